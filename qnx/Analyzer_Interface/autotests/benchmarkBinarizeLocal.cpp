@@ -0,0 +1,70 @@
+#include <QTest>
+#include "filter/algoImage.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::image::Size2d;
+using precitec::filter::ComparisonType;
+using precitec::filter::calcBinarizeLocal;
+using precitec::filter::calcBinarizeLocalIntegral;
+
+class BenchmarkBinarizeLocal : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkLocal();
+    void benchmarkLocalIntegral_data();
+    void benchmarkLocalIntegral();
+
+private:
+    BImage m_image{Size2d{1024, 1024}};
+};
+
+void BenchmarkBinarizeLocal::initTestCase()
+{
+    std::mt19937 generator{3};
+    for (auto & pixel : m_image)
+    {
+        pixel = generator() % 256;
+    }
+}
+
+void BenchmarkBinarizeLocal::benchmarkLocal()
+{
+    BImage result{m_image.size()};
+    QBENCHMARK
+    {
+        calcBinarizeLocal(m_image, ComparisonType::eLess, 10, result);
+    }
+}
+
+void BenchmarkBinarizeLocal::benchmarkLocalIntegral_data()
+{
+    QTest::addColumn<int>("windowSize");
+    QTest::addColumn<int>("blockSize");
+
+    for (int windowSize : {20, 64, 256})
+    {
+        for (int blockSize : {1, 5})
+        {
+            QTest::newRow(qPrintable(QStringLiteral("window %1, block %2").arg(windowSize).arg(blockSize))) << windowSize << blockSize;
+        }
+    }
+}
+
+void BenchmarkBinarizeLocal::benchmarkLocalIntegral()
+{
+    QFETCH(int, windowSize);
+    QFETCH(int, blockSize);
+
+    BImage result{m_image.size()};
+    QBENCHMARK
+    {
+        calcBinarizeLocalIntegral(m_image, ComparisonType::eLess, 10, windowSize, blockSize, result);
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkBinarizeLocal)
+#include "benchmarkBinarizeLocal.moc"
@@ -0,0 +1,134 @@
+#include <QTest>
+#include "math/calibration3DCoords.h"
+#include "math/calibrationStructures.h"
+#include "math/Calibration3DCoordsLoader.h"
+
+using namespace precitec::math;
+using precitec::geo2d::Point;
+using precitec::filter::LaserLine;
+
+class BenchmarkCalibration3DCoords : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkLaserLine_data();
+    void benchmarkLaserLine();
+    void benchmarkCalibrationChange_data();
+    void benchmarkCalibrationChange();
+
+private:
+    Calibration3DCoords m_coords;
+    std::vector<int> m_screenX;
+    std::vector<int> m_screenY;
+};
+
+void BenchmarkCalibration3DCoords::initTestCase()
+{
+    CoaxCalibrationData oCoaxData;
+    oCoaxData.m_oBeta0 = 0.3144555989;
+    oCoaxData.m_oBetaZ = 0.2489175749;
+    oCoaxData.m_oBetaZ2 = 0.2969726798;
+    oCoaxData.m_oBetaZTCP = 0.5;
+    oCoaxData.m_oDpixX = 0.0106;
+    oCoaxData.m_oDpixY = 0.0106;
+    oCoaxData.m_oWidth = 1024;
+    oCoaxData.m_oHeight = 1024;
+    oCoaxData.m_oOrigX = 512;
+    oCoaxData.m_oOrigY = 512;
+    oCoaxData.m_oAxisFactor = 1.0;
+    oCoaxData.m_oHighPlaneOnImageTop = true;
+    oCoaxData.m_oHighPlaneOnImageTop_2 = true;
+    oCoaxData.m_oHighPlaneOnImageTop_TCP = true;
+    oCoaxData.m_oInvertX = false;
+    QVERIFY(loadCoaxModel(m_coords, oCoaxData, false));
+
+    // one laser line over the full sensor width
+    for (int i = 0; i < 1024; i++)
+    {
+        m_screenX.push_back(i);
+        m_screenY.push_back(400 + (i * 37) % 200);
+    }
+}
+
+void BenchmarkCalibration3DCoords::benchmarkLaserLine_data()
+{
+    QTest::addColumn<bool>("batch");
+
+    QTest::newRow("scalar") << false;
+    QTest::newRow("batch") << true;
+}
+
+void BenchmarkCalibration3DCoords::benchmarkLaserLine()
+{
+    QFETCH(bool, batch);
+    const auto oCount = m_screenX.size();
+    std::vector<float> oX(oCount), oY(oCount), oZ(oCount);
+
+    if (batch)
+    {
+        QBENCHMARK
+        {
+            m_coords.convertScreenTo3D(oX.data(), oY.data(), oZ.data(), nullptr, m_screenX.data(), m_screenY.data(), oCount, LaserLine::FrontLaserLine);
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (std::size_t i = 0; i < oCount; i++)
+            {
+                m_coords.convertScreenTo3D(oX[i], oY[i], oZ[i], m_screenX[i], m_screenY[i], LaserLine::FrontLaserLine);
+            }
+        }
+    }
+}
+
+void BenchmarkCalibration3DCoords::benchmarkCalibrationChange_data()
+{
+    QTest::addColumn<bool>("sharedMemory");
+    QTest::addColumn<bool>("changeCoordinates");
+
+    QTest::newRow("message_coordinates") << false << true;
+    QTest::newRow("message_angle") << false << false;
+    QTest::newRow("sharedMemory_coordinates") << true << true;
+    QTest::newRow("sharedMemory_angle") << true << false;
+}
+
+void BenchmarkCalibration3DCoords::benchmarkCalibrationChange()
+{
+    // latency from a calibration change until the receiver can use the coordinates
+    QFETCH(bool, sharedMemory);
+    QFETCH(bool, changeCoordinates);
+    using precitec::system::message::StaticMessageBuffer;
+
+    auto oCoords = m_coords;
+    StaticMessageBuffer oBuffer(2 * sizeof(float) * 1024 * 1024 + 1024);
+    Calibration3DCoords oReceived;
+    float oAngle = 30.0;
+    QBENCHMARK
+    {
+        if (changeCoordinates)
+        {
+            oCoords.X(0, 0) += 0.001;
+        }
+        else
+        {
+            oAngle += 0.1;
+            oCoords.setAllTriangulationAngles(oAngle, angleUnit::eDegrees);
+        }
+        if (sharedMemory)
+        {
+            oCoords.publishSharedMemory(0);
+        }
+        oBuffer.clear();
+        oCoords.serialize(oBuffer);
+        oBuffer.rewind();
+        oReceived.deserialize(oBuffer);
+    }
+    QCOMPARE(oReceived.getTriangulationAngle(angleUnit::eDegrees, LaserLine::FrontLaserLine), oCoords.getTriangulationAngle(angleUnit::eDegrees, LaserLine::FrontLaserLine));
+    Calibration3DCoordsSharedMemory::release();
+}
+
+QTEST_MAIN(BenchmarkCalibration3DCoords)
+#include "benchmarkCalibration3DCoords.moc"
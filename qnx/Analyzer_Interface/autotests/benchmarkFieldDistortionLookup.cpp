@@ -0,0 +1,82 @@
+#include <QTest>
+
+#include "coordinates/fieldDistortionLookup.h"
+#include "coordinates/fieldDistortionMapping.h"
+
+#include <cmath>
+
+class BenchmarkFieldDistortionLookup : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkPixelToWorld_data();
+    void benchmarkPixelToWorld();
+    void benchmarkBuild_data();
+    void benchmarkBuild();
+
+private:
+    std::vector<double> m_coefficient{60, 0.5, 0.05, 0.03, 0.02, 0.002, -60, 0.4, 0.04, 0.02, 0.03, 0.002};
+    std::vector<std::pair<double, double>> m_pixel;
+};
+
+void BenchmarkFieldDistortionLookup::initTestCase()
+{
+    // a dense contour over the whole image, relative to a TCP in the image center
+    for (int i = 0; i < 100000; i++)
+    {
+        m_pixel.emplace_back(-640 + std::fmod(i * 0.37, 1280.0), -512 + std::fmod(i * 0.53, 1024.0));
+    }
+}
+
+void BenchmarkFieldDistortionLookup::benchmarkPixelToWorld_data()
+{
+    QTest::addColumn<double>("tolerance");
+
+    QTest::newRow("exact") << 0.0;
+    QTest::newRow("1e-3") << 1e-3;
+    QTest::newRow("1e-4") << 1e-4;
+    QTest::newRow("1e-5") << 1e-5;
+}
+
+void BenchmarkFieldDistortionLookup::benchmarkPixelToWorld()
+{
+    QFETCH(double, tolerance);
+    // build the grid outside of the measurement
+    pixelToWorld(m_pixel, m_coefficient, tolerance);
+
+    std::vector<std::pair<double, double>> world;
+    QBENCHMARK
+    {
+        world = pixelToWorld(m_pixel, m_coefficient, tolerance);
+    }
+
+    double maxDeviation = 0.0;
+    for (std::size_t i = 0; i < m_pixel.size(); i++)
+    {
+        const auto exact = pixelToWorld(m_pixel[i].first, m_pixel[i].second, m_coefficient);
+        maxDeviation = std::max(maxDeviation, std::hypot(world[i].first - exact.first, world[i].second - exact.second));
+    }
+    qInfo("%zu points, maximum deviation %g mm", m_pixel.size(), maxDeviation);
+    QVERIFY(maxDeviation <= tolerance * 1.1 + 1e-6);
+}
+
+void BenchmarkFieldDistortionLookup::benchmarkBuild_data()
+{
+    QTest::addColumn<double>("step");
+
+    QTest::newRow("4") << 4.0;
+    QTest::newRow("16") << 16.0;
+}
+
+void BenchmarkFieldDistortionLookup::benchmarkBuild()
+{
+    QFETCH(double, step);
+    QBENCHMARK
+    {
+        FieldDistortionLookup lookup{m_coefficient, -640, 640, -512, 512, step};
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkFieldDistortionLookup)
+#include "benchmarkFieldDistortionLookup.moc"
@@ -0,0 +1,136 @@
+#include <QTest>
+#include "filter/algoImage.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::image::Size2d;
+using precitec::filter::ComparisonType;
+using precitec::filter::calcBinarizeLocalIntegral;
+
+class TestBinarizeLocal : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testIntegral_data();
+    void testIntegral();
+    void testConstantImage();
+};
+
+namespace
+{
+
+/**
+* Straightforward local binarization: mean of the window around the block of the pixel, the window is clipped at the image border.
+*/
+BImage binarizeReference(const BImage & image, ComparisonType comparisonType, int distance, int windowSize, int blockSize)
+{
+    const int width = image.width();
+    const int height = image.height();
+    const int offset = (windowSize - blockSize) / 2;
+    BImage result{image.size()};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const int blockY = y / blockSize * blockSize;
+            const int blockX = x / blockSize * blockSize;
+            const int top = std::min(std::max(blockY - offset, 0), height - 1);
+            const int bottom = std::max(std::min(blockY - offset + windowSize, height), top + 1);
+            const int left = std::min(std::max(blockX - offset, 0), width - 1);
+            const int right = std::max(std::min(blockX - offset + windowSize, width), left + 1);
+            long sum = 0;
+            for (int windowY = top; windowY < bottom; windowY++)
+            {
+                for (int windowX = left; windowX < right; windowX++)
+                {
+                    sum += image[windowY][windowX];
+                }
+            }
+            const int mean = sum / ((bottom - top) * (right - left));
+            const bool set = comparisonType == ComparisonType::eLess ? image[y][x] < mean - distance : image[y][x] >= mean + distance;
+            result[y][x] = set ? 255 : 0;
+        }
+    }
+    return result;
+}
+
+}
+
+void TestBinarizeLocal::testIntegral_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("windowSize");
+    QTest::addColumn<int>("blockSize");
+    QTest::addColumn<int>("comparisonType");
+    QTest::addColumn<int>("distance");
+
+    QTest::newRow("per pixel, less") << 100 << 80 << 20 << 1 << int(ComparisonType::eLess) << 10;
+    QTest::newRow("per pixel, greater equal") << 100 << 80 << 20 << 1 << int(ComparisonType::eGreaterEqual) << 10;
+    QTest::newRow("blocks, less") << 100 << 80 << 20 << 5 << int(ComparisonType::eLess) << 5;
+    QTest::newRow("blocks, greater equal") << 101 << 79 << 21 << 4 << int(ComparisonType::eGreaterEqual) << 5;
+    QTest::newRow("distance 0") << 64 << 64 << 9 << 1 << int(ComparisonType::eLess) << 0;
+    QTest::newRow("window 1") << 37 << 23 << 1 << 1 << int(ComparisonType::eGreaterEqual) << 0;
+    QTest::newRow("window smaller than block") << 50 << 50 << 3 << 8 << int(ComparisonType::eLess) << 2;
+    QTest::newRow("window larger than image") << 40 << 30 << 100 << 1 << int(ComparisonType::eLess) << 3;
+    QTest::newRow("large window") << 300 << 300 << 260 << 1 << int(ComparisonType::eGreaterEqual) << 3;
+    QTest::newRow("single row") << 200 << 1 << 15 << 1 << int(ComparisonType::eLess) << 4;
+    QTest::newRow("single column") << 1 << 200 << 15 << 2 << int(ComparisonType::eGreaterEqual) << 4;
+}
+
+void TestBinarizeLocal::testIntegral()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, windowSize);
+    QFETCH(int, blockSize);
+    QFETCH(int, comparisonType);
+    QFETCH(int, distance);
+
+    // gradient with noise, the means differ over the image
+    std::mt19937 generator{11};
+    BImage image{Size2d{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            image[y][x] = ((x * 7 + y * 3) % 192) + generator() % 64;
+        }
+    }
+
+    BImage result{image.size()};
+    calcBinarizeLocalIntegral(image, ComparisonType(comparisonType), distance, windowSize, blockSize, result);
+    const auto expected = binarizeReference(image, ComparisonType(comparisonType), distance, windowSize, blockSize);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            QCOMPARE(int(result[y][x]), int(expected[y][x]));
+        }
+    }
+}
+
+void TestBinarizeLocal::testConstantImage()
+{
+    BImage image{Size2d{64, 48}};
+    image.fill(100);
+    BImage result{image.size()};
+
+    // no pixel is darker than the mean, all are at least as bright
+    calcBinarizeLocalIntegral(image, ComparisonType::eLess, 0, 20, 1, result);
+    for (const auto pixel : result)
+    {
+        QCOMPARE(int(pixel), 0);
+    }
+    calcBinarizeLocalIntegral(image, ComparisonType::eGreaterEqual, 0, 20, 1, result);
+    for (const auto pixel : result)
+    {
+        QCOMPARE(int(pixel), 255);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestBinarizeLocal)
+#include "testBinarizeLocal.moc"
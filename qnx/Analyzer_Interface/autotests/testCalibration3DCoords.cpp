@@ -4,6 +4,13 @@
 #include "math/Calibration3DCoordsLoader.h"
 #include <util/camGridData.h>
 
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+
 class TestCalibration3DCoords : public QObject
 {
     Q_OBJECT
@@ -11,6 +18,10 @@ private Q_SLOTS:
     void testCoax_data();
     void testCoax();
     void testScheimpflug();
+    void testBatchConversion_data();
+    void testBatchConversion();
+    void testSharedMemoryTransport();
+    void testUnlinkStaleSegments();
 };
 
 using namespace precitec::math;
@@ -484,5 +495,246 @@ void TestCalibration3DCoords::testScheimpflug()
 
 
 
+void TestCalibration3DCoords::testBatchConversion_data()
+{
+    QTest::addColumn<bool>("scheimpflug");
+    QTest::addColumn<bool>("useOrientedLine");
+
+    QTest::newRow("coax") << false << false;
+    QTest::newRow("coax_orientedLine") << false << true;
+    QTest::newRow("scheimpflug") << true << false;
+}
+
+void TestCalibration3DCoords::testBatchConversion()
+{
+    QFETCH(bool, scheimpflug);
+    QFETCH(bool, useOrientedLine);
+
+    Calibration3DCoords coords;
+    if (scheimpflug)
+    {
+        precitec::system::CamGridData oCamGridData;
+        std::string oMsgError = oCamGridData.loadFromCSV(QFINDTESTDATA("testdata/scheimpflug/").toStdString() + "/config/calibImgData0fallback.csv");
+        QVERIFY(oMsgError.empty());
+        QVERIFY(loadCamGridData(coords, oCamGridData));
+    }
+    else
+    {
+        CoaxCalibrationData oCoaxData;
+        oCoaxData.m_oBeta0 = 0.3144555989;
+        oCoaxData.m_oBetaZ = 0.2489175749;
+        oCoaxData.m_oBetaZ2 = 0.2969726798;
+        oCoaxData.m_oBetaZTCP = 0.5;
+        oCoaxData.m_oDpixX = 0.0106;
+        oCoaxData.m_oDpixY = 0.0106;
+        oCoaxData.m_oWidth = 1024;
+        oCoaxData.m_oHeight = 1024;
+        oCoaxData.m_oOrigX = 512;
+        oCoaxData.m_oOrigY = 512;
+        oCoaxData.m_oAxisFactor = 1.0;
+        oCoaxData.m_oHighPlaneOnImageTop = true;
+        oCoaxData.m_oHighPlaneOnImageTop_2 = true;
+        oCoaxData.m_oHighPlaneOnImageTop_TCP = true;
+        oCoaxData.m_oInvertX = false;
+        QVERIFY(loadCoaxModel(coords, oCoaxData, useOrientedLine));
+    }
+    QCOMPARE(coords.usesOrientedLineCalibration(), useOrientedLine);
+    const auto oSensorSize = coords.getSensorSize();
+
+    // a laser line over the whole sensor width, with some points outside the sensor
+    std::vector<int> oScreenX, oScreenY;
+    for (int i = -2; i < oSensorSize.width + 2; i++)
+    {
+        oScreenX.push_back(i);
+        oScreenY.push_back(i % 7 == 0 ? oSensorSize.height + 1 : (oSensorSize.height / 2 + (i * 37) % 300 - 150));
+    }
+    const auto oCount = oScreenX.size();
+
+    for (int line = 0; line < (int)LaserLine::NumberLaserLines; line++)
+    {
+        std::vector<float> oX(oCount, -1.0), oY(oCount, -1.0), oZ(oCount, -1.0);
+        std::unique_ptr<bool[]> oValid{new bool[oCount]};
+        const auto oNumValid = coords.convertScreenTo3D(oX.data(), oY.data(), oZ.data(), oValid.get(), oScreenX.data(), oScreenY.data(), oCount, LaserLine(line));
+
+        std::size_t oExpectedNumValid = 0;
+        for (std::size_t i = 0; i < oCount; i++)
+        {
+            float x = 0.0, y = 0.0, z = 0.0;
+            const bool valid = coords.convertScreenTo3D(x, y, z, oScreenX[i], oScreenY[i], LaserLine(line));
+            oExpectedNumValid += valid;
+            QCOMPARE(oValid[i], valid);
+            // identical to the scalar conversion, not only fuzzy equal
+            QVERIFY(oX[i] == x);
+            QVERIFY(oY[i] == y);
+            QVERIFY(oZ[i] == z);
+        }
+        QCOMPARE(oNumValid, oExpectedNumValid);
+        QVERIFY(oNumValid > 0);
+
+        const auto oNumValidLaserPlane = coords.convertScreenToLaserPlane(oX.data(), oY.data(), nullptr, oScreenX.data(), oScreenY.data(), oCount, LaserLine(line));
+        QCOMPARE(oNumValidLaserPlane, oExpectedNumValid);
+        for (std::size_t i = 0; i < oCount; i++)
+        {
+            float x = 0.0, y = 0.0;
+            coords.convertScreenToLaserPlane(x, y, oScreenX[i], oScreenY[i], LaserLine(line));
+            QVERIFY(oX[i] == x);
+            QVERIFY(oY[i] == y);
+        }
+
+        std::vector<Point> oPoints;
+        for (std::size_t i = 0; i < oCount; i++)
+        {
+            oPoints.emplace_back(oScreenX[i], oScreenY[i]);
+        }
+        const auto oPoints3D = coords.to3D(oPoints, LaserLine(line));
+        QCOMPARE(oPoints3D.size(), oCount);
+        for (std::size_t i = 0; i < oCount; i++)
+        {
+            const auto oExpected = coords.to3D(oPoints[i].x, oPoints[i].y, LaserLine(line));
+            QVERIFY(oPoints3D[i][0] == oExpected[0]);
+            QVERIFY(oPoints3D[i][1] == oExpected[1]);
+            QVERIFY(oPoints3D[i][2] == oExpected[2]);
+        }
+    }
+}
+
+void TestCalibration3DCoords::testSharedMemoryTransport()
+{
+    using precitec::system::message::StaticMessageBuffer;
+
+    Calibration3DCoords coords;
+    CoaxCalibrationData oCoaxData;
+    oCoaxData.m_oBeta0 = 0.3144555989;
+    oCoaxData.m_oBetaZ = 0.2489175749;
+    oCoaxData.m_oBetaZ2 = 0.2969726798;
+    oCoaxData.m_oBetaZTCP = 0.5;
+    oCoaxData.m_oDpixX = 0.0106;
+    oCoaxData.m_oDpixY = 0.0106;
+    oCoaxData.m_oWidth = 1024;
+    oCoaxData.m_oHeight = 1024;
+    oCoaxData.m_oOrigX = 512;
+    oCoaxData.m_oOrigY = 512;
+    oCoaxData.m_oAxisFactor = 1.0;
+    oCoaxData.m_oHighPlaneOnImageTop = true;
+    oCoaxData.m_oHighPlaneOnImageTop_2 = true;
+    oCoaxData.m_oHighPlaneOnImageTop_TCP = true;
+    oCoaxData.m_oInvertX = false;
+    QVERIFY(loadCoaxModel(coords, oCoaxData, false));
+    QVERIFY(!coords.getSharedMemoryHandle().isValid());
+
+    const int oBufferSize = 2 * sizeof(float) * 1024 * 1024 + 1024;
+    auto transfer = [oBufferSize] (const Calibration3DCoords & rSent, Calibration3DCoords & rReceived)
+    {
+        StaticMessageBuffer oBuffer(oBufferSize);
+        rSent.serialize(oBuffer);
+        const auto oSize = oBuffer.currentPos();
+        oBuffer.rewind();
+        rReceived.deserialize(oBuffer);
+        return oSize;
+    };
+    auto compareCoordinates = [] (const Calibration3DCoords & rExpected, const Calibration3DCoords & rActual)
+    {
+        QCOMPARE(rActual.getSensorSize().width, rExpected.getSensorSize().width);
+        QCOMPARE(rActual.getSensorSize().height, rExpected.getSensorSize().height);
+        for (int y = 0; y < 1024; y += 7)
+        {
+            for (int x = 0; x < 1024; x += 5)
+            {
+                float oExpectedX = 0, oExpectedY = 0, oActualX = 0, oActualY = 0;
+                QCOMPARE(rActual.getCoordinates(oActualX, oActualY, x, y), rExpected.getCoordinates(oExpectedX, oExpectedY, x, y));
+                QVERIFY(oActualX == oExpectedX);
+                QVERIFY(oActualY == oExpectedY);
+            }
+        }
+    };
+
+    Calibration3DCoords oReceivedInline;
+    const auto oInlineSize = transfer(coords, oReceivedInline);
+    compareCoordinates(coords, oReceivedInline);
+
+    // only the handle is sent
+    QVERIFY(coords.publishSharedMemory(0));
+    const auto oHandle = coords.getSharedMemoryHandle();
+    QVERIFY(oHandle.isValid());
+    Calibration3DCoords oReceived;
+    const auto oSharedMemorySize = transfer(coords, oReceived);
+    QVERIFY(oSharedMemorySize < 1024);
+    QVERIFY(oSharedMemorySize * 1000 < oInlineSize);
+    QVERIFY(!oReceived.getSharedMemoryHandle().isValid());
+    compareCoordinates(coords, oReceived);
+
+    // a parameter change does not publish the arrays again
+    coords.setAllTriangulationAngles(45.0, angleUnit::eDegrees);
+    QVERIFY(coords.publishSharedMemory(0));
+    QCOMPARE(coords.getSharedMemoryHandle().name, oHandle.name);
+    QCOMPARE(coords.getSharedMemoryHandle().version, oHandle.version);
+    transfer(coords, oReceived);
+    QCOMPARE(oReceived.getTriangulationAngle(angleUnit::eDegrees, LaserLine::FrontLaserLine), 45.0f);
+    compareCoordinates(coords, oReceived);
+
+    // changed arrays are published as a new version
+    coords.X(10, 10) += 1.0;
+    QVERIFY(!coords.getSharedMemoryHandle().isValid());
+    QVERIFY(coords.publishSharedMemory(0));
+    const auto oNewHandle = coords.getSharedMemoryHandle();
+    QVERIFY(oNewHandle.isValid());
+    QVERIFY(oNewHandle.name != oHandle.name);
+    QVERIFY(oNewHandle.version != oHandle.version);
+    transfer(coords, oReceived);
+    compareCoordinates(coords, oReceived);
+
+    // a copy keeps the handle and the generation of the arrays, publishing it again sends the same version
+    Calibration3DCoords oCopy = coords;
+    QCOMPARE(oCopy.getSharedMemoryHandle().name, oNewHandle.name);
+    QVERIFY(oCopy.publishSharedMemory(0));
+    QCOMPARE(oCopy.getSharedMemoryHandle().name, oNewHandle.name);
+    QCOMPARE(oCopy.getSharedMemoryHandle().version, oNewHandle.version);
+
+    Calibration3DCoordsSharedMemory::release();
+    std::vector<float> oX, oY;
+    QVERIFY(!Calibration3DCoordsSharedMemory::read(oNewHandle, oX, oY));
+    QVERIFY(!Calibration3DCoordsSharedMemory::read(oHandle, oX, oY));
+
+    // a handle which cannot be read does not result in zero coordinates
+    QVERIFY(!oReceived.coordinatesMissing());
+    QVERIFY(oCopy.getSharedMemoryHandle().isValid());
+    transfer(oCopy, oReceived);
+    QVERIFY(oReceived.coordinatesMissing());
+
+    // the arrays are sent in the message instead
+    oCopy.resetSharedMemoryHandle();
+    QVERIFY(!oCopy.getSharedMemoryHandle().isValid());
+    transfer(oCopy, oReceived);
+    QVERIFY(!oReceived.coordinatesMissing());
+    compareCoordinates(oCopy, oReceived);
+}
+
+void TestCalibration3DCoords::testUnlinkStaleSegments()
+{
+    // a publisher which did not exit cleanly and a running one
+    const pid_t oPid = fork();
+    if (oPid == 0)
+    {
+        _exit(0);
+    }
+    QVERIFY(oPid > 0);
+    QCOMPARE(waitpid(oPid, nullptr, 0), oPid);
+    const auto oStaleName = "/wmCalib3DCoords_" + std::to_string(oPid) + "_0_0_1";
+    const auto oRunningName = "/wmCalib3DCoords_" + std::to_string(getppid()) + "_0_0_1";
+    for (const auto & rName : {oStaleName, oRunningName})
+    {
+        const int oFd = shm_open(rName.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        QVERIFY(oFd != -1);
+        close(oFd);
+    }
+
+    Calibration3DCoordsSharedMemory::unlinkStaleSegments();
+    QCOMPARE(shm_open(oStaleName.c_str(), O_RDONLY, 0), -1);
+    const int oFd = shm_open(oRunningName.c_str(), O_RDONLY, 0);
+    QVERIFY(oFd != -1);
+    close(oFd);
+    shm_unlink(oRunningName.c_str());
+}
+
 QTEST_MAIN(TestCalibration3DCoords)
 #include "testCalibration3DCoords.moc"
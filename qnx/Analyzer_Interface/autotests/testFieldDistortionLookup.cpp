@@ -0,0 +1,212 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "coordinates/fieldDistortionLookup.h"
+#include "coordinates/fieldDistortionMapping.h"
+
+#include <cmath>
+#include <future>
+
+class TestFieldDistortionLookup : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void testDeviation_data();
+    void testDeviation();
+    void testOutsideGrid();
+    void testCache();
+    void testSaveLoad();
+    void testConcurrentCache();
+    void testBatch();
+};
+
+namespace
+{
+
+// typical coefficients of a scanner field (pixel per mm), with distortion
+const std::vector<double> s_coefficient{60, 0.5, 0.05, 0.03, 0.02, 0.002, -60, 0.4, 0.04, 0.02, 0.03, 0.002};
+
+double distance(const std::pair<double, double>& a, const std::pair<double, double>& b)
+{
+    return std::hypot(a.first - b.first, a.second - b.second);
+}
+
+}
+
+void TestFieldDistortionLookup::init()
+{
+    FieldDistortionLookup::clearCache();
+}
+
+void TestFieldDistortionLookup::testDeviation_data()
+{
+    QTest::addColumn<double>("step");
+
+    QTest::newRow("1") << 1.0;
+    QTest::newRow("4") << 4.0;
+    QTest::newRow("16") << 16.0;
+    QTest::newRow("64") << 64.0;
+}
+
+void TestFieldDistortionLookup::testDeviation()
+{
+    QFETCH(double, step);
+    const FieldDistortionLookup lookup{s_coefficient, -640, 640, -512, 512, step};
+    QCOMPARE(lookup.step(), step);
+    QVERIFY(lookup.sampledMaxDeviation() > 0.0);
+
+    // the deviation sampled at the cell centers is a close estimate, but not a bound, for the deviation at arbitrary positions
+    double maxDeviation = 0.0;
+    for (int j = 0; j < 200; j++)
+    {
+        for (int i = 0; i < 200; i++)
+        {
+            const double x = -640 + i * 6.4 + 0.3;
+            const double y = -512 + j * 5.12 + 0.7;
+            QVERIFY(lookup.contains(x, y));
+            maxDeviation = std::max(maxDeviation, distance(lookup.pixelToWorld(x, y), pixelToWorld(x, y, s_coefficient)));
+        }
+    }
+    QVERIFY(maxDeviation <= lookup.sampledMaxDeviation() * 1.1 + 1e-6);
+}
+
+void TestFieldDistortionLookup::testOutsideGrid()
+{
+    const FieldDistortionLookup lookup{s_coefficient, -100, 100, -100, 100, 16};
+    QVERIFY(!lookup.contains(200, 0));
+    QVERIFY(!lookup.contains(0, -200));
+    const auto exact = pixelToWorld(200, -200, s_coefficient);
+    const auto result = lookup.pixelToWorld(200, -200);
+    QCOMPARE(result.first, exact.first);
+    QCOMPARE(result.second, exact.second);
+}
+
+void TestFieldDistortionLookup::testCache()
+{
+    const auto lookup = FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-3);
+    QVERIFY(lookup);
+    QVERIFY(lookup->sampledMaxDeviation() <= 1e-3);
+
+    // a smaller range is served by the same grid
+    QCOMPARE(FieldDistortionLookup::cached(s_coefficient, -100, 100, -100, 100, 1e-3), lookup);
+
+    // a stricter tolerance requires a finer grid
+    const auto fine = FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-5);
+    QVERIFY(fine);
+    QVERIFY(fine != lookup);
+    QVERIFY(fine->step() < lookup->step());
+    QVERIFY(fine->sampledMaxDeviation() <= 1e-5);
+
+    // other coefficients
+    auto coefficient = s_coefficient;
+    coefficient[0] = 61;
+    const auto other = FieldDistortionLookup::cached(coefficient, -640, 640, -512, 512, 1e-3);
+    QVERIFY(other);
+    QVERIFY(other != lookup);
+    QCOMPARE(other->distortionCoefficient(), coefficient);
+
+    // tolerance below the precision of the exact solver cannot be met
+    QVERIFY(!FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-12));
+}
+
+void TestFieldDistortionLookup::testSaveLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto fileName = dir.filePath(QStringLiteral("lookup.bin")).toStdString();
+
+    const FieldDistortionLookup lookup{s_coefficient, -640, 640, -512, 512, 8};
+    QVERIFY(lookup.save(fileName));
+    const auto loaded = FieldDistortionLookup::load(fileName);
+    QVERIFY(loaded);
+    QCOMPARE(loaded->distortionCoefficient(), s_coefficient);
+    QCOMPARE(loaded->step(), 8.0);
+    QCOMPARE(loaded->sampledMaxDeviation(), lookup.sampledMaxDeviation());
+    QCOMPARE(loaded->pixelToWorld(12.3, -45.6), lookup.pixelToWorld(12.3, -45.6));
+
+    QVERIFY(!FieldDistortionLookup::load(dir.filePath(QStringLiteral("missing.bin")).toStdString()));
+
+    // the disk cache is used after the memory cache is cleared
+    const auto cached = FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-3, dir.path().toStdString());
+    QVERIFY(cached);
+    FieldDistortionLookup::clearCache();
+    const auto reloaded = FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-3, dir.path().toStdString());
+    QVERIFY(reloaded);
+    QVERIFY(reloaded != cached);
+    QCOMPARE(reloaded->step(), cached->step());
+    QCOMPARE(reloaded->pixelToWorld(12.3, -45.6), cached->pixelToWorld(12.3, -45.6));
+}
+
+void TestFieldDistortionLookup::testConcurrentCache()
+{
+    // the grids are built in parallel outside of the cache lock, all threads get the same grid
+    std::vector<std::future<std::shared_ptr<const FieldDistortionLookup>>> futures;
+    for (int i = 0; i < 4; i++)
+    {
+        futures.push_back(std::async(std::launch::async, [] { return FieldDistortionLookup::cached(s_coefficient, -640, 640, -512, 512, 1e-3); }));
+    }
+    const auto lookup = futures.front().get();
+    QVERIFY(lookup);
+    for (std::size_t i = 1; i < futures.size(); i++)
+    {
+        QCOMPARE(futures.at(i).get(), lookup);
+    }
+    QCOMPARE(FieldDistortionLookup::findCached(s_coefficient, -640, 640, -512, 512, 1e-3), lookup);
+}
+
+void TestFieldDistortionLookup::testBatch()
+{
+    std::vector<std::pair<double, double>> pixel;
+    for (int i = 0; i < 1000; i++)
+    {
+        pixel.emplace_back(-600 + i * 1.2, 300 - i * 0.7);
+    }
+    // the grid of the batch covers the bounding box rounded to 256 pixel
+    QVERIFY(pixel.size() < FieldDistortionLookup::initialNodeCount(-768, 768, -512, 512));
+
+    // a batch with fewer points than grid nodes does not build a grid
+    const auto exact = pixelToWorld(pixel, s_coefficient);
+    QCOMPARE(pixelToWorld(pixel, s_coefficient, 1e-4), exact);
+    QVERIFY(!FieldDistortionLookup::findCached(s_coefficient, -768, 768, -512, 512, 1e-4));
+
+    // but uses a grid in memory
+    QVERIFY(FieldDistortionLookup::cached(s_coefficient, -768, 768, -512, 512, 1e-4));
+    const auto interpolated = pixelToWorld(pixel, s_coefficient, 1e-4);
+    QCOMPARE(exact.size(), pixel.size());
+    QCOMPARE(interpolated.size(), pixel.size());
+    QVERIFY(interpolated != exact);
+    for (std::size_t i = 0; i < pixel.size(); i++)
+    {
+        const auto expected = pixelToWorld(pixel[i].first, pixel[i].second, s_coefficient);
+        QCOMPARE(exact[i], expected);
+        QVERIFY(distance(interpolated[i], expected) <= 1.1e-4 + 1e-6);
+    }
+
+    // a large batch builds the grid
+    FieldDistortionLookup::clearCache();
+    std::vector<std::pair<double, double>> image;
+    for (int y = -200; y < 200; y += 2)
+    {
+        for (int x = -300; x < 300; x += 2)
+        {
+            image.emplace_back(x, y);
+        }
+    }
+    const auto imageWorld = pixelToWorld(image, s_coefficient, 1e-4);
+    QVERIFY(FieldDistortionLookup::findCached(s_coefficient, -300, 300, -200, 200, 1e-4));
+    for (std::size_t i = 0; i < image.size(); i += 97)
+    {
+        QVERIFY(distance(imageWorld[i], pixelToWorld(image[i].first, image[i].second, s_coefficient)) <= 1.1e-4 + 1e-6);
+    }
+
+    const auto roundTrip = worldToPixel(exact, s_coefficient);
+    QCOMPARE(roundTrip.size(), pixel.size());
+    for (std::size_t i = 0; i < pixel.size(); i++)
+    {
+        QVERIFY(distance(roundTrip[i], pixel[i]) < 1e-3);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFieldDistortionLookup)
+#include "testFieldDistortionLookup.moc"
@@ -3,9 +3,9 @@
 #include "filter/algoArray.h"
 #include "geo/array.h" 
 
-Q_DECLARE_METATYPE(precitec::geo2d::Doublearray)
+#include <random>
 
-int g_BenchmarkFilterSize = 2;
+Q_DECLARE_METATYPE(precitec::geo2d::Doublearray)
 
 class TestMovingWindow: public QObject
 {
@@ -13,19 +13,50 @@ class TestMovingWindow: public QObject
 private Q_SLOTS:
     void testCompareOptimizedMethods_data();
     void testCompareOptimizedMethods();
-   /*
-    void benchmarkMedianGeneric();
-    void benchmarkMedianOptimized();
-    void benchmarkMeanGeneric();
-    void benchmarkMeanOptimized();
-    */
+    void testSlidingMedian();
+    void testMedianRandomInput_data();
+    void testMedianRandomInput();
+    void benchmarkMedian_data();
+    void benchmarkMedian();
+    void benchmarkMean_data();
+    void benchmarkMean();
 };
 
 using precitec::filter::MovingWindow;
+using precitec::filter::SlidingMedian;
 using precitec::geo2d::TArray;
 using precitec::filter::calcMedian1d;
 using precitec::geo2d::Doublearray;
 
+namespace
+{
+
+// laser line like input: a slope with noise, outliers and gaps with bad rank
+Doublearray createLine(int size, int numDistinctValues, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    Doublearray line(size, 0.0, 255);
+    for (int i = 0; i < size; ++i)
+    {
+        line.getData()[i] = 0.1 * i + int(generator() % numDistinctValues);
+        if (generator() % 50 == 0)
+        {
+            line.getData()[i] += 500;
+        }
+        if (generator() % 10 == 0)
+        {
+            line.getRank()[i] = 0;
+        }
+        else
+        {
+            line.getRank()[i] = 1 + generator() % 255;
+        }
+    }
+    return line;
+}
+
+}
+
 void TestMovingWindow::testCompareOptimizedMethods_data()
 {
     QTest::addColumn<int>("filterSize");
@@ -117,7 +148,7 @@ void TestMovingWindow::testCompareOptimizedMethods()
 
     
     Doublearray outputArrayOptimized(inputArray.size());
-    std::vector<double> valuesInWindow(filterSize);
+    SlidingMedian<double> valuesInWindow(filterSize);
     MovingWindow<double>::movingMedian(inputArray, outputArrayOptimized, valuesInWindow, passThroughBadRank);
 
     
@@ -133,153 +164,151 @@ void TestMovingWindow::testCompareOptimizedMethods()
 
 }
 
-/*
-void TestMovingWindow::benchmarkMedianGeneric()
+void TestMovingWindow::testSlidingMedian()
 {
-    Doublearray input(44,0.1,255);
-    double value = -3;
-    int i = 2;
-    for ( ; i < 10;++i)
-    {
-        input.getData()[i] = ++value;
-    }
-    for (i =5; i < 15; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
+    SlidingMedian<int> window(6);
+    QCOMPARE(window.windowSize(), 6u);
+    QCOMPARE(window.numValues(), 0u);
+
+    // the median is the element at index n / 2 of the sorted values
+    window.insert(0, 5);
+    QCOMPARE(window.median(), 5);
+    window.insert(1, 3);
+    QCOMPARE(window.median(), 5);
+    window.insert(2, 4);
+    QCOMPARE(window.median(), 4);
+    window.insert(3, 4);
+    QCOMPARE(window.median(), 4);
+    window.insert(4, 1);
+    QCOMPARE(window.median(), 4);
+    window.insert(5, 9);
+    QCOMPARE(window.numValues(), 6u);
+    QCOMPARE(window.median(), 4);
+
+    window.erase(2);
+    QVERIFY(!window.contains(2));
+    QCOMPARE(window.median(), 4);
+    window.erase(3);
+    QCOMPARE(window.median(), 5);
+    window.insert(2, -7);
+    QCOMPARE(window.median(), 3);
+    window.erase(0);
+    window.erase(5);
+    QCOMPARE(window.numValues(), 3u);
+    QCOMPARE(window.median(), 1);
+
+    window.clear();
+    QCOMPARE(window.numValues(), 0u);
+    QVERIFY(!window.contains(1));
+    window.insert(1, 8);
+    QCOMPARE(window.median(), 8);
+}
 
-    for (; i < 30; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
-    for (i = 0; i < 44; ++i)
+void TestMovingWindow::testMedianRandomInput_data()
+{
+    QTest::addColumn<int>("filterSize");
+    QTest::addColumn<int>("numDistinctValues");
+
+    for (int filterSize : {2, 7, 50, 51, 200})
     {
-        if (i % 6 < 2)
+        // few distinct values give many equal values in the window
+        for (int numDistinctValues : {3, 1000})
         {
-        input.getRank()[i] = 0;
+            QTest::addRow("%d_%d", filterSize, numDistinctValues) << filterSize << numDistinctValues;
         }
     }
-    Doublearray outputArray(input.size());
-    
-    MovingWindow<double> obj(g_BenchmarkFilterSize, calcMedian1d<double> , true);
-
-    
-    QBENCHMARK
-    {
-        obj.processCentric(input, outputArray);
-    }
-
 }
 
-
-void TestMovingWindow::benchmarkMedianOptimized()
+void TestMovingWindow::testMedianRandomInput()
 {
-    Doublearray input(44,0.1,255);
-    double value = -3;
-    int i = 2;
-    for ( ; i < 10;++i)
-    {
-        input.getData()[i] = ++value;
-    }
-    for (i =5; i < 15; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
+    QFETCH(int, filterSize);
+    QFETCH(int, numDistinctValues);
 
-    for (; i < 30; i+=2)
+    SlidingMedian<double> valuesInWindow(filterSize);
+    for (bool passThroughBadRank : {true, false})
     {
-        input.getData()[i] *= (-1.5);
-    }
-    for (i = 0; i < 44; ++i)
-    {
-        if (i % 6 < 2)
+        MovingWindow<double> movingWindowMedian(filterSize, calcMedian1d<double>, passThroughBadRank);
+        // the window is reused for several lines, like in the filters
+        for (unsigned int seed = 1; seed <= 3; ++seed)
         {
-        input.getRank()[i] = 0;
+            const auto input = createLine(700, numDistinctValues, seed);
+            Doublearray outputGeneric(input.size());
+            movingWindowMedian.processCentric(input, outputGeneric);
+
+            Doublearray outputOptimized(input.size());
+            MovingWindow<double>::movingMedian(input, outputOptimized, valuesInWindow, passThroughBadRank);
+            QCOMPARE(outputOptimized.getData(), outputGeneric.getData());
+            QCOMPARE(outputOptimized.getRank(), outputGeneric.getRank());
         }
     }
-    Doublearray outputArray(input.size());
-    QBENCHMARK
-    {
-        MovingWindow<double>::movingMedian(input, outputArray, g_BenchmarkFilterSize, true);
-    }
-
 }
 
-
-void TestMovingWindow::benchmarkMeanGeneric()
+void TestMovingWindow::benchmarkMedian_data()
 {
-    Doublearray input(44,0.1,255);
-    double value = -3;
-    int i = 2;
-    for ( ; i < 10;++i)
-    {
-        input.getData()[i] = ++value;
-    }
-    for (i =5; i < 15; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
+    QTest::addColumn<int>("filterSize");
+    QTest::addColumn<bool>("optimized");
 
-    for (; i < 30; i+=2)
+    for (int filterSize : {3, 11, 51, 101, 201})
     {
-        input.getData()[i] *= (-1.5);
+        QTest::addRow("generic_%d", filterSize) << filterSize << false;
+        QTest::addRow("optimized_%d", filterSize) << filterSize << true;
     }
-    for (i = 0; i < 44; ++i)
+}
+
+void TestMovingWindow::benchmarkMedian()
+{
+    QFETCH(int, filterSize);
+    QFETCH(bool, optimized);
+
+    const auto input = createLine(1024, 1000, 42);
+    Doublearray outputArray(input.size());
+    if (optimized)
     {
-        if (i % 6 < 2)
+        SlidingMedian<double> valuesInWindow(filterSize);
+        QBENCHMARK
         {
-        input.getRank()[i] = 0;
+            MovingWindow<double>::movingMedian(input, outputArray, valuesInWindow, true);
         }
     }
-    Doublearray outputArray(input.size());
-    
-    MovingWindow<double> obj(g_BenchmarkFilterSize, precitec::filter::calcMean<double> , true);
-
-    
-    QBENCHMARK
+    else
     {
-        obj.processCentric(input, outputArray);
+        MovingWindow<double> movingWindowMedian(filterSize, calcMedian1d<double>, true);
+        QBENCHMARK
+        {
+            movingWindowMedian.processCentric(input, outputArray);
+        }
     }
-
 }
 
+void TestMovingWindow::benchmarkMean_data()
+{
+    benchmarkMedian_data();
+}
 
-void TestMovingWindow::benchmarkMeanOptimized()
+void TestMovingWindow::benchmarkMean()
 {
-    Doublearray input(44,0.1,255);
-    double value = -3;
-    int i = 2;
-    for ( ; i < 10;++i)
-    {
-        input.getData()[i] = ++value;
-    }
-    for (i =5; i < 15; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
+    QFETCH(int, filterSize);
+    QFETCH(bool, optimized);
 
-    for (; i < 30; i+=2)
-    {
-        input.getData()[i] *= (-1.5);
-    }
-    for (i = 0; i < 44; ++i)
+    const auto input = createLine(1024, 1000, 42);
+    Doublearray outputArray(input.size());
+    if (optimized)
     {
-        if (i % 6 < 2)
+        QBENCHMARK
         {
-        input.getRank()[i] = 0;
+            MovingWindow<double>::movingMean(input, outputArray, filterSize, true);
         }
     }
-    Doublearray outputArray(input.size());
-    QBENCHMARK
+    else
     {
-        MovingWindow<double>::movingMean(input, outputArray, g_BenchmarkFilterSize, true);
+        MovingWindow<double> movingWindowMean(filterSize, precitec::filter::calcMean<double>, true);
+        QBENCHMARK
+        {
+            movingWindowMean.processCentric(input, outputArray);
+        }
     }
-
 }
 
-*/
-
-
 
 QTEST_MAIN(TestMovingWindow)
 #include "testMovingWindow.moc"
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+Dense lookup grid for pixelToWorld of one set of distortion coefficients.
+
+pixelToWorld inverts the worldToPixel polynomial iteratively. The grid stores
+its exact solution at nodes "step" pixels apart, points in between are
+interpolated bilinearly. The interpolation error is checked against the exact
+solver at every cell center when the grid is built, see sampledMaxDeviation.
+Points outside of the grid are converted with the exact solver.
+ **/
+class FieldDistortionLookup
+{
+public:
+    /**
+    Builds the grid for pixel positions relative to TCP in [xMin, xMax] x [yMin, yMax]
+     **/
+    FieldDistortionLookup(const std::vector<double>& distortionCoefficient, double xMin, double xMax, double yMin, double yMax, double step);
+
+    /**
+    Interpolated pixelToWorld, exact outside of the grid
+     **/
+    std::pair<double, double> pixelToWorld(double x, double y) const;
+
+    /**
+    Batch version of pixelToWorld, all arrays have count elements
+     **/
+    void pixelToWorld(const double* x, const double* y, double* u, double* v, std::size_t count) const;
+
+    bool contains(double x, double y) const;
+
+    /**
+    Largest distance (in world units) between the interpolated and the exact
+    solution at the cell centers. This is an estimate, not a bound: the error of the
+    bilinear interpolation is largest at the cell center only if the second derivatives
+    are constant within the cell, higher order terms of the distortion can move the
+    maximum elsewhere. For the polynomial model of the scanner field a dense sampling of
+    the cells stays below it, testDeviation allows 10 % more.
+     **/
+    double sampledMaxDeviation() const
+    {
+        return m_sampledMaxDeviation;
+    }
+
+    double step() const
+    {
+        return m_step;
+    }
+
+    const std::vector<double>& distortionCoefficient() const
+    {
+        return m_distortionCoefficient;
+    }
+
+    /**
+    Writes the grid to a binary file, which can be restored with load
+     **/
+    bool save(const std::string& fileName) const;
+
+    /**
+    Reads a grid written by save, returns nullptr if the file cannot be read
+     **/
+    static std::shared_ptr<FieldDistortionLookup> load(const std::string& fileName);
+
+    /**
+    Returns a grid for the distortion coefficients covering [xMin, xMax] x [yMin, yMax]
+    with a sampledMaxDeviation below tolerance. Grids are kept in memory and, if cacheDirectory
+    is not empty, in files in cacheDirectory. The step is refined until the tolerance
+    is met, if even a step of one pixel is not accurate enough nullptr is returned.
+    The grid is loaded or built without holding the cache lock.
+     **/
+    static std::shared_ptr<const FieldDistortionLookup> cached(const std::vector<double>& distortionCoefficient,
+        double xMin, double xMax, double yMin, double yMax, double tolerance, const std::string& cacheDirectory = {});
+
+    /**
+    Like cached, but only returns a grid which is already in memory
+     **/
+    static std::shared_ptr<const FieldDistortionLookup> findCached(const std::vector<double>& distortionCoefficient,
+        double xMin, double xMax, double yMin, double yMax, double tolerance);
+
+    /**
+    Number of grid nodes of the coarsest grid cached() tries for the range
+     **/
+    static std::size_t initialNodeCount(double xMin, double xMax, double yMin, double yMax);
+
+    static void clearCache();
+
+private:
+    FieldDistortionLookup() = default;
+    void computeSampledMaxDeviation();
+    bool usable(const std::vector<double>& distortionCoefficient, double xMin, double xMax, double yMin, double yMax, double tolerance) const;
+
+    std::vector<double> m_distortionCoefficient;
+    double m_xMin = 0.0;
+    double m_yMin = 0.0;
+    double m_step = 1.0;
+    std::size_t m_columns = 0;
+    std::size_t m_rows = 0;
+    std::vector<double> m_u; ///< world coordinates at the grid nodes, row major
+    std::vector<double> m_v;
+    double m_sampledMaxDeviation = 0.0;
+};
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -106,6 +107,22 @@ relative to laser focus point in world coordinate
  **/
 std::pair<double, double> pixelToWorld(double x, double y, const std::vector<double>& distortionCoefficient);
 
+/**
+Batch version of worldToPixel
+ **/
+std::vector<std::pair<double, double>> worldToPixel(const std::vector<std::pair<double, double>>& world, const std::vector<double>& distortionCoefficient);
+
+/**
+Batch version of pixelToWorld. If tolerance is greater than 0, a cached
+FieldDistortionLookup with a maximum deviation below tolerance (world units)
+is used instead of the iterative solver. The grid covers the bounding box of
+the points, rounded to 256 pixel, so that it can be reused for following
+batches. A new grid is only built if the batch has at least as many points as
+the coarsest grid has nodes, smaller batches use a grid only if it is already
+in memory. If no grid meets the tolerance, the exact solver is used.
+ **/
+std::vector<std::pair<double, double>> pixelToWorld(const std::vector<std::pair<double, double>>& pixel, const std::vector<double>& distortionCoefficient, double tolerance = 0.0, const std::string& cacheDirectory = {});
+
 std::pair<double, double> imageShift(const uint8_t *imageA, const uint8_t *imageB, int height, int width, std::ptrdiff_t strideA, std::ptrdiff_t strideB);
 
 int horizontalPeriod(uint8_t *image, int height, int width, std::ptrdiff_t stride);
@@ -139,6 +139,24 @@ ANALYZER_INTERFACE_API void calcBinarizeLocal(
 	byte									p_oDistToMeanIntensity,
 	image::BImage&							p_rImageOut);
 
+/**
+* @brief						Binarizes an image depending on the mean intensity of a window around each pixel or block.
+* @details						The window sums are taken from a summed area table, the cost does not depend on the window size. The window is clipped at the image border, all pixels are written.
+* @param p_rImageIn				Input image to be read.
+* @param p_oComparisonType		Comparison type 'smaller' / 'greater-equal'. Dark / bright regions will be set to 255.
+* @param p_oDistToMeanIntensity	Distance to mean window intensity.
+* @param p_oWindowSize			Side length of the window in pixel.
+* @param p_oBlockSize			Side length of the blocks sharing one threshold, 1 for a threshold per pixel.
+* @param p_rImageOut			Output binary image to be calculated. Contains only 0 and 255.
+*/
+ANALYZER_INTERFACE_API void calcBinarizeLocalIntegral(
+	const image::BImage&					p_rImageIn,
+	ComparisonType 							p_oComparisonType,
+	byte									p_oDistToMeanIntensity,
+	int										p_oWindowSize,
+	int										p_oBlockSize,
+	image::BImage&							p_rImageOut);
+
 /**
 * @brief						Eliminates single pixel > 0 if 5x5 neighboorhood is dark (0). Inplace.
 * @param p_rImageIn				Input image to be filtered.
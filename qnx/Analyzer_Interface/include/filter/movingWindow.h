@@ -16,6 +16,7 @@
 #include <tuple>					///< tuple
 #include <functional>				///< function
 #include <cassert>					///< assert
+#include <algorithm>				///< find
 
 #include "system/types.h"			///< byte type
 #include "module/moduleLogger.h"	///< wmLog
@@ -30,6 +31,256 @@ namespace precitec {
 namespace filter {
 
 
+/**
+ * @brief	Median of a sliding window in O(log n) per update.
+ * @details	The values are kept in two heaps: a max heap with the smaller half and a min heap with the larger half of the values.
+ *			Every value is identified by a slot, e.g. its position in a ring buffer. The heap position of each slot is tracked,
+ *			so that a value leaving the window is removed directly instead of lazily.
+ *			The median is the element at index n / 2 of the sorted values, like calcMedian.
+ *			Windows of up to 16 values are kept sorted instead, for these the heaps are slower than shifting a few values.
+*/
+template <typename T>
+class SlidingMedian {
+public:
+	/**
+	 * @param	p_oWindowSize			Maximal number of values, the slots are in [0, p_oWindowSize).
+	*/
+	explicit SlidingMedian(unsigned int p_oWindowSize = 0)
+	{
+		resize(p_oWindowSize);
+	}
+
+	/**
+	 * @brief	Sets the window size and removes all values.
+	*/
+	void resize(unsigned int p_oWindowSize)
+	{
+		m_oValues.assign(p_oWindowSize, T());
+		m_oHeapOfSlot.assign(p_oWindowSize, eNoHeap);
+		m_oPositionOfSlot.assign(p_oWindowSize, 0);
+		m_oLower.clear();
+		m_oUpper.clear();
+		m_oSorted.clear();
+		m_oSmallWindow = p_oWindowSize <= eMaxSortedWindowSize;
+		if (m_oSmallWindow)
+		{
+			m_oSorted.reserve(p_oWindowSize);
+		}
+		else
+		{
+			m_oLower.reserve(p_oWindowSize / 2);
+			m_oUpper.reserve(p_oWindowSize - p_oWindowSize / 2);
+		}
+	}
+
+	/**
+	 * @brief	Removes all values.
+	*/
+	void clear()
+	{
+		for (const auto oSlot : m_oLower)
+		{
+			m_oHeapOfSlot[oSlot] = eNoHeap;
+		}
+		for (const auto oSlot : m_oUpper)
+		{
+			m_oHeapOfSlot[oSlot] = eNoHeap;
+		}
+		for (const auto oSlot : m_oSorted)
+		{
+			m_oHeapOfSlot[oSlot] = eNoHeap;
+		}
+		m_oLower.clear();
+		m_oUpper.clear();
+		m_oSorted.clear();
+	}
+
+	unsigned int windowSize() const
+	{
+		return m_oValues.size();
+	}
+
+	unsigned int numValues() const
+	{
+		return m_oLower.size() + m_oUpper.size() + m_oSorted.size();
+	}
+
+	bool contains(unsigned int p_oSlot) const
+	{
+		return m_oHeapOfSlot[p_oSlot] != eNoHeap;
+	}
+
+	/**
+	 * @brief	Adds a value. The slot must be free.
+	*/
+	void insert(unsigned int p_oSlot, T p_oValue)
+	{
+		assert(p_oSlot < windowSize() && !contains(p_oSlot));
+		m_oValues[p_oSlot] = p_oValue;
+		if (m_oSmallWindow)
+		{
+			auto oPosition = m_oSorted.end();
+			while (oPosition != m_oSorted.begin() && p_oValue < m_oValues[*(oPosition - 1)])
+			{
+				--oPosition;
+			}
+			m_oSorted.insert(oPosition, p_oSlot);
+			m_oHeapOfSlot[p_oSlot] = eSorted;
+			return;
+		}
+		if (!m_oUpper.empty() && p_oValue < m_oValues[m_oUpper.front()])
+		{
+			push(eLower, p_oSlot);
+		}
+		else
+		{
+			push(eUpper, p_oSlot);
+		}
+		balance();
+	}
+
+	/**
+	 * @brief	Removes the value of a slot.
+	*/
+	void erase(unsigned int p_oSlot)
+	{
+		assert(p_oSlot < windowSize() && contains(p_oSlot));
+		if (m_oSmallWindow)
+		{
+			m_oSorted.erase(std::find(m_oSorted.begin(), m_oSorted.end(), p_oSlot));
+			m_oHeapOfSlot[p_oSlot] = eNoHeap;
+			return;
+		}
+		remove(p_oSlot);
+		balance();
+	}
+
+	/**
+	 * @brief	Median of the values, there must be at least one value.
+	*/
+	const T& median() const
+	{
+		assert(numValues() > 0);
+		if (m_oSmallWindow)
+		{
+			return m_oValues[m_oSorted[m_oSorted.size() / 2]];
+		}
+		return m_oValues[m_oUpper.front()];
+	}
+
+private:
+	enum Heap : unsigned char { eLower, eUpper, eSorted, eNoHeap };
+	// up to this size, shifting the values of a sorted window is cheaper than the bookkeeping of the heaps
+	enum { eMaxSortedWindowSize = 16 };
+
+	std::vector<unsigned int>& heap(Heap p_oHeap)
+	{
+		return p_oHeap == eLower ? m_oLower : m_oUpper;
+	}
+
+	// true if the first slot belongs closer to the top of the heap than the second one
+	bool isAbove(Heap p_oHeap, unsigned int p_oFirst, unsigned int p_oSecond) const
+	{
+		return p_oHeap == eLower ? m_oValues[p_oSecond] < m_oValues[p_oFirst] : m_oValues[p_oFirst] < m_oValues[p_oSecond];
+	}
+
+	void place(Heap p_oHeap, unsigned int p_oPosition, unsigned int p_oSlot)
+	{
+		heap(p_oHeap)[p_oPosition] = p_oSlot;
+		m_oHeapOfSlot[p_oSlot] = p_oHeap;
+		m_oPositionOfSlot[p_oSlot] = p_oPosition;
+	}
+
+	void siftUp(Heap p_oHeap, unsigned int p_oPosition)
+	{
+		auto& rHeap = heap(p_oHeap);
+		const unsigned int oSlot = rHeap[p_oPosition];
+		while (p_oPosition > 0)
+		{
+			const unsigned int oParent = (p_oPosition - 1) / 2;
+			if (!isAbove(p_oHeap, oSlot, rHeap[oParent]))
+			{
+				break;
+			}
+			place(p_oHeap, p_oPosition, rHeap[oParent]);
+			p_oPosition = oParent;
+		}
+		place(p_oHeap, p_oPosition, oSlot);
+	}
+
+	void siftDown(Heap p_oHeap, unsigned int p_oPosition)
+	{
+		auto& rHeap = heap(p_oHeap);
+		const unsigned int oSize = rHeap.size();
+		const unsigned int oSlot = rHeap[p_oPosition];
+		for (unsigned int oChild = 2 * p_oPosition + 1; oChild < oSize; oChild = 2 * p_oPosition + 1)
+		{
+			if (oChild + 1 < oSize && isAbove(p_oHeap, rHeap[oChild + 1], rHeap[oChild]))
+			{
+				++oChild;
+			}
+			if (!isAbove(p_oHeap, rHeap[oChild], oSlot))
+			{
+				break;
+			}
+			place(p_oHeap, p_oPosition, rHeap[oChild]);
+			p_oPosition = oChild;
+		}
+		place(p_oHeap, p_oPosition, oSlot);
+	}
+
+	void push(Heap p_oHeap, unsigned int p_oSlot)
+	{
+		heap(p_oHeap).push_back(p_oSlot);
+		siftUp(p_oHeap, heap(p_oHeap).size() - 1);
+	}
+
+	void remove(unsigned int p_oSlot)
+	{
+		const Heap oHeap = static_cast<Heap>(m_oHeapOfSlot[p_oSlot]);
+		auto& rHeap = heap(oHeap);
+		const unsigned int oPosition = m_oPositionOfSlot[p_oSlot];
+		const unsigned int oLast = rHeap.back();
+		rHeap.pop_back();
+		m_oHeapOfSlot[p_oSlot] = eNoHeap;
+		if (oLast == p_oSlot)
+		{
+			return;
+		}
+		// the last element fills the gap and moves up or down from there
+		place(oHeap, oPosition, oLast);
+		siftUp(oHeap, oPosition);
+		siftDown(oHeap, m_oPositionOfSlot[oLast]);
+	}
+
+	// moves the top of one heap to the other one until the lower heap has n / 2 values
+	void balance()
+	{
+		const unsigned int oLowerSize = numValues() / 2;
+		while (m_oLower.size() > oLowerSize)
+		{
+			const unsigned int oSlot = m_oLower.front();
+			remove(oSlot);
+			push(eUpper, oSlot);
+		}
+		while (m_oLower.size() < oLowerSize)
+		{
+			const unsigned int oSlot = m_oUpper.front();
+			remove(oSlot);
+			push(eLower, oSlot);
+		}
+	}
+
+	std::vector<T>				m_oValues;			///< value of each slot
+	std::vector<unsigned char>	m_oHeapOfSlot;		///< heap containing the slot
+	std::vector<unsigned int>	m_oPositionOfSlot;	///< position of the slot in its heap
+	std::vector<unsigned int>	m_oLower;			///< max heap of the slots with the n / 2 smallest values
+	std::vector<unsigned int>	m_oUpper;			///< min heap of the slots with the remaining values, its top is the median
+	std::vector<unsigned int>	m_oSorted;			///< slots in ascending order of their values, only used for small windows
+	bool						m_oSmallWindow = true;
+}; // SlidingMedian
+
+
 /**
  * @brief	Causal finite impulse result(FIR) filter. Parametrized with a functor object that contains the actual filter algorithm.
  * @details Moving window stateful functor, parametrized with filter function like calcMean or calcMedian. Uses a fixed length ringbuffer. Processes boundary values.
@@ -168,10 +419,14 @@ public:
 
 
     
+	/**
+	 * @brief	Same result as processCentric with calcMedian1d, but O(log n) per element instead of O(n).
+	 * @param	rValuesInWindow		Window of the filter, its window size is the filter length. Kept by the caller to avoid allocations.
+	*/
 	template<bool t_oPassThroughBadRank>
-	static void movingMedian(const geo2d::TArray<T> &p_rInput, geo2d::TArray<T> &p_rOutput, std::vector<T> & rValuesInWindow)
+	static void movingMedian(const geo2d::TArray<T> &p_rInput, geo2d::TArray<T> &p_rOutput, SlidingMedian<T> & rValuesInWindow)
     {
-        int p_oSizeFilter = rValuesInWindow.size();
+        const int p_oSizeFilter = rValuesInWindow.windowSize();
 
         // 1) check input
         p_rOutput.resize(p_rInput.size());
@@ -192,100 +447,32 @@ public:
 		auto itOutRank = p_rOutput.getRank().begin();
 
 
-        // 2) define the container for the window, and the helper function to update it
-        //the window is preallocated, but we update the oValuesInWindowSize
-        int oValuesInWindowSize = 0;
+        // 2) define the helper functions to update the window
+        // the slot of an input element is its position in a ring buffer of the filter length
+
+        rValuesInWindow.clear();
         
         int oRankSumInWindow = 0;
 
-        auto fAppendValuesInWindow = [&rValuesInWindow, &oRankSumInWindow, &p_oSizeFilter, & oValuesInWindowSize] (T const & rValueToAdd, int const & rRankToAdd )
+        auto fAddToValuesInWindow = [&rValuesInWindow, &oRankSumInWindow, &p_oSizeFilter] (int indexToAdd, T const & rValueToAdd, int const & rRankToAdd )
         {            
             oRankSumInWindow += (rRankToAdd);
             if (rRankToAdd != eRankMin)
             {
-                assert(oValuesInWindowSize < p_oSizeFilter);
-                rValuesInWindow[oValuesInWindowSize] = rValueToAdd;
-                oValuesInWindowSize ++;
+                rValuesInWindow.insert(indexToAdd % p_oSizeFilter, rValueToAdd);
             }
         };        
         
-                
-        auto fSearchValuesInWindow = [&rValuesInWindow, &oValuesInWindowSize] (T const & rValueToRemove, int const & rRankToRemove)
+        auto fRemoveFromValuesInWindow = [&rValuesInWindow, &oRankSumInWindow, &p_oSizeFilter] (int indexToRemove, int const & rRankToRemove)
         {
-            auto indexToRemove = -1;
+            oRankSumInWindow -= rRankToRemove;
             if (rRankToRemove != eRankMin)
             {
-                auto itEnd = rValuesInWindow.begin() + oValuesInWindowSize;
-                //we cannot assume that the value to remove is the first, because calcMedian partially reorders to oValuesInWindow
-                auto it =  std::find(rValuesInWindow.begin(), itEnd, rValueToRemove);
-#ifndef NDEBUG
-                if(it == itEnd)
-                {
-                    std::cout << " Cant find " << rValueToRemove << "  diffs: " ;
-                    for (auto && v: rValuesInWindow)
-                    {
-                        std::cout << v - rValueToRemove << " " ;
-                    }
-                    std::cout << std::endl;
-                    assert(false);
-                }
-            #endif
-                indexToRemove = it  - rValuesInWindow.begin();
-                assert(indexToRemove < oValuesInWindowSize);
-                assert(rValuesInWindow[indexToRemove] == rValueToRemove);
-               
-            }
-            return indexToRemove;
-    
-        };
-                
-        auto fRemoveFromWindowValues = [&rValuesInWindow, &oValuesInWindowSize] (int indexToRemove)
-        {
-            assert(indexToRemove >= 0 && indexToRemove < (int)(oValuesInWindowSize));
-            int lastIndex = oValuesInWindowSize - 1;
-            rValuesInWindow[indexToRemove] = rValuesInWindow[lastIndex];
-
-            oValuesInWindowSize = lastIndex;
-
-        };       
-        
-        auto fRemoveFromValuesInWindow = [&oRankSumInWindow, & fRemoveFromWindowValues, &fSearchValuesInWindow] (T const & rValueToRemove, int const & rRankToRemove)
-        {
-            if (rRankToRemove != eRankMin)
-            {
-                int indexToRemove = fSearchValuesInWindow(rValueToRemove, rRankToRemove);
-                assert(indexToRemove >= 0);
-                oRankSumInWindow -= rRankToRemove;
-                fRemoveFromWindowValues(indexToRemove);
-            }
-        };
-        
-        auto fUpdateValuesInWindow = [&rValuesInWindow, &oRankSumInWindow, &fAppendValuesInWindow, & fRemoveFromWindowValues, &fSearchValuesInWindow] (T const & rValueToRemove, int const & rRankToRemove, T const & rValueToAdd, int const & rRankToAdd )
-        {
-            auto indexToRemove = fSearchValuesInWindow(rValueToRemove, rRankToRemove);
-    
-            if (indexToRemove >= 0)
-            {                   
-                oRankSumInWindow -= rRankToRemove;
-
-                if (rRankToAdd != eRankMin)
-                {
-                    oRankSumInWindow += (rRankToAdd);
-                    rValuesInWindow[indexToRemove] = rValueToAdd;
-                }
-                else
-                {
-                    fRemoveFromWindowValues(indexToRemove);      
-                }
-            }
-            else
-            {
-                fAppendValuesInWindow(rValueToAdd, rRankToAdd);
+                rValuesInWindow.erase(indexToRemove % p_oSizeFilter);
             }
         };
-        
 
-        auto fWriteOutput = [&rValuesInWindow, &oRankSumInWindow, &oValuesInWindowSize](const int & rInRankAtOutputPosition, T  & rOutValue, int & rOutRank )
+        auto fWriteOutput = [&rValuesInWindow, &oRankSumInWindow](const int & rInRankAtOutputPosition, T  & rOutValue, int & rOutRank )
         {
             if (t_oPassThroughBadRank && rInRankAtOutputPosition == eRankMin )
             {
@@ -294,10 +481,10 @@ public:
             }
             else
             {
-                auto numValidValues = oValuesInWindowSize;
+                const int numValidValues = rValuesInWindow.numValues();
                 if (numValidValues > 0)
                 {
-                    rOutValue = * (filter::calcMedian(rValuesInWindow.begin(), rValuesInWindow.begin() + oValuesInWindowSize));
+                    rOutValue = rValuesInWindow.median();
                     rOutRank = oRankSumInWindow / numValidValues;
                 }
                 else
@@ -317,7 +504,7 @@ public:
         //contrarily to the comment, processCentric(calcMedian1d) computes the output from the incomplete buffer
         for(indexToRead = 0;  indexToRead < p_oSizeFilter;   ++indexToRead, ++indexOutput )
         {
-            fAppendValuesInWindow(rInData[indexToRead], rInRank[indexToRead]);
+            fAddToValuesInWindow(indexToRead, rInData[indexToRead], rInRank[indexToRead]);
     
             if (indexOutput>=0)
             {
@@ -336,7 +523,9 @@ public:
         for (int end = p_rInput.getData().size(); indexToRead < end;
            ++indexToRead, ++indexToRemove, ++itOutData, ++itOutRank, ++indexOutput)
         {
-            fUpdateValuesInWindow(rInData[indexToRemove], rInRank[indexToRemove], rInData[indexToRead], rInRank[indexToRead]);
+            // the removed and the added element share the slot
+            fRemoveFromValuesInWindow(indexToRemove, rInRank[indexToRemove]);
+            fAddToValuesInWindow(indexToRead, rInData[indexToRead], rInRank[indexToRead]);
             fWriteOutput(rInRank[indexOutput], *itOutData, *itOutRank );              
         }
         
@@ -345,14 +534,14 @@ public:
            ++indexToRemove, ++itOutData, ++itOutRank, ++indexOutput)
         {
             assert(indexToRemove < (int)p_rInput.size());
-            fRemoveFromValuesInWindow(rInData[indexToRemove], rInRank[indexToRemove]);
+            fRemoveFromValuesInWindow(indexToRemove, rInRank[indexToRemove]);
             fWriteOutput(rInRank[indexOutput], *itOutData, *itOutRank );              
         }
           
         
     } 
     
-	static void movingMedian(const geo2d::TArray<T> &p_rInput, geo2d::TArray<T> &p_rOutput, std::vector<T> & oValuesInWindow, bool p_oPassThroughBadRank)
+	static void movingMedian(const geo2d::TArray<T> &p_rInput, geo2d::TArray<T> &p_rOutput, SlidingMedian<T> & oValuesInWindow, bool p_oPassThroughBadRank)
     {
         if (p_oPassThroughBadRank)
         {
@@ -247,8 +247,9 @@ enum class BinarizeType {
 	eGlobal				= 0,		///< binarizes globally (global dynamic threshold)
 	eLocal,							///< binarizes locally (windowed dynamic threshold)
 	eStatic,						///< binarizes globally (global static threshold)
+	eLocalIntegral,					///< binarizes locally (windowed dynamic threshold from a summed area table)
 	eBinarizeTypeMin = eGlobal,		///< delimiter
-	eBinarizeTypeMax = eStatic		///< delimiter
+	eBinarizeTypeMax = eLocalIntegral	///< delimiter
 }; // BinarizeType
 
 /**
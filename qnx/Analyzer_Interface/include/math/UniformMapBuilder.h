@@ -57,6 +57,7 @@ class Calibration3DCoordsTransformer
         template<class UnaryOperationX, class UnaryOperationY>
         void applyTransformToInternalPlane(UnaryOperationX unary_op_x,UnaryOperationY unary_op_y)
         {
+            m_rCoords.arraysChanged();
             std::for_each(m_rCoords.m_oCoordsArrayX.begin(), m_rCoords.m_oCoordsArrayX.end(), unary_op_x);
             std::for_each(m_rCoords.m_oCoordsArrayY.begin(), m_rCoords.m_oCoordsArrayY.end(), unary_op_y);
         }
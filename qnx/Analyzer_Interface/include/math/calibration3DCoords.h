@@ -26,6 +26,7 @@
 #include "message/messageBuffer.h"
 #include "common/geoContext.h"
 #include "coordinates/linearMagnificationModel.h"
+#include "math/calibration3DCoordsSharedMemory.h"
 
 
 namespace precitec {
@@ -50,6 +51,25 @@ public:
 
     void completeInitialization (math::SensorModel pSensorModel);
 
+	/*
+	* @brief Publishes the coordinate arrays in shared memory, serialize then only sends a handle to them.
+	* @param p_oSensorId	Sensor, a new version replaces the previous version of the same sensor.
+	* @return			False if the arrays could not be published, they are then serialized as before.
+	*
+	* Unchanged arrays are not published again, so a change of the triangulation angles results in a small message.
+	* Changing the arrays afterwards drops the handle, copies share the generation of the arrays until they are changed.
+	*/
+	bool publishSharedMemory(int p_oSensorId);
+	const Calibration3DCoordsHandle & getSharedMemoryHandle() const;
+	/*
+	* @brief Serializes the arrays in the message again, e.g. if the receiver could not read the published arrays.
+	*/
+	void resetSharedMemoryHandle();
+	/*
+	* @brief True if deserialize could not read the published arrays, the coordinates must then not be used.
+	*/
+	bool coordinatesMissing() const;
+
 	/*
 	* @brief 2D to 3D method, internally used to to3D.
 	* @param &p_rX3D   Returned X coord.
@@ -75,6 +95,26 @@ public:
     Vec3D to3D(const int p_oX, const int p_oY, filter::LaserLine p_oLaserLine) const;
     Vec3D to3D(const Vec3D &p_rCoord2D, filter::LaserLine p_oLaserLine) const;
 
+	/*
+	* @brief Batch version of convertScreenTo3D, e.g. for all points of a laser line.
+	* @param p_pX3d, p_pY3d, p_pZ3d	Returned coords, p_oCount elements each. (0,0,0) for points without 3D coordinate.
+	* @param p_pValid	Optional (may be nullptr), p_oCount elements. False for points without 3D coordinate.
+	* @param p_pX, p_pY	2D screen coords, p_oCount elements each.
+	* @return			Number of valid points.
+	*
+	* Same result as convertScreenTo3D per point, but the laser line model, the sensor model and the
+	* triangulation angle are resolved once per call and the plane to world transformation is vectorized.
+	*/
+	std::size_t convertScreenTo3D(float *p_pX3d, float *p_pY3d, float *p_pZ3d, bool *p_pValid,
+		const int *p_pX, const int *p_pY, std::size_t p_oCount, filter::LaserLine p_oLaserLine) const;
+	/*
+	* @brief Batch version of convertScreenToLaserPlane, see batch version of convertScreenTo3D.
+	*/
+	std::size_t convertScreenToLaserPlane(float *p_pX2d, float *p_pY2d, bool *p_pValid,
+		const int *p_pX, const int *p_pY, std::size_t p_oCount, filter::LaserLine p_oLaserLine) const;
+
+    std::vector<Vec3D> to3D(const std::vector<geo2d::Point> &p_rCoords2D, filter::LaserLine p_oLaserLine) const;
+
 
 	double dist(const double &p_oX3d1, const double &p_oY3d1, const double &p_oZ3d1,
 			const double &p_oX3d2, const double &p_oY3d2, const double &p_oZ3d2) const;
@@ -202,6 +242,10 @@ private:
 
 	
     size_t getIndex(unsigned int x_pixel, unsigned int y_pixel) const;
+    //batch version of getCoordinates, invalid points are set to (0,0)
+    std::size_t getCoordinates(float * x_plane, float * y_plane, bool * valid, const int * x_pixel, const int * y_pixel, std::size_t count) const;
+    //the arrays may have been changed, the published arrays are outdated
+    void arraysChanged();
 	mapTriangAngles_t  m_oTriangAngles;  ///< Triangulation angle  in radian! (90 - (angle of rotation around x )
 	coordsArray_t m_oCoordsArrayX; /// Coordinates in mm on a plane
 	coordsArray_t m_oCoordsArrayY; /// Coordinates in mm on a plane
@@ -211,6 +255,9 @@ private:
 	math::SensorModel m_oSensorModel; //Scheimpflug or Coax give a different meaning to the internal plane
 
 	std::map<filter::LaserLine, coordinates::LinearMagnificationModel> m_oLinearMagnificationModels;
+	Calibration3DCoordsHandle m_oSharedMemoryHandle; ///< valid while the published arrays are equal to m_oCoordsArrayX, m_oCoordsArrayY
+	std::uint64_t m_oArraysGeneration = 0; ///< identifies the content of the arrays when publishing them, 0 after a change
+	bool m_oCoordinatesMissing = false; ///< set by deserialize if the published arrays could not be read, the arrays are empty
 
 	
 	friend Calibration3DCoordsTransformer;
@@ -286,7 +333,13 @@ public:
         }
 		return m_r3DCoords.to3D(X, Y, m_oLaserLine);
 	}
-	
+
+	/**
+	* Batch version of imageCoordTo3D, converts all points with one call to the calibration.
+	* Points without 3D coordinate are returned as (0,0,0), like in imageCoordTo3D.
+	*/
+	std::vector<math::Vec3D> imageCoordsTo3D(const std::vector<geo2d::Point> & rImagePoints) const;
+
 	std::vector<geo2d::DPoint> distanceTCPmmToImageCoordCoax(const std::vector<geo2d::DPoint>& contour_mm, double tcpSensorX, double tcpSensorY) const
 	{
         if (m_r3DCoords.isScheimpflugCase())
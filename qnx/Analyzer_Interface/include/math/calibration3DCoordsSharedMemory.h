@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Analyzer_Interface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace precitec {
+namespace math {
+
+/**
+ * Identifies one version of the coordinate arrays of a Calibration3DCoords, published
+ * with Calibration3DCoordsSharedMemory::publish. Only the handle is sent over the
+ * calibration interface, see Calibration3DCoords::serialize.
+ **/
+struct Calibration3DCoordsHandle
+{
+    std::string name;
+    std::uint32_t version = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+
+    bool isValid() const
+    {
+        return !name.empty();
+    }
+};
+
+/**
+ * Shared memory transport for the per pixel coordinate arrays of Calibration3DCoords.
+ *
+ * The publisher writes each version of the arrays once into its own segment, the
+ * previous segment of the same sensor is unlinked. As the calibration messages are
+ * synchronous, a consumer has mapped the previous segment before the next one is published.
+ * The caller identifies the content of the arrays with a generation, publishing the
+ * generation of the current version returns the current handle without comparing the arrays.
+ * So changes of the triangulation angles or of the sensor model are sent as small messages.
+ *
+ * The segment names contain the pid of the publisher. The segments are unlinked when the
+ * process exits, segments of a publisher which did not exit cleanly are unlinked by the
+ * first publish of the next run.
+ *
+ * Consumers map the segments read-only and keep the last few mappings, a handle which
+ * has been read before does not require to open and map the segment again.
+ **/
+class ANALYZER_INTERFACE_API Calibration3DCoordsSharedMemory
+{
+public:
+    /**
+     * Publishes the arrays of width * height coordinates for the sensor.
+     * If the current version of the sensor has the same generation and size, its handle is returned.
+     * Returns an invalid handle if the segment cannot be created.
+     **/
+    static Calibration3DCoordsHandle publish(int sensorId, std::uint64_t generation, const std::vector<float>& x, const std::vector<float>& y, std::size_t width, std::size_t height);
+
+    /**
+     * Copies the arrays of a published version into x and y.
+     * Returns false if the segment does not exist (anymore) or does not match the handle.
+     **/
+    static bool read(const Calibration3DCoordsHandle& handle, std::vector<float>& x, std::vector<float>& y);
+
+    /**
+     * Unlinks all segments published by this process and drops all mappings.
+     **/
+    static void release();
+
+    /**
+     * Unlinks the segments of publishers which are not running anymore.
+     * Called by the first publish of the process.
+     **/
+    static void unlinkStaleSegments();
+};
+
+}
+}
@@ -12,8 +12,13 @@
 #include "system/typeTraits.h"
 #include "module/moduleLogger.h"		///< logger
 #include "filter/samplingInformation.h"
+#include <config-weldmaster.h>
 #include <cmath>
+#include <cstdint>
 #include <random>
+#if HAVE_SSE4
+#include <emmintrin.h>
+#endif
 
 namespace precitec {
 	using namespace	image;
@@ -349,6 +354,163 @@ void calcBinarizeLocal(
 
 
 
+namespace
+{
+
+/**
+* Summed area table with a leading row and column of zeros, p_rTable[y * (width + 1) + x] is the sum of the pixels above and left of (x, y).
+* The sums wrap around for very large images, the difference of four entries is still exact as long as the window sum fits into 32 bit.
+*/
+void calcSummedAreaTable(const BImage& p_rImageIn, std::vector<std::uint32_t>& p_rTable)
+{
+	const int oWidth = p_rImageIn.width();
+	const int oHeight = p_rImageIn.height();
+	const int oStride = oWidth + 1;
+	p_rTable.assign(std::size_t(oStride) * (oHeight + 1), 0);
+	for (int oY = 0; oY < oHeight; ++oY) {
+		const byte* pLine = p_rImageIn[oY];
+		const std::uint32_t* pAbove = p_rTable.data() + std::size_t(oY) * oStride;
+		std::uint32_t* pCurrent = p_rTable.data() + std::size_t(oY + 1) * oStride;
+		std::uint32_t oRowSum = 0;
+		for (int oX = 0; oX < oWidth; ++oX) {
+			oRowSum += pLine[oX];
+			pCurrent[oX + 1] = pAbove[oX + 1] + oRowSum;
+		} // for
+	} // for
+} // calcSummedAreaTable
+
+/**
+* Writes 255 where the pixel is less than the threshold (p_oLess) or greater equal (!p_oLess), else 0.
+*/
+void compareRow(const byte* p_pLine, const std::int16_t* p_pThreshold, bool p_oLess, byte* p_pLineOut, int p_oWidth)
+{
+	int oX = 0;
+#if HAVE_SSE4
+	const __m128i oZero = _mm_setzero_si128();
+	const __m128i oInvert = p_oLess ? oZero : _mm_set1_epi8(-1);
+	for (; oX + 16 <= p_oWidth; oX += 16) {
+		const __m128i oPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pLine + oX));
+		const __m128i oThresholdLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pThreshold + oX));
+		const __m128i oThresholdHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pThreshold + oX + 8));
+		const __m128i oLessLow = _mm_cmplt_epi16(_mm_unpacklo_epi8(oPixels, oZero), oThresholdLow);
+		const __m128i oLessHigh = _mm_cmplt_epi16(_mm_unpackhi_epi8(oPixels, oZero), oThresholdHigh);
+		// the masks are 0 or -1, the signed saturation keeps them as 0 and 255
+		const __m128i oLess = _mm_packs_epi16(oLessLow, oLessHigh);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p_pLineOut + oX), _mm_xor_si128(oLess, oInvert));
+	} // for
+#endif
+	for (; oX < p_oWidth; ++oX) {
+		p_pLineOut[oX] = ((p_pLine[oX] < p_pThreshold[oX]) == p_oLess) ? 255 : 0;
+	} // for
+} // compareRow
+
+} // namespace
+
+
+
+void calcBinarizeLocalIntegral(
+	const image::BImage&					p_rImageIn,
+	ComparisonType 							p_oComparisonType,
+	byte									p_oDistToMeanIntensity,
+	int										p_oWindowSize,
+	int										p_oBlockSize,
+	image::BImage&							p_rImageOut) {
+	assert(p_rImageIn.size() == p_rImageOut.size());
+	poco_assert_dbg(p_oWindowSize > 0);
+	poco_assert_dbg(p_oBlockSize > 0);
+
+	const int oWidth = p_rImageIn.width();
+	const int oHeight = p_rImageIn.height();
+	const int oStride = oWidth + 1;
+	const int oWindowSize = std::max(p_oWindowSize, 1);
+	const int oBlockSize = std::max(p_oBlockSize, 1);
+	const int oOffset = (oWindowSize - oBlockSize) / 2;	// window start relative to the block start
+	const int oDistance = p_oComparisonType == eGreaterEqual ? p_oDistToMeanIntensity : -p_oDistToMeanIntensity;
+
+	// filters of the same graph run in parallel
+	thread_local std::vector<std::uint32_t> tTable;
+	thread_local std::vector<std::int16_t> tThresholdRow;
+	calcSummedAreaTable(p_rImageIn, tTable);
+	tThresholdRow.resize(oWidth);
+	const std::uint32_t* pTable = tTable.data();
+	std::int16_t* pThresholdRow = tThresholdRow.data();
+
+	for (int oBlockY = 0; oBlockY < oHeight; oBlockY += oBlockSize) {
+		// a window smaller than the block may lie behind the end of the last block, it keeps at least one row and column
+		const int oTop = std::min(std::max(oBlockY - oOffset, 0), oHeight - 1);
+		const int oBottom = std::max(std::min(oBlockY - oOffset + oWindowSize, oHeight), oTop + 1);
+		const std::uint32_t* pTop = pTable + std::size_t(oTop) * oStride;
+		const std::uint32_t* pBottom = pTable + std::size_t(oBottom) * oStride;
+
+		auto fSetThreshold = [pThresholdRow, oBlockSize, oWidth, oDistance] (int p_oBlockX, std::uint32_t p_oMean) {
+			const auto oThreshold = static_cast<std::int16_t>(int(p_oMean) + oDistance);
+			if (oBlockSize == 1) {
+				pThresholdRow[p_oBlockX] = oThreshold;
+			}
+			else {
+				std::fill(pThresholdRow + p_oBlockX, pThresholdRow + std::min(p_oBlockX + oBlockSize, oWidth), oThreshold);
+			}
+		};
+		auto fClippedMean = [pTop, pBottom, oOffset, oWindowSize, oWidth, oTop, oBottom] (int p_oBlockX) {
+			const int oLeft = std::min(std::max(p_oBlockX - oOffset, 0), oWidth - 1);
+			const int oRight = std::max(std::min(p_oBlockX - oOffset + oWindowSize, oWidth), oLeft + 1);
+			const std::uint32_t oSum = pBottom[oRight] - pBottom[oLeft] - pTop[oRight] + pTop[oLeft];
+			return oSum / (std::uint32_t(oBottom - oTop) * (oRight - oLeft));
+		};
+
+		int oBlockX = 0;
+		// windows clipped at the left border
+		for (; oBlockX < oWidth && oBlockX - oOffset < 0; oBlockX += oBlockSize) {
+			fSetThreshold(oBlockX, fClippedMean(oBlockX));
+		} // for
+
+		const std::uint32_t oInnerArea = std::uint32_t(oBottom - oTop) * oWindowSize;
+#if HAVE_SSE4
+		// per pixel thresholds, 8 at once. Sum and area are exact in float and the quotient is at least 1 / area away
+		// from the next integer, which is more than the rounding error below 256, the truncated division is the integer division.
+		if (oBlockSize == 1 && oInnerArea < (1u << 16)) {
+			const __m128 oArea = _mm_set1_ps(float(oInnerArea));
+			const __m128i oDistance8 = _mm_set1_epi32(oDistance);
+			auto fThreshold4 = [pTop, pBottom, oArea, oDistance8] (int p_oLeft, int p_oRight) {
+				auto fLoad = [] (const std::uint32_t* p_pSums) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pSums)); };
+				const __m128i oSum = _mm_add_epi32(_mm_sub_epi32(fLoad(pBottom + p_oRight), fLoad(pBottom + p_oLeft)),
+					_mm_sub_epi32(fLoad(pTop + p_oLeft), fLoad(pTop + p_oRight)));
+				return _mm_add_epi32(_mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(oSum), oArea)), oDistance8);
+			};
+			for (; oBlockX + 8 <= oWidth && oBlockX + 8 - oOffset + oWindowSize <= oWidth; oBlockX += 8) {
+				const int oLeft = oBlockX - oOffset;
+				const int oRight = oLeft + oWindowSize;
+				const __m128i oThresholds = _mm_packs_epi32(fThreshold4(oLeft, oRight), fThreshold4(oLeft + 4, oRight + 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pThresholdRow + oBlockX), oThresholds);
+			} // for
+		} // if
+#endif
+
+		// inner windows have the same area, the division by it is a multiplication:
+		// floor(sum * ceil(2^48 / area) / 2^48) is exact for sum <= 255 * area < 2^48 / area
+		if (oInnerArea < (1u << 20)) {
+			const std::uint64_t oReciprocal = ((std::uint64_t(1) << 48) + oInnerArea - 1) / oInnerArea;
+			for (; oBlockX < oWidth && oBlockX - oOffset + oWindowSize <= oWidth; oBlockX += oBlockSize) {
+				const int oLeft = oBlockX - oOffset;
+				const int oRight = oLeft + oWindowSize;
+				const std::uint32_t oSum = pBottom[oRight] - pBottom[oLeft] - pTop[oRight] + pTop[oLeft];
+				fSetThreshold(oBlockX, std::uint32_t((oSum * oReciprocal) >> 48));
+			} // for
+		} // if
+
+		// windows clipped at the right border
+		for (; oBlockX < oWidth; oBlockX += oBlockSize) {
+			fSetThreshold(oBlockX, fClippedMean(oBlockX));
+		} // for
+
+		for (int oY = oBlockY; oY < std::min(oBlockY + oBlockSize, oHeight); ++oY) {
+			compareRow(p_rImageIn[oY], pThresholdRow, p_oComparisonType == eLess, p_rImageOut[oY], oWidth);
+		} // for
+	} // for
+} // calcBinarizeLocalIntegral
+
+
+
 void filterBinNoise5x5(image::BImage& p_rImageIn)
 {
 	const int cols = p_rImageIn.width();
@@ -1,6 +1,12 @@
 #include "calibration3DCoords.h"
+#include <config-weldmaster.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#if HAVE_SSE4
+#include <smmintrin.h>
+#endif
 
 #include "common/defines.h"
 #include "image/image.h"
@@ -34,7 +40,15 @@ void Calibration3DCoords::serialize ( system::message::MessageBuffer &buffer ) c
 {
     marshal(buffer, m_oSensorWidth );
     marshal(buffer, m_oSensorHeight);
-    if (!usesOrientedLineCalibration())
+    //published coordinates are read by the receiver from shared memory
+    const bool oSharedMemory = !usesOrientedLineCalibration() && m_oSharedMemoryHandle.isValid();
+    marshal(buffer, oSharedMemory);
+    if (oSharedMemory)
+    {
+        marshal(buffer, m_oSharedMemoryHandle.name);
+        marshal(buffer, int(m_oSharedMemoryHandle.version));
+    }
+    else if (!usesOrientedLineCalibration())
     {
         assert(buffer.hasSpace(2 * sizeof(float) * m_oCoordsArrayX.size()));
         marshal(buffer, m_oCoordsArrayX, m_oCoordsArrayX.size());
@@ -67,13 +81,41 @@ void Calibration3DCoords::serialize ( system::message::MessageBuffer &buffer ) c
 
 void Calibration3DCoords::deserialize( system::message::MessageBuffer const&buffer )
 {
+    arraysChanged();
+    m_oCoordinatesMissing = false;
     deMarshal(buffer, m_oSensorWidth);
     deMarshal(buffer, m_oSensorHeight);
-    deMarshal(buffer, m_oCoordsArrayX );
-    deMarshal(buffer, m_oCoordsArrayY );
+    bool oSharedMemory = false;
+    deMarshal(buffer, oSharedMemory);
+    if (oSharedMemory)
+    {
+        Calibration3DCoordsHandle oHandle;
+        int oVersion = 0;
+        deMarshal(buffer, oHandle.name);
+        deMarshal(buffer, oVersion);
+        oHandle.version = oVersion;
+        oHandle.width = m_oSensorWidth;
+        oHandle.height = m_oSensorHeight;
+        if (!Calibration3DCoordsSharedMemory::read(oHandle, m_oCoordsArrayX, m_oCoordsArrayY))
+        {
+            //no zero filled arrays, the receiver has to reject the coordinates
+            wmLog(eWarning, "Calibration coordinates %s not available\n", oHandle.name.c_str());
+            m_oCoordsArrayX.clear();
+            m_oCoordsArrayY.clear();
+            m_oCoordinatesMissing = true;
+        }
+    }
+    else
+    {
+        deMarshal(buffer, m_oCoordsArrayX );
+        deMarshal(buffer, m_oCoordsArrayY );
+    }
 
-    m_oCoordsArrayX.resize(m_oSensorWidth * m_oSensorHeight);
-    m_oCoordsArrayY.resize(m_oSensorWidth * m_oSensorHeight);
+    if (!m_oCoordinatesMissing)
+    {
+        m_oCoordsArrayX.resize(m_oSensorWidth * m_oSensorHeight);
+        m_oCoordsArrayY.resize(m_oSensorWidth * m_oSensorHeight);
+    }
     
     int oNumAngles;
     mapTriangAngles_t tmp_mapTriangAngles;
@@ -472,17 +514,61 @@ size_t Calibration3DCoords::getIndex(unsigned int x_pixel, unsigned int y_pixel)
 
 float & Calibration3DCoords::X(unsigned int x_pixel, unsigned int y_pixel)
 {
+    arraysChanged();
     auto & r_x = m_oCoordsArrayX[getIndex(x_pixel, y_pixel)];
     return r_x;
 }
 float & Calibration3DCoords::Y(unsigned int x_pixel, unsigned int y_pixel)
 {
+    arraysChanged();
     auto & r_y = m_oCoordsArrayY[getIndex(x_pixel, y_pixel)];
     return r_y;
 }
-    
+
+bool Calibration3DCoords::publishSharedMemory(int p_oSensorId)
+{
+    if (usesOrientedLineCalibration())
+    {
+        //nothing to publish, the arrays are not serialized
+        return true;
+    }
+    if (m_oArraysGeneration == 0)
+    {
+        static std::atomic<std::uint64_t> s_oLastGeneration{0};
+        m_oArraysGeneration = ++s_oLastGeneration;
+    }
+    m_oSharedMemoryHandle = Calibration3DCoordsSharedMemory::publish(p_oSensorId, m_oArraysGeneration, m_oCoordsArrayX, m_oCoordsArrayY, m_oSensorWidth, m_oSensorHeight);
+    return m_oSharedMemoryHandle.isValid();
+}
+
+const Calibration3DCoordsHandle & Calibration3DCoords::getSharedMemoryHandle() const
+{
+    return m_oSharedMemoryHandle;
+}
+
+void Calibration3DCoords::resetSharedMemoryHandle()
+{
+    m_oSharedMemoryHandle = Calibration3DCoordsHandle{};
+}
+
+bool Calibration3DCoords::coordinatesMissing() const
+{
+    return m_oCoordinatesMissing;
+}
+
+void Calibration3DCoords::arraysChanged()
+{
+    if (m_oSharedMemoryHandle.isValid())
+    {
+        m_oSharedMemoryHandle = Calibration3DCoordsHandle{};
+    }
+    m_oArraysGeneration = 0;
+}
+
 void Calibration3DCoords::resetGridCellData(const int & pWidth, const int & pHeight, const math::SensorModel & pSensorModel)
 {
+    arraysChanged();
+    m_oCoordinatesMissing = false;
     m_oSensorWidth = pWidth;
     m_oSensorHeight = pHeight;
 	if ( pWidth == 0 && pHeight == 0 )
@@ -565,6 +651,266 @@ Vec3D Calibration3DCoords::to3D(const Vec3D &p_rCoord2D, filter::LaserLine p_oLa
 	return Vec3D(oX, oY, oZ);  // remains unchanged if oOK == false
 }
 
+namespace
+{
+
+#if HAVE_SSE4
+// value * factor, computed in double precision like the scalar code path
+inline __m128 multiplyDouble(__m128 value, __m128d factor)
+{
+	const __m128d oLow = _mm_mul_pd(_mm_cvtps_pd(value), factor);
+	const __m128d oHigh = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(value, value)), factor);
+	return _mm_movelh_ps(_mm_cvtpd_ps(oLow), _mm_cvtpd_ps(oHigh));
+}
+
+// value / divisor, computed in double precision like the scalar code path
+inline __m128 divideDouble(__m128 value, __m128d divisor)
+{
+	const __m128d oLow = _mm_div_pd(_mm_cvtps_pd(value), divisor);
+	const __m128d oHigh = _mm_div_pd(_mm_cvtps_pd(_mm_movehl_ps(value, value)), divisor);
+	return _mm_movelh_ps(_mm_cvtpd_ps(oLow), _mm_cvtpd_ps(oHigh));
+}
+#endif
+
+// scheimpflug case: y = yPlane * sin(alpha), z = yPlane * cos(alpha)
+void laserPlaneToWorld(float *p_pY, float *p_pZ, std::size_t p_oCount, double p_oSin, double p_oCos)
+{
+	std::size_t i = 0;
+#if HAVE_SSE4
+	const __m128d oSin = _mm_set1_pd(p_oSin);
+	const __m128d oCos = _mm_set1_pd(p_oCos);
+	for (; i + 4 <= p_oCount; i += 4)
+	{
+		const __m128 oYPlane = _mm_loadu_ps(p_pY + i);
+		_mm_storeu_ps(p_pZ + i, multiplyDouble(oYPlane, oCos));
+		_mm_storeu_ps(p_pY + i, multiplyDouble(oYPlane, oSin));
+	}
+#endif
+	for (; i < p_oCount; ++i)
+	{
+		const float oYPlane = p_pY[i];
+		p_pY[i] = oYPlane * p_oSin;
+		p_pZ[i] = oYPlane * p_oCos;
+	}
+}
+
+// coax case: y = yPlane, z = yPlane / tan(alpha)
+void horizontalPlaneToWorld(const float *p_pY, float *p_pZ, std::size_t p_oCount, float p_oTan)
+{
+	std::size_t i = 0;
+#if HAVE_SSE4
+	const __m128 oTan = _mm_set1_ps(p_oTan);
+	for (; i + 4 <= p_oCount; i += 4)
+	{
+		_mm_storeu_ps(p_pZ + i, _mm_div_ps(_mm_loadu_ps(p_pY + i), oTan));
+	}
+#endif
+	for (; i < p_oCount; ++i)
+	{
+		p_pZ[i] = p_pY[i] / p_oTan;
+	}
+}
+
+// coax case: yLaserPlane = yPlane / sin(alpha)
+void horizontalPlaneToLaserPlane(float *p_pY, std::size_t p_oCount, double p_oSin)
+{
+	std::size_t i = 0;
+#if HAVE_SSE4
+	const __m128d oSin = _mm_set1_pd(p_oSin);
+	for (; i + 4 <= p_oCount; i += 4)
+	{
+		_mm_storeu_ps(p_pY + i, divideDouble(_mm_loadu_ps(p_pY + i), oSin));
+	}
+#endif
+	for (; i < p_oCount; ++i)
+	{
+		p_pY[i] = p_pY[i] / p_oSin;
+	}
+}
+
+}
+
+std::size_t Calibration3DCoords::getCoordinates(float * x_plane, float * y_plane, bool * valid, const int * x_pixel, const int * y_pixel, std::size_t count) const
+{
+	int oWidth, oHeight;
+	getSensorSize(oWidth, oHeight);
+
+	std::size_t oNumValid = 0;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const int x = x_pixel[i];
+		const int y = y_pixel[i];
+		bool oValid = false;
+		if ( x >= 0 && x < oWidth && y >= 0 && y < oHeight )
+		{
+			const auto index = m_oSensorWidth * y + x;
+			x_plane[i] = m_oCoordsArrayX[index];
+			y_plane[i] = m_oCoordsArrayY[index];
+			oValid = isValidCoord(x_plane[i], y_plane[i]);
+		}
+		if ( !oValid )
+		{
+			//rare case: out of range or invalid, the scalar version handles the origin
+			oValid = getCoordinates(x_plane[i], y_plane[i], x, y);
+			if ( !oValid )
+			{
+				x_plane[i] = 0.0;
+				y_plane[i] = 0.0;
+			}
+		}
+		if ( valid )
+		{
+			valid[i] = oValid;
+		}
+		oNumValid += oValid;
+	}
+	return oNumValid;
+}
+
+std::size_t Calibration3DCoords::convertScreenTo3D(float *p_pX3d, float *p_pY3d, float *p_pZ3d, bool *p_pValid,
+	const int *p_pX, const int *p_pY, std::size_t p_oCount, filter::LaserLine p_oLaserLine) const
+{
+    auto itModel = m_oLinearMagnificationModels.find(p_oLaserLine);
+    if (itModel != m_oLinearMagnificationModels.end())
+    {
+        std::size_t oNumValid = 0;
+        for (std::size_t i = 0; i < p_oCount; ++i)
+        {
+            const auto result = itModel->second.laserScreenCoordinatesTo3D(p_pX[i], p_pY[i]);
+            p_pX3d[i] = result.first ? result.second.x : 0.0;
+            p_pY3d[i] = result.first ? result.second.y : 0.0;
+            p_pZ3d[i] = result.first ? result.second.z : 0.0;
+            if (p_pValid)
+            {
+                p_pValid[i] = result.first;
+            }
+            oNumValid += result.first;
+        }
+        return oNumValid;
+    }
+
+	if ( p_oLaserLine >= filter::LaserLine::NumberLaserLines )
+	{
+		wmLog(eWarning, "Wrong laser line requested\n");
+		std::fill(p_pX3d, p_pX3d + p_oCount, 0.0);
+		std::fill(p_pY3d, p_pY3d + p_oCount, 0.0);
+		std::fill(p_pZ3d, p_pZ3d + p_oCount, 0.0);
+		if (p_pValid)
+		{
+			std::fill(p_pValid, p_pValid + p_oCount, false);
+		}
+		return 0;
+	}
+
+	//plane coordinates, the y coordinate is transformed in place
+	const auto oNumValid = getCoordinates(p_pX3d, p_pY3d, p_pValid, p_pX, p_pY, p_oCount);
+
+	auto oTriangAngle = getTriangulationAngle(angleUnit::eRadians, p_oLaserLine);
+    if ( isScheimpflugCase() )
+    {
+        laserPlaneToWorld(p_pY3d, p_pZ3d, p_oCount, sin(oTriangAngle), cos(oTriangAngle));
+    }
+    else
+    {
+        assert(m_oSensorModel == SensorModel::eLinearMagnification);
+        float oTan = static_cast<float>(std::tan(oTriangAngle));
+        if ( oTan == 0.0 )
+        {
+            wmLog(eWarning, "Triangulation angle is 0 \n");
+            oTan = 1.0;
+        }
+        horizontalPlaneToWorld(p_pY3d, p_pZ3d, p_oCount, oTan);
+    }
+    return oNumValid;
+}
+
+std::size_t Calibration3DCoords::convertScreenToLaserPlane(float *p_pX2d, float *p_pY2d, bool *p_pValid,
+	const int *p_pX, const int *p_pY, std::size_t p_oCount, filter::LaserLine p_oLaserLine) const
+{
+    auto itModel = m_oLinearMagnificationModels.find(p_oLaserLine);
+    if (itModel != m_oLinearMagnificationModels.end())
+    {
+        std::size_t oNumValid = 0;
+        for (std::size_t i = 0; i < p_oCount; ++i)
+        {
+            const auto result = itModel->second.laserScreenCoordinatesToLaserPlane(p_pX[i], p_pY[i]);
+            p_pX2d[i] = result.first ? result.second.x : 0.0;
+            p_pY2d[i] = result.first ? result.second.y : 0.0;
+            if (p_pValid)
+            {
+                p_pValid[i] = result.first;
+            }
+            oNumValid += result.first;
+        }
+        return oNumValid;
+    }
+
+	if ( p_oLaserLine >= filter::LaserLine::NumberLaserLines )
+	{
+		wmLog(eDebug, "Wrong laser line requested\n");
+	}
+
+	const auto oNumValid = getCoordinates(p_pX2d, p_pY2d, p_pValid, p_pX, p_pY, p_oCount);
+    if ( m_oSensorModel != SensorModel::eCalibrationGridOnLaserPlane )
+    {
+        assert(m_oSensorModel == SensorModel::eLinearMagnification);
+        auto oTriangAngle = getTriangulationAngle(angleUnit::eRadians, p_oLaserLine);
+        if ( oTriangAngle != 0 )
+        {
+            horizontalPlaneToLaserPlane(p_pY2d, p_oCount, sin(oTriangAngle));
+        }
+    }
+    return oNumValid;
+}
+
+std::vector<Vec3D> Calibration3DCoords::to3D(const std::vector<Point> &p_rCoords2D, filter::LaserLine p_oLaserLine) const
+{
+	const auto oCount = p_rCoords2D.size();
+	std::vector<int> oScreenX(oCount), oScreenY(oCount);
+	for (std::size_t i = 0; i < oCount; ++i)
+	{
+		oScreenX[i] = p_rCoords2D[i].x;
+		oScreenY[i] = p_rCoords2D[i].y;
+	}
+	std::vector<float> oX(oCount), oY(oCount), oZ(oCount);
+	convertScreenTo3D(oX.data(), oY.data(), oZ.data(), nullptr, oScreenX.data(), oScreenY.data(), oCount, p_oLaserLine);
+
+	std::vector<Vec3D> oResult;
+	oResult.reserve(oCount);
+	for (std::size_t i = 0; i < oCount; ++i)
+	{
+		oResult.emplace_back(oX[i], oY[i], oZ[i]);
+	}
+	return oResult;
+}
+
+std::vector<math::Vec3D> ImageCoordsTo3DCoordsTransformer::imageCoordsTo3D(const std::vector<geo2d::Point> & rImagePoints) const
+{
+	if (m_transposed)
+	{
+		wmLog(eError, "%s for transposed context not implemented\n", __FUNCTION__);
+	}
+	std::vector<Point> oSensorPoints;
+	oSensorPoints.reserve(rImagePoints.size());
+	for (const auto & rPoint : rImagePoints)
+	{
+		oSensorPoints.push_back(getSensorPoint(rPoint.x, rPoint.y));
+	}
+	if (m_2DMeasurement)
+	{
+		std::vector<math::Vec3D> oResult;
+		oResult.reserve(oSensorPoints.size());
+		for (const auto & rPoint : oSensorPoints)
+		{
+			float oX2d, oY2d;
+			m_r3DCoords.convertScreenToHorizontalPlane(oX2d, oY2d, rPoint.x, rPoint.y);
+			oResult.emplace_back(oX2d, oY2d, 0.0);
+		}
+		return oResult;
+	}
+	return m_r3DCoords.to3D(oSensorPoints, m_oLaserLine);
+}
+
 void Calibration3DCoords::coordsToCheckerBoardImage(
 	BImage & pImage,
 	const Point & pRoiOrigin, const Size & pRoiSize,
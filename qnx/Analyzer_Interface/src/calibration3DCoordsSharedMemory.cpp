@@ -0,0 +1,329 @@
+#include "math/calibration3DCoordsSharedMemory.h"
+#include "module/moduleLogger.h"
+
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace precitec {
+namespace math {
+
+namespace
+{
+
+const char s_magic[4] = {'W', 'M', 'C', '3'};
+const std::size_t s_maxMappings = 4;
+const std::string s_namePrefix{"wmCalib3DCoords_"};
+
+struct SegmentHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+std::size_t segmentSize(std::size_t width, std::size_t height)
+{
+    return sizeof(SegmentHeader) + 2 * sizeof(float) * width * height;
+}
+
+/**
+ * A complete segment mapped into this process, unmapped on destruction.
+ * The x coordinates follow the header, the y coordinates follow the x coordinates.
+ **/
+class Mapping
+{
+public:
+    Mapping(void* data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+    ~Mapping()
+    {
+        munmap(m_data, m_size);
+    }
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    SegmentHeader& header() const
+    {
+        return *static_cast<SegmentHeader*>(m_data);
+    }
+    float* x() const
+    {
+        return reinterpret_cast<float*>(static_cast<char*>(m_data) + sizeof(SegmentHeader));
+    }
+    float* y() const
+    {
+        return x() + std::size_t(header().width) * header().height;
+    }
+
+private:
+    void* m_data;
+    std::size_t m_size;
+};
+
+struct Published
+{
+    Calibration3DCoordsHandle handle;
+    std::uint64_t generation;
+};
+
+/**
+ * Segments published by this process, the segments are unlinked when the process exits
+ **/
+struct PublishedSegments
+{
+    ~PublishedSegments()
+    {
+        clear();
+    }
+    void clear()
+    {
+        for (const auto& entry : sensors)
+        {
+            shm_unlink(entry.second.handle.name.c_str());
+        }
+        sensors.clear();
+    }
+    std::map<int, Published> sensors;
+};
+
+std::mutex s_mutex;
+PublishedSegments s_published;
+std::uint32_t s_nextVersion = 1;
+bool s_staleSegmentsUnlinked = false;
+std::vector<std::pair<std::string, std::shared_ptr<const Mapping>>> s_mappings; ///< consumer side, least recently used first
+
+/**
+ * Beginning of the names of all segments of this process, without the leading slash
+ **/
+const std::string& processPrefix()
+{
+    // the start time separates segments of processes which got the same pid
+    static const std::string s_processPrefix = []
+        {
+            std::ostringstream prefix;
+            prefix << s_namePrefix << getpid() << "_" << std::hex << std::chrono::system_clock::now().time_since_epoch().count() << "_";
+            return prefix.str();
+        }();
+    return s_processPrefix;
+}
+
+std::string segmentName(int sensorId, std::uint32_t version)
+{
+    return "/" + processPrefix() + std::to_string(sensorId) + "_" + std::to_string(version);
+}
+
+std::shared_ptr<const Mapping> mapSegment(const Calibration3DCoordsHandle& handle)
+{
+    const int fd = shm_open(handle.name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+    {
+        wmLog(eError, "Cannot open calibration coordinates %s: %s\n", handle.name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    const auto size = segmentSize(handle.width, handle.height);
+    struct stat status;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && std::size_t(status.st_size) == size)
+    {
+        data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        wmLog(eError, "Cannot map calibration coordinates %s\n", handle.name.c_str());
+        return nullptr;
+    }
+
+    auto mapping = std::make_shared<const Mapping>(data, size);
+    const auto& header = mapping->header();
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != handle.version
+        || header.width != handle.width || header.height != handle.height)
+    {
+        wmLog(eError, "Calibration coordinates %s do not match version %u\n", handle.name.c_str(), handle.version);
+        return nullptr;
+    }
+    return mapping;
+}
+
+}
+
+Calibration3DCoordsHandle Calibration3DCoordsSharedMemory::publish(int sensorId, std::uint64_t generation, const std::vector<float>& x, const std::vector<float>& y, std::size_t width, std::size_t height)
+{
+    const auto count = width * height;
+    if (count == 0 || x.size() < count || y.size() < count)
+    {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock{s_mutex};
+    if (!s_staleSegmentsUnlinked)
+    {
+        s_staleSegmentsUnlinked = true;
+        unlinkStaleSegments();
+    }
+    auto it = s_published.sensors.find(sensorId);
+    if (it != s_published.sensors.end())
+    {
+        const auto& current = it->second;
+        if (current.generation == generation && current.handle.width == width && current.handle.height == height)
+        {
+            return current.handle;
+        }
+    }
+
+    Calibration3DCoordsHandle handle;
+    handle.version = s_nextVersion++;
+    handle.width = width;
+    handle.height = height;
+    handle.name = segmentName(sensorId, handle.version);
+
+    const auto size = segmentSize(width, height);
+    int fd = shm_open(handle.name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1 && errno == EEXIST)
+    {
+        shm_unlink(handle.name.c_str());
+        fd = shm_open(handle.name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    }
+    if (fd == -1)
+    {
+        wmLog(eError, "Cannot create calibration coordinates %s: %s\n", handle.name.c_str(), strerror(errno));
+        return {};
+    }
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, size) == 0)
+    {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        wmLog(eError, "Cannot map calibration coordinates %s\n", handle.name.c_str());
+        shm_unlink(handle.name.c_str());
+        return {};
+    }
+
+    {
+        // the segment stays, the publisher does not need the mapping anymore
+        const Mapping mapping{data, size};
+        auto& header = mapping.header();
+        std::memcpy(header.magic, s_magic, sizeof(s_magic));
+        header.version = handle.version;
+        header.width = handle.width;
+        header.height = handle.height;
+        std::memcpy(mapping.x(), x.data(), count * sizeof(float));
+        std::memcpy(mapping.y(), y.data(), count * sizeof(float));
+    }
+
+    if (it != s_published.sensors.end())
+    {
+        // consumers which mapped the previous version keep their mapping
+        shm_unlink(it->second.handle.name.c_str());
+        it->second = Published{handle, generation};
+    }
+    else
+    {
+        s_published.sensors.emplace(sensorId, Published{handle, generation});
+    }
+    return handle;
+}
+
+bool Calibration3DCoordsSharedMemory::read(const Calibration3DCoordsHandle& handle, std::vector<float>& x, std::vector<float>& y)
+{
+    if (!handle.isValid())
+    {
+        return false;
+    }
+
+    std::shared_ptr<const Mapping> mapping;
+    {
+        std::lock_guard<std::mutex> lock{s_mutex};
+        auto it = std::find_if(s_mappings.begin(), s_mappings.end(), [&handle] (const auto& entry) { return entry.first == handle.name; });
+        if (it != s_mappings.end())
+        {
+            mapping = it->second;
+            s_mappings.erase(it);
+            s_mappings.emplace_back(handle.name, mapping);
+        }
+    }
+    if (!mapping)
+    {
+        mapping = mapSegment(handle);
+        if (!mapping)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock{s_mutex};
+        if (s_mappings.size() >= s_maxMappings)
+        {
+            s_mappings.erase(s_mappings.begin());
+        }
+        s_mappings.emplace_back(handle.name, mapping);
+    }
+
+    const auto count = std::size_t(handle.width) * handle.height;
+    x.assign(mapping->x(), mapping->x() + count);
+    y.assign(mapping->y(), mapping->y() + count);
+    return true;
+}
+
+void Calibration3DCoordsSharedMemory::release()
+{
+    std::lock_guard<std::mutex> lock{s_mutex};
+    s_published.clear();
+    s_mappings.clear();
+}
+
+void Calibration3DCoordsSharedMemory::unlinkStaleSegments()
+{
+#ifdef __QNX__
+    Poco::File directory{"/dev/shmem"};
+#else
+    Poco::File directory{"/dev/shm"};
+#endif
+    std::vector<std::string> files;
+    try
+    {
+        directory.list(files);
+    }
+    catch (const Poco::Exception& exception)
+    {
+        wmLog(eDebug, "Cannot list shared memory segments: %s\n", exception.displayText().c_str());
+        return;
+    }
+    for (const auto& file : files)
+    {
+        if (file.compare(0, s_namePrefix.size(), s_namePrefix) != 0 || file.compare(0, processPrefix().size(), processPrefix()) == 0)
+        {
+            continue;
+        }
+        // a segment with the pid of this process but another start time is left from a previous process with the same pid
+        const auto pid = pid_t(std::atoi(file.c_str() + s_namePrefix.size()));
+        if (pid == getpid() || (pid > 0 && kill(pid, 0) == -1 && errno == ESRCH))
+        {
+            shm_unlink(("/" + file).c_str());
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,282 @@
+#include "coordinates/fieldDistortionLookup.h"
+#include "coordinates/fieldDistortionMapping.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+
+const char s_magic[4] = {'W', 'M', 'F', 'D'};
+const std::uint32_t s_version = 1;
+const std::size_t s_maxCachedGrids = 16;
+const double s_initialStep = 16.0;
+const std::size_t s_maxNodes = 1u << 22;
+
+std::mutex s_cacheMutex;
+std::vector<std::shared_ptr<const FieldDistortionLookup>> s_cache; ///< least recently used first
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+    return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+std::size_t nodeCount(double xMin, double xMax, double yMin, double yMax, double step)
+{
+    // same as the number of columns and rows of the grid
+    return std::max<std::size_t>(2, std::ceil((xMax - xMin) / step) + 1) * std::max<std::size_t>(2, std::ceil((yMax - yMin) / step) + 1);
+}
+
+std::string cacheFileName(const std::string& cacheDirectory, const std::vector<double>& distortionCoefficient,
+    double xMin, double xMax, double yMin, double yMax)
+{
+    // FNV-1a over the coefficients and the range
+    std::vector<double> key{distortionCoefficient};
+    key.insert(key.end(), {xMin, xMax, yMin, yMax});
+    std::uint64_t hash = 14695981039346656037ull;
+    const auto bytes = reinterpret_cast<const unsigned char*>(key.data());
+    for (std::size_t i = 0; i < key.size() * sizeof(double); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    std::ostringstream stream;
+    stream << cacheDirectory << "/fieldDistortionLookup_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return stream.str();
+}
+
+}
+
+FieldDistortionLookup::FieldDistortionLookup(const std::vector<double>& distortionCoefficient, double xMin, double xMax, double yMin, double yMax, double step)
+    : m_distortionCoefficient(distortionCoefficient)
+    , m_xMin(xMin)
+    , m_yMin(yMin)
+    , m_step(step)
+    , m_columns(std::max<std::size_t>(2, std::ceil((xMax - xMin) / step) + 1))
+    , m_rows(std::max<std::size_t>(2, std::ceil((yMax - yMin) / step) + 1))
+    , m_u(m_columns * m_rows)
+    , m_v(m_columns * m_rows)
+{
+    for (std::size_t j = 0; j < m_rows; ++j)
+    {
+        for (std::size_t i = 0; i < m_columns; ++i)
+        {
+            const auto world = ::pixelToWorld(m_xMin + i * m_step, m_yMin + j * m_step, m_distortionCoefficient);
+            m_u[j * m_columns + i] = world.first;
+            m_v[j * m_columns + i] = world.second;
+        }
+    }
+    computeSampledMaxDeviation();
+}
+
+void FieldDistortionLookup::computeSampledMaxDeviation()
+{
+    m_sampledMaxDeviation = 0.0;
+    for (std::size_t j = 0; j + 1 < m_rows; ++j)
+    {
+        for (std::size_t i = 0; i + 1 < m_columns; ++i)
+        {
+            const auto x = m_xMin + (i + 0.5) * m_step;
+            const auto y = m_yMin + (j + 0.5) * m_step;
+            const auto exact = ::pixelToWorld(x, y, m_distortionCoefficient);
+            const auto interpolated = pixelToWorld(x, y);
+            m_sampledMaxDeviation = std::max(m_sampledMaxDeviation, std::hypot(exact.first - interpolated.first, exact.second - interpolated.second));
+        }
+    }
+}
+
+bool FieldDistortionLookup::contains(double x, double y) const
+{
+    return x >= m_xMin && x <= m_xMin + (m_columns - 1) * m_step
+        && y >= m_yMin && y <= m_yMin + (m_rows - 1) * m_step;
+}
+
+bool FieldDistortionLookup::usable(const std::vector<double>& distortionCoefficient, double xMin, double xMax, double yMin, double yMax, double tolerance) const
+{
+    return m_sampledMaxDeviation <= tolerance && distortionCoefficient == m_distortionCoefficient && contains(xMin, yMin) && contains(xMax, yMax);
+}
+
+std::pair<double, double> FieldDistortionLookup::pixelToWorld(double x, double y) const
+{
+    if (!contains(x, y))
+    {
+        return ::pixelToWorld(x, y, m_distortionCoefficient);
+    }
+    const auto fx = (x - m_xMin) / m_step;
+    const auto fy = (y - m_yMin) / m_step;
+    const auto i = std::min<std::size_t>(fx, m_columns - 2);
+    const auto j = std::min<std::size_t>(fy, m_rows - 2);
+    const auto tx = fx - i;
+    const auto ty = fy - j;
+
+    const auto index = j * m_columns + i;
+    const auto interpolate = [&] (const std::vector<double>& grid)
+    {
+        const auto top = grid[index] + tx * (grid[index + 1] - grid[index]);
+        const auto bottom = grid[index + m_columns] + tx * (grid[index + m_columns + 1] - grid[index + m_columns]);
+        return top + ty * (bottom - top);
+    };
+    return {interpolate(m_u), interpolate(m_v)};
+}
+
+void FieldDistortionLookup::pixelToWorld(const double* x, const double* y, double* u, double* v, std::size_t count) const
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto world = pixelToWorld(x[i], y[i]);
+        u[i] = world.first;
+        v[i] = world.second;
+    }
+}
+
+bool FieldDistortionLookup::save(const std::string& fileName) const
+{
+    std::ofstream file{fileName, std::ios::binary | std::ios::trunc};
+    if (!file)
+    {
+        return false;
+    }
+    file.write(s_magic, sizeof(s_magic));
+    writeValue(file, s_version);
+    writeValue(file, std::uint32_t(m_distortionCoefficient.size()));
+    file.write(reinterpret_cast<const char*>(m_distortionCoefficient.data()), m_distortionCoefficient.size() * sizeof(double));
+    writeValue(file, m_xMin);
+    writeValue(file, m_yMin);
+    writeValue(file, m_step);
+    writeValue(file, std::uint64_t(m_columns));
+    writeValue(file, std::uint64_t(m_rows));
+    writeValue(file, m_sampledMaxDeviation);
+    file.write(reinterpret_cast<const char*>(m_u.data()), m_u.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(m_v.data()), m_v.size() * sizeof(double));
+    return bool(file);
+}
+
+std::shared_ptr<FieldDistortionLookup> FieldDistortionLookup::load(const std::string& fileName)
+{
+    std::ifstream file{fileName, std::ios::binary};
+    char magic[sizeof(s_magic)];
+    std::uint32_t version = 0;
+    std::uint32_t coefficientCount = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, s_magic, sizeof(magic)) != 0
+        || !readValue(file, version) || version != s_version
+        || !readValue(file, coefficientCount) || coefficientCount > 64)
+    {
+        return nullptr;
+    }
+    std::shared_ptr<FieldDistortionLookup> lookup{new FieldDistortionLookup};
+    lookup->m_distortionCoefficient.resize(coefficientCount);
+    std::uint64_t columns = 0;
+    std::uint64_t rows = 0;
+    if (!file.read(reinterpret_cast<char*>(lookup->m_distortionCoefficient.data()), coefficientCount * sizeof(double))
+        || !readValue(file, lookup->m_xMin) || !readValue(file, lookup->m_yMin) || !readValue(file, lookup->m_step)
+        || !readValue(file, columns) || !readValue(file, rows) || !readValue(file, lookup->m_sampledMaxDeviation)
+        || columns < 2 || rows < 2 || columns * rows > s_maxNodes)
+    {
+        return nullptr;
+    }
+    lookup->m_columns = columns;
+    lookup->m_rows = rows;
+    lookup->m_u.resize(columns * rows);
+    lookup->m_v.resize(columns * rows);
+    if (!file.read(reinterpret_cast<char*>(lookup->m_u.data()), lookup->m_u.size() * sizeof(double))
+        || !file.read(reinterpret_cast<char*>(lookup->m_v.data()), lookup->m_v.size() * sizeof(double)))
+    {
+        return nullptr;
+    }
+    return lookup;
+}
+
+std::shared_ptr<const FieldDistortionLookup> FieldDistortionLookup::findCached(const std::vector<double>& distortionCoefficient,
+    double xMin, double xMax, double yMin, double yMax, double tolerance)
+{
+    std::lock_guard<std::mutex> lock{s_cacheMutex};
+    auto it = std::find_if(s_cache.begin(), s_cache.end(), [&] (const auto& lookup) { return lookup->usable(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance); });
+    if (it == s_cache.end())
+    {
+        return nullptr;
+    }
+    auto lookup = *it;
+    s_cache.erase(it);
+    s_cache.push_back(lookup);
+    return lookup;
+}
+
+std::shared_ptr<const FieldDistortionLookup> FieldDistortionLookup::cached(const std::vector<double>& distortionCoefficient,
+    double xMin, double xMax, double yMin, double yMax, double tolerance, const std::string& cacheDirectory)
+{
+    if (auto lookup = findCached(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance))
+    {
+        return lookup;
+    }
+
+    // reading and building the grid take long, other threads can use the cache in the meantime
+    const auto fileName = cacheDirectory.empty() ? std::string{} : cacheFileName(cacheDirectory, distortionCoefficient, xMin, xMax, yMin, yMax);
+    std::shared_ptr<const FieldDistortionLookup> lookup;
+    if (!fileName.empty())
+    {
+        lookup = load(fileName);
+    }
+    if (!lookup || !lookup->usable(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance))
+    {
+        lookup.reset();
+        for (double step = s_initialStep; step >= 1.0; step /= 2)
+        {
+            if (nodeCount(xMin, xMax, yMin, yMax, step) > s_maxNodes)
+            {
+                break;
+            }
+            auto candidate = std::make_shared<const FieldDistortionLookup>(distortionCoefficient, xMin, xMax, yMin, yMax, step);
+            if (candidate->sampledMaxDeviation() <= tolerance)
+            {
+                lookup = candidate;
+                break;
+            }
+        }
+        if (!lookup)
+        {
+            return nullptr;
+        }
+        if (!fileName.empty())
+        {
+            lookup->save(fileName);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{s_cacheMutex};
+    // another thread might have added a grid in the meantime, keep only one of them
+    auto it = std::find_if(s_cache.begin(), s_cache.end(), [&] (const auto& other) { return other->usable(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance); });
+    if (it != s_cache.end())
+    {
+        lookup = *it;
+        s_cache.erase(it);
+    }
+    else if (s_cache.size() >= s_maxCachedGrids)
+    {
+        s_cache.erase(s_cache.begin());
+    }
+    s_cache.push_back(lookup);
+    return lookup;
+}
+
+std::size_t FieldDistortionLookup::initialNodeCount(double xMin, double xMax, double yMin, double yMax)
+{
+    return nodeCount(xMin, xMax, yMin, yMax, s_initialStep);
+}
+
+void FieldDistortionLookup::clearCache()
+{
+    std::lock_guard<std::mutex> lock{s_cacheMutex};
+    s_cache.clear();
+}
@@ -1,4 +1,5 @@
 #include "coordinates/fieldDistortionMapping.h"
+#include "coordinates/fieldDistortionLookup.h"
 
 #include <iostream>
 #include <cmath>
@@ -677,6 +678,44 @@ std::pair<double, double> pixelToWorld(double x, double y, const std::vector<dou
     return {u, v};
 }
 
+std::vector<std::pair<double, double>> worldToPixel(const std::vector<std::pair<double, double>>& world, const std::vector<double>& distortionCoefficient)
+{
+    std::vector<std::pair<double, double>> pixel;
+    pixel.reserve(world.size());
+    for (const auto& point : world)
+    {
+        pixel.push_back(worldToPixel(point.first, point.second, distortionCoefficient));
+    }
+    return pixel;
+}
+
+std::vector<std::pair<double, double>> pixelToWorld(const std::vector<std::pair<double, double>>& pixel, const std::vector<double>& distortionCoefficient, double tolerance, const std::string& cacheDirectory)
+{
+    std::shared_ptr<const FieldDistortionLookup> lookup;
+    if (tolerance > 0.0 && !pixel.empty())
+    {
+        const auto xRange = std::minmax_element(pixel.begin(), pixel.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+        const auto yRange = std::minmax_element(pixel.begin(), pixel.end(), [] (const auto& a, const auto& b) { return a.second < b.second; });
+        const double blockSize = 256.0;
+        const auto xMin = std::floor(xRange.first->first / blockSize) * blockSize;
+        const auto xMax = std::ceil(xRange.second->first / blockSize) * blockSize;
+        const auto yMin = std::floor(yRange.first->second / blockSize) * blockSize;
+        const auto yMax = std::ceil(yRange.second->second / blockSize) * blockSize;
+        // building a grid solves at least twice per node, for fewer points only an existing grid is worth it
+        lookup = pixel.size() < FieldDistortionLookup::initialNodeCount(xMin, xMax, yMin, yMax) ?
+            FieldDistortionLookup::findCached(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance) :
+            FieldDistortionLookup::cached(distortionCoefficient, xMin, xMax, yMin, yMax, tolerance, cacheDirectory);
+    }
+
+    std::vector<std::pair<double, double>> world;
+    world.reserve(pixel.size());
+    for (const auto& point : pixel)
+    {
+        world.push_back(lookup ? lookup->pixelToWorld(point.first, point.second) : pixelToWorld(point.first, point.second, distortionCoefficient));
+    }
+    return world;
+}
+
 std::pair<double, double> imageShift(const uint8_t *imageA, const uint8_t *imageB, int height, int width, std::ptrdiff_t strideA, std::ptrdiff_t strideB)
 {
     cv::Mat cvImageA(height, width, CV_8UC1, (void *)imageA, strideA);
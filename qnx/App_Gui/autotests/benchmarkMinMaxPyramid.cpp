@@ -0,0 +1,124 @@
+#include <QTest>
+
+#include "../src/minMaxPyramid.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using precitec::gui::MinMaxPyramid;
+
+class BenchmarkMinMaxPyramid : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkBuild();
+    void benchmarkAllSamples();
+    void benchmarkZoom_data();
+    void benchmarkZoom();
+    void benchmarkPan();
+
+private:
+    std::vector<MinMaxPyramid::Sample> m_samples;
+    std::unique_ptr<MinMaxPyramid> m_pyramid;
+};
+
+namespace
+{
+
+// a seam of 10 million samples with a distance of 1 µm, shown on a full HD screen
+const std::size_t SAMPLE_COUNT = 10000000;
+const float SAMPLE_DISTANCE = 0.001f;
+const int PIXEL_WIDTH = 1920;
+
+}
+
+void BenchmarkMinMaxPyramid::initTestCase()
+{
+    std::mt19937 generator{5};
+    std::normal_distribution<float> noise{0.0f, 0.1f};
+    std::uniform_int_distribution<int> spike{0, 100000};
+    m_samples.reserve(SAMPLE_COUNT);
+    for (std::size_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        const auto value = std::sin(i * 1e-5f) + noise(generator) + (spike(generator) == 0 ? 10.0f : 0.0f);
+        m_samples.emplace_back(QVector2D(i * SAMPLE_DISTANCE, value), 0.0f);
+    }
+    m_pyramid = std::make_unique<MinMaxPyramid>(m_samples);
+}
+
+void BenchmarkMinMaxPyramid::cleanupTestCase()
+{
+    m_pyramid.reset();
+    m_samples.clear();
+}
+
+void BenchmarkMinMaxPyramid::benchmarkBuild()
+{
+    // done once in the background thread when the results are loaded
+    QBENCHMARK
+    {
+        MinMaxPyramid pyramid{m_samples};
+        QCOMPARE(pyramid.samples().size(), SAMPLE_COUNT);
+    }
+}
+
+void BenchmarkMinMaxPyramid::benchmarkAllSamples()
+{
+    // all samples are provided to the plotter without the pyramid
+    QBENCHMARK
+    {
+        const std::vector<MinMaxPyramid::Sample> samples{m_samples};
+        QCOMPARE(samples.size(), SAMPLE_COUNT);
+    }
+}
+
+void BenchmarkMinMaxPyramid::benchmarkZoom_data()
+{
+    QTest::addColumn<qreal>("zoom");
+
+    QTest::newRow("1") << 1.0;
+    QTest::newRow("10") << 10.0;
+    QTest::newRow("100") << 100.0;
+    QTest::newRow("1000") << 1000.0;
+    QTest::newRow("10000") << 10000.0;
+}
+
+void BenchmarkMinMaxPyramid::benchmarkZoom()
+{
+    // a frame after zooming into the middle of the seam: select the level and provide the samples of the served range
+    QFETCH(qreal, zoom);
+    const qreal visibleSpan = SAMPLE_COUNT * SAMPLE_DISTANCE / zoom;
+    const qreal xMin = (SAMPLE_COUNT * SAMPLE_DISTANCE - visibleSpan) / 2.0;
+    const auto [servedMin, servedMax] = MinMaxPyramid::servedRange(xMin, xMin + visibleSpan);
+
+    std::size_t sampleCount = 0;
+    QBENCHMARK
+    {
+        const auto level = m_pyramid->levelFor(visibleSpan, PIXEL_WIDTH);
+        sampleCount = m_pyramid->level(level, servedMin, servedMax).size();
+    }
+    qInfo("level %zu, %zu samples", m_pyramid->levelFor(visibleSpan, PIXEL_WIDTH), sampleCount);
+}
+
+void BenchmarkMinMaxPyramid::benchmarkPan()
+{
+    // a frame after panning beyond the served range: the level does not change, the samples of the new range are provided
+    const qreal visibleSpan = SAMPLE_COUNT * SAMPLE_DISTANCE / 100.0;
+    const auto level = m_pyramid->levelFor(visibleSpan, PIXEL_WIDTH);
+
+    qreal xMin = 0.0;
+    std::size_t sampleCount = 0;
+    QBENCHMARK
+    {
+        xMin = xMin + visibleSpan < SAMPLE_COUNT * SAMPLE_DISTANCE ? xMin + visibleSpan / 2.0 : 0.0;
+        const auto [servedMin, servedMax] = MinMaxPyramid::servedRange(xMin, xMin + visibleSpan);
+        sampleCount = m_pyramid->level(level, servedMin, servedMax).size();
+    }
+    QVERIFY(sampleCount <= std::size_t(12 * PIXEL_WIDTH + 8));
+}
+
+QTEST_GUILESS_MAIN(BenchmarkMinMaxPyramid)
+#include "benchmarkMinMaxPyramid.moc"
@@ -0,0 +1,271 @@
+#include <QTest>
+
+#include "../src/minMaxPyramid.h"
+
+#include <cmath>
+#include <random>
+
+using precitec::gui::MinMaxPyramid;
+
+class MinMaxPyramidTest: public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCtor();
+    void testSingleSample();
+    void testLevels_data();
+    void testLevels();
+    void testSpikes();
+    void testLevelFor_data();
+    void testLevelFor();
+    void testServedSize_data();
+    void testServedSize();
+    void testValueAtPosition_data();
+    void testValueAtPosition();
+};
+
+namespace
+{
+
+// noisy signal with a sample distance of 0.5
+std::vector<MinMaxPyramid::Sample> signal(std::size_t count)
+{
+    std::mt19937 generator{5};
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+
+    std::vector<MinMaxPyramid::Sample> ret;
+    ret.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        ret.emplace_back(QVector2D(100.0f + 0.5f * i, std::sin(0.01f * i) * 10.0f + noise(generator)), 0.01f * (i % 100));
+    }
+    return ret;
+}
+
+// the search of ResultsDataSetModel in all samples
+std::optional<float> linearSearch(const std::vector<MinMaxPyramid::Sample>& samples, float position)
+{
+    for (const auto& sample : samples)
+    {
+        if (qFuzzyCompare(sample.first.x(), position))
+        {
+            return sample.first.y();
+        }
+        if (sample.first.x() > position)
+        {
+            break;
+        }
+    }
+    return {};
+}
+
+}
+
+void MinMaxPyramidTest::testCtor()
+{
+    MinMaxPyramid pyramid;
+    QVERIFY(pyramid.samples().empty());
+    QCOMPARE(pyramid.levelCount(), std::size_t(1));
+    QVERIFY(pyramid.level(0).empty());
+    QVERIFY(pyramid.level(5).empty());
+    QCOMPARE(pyramid.levelFor(100.0, 1000), std::size_t(0));
+    QVERIFY(!pyramid.valueAtPosition(0.0f));
+}
+
+void MinMaxPyramidTest::testSingleSample()
+{
+    MinMaxPyramid pyramid{{{QVector2D{1.0f, 2.0f}, 0.5f}}};
+    QCOMPARE(pyramid.samples().size(), std::size_t(1));
+    QCOMPARE(pyramid.levelCount(), std::size_t(1));
+    QCOMPARE(pyramid.level(3), pyramid.samples());
+    QCOMPARE(pyramid.levelFor(100.0, 1), std::size_t(0));
+    QCOMPARE(pyramid.valueAtPosition(1.0f), std::optional<float>(2.0f));
+}
+
+void MinMaxPyramidTest::testLevels_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("2") << 2;
+    QTest::newRow("3") << 3;
+    QTest::newRow("17") << 17;
+    QTest::newRow("1024") << 1024;
+    QTest::newRow("10001") << 10001;
+}
+
+void MinMaxPyramidTest::testLevels()
+{
+    QFETCH(int, count);
+
+    const auto samples = signal(count);
+    MinMaxPyramid pyramid{samples};
+    QCOMPARE(pyramid.samples(), samples);
+    QCOMPARE(pyramid.level(0), samples);
+    QCOMPARE(pyramid.levelCount(), std::size_t(std::ceil(std::log2(count))) + 1);
+
+    for (std::size_t level = 1; level < pyramid.levelCount(); level++)
+    {
+        const std::size_t bucketSize = std::size_t(1) << level;
+        const auto served = pyramid.level(level);
+
+        std::size_t next = 0;
+        for (std::size_t first = 0; first < samples.size(); first += bucketSize)
+        {
+            const auto end = std::min(first + bucketSize, samples.size());
+            const auto [min, max] = std::minmax_element(samples.begin() + first, samples.begin() + end,
+                                                        [] (const auto& a, const auto& b) { return a.first.y() < b.first.y(); });
+
+            // first, minimum, maximum and last sample of the bucket in their original order
+            std::vector<MinMaxPyramid::Sample> bucket;
+            for (; next < served.size() && served.at(next).first.x() < samples.at(end - 1).first.x() + 0.25f; next++)
+            {
+                bucket.push_back(served.at(next));
+            }
+            QVERIFY(!bucket.empty());
+            QVERIFY(bucket.size() <= 4);
+            QCOMPARE(bucket.front(), samples.at(first));
+            QCOMPARE(bucket.back(), samples.at(end - 1));
+            QVERIFY(std::is_sorted(bucket.begin(), bucket.end(), [] (const auto& a, const auto& b) { return a.first.x() < b.first.x(); }));
+            QVERIFY(std::any_of(bucket.begin(), bucket.end(), [min = min] (const auto& sample) { return sample.first.y() == min->first.y(); }));
+            QVERIFY(std::any_of(bucket.begin(), bucket.end(), [max = max] (const auto& sample) { return sample.first.y() == max->first.y(); }));
+        }
+        QCOMPARE(next, served.size());
+    }
+
+    // levels beyond the last one return the last one
+    QCOMPARE(pyramid.level(pyramid.levelCount() + 3), pyramid.level(pyramid.levelCount() - 1));
+}
+
+void MinMaxPyramidTest::testSpikes()
+{
+    // single sample spikes are kept on all levels
+    auto samples = signal(100000);
+    samples.at(12345).first.setY(1000.0f);
+    samples.at(77777).first.setY(-1000.0f);
+    MinMaxPyramid pyramid{samples};
+
+    for (std::size_t level = 1; level < pyramid.levelCount(); level++)
+    {
+        const auto served = pyramid.level(level);
+        QVERIFY(std::find(served.begin(), served.end(), samples.at(12345)) != served.end());
+        QVERIFY(std::find(served.begin(), served.end(), samples.at(77777)) != served.end());
+    }
+}
+
+void MinMaxPyramidTest::testLevelFor_data()
+{
+    QTest::addColumn<qreal>("visibleSpan");
+    QTest::addColumn<int>("pixelWidth");
+    QTest::addColumn<bool>("sorted");
+    QTest::addColumn<int>("level");
+
+    // 100000 samples with a distance of 0.5
+    QTest::newRow("all") << 50000.0 << 1000 << true << 6;
+    QTest::newRow("all, 100 pixel") << 50000.0 << 100 << true << 9;
+    QTest::newRow("8 samples per pixel") << 4000.0 << 1000 << true << 3;
+    QTest::newRow("7 samples per pixel") << 3500.0 << 1000 << true << 0;
+    QTest::newRow("1 sample per pixel") << 500.0 << 1000 << true << 0;
+    QTest::newRow("zoomed in") << 10.0 << 1000 << true << 0;
+    QTest::newRow("1 pixel") << 50000.0 << 1 << true << 16;
+    QTest::newRow("beyond last level") << 1e9 << 1 << true << 17;
+    QTest::newRow("no width") << 50000.0 << 0 << true << 0;
+    QTest::newRow("no span") << 0.0 << 1000 << true << 0;
+    QTest::newRow("unsorted") << 50000.0 << 1000 << false << 0;
+}
+
+void MinMaxPyramidTest::testLevelFor()
+{
+    QFETCH(qreal, visibleSpan);
+    QFETCH(int, pixelWidth);
+    QFETCH(bool, sorted);
+
+    auto samples = signal(100000);
+    if (!sorted)
+    {
+        std::swap(samples.at(10), samples.at(20));
+    }
+    MinMaxPyramid pyramid{samples};
+    QCOMPARE(pyramid.levelCount(), std::size_t(18));
+    QTEST(int(pyramid.levelFor(visibleSpan, pixelWidth)), "level");
+}
+
+void MinMaxPyramidTest::testServedSize_data()
+{
+    QTest::addColumn<qreal>("zoom");
+    QTest::addColumn<qreal>("position");
+
+    QTest::newRow("all") << 1.0 << 0.0;
+    QTest::newRow("10, start") << 10.0 << 0.0;
+    QTest::newRow("10, middle") << 10.0 << 0.5;
+    QTest::newRow("100, end") << 100.0 << 1.0;
+    QTest::newRow("1000, middle") << 1000.0 << 0.5;
+    QTest::newRow("10000, start") << 10000.0 << 0.0;
+    QTest::newRow("10000, middle") << 10000.0 << 0.3;
+    QTest::newRow("100000, end") << 100000.0 << 1.0;
+}
+
+void MinMaxPyramidTest::testServedSize()
+{
+    QFETCH(qreal, zoom);
+    QFETCH(qreal, position);
+
+    const int pixelWidth = 1920;
+    const auto samples = signal(1000000);
+    MinMaxPyramid pyramid{samples};
+
+    const qreal signalMin = samples.front().first.x();
+    const qreal signalMax = samples.back().first.x();
+    const qreal visibleSpan = (signalMax - signalMin) / zoom;
+    const qreal xMin = signalMin + position * (signalMax - signalMin - visibleSpan);
+    const qreal xMax = xMin + visibleSpan;
+
+    const auto level = pyramid.levelFor(visibleSpan, pixelWidth);
+    const auto [servedMin, servedMax] = MinMaxPyramid::servedRange(xMin, xMax);
+    const auto served = pyramid.level(level, servedMin, servedMax);
+
+    // at most 12 samples per pixel and the buckets at the border, no matter how far zoomed in
+    QVERIFY(!served.empty());
+    QVERIFY(served.size() <= std::size_t(12 * pixelWidth + 8));
+
+    // the served range covers the visible range and is a part of the complete level
+    QVERIFY(served.front().first.x() <= std::max(qreal(servedMin), signalMin));
+    QVERIFY(served.back().first.x() >= std::min(qreal(servedMax), signalMax));
+    const auto all = pyramid.level(level);
+    QVERIFY(std::search(all.begin(), all.end(), served.begin(), served.end()) != all.end());
+}
+
+void MinMaxPyramidTest::testValueAtPosition_data()
+{
+    QTest::addColumn<bool>("sorted");
+
+    QTest::newRow("sorted") << true;
+    QTest::newRow("unsorted") << false;
+}
+
+void MinMaxPyramidTest::testValueAtPosition()
+{
+    QFETCH(bool, sorted);
+
+    auto samples = signal(5000);
+    if (!sorted)
+    {
+        std::swap(samples.at(10), samples.at(2000));
+    }
+    MinMaxPyramid pyramid{samples};
+
+    // identical to the linear search, including positions between samples and outside of the signal
+    std::mt19937 generator{7};
+    std::uniform_real_distribution<float> positions(50.0f, 2650.0f);
+    for (int i = 0; i < 2000; i++)
+    {
+        const auto position = i % 2 == 0 ? samples.at(i).first.x() : positions(generator);
+        QCOMPARE(pyramid.valueAtPosition(position), linearSearch(samples, position));
+    }
+    if (sorted)
+    {
+        QCOMPARE(pyramid.valueAtPosition(samples.at(1234).first.x()), std::optional<float>(samples.at(1234).first.y()));
+    }
+}
+
+QTEST_GUILESS_MAIN(MinMaxPyramidTest)
+#include "minMaxPyramidTest.moc"
@@ -0,0 +1,311 @@
+#include <QTest>
+
+#include "../src/referenceCurveAccumulator.h"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+
+using precitec::gui::ReferenceCurveAccumulator;
+using precitec::storage::ReferenceCurve;
+
+class ReferenceCurveAccumulatorTest: public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCtor();
+    void testEmptyInstance();
+    void testExact_data();
+    void testExact();
+    void testMedianSketch_data();
+    void testMedianSketch();
+    void testJitterBounds_data();
+    void testJitterBounds();
+};
+
+namespace
+{
+
+// instances of different length with a position offset and a noisy signal
+std::vector<std::vector<QVector2D>> instances(std::size_t count, std::size_t length)
+{
+    std::mt19937 generator{5};
+    std::uniform_int_distribution<int> lengthVariation(0, 10);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+
+    std::vector<std::vector<QVector2D>> ret;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::vector<QVector2D> samples;
+        const auto offset = 100.0f + i;
+        const std::size_t instanceLength = length - lengthVariation(generator);
+        for (std::size_t j = 0; j < instanceLength; j++)
+        {
+            samples.emplace_back(offset + j * (0.5f + 0.001f * (i % 3)), std::sin(0.05f * j) * 10.0f + noise(generator));
+        }
+        ret.push_back(samples);
+    }
+    return ret;
+}
+
+// the y values of each sample index over all instances
+std::vector<std::vector<float>> valuesPerIndex(const std::vector<std::vector<QVector2D>>& input)
+{
+    std::vector<std::vector<float>> ret;
+    for (const auto& samples : input)
+    {
+        if (samples.size() > ret.size())
+        {
+            ret.resize(samples.size());
+        }
+        for (std::size_t i = 0; i < samples.size(); i++)
+        {
+            ret.at(i).push_back(samples.at(i).y());
+        }
+    }
+    return ret;
+}
+
+std::vector<float> expectedPositions(const std::vector<std::vector<QVector2D>>& input, bool fromLongest)
+{
+    std::vector<float> ret;
+    for (const auto& samples : input)
+    {
+        const auto offset = samples.front().x();
+        if (fromLongest && samples.size() > ret.size())
+        {
+            ret.clear();
+        }
+        for (std::size_t i = ret.size(); i < samples.size(); i++)
+        {
+            ret.push_back(samples.at(i).x() - offset);
+        }
+    }
+    return ret;
+}
+
+std::vector<QVector2D> expectedMiddle(const std::vector<std::vector<QVector2D>>& input, ReferenceCurve::ReferenceType referenceType)
+{
+    const auto x = expectedPositions(input, referenceType != ReferenceCurve::ReferenceType::MinMax);
+    auto values = valuesPerIndex(input);
+
+    std::vector<QVector2D> ret;
+    for (std::size_t i = 0; i < x.size(); i++)
+    {
+        auto& y = values.at(i);
+        switch (referenceType)
+        {
+            case ReferenceCurve::ReferenceType::Average:
+                ret.emplace_back(x.at(i), std::accumulate(y.begin(), y.end(), 0.0) / static_cast<float>(y.size()));
+                break;
+            case ReferenceCurve::ReferenceType::Median:
+                std::sort(y.begin(), y.end());
+                ret.emplace_back(x.at(i), y.at(0.5 * y.size()));
+                break;
+            case ReferenceCurve::ReferenceType::MinMax:
+            {
+                const QVector2D minElement{x.at(i), *std::min_element(y.begin(), y.end())};
+                const QVector2D maxElement{x.at(i), *std::max_element(y.begin(), y.end())};
+                ret.emplace_back(minElement + 0.5f * (maxElement - minElement));
+                break;
+            }
+        }
+    }
+    return ret;
+}
+
+std::vector<QVector2D> expectedJitterBound(const std::vector<QVector2D>& curve, float lastPosition, float jitter, bool upper)
+{
+    std::vector<QVector2D> ret;
+    const auto firstPosition = curve.front().x();
+    for (const auto& sample : curve)
+    {
+        auto jitterIntervalMin = std::max(firstPosition, sample.x() - jitter);
+        auto jitterIntervalMax = std::min(lastPosition, jitterIntervalMin + 2 * jitter);
+        auto value = upper ? std::numeric_limits<float>::lowest() : std::numeric_limits<float>::max();
+        for (const auto& s : curve)
+        {
+            if (s.x() >= jitterIntervalMin && s.x() <= jitterIntervalMax)
+            {
+                value = upper ? std::max(value, s.y()) : std::min(value, s.y());
+            }
+        }
+        ret.emplace_back(sample.x(), value);
+    }
+    return ret;
+}
+
+}
+
+void ReferenceCurveAccumulatorTest::testCtor()
+{
+    ReferenceCurveAccumulator accumulator{ReferenceCurve::ReferenceType::Median};
+    QCOMPARE(accumulator.instanceCount(), std::size_t(0));
+    QCOMPARE(accumulator.sampleCount(), std::size_t(0));
+    QCOMPARE(accumulator.medianCapacity(), ReferenceCurveAccumulator::defaultMedianCapacity);
+    QVERIFY(accumulator.middle().empty());
+    QVERIFY(accumulator.lower().empty());
+    QVERIFY(accumulator.upper().empty());
+
+    // the capacity is rounded up to a multiple of 4
+    QCOMPARE(ReferenceCurveAccumulator(ReferenceCurve::ReferenceType::Median, 0).medianCapacity(), std::size_t(4));
+    QCOMPARE(ReferenceCurveAccumulator(ReferenceCurve::ReferenceType::Median, 10).medianCapacity(), std::size_t(12));
+}
+
+void ReferenceCurveAccumulatorTest::testEmptyInstance()
+{
+    ReferenceCurveAccumulator accumulator{ReferenceCurve::ReferenceType::Average};
+    accumulator.addInstance({});
+    QCOMPARE(accumulator.instanceCount(), std::size_t(0));
+
+    accumulator.addInstance({{10, 1}, {11, 2}});
+    accumulator.addInstance({});
+    QCOMPARE(accumulator.instanceCount(), std::size_t(1));
+    QCOMPARE(accumulator.sampleCount(), std::size_t(2));
+    QCOMPARE(accumulator.middle(), std::vector<QVector2D>({{0, 1}, {1, 2}}));
+}
+
+void ReferenceCurveAccumulatorTest::testExact_data()
+{
+    QTest::addColumn<ReferenceCurve::ReferenceType>("referenceType");
+    QTest::addColumn<int>("instanceCount");
+
+    QTest::newRow("Average, 1") << ReferenceCurve::ReferenceType::Average << 1;
+    QTest::newRow("Average, 300") << ReferenceCurve::ReferenceType::Average << 300;
+    QTest::newRow("Median, 1") << ReferenceCurve::ReferenceType::Median << 1;
+    QTest::newRow("Median, 2") << ReferenceCurve::ReferenceType::Median << 2;
+    QTest::newRow("Median, 300") << ReferenceCurve::ReferenceType::Median << 300;
+    QTest::newRow("Median, capacity") << ReferenceCurve::ReferenceType::Median << int(ReferenceCurveAccumulator::defaultMedianCapacity);
+    QTest::newRow("MinMax, 1") << ReferenceCurve::ReferenceType::MinMax << 1;
+    QTest::newRow("MinMax, 300") << ReferenceCurve::ReferenceType::MinMax << 300;
+}
+
+void ReferenceCurveAccumulatorTest::testExact()
+{
+    QFETCH(ReferenceCurve::ReferenceType, referenceType);
+    QFETCH(int, instanceCount);
+
+    const auto input = instances(instanceCount, 200);
+
+    ReferenceCurveAccumulator accumulator{referenceType};
+    for (const auto& samples : input)
+    {
+        accumulator.addInstance(samples);
+    }
+    QCOMPARE(accumulator.instanceCount(), std::size_t(instanceCount));
+
+    // identical to sorting all values of a sample index
+    const auto middle = accumulator.middle();
+    QCOMPARE(accumulator.sampleCount(), middle.size());
+    QCOMPARE(middle, expectedMiddle(input, referenceType));
+
+    if (referenceType == ReferenceCurve::ReferenceType::MinMax)
+    {
+        const auto values = valuesPerIndex(input);
+        const auto lower = accumulator.lower();
+        const auto upper = accumulator.upper();
+        QCOMPARE(lower.size(), middle.size());
+        QCOMPARE(upper.size(), middle.size());
+        for (std::size_t i = 0; i < middle.size(); i++)
+        {
+            QCOMPARE(lower.at(i).x(), middle.at(i).x());
+            QCOMPARE(lower.at(i).y(), *std::min_element(values.at(i).begin(), values.at(i).end()));
+            QCOMPARE(upper.at(i).x(), middle.at(i).x());
+            QCOMPARE(upper.at(i).y(), *std::max_element(values.at(i).begin(), values.at(i).end()));
+        }
+    } else
+    {
+        QVERIFY(accumulator.lower().empty());
+        QVERIFY(accumulator.upper().empty());
+    }
+}
+
+void ReferenceCurveAccumulatorTest::testMedianSketch_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<int>("instanceCount");
+
+    QTest::newRow("4, 100") << 4 << 100;
+    QTest::newRow("16, 1000") << 16 << 1000;
+    QTest::newRow("64, 3000") << 64 << 3000;
+    QTest::newRow("256, 3000") << 256 << 3000;
+}
+
+void ReferenceCurveAccumulatorTest::testMedianSketch()
+{
+    QFETCH(int, capacity);
+    QFETCH(int, instanceCount);
+
+    const auto input = instances(instanceCount, 50);
+
+    ReferenceCurveAccumulator accumulator{ReferenceCurve::ReferenceType::Median, std::size_t(capacity)};
+    for (const auto& samples : input)
+    {
+        accumulator.addInstance(samples);
+    }
+
+    const auto values = valuesPerIndex(input);
+    const auto middle = accumulator.middle();
+    QCOMPARE(middle.size(), values.size());
+
+    for (std::size_t i = 0; i < middle.size(); i++)
+    {
+        auto y = values.at(i);
+        std::sort(y.begin(), y.end());
+        const auto n = y.size();
+
+        // the documented bound on the rank error
+        const auto levels = n > std::size_t(capacity) ? std::ceil(std::log2(double(n) / capacity)) : 0.0;
+        const auto maxRankError = n * levels / capacity;
+
+        const auto estimate = middle.at(i).y();
+        const double firstRank = std::lower_bound(y.begin(), y.end(), estimate) - y.begin();
+        const double lastRank = std::upper_bound(y.begin(), y.end(), estimate) - y.begin() - 1;
+        const double exactRank = std::size_t(0.5 * n);
+        QVERIFY(firstRank <= lastRank);
+        QVERIFY(firstRank <= exactRank + maxRankError);
+        QVERIFY(lastRank >= exactRank - maxRankError);
+    }
+}
+
+void ReferenceCurveAccumulatorTest::testJitterBounds_data()
+{
+    QTest::addColumn<float>("jitter");
+    QTest::addColumn<bool>("sorted");
+
+    QTest::newRow("0") << 0.0f << true;
+    QTest::newRow("0.3") << 0.3f << true;
+    QTest::newRow("1.5") << 1.5f << true;
+    QTest::newRow("20") << 20.0f << true;
+    QTest::newRow("1000") << 1000.0f << true;
+    QTest::newRow("unsorted 0") << 0.0f << false;
+    QTest::newRow("unsorted 1.5") << 1.5f << false;
+}
+
+void ReferenceCurveAccumulatorTest::testJitterBounds()
+{
+    QFETCH(float, jitter);
+    QFETCH(bool, sorted);
+
+    auto curve = expectedMiddle(instances(5, 400), ReferenceCurve::ReferenceType::Average);
+    if (!sorted)
+    {
+        std::swap(curve.at(10), curve.at(200));
+    }
+    const auto lastPosition = curve.back().x();
+
+    std::vector<QVector2D> lower;
+    std::vector<QVector2D> upper;
+    ReferenceCurveAccumulator::jitterBounds(curve, lastPosition, jitter, lower, upper);
+
+    // identical to comparing each sample with all samples
+    QCOMPARE(lower, expectedJitterBound(curve, lastPosition, jitter, false));
+    QCOMPARE(upper, expectedJitterBound(curve, lastPosition, jitter, true));
+
+    ReferenceCurveAccumulator::jitterBounds({}, 0.0f, jitter, lower, upper);
+    QVERIFY(lower.empty());
+    QVERIFY(upper.empty());
+}
+
+QTEST_GUILESS_MAIN(ReferenceCurveAccumulatorTest)
+#include "referenceCurveAccumulatorTest.moc"
@@ -2,6 +2,9 @@
 
 #include <QObject>
 
+#include <atomic>
+#include <map>
+
 class QFileInfo;
 
 namespace precitec
@@ -49,7 +52,8 @@ private:
     explicit LanguageSupport(QObject *parent = nullptr);
     void init();
     void parseFile(const QFileInfo &path);
-    bool m_ready = false;
+    // the texts are not modified once ready, thus they can be read from any thread
+    std::atomic<bool> m_ready{false};
     std::map<QString, QString> m_texts;
 };
 
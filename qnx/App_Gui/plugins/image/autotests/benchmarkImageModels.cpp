@@ -0,0 +1,155 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "../imageHistogramModel.h"
+#include "../intensityProfileModel.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using precitec::gui::components::image::ImageData;
+using precitec::gui::components::image::ImageHistogramModel;
+using precitec::gui::components::image::IntensityProfileModel;
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+
+class BenchmarkImageModels : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkHistogramPerPixel();
+    void benchmarkComputeHistogram();
+    void benchmarkHistogramUpdate();
+    void benchmarkHistogramUnchanged();
+    void benchmarkIntensityProfileUpdate();
+
+private:
+    ImageData nextFrame();
+
+    BImage m_image;
+    int m_imageNumber = 0;
+};
+
+namespace
+{
+
+// a 1 megapixel camera image, the roi covers the complete image
+const int IMAGE_WIDTH = 1024;
+const int IMAGE_HEIGHT = 1024;
+const QRect ROI{0, 0, IMAGE_WIDTH, IMAGE_HEIGHT};
+
+template <typename Model>
+bool waitForUpdate(Model &model)
+{
+    // a queued update starts directly after the previous one finished
+    QSignalSpy updatingChangedSpy(&model, &Model::updatingChanged);
+    while (model.isUpdating())
+    {
+        if (!updatingChangedSpy.wait())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+void BenchmarkImageModels::initTestCase()
+{
+    std::mt19937 generator{3};
+    std::normal_distribution<float> distribution{100.0f, 30.0f};
+    m_image = BImage{Size{IMAGE_WIDTH, IMAGE_HEIGHT}};
+    for (int y = 0; y < IMAGE_HEIGHT; y++)
+    {
+        for (int x = 0; x < IMAGE_WIDTH; x++)
+        {
+            m_image.rowBegin(y)[x] = std::max(0, std::min(255, int(distribution(generator))));
+        }
+    }
+}
+
+ImageData BenchmarkImageModels::nextFrame()
+{
+    // live mode: every frame has a new image number
+    precitec::interface::ImageContext context;
+    context.setImageNumber(++m_imageNumber);
+    return ImageData{context, m_image, precitec::image::OverlayCanvas{}};
+}
+
+void BenchmarkImageModels::benchmarkHistogramPerPixel()
+{
+    // the previous implementation counting one pixel after the other into one histogram
+    ImageHistogramModel::Histogram histogram{};
+    QBENCHMARK
+    {
+        histogram.fill(0);
+        for (int y = 0; y < IMAGE_HEIGHT; y++)
+        {
+            const auto lastPixel = m_image.rowBegin(y) + IMAGE_WIDTH;
+            for (auto curPixel = m_image.rowBegin(y); curPixel < lastPixel; ++curPixel)
+            {
+                ++histogram[*curPixel];
+            }
+        }
+    }
+    QCOMPARE(histogram, ImageHistogramModel::computeHistogram(m_image, ROI));
+}
+
+void BenchmarkImageModels::benchmarkComputeHistogram()
+{
+    ImageHistogramModel::Histogram histogram{};
+    QBENCHMARK
+    {
+        histogram = ImageHistogramModel::computeHistogram(m_image, ROI);
+    }
+    QCOMPARE(std::accumulate(histogram.begin(), histogram.end(), 0), IMAGE_WIDTH * IMAGE_HEIGHT);
+}
+
+void BenchmarkImageModels::benchmarkHistogramUpdate()
+{
+    // a new frame is shown: computed in the background thread and provided to the model and data set
+    ImageHistogramModel model;
+    model.setROI(ROI);
+    QVERIFY(waitForUpdate(model));
+    QBENCHMARK
+    {
+        model.setImageData(nextFrame());
+        QVERIFY(waitForUpdate(model));
+    }
+}
+
+void BenchmarkImageModels::benchmarkHistogramUnchanged()
+{
+    // the same frame is set again, e.g. when the image is updated without a new frame
+    ImageHistogramModel model;
+    model.setROI(ROI);
+    const auto frame = nextFrame();
+    model.setImageData(frame);
+    QVERIFY(waitForUpdate(model));
+    QBENCHMARK
+    {
+        model.setImageData(frame);
+        QVERIFY(waitForUpdate(model));
+    }
+}
+
+void BenchmarkImageModels::benchmarkIntensityProfileUpdate()
+{
+    // a new frame is shown with a profile line along the image diagonal
+    IntensityProfileModel model;
+    model.setStartPoint(QVector2D{0, 0});
+    model.setEndPoint(QVector2D{IMAGE_WIDTH - 1, IMAGE_HEIGHT - 1});
+    QVERIFY(waitForUpdate(model));
+    QBENCHMARK
+    {
+        model.setImageData(nextFrame());
+        QVERIFY(waitForUpdate(model));
+    }
+    QCOMPARE(model.rowCount(), IMAGE_WIDTH);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkImageModels)
+#include "benchmarkImageModels.moc"
@@ -0,0 +1,196 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "../imageHistogramModel.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using precitec::gui::components::image::ImageData;
+using precitec::gui::components::image::ImageHistogramModel;
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+
+class TestImageHistogramModel : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCtor();
+    void testComputeHistogram_data();
+    void testComputeHistogram();
+    void testUpdate();
+    void testCoalescing();
+};
+
+namespace
+{
+
+BImage createImage(int width, int height, int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    BImage image{Size{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            image.rowBegin(y)[x] = distribution(generator);
+        }
+    }
+    return image;
+}
+
+ImageData createImageData(const BImage &image, int imageNumber)
+{
+    precitec::interface::ImageContext context;
+    context.setImageNumber(imageNumber);
+    return ImageData{context, image, precitec::image::OverlayCanvas{}};
+}
+
+ImageHistogramModel::Histogram countPixels(const BImage &image, const QRect &roi)
+{
+    ImageHistogramModel::Histogram histogram{};
+    for (int y = roi.top(); y <= roi.bottom(); y++)
+    {
+        for (int x = roi.left(); x <= roi.right(); x++)
+        {
+            ++histogram[image.rowBegin(y)[x]];
+        }
+    }
+    return histogram;
+}
+
+}
+
+void TestImageHistogramModel::testCtor()
+{
+    ImageHistogramModel model;
+    QCOMPARE(model.rowCount(), 256);
+    QCOMPARE(model.isUpdating(), false);
+    QCOMPARE(model.roi(), QRect{});
+    QVERIFY(model.dataSet());
+    QCOMPARE(model.index(10, 0).data(Qt::UserRole).toInt(), 10);
+    QCOMPARE(model.index(10, 0).data(Qt::UserRole + 1).toUInt(), 0u);
+
+    const auto roles = model.roleNames();
+    QCOMPARE(roles.size(), 3);
+    QCOMPARE(roles.value(Qt::UserRole), QByteArrayLiteral("bin"));
+    QCOMPARE(roles.value(Qt::UserRole + 1), QByteArrayLiteral("count"));
+    QCOMPARE(roles.value(Qt::UserRole + 2), QByteArrayLiteral("countScaled"));
+}
+
+void TestImageHistogramModel::testComputeHistogram_data()
+{
+    QTest::addColumn<QRect>("roi");
+    QTest::addColumn<QRect>("clipped");
+
+    QTest::newRow("full") << QRect{0, 0, 101, 37} << QRect{0, 0, 101, 37};
+    QTest::newRow("inside") << QRect{3, 5, 50, 20} << QRect{3, 5, 50, 20};
+    QTest::newRow("less than 16 pixels") << QRect{7, 2, 9, 3} << QRect{7, 2, 9, 3};
+    QTest::newRow("clipped") << QRect{90, 30, 50, 50} << QRect{90, 30, 11, 7};
+    QTest::newRow("empty") << QRect{10, 10, 0, 0} << QRect{};
+}
+
+void TestImageHistogramModel::testComputeHistogram()
+{
+    const auto image = createImage(101, 37, 42);
+    QFETCH(QRect, roi);
+    QFETCH(QRect, clipped);
+
+    const auto histogram = ImageHistogramModel::computeHistogram(image, roi);
+    QCOMPARE(histogram, countPixels(image, clipped));
+    QCOMPARE(std::accumulate(histogram.begin(), histogram.end(), 0), clipped.width() * clipped.height());
+
+    // an invalid image has an empty histogram
+    QCOMPARE(ImageHistogramModel::computeHistogram(BImage{}, roi), ImageHistogramModel::Histogram{});
+}
+
+void TestImageHistogramModel::testUpdate()
+{
+    ImageHistogramModel model;
+    QSignalSpy updatingChangedSpy(&model, &ImageHistogramModel::updatingChanged);
+    QVERIFY(updatingChangedSpy.isValid());
+    QSignalSpy dataChangedSpy(&model, &ImageHistogramModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+    QSignalSpy modelResetSpy(&model, &ImageHistogramModel::modelReset);
+    QVERIFY(modelResetSpy.isValid());
+
+    const auto image = createImage(64, 48, 1);
+    const QRect roi{4, 4, 40, 30};
+    model.setROI(roi);
+    QTRY_COMPARE(model.isUpdating(), false);
+    model.setImageData(createImageData(image, 1));
+    QCOMPARE(model.isUpdating(), true);
+    QTRY_COMPARE(model.isUpdating(), false);
+
+    QCOMPARE(modelResetSpy.count(), 0);
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 256);
+    const auto expected = countPixels(image, roi);
+    for (int i = 0; i < 256; i++)
+    {
+        QCOMPARE(model.index(i, 0).data(Qt::UserRole + 1).toUInt(), expected[i]);
+    }
+    const auto peak = *std::max_element(expected.begin(), expected.end());
+    QCOMPARE(model.index(0, 0).data(Qt::UserRole + 2).toDouble(), expected[0] / double(peak));
+
+    // same image and roi are not computed again
+    const auto updatingCount = updatingChangedSpy.count();
+    model.setImageData(createImageData(image, 1));
+    model.setROI(roi);
+    QCOMPARE(model.isUpdating(), false);
+    QCOMPARE(updatingChangedSpy.count(), updatingCount);
+
+    // a new frame with the same buffer is computed again
+    model.setImageData(createImageData(image, 2));
+    QCOMPARE(model.isUpdating(), true);
+    QTRY_COMPARE(model.isUpdating(), false);
+    // but the histogram did not change
+    QCOMPARE(dataChangedSpy.count(), 1);
+
+    // changing the roi
+    model.setROI(QRect{0, 0, 64, 48});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(model.index(17, 0).data(Qt::UserRole + 1).toUInt(), countPixels(image, QRect{0, 0, 64, 48})[17]);
+
+    // invalid image
+    model.setImageData({});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(dataChangedSpy.count(), 3);
+    QCOMPARE(model.index(17, 0).data(Qt::UserRole + 1).toUInt(), 0u);
+    QCOMPARE(modelResetSpy.count(), 0);
+}
+
+void TestImageHistogramModel::testCoalescing()
+{
+    ImageHistogramModel model;
+    QSignalSpy dataChangedSpy(&model, &ImageHistogramModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+    const QRect roi{0, 0, 512, 512};
+    model.setROI(roi);
+    QTRY_COMPARE(model.isUpdating(), false);
+
+    // the images are set faster than computed, only the first and the last are processed
+    std::vector<BImage> images;
+    for (int i = 0; i < 5; i++)
+    {
+        images.push_back(createImage(512, 512, i));
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        model.setImageData(createImageData(images.at(i), i));
+    }
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(dataChangedSpy.count(), 2);
+
+    const auto expected = countPixels(images.back(), roi);
+    for (int i = 0; i < 256; i++)
+    {
+        QCOMPARE(model.index(i, 0).data(Qt::UserRole + 1).toUInt(), expected[i]);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestImageHistogramModel)
+#include "testImageHistogramModel.moc"
@@ -0,0 +1,172 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "../intensityProfileModel.h"
+
+#include <random>
+
+using precitec::gui::components::image::ImageData;
+using precitec::gui::components::image::IntensityProfileModel;
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+
+class TestIntensityProfileModel : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCtor();
+    void testUpdate();
+    void testCoalescing();
+};
+
+namespace
+{
+
+BImage createImage(int width, int height, int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    BImage image{Size{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            image.rowBegin(y)[x] = distribution(generator);
+        }
+    }
+    return image;
+}
+
+ImageData createImageData(const BImage &image, int imageNumber)
+{
+    precitec::interface::ImageContext context;
+    context.setImageNumber(imageNumber);
+    return ImageData{context, image, precitec::image::OverlayCanvas{}};
+}
+
+}
+
+void TestIntensityProfileModel::testCtor()
+{
+    IntensityProfileModel model;
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.isUpdating(), false);
+    QCOMPARE(model.startPoint(), QVector2D{});
+    QCOMPARE(model.endPoint(), QVector2D{});
+    QVERIFY(model.dataSet());
+
+    const auto roles = model.roleNames();
+    QCOMPARE(roles.size(), 3);
+    QCOMPARE(roles.value(Qt::UserRole), QByteArrayLiteral("x"));
+    QCOMPARE(roles.value(Qt::UserRole + 1), QByteArrayLiteral("y"));
+    QCOMPARE(roles.value(Qt::UserRole + 2), QByteArrayLiteral("intensity"));
+}
+
+void TestIntensityProfileModel::testUpdate()
+{
+    IntensityProfileModel model;
+    QSignalSpy updatingChangedSpy(&model, &IntensityProfileModel::updatingChanged);
+    QVERIFY(updatingChangedSpy.isValid());
+    QSignalSpy dataChangedSpy(&model, &IntensityProfileModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+    QSignalSpy modelResetSpy(&model, &IntensityProfileModel::modelReset);
+    QVERIFY(modelResetSpy.isValid());
+
+    // a horizontal line, every pixel of it is sampled
+    const auto image = createImage(64, 48, 1);
+    model.setStartPoint(QVector2D{2, 3});
+    QTRY_COMPARE(model.isUpdating(), false);
+    model.setEndPoint(QVector2D{20, 3});
+    QTRY_COMPARE(model.isUpdating(), false);
+    const auto resetCount = modelResetSpy.count();
+    model.setImageData(createImageData(image, 1));
+    QCOMPARE(model.isUpdating(), true);
+    QTRY_COMPARE(model.isUpdating(), false);
+
+    // the number of sampled points changed
+    QCOMPARE(modelResetSpy.count(), resetCount + 1);
+    QCOMPARE(dataChangedSpy.count(), 0);
+    QCOMPARE(model.rowCount(), 19);
+    for (int i = 0; i < 19; i++)
+    {
+        QCOMPARE(model.index(i, 0).data(Qt::UserRole).toDouble(), 2.0 + i);
+        QCOMPARE(model.index(i, 0).data(Qt::UserRole + 1).toDouble(), 3.0);
+        QCOMPARE(model.index(i, 0).data(Qt::UserRole + 2).toDouble(), double(image.rowBegin(3)[2 + i]));
+    }
+
+    // same image and line are not computed again
+    const auto updatingCount = updatingChangedSpy.count();
+    model.setImageData(createImageData(image, 1));
+    model.setStartPoint(QVector2D{2, 3});
+    model.setEndPoint(QVector2D{20, 3});
+    QCOMPARE(model.isUpdating(), false);
+    QCOMPARE(updatingChangedSpy.count(), updatingCount);
+
+    // a new frame with the same number of sampled points only changes the data
+    const auto nextImage = createImage(64, 48, 2);
+    model.setImageData(createImageData(nextImage, 2));
+    QCOMPARE(model.isUpdating(), true);
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(modelResetSpy.count(), resetCount + 1);
+    QCOMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 19);
+    QCOMPARE(model.index(5, 0).data(Qt::UserRole + 2).toDouble(), double(nextImage.rowBegin(3)[7]));
+
+    // a diagonal line with the same number of sampled points
+    model.setEndPoint(QVector2D{20, 10});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(modelResetSpy.count(), resetCount + 1);
+    QCOMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(model.rowCount(), 19);
+    QCOMPARE(model.index(18, 0).data(Qt::UserRole).toDouble(), 20.0);
+    QCOMPARE(model.index(18, 0).data(Qt::UserRole + 1).toDouble(), 10.0);
+    QCOMPARE(model.index(18, 0).data(Qt::UserRole + 2).toDouble(), double(nextImage.rowBegin(10)[20]));
+
+    // a longer line
+    model.setEndPoint(QVector2D{2, 40});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(modelResetSpy.count(), resetCount + 2);
+    QCOMPARE(model.rowCount(), 38);
+
+    // invalid image
+    model.setImageData({});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(modelResetSpy.count(), resetCount + 3);
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TestIntensityProfileModel::testCoalescing()
+{
+    IntensityProfileModel model;
+    model.setStartPoint(QVector2D{0, 100});
+    QTRY_COMPARE(model.isUpdating(), false);
+    model.setEndPoint(QVector2D{511, 100});
+    QTRY_COMPARE(model.isUpdating(), false);
+    QSignalSpy dataChangedSpy(&model, &IntensityProfileModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+    QSignalSpy modelResetSpy(&model, &IntensityProfileModel::modelReset);
+    QVERIFY(modelResetSpy.isValid());
+
+    // the images are set faster than computed, only the first and the last are processed
+    std::vector<BImage> images;
+    for (int i = 0; i < 5; i++)
+    {
+        images.push_back(createImage(512, 512, i));
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        model.setImageData(createImageData(images.at(i), i));
+    }
+    QTRY_COMPARE(model.isUpdating(), false);
+    QCOMPARE(modelResetSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.count(), 1);
+
+    QCOMPARE(model.rowCount(), 512);
+    for (int x = 0; x < 512; x++)
+    {
+        QCOMPARE(model.index(x, 0).data(Qt::UserRole + 2).toDouble(), double(images.back().rowBegin(100)[x]));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestIntensityProfileModel)
+#include "testIntensityProfileModel.moc"
@@ -1,8 +1,14 @@
 #include "imageHistogramModel.h"
 #include <algorithm> //max_element
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
 #include <precitec/dataSet.h>
 
+#include <cstdint>
+#include <cstring>
+
 namespace precitec
 {
 namespace gui
@@ -14,13 +20,17 @@ namespace image
 
 ImageHistogramModel::ImageHistogramModel(QObject *parent)
     : QAbstractListModel(parent),
-    m_Histogram(levels)
+    m_Histogram{}
+    , m_Peak(0)
     , m_dataSet(new plotter::DataSet{this})
     {
         m_dataSet->setDrawingMode(plotter::DataSet::DrawingMode::LineWithPoints);
     }
 
-ImageHistogramModel::~ImageHistogramModel() = default;
+ImageHistogramModel::~ImageHistogramModel()
+{
+    m_future.waitForFinished();
+}
 
 QHash<int, QByteArray> ImageHistogramModel::roleNames() const
 {
@@ -87,46 +97,146 @@ void ImageHistogramModel::setROI(QRect p_ROI)
     }
 }
 
+bool ImageHistogramModel::Input::operator==(const Input &other) const
+{
+    if (imageNumber != other.imageNumber || roi != other.roi || image.isValid() != other.image.isValid())
+    {
+        return false;
+    }
+    // the image data is shared, thus the same buffer with the same image number is the same image
+    return !image.isValid() || (image.begin() == other.image.begin() && image.width() == other.image.width() && image.height() == other.image.height());
+}
+
 void ImageHistogramModel::update()
 {
-    beginResetModel();
-    m_Histogram.resize(levels, 0);
-    std::fill(m_Histogram.begin(), m_Histogram.end(), 0);
-    m_Peak = 0;
-    m_dataSet->clear();
-    const precitec::image::BImage & rImage = std::get<precitec::image::BImage>(m_ImageData);
-    if (!rImage.isValid())
+    if (isUpdating())
     {
-        endResetModel();
+        // only the newest image is processed once the current computation finished
+        m_queueUpdate = true;
         return;
     }
-    //clip roi
-    
-    const unsigned int xMin = std::min<unsigned int>(m_ROI.x(), rImage.width() -1);
-    const unsigned int yMin = std::min<unsigned int>(m_ROI.y(), rImage.height() -1);
-    const unsigned int xMax = std::min<unsigned int>(xMin + m_ROI.width(), rImage.width());
-    const unsigned int yMax = std::min<unsigned int>(yMin + m_ROI.height(), rImage.height());
-    assert(xMin >= 0);
-    assert(yMin >= 0);
-
-    for (unsigned int y = yMin; y < yMax; ++y) 
+    Input input{std::get<precitec::image::BImage>(m_ImageData), std::get<precitec::interface::ImageContext>(m_ImageData).imageNumber(), m_ROI};
+    if (input == m_lastInput)
     {
-        const auto lastPixel = rImage.rowBegin(y) + xMax;
-        for (auto  curPixel = rImage.rowBegin(y) + xMin; curPixel < lastPixel; ++curPixel)
+        return;
+    }
+    m_lastInput = input;
+    setUpdating(true);
+
+    auto watcher = new QFutureWatcher<Histogram>{this};
+    connect(watcher, &QFutureWatcher<Histogram>::finished, this,
+        [this, watcher]
         {
-            //if (levels!=256) we need ++m_Histogram[(*curPixel)*levels >>8] 
-            ++m_Histogram[(*curPixel)];
+            watcher->deleteLater();
+            setHistogram(watcher->result());
+            setUpdating(false);
+            if (m_queueUpdate)
+            {
+                m_queueUpdate = false;
+                update();
+            }
         }
+    );
+    m_future = QtConcurrent::run(
+        [input]
+        {
+            return computeHistogram(input.image, input.roi);
+        });
+    watcher->setFuture(m_future);
+}
+
+void ImageHistogramModel::setHistogram(const Histogram &histogram)
+{
+    if (histogram == m_Histogram)
+    {
+        return;
     }
+    m_Histogram = histogram;
+    m_Peak = *(std::max_element( m_Histogram.cbegin(), m_Histogram.cend()));
+    // the number of bins is constant, thus the model does not need to be reset
+    emit dataChanged(index(0), index(levels - 1), {Qt::UserRole + 1, Qt::UserRole + 2});
+
+    m_dataSet->clear();
     std::vector<QVector2D> samples;
     samples.reserve(levels);
     auto counter = 0;
     std::transform(m_Histogram.begin(), m_Histogram.end(), std::back_inserter(samples), [&counter] (const auto& value) { return QVector2D{float(counter++), float(value)}; });
     m_dataSet->addSamples(samples);
-    m_Peak = *(std::max_element( m_Histogram.cbegin(), m_Histogram.cend()));
-    endResetModel();
 }
 
+void ImageHistogramModel::setUpdating(bool set)
+{
+    if (m_updating == set)
+    {
+        return;
+    }
+    m_updating = set;
+    emit updatingChanged();
+}
+
+namespace
+{
+
+// the pixels are counted alternating into several histograms, thus runs of the same grey level
+// do not wait for the previous increment of the same counter. The increments are scalar, reading
+// 8 pixels at once only saves the loads, a vectorized scatter into 256 bins would not be faster.
+const std::size_t histogramBanks = 4;
+using HistogramBanks = std::array<ImageHistogramModel::Histogram, histogramBanks>;
+
+inline void countPixels(std::uint64_t pixels, HistogramBanks &banks)
+{
+    ++banks[0][pixels & 0xff];
+    ++banks[1][(pixels >> 8) & 0xff];
+    ++banks[2][(pixels >> 16) & 0xff];
+    ++banks[3][(pixels >> 24) & 0xff];
+    ++banks[0][(pixels >> 32) & 0xff];
+    ++banks[1][(pixels >> 40) & 0xff];
+    ++banks[2][(pixels >> 48) & 0xff];
+    ++banks[3][pixels >> 56];
+}
+
+void countRow(const byte *pixel, const byte *lastPixel, HistogramBanks &banks)
+{
+    for (; pixel + sizeof(std::uint64_t) <= lastPixel; pixel += sizeof(std::uint64_t))
+    {
+        std::uint64_t pixels;
+        std::memcpy(&pixels, pixel, sizeof(pixels));
+        countPixels(pixels, banks);
+    }
+    for (; pixel < lastPixel; ++pixel)
+    {
+        //if (levels!=256) we need ++m_Histogram[(*curPixel)*levels >>8] 
+        ++banks[0][*pixel];
+    }
+}
+
+}
+
+ImageHistogramModel::Histogram ImageHistogramModel::computeHistogram(const precitec::image::BImage &rImage, const QRect &roi)
+{
+    Histogram histogram{};
+    if (!rImage.isValid())
+    {
+        return histogram;
+    }
+    //clip roi
+    
+    const unsigned int xMin = std::min<unsigned int>(roi.x(), rImage.width() -1);
+    const unsigned int yMin = std::min<unsigned int>(roi.y(), rImage.height() -1);
+    const unsigned int xMax = std::min<unsigned int>(xMin + roi.width(), rImage.width());
+    const unsigned int yMax = std::min<unsigned int>(yMin + roi.height(), rImage.height());
+
+    HistogramBanks banks{};
+    for (unsigned int y = yMin; y < yMax; ++y) 
+    {
+        countRow(rImage.rowBegin(y) + xMin, rImage.rowBegin(y) + xMax, banks);
+    }
+    for (std::size_t i = 0; i < levels; i++)
+    {
+        histogram[i] = banks[0][i] + banks[1][i] + banks[2][i] + banks[3][i];
+    }
+    return histogram;
+}
 
 }
 }
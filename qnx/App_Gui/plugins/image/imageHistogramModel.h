@@ -1,9 +1,12 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QFuture>
 #include "image/image.h"
 #include "imageItem.h"
 
+#include <array>
+
 
 namespace precitec
 {
@@ -19,14 +22,28 @@ class DataSet;
 
 namespace image
 {
+/**
+ * @brief Model for the grey level histogram of the @link{roi} in the @link{imageData}.
+ *
+ * The histogram is computed in a background thread. While a computation is running, further changes
+ * of the image or roi are coalesced, thus only the newest image is processed once the computation finished.
+ * If neither the image nor the roi changed, the histogram is not computed again.
+ **/
 class ImageHistogramModel : public QAbstractListModel
 {
     Q_OBJECT
     Q_PROPERTY(precitec::gui::components::image::ImageData imageData READ imageData WRITE setImageData NOTIFY imageDataChanged)
     Q_PROPERTY(QRect roi READ roi WRITE setROI NOTIFY roiChanged)  
     Q_PROPERTY(precitec::gui::components::plotter::DataSet *dataSet READ dataSet CONSTANT)
+    /**
+     * Whether the histogram is currently computed in the background thread.
+     **/
+    Q_PROPERTY(bool updating READ isUpdating NOTIFY updatingChanged)
 
 public:
+    static const unsigned int levels = 256; //8 bit gray image
+    using Histogram = std::array<quint32, levels>;
+
     explicit ImageHistogramModel(QObject *parent = nullptr);
     ~ImageHistogramModel() override;
     
@@ -44,23 +61,51 @@ public:
     {
         return m_dataSet;
     }
+
+    bool isUpdating() const
+    {
+        return m_updating;
+    }
+
+    /**
+     * Counts the grey levels of @p rImage inside @p roi. The roi is clipped to the image.
+     **/
+    static Histogram computeHistogram(const precitec::image::BImage &rImage, const QRect &roi);
     
     Q_SIGNALS:
         
     void imageDataChanged();
     void roiChanged();
+    void updatingChanged();
 
 private:
-    static const unsigned int levels = 256; //8 bit gray image
-    
+    /**
+     * Identifies the image and roi the histogram was computed for.
+     **/
+    struct Input
+    {
+        precitec::image::BImage image;
+        int imageNumber = 0;
+        QRect roi;
+
+        bool operator==(const Input &other) const;
+    };
+
     precitec::gui::components::image::ImageData  m_ImageData;
     QRect m_ROI;
-    std::vector<unsigned int> m_Histogram;
+    Histogram m_Histogram;
     double m_Peak; //double to avoid integer division when normalizing
 
     precitec::gui::components::plotter::DataSet *m_dataSet;
+
+    Input m_lastInput;
+    QFuture<Histogram> m_future;
+    bool m_updating = false;
+    bool m_queueUpdate = false;
     
     void update();
+    void setHistogram(const Histogram &histogram);
+    void setUpdating(bool set);
 };
 
 
@@ -1,5 +1,8 @@
 #include "intensityProfileModel.h"
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
 #include <precitec/dataSet.h>
 
 namespace precitec
@@ -17,7 +20,10 @@ namespace image
         m_dataSet->setDrawingMode(plotter::DataSet::DrawingMode::LineWithPoints);
     }
 
-    IntensityProfileModel::~IntensityProfileModel() = default;
+    IntensityProfileModel::~IntensityProfileModel()
+    {
+        m_future.waitForFinished();
+    }
 
     QHash<int, QByteArray> IntensityProfileModel::roleNames() const
     {
@@ -94,47 +100,115 @@ namespace image
         }
     }
 
+    bool IntensityProfileModel::Input::operator==(const Input &other) const
+    {
+        if (imageNumber != other.imageNumber || startPoint != other.startPoint || endPoint != other.endPoint || image.isValid() != other.image.isValid())
+        {
+            return false;
+        }
+        // the image data is shared, thus the same buffer with the same image number is the same image
+        return !image.isValid() || (image.begin() == other.image.begin() && image.width() == other.image.width() && image.height() == other.image.height());
+    }
+
     void IntensityProfileModel::update()
     {
-        beginResetModel();
-        computeProfileWithoutInterpolation();
-        m_dataSet->clear();
+        if (isUpdating())
+        {
+            // only the newest image is processed once the current computation finished
+            m_queueUpdate = true;
+            return;
+        }
+        Input input{std::get<precitec::image::BImage>(m_ImageData), std::get<precitec::interface::ImageContext>(m_ImageData).imageNumber(), m_startPoint, m_endPoint};
+        if (input == m_lastInput)
+        {
+            return;
+        }
+        m_lastInput = input;
+        setUpdating(true);
+
+        auto watcher = new QFutureWatcher<Profile>{this};
+        connect(watcher, &QFutureWatcher<Profile>::finished, this,
+            [this, watcher]
+            {
+                watcher->deleteLater();
+                setProfile(watcher->result());
+                setUpdating(false);
+                if (m_queueUpdate)
+                {
+                    m_queueUpdate = false;
+                    update();
+                }
+            }
+        );
+        m_future = QtConcurrent::run(
+            [input]
+            {
+                return computeProfileWithoutInterpolation(input);
+            });
+        watcher->setFuture(m_future);
+    }
+
+    void IntensityProfileModel::setProfile(Profile &&profile)
+    {
+        if (profile.size() == m_Profile.size())
+        {
+            // same number of sampled points, thus the model does not need to be reset
+            m_Profile = std::move(profile);
+            if (!m_Profile.empty())
+            {
+                emit dataChanged(index(0), index(m_Profile.size() - 1), {});
+            }
+        } else
+        {
+            beginResetModel();
+            m_Profile = std::move(profile);
+            endResetModel();
+        }
 
+        m_dataSet->clear();
         std::vector<QVector2D> samples;
         samples.reserve(m_Profile.size());
         auto counter = 0;
         std::transform(m_Profile.begin(), m_Profile.end(), std::back_inserter(samples), [&counter] (const auto &value) { return QVector2D{float(counter++), float(value.intensity)}; });
         m_dataSet->addSamples(samples);
+    }
 
-        endResetModel();
+    void IntensityProfileModel::setUpdating(bool set)
+    {
+        if (m_updating == set)
+        {
+            return;
+        }
+        m_updating = set;
+        emit updatingChanged();
     }
 
-    IntensityProfileModel::ExtremePoints IntensityProfileModel::computeExtremePoints()
+    IntensityProfileModel::ExtremePoints IntensityProfileModel::computeExtremePoints(const Input &input)
     {
-        const precitec::image::BImage & rImage = std::get<precitec::image::BImage>(m_ImageData);
+        const precitec::image::BImage & rImage = input.image;
         assert(rImage.isValid() && "computeExtremePoints called outside computeProfile");
 
         //convert first and last point to image indexes, project external points to border
         int W = rImage.width()-1;  //max x value
         int H = rImage.height()-1; //max y value
 
-        return { std::max(0, std::min(W, int(std::round(m_startPoint.x())))), //iStart
-            std::max(0, std::min(H, int(std::round(m_startPoint.y())))), //jStart
-            std::max(0, std::min(W, int(std::round(m_endPoint.x())))), //iEnd
-            std::min(H, int(std::round(m_endPoint.y()))) //jEnd
+        return { std::max(0, std::min(W, int(std::round(input.startPoint.x())))), //iStart
+            std::max(0, std::min(H, int(std::round(input.startPoint.y())))), //jStart
+            std::max(0, std::min(W, int(std::round(input.endPoint.x())))), //iEnd
+            std::min(H, int(std::round(input.endPoint.y()))) //jEnd
         };
     }
 
-    void IntensityProfileModel::computeProfileWithoutInterpolation()
+    IntensityProfileModel::Profile IntensityProfileModel::computeProfileWithoutInterpolation(const Input &input)
     {
-        m_Profile.clear();
-        const precitec::image::BImage & rImage = std::get<precitec::image::BImage>(m_ImageData);
+        Profile profile;
+        const precitec::image::BImage & rImage = input.image;
         if (!rImage.isValid())
         {
-            return;
+            return profile;
         }
 
-        ExtremePoints oExtremePoints = computeExtremePoints();
+        ExtremePoints oExtremePoints = computeExtremePoints(input);
 
         // Bresenham-Algorithm
 
@@ -152,7 +226,7 @@ namespace image
 
         while(x != oExtremePoints.iEnd || y != oExtremePoints.jEnd)
         {
-            m_Profile.push_back({static_cast<double>(x), static_cast<double>(y), static_cast<double>(*pixel)});
+            profile.push_back({static_cast<double>(x), static_cast<double>(y), static_cast<double>(*pixel)});
             int e2 = 2 * err; /* error value e_xy */
             if (e2 > dy)
             {
@@ -169,23 +243,24 @@ namespace image
             }
         }
         //add last point
-        m_Profile.push_back({static_cast<double>(x), static_cast<double>(y), static_cast<double>(*pixel)});
-        assert(std::round(m_Profile.front().x) == oExtremePoints.iStart);
-        assert(std::round(m_Profile.front().y) == oExtremePoints.jStart);
-        assert(std::round(m_Profile.back().x) == oExtremePoints.iEnd);
-        assert(std::round(m_Profile.back().y) == oExtremePoints.jEnd);
+        profile.push_back({static_cast<double>(x), static_cast<double>(y), static_cast<double>(*pixel)});
+        assert(std::round(profile.front().x) == oExtremePoints.iStart);
+        assert(std::round(profile.front().y) == oExtremePoints.jStart);
+        assert(std::round(profile.back().x) == oExtremePoints.iEnd);
+        assert(std::round(profile.back().y) == oExtremePoints.jEnd);
+        return profile;
     }
 
-    void IntensityProfileModel::computeProfileWithMainDirectionInterpolation()
+    IntensityProfileModel::Profile IntensityProfileModel::computeProfileWithMainDirectionInterpolation(const Input &input)
     {
-        m_Profile.clear();
-        const precitec::image::BImage & rImage = std::get<precitec::image::BImage>(m_ImageData);
+        Profile profile;
+        const precitec::image::BImage & rImage = input.image;
         if (!rImage.isValid())
         {
-            return;
+            return profile;
         }
 
-        ExtremePoints oExtremePoints = computeExtremePoints();
+        ExtremePoints oExtremePoints = computeExtremePoints(input);
 
         const unsigned int xDistance = std::abs(oExtremePoints.iEnd-oExtremePoints.iStart);
         const unsigned int yDistance = std::abs(oExtremePoints.jEnd-oExtremePoints.jStart);
@@ -193,15 +268,15 @@ namespace image
         //special case: coincident points
         if (xDistance == 0 && yDistance == 0)
         {
-            m_Profile.push_back({ static_cast<double>(oExtremePoints.iStart),  static_cast<double>(oExtremePoints.jStart), static_cast<double>(rImage.getValue( oExtremePoints.iStart,  oExtremePoints.jStart))});
-            return;
+            profile.push_back({ static_cast<double>(oExtremePoints.iStart),  static_cast<double>(oExtremePoints.jStart), static_cast<double>(rImage.getValue( oExtremePoints.iStart,  oExtremePoints.jStart))});
+            return profile;
         }
 
         const SamplingDirection oDirection = xDistance > yDistance?
             SamplingDirection::Horizontal : SamplingDirection::Vertical;
 
             const unsigned int numPoints = (oDirection == SamplingDirection::Horizontal? xDistance : yDistance) + 1; //inclusive of end point
-        m_Profile.reserve(numPoints);
+        profile.reserve(numPoints);
 
         if (oDirection == SamplingDirection::Horizontal)
         {
@@ -222,7 +297,7 @@ namespace image
                 double k = y - j; //e.g k = 0.5 means that the sampling point is between 2 pixels
 
                 double intensity = k > 0.1 ? (1-k)*rImage.getValue(i,j) + k * rImage.getValue(i, j+1): rImage.getValue(i,j);
-                m_Profile.push_back({static_cast<double>(i), y, intensity});
+                profile.push_back({static_cast<double>(i), y, intensity});
             }
         }
         else
@@ -251,15 +326,16 @@ namespace image
                     const auto &nextPixel = (*(++pixel));
                     intensity = (1-k) * currentPixel + k * nextPixel;
                 }
-                m_Profile.push_back({x, static_cast<double>(j), intensity});
+                profile.push_back({x, static_cast<double>(j), intensity});
             }
         }
 
-        assert(m_Profile.size() == numPoints);
-        assert(std::round(m_Profile.front().x) == oExtremePoints.iStart);
-        assert(std::round(m_Profile.front().y) == oExtremePoints.jStart);
-        assert(std::round(m_Profile.back().x) == oExtremePoints.iEnd);
-        assert(std::round(m_Profile.back().y) == oExtremePoints.jEnd);
+        assert(profile.size() == numPoints);
+        assert(std::round(profile.front().x) == oExtremePoints.iStart);
+        assert(std::round(profile.front().y) == oExtremePoints.jStart);
+        assert(std::round(profile.back().x) == oExtremePoints.iEnd);
+        assert(std::round(profile.back().y) == oExtremePoints.jEnd);
+        return profile;
     }
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QFuture>
 #include "image/image.h"
 #include "imageItem.h"
 
@@ -19,6 +20,12 @@ class DataSet;
 
 namespace image
 {
+/**
+ * @brief Model for the grey levels along the line from @link{startPoint} to @link{endPoint} in the @link{imageData}.
+ *
+ * The profile is computed in a background thread, changes during a running computation are coalesced
+ * like in the ImageHistogramModel.
+ **/
 class IntensityProfileModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -26,6 +33,10 @@ class IntensityProfileModel : public QAbstractListModel
     Q_PROPERTY(QVector2D startPoint READ startPoint WRITE setStartPoint NOTIFY startPointChanged)
     Q_PROPERTY(QVector2D endPoint READ endPoint WRITE setEndPoint NOTIFY endPointChanged)
     Q_PROPERTY(precitec::gui::components::plotter::DataSet *dataSet READ dataSet CONSTANT)
+    /**
+     * Whether the profile is currently computed in the background thread.
+     **/
+    Q_PROPERTY(bool updating READ isUpdating NOTIFY updatingChanged)
 
 public:
     explicit IntensityProfileModel (QObject *parent = nullptr);
@@ -45,11 +56,17 @@ public:
         return m_dataSet;
     }
 
+    bool isUpdating() const
+    {
+        return m_updating;
+    }
+
     Q_SIGNALS:
 
         void imageDataChanged();
     void startPointChanged();
     void endPointChanged();
+    void updatingChanged();
 
 private:
 
@@ -65,18 +82,39 @@ private:
         int jEnd;
     };
     enum class SamplingDirection {Horizontal, Vertical};
+    using Profile = std::vector<SampledPoint>;
+
+    /**
+     * Identifies the image and line the profile was computed for.
+     **/
+    struct Input
+    {
+        precitec::image::BImage image;
+        int imageNumber = 0;
+        QVector2D startPoint;
+        QVector2D endPoint;
+
+        bool operator==(const Input &other) const;
+    };
 
     precitec::gui::components::image::ImageData  m_ImageData;
     QVector2D m_startPoint;
     QVector2D m_endPoint;
 
-    std::vector<SampledPoint> m_Profile;
+    Profile m_Profile;
     precitec::gui::components::plotter::DataSet *m_dataSet;
 
-    ExtremePoints computeExtremePoints();
-    void computeProfileWithoutInterpolation();
-    void computeProfileWithMainDirectionInterpolation();
+    Input m_lastInput;
+    QFuture<Profile> m_future;
+    bool m_updating = false;
+    bool m_queueUpdate = false;
+
+    static ExtremePoints computeExtremePoints(const Input &input);
+    static Profile computeProfileWithoutInterpolation(const Input &input);
+    static Profile computeProfileWithMainDirectionInterpolation(const Input &input);
     void update();
+    void setProfile(Profile &&profile);
+    void setUpdating(bool set);
 };
 
 
@@ -0,0 +1,101 @@
+#include <QTest>
+
+#include "../logFilterModel.h"
+#include "../logModel.h"
+
+#include "message/loggerGlobal.interface.h"
+
+std::unique_ptr<precitec::ModuleLogger> g_pLogger = nullptr;
+
+using precitec::interface::wmLogItem;
+using precitec::interface::wmLogParam;
+using precitec::gui::components::logging::LogEntry;
+using precitec::gui::components::logging::LogFilterModel;
+using precitec::gui::components::logging::LogModel;
+
+class BenchmarkLogModel : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkFormat();
+    void benchmarkLogStorm();
+};
+
+namespace
+{
+
+// a log storm of 50000 messages per second, taken from the receiver every 20 msec
+const int MESSAGES_PER_SECOND = 50000;
+const int BATCHES = 50;
+
+wmLogItem createItem(int i)
+{
+    wmLogItem item{Poco::Timestamp(), 0, std::string("Seam %d: %s exceeds %f"), std::string(), std::string(i % 2 == 0 ? "Analyzer" : "Grabber"), i % 5 == 0 ? 2 : 1};
+    item.addParam(wmLogParam{i});
+    item.addParam(wmLogParam{std::string{"value"}});
+    item.addParam(wmLogParam{0.5});
+    return item;
+}
+
+}
+
+void BenchmarkLogModel::initTestCase()
+{
+    qputenv("WM_STATION_NAME", "BENCHMARKLOGMODEL");
+    g_pLogger = std::unique_ptr<precitec::ModuleLogger>(new precitec::ModuleLogger(precitec::system::module::ModuleName[precitec::system::module::Modules::UserInterfaceModul]));
+}
+
+void BenchmarkLogModel::benchmarkFormat()
+{
+    // the part done in the receiver thread
+    std::vector<wmLogItem> items;
+    items.reserve(MESSAGES_PER_SECOND / BATCHES);
+    for (int i = 0; i < MESSAGES_PER_SECOND / BATCHES; i++)
+    {
+        items.push_back(createItem(i));
+    }
+    std::deque<LogEntry> entries;
+    QBENCHMARK
+    {
+        entries.clear();
+        for (const auto &item : items)
+        {
+            entries.emplace_back(item);
+        }
+    }
+    QCOMPARE(entries.back().message(), QStringLiteral("Seam 999: value exceeds 0.5"));
+}
+
+void BenchmarkLogModel::benchmarkLogStorm()
+{
+    // one second of the log storm through the model and the filter model, as in TestLogModel::testLogStorm
+    LogModel model;
+    LogFilterModel filterModel;
+    filterModel.setSourceModel(&model);
+    filterModel.setProperty("moduleNameFilter", QByteArrayLiteral("Analyzer"));
+
+    QBENCHMARK
+    {
+        for (int batch = 0; batch < BATCHES; batch++)
+        {
+            std::deque<LogEntry> entries;
+            for (int i = batch * MESSAGES_PER_SECOND / BATCHES; i < (batch + 1) * MESSAGES_PER_SECOND / BATCHES; i++)
+            {
+                entries.emplace_back(createItem(i));
+            }
+            model.addEntries(std::move(entries));
+
+            // the view shows the latest messages
+            for (int row = filterModel.rowCount() - 30; row < filterModel.rowCount(); row++)
+            {
+                filterModel.index(row, 0).data();
+            }
+        }
+    }
+    QCOMPARE(model.rowCount({}), 5000);
+    QCOMPARE(filterModel.rowCount(), 2500);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkLogModel)
+#include "benchmarkLogModel.moc"
@@ -3,6 +3,7 @@
 
 #include <cmath>
 
+#include "../logFilterModel.h"
 #include "../logModel.h"
 
 #include "message/loggerGlobal.interface.h"
@@ -11,6 +12,8 @@ std::unique_ptr<precitec::ModuleLogger> g_pLogger = nullptr;
 
 using precitec::interface::wmLogItem;
 using precitec::interface::wmLogParam;
+using precitec::gui::components::logging::LogEntry;
+using precitec::gui::components::logging::LogFilterModel;
 using precitec::gui::components::logging::LogModel;
 
 typedef std::vector<precitec::interface::wmLogParam> LogParamList;
@@ -27,8 +30,10 @@ private Q_SLOTS:
     void testFormat_data();
     void testFormat();
     void testAddingData();
+    void testMaximumLogMessage();
     void testThreadedReceiver();
     void testPaused();
+    void testLogStorm();
 };
 
 void TestLogModel::initTestCase()
@@ -83,7 +88,6 @@ void TestLogModel::testFormat_data()
 
 void TestLogModel::testFormat()
 {
-    LogModel model;
     QFETCH(QByteArray, message);
     wmLogItem logItem(Poco::Timestamp(), 0, message.toStdString());
     QFETCH(LogParamList, logParams);
@@ -92,7 +96,8 @@ void TestLogModel::testFormat()
         logItem.addParam(param);
     }
 
-    QTEST(model.format(logItem), "expected");
+    QTEST(LogEntry::format(logItem), "expected");
+    QTEST(LogEntry{logItem}.message(), "expected");
 }
 
 void TestLogModel::testAddingData()
@@ -172,8 +177,7 @@ void TestLogModel::testAddingData()
     QCOMPARE(model.index(3, 0).data(Qt::DisplayRole).toString(), QStringLiteral("2This is my log message3"));
     QCOMPARE(model.index(4, 0).data(Qt::DisplayRole).toString(), QStringLiteral("2This is my log message4"));
 
-    // add more items than supported by the model
-    // TODO: should we really allow more elements than capacity?
+    // add more items than supported by the model, only the newest are kept
     QCOMPARE(modelResetSpy.count(), 0);
     model.addItems({
         wmLogItem{Poco::Timestamp(), 0, std::string("3This is my warning message"), std::string(), std::string("Test Module"), 2},
@@ -187,13 +191,13 @@ void TestLogModel::testAddingData()
     QCOMPARE(rowsInsertedSpy.count(), 2);
     QCOMPARE(rowsRemovedSpy.count(), 1);
     QCOMPARE(latestWarningChangedSpy.count(), 2);
-    QCOMPARE(model.latestWarningOrError(), model.index(3, 0).data().toString());
-    QCOMPARE(model.rowCount(QModelIndex()), 6);
-    QCOMPARE(model.index(1, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message2"));
-    QCOMPARE(model.index(2, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message3"));
-    QCOMPARE(model.index(3, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my warning message4"));
-    QCOMPARE(model.index(4, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message5"));
-    QCOMPARE(model.index(5, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message6"));
+    QCOMPARE(model.latestWarningOrError(), model.index(2, 0).data().toString());
+    QCOMPARE(model.rowCount(QModelIndex()), 5);
+    QCOMPARE(model.index(0, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message2"));
+    QCOMPARE(model.index(1, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message3"));
+    QCOMPARE(model.index(2, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my warning message4"));
+    QCOMPARE(model.index(3, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message5"));
+    QCOMPARE(model.index(4, 0).data(Qt::DisplayRole).toString(), QStringLiteral("3This is my log message6"));
 
     // let's add nothing
     model.addItems({});
@@ -223,6 +227,60 @@ void TestLogModel::testAddingData()
     QCOMPARE(model.rowCount({}), 5);
 }
 
+void TestLogModel::testMaximumLogMessage()
+{
+    LogModel model;
+    QSignalSpy rowsRemovedSpy(&model, &LogModel::rowsRemoved);
+    QVERIFY(rowsRemovedSpy.isValid());
+    QSignalSpy maximumLogMessageChangedSpy(&model, &LogModel::maximumLogMessageChanged);
+    QVERIFY(maximumLogMessageChangedSpy.isValid());
+
+    std::deque<wmLogItem> items;
+    for (int i = 0; i < 10; i++)
+    {
+        items.emplace_back(Poco::Timestamp(), 0, std::string("Message %d"), std::string(), std::string(i % 2 == 0 ? "Even" : "Odd"));
+        items.back().addParam(wmLogParam{i});
+    }
+    model.addItems(std::move(items));
+    QCOMPARE(model.rowCount({}), 10);
+    QCOMPARE(model.level(0), LogModel::LogLevel::Info);
+    QCOMPARE(model.module(0), QByteArrayLiteral("Even"));
+    QCOMPARE(model.module(1), QByteArrayLiteral("Odd"));
+
+    // reducing the maximum removes the oldest messages
+    model.setMaximumLogMessage(4);
+    QCOMPARE(model.maximumLogMessage(), 4u);
+    QCOMPARE(maximumLogMessageChangedSpy.count(), 1);
+    QCOMPARE(rowsRemovedSpy.count(), 1);
+    QCOMPARE(rowsRemovedSpy.last().at(1).toInt(), 0);
+    QCOMPARE(rowsRemovedSpy.last().at(2).toInt(), 5);
+    QCOMPARE(model.rowCount({}), 4);
+    QCOMPARE(model.index(0, 0).data().toString(), QStringLiteral("Message 6"));
+    QCOMPARE(model.index(3, 0).data().toString(), QStringLiteral("Message 9"));
+    QCOMPARE(model.module(0), QByteArrayLiteral("Even"));
+
+    // increasing the maximum keeps all messages
+    model.setMaximumLogMessage(6);
+    QCOMPARE(maximumLogMessageChangedSpy.count(), 2);
+    QCOMPARE(rowsRemovedSpy.count(), 1);
+    QCOMPARE(model.rowCount({}), 4);
+
+    model.setMaximumLogMessage(6);
+    QCOMPARE(maximumLogMessageChangedSpy.count(), 2);
+
+    // the ring wraps around
+    for (int i = 10; i < 15; i++)
+    {
+        model.addItems({wmLogItem{Poco::Timestamp(), 0, QStringLiteral("Message %1").arg(i).toStdString()}});
+    }
+    QCOMPARE(model.rowCount({}), 6);
+    QCOMPARE(rowsRemovedSpy.count(), 4);
+    for (int i = 0; i < 6; i++)
+    {
+        QCOMPARE(model.index(i, 0).data().toString(), QStringLiteral("Message %1").arg(i + 9));
+    }
+}
+
 void TestLogModel::testThreadedReceiver()
 {
     LogModel model;
@@ -323,5 +381,48 @@ void TestLogModel::testPaused()
     QCOMPARE(model.index(4, 0).data(Qt::DisplayRole).toString(), QStringLiteral("This is another log message 12"));
 }
 
+void TestLogModel::testLogStorm()
+{
+    // a log storm of 50000 messages per second, taken from the receiver every 20 msec, see benchmarkLogModel for the time it takes
+    const int messagesPerSecond = 50000;
+    const int batches = 50;
+
+    LogModel model;
+    LogFilterModel filterModel;
+    filterModel.setSourceModel(&model);
+    filterModel.setProperty("moduleNameFilter", QByteArrayLiteral("Analyzer"));
+
+    for (int batch = 0; batch < batches; batch++)
+    {
+        // formatting is done in the receiver thread
+        std::deque<LogEntry> entries;
+        for (int i = batch * messagesPerSecond / batches; i < (batch + 1) * messagesPerSecond / batches; i++)
+        {
+            wmLogItem item{Poco::Timestamp(), 0, std::string("Seam %d: %s exceeds %f"), std::string(), std::string(i % 2 == 0 ? "Analyzer" : "Grabber"), i % 5 == 0 ? 2 : 1};
+            item.addParam(wmLogParam{i});
+            item.addParam(wmLogParam{std::string{"value"}});
+            item.addParam(wmLogParam{0.5});
+            entries.emplace_back(item);
+        }
+        model.addEntries(std::move(entries));
+
+        // the view shows the latest messages
+        for (int row = filterModel.rowCount() - 30; row < filterModel.rowCount(); row++)
+        {
+            QVERIFY(filterModel.index(row, 0).data().toString().startsWith(QStringLiteral("Seam ")));
+        }
+    }
+    QCOMPARE(model.rowCount({}), 5000);
+    QCOMPARE(filterModel.rowCount(), 2500);
+    QCOMPARE(model.index(4999, 0).data().toString(), QStringLiteral("Seam 49999: value exceeds 0.5"));
+    QCOMPARE(model.latestWarningOrError(), QStringLiteral("Seam 49995: value exceeds 0.5"));
+
+    // filtering on the level
+    filterModel.setProperty("includeInfo", false);
+    QCOMPARE(filterModel.rowCount(), 500);
+    filterModel.setProperty("moduleNameFilter", QByteArray());
+    QCOMPARE(filterModel.rowCount(), 1000);
+}
+
 QTEST_GUILESS_MAIN(TestLogModel)
 #include "testLogModel.moc"
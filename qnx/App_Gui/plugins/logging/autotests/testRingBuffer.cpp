@@ -0,0 +1,142 @@
+#include <QTest>
+
+#include "../ringBuffer.h"
+
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+using precitec::gui::components::logging::RingBuffer;
+
+class TestRingBuffer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCtor();
+    void testPushBack();
+    void testPopFront();
+    void testSetCapacity();
+    void testTake();
+};
+
+void TestRingBuffer::testCtor()
+{
+    RingBuffer<int> buffer{3};
+    QCOMPARE(buffer.size(), std::size_t(0));
+    QCOMPARE(buffer.capacity(), std::size_t(3));
+    QVERIFY(buffer.empty());
+    QVERIFY_EXCEPTION_THROWN(buffer.at(0), std::out_of_range);
+
+    RingBuffer<int> empty;
+    QCOMPARE(empty.capacity(), std::size_t(0));
+    empty.push_back(1);
+    QVERIFY(empty.empty());
+}
+
+void TestRingBuffer::testPushBack()
+{
+    RingBuffer<std::string> buffer{3};
+    buffer.push_back("a");
+    buffer.push_back("b");
+    QCOMPARE(buffer.size(), std::size_t(2));
+    QCOMPARE(buffer.at(0), std::string{"a"});
+    QCOMPARE(buffer.at(1), std::string{"b"});
+    QVERIFY_EXCEPTION_THROWN(buffer.at(2), std::out_of_range);
+
+    // the oldest elements are dropped once the capacity is reached
+    buffer.push_back("c");
+    buffer.push_back("d");
+    buffer.push_back("e");
+    QCOMPARE(buffer.size(), std::size_t(3));
+    QCOMPARE(buffer.at(0), std::string{"c"});
+    QCOMPARE(buffer.at(1), std::string{"d"});
+    QCOMPARE(buffer.at(2), std::string{"e"});
+
+    buffer.at(1) = "f";
+    QCOMPARE(buffer.at(1), std::string{"f"});
+}
+
+void TestRingBuffer::testPopFront()
+{
+    RingBuffer<int> buffer{4};
+    for (int i = 0; i < 6; i++)
+    {
+        buffer.push_back(int{i});
+    }
+    buffer.pop_front();
+    QCOMPARE(buffer.size(), std::size_t(3));
+    QCOMPARE(buffer.at(0), 3);
+
+    buffer.pop_front(2);
+    QCOMPARE(buffer.size(), std::size_t(1));
+    QCOMPARE(buffer.at(0), 5);
+
+    buffer.push_back(6);
+    buffer.push_back(7);
+    QCOMPARE(buffer.size(), std::size_t(3));
+    QCOMPARE(buffer.at(2), 7);
+
+    // removing more than the size clears the buffer
+    buffer.pop_front(10);
+    QVERIFY(buffer.empty());
+    QCOMPARE(buffer.capacity(), std::size_t(4));
+
+    buffer.push_back(8);
+    QCOMPARE(buffer.at(0), 8);
+    buffer.clear();
+    QVERIFY(buffer.empty());
+}
+
+void TestRingBuffer::testSetCapacity()
+{
+    RingBuffer<int> buffer{4};
+    for (int i = 0; i < 6; i++)
+    {
+        buffer.push_back(int{i});
+    }
+
+    // the newest elements are kept
+    buffer.setCapacity(2);
+    QCOMPARE(buffer.capacity(), std::size_t(2));
+    QCOMPARE(buffer.size(), std::size_t(2));
+    QCOMPARE(buffer.at(0), 4);
+    QCOMPARE(buffer.at(1), 5);
+
+    buffer.setCapacity(5);
+    QCOMPARE(buffer.capacity(), std::size_t(5));
+    QCOMPARE(buffer.size(), std::size_t(2));
+    for (int i = 6; i < 10; i++)
+    {
+        buffer.push_back(int{i});
+    }
+    QCOMPARE(buffer.size(), std::size_t(5));
+    for (std::size_t i = 0; i < buffer.size(); i++)
+    {
+        QCOMPARE(buffer.at(i), int(i) + 5);
+    }
+
+    buffer.setCapacity(0);
+    QVERIFY(buffer.empty());
+}
+
+void TestRingBuffer::testTake()
+{
+    RingBuffer<std::string> buffer{3};
+    for (const auto &value : {"a", "b", "c", "d"})
+    {
+        buffer.push_back(value);
+    }
+    const auto values = buffer.take<std::deque<std::string>>();
+    QCOMPARE(values.size(), std::size_t(3));
+    QCOMPARE(values.at(0), std::string{"b"});
+    QCOMPARE(values.at(1), std::string{"c"});
+    QCOMPARE(values.at(2), std::string{"d"});
+    QVERIFY(buffer.empty());
+    QCOMPARE(buffer.capacity(), std::size_t(3));
+
+    buffer.push_back("e");
+    QCOMPARE(buffer.at(0), std::string{"e"});
+}
+
+QTEST_GUILESS_MAIN(TestRingBuffer)
+#include "testRingBuffer.moc"
@@ -0,0 +1,122 @@
+#include "logEntry.h"
+
+#include "../general/languageSupport.h"
+
+#include <chrono>
+
+namespace precitec
+{
+namespace gui
+{
+namespace components
+{
+namespace logging
+{
+
+LogEntry::LogEntry(const precitec::interface::wmLogItem &item)
+    : m_timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(item.timestamp().epochMicroseconds())).count())
+    , m_module(QByteArray::fromStdString(item.moduleName()))
+    , m_type(item.type())
+{
+    // the translations are loaded concurrently: check before formatting, otherwise a message formatted
+    // without translations would not be kept for translate() if they become ready in between
+    if (!item.key().empty() && !LanguageSupport::instance()->isReady())
+    {
+        m_untranslatedItem = std::make_shared<const precitec::interface::wmLogItem>(item);
+    }
+    m_message = format(item);
+}
+
+bool LogEntry::translate()
+{
+    if (!m_untranslatedItem || !LanguageSupport::instance()->isReady())
+    {
+        return false;
+    }
+    auto message = format(*m_untranslatedItem);
+    m_untranslatedItem.reset();
+    if (message == m_message)
+    {
+        return false;
+    }
+    m_message = std::move(message);
+    return true;
+}
+
+namespace
+{
+
+/**
+ * Seeks to the next index of a "%" not followed by a "%".
+ * Replaces all "%%" on the fly with "%"
+ **/
+int findNextMarkerReplacingEscape(QString &message, int startIndex)
+{
+    int index = message.indexOf(QLatin1Char('%'), startIndex);
+    if (index == -1)
+    {
+        return -1;
+    }
+    if (index + 1 == message.length())
+    {
+        return -1;
+    }
+    if (message.at(index + 1) == QLatin1Char('%'))
+    {
+        message.replace(index, 2, QLatin1String("%"));
+        return findNextMarkerReplacingEscape(message, index + 1);
+    }
+    return index;
+}
+}
+
+QString LogEntry::format(const precitec::interface::wmLogItem &item)
+{
+    QString message = QString::fromStdString(item.message()).trimmed();
+    if (!item.key().empty())
+    {
+        const auto key = QString::fromStdString(item.key());
+        const auto translated = LanguageSupport::instance()->getString(key);
+        // in case the key is not translated, the key is returned and then we use the untranslated message
+        if (translated != key)
+        {
+            message = translated.trimmed();
+        }
+    }
+    int index = 0;
+    for (const auto &param : item.getParams())
+    {
+        index = findNextMarkerReplacingEscape(message, index);
+        const int nextCharIndex = index + 1;
+        if (index == -1)
+        {
+            break;
+        }
+        const auto &character = message.at(nextCharIndex);
+        if (character == QLatin1Char('d') || character == QLatin1Char('i'))
+        {
+            message.replace(index, 2, QString::number(int(param.value())));
+        } else if (character == QLatin1Char('u'))
+        {
+            message.replace(index, 2, QString::number(uint(param.value())));
+        } else if (character == QLatin1Char('x'))
+        {
+            message.replace(index, 2, QString::number(uint(param.value()), 16));
+        } else if (character == QLatin1Char('f'))
+        {
+            message.replace(index, 2, QString::number(param.value()));
+        } else if (character == QLatin1Char('s'))
+        {
+            const QString replaceString = QString::fromStdString(param.string());
+            message.replace(index, 2, replaceString);
+            index += replaceString.length();
+        }
+    }
+    findNextMarkerReplacingEscape(message, index);
+    return message;
+}
+
+}
+}
+}
+}
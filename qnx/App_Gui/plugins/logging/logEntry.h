@@ -0,0 +1,81 @@
+#pragma once
+
+#include "message/loggerGlobal.interface.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <memory>
+
+namespace precitec
+{
+namespace gui
+{
+namespace components
+{
+namespace logging
+{
+
+/**
+ * @brief A log message with the formatted text and the fields used for filtering.
+ *
+ * The LogEntry is created in the thread receiving the log messages, thus the message is formatted only once
+ * and the GUI thread does not need to access the wmLogItem. If the message has a translation key, but the
+ * translations are not yet loaded, the wmLogItem is kept and the message is formatted again in @link{translate}.
+ **/
+class LogEntry
+{
+public:
+    LogEntry() = default;
+    explicit LogEntry(const precitec::interface::wmLogItem &item);
+
+    const QString &message() const
+    {
+        return m_message;
+    }
+
+    /**
+     * Milliseconds since epoch
+     **/
+    qint64 timestamp() const
+    {
+        return m_timestamp;
+    }
+
+    const QByteArray &module() const
+    {
+        return m_module;
+    }
+
+    /**
+     * The LogType of the message
+     **/
+    int type() const
+    {
+        return m_type;
+    }
+
+    /**
+     * Formats the message again if it was created before the translations were loaded.
+     * @returns whether the message changed
+     **/
+    bool translate();
+
+    /**
+     * Formats the given log @p item and returns as a QString.
+     * The placeholders are replaced by the appropriate parameters of the @p item.
+     **/
+    static QString format(const precitec::interface::wmLogItem &item);
+
+private:
+    QString m_message;
+    qint64 m_timestamp = 0;
+    QByteArray m_module;
+    int m_type = 0;
+    std::shared_ptr<const precitec::interface::wmLogItem> m_untranslatedItem;
+};
+
+}
+}
+}
+}
@@ -1,5 +1,4 @@
 #include "logFilterModel.h"
-#include "logModel.h"
 
 #include <precitec/userManagement.h>
 
@@ -29,6 +28,11 @@ LogFilterModel::LogFilterModel(QObject *parent)
     connect(this, &LogFilterModel::includeTrackerChanged, this, invalidate);
     connect(UserManagement::instance(), &UserManagement::currentUserChanged, this, &LogFilterModel::canIncludeDebugChanged);
     connect(this, &LogFilterModel::canIncludeDebugChanged, this, invalidate);
+    connect(this, &LogFilterModel::sourceModelChanged, this,
+        [this]
+        {
+            m_logModel = qobject_cast<LogModel*>(sourceModel());
+        });
 }
 
 LogFilterModel::~LogFilterModel() = default;
@@ -44,8 +48,12 @@ bool LogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourcePa
     {
         return false;
     }
+    if (m_logModel)
+    {
+        return includeByErrorLevel(m_logModel->level(sourceRow)) && (m_moduleNameFilter.isEmpty() || m_logModel->module(sourceRow) == m_moduleNameFilter);
+    }
     const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
-    if (!includeByErrorLevel(index))
+    if (!includeByErrorLevel(index.data(Qt::UserRole + 2).value<LogModel::LogLevel>()))
     {
         return false;
     }
@@ -57,9 +65,9 @@ bool LogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourcePa
     return groupName == m_moduleNameFilter;
 }
 
-bool LogFilterModel::includeByErrorLevel(const QModelIndex &sourceIndex) const
+bool LogFilterModel::includeByErrorLevel(LogModel::LogLevel level) const
 {
-    switch (sourceIndex.data(Qt::UserRole + 2).value<LogModel::LogLevel>())
+    switch (level)
     {
     case LogModel::LogLevel::Info:
     case LogModel::LogLevel::Startup:
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "logModel.h"
+
+#include <QPointer>
 #include <QSortFilterProxyModel>
 
 namespace precitec
@@ -16,6 +19,7 @@ namespace logging
  *
  * The main purpose is to restrict the modules for which to show the log messages.
  * Use property @link{moduleNameFilter} to filter on a module name.
+ * If the source model is a LogModel the level and module of a row are read directly instead of through the roles.
  **/
 class LogFilterModel : public QSortFilterProxyModel
 {
@@ -88,7 +92,8 @@ Q_SIGNALS:
     void viewDebugMessagesPermissionChanged();
 
 private:
-    bool includeByErrorLevel(const QModelIndex &sourceIndex) const;
+    bool includeByErrorLevel(LogModel::LogLevel level) const;
+    QPointer<LogModel> m_logModel;
     QByteArray m_moduleNameFilter;
     bool m_includeInfo = true;
     bool m_includeWarning = true;
@@ -9,6 +9,8 @@
 #include <QDateTime>
 #include <QThread>
 
+#include <algorithm>
+
 using precitec::gui::components::user::UserManagement;
 
 namespace precitec
@@ -24,6 +26,8 @@ LogModel::LogModel(QObject *parent)
     : QAbstractListModel(parent)
     , m_moduleModel(new ModuleModel(this))
 {
+    m_logItems.setCapacity(m_maximumLogMessage);
+    m_pauseQueue.setCapacity(m_maximumLogMessage);
     m_moduleModel->setLogModel(this);
     connect(UserManagement::instance(), &UserManagement::currentUserChanged, this, &LogModel::canClearChanged);
     connect(this, &LogModel::pausedChanged, this,
@@ -33,10 +37,11 @@ LogModel::LogModel(QObject *parent)
             {
                 return;
             }
-            addItems(std::move(m_pauseQueue));
-            m_pauseQueue = {};
+            addEntries(m_pauseQueue.take<std::deque<LogEntry>>());
         });
     connect(this, &LogModel::stationChanged, this, &LogModel::initReceiverThread);
+    // also ensures that the LanguageSupport is created in the GUI thread before the receiver thread formats messages
+    connect(LanguageSupport::instance(), &LanguageSupport::readyChanged, this, &LogModel::translate);
 }
 
 LogModel::~LogModel()
@@ -58,98 +63,22 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
     {
         return QVariant();
     }
-    const auto &item = m_logItems.at(index.row());
+    const auto &entry = m_logItems.at(index.row());
     switch (role)
     {
     case Qt::DisplayRole:
-        return format(item);
+        return entry.message();
     case Qt::UserRole:
-    {
-        const std::chrono::microseconds time(item.timestamp().epochMicroseconds());
-        return QDateTime::fromMSecsSinceEpoch(std::chrono::duration_cast<std::chrono::milliseconds>(time).count());
-    }
+        return QDateTime::fromMSecsSinceEpoch(entry.timestamp());
     case Qt::UserRole+1:
-        return QByteArray::fromStdString(item.moduleName());
+        return entry.module();
     case Qt::UserRole+2:
-        return QVariant::fromValue(LogLevel(item.type()));
+        return QVariant::fromValue(LogLevel(entry.type()));
     default:
         return QVariant();
     }
 }
 
-namespace
-{
-
-/**
- * Seeks to the next index of a "%" not followed by a "%".
- * Replaces all "%%" on the fly with "%"
- **/
-int findNextMarkerReplacingEscape(QString &message, int startIndex)
-{
-    int index = message.indexOf(QLatin1Char('%'), startIndex);
-    if (index == -1)
-    {
-        return -1;
-    }
-    if (index + 1 == message.length())
-    {
-        return -1;
-    }
-    if (message.at(index + 1) == QLatin1Char('%'))
-    {
-        message.replace(index, 2, QLatin1String("%"));
-        return findNextMarkerReplacingEscape(message, index + 1);
-    }
-    return index;
-}
-}
-
-QString LogModel::format(const precitec::interface::wmLogItem &item) const
-{
-    QString message = QString::fromStdString(item.message()).trimmed();
-    if (!item.key().empty())
-    {
-        const auto key = QString::fromStdString(item.key());
-        const auto translated = LanguageSupport::instance()->getString(key);
-        // in case the key is not translated, the key is returned and then we use the untranslated message
-        if (translated != key)
-        {
-            message = translated.trimmed();
-        }
-    }
-    int index = 0;
-    for (const auto &param : item.getParams())
-    {
-        index = findNextMarkerReplacingEscape(message, index);
-        const int nextCharIndex = index + 1;
-        if (index == -1)
-        {
-            break;
-        }
-        const auto &character = message.at(nextCharIndex);
-        if (character == QLatin1Char('d') || character == QLatin1Char('i'))
-        {
-            message.replace(index, 2, QString::number(int(param.value())));
-        } else if (character == QLatin1Char('u'))
-        {
-            message.replace(index, 2, QString::number(uint(param.value())));
-        } else if (character == QLatin1Char('x'))
-        {
-            message.replace(index, 2, QString::number(uint(param.value()), 16));
-        } else if (character == QLatin1Char('f'))
-        {
-            message.replace(index, 2, QString::number(param.value()));
-        } else if (character == QLatin1Char('s'))
-        {
-            const QString replaceString = QString::fromStdString(param.string());
-            message.replace(index, 2, replaceString);
-            index += replaceString.length();
-        }
-    }
-    findNextMarkerReplacingEscape(message, index);
-    return message;
-}
-
 int LogModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
@@ -171,61 +100,98 @@ QHash<int, QByteArray> LogModel::roleNames() const
 
 void LogModel::addItems(std::deque<precitec::interface::wmLogItem> &&items)
 {
-    if (items.size() == 0)
+    std::deque<LogEntry> entries;
+    for (const auto &item : items)
+    {
+        entries.emplace_back(item);
+    }
+    addEntries(std::move(entries));
+}
+
+void LogModel::addEntries(std::deque<LogEntry> &&entries)
+{
+    if (entries.empty())
     {
         return;
     }
-    for (auto it = items.end(); it != items.begin(); it--)
+    // entries formatted before the translations were loaded might have waited in the receiver while translate() ran
+    for (auto &entry : entries)
     {
-        const auto type = LogLevel((it - 1)->type());
-        if (type == LogLevel::Warning || type == LogLevel::Error || type == LogLevel::Fatal)
+        entry.translate();
+    }
+    const auto latestWarningOrError = std::find_if(entries.rbegin(), entries.rend(),
+        [] (const auto &entry)
         {
-            m_latestWarningOrError = format(*(it - 1));
-            emit latestWarningOrErrorChanged();
-            break;
-        }
+            const auto type = LogLevel(entry.type());
+            return type == LogLevel::Warning || type == LogLevel::Error || type == LogLevel::Fatal;
+        });
+    if (latestWarningOrError != entries.rend())
+    {
+        m_latestWarningOrError = latestWarningOrError->message();
+        emit latestWarningOrErrorChanged();
     }
     if (m_paused)
     {
-        if (m_pauseQueue.size() + items.size() >= m_maximumLogMessage)
+        // the RingBuffer drops the oldest messages
+        for (auto &entry : entries)
         {
-            if (items.size() >= m_maximumLogMessage)
-            {
-                m_pauseQueue = std::move(items);
-                return;
-            } else
-            {
-                auto end = m_pauseQueue.begin();
-                std::advance(end, m_pauseQueue.size() + items.size() - m_maximumLogMessage);
-                m_pauseQueue.erase(m_pauseQueue.begin(), end);
-            }
+            m_pauseQueue.push_back(std::move(entry));
         }
-        std::move(items.begin(), items.end(), std::back_inserter(m_pauseQueue));
         return;
     }
-    if (m_logItems.size() + items.size() >= m_maximumLogMessage)
+    const auto capacity = m_logItems.capacity();
+    if (entries.size() >= capacity)
     {
-        if (items.size() >= m_maximumLogMessage)
-        {
-            beginResetModel();
-            m_logItems = std::move(items);
-            endResetModel();
-            return;
-        } else
+        // only the newest messages are kept
+        beginResetModel();
+        m_logItems.clear();
+        for (auto it = entries.end() - capacity; it != entries.end(); it++)
         {
-            // erase elements
-            beginRemoveRows(QModelIndex(), 0, m_logItems.size() + items.size() - m_maximumLogMessage - 1);
-            auto end = m_logItems.begin();
-            std::advance(end, m_logItems.size() + items.size() - m_maximumLogMessage);
-            m_logItems.erase(m_logItems.begin(), end);
-            endRemoveRows();
+            m_logItems.push_back(std::move(*it));
         }
+        endResetModel();
+        return;
+    }
+    if (m_logItems.size() + entries.size() > capacity)
+    {
+        const auto count = m_logItems.size() + entries.size() - capacity;
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+        m_logItems.pop_front(count);
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), m_logItems.size(), m_logItems.size() + entries.size() - 1);
+    for (auto &entry : entries)
+    {
+        m_logItems.push_back(std::move(entry));
     }
-    beginInsertRows(QModelIndex(), m_logItems.size(), m_logItems.size() + items.size() - 1);
-    std::move(items.begin(), items.end(), std::back_inserter(m_logItems));
     endInsertRows();
 }
 
+void LogModel::translate()
+{
+    int first = -1;
+    int last = -1;
+    for (std::size_t i = 0; i < m_logItems.size(); i++)
+    {
+        if (m_logItems.at(i).translate())
+        {
+            if (first == -1)
+            {
+                first = i;
+            }
+            last = i;
+        }
+    }
+    for (std::size_t i = 0; i < m_pauseQueue.size(); i++)
+    {
+        m_pauseQueue.at(i).translate();
+    }
+    if (first != -1)
+    {
+        emit dataChanged(index(first), index(last), {Qt::DisplayRole});
+    }
+}
+
 void LogModel::clear()
 {
     if (!canClear())
@@ -260,7 +226,7 @@ void LogModel::initReceiverThread()
     connect(m_receiver, &LogReceiver::logsReceived, this,
         [this]
         {
-            addItems(std::forward<std::deque<precitec::interface::wmLogItem>>(m_receiver->takeLogs()));
+            addEntries(m_receiver->takeLogs());
         }, Qt::QueuedConnection);
 
     m_receiverThread->start();
@@ -281,6 +247,26 @@ bool LogModel::canClear() const
     return UserManagement::instance()->hasPermission(m_clearLogMessagesPermission);
 }
 
+void LogModel::setMaximumLogMessage(quint32 maximumLogMessage)
+{
+    if (m_maximumLogMessage == maximumLogMessage)
+    {
+        return;
+    }
+    m_maximumLogMessage = maximumLogMessage;
+    if (m_logItems.size() > m_maximumLogMessage)
+    {
+        beginRemoveRows(QModelIndex(), 0, m_logItems.size() - m_maximumLogMessage - 1);
+        m_logItems.setCapacity(m_maximumLogMessage);
+        endRemoveRows();
+    } else
+    {
+        m_logItems.setCapacity(m_maximumLogMessage);
+    }
+    m_pauseQueue.setCapacity(m_maximumLogMessage);
+    emit maximumLogMessageChanged();
+}
+
 void LogModel::setPaused(bool paused)
 {
     if (m_paused == paused)
@@ -2,6 +2,8 @@
 
 #include <QAbstractListModel>
 
+#include "logEntry.h"
+#include "ringBuffer.h"
 #include "message/loggerGlobal.interface.h"
 
 #include <deque>
@@ -28,6 +30,9 @@ class ModuleModel;
  * @li dateTime: the timestamp of the log message
  * @li module: the name of the module which emitted the log message
  * @li level: The log level (see LogType)
+ *
+ * The log messages are formatted once when they are received, see @link{LogEntry}.
+ * They are kept in a RingBuffer of @link{maximumLogMessage} entries, thus removing the oldest messages is cheap.
  **/
 class LogModel : public QAbstractListModel
 {
@@ -46,7 +51,7 @@ class LogModel : public QAbstractListModel
      * are removed so that the limit is kept.
      * The default maximumLogMessage is @c 5000.
      **/
-    Q_PROPERTY(quint32 maximumLogMessage MEMBER m_maximumLogMessage NOTIFY maximumLogMessageChanged)
+    Q_PROPERTY(quint32 maximumLogMessage READ maximumLogMessage WRITE setMaximumLogMessage NOTIFY maximumLogMessageChanged)
     /**
      * Whether the current logged in user is allowed to clear log messages.
      * If there is no user logged in the property is @c true.
@@ -96,6 +101,28 @@ public:
 
     QAbstractItemModel *moduleModel() const;
 
+    quint32 maximumLogMessage() const
+    {
+        return m_maximumLogMessage;
+    }
+    void setMaximumLogMessage(quint32 maximumLogMessage);
+
+    /**
+     * The log level of the message in @p row, same as the level role without creating a QVariant.
+     **/
+    LogLevel level(int row) const
+    {
+        return LogLevel(m_logItems.at(row).type());
+    }
+
+    /**
+     * The module name of the message in @p row, same as the module role without creating a QVariant.
+     **/
+    const QByteArray &module(int row) const
+    {
+        return m_logItems.at(row).module();
+    }
+
     /**
      * Clears the model by removing all log entries.
      **/
@@ -137,13 +164,16 @@ private:
      **/
     void addItems(std::deque<precitec::interface::wmLogItem> &&items);
     /**
-     * Formats the given log @p item and returns as a QString.
-     * The placeholders are replaced by the appropriate parameters of the @p item.
+     * Adds the already formatted @p entries to the LogModel. Entries formatted before the translations were loaded are translated.
+     **/
+    void addEntries(std::deque<LogEntry> &&entries);
+    /**
+     * Formats the messages again which were received before the translations were loaded.
      **/
-    QString format(const precitec::interface::wmLogItem &item) const;
+    void translate();
 
-    std::deque<precitec::interface::wmLogItem> m_logItems;
-    std::deque<precitec::interface::wmLogItem> m_pauseQueue;
+    RingBuffer<LogEntry> m_logItems;
+    RingBuffer<LogEntry> m_pauseQueue;
     QThread *m_receiverThread = nullptr;
     LogReceiver *m_receiver = nullptr;
     QString m_latestWarningOrError;
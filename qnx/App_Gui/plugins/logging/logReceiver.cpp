@@ -96,9 +96,10 @@ void LogReceiver::getLogs()
             auto content = reinterpret_cast<LogShMemContent*>(sharedMemory.begin());
             if ( content->m_oWriteIndex != content->m_oReadIndexGui || content->m_bRollOverGui == true )
             {
-                QMutexLocker locker(m_mutex.get());
+                LogEntry entry{convertMsg(content->m_oMessages[content->m_oReadIndexGui], content->m_oReadIndexGui)};
 
-                m_messages.emplace_back(convertMsg(content->m_oMessages[content->m_oReadIndexGui], content->m_oReadIndexGui));
+                QMutexLocker locker(m_mutex.get());
+                m_messages.emplace_back(std::move(entry));
 
                 content->m_oReadIndexGui++;
                 if (content->m_oReadIndexGui >= LogMessageCapacity)
@@ -122,10 +123,10 @@ void LogReceiver::getLogs()
     m_timer->start();
 }
 
-std::deque<precitec::interface::wmLogItem> LogReceiver::takeLogs()
+std::deque<LogEntry> LogReceiver::takeLogs()
 {
     QMutexLocker locker(m_mutex.get());
-    std::deque<precitec::interface::wmLogItem> messages = std::move(m_messages);
+    std::deque<LogEntry> messages = std::move(m_messages);
     m_messages.clear();
     return messages;
 }
@@ -2,6 +2,7 @@
 
 #include <QObject>
 
+#include "logEntry.h"
 #include "message/loggerGlobal.interface.h"
 
 #include <deque>
@@ -27,7 +28,7 @@ namespace logging
 /**
  * @brief Periodically queries the logger shared memory for new log messages.
  *
- * The class is supposed to be used in a dedicated thread.
+ * The class is supposed to be used in a dedicated thread. The messages are formatted in this thread.
  * It emits a signal @link{logsReceived} once new log messages are available.
  * They can be obtained by invoking the takeLogs method.
  **/
@@ -42,7 +43,7 @@ public:
      * @returns all log messages which have been received since the last invokation of takeLogs.
      * @see logsReceived
      **/
-    std::deque<precitec::interface::wmLogItem> takeLogs();
+    std::deque<LogEntry> takeLogs();
 
     void setStationName(const QByteArray &stationName)
     {
@@ -61,7 +62,7 @@ private:
     void getLogs();
     void checkForLogFiles();
     std::unique_ptr<QMutex> m_mutex;
-    std::deque<precitec::interface::wmLogItem> m_messages;
+    std::deque<LogEntry> m_messages;
     QFileSystemWatcher *m_shmWatcher;
     std::vector<QFileInfo> m_shmFiles;
     std::vector<Poco::SharedMemory> m_shmSections;
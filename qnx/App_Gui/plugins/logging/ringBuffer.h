@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace precitec
+{
+namespace gui
+{
+namespace components
+{
+namespace logging
+{
+
+/**
+ * @brief Container with a fixed capacity which drops the oldest elements.
+ *
+ * The storage for @link{capacity} elements is allocated once. Appending to a full RingBuffer
+ * overwrites the oldest element, removing elements from the front only moves the start index.
+ * Index @c 0 is the oldest element.
+ **/
+template <typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(std::size_t capacity = 0)
+        : m_data(capacity)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    std::size_t capacity() const
+    {
+        return m_data.size();
+    }
+
+    const T &at(std::size_t index) const
+    {
+        return m_data.at(physicalIndex(index));
+    }
+
+    T &at(std::size_t index)
+    {
+        return m_data.at(physicalIndex(index));
+    }
+
+    /**
+     * Appends @p value, if the RingBuffer is full the oldest element is dropped.
+     **/
+    void push_back(T &&value)
+    {
+        if (m_data.empty())
+        {
+            return;
+        }
+        if (m_size == m_data.size())
+        {
+            m_data[m_start] = std::move(value);
+            m_start = (m_start + 1) % m_data.size();
+            return;
+        }
+        m_data[(m_start + m_size) % m_data.size()] = std::move(value);
+        m_size++;
+    }
+
+    /**
+     * Removes the @p count oldest elements.
+     **/
+    void pop_front(std::size_t count = 1)
+    {
+        count = std::min(count, m_size);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            m_data[m_start] = T{};
+            m_start = (m_start + 1) % m_data.size();
+        }
+        m_size -= count;
+        if (m_size == 0)
+        {
+            m_start = 0;
+        }
+    }
+
+    void clear()
+    {
+        pop_front(m_size);
+    }
+
+    /**
+     * Changes the capacity, if the RingBuffer contains more than @p capacity elements the oldest are dropped.
+     **/
+    void setCapacity(std::size_t capacity)
+    {
+        if (capacity == m_data.size())
+        {
+            return;
+        }
+        pop_front(m_size > capacity ? m_size - capacity : 0);
+        std::vector<T> data(capacity);
+        for (std::size_t i = 0; i < m_size; i++)
+        {
+            data[i] = std::move(at(i));
+        }
+        m_data = std::move(data);
+        m_start = 0;
+    }
+
+    /**
+     * Moves all elements out of the RingBuffer, oldest first.
+     **/
+    template <typename Container>
+    Container take()
+    {
+        Container ret;
+        for (std::size_t i = 0; i < m_size; i++)
+        {
+            ret.push_back(std::move(at(i)));
+        }
+        clear();
+        return ret;
+    }
+
+private:
+    std::size_t physicalIndex(std::size_t index) const
+    {
+        // indices beyond the size are mapped past the storage, thus at throws std::out_of_range
+        return index < m_size ? (m_start + index) % m_data.size() : m_data.size();
+    }
+
+    std::vector<T> m_data;
+    std::size_t m_start = 0;
+    std::size_t m_size = 0;
+};
+
+}
+}
+}
+}
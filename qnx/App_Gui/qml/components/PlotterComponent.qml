@@ -24,6 +24,15 @@ Item {
     property alias multipleSeamControlsVisible: numberOfSeamBox.visible
     property bool toolTipEnabled: true
 
+    /**
+     * The range of the x axis which is currently visible, as labeled by the x legend, and the width of the plot area in pixels.
+     * Allows the resultsModel to provide only as many samples as can be shown.
+     **/
+    readonly property real visibleXSpan: xControl.zoomX > 0 ? (xControl.xMaxVisual - xControl.xMinVisual) / xControl.zoomX : 0
+    readonly property real visibleXMin: xControl.xMinVisual - xControl.panning - xControl.zoomOffset
+    readonly property real visibleXMax: visibleXMin + visibleXSpan
+    readonly property int plotWidth: xLegend.sectionWidth * plotterControl.columns
+
     /**
      * Whether an external configure button should be visible in the button row.
      * If clicked the signal @link{configure} is emitted.
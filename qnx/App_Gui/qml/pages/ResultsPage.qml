@@ -456,6 +456,10 @@ SideTabView {
                         externalConfigureButtonVisible: UserManagement.currentUser && UserManagement.hasPermission(App.RunHardwareAndProductWizard)
                         externalConfigureButtonEnabled: instanceTable.product && !instanceTable.product.defaultProduct
 
+                        onVisibleXMinChanged: resultsDataSetModel.setViewport(plotter.visibleXMin, plotter.visibleXMax, plotter.plotWidth)
+                        onVisibleXMaxChanged: resultsDataSetModel.setViewport(plotter.visibleXMin, plotter.visibleXMax, plotter.plotWidth)
+                        onPlotWidthChanged: resultsDataSetModel.setViewport(plotter.visibleXMin, plotter.visibleXMax, plotter.plotWidth)
+
                         onGoPrevious : seamSelector.selectPrevious()
                         onGoNext: seamSelector.selectNext()
                         onConfigure: {
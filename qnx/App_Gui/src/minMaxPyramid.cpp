@@ -0,0 +1,163 @@
+#include "minMaxPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace precitec
+{
+namespace gui
+{
+
+MinMaxPyramid::MinMaxPyramid(std::vector<Sample> samples)
+    : m_samples(std::move(samples))
+    , m_sorted(std::is_sorted(m_samples.begin(), m_samples.end(), [] (const auto& a, const auto& b) { return a.first.x() < b.first.x(); }))
+{
+    if (m_samples.size() < 2)
+    {
+        return;
+    }
+
+    // level 1 combines pairs of samples, each further level pairs of buckets of the previous level
+    std::vector<Bucket> buckets;
+    buckets.reserve((m_samples.size() + 1) / 2);
+    for (std::size_t i = 0; i < m_samples.size(); i += 2)
+    {
+        const quint32 first = i;
+        const quint32 second = std::min(i + 1, m_samples.size() - 1);
+        const auto secondIsLower = m_samples[second].first.y() < m_samples[first].first.y();
+        const auto secondIsHigher = m_samples[second].first.y() > m_samples[first].first.y();
+        buckets.push_back({secondIsLower ? second : first, secondIsHigher ? second : first});
+    }
+    m_levels.push_back(std::move(buckets));
+
+    while (m_levels.back().size() > 1)
+    {
+        const auto& previous = m_levels.back();
+        std::vector<Bucket> next;
+        next.reserve((previous.size() + 1) / 2);
+        for (std::size_t i = 0; i < previous.size(); i += 2)
+        {
+            if (i + 1 == previous.size())
+            {
+                next.push_back(previous[i]);
+                continue;
+            }
+            const auto& a = previous[i];
+            const auto& b = previous[i + 1];
+            next.push_back({m_samples[b.min].first.y() < m_samples[a.min].first.y() ? b.min : a.min,
+                            m_samples[b.max].first.y() > m_samples[a.max].first.y() ? b.max : a.max});
+        }
+        m_levels.push_back(std::move(next));
+    }
+}
+
+std::size_t MinMaxPyramid::levelFor(qreal visibleSpan, int pixelWidth) const
+{
+    if (!m_sorted || m_levels.empty() || pixelWidth <= 0 || !(visibleSpan > 0.0))
+    {
+        return 0;
+    }
+    const qreal sampleDistance = (m_samples.back().first.x() - m_samples.front().first.x()) / qreal(m_samples.size() - 1);
+    if (!(sampleDistance > 0.0))
+    {
+        return 0;
+    }
+
+    const auto samplesPerPixel = visibleSpan / pixelWidth / sampleDistance;
+    if (!(samplesPerPixel >= 1.0))
+    {
+        return 0;
+    }
+    const auto level = std::min(std::size_t(std::floor(std::log2(samplesPerPixel))), m_levels.size());
+
+    // a bucket is served with up to four samples, thus the first two levels do not reduce the number of samples
+    return level < 3 ? 0 : level;
+}
+
+std::vector<MinMaxPyramid::Sample> MinMaxPyramid::level(std::size_t level) const
+{
+    if (level == 0 || m_levels.empty())
+    {
+        return m_samples;
+    }
+    level = std::min(level, m_levels.size());
+    return serve(level, 0, m_levels.at(level - 1).size() - 1);
+}
+
+std::vector<MinMaxPyramid::Sample> MinMaxPyramid::level(std::size_t level, qreal xMin, qreal xMax) const
+{
+    if (!m_sorted || m_samples.empty() || !(xMin <= xMax))
+    {
+        return this->level(level);
+    }
+    const auto byX = [] (const auto& sample, qreal x) { return sample.first.x() < x; };
+    const auto begin = std::lower_bound(m_samples.begin(), m_samples.end(), xMin, byX);
+    const auto end = std::lower_bound(begin, m_samples.end(), xMax, byX);
+
+    // one sample before and after the range
+    const std::size_t first = std::max(std::distance(m_samples.begin(), begin), std::ptrdiff_t(1)) - 1;
+    const std::size_t last = std::min(std::size_t(std::distance(m_samples.begin(), end)), m_samples.size() - 1);
+
+    if (level == 0 || m_levels.empty())
+    {
+        return {m_samples.begin() + first, m_samples.begin() + last + 1};
+    }
+    level = std::min(level, m_levels.size());
+    return serve(level, first >> level, last >> level);
+}
+
+std::pair<qreal, qreal> MinMaxPyramid::servedRange(qreal xMin, qreal xMax)
+{
+    const auto margin = (xMax - xMin) / 4.0;
+    return {xMin - margin, xMax + margin};
+}
+
+std::vector<MinMaxPyramid::Sample> MinMaxPyramid::serve(std::size_t level, std::size_t firstBucket, std::size_t lastBucket) const
+{
+    const auto& buckets = m_levels.at(level - 1);
+    const std::size_t bucketSize = std::size_t(1) << level;
+
+    std::vector<Sample> ret;
+    ret.reserve((lastBucket - firstBucket + 1) * 4);
+    for (std::size_t i = firstBucket; i <= lastBucket; i++)
+    {
+        const std::size_t first = i * bucketSize;
+        const std::size_t last = std::min(first + bucketSize, m_samples.size()) - 1;
+        std::size_t indices[4] = {first, buckets[i].min, buckets[i].max, last};
+        std::sort(std::begin(indices), std::end(indices));
+        const auto end = std::unique(std::begin(indices), std::end(indices));
+        for (auto it = std::begin(indices); it != end; it++)
+        {
+            ret.push_back(m_samples[*it]);
+        }
+    }
+    return ret;
+}
+
+std::optional<float> MinMaxPyramid::valueAtPosition(float position) const
+{
+    auto it = m_samples.begin();
+    if (m_sorted)
+    {
+        // qFuzzyCompare accepts a relative difference of 1e-5, start before the first sample which can match
+        const auto start = position - std::abs(position) * 1e-4f;
+        it = std::lower_bound(m_samples.begin(), m_samples.end(), start, [] (const auto& sample, float x) { return sample.first.x() < x; });
+    }
+
+    for (; it != m_samples.end(); it++)
+    {
+        const auto x = it->first.x();
+        if (qFuzzyCompare(x, position))
+        {
+            return it->first.y();
+        }
+        if (x > position)
+        {
+            break;
+        }
+    }
+    return {};
+}
+
+}
+}
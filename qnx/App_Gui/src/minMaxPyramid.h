@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QVector2D>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace precitec
+{
+namespace gui
+{
+
+/**
+ * @brief Level of detail pyramid of the samples of a signal for plotting
+ *
+ * Level 0 holds all samples. On level k the samples are combined into buckets of 2^k consecutive samples
+ * and for each bucket the sample with the minimum and the sample with the maximum value are stored.
+ * The pyramid is built once in linear time and can be built in a background thread.
+ *
+ * A level is served as the first, minimum, maximum and last sample of each bucket in their original order.
+ * If a bucket is not wider than a pixel, a line through these samples covers the same pixels as a line through
+ * all samples of the bucket, thus spikes are never lost, no matter how many samples are combined.
+ **/
+class MinMaxPyramid
+{
+public:
+    using Sample = std::pair<QVector2D, float>;
+
+    MinMaxPyramid() = default;
+    explicit MinMaxPyramid(std::vector<Sample> samples);
+
+    /**
+     * All samples
+     **/
+    const std::vector<Sample>& samples() const
+    {
+        return m_samples;
+    }
+
+    /**
+     * Number of levels including level 0
+     **/
+    std::size_t levelCount() const
+    {
+        return m_levels.size() + 1;
+    }
+
+    /**
+     * The coarsest level whose buckets are not wider than a pixel, if @p visibleSpan is shown in @p pixelWidth pixels.
+     * Levels which do not reduce the number of samples are skipped, 0 is returned if the viewport is unknown.
+     **/
+    std::size_t levelFor(qreal visibleSpan, int pixelWidth) const;
+
+    /**
+     * The first, minimum, maximum and last sample of each bucket of @p level, level 0 returns all samples.
+     **/
+    std::vector<Sample> level(std::size_t level) const;
+
+    /**
+     * Like level(std::size_t), but only the buckets overlapping the x range [@p xMin, @p xMax].
+     * The buckets next to the range are included, thus the line continues beyond the border of the range.
+     * Unsorted signals return all buckets.
+     **/
+    std::vector<Sample> level(std::size_t level, qreal xMin, qreal xMax) const;
+
+    /**
+     * The x range to serve for a plotter showing [@p xMin, @p xMax]: the visible range extended by a quarter of its span on both sides.
+     * Panning by less than that does not need new samples. Together with levelFor at most 12 samples per pixel are served.
+     **/
+    static std::pair<qreal, qreal> servedRange(qreal xMin, qreal xMax);
+
+    /**
+     * The value of the sample at @p position, compared with qFuzzyCompare
+     **/
+    std::optional<float> valueAtPosition(float position) const;
+
+private:
+    // the first, minimum, maximum and last sample of the buckets from @p firstBucket to @p lastBucket
+    std::vector<Sample> serve(std::size_t level, std::size_t firstBucket, std::size_t lastBucket) const;
+
+    struct Bucket
+    {
+        quint32 min;
+        quint32 max;
+    };
+
+    std::vector<Sample> m_samples;
+    // m_levels.at(k - 1) holds the buckets of level k
+    std::vector<std::vector<Bucket>> m_levels;
+    bool m_sorted = true;
+};
+
+}
+}
@@ -0,0 +1,296 @@
+#include "referenceCurveAccumulator.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+using precitec::storage::ReferenceCurve;
+
+namespace precitec
+{
+namespace gui
+{
+
+const std::size_t ReferenceCurveAccumulator::defaultMedianCapacity;
+
+ReferenceCurveAccumulator::ReferenceCurveAccumulator(ReferenceCurve::ReferenceType referenceType, std::size_t medianCapacity)
+    : m_referenceType(referenceType)
+    // a multiple of 4 ensures that each level is compacted with an even number of values
+    , m_medianCapacity(std::max(std::size_t(4), (medianCapacity + 3) / 4 * 4))
+{
+}
+
+void ReferenceCurveAccumulator::addInstance(const std::vector<QVector2D>& samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+    m_instanceCount++;
+
+    const auto offset = samples.front().x();
+    if (m_referenceType == ReferenceCurve::ReferenceType::MinMax)
+    {
+        // positions of the first instance which reaches a sample index
+        for (std::size_t i = m_x.size(); i < samples.size(); i++)
+        {
+            m_x.emplace_back(samples.at(i).x() - offset);
+        }
+    } else if (samples.size() > m_x.size())
+    {
+        // positions of the longest instance
+        m_x.clear();
+        std::transform(samples.begin(), samples.end(), std::back_inserter(m_x), [offset] (const auto& sample) { return sample.x() - offset; });
+    }
+
+    switch (m_referenceType)
+    {
+        case ReferenceCurve::ReferenceType::Average:
+        {
+            if (samples.size() > m_sum.size())
+            {
+                m_sum.resize(samples.size(), 0.0);
+                m_count.resize(samples.size(), 0);
+            }
+            for (std::size_t i = 0; i < samples.size(); i++)
+            {
+                m_sum[i] += samples[i].y();
+                m_count[i]++;
+            }
+            break;
+        }
+        case ReferenceCurve::ReferenceType::Median:
+        {
+            if (samples.size() > m_median.size())
+            {
+                m_median.resize(samples.size());
+            }
+            for (std::size_t i = 0; i < samples.size(); i++)
+            {
+                addToMedian(m_median[i], samples[i].y());
+            }
+            break;
+        }
+        case ReferenceCurve::ReferenceType::MinMax:
+        {
+            for (std::size_t i = 0; i < samples.size(); i++)
+            {
+                const auto y = samples[i].y();
+                if (i < m_min.size())
+                {
+                    m_min[i] = std::min(m_min[i], y);
+                    m_max[i] = std::max(m_max[i], y);
+                } else
+                {
+                    m_min.emplace_back(y);
+                    m_max.emplace_back(y);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void ReferenceCurveAccumulator::addToMedian(MedianBin& bin, float value)
+{
+    if (bin.levels.empty())
+    {
+        bin.levels.emplace_back();
+        bin.oddOffset.emplace_back(false);
+    }
+
+    // a full level is only compacted when the next value arrives, thus the median is exact up to the capacity
+    for (std::size_t h = 0; bin.levels.at(h).size() >= m_medianCapacity; h++)
+    {
+        if (h + 1 == bin.levels.size())
+        {
+            bin.levels.emplace_back();
+            bin.oddOffset.emplace_back(false);
+        }
+        auto& level = bin.levels.at(h);
+        auto& next = bin.levels.at(h + 1);
+
+        std::sort(level.begin(), level.end());
+        // alternate between the odd and even values to avoid a bias
+        for (std::size_t i = bin.oddOffset.at(h) ? 1 : 0; i < level.size(); i += 2)
+        {
+            next.emplace_back(level.at(i));
+        }
+        bin.oddOffset.at(h) = !bin.oddOffset.at(h);
+        level.clear();
+    }
+
+    bin.levels.front().emplace_back(value);
+    bin.count++;
+}
+
+float ReferenceCurveAccumulator::median(const MedianBin& bin) const
+{
+    const std::size_t middle = 0.5 * bin.count;
+
+    if (bin.levels.size() == 1)
+    {
+        auto values = bin.levels.front();
+        std::nth_element(values.begin(), values.begin() + middle, values.end());
+        return values.at(middle);
+    }
+
+    std::vector<std::pair<float, std::size_t>> weightedValues;
+    for (std::size_t h = 0; h < bin.levels.size(); h++)
+    {
+        for (const auto value : bin.levels.at(h))
+        {
+            weightedValues.emplace_back(value, std::size_t(1) << h);
+        }
+    }
+    std::sort(weightedValues.begin(), weightedValues.end());
+
+    std::size_t rank = 0;
+    for (const auto& weightedValue : weightedValues)
+    {
+        rank += weightedValue.second;
+        if (rank > middle)
+        {
+            return weightedValue.first;
+        }
+    }
+    return weightedValues.back().first;
+}
+
+std::vector<QVector2D> ReferenceCurveAccumulator::middle() const
+{
+    std::vector<QVector2D> curve;
+    curve.reserve(m_x.size());
+
+    switch (m_referenceType)
+    {
+        case ReferenceCurve::ReferenceType::Average:
+        {
+            for (std::size_t i = 0; i < m_x.size(); i++)
+            {
+                curve.emplace_back(m_x.at(i), m_sum.at(i) / static_cast<float>(m_count.at(i)));
+            }
+            break;
+        }
+        case ReferenceCurve::ReferenceType::Median:
+        {
+            for (std::size_t i = 0; i < m_x.size(); i++)
+            {
+                curve.emplace_back(m_x.at(i), median(m_median.at(i)));
+            }
+            break;
+        }
+        case ReferenceCurve::ReferenceType::MinMax:
+        {
+            for (std::size_t i = 0; i < m_x.size(); i++)
+            {
+                const QVector2D minElement{m_x.at(i), m_min.at(i)};
+                const QVector2D maxElement{m_x.at(i), m_max.at(i)};
+                curve.emplace_back(minElement + 0.5f * (maxElement - minElement));
+            }
+            break;
+        }
+    }
+
+    return curve;
+}
+
+std::vector<QVector2D> ReferenceCurveAccumulator::lower() const
+{
+    std::vector<QVector2D> curve;
+    curve.reserve(m_min.size());
+    for (std::size_t i = 0; i < m_min.size(); i++)
+    {
+        curve.emplace_back(m_x.at(i), m_min.at(i));
+    }
+    return curve;
+}
+
+std::vector<QVector2D> ReferenceCurveAccumulator::upper() const
+{
+    std::vector<QVector2D> curve;
+    curve.reserve(m_max.size());
+    for (std::size_t i = 0; i < m_max.size(); i++)
+    {
+        curve.emplace_back(m_x.at(i), m_max.at(i));
+    }
+    return curve;
+}
+
+void ReferenceCurveAccumulator::jitterBounds(const std::vector<QVector2D>& curve, float lastPosition, float jitter, std::vector<QVector2D>& lower, std::vector<QVector2D>& upper)
+{
+    lower.clear();
+    upper.clear();
+
+    if (curve.empty())
+    {
+        return;
+    }
+
+    lower.reserve(curve.size());
+    upper.reserve(curve.size());
+
+    const auto firstPosition = curve.front().x();
+
+    if (!std::is_sorted(curve.begin(), curve.end(), [] (const auto& a, const auto& b) { return a.x() < b.x(); }))
+    {
+        for (const auto& sample : curve)
+        {
+            auto jitterIntervalMin = std::max(firstPosition, sample.x() - jitter);
+            auto jitterIntervalMax = std::min(lastPosition, jitterIntervalMin + 2 * jitter);
+            auto minValue = std::numeric_limits<float>::max();
+            auto maxValue = std::numeric_limits<float>::lowest();
+            for (const auto& s : curve)
+            {
+                if (s.x() >= jitterIntervalMin && s.x() <= jitterIntervalMax)
+                {
+                    minValue = std::min(minValue, s.y());
+                    maxValue = std::max(maxValue, s.y());
+                }
+            }
+            lower.emplace_back(sample.x(), minValue);
+            upper.emplace_back(sample.x(), maxValue);
+        }
+        return;
+    }
+
+    // both ends of the interval move forward, the indices of the candidates for the minimum and maximum are kept in monotonic queues
+    std::deque<std::size_t> minCandidates;
+    std::deque<std::size_t> maxCandidates;
+    std::size_t next = 0;
+
+    for (const auto& sample : curve)
+    {
+        auto jitterIntervalMin = std::max(firstPosition, sample.x() - jitter);
+        auto jitterIntervalMax = std::min(lastPosition, jitterIntervalMin + 2 * jitter);
+
+        for (; next < curve.size() && curve[next].x() <= jitterIntervalMax; next++)
+        {
+            const auto y = curve[next].y();
+            while (!minCandidates.empty() && !(curve[minCandidates.back()].y() < y))
+            {
+                minCandidates.pop_back();
+            }
+            minCandidates.push_back(next);
+            while (!maxCandidates.empty() && !(curve[maxCandidates.back()].y() > y))
+            {
+                maxCandidates.pop_back();
+            }
+            maxCandidates.push_back(next);
+        }
+        while (!minCandidates.empty() && curve[minCandidates.front()].x() < jitterIntervalMin)
+        {
+            minCandidates.pop_front();
+        }
+        while (!maxCandidates.empty() && curve[maxCandidates.front()].x() < jitterIntervalMin)
+        {
+            maxCandidates.pop_front();
+        }
+
+        lower.emplace_back(sample.x(), minCandidates.empty() ? std::numeric_limits<float>::max() : curve[minCandidates.front()].y());
+        upper.emplace_back(sample.x(), maxCandidates.empty() ? std::numeric_limits<float>::lowest() : curve[maxCandidates.front()].y());
+    }
+}
+
+}
+}
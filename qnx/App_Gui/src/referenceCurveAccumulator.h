@@ -0,0 +1,109 @@
+#pragma once
+
+#include "referenceCurve.h"
+
+#include <QVector2D>
+
+#include <vector>
+
+namespace precitec
+{
+namespace gui
+{
+
+/**
+ * @brief Accumulates the samples of the result instances of a @link{ReferenceCurve} one instance at a time
+ *
+ * Each instance is added with @link{addInstance} and can be freed afterwards. The accumulator only keeps
+ * one bin per sample index:
+ * @li @link{ReferenceType::Average}: the exact running sum and count
+ * @li @link{ReferenceType::MinMax}: the exact running minimum and maximum
+ * @li @link{ReferenceType::Median}: the values of the bin, compacted once more than @link{medianCapacity} instances are added
+ *
+ * The median is exact as long as at most @link{medianCapacity} instances are added. Beyond that the values of a bin
+ * are kept in a compacting quantile sketch of at most medianCapacity values per level: whenever a level is full it is sorted
+ * and every other value is moved to the next level with twice the weight. With N instances and capacity k the sketch
+ * needs about k * log2(N / k) values per bin and the rank of the returned median differs from the exact median
+ * by at most N * ceil(log2(N / k)) / k.
+ **/
+class ReferenceCurveAccumulator
+{
+public:
+    static const std::size_t defaultMedianCapacity = 1024;
+
+    explicit ReferenceCurveAccumulator(precitec::storage::ReferenceCurve::ReferenceType referenceType, std::size_t medianCapacity = defaultMedianCapacity);
+
+    /**
+     * Adds the samples of one instance, the positions are relative to the first sample.
+     * Empty instances are ignored.
+     **/
+    void addInstance(const std::vector<QVector2D>& samples);
+
+    std::size_t instanceCount() const
+    {
+        return m_instanceCount;
+    }
+
+    /**
+     * The number of samples of the longest instance
+     **/
+    std::size_t sampleCount() const
+    {
+        return m_x.size();
+    }
+
+    std::size_t medianCapacity() const
+    {
+        return m_medianCapacity;
+    }
+
+    /**
+     * The average, median or the middle between minimum and maximum, depending on the ReferenceType
+     **/
+    std::vector<QVector2D> middle() const;
+
+    /**
+     * The minimum of each bin, only available for @link{ReferenceType::MinMax}
+     **/
+    std::vector<QVector2D> lower() const;
+
+    /**
+     * The maximum of each bin, only available for @link{ReferenceType::MinMax}
+     **/
+    std::vector<QVector2D> upper() const;
+
+    /**
+     * Computes the lower and upper boundary of @p curve in one pass.
+     * Each boundary sample is the minimum resp. maximum of @p curve within [x - jitter, x + jitter],
+     * the interval is shifted to start at the first position and cut at @p lastPosition.
+     * The cost is linear if the positions of @p curve are sorted.
+     **/
+    static void jitterBounds(const std::vector<QVector2D>& curve, float lastPosition, float jitter, std::vector<QVector2D>& lower, std::vector<QVector2D>& upper);
+
+private:
+    struct MedianBin
+    {
+        // levels.at(h) holds values of weight 2^h, a level is compacted when it reaches the capacity
+        std::vector<std::vector<float>> levels;
+        std::vector<bool> oddOffset;
+        std::size_t count = 0;
+    };
+
+    void addToMedian(MedianBin& bin, float value);
+    float median(const MedianBin& bin) const;
+
+    precitec::storage::ReferenceCurve::ReferenceType m_referenceType;
+    std::size_t m_medianCapacity;
+    std::size_t m_instanceCount = 0;
+
+    std::vector<float> m_x;
+
+    std::vector<double> m_sum;
+    std::vector<std::size_t> m_count;
+    std::vector<float> m_min;
+    std::vector<float> m_max;
+    std::vector<MedianBin> m_median;
+};
+
+}
+}
@@ -1,4 +1,5 @@
 #include "referenceCurveConstructor.h"
+#include "referenceCurveAccumulator.h"
 #include "product.h"
 #include "seamSeries.h"
 #include "seam.h"
@@ -9,8 +10,6 @@
 #include <QtConcurrentRun>
 #include <QDir>
 
-#include <numeric>
-
 using precitec::storage::Product;
 using precitec::storage::ReferenceCurve;
 using precitec::gui::components::plotter::DataSet;
@@ -254,78 +253,36 @@ void ReferenceCurveConstructor::computeCurves()
         return;
     }
 
-    if (m_referenceType == ReferenceCurve::ReferenceType::MinMax)
-    {
-        auto minMaxWatcher = new QFutureWatcher<void>{this};
-
-        connect(minMaxWatcher, &QFutureWatcher<void>::finished, this,
-        [this, minMaxWatcher]
-            {
-                minMaxWatcher->deleteLater();
-
-                m_lowerUpdating = false;
-                m_middleUpdating = false;
-                m_upperUpdating = false;
-
-                refreshUpdating();
-            }
-        );
-
-        minMaxWatcher->setFuture(QtConcurrent::run(this, &ReferenceCurveConstructor::minMaxCurve, results));
-    } else
-    {
-        auto lowerWatcher = new QFutureWatcher<void>{this};
-        auto upperWatcher = new QFutureWatcher<void>{this};
-        auto middleWatcher = new QFutureWatcher<void>{this};
+    auto watcher = new QFutureWatcher<void>{this};
 
-        connect(middleWatcher, &QFutureWatcher<void>::finished, this,
-        [this, middleWatcher, upperWatcher, lowerWatcher]
-            {
-                middleWatcher->deleteLater();
-
-                m_middleUpdating = false;
-
-                lowerWatcher->setFuture(QtConcurrent::run(this, &ReferenceCurveConstructor::lowerBound));
-                upperWatcher->setFuture(QtConcurrent::run(this, &ReferenceCurveConstructor::upperBound));
-            }
-        );
-
-        connect(upperWatcher, &QFutureWatcher<void>::finished, this,
-        [this, upperWatcher]
-            {
-                upperWatcher->deleteLater();
-
-                m_upperUpdating = false;
-
-                refreshUpdating();
-            }
-        );
-
-        connect(lowerWatcher, &QFutureWatcher<void>::finished, this,
-        [this, lowerWatcher]
-            {
-                lowerWatcher->deleteLater();
+    connect(watcher, &QFutureWatcher<void>::finished, this,
+    [this, watcher]
+        {
+            watcher->deleteLater();
 
-                m_lowerUpdating = false;
+            m_lowerUpdating = false;
+            m_middleUpdating = false;
+            m_upperUpdating = false;
 
-                refreshUpdating();
-            }
-        );
+            refreshUpdating();
+        }
+    );
 
-        middleWatcher->setFuture(QtConcurrent::run(this, &ReferenceCurveConstructor::middleCurve, results, m_referenceType));
-    }
+    watcher->setFuture(QtConcurrent::run(this, &ReferenceCurveConstructor::constructCurves, results, m_referenceType, m_jitter));
 }
 
-void ReferenceCurveConstructor::middleCurve(std::vector<Instance> instances, ReferenceCurve::ReferenceType referenceType)
+void ReferenceCurveConstructor::constructCurves(std::vector<Instance> instances, ReferenceCurve::ReferenceType referenceType, float jitter)
 {
+    m_lower->clear();
     m_middle->clear();
+    m_upper->clear();
 
     const auto resultType = this->resultType();
     const auto triggerType = this->triggerType();
     const auto threshold = this->threshold();
 
-    std::vector<float> x;
-    std::vector<std::vector<float>> y_values;
+    // all curves are computed in one pass, each instance is freed as soon as it is accumulated
+    ReferenceCurveAccumulator accumulator{referenceType};
 
     auto counter = 1;
     for (const auto& info : instances)
@@ -349,115 +306,22 @@ void ReferenceCurveConstructor::middleCurve(std::vector<Instance> instances, Ref
             continue;
         }
 
-        if (samples.size() > x.size())
-        {
-            // acquire x values from the longest result
-            x.clear();
-            const auto& offset = samples.front().x();
-            std::transform(samples.begin(), samples.end(), std::back_inserter(x), [offset] (const auto& sample) { return sample.x() - offset; });
-        }
-
-        y_values.reserve(samples.size());
-
-        for (std::size_t i = 0; i < samples.size(); i++)
-        {
-            if (i >= y_values.size())
-            {
-                y_values.emplace_back(std::vector<float>{samples.at(i).y()});
-            } else
-            {
-                y_values.at(i).emplace_back(samples.at(i).y());
-            }
-        }
+        accumulator.addInstance(samples);
 
         emit progressChanged(counter / static_cast<float> (instances.size()));
         counter++;
     }
 
-    std::vector<QVector2D> middleCurve;
-    middleCurve.reserve(x.size());
-
-    switch (referenceType)
-    {
-        case ReferenceCurve::ReferenceType::Average:
-        {
-            computeAverage(x, y_values, middleCurve);
-            break;
-        }
-        case ReferenceCurve::ReferenceType::Median:
-        {
-            computeMedian(x, y_values, middleCurve);
-            break;
-        }
-        default:
-            Q_UNREACHABLE();
-    }
-
-    m_middle->addSamples(middleCurve);
-
-    x.clear();
-    y_values.clear();
-    middleCurve.clear();
-}
-
-void ReferenceCurveConstructor::computeAverage(const std::vector<float>& x_values, std::vector<std::vector<float>>& y_values, std::vector<QVector2D>& output)
-{
-    for (std::size_t i = 0; i < x_values.size(); i++)
-    {
-        auto& y = y_values.at(i);
-        output.emplace_back(x_values.at(i), std::accumulate(y.begin(), y.end(), 0.0) / static_cast<float>(y.size()));
-        y.clear();
-    }
-}
-
-void ReferenceCurveConstructor::computeMedian(const std::vector<float>& x_values, std::vector<std::vector<float>>& y_values, std::vector<QVector2D>& output)
-{
-    for (std::size_t i = 0; i < x_values.size(); i++)
-    {
-        auto& y = y_values.at(i);
-
-        std::sort(y.begin(), y.end());
-        std::size_t middle = 0.5 * y.size();
-
-        output.emplace_back(x_values.at(i), y.at(middle));
-        y.clear();
-    }
-}
-
-void ReferenceCurveConstructor::upperBound()
-{
-    const auto& curve = m_middle->samples();
+    m_middle->addSamples(accumulator.middle());
 
-    if (curve.empty())
+    if (referenceType == ReferenceCurve::ReferenceType::MinMax)
     {
+        m_lower->addSamples(accumulator.lower());
+        m_upper->addSamples(accumulator.upper());
         return;
     }
 
-    std::vector<QVector2D> upperBound;
-    upperBound.reserve(m_middle->sampleCount());
-
-    const auto firstPosition = curve.front().x();
-    const auto lastPosition = m_middle->lastSamplePosition();
-
-    for (const auto& sample : curve)
-    {
-        auto jitterIntervalMin = std::max(firstPosition, sample.x() - m_jitter);
-        auto jitterIntervalMax = std::min(lastPosition, jitterIntervalMin + 2 * m_jitter);
-        auto value = std::numeric_limits<float>::lowest();
-        std::for_each(curve.begin(), curve.end(), [jitterIntervalMin, jitterIntervalMax, &value] (const auto& s) {
-            if (s.x() >= jitterIntervalMin && s.x() <= jitterIntervalMax)
-            {
-                value = std::max(value, s.y());
-            }
-        });
-        upperBound.emplace_back(sample.x(), value);
-    }
-
-    m_upper->addSamples(upperBound);
-}
-
-void ReferenceCurveConstructor::lowerBound()
-{
+    // the boundaries are computed from the curve as stored in the data set
     const auto& curve = m_middle->samples();
 
     if (curve.empty())
@@ -466,125 +330,10 @@ void ReferenceCurveConstructor::lowerBound()
     }
 
     std::vector<QVector2D> lowerBound;
-    lowerBound.reserve(m_middle->sampleCount());
-
-    const auto firstPosition = curve.front().x();
-    const auto lastPosition = m_middle->lastSamplePosition();
-
-    for (const auto& sample : curve)
-    {
-        auto jitterIntervalMin = std::max(firstPosition, sample.x() - m_jitter);
-        auto jitterIntervalMax = std::min(lastPosition, jitterIntervalMin + 2 * m_jitter);
-        auto value = std::numeric_limits<float>::max();
-        std::for_each(curve.begin(), curve.end(), [jitterIntervalMin, jitterIntervalMax, &value] (const auto& s) {
-            if (s.x() >= jitterIntervalMin && s.x() <= jitterIntervalMax)
-            {
-                value = std::min(value, s.y());
-            }
-        });
-        lowerBound.emplace_back(sample.x(), value);
-    }
-
-    m_lower->addSamples(lowerBound);
-}
-
-void ReferenceCurveConstructor::minMaxCurve(std::vector<Instance> instances)
-{
-    m_lower->clear();
-    m_middle->clear();
-    m_upper->clear();
-
-    std::vector<QVector2D> lowerBound;
-    std::vector<QVector2D> middleCurve;
     std::vector<QVector2D> upperBound;
-
-    const auto resultType = this->resultType();
-    const auto triggerType = this->triggerType();
-    const auto threshold = this->threshold();
-
-    auto counter = 1;
-    for (const auto& info : instances)
-    {
-        const auto directory = QDir{QStringLiteral("%1/seam_series%2/seam%3/").arg(info.path)
-            .arg(seam()->seamSeries()->number(), 4, 10, QLatin1Char('0'))
-            .arg(info.seamNumber, 4, 10, QLatin1Char('0'))};
-
-        std::vector<QVector2D> samples;
-
-        if (triggerType == -1)
-        {
-            samples = loadResult(directory, resultType);
-        } else
-        {
-            samples = loadResultRange(directory, resultType, triggerType, threshold);
-        }
-
-        if (samples.empty())
-        {
-            continue;
-        }
-
-        const auto& offset = samples.front().x();
-        std::for_each(samples.begin(), samples.end(), [offset] (auto& sample) { sample.setX(sample.x() - offset); });
-
-        if (lowerBound.empty())
-        {
-            lowerBound = samples;
-        } else
-        {
-            lowerBound.reserve(samples.size());
-
-            for (std::size_t i = 0;  i < samples.size(); i++)
-            {
-                const auto& sample = samples.at(i);
-
-                if (i < lowerBound.size())
-                {
-                    auto& current = lowerBound.at(i);
-                    current.setY(std::min(current.y(), sample.y()));
-                } else
-                {
-                    lowerBound.emplace_back(sample);
-                }
-            }
-        }
-
-        if (upperBound.empty())
-        {
-            upperBound = samples;
-        } else
-        {
-            upperBound.reserve(samples.size());
-
-            for (std::size_t i = 0;  i < samples.size(); i++)
-            {
-                const auto& sample = samples.at(i);
-
-                if (i < upperBound.size())
-                {
-                    auto& current = upperBound.at(i);
-                    current.setY(std::max(current.y(), sample.y()));
-                } else
-                {
-                    upperBound.emplace_back(sample);
-                }
-            }
-        }
-
-        emit progressChanged(counter / static_cast<float> (instances.size()));
-        counter++;
-    }
-
-    middleCurve.reserve(lowerBound.size());
-    for (std::size_t i = 0;  i < lowerBound.size(); i++)
-    {
-        const auto& minElement = lowerBound.at(i);
-        const auto& maxElement = upperBound.at(i);
-        middleCurve.emplace_back(minElement + 0.5f * (maxElement - minElement));
-    }
+    ReferenceCurveAccumulator::jitterBounds({curve.begin(), curve.end()}, m_middle->lastSamplePosition(), jitter, lowerBound, upperBound);
 
     m_lower->addSamples(lowerBound);
-    m_middle->addSamples(middleCurve);
     m_upper->addSamples(upperBound);
 }
 
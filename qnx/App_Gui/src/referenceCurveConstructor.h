@@ -164,13 +164,8 @@ private:
         quint32 seamNumber = -1;
     };
 
-    // construction functions to be executed in a separate thread
-    void middleCurve(std::vector<Instance> instances, precitec::storage::ReferenceCurve::ReferenceType referenceType);
-    void computeAverage(const std::vector<float>& x_values, std::vector<std::vector<float>>& y_values, std::vector<QVector2D>& output);
-    void computeMedian(const std::vector<float>& x_values, std::vector<std::vector<float>>& y_values, std::vector<QVector2D>& output);
-    void upperBound();
-    void lowerBound();
-    void minMaxCurve(std::vector<Instance> instances);
+    // construction function to be executed in a separate thread
+    void constructCurves(std::vector<Instance> instances, precitec::storage::ReferenceCurve::ReferenceType referenceType, float jitter);
 
     bool m_updating = false;
     bool m_updatePending = false;
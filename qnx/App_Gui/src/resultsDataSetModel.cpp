@@ -8,8 +8,14 @@
 #include "resultSettingModel.h"
 #include <precitec/multicolorSet.h>
 
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QtConcurrentRun>
 #include <QVector2D>
 
+#include <tuple>
+
+using precitec::interface::ResultArgs;
 using precitec::storage::ResultSetting;
 using precitec::storage::ResultsLoader;
 using precitec::gui::components::plotter::MulticolorSet;
@@ -19,12 +25,32 @@ namespace precitec
 namespace gui
 {
 
+struct ResultsDataSetModel::LoadedResults
+{
+    struct Result
+    {
+        std::vector<ResultArgs> resultData;
+        QPointer<ResultSetting> config;
+        bool skipNullValues = false;
+
+        // filled in the background thread, resultData is freed afterwards except for the first result
+        std::list<QVector2D> upperReferenceSamples;
+        std::list<QVector2D> lowerReferenceSamples;
+        std::shared_ptr<const MinMaxPyramid> pyramid;
+    };
+    std::vector<Result> results;
+    std::vector<std::pair<qint32, qreal>> imagePositions;
+};
+
 ResultsDataSetModel::ResultsDataSetModel(QObject *parent)
     : AbstractSingleSeamDataModel(parent)
 {
 }
 
-ResultsDataSetModel::~ResultsDataSetModel() = default;
+ResultsDataSetModel::~ResultsDataSetModel()
+{
+    m_loading.waitForFinished();
+}
 
 void ResultsDataSetModel::setResultsLoader(ResultsLoader *loader)
 {
@@ -63,14 +89,15 @@ void ResultsDataSetModel::update()
 
     clear();
 
-    const auto results{m_resultsLoader->takeResults()};
+    auto results{m_resultsLoader->takeResults()};
 
     if (currentProduct())
     {
         setSeam(currentProduct()->findSeam(m_resultsLoader->seamSeries(), m_resultsLoader->seam()));
     }
 
-    for (const auto &resultData : results)
+    auto loadedResults = std::make_shared<LoadedResults>();
+    for (auto& resultData : results)
     {
         if (resultData.empty())
         {
@@ -88,18 +115,67 @@ void ResultsDataSetModel::update()
             resultConfig = errorConfigModel() ? errorConfigModel()->getItem(resultType) : nullptr;
         }
 
-        std::list<std::pair<QVector2D, float>> signalSamples;
-        std::list<QVector2D> upperReferenceSamples;
-        std::list<QVector2D> lowerReferenceSamples;
-        bool skipNullValues = (resultConfig && resultConfig->visualization() == storage::ResultSetting::Visualization::Binary);
+        LoadedResults::Result loaded;
+        loaded.resultData = std::move(resultData);
+        loaded.config = resultConfig;
+        loaded.skipNullValues = (resultConfig && resultConfig->visualization() == storage::ResultSetting::Visualization::Binary);
+        loadedResults->results.push_back(std::move(loaded));
+    }
 
-        for (const auto& result : resultData)
+    // the samples and their level of detail pyramid are computed in a background thread
+    auto watcher = new QFutureWatcher<void>{this};
+    connect(watcher, &QFutureWatcher<void>::finished, this,
+        [this, watcher, loadedResults, updateCounter = m_updateCounter]
         {
-            insertImagePosition(std::make_pair(result.context().imageNumber(), result.context().position() / 1000.0));
-            collectResults(signalSamples, upperReferenceSamples, lowerReferenceSamples, result, skipNullValues);
+            watcher->deleteLater();
+            if (updateCounter != m_updateCounter)
+            {
+                // cleared or updated in the meantime
+                return;
+            }
+            addLoadedResults(*loadedResults);
         }
+    );
+
+    m_loading = QtConcurrent::run(
+        [this, loadedResults]
+        {
+            for (auto& loaded : loadedResults->results)
+            {
+                std::list<std::pair<QVector2D, float>> signalSamples;
+                for (const auto& result : loaded.resultData)
+                {
+                    loadedResults->imagePositions.emplace_back(result.context().imageNumber(), result.context().position() / 1000.0);
+                    collectResults(signalSamples, loaded.upperReferenceSamples, loaded.lowerReferenceSamples, result, loaded.skipNullValues);
+                }
+                loaded.resultData.erase(loaded.resultData.begin() + 1, loaded.resultData.end());
+                loaded.pyramid = std::make_shared<MinMaxPyramid>(std::vector<MinMaxPyramid::Sample>{signalSamples.begin(), signalSamples.end()});
+            }
+        });
+    watcher->setFuture(m_loading);
+}
+
+void ResultsDataSetModel::addLoadedResults(const LoadedResults& loadedResults)
+{
+    for (const auto& imagePosition : loadedResults.imagePositions)
+    {
+        insertImagePosition(imagePosition);
+    }
+
+    for (const auto& loaded : loadedResults.results)
+    {
+        const auto& result = loaded.resultData.front();
+
+        // the nio percentage is a list of blocks and evaluated per sample, it is never decimated
+        ServedSignal served;
+        served.pyramid = loaded.pyramid;
+        served.decimate = result.nioPercentage().empty();
 
-        addResults(resultIndex(resultType), resultData.front(), resultConfig, signalSamples, upperReferenceSamples, lowerReferenceSamples);
+        const auto samples = serve(served);
+        const std::list<std::pair<QVector2D, float>> signalSamples{samples.begin(), samples.end()};
+        addResults(resultIndex(result.resultType()), result, loaded.config.data(), signalSamples, loaded.upperReferenceSamples, loaded.lowerReferenceSamples);
+
+        m_servedSignals[result.resultType()] = served;
     }
 
     setCurrentIndex(0);
@@ -108,6 +184,84 @@ void ResultsDataSetModel::update()
     emit lastPositionChanged();
 }
 
+void ResultsDataSetModel::clear()
+{
+    m_updateCounter++;
+    m_servedSignals.clear();
+
+    AbstractSingleSeamDataModel::clear();
+}
+
+std::size_t ResultsDataSetModel::levelFor(const ServedSignal& served) const
+{
+    return served.decimate ? served.pyramid->levelFor(m_visibleMax - m_visibleMin, m_pixelWidth) : 0;
+}
+
+bool ResultsDataSetModel::viewportKnown() const
+{
+    return m_pixelWidth > 0 && m_visibleMax > m_visibleMin;
+}
+
+bool ResultsDataSetModel::needsServing(const ServedSignal& served) const
+{
+    if (levelFor(served) != served.level)
+    {
+        return true;
+    }
+    if (!served.decimate || !viewportKnown())
+    {
+        return false;
+    }
+    // the visible range left the served range or the served range is far too wide after zooming in
+    const auto [xMin, xMax] = MinMaxPyramid::servedRange(m_visibleMin, m_visibleMax);
+    return m_visibleMin < served.xMin || m_visibleMax > served.xMax || (served.xMax - served.xMin) > 2.0 * (xMax - xMin);
+}
+
+std::vector<MinMaxPyramid::Sample> ResultsDataSetModel::serve(ServedSignal& served) const
+{
+    served.level = levelFor(served);
+    if (!served.decimate || !viewportKnown())
+    {
+        served.xMin = std::numeric_limits<qreal>::lowest();
+        served.xMax = std::numeric_limits<qreal>::max();
+        return served.pyramid->level(served.level);
+    }
+    std::tie(served.xMin, served.xMax) = MinMaxPyramid::servedRange(m_visibleMin, m_visibleMax);
+    return served.pyramid->level(served.level, served.xMin, served.xMax);
+}
+
+void ResultsDataSetModel::setViewport(qreal xMin, qreal xMax, int pixelWidth)
+{
+    m_visibleMin = xMin;
+    m_visibleMax = xMax;
+    m_pixelWidth = pixelWidth;
+
+    for (auto& [resultType, served] : m_servedSignals)
+    {
+        if (!needsServing(served))
+        {
+            continue;
+        }
+        const auto row = resultIndex(resultType);
+        if (row == -1)
+        {
+            continue;
+        }
+        const auto& data = resultAt(row).m_data;
+        if (data.empty() || !data.front().m_signal)
+        {
+            continue;
+        }
+
+        auto signal = data.front().m_signal;
+        signal->clear();
+        signal->addSamples(serve(served));
+
+        const auto& idx = index(row);
+        emit dataChanged(idx, idx, {Qt::UserRole, Qt::UserRole + 1, Qt::UserRole + 2});
+    }
+}
+
 QVariant ResultsDataSetModel::valueAtPosition(const QModelIndex& index, float position)
 {
     const auto dataValue = index.data(Qt::UserRole + 2);
@@ -117,6 +271,18 @@ QVariant ResultsDataSetModel::valueAtPosition(const QModelIndex& index, float po
         return {};
     }
 
+    // the plotted samples might be decimated, the value is looked up in all samples
+    const auto it = m_servedSignals.find(resultAt(index.row()).m_resultType);
+    if (it != m_servedSignals.end())
+    {
+        if (const auto value = it->second.pyramid->valueAtPosition(position))
+        {
+            return value.value();
+        }
+        // value not found
+        return {};
+    }
+
     auto *dataSet = dataValue.value<MulticolorSet*>();
     const auto &samples = dataSet->samples();
     for (const auto &sample : samples)
@@ -1,6 +1,13 @@
 #pragma once
 
 #include "abstractSingleSeamDataModel.h"
+#include "minMaxPyramid.h"
+
+#include <QFuture>
+
+#include <limits>
+#include <map>
+#include <memory>
 
 namespace precitec
 {
@@ -33,14 +40,50 @@ public:
 
     Q_INVOKABLE QVariant valueAtPosition(const QModelIndex& index, float position);
 
+    /**
+     * Selects the level of detail of the signals for a plotter showing the x range [@p xMin, @p xMax] in @p pixelWidth pixels.
+     * Only the samples of the visible range and a margin around it are served, see MinMaxPyramid::servedRange.
+     * Panning within the margin does not change the samples.
+     **/
+    Q_INVOKABLE void setViewport(qreal xMin, qreal xMax, int pixelWidth);
+
+    void clear() override;
+
 Q_SIGNALS:
     void resultsLoaderChanged();
 
 private:
     void update();
 
+    struct LoadedResults;
+    void addLoadedResults(const LoadedResults& loadedResults);
+
+    struct ServedSignal
+    {
+        std::shared_ptr<const MinMaxPyramid> pyramid;
+        std::size_t level = 0;
+        bool decimate = true;
+        // the x range of the served samples
+        qreal xMin = std::numeric_limits<qreal>::lowest();
+        qreal xMax = std::numeric_limits<qreal>::max();
+    };
+    std::size_t levelFor(const ServedSignal& served) const;
+    bool viewportKnown() const;
+    bool needsServing(const ServedSignal& served) const;
+    std::vector<MinMaxPyramid::Sample> serve(ServedSignal& served) const;
+
     precitec::storage::ResultsLoader* m_resultsLoader = nullptr;
     QMetaObject::Connection m_resultsLoaderDestroyedConnection;
+
+    // results are converted in a background thread, a new update or clear discards older ones
+    QFuture<void> m_loading;
+    quint64 m_updateCounter = 0;
+
+    // key is the result type
+    std::map<int, ServedSignal> m_servedSignals;
+    qreal m_visibleMin = 0.0;
+    qreal m_visibleMax = 0.0;
+    int m_pixelWidth = 0;
 };
 
 }
@@ -696,20 +696,33 @@ void FigureAnalyzerTest::testUpdateFocusSpeed()
     FigureAnalyzer analyzer;
     SimulationController simulationController;
 
-    simulationController.m_focusSpeed = std::vector<double> {100.0, 200.0, 300.0, 400.0, 500.0};
     analyzer.setSimulationController(&simulationController);
     analyzer.updateFocusSpeed();
+    QCOMPARE(analyzer.minFocusSpeed(), 0.0);
+    QCOMPARE(analyzer.maxFocusSpeed(), 0.0);
+    QCOMPARE(analyzer.averageFocusSpeed(), 0.0);
 
-    QCOMPARE(analyzer.minFocusSpeed(), 100.0);
-    QCOMPARE(analyzer.maxFocusSpeed(), 500.0);
-    QCOMPARE(analyzer.averageFocusSpeed(), 300.0);
+    // movement in 10us, 0.001 mm are 100 mm/s
+    for (const auto& movement : {0.001f, 0.002f, 0.003f, 0.004f, 0.005f})
+    {
+        simulationController.m_simulationStatistics.add(QVector2D{movement, 0.0f}, 0.0);
+    }
+    analyzer.updateFocusSpeed();
 
-    simulationController.m_focusSpeed = std::vector<double> {500.0, 750.0, 250.0, 500.0};
+    QCOMPARE(qRound(analyzer.minFocusSpeed()), 100);
+    QCOMPARE(qRound(analyzer.maxFocusSpeed()), 500);
+    QCOMPARE(qRound(analyzer.averageFocusSpeed()), 300);
+
+    simulationController.m_simulationStatistics = {};
+    for (const auto& movement : {0.005f, 0.0075f, 0.0025f, 0.005f})
+    {
+        simulationController.m_simulationStatistics.add(QVector2D{0.0f, movement}, 0.0);
+    }
     analyzer.updateFocusSpeed();
 
-    QCOMPARE(analyzer.minFocusSpeed(), 250.0);
-    QCOMPARE(analyzer.maxFocusSpeed(), 750.0);
-    QCOMPARE(analyzer.averageFocusSpeed(), 500.0);
+    QCOMPARE(qRound(analyzer.minFocusSpeed()), 250);
+    QCOMPARE(qRound(analyzer.maxFocusSpeed()), 750);
+    QCOMPARE(qRound(analyzer.averageFocusSpeed()), 500);
 }
 
 QTEST_GUILESS_MAIN(FigureAnalyzerTest)
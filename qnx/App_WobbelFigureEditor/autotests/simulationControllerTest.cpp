@@ -1,6 +1,9 @@
 #include <QTest>
 #include <QSignalSpy>
 
+#include <algorithm>
+#include <numeric>
+
 #include "../src/simulationController.h"
 #include "../src/FileModel.h"
 #include "../src/laserPointController.h"
@@ -10,6 +13,7 @@
 #include "../src/editorDataTypes.h"
 
 using precitec::scanmaster::components::wobbleFigureEditor::SimulationController;
+using precitec::scanmaster::components::wobbleFigureEditor::SimulationResult;
 using precitec::scantracker::components::wobbleFigureEditor::FileModel;
 using precitec::scanmaster::components::wobbleFigureEditor::LaserPointController;
 using precitec::scantracker::components::wobbleFigureEditor::WobbleFigure;
@@ -110,23 +114,17 @@ private Q_SLOTS:
     void testCheckOneFigureMissing();
     void testClearSimulationFigure();
     void testFirstValidSpeed();
-    void testCreateSeamVelocities_data();
-    void testCreateSeamVelocities();
-    void testCreateWobbleVelocities_data();
-    void testCreateWobbleVelocities();
     void testCalculateVisualizationInformation_data();
     void testCalculateVisualizationInformation();
     void testCheckTooManyPoints_data();
     void testCheckTooManyPoints();
     void testCheckSimulatedFigureReady_data();
     void testCheckSimulatedFigureReady();
-    void testCalcFocusSpeed();
     void testCalculateSimulationFigure_data();
     void testCalculateSimulationFigure();
-    void testAngleRadFromXAxis_data();
-    void testAngleRadFromXAxis();
-    void testRotateVectorRad_data();
-    void testRotateVectorRad();
+    void testCalculateLongSeam();
+    void testRestartDiscardsPendingSimulation();
+    void testDestructorWaitsForSimulation();
 
 private:
     QTemporaryDir m_dir;
@@ -609,146 +607,6 @@ void SimulationControllerTest::testFirstValidSpeed()
     QCOMPARE(simulationController.firstValidSpeed(), 1000.0);
 }
 
-void SimulationControllerTest::testCreateSeamVelocities_data()
-{
-    QTest::addColumn<QVector<QVector2D>>("position");
-    QTest::addColumn<QVector<double>>("velocity");
-    QTest::addColumn<int>("countSeam10usParts");
-
-    QTest::newRow("LineX") << QVector<QVector2D> {
-        QVector2D{0.0f, 0.0f},
-        QVector2D{0.25f, 0.0f},
-        QVector2D{0.5f, 0.0f},
-        QVector2D{0.75f, 0.0f},
-        QVector2D{1.0f, 0.0f}
-    } << QVector<double> {
-        -1.0,
-        -1.0,
-        -1.0,
-        -1.0,
-        -1.0
-    } << 100;
-}
-
-void SimulationControllerTest::testCreateSeamVelocities()
-{
-    SimulationController simulationController;
-    FigureEditorSettings::instance()->setScannerSpeed(1000.0);
-
-    QFETCH(QVector<QVector2D>, position);
-    QFETCH(QVector<double>, velocity);
-    QCOMPARE(position.size(), velocity.size());
-
-    SeamFigure seam;
-    RTC6::seamFigure::command::Order newSeamPoint;
-    for (int i = 0; i < position.size(); i++)
-    {
-        const auto &point = position.at(i);
-        newSeamPoint.endPosition = std::make_pair(point.x(), point.y());
-        newSeamPoint.velocity = velocity.at(i);
-        seam.figure.push_back(newSeamPoint);
-    }
-
-    simulationController.m_seamFigure = seam;
-    const auto &seamPartsIn10usParts = simulationController.createSeamVelocities();
-    QFETCH(int, countSeam10usParts);
-    QCOMPARE(seamPartsIn10usParts.size(), countSeam10usParts);
-
-    auto startPoint = position.front();
-    int counter = 0;
-    int deltaCompareValue = countSeam10usParts / (position.size() - 1);
-    int compareValue = 0;
-
-    for (const auto& seamPart : seamPartsIn10usParts)
-    {
-        if (counter == compareValue)
-        {
-            QCOMPARE(testFunction::limitPrecisionToSixDigits(startPoint), position.at(counter / deltaCompareValue));
-            compareValue += deltaCompareValue;
-        }
-        startPoint += seamPart;
-        counter++;
-    }
-}
-
-
-void SimulationControllerTest::testCreateWobbleVelocities_data()
-{
-    QTest::addColumn<QVector<QVector2D>>("position");
-    QTest::addColumn<int>("microVectorFactor");
-    QTest::addColumn<QVector<double>>("power");
-
-    QTest::newRow("LineX") << QVector<QVector2D> {
-        QVector2D{0.0, 0.0},
-        QVector2D{0.15, 0.0},
-        QVector2D{0.0, 0.0},
-        QVector2D{-0.15, 0.0},
-        QVector2D{0.0, 0.0}
-    } << 10 << QVector<double> {
-        0.1,
-        0.3,
-        0.1,
-        0.1,
-        0.1
-    };
-    QTest::newRow("LineY") << QVector<QVector2D> {
-        QVector2D{0.0, 0.0},
-        QVector2D{0.0, 0.15},
-        QVector2D{0.0, 0.0},
-        QVector2D{0.0, -0.15},
-        QVector2D{0.0, 0.0}
-    } << 5 << QVector<double> {
-        0.5,
-        0.3,
-        0.4,
-        0.5,
-        0.5
-    };
-}
-
-void SimulationControllerTest::testCreateWobbleVelocities()
-{
-    SimulationController simulationController;
-
-    QFETCH(QVector<QVector2D>, position);
-    QFETCH(int, microVectorFactor);
-    QFETCH(QVector<double>, power);
-
-    Figure wobble;
-    wobble.microVectorFactor = microVectorFactor;
-    RTC6::wobbleFigure::command::Order newWobblePoint;
-    for (int i = 0; i < position.size(); i++)
-    {
-        const auto &point = position.at(i);
-        newWobblePoint.endPosition = std::make_pair(point.x(), point.y());
-        newWobblePoint.power = power.at(i);
-        wobble.figure.push_back(newWobblePoint);
-    }
-
-    simulationController.m_wobbleFigure = wobble;
-    const auto &wobbleParts = simulationController.createWobbleVelocities();
-    QCOMPARE(wobbleParts.size(), (wobble.figure.size() - 1) * wobble.microVectorFactor);
-
-    auto startPoint = position.front();
-    int counter = 0;
-    int deltaCompareValue = wobble.microVectorFactor;
-    int compareValue = deltaCompareValue;
-    auto startPower = power.front();
-
-    for (const auto& wobblePart : wobbleParts)
-    {
-        if (counter == compareValue)
-        {
-            QCOMPARE(startPoint, position.at(counter / deltaCompareValue));
-            compareValue += deltaCompareValue;
-            QCOMPARE(testFunction::limitPowerPrecisionToSixDigits(startPower), power.at(counter / deltaCompareValue));
-        }
-        startPoint += wobblePart.toVector2D();
-        startPower += wobblePart.z();
-        counter++;
-    }
-}
-
 void SimulationControllerTest::testCalculateVisualizationInformation_data()
 {
     QTest::addColumn<QVector<QVector2D>>("position");
@@ -837,16 +695,12 @@ void SimulationControllerTest::testCheckTooManyPoints()
     }
 
     simulationController.m_simulatedSeamFigure = seam;
-    simulationController.setTenMicroSecondsFactor(10);
-    QVERIFY(!simulationController.checkTooManyPoints());
-
-    simulationController.setTenMicroSecondsFactor(1);
     QVERIFY(!simulationController.checkTooManyPoints());
 
     simulationController.m_pointCountVisualizationLimit = 10;
     QVERIFY(simulationController.checkTooManyPoints());
 
-    simulationController.setTenMicroSecondsFactor(20);
+    simulationController.m_pointCountVisualizationLimit = 20;
     QVERIFY(!simulationController.checkTooManyPoints());
 }
 
@@ -911,15 +765,6 @@ void SimulationControllerTest::testCheckSimulatedFigureReady()
     QVERIFY(simulationController.ready());
 }
 
-void SimulationControllerTest::testCalcFocusSpeed()
-{
-    SimulationController simulationController;
-
-    QVector2D movement{-0.02, 0.05};
-
-    QCOMPARE(testFunction::limitPrecisionToTwoDigits(simulationController.calculateFocusSpeed(movement)), 5385.16);
-}
-
 void SimulationControllerTest::testCalculateSimulationFigure_data()
 {
     QTest::addColumn<QVector<QVector2D>>("seamPosition");
@@ -1070,7 +915,14 @@ void SimulationControllerTest::testCalculateSimulationFigure()
         simulationController.m_wobbleFigure.figure.push_back(element);
     }
 
+    // one period of the wobble figure is longer than the seam, so every 10us step is a point of the simulated figure
+    simulationController.m_loopCount = 1;
+
+    QSignalSpy simulationFigureCalculated{&simulationController, &SimulationController::simulationFigureCalculated};
+    QVERIFY(simulationFigureCalculated.isValid());
     simulationController.calculateSimulationFigure();
+    QVERIFY(simulationController.m_simulatedSeamFigure.figure.empty());
+    QVERIFY(simulationFigureCalculated.wait());
 
     QCOMPARE(simulationController.m_simulatedSeamFigure.figure.size() - 1, simulationPosition.size());
 
@@ -1082,70 +934,83 @@ void SimulationControllerTest::testCalculateSimulationFigure()
         QCOMPARE(testFunction::limitPrecisionToSixDigits(calculatedSimulationPoint.endPosition.second), testFunction::limitPrecisionToSixDigits(simulationPoint.y()));
     }
 
-    QCOMPARE(simulationController.m_focusSpeed.size(), simulationPosition.size());
+    const auto& statistics = simulationController.simulationStatistics();
+    QCOMPARE(statistics.stepCount(), std::size_t(focusSpeed.size()));
+    QCOMPARE(testFunction::limitPrecisionToOneDigit(statistics.minFocusSpeed()), *std::min_element(focusSpeed.begin(), focusSpeed.end()));
+    QCOMPARE(testFunction::limitPrecisionToOneDigit(statistics.maxFocusSpeed()), *std::max_element(focusSpeed.begin(), focusSpeed.end()));
+    QCOMPARE(qRound(statistics.averageFocusSpeed()), qRound(std::accumulate(focusSpeed.begin(), focusSpeed.end(), 0.0) / focusSpeed.size()));
 
-    for (std::size_t i = 0; i < simulationController.m_focusSpeed.size(); i++)
-    {
-        QCOMPARE(testFunction::limitPrecisionToOneDigit(simulationController.m_focusSpeed.at(i)), focusSpeed.at(i));
-    }
-}
+    // the whole figure is decimated, but starts and ends at the same points
+    simulationController.m_loopCount = 0;
+    simulationController.calculateSimulationFigure();
+    QVERIFY(simulationFigureCalculated.wait());
 
-void SimulationControllerTest::testAngleRadFromXAxis_data()
-{
-    QTest::addColumn<QVector2D>("point1");
-    QTest::addColumn<QVector2D>("point2");
-    QTest::addColumn<double>("angle");
-
-    QTest::newRow("0°") << QVector2D{1.0, 1.0} << QVector2D{2.0, 1.0} << 0.0;
-    QTest::newRow("45°") << QVector2D{1.0, 1.0} << QVector2D{2.0, 2.0} << 0.79;
-    QTest::newRow("90°") << QVector2D{0.0, 0.0} << QVector2D{0.0, 2.0} << 1.57;
-    QTest::newRow("135°") << QVector2D{-1.0, 1.0} << QVector2D{-2.0, 2.0} << 2.36;
-    QTest::newRow("180°") << QVector2D{1.0, 0.0} << QVector2D{-2.0, 0.0} << 3.14;
-    QTest::newRow("225°") << QVector2D{-1.0, -1.0} << QVector2D{-2.0, -2.0} << 3.93;
-    QTest::newRow("270°") << QVector2D{-1.0, -1.0} << QVector2D{-1.0, -2.0} << 4.71;
-    QTest::newRow("315°") << QVector2D{1.0, -1.0} << QVector2D{2.0, -2.0} << 5.5;
-    QTest::newRow("360°") << QVector2D{1.0, -1.0} << QVector2D{2.0, -1.0} << 0.0;
+    const auto& wholeFigure = simulationController.m_simulatedSeamFigure.figure;
+    QVERIFY(wholeFigure.size() <= simulationPosition.size() + 1);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(wholeFigure.front().endPosition.first), testFunction::limitPrecisionToSixDigits(simulationPosition.front().x()));
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(wholeFigure.front().endPosition.second), testFunction::limitPrecisionToSixDigits(simulationPosition.front().y()));
+    QCOMPARE(simulationController.simulationStatistics().stepCount(), std::size_t(focusSpeed.size()));
 }
 
-void SimulationControllerTest::testAngleRadFromXAxis()
+void SimulationControllerTest::testCalculateLongSeam()
 {
     SimulationController simulationController;
+    simulationController.m_seamFigure = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{50.0, 0.0}, QVector2D{50.0, 50.0}}, 10.0);
+    simulationController.m_wobbleFigure = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.5, 0.5}, QVector2D{0.0, 0.0}, QVector2D{-0.5, -0.5}, QVector2D{0.0, 0.0}}, 100);
 
-    QFETCH(QVector2D, point1);
-    QFETCH(QVector2D, point2);
+    QSignalSpy simulationFigureCalculated{&simulationController, &SimulationController::simulationFigureCalculated};
+    QVERIFY(simulationFigureCalculated.isValid());
+    simulationController.startSimulationFigure();
+    QVERIFY(simulationFigureCalculated.wait(30000));
 
-    const auto& vector = point2 - point1;
-    QTEST(testFunction::limitPrecisionToTwoDigits(simulationController.angleRadFromXAxis(vector)), "angle");
-}
+    // 100 mm with 10 mm/s are 1 million steps, the preview is decimated below the limit instead of being rejected
+    QCOMPARE(simulationController.simulationStatistics().stepCount(), std::size_t(1000000));
+    QVERIFY(simulationController.m_simulatedSeamFigure.figure.size() < simulationController.m_pointCountVisualizationLimit);
+    QVERIFY(!simulationController.checkTooManyPoints());
+    QVERIFY(simulationController.ready());
 
-void SimulationControllerTest::testRotateVectorRad_data()
-{
-    QTest::addColumn<QVector2D>("vector");
-    QTest::addColumn<double>("angle");
-    QTest::addColumn<QVector2D>("rotatedVector");
-
-    QTest::newRow("0°") << QVector2D{1.0, 1.0} << 0.0 << QVector2D{1.0, 1.0};
-    QTest::newRow("45°") << QVector2D{1.0, 1.0} << 0.79 << QVector2D{-0.006508, 1.414199};
-    QTest::newRow("90°") << QVector2D{1.0, 1.0} << 1.57 << QVector2D{-0.999203, 1.000796};
-    QTest::newRow("135°") << QVector2D{1.0, 1.0} << 2.36 << QVector2D{-1.414203, -0.005382};
-    QTest::newRow("180°") << QVector2D{1.0, 1.0} << 3.14 << QVector2D{-1.001591, -0.998406};
-    QTest::newRow("225°") << QVector2D{1.0, 1.0} << 3.93 << QVector2D{0.004256, -1.414207};
-    QTest::newRow("270°") << QVector2D{1.0, 1.0} << 4.71 << QVector2D{0.997608, -1.002386};
-    QTest::newRow("315°") << QVector2D{1.0, 1.0} << 5.5 << QVector2D{1.41421, 0.003129};
-    QTest::newRow("360°") << QVector2D{1.0, 1.0} << 6.28 << QVector2D{1.00318, 0.99681};
+    const auto& end = simulationController.m_simulatedSeamFigure.figure.back().endPosition;
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(end.first), 50.0);
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(end.second), 50.0);
 }
 
-void SimulationControllerTest::testRotateVectorRad()
+void SimulationControllerTest::testRestartDiscardsPendingSimulation()
 {
     SimulationController simulationController;
+    simulationController.m_seamFigure = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{100.0, 0.0}}, 1.0);
+    simulationController.m_wobbleFigure = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.5, 0.0}, QVector2D{0.0, 0.0}}, 100);
+
+    QSignalSpy simulationFigureCalculated{&simulationController, &SimulationController::simulationFigureCalculated};
+    QVERIFY(simulationFigureCalculated.isValid());
+    simulationController.calculateSimulationFigure();
+
+    simulationController.m_seamFigure = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{1.0, 0.0}}, 100.0);
+    simulationController.calculateSimulationFigure();
+    QVERIFY(simulationFigureCalculated.wait());
+
+    // only the result of the last simulation is taken
+    QCOMPARE(simulationFigureCalculated.count(), 1);
+    QCOMPARE(simulationController.simulationStatistics().stepCount(), std::size_t(1000));
+    QVERIFY(!simulationFigureCalculated.wait(500));
+}
 
-    QFETCH(QVector2D, vector);
-    QFETCH(double, angle);
+void SimulationControllerTest::testDestructorWaitsForSimulation()
+{
+    QFuture<SimulationResult> simulation;
+    std::shared_ptr<std::atomic<bool>> simulationCanceled;
+    {
+        SimulationController simulationController;
+        simulationController.m_seamFigure = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{10000.0, 0.0}}, 1.0);
+        simulationController.m_wobbleFigure = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.5, 0.0}, QVector2D{0.0, 0.0}}, 100);
+        simulationController.calculateSimulationFigure();
+        simulation = simulationController.m_simulation;
+        simulationCanceled = simulationController.m_simulationCanceled;
+        QVERIFY(simulationCanceled);
+    }
 
-    auto manipulatedVector = simulationController.rotateVectorRad(vector, angle);
-    QFETCH(QVector2D, rotatedVector);
-    QCOMPARE(testFunction::limitPrecisionToSixDigits(manipulatedVector.x()), testFunction::limitPrecisionToSixDigits(rotatedVector.x()));
-    QCOMPARE(testFunction::limitPrecisionToSixDigits(manipulatedVector.y()), testFunction::limitPrecisionToSixDigits(rotatedVector.y()));
+    // the running simulation was canceled and has finished before the controller was gone
+    QVERIFY(simulationCanceled->load());
+    QVERIFY(simulation.isFinished());
 }
 
 QTEST_GUILESS_MAIN(SimulationControllerTest)
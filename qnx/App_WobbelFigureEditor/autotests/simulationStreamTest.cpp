@@ -0,0 +1,528 @@
+#include <QTest>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+#include "../src/simulationStream.h"
+
+#include "../src/editorDataTypes.h"
+
+using precitec::scanmaster::components::wobbleFigureEditor::SimulationStatistics;
+using precitec::scanmaster::components::wobbleFigureEditor::SimulationStream;
+using precitec::scanmaster::components::wobbleFigureEditor::PolylineDecimator;
+using precitec::scanmaster::components::wobbleFigureEditor::SimulationSettings;
+using precitec::scanmaster::components::wobbleFigureEditor::simulate;
+
+using RTC6::seamFigure::SeamFigure;
+using RTC6::wobbleFigure::Figure;
+
+namespace testFunction
+{
+QVector2D limitPrecisionToSixDigits(QVector2D value)
+{
+    QVector2D copy = value * 1000000;
+    copy.setX(qRound(copy.x()));
+    copy.setY(qRound(copy.y()));
+    return copy / 1000000;
+}
+
+double limitPrecisionToSixDigits(double value)
+{
+    auto copy = value * 1000000;
+    int copyInt = qRound(copy);
+    return static_cast<double> (copyInt) / 1000000.0;
+}
+
+double limitPowerPrecisionToSixDigits(double value)
+{
+    auto copy = value * 10;
+    int copyInt = qRound(copy) * 100000;
+    return static_cast<double> (copyInt) / 1000000.0;
+}
+
+double limitPrecisionToTwoDigits(double value)
+{
+    auto valueCopy = value * 100;
+    int copyInt = qRound(valueCopy);
+    return static_cast<double> (copyInt) / 100.0;
+}
+
+SeamFigure getSeamFigureFromVectors(const QVector<QVector2D>& position, double seamSpeed)
+{
+    SeamFigure seam;
+
+    for (const auto& element : position)
+    {
+        RTC6::seamFigure::command::Order newOrder;
+        newOrder.endPosition = std::make_pair(element.x(), element.y());
+        newOrder.velocity = seamSpeed;
+        seam.figure.push_back(newOrder);
+    }
+
+    return seam;
+}
+
+Figure getWobbleFigureFromVectors(const QVector<QVector2D>& position, unsigned int microVectorFactor)
+{
+    Figure wobble;
+    wobble.microVectorFactor = microVectorFactor;
+
+    for (const auto& element : position)
+    {
+        RTC6::wobbleFigure::command::Order newOrder;
+        newOrder.endPosition = std::make_pair(element.x(), element.y());
+        newOrder.power = 0.5;
+        newOrder.ringPower = 0.5;
+        wobble.figure.push_back(newOrder);
+    }
+
+    return wobble;
+}
+
+RTC6::seamFigure::command::Order point(double x, double y)
+{
+    RTC6::seamFigure::command::Order order;
+    order.endPosition = std::make_pair(x, y);
+    order.power = 0.0;
+    order.ringPower = 0.0;
+    order.velocity = 0.0;
+    return order;
+}
+
+double distanceToSegment(const std::pair<double, double>& point, const std::pair<double, double>& start, const std::pair<double, double>& end)
+{
+    const auto dx = end.first - start.first;
+    const auto dy = end.second - start.second;
+    const auto lengthSquared = dx * dx + dy * dy;
+    auto t = lengthSquared == 0.0 ? 0.0 : ((point.first - start.first) * dx + (point.second - start.second) * dy) / lengthSquared;
+    t = std::clamp(t, 0.0, 1.0);
+    return std::hypot(point.first - (start.first + t * dx), point.second - (start.second + t * dy));
+}
+}
+
+class SimulationStreamTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCreateSeamParts_data();
+    void testCreateSeamParts();
+    void testCreateWobbleVelocities_data();
+    void testCreateWobbleVelocities();
+    void testAngleRadFromXAxis_data();
+    void testAngleRadFromXAxis();
+    void testRotateVectorRad_data();
+    void testRotateVectorRad();
+    void testFocusSpeed();
+    void testStatistics();
+    void testStream();
+    void testDecimateStraightLine();
+    void testDecimateKeepsCorners();
+    void testDecimateMaxPointCount();
+    void testSimulateWholeFigure();
+    void testSimulateLoopCount();
+    void testSimulateCanceled();
+};
+
+void SimulationStreamTest::testCreateSeamParts_data()
+{
+    QTest::addColumn<QVector<QVector2D>>("position");
+    QTest::addColumn<QVector<double>>("velocity");
+    QTest::addColumn<int>("countSeam10usParts");
+
+    QTest::newRow("LineX") << QVector<QVector2D> {
+        QVector2D{0.0f, 0.0f},
+        QVector2D{0.25f, 0.0f},
+        QVector2D{0.5f, 0.0f},
+        QVector2D{0.75f, 0.0f},
+        QVector2D{1.0f, 0.0f}
+    } << QVector<double> {
+        -1.0,
+        -1.0,
+        -1.0,
+        -1.0,
+        -1.0
+    } << 100;
+}
+
+void SimulationStreamTest::testCreateSeamParts()
+{
+    QFETCH(QVector<QVector2D>, position);
+    QFETCH(QVector<double>, velocity);
+    QCOMPARE(position.size(), velocity.size());
+
+    SeamFigure seam;
+    RTC6::seamFigure::command::Order newSeamPoint;
+    for (int i = 0; i < position.size(); i++)
+    {
+        const auto &point = position.at(i);
+        newSeamPoint.endPosition = std::make_pair(point.x(), point.y());
+        newSeamPoint.velocity = velocity.at(i);
+        seam.figure.push_back(newSeamPoint);
+    }
+
+    const auto& seamParts = SimulationStream::createSeamParts(seam, 1000.0);
+    QCOMPARE(seamParts.size(), std::size_t(position.size() - 1));
+
+    QFETCH(int, countSeam10usParts);
+    auto startPoint = position.front();
+    int stepCount = 0;
+    for (std::size_t i = 0; i < seamParts.size(); i++)
+    {
+        const auto& seamPart = seamParts.at(i);
+        startPoint += seamPart.velocity * seamPart.stepCount;
+        stepCount += seamPart.stepCount;
+        QCOMPARE(testFunction::limitPrecisionToSixDigits(startPoint), position.at(i + 1));
+    }
+    QCOMPARE(stepCount, countSeam10usParts);
+}
+
+void SimulationStreamTest::testCreateWobbleVelocities_data()
+{
+    QTest::addColumn<QVector<QVector2D>>("position");
+    QTest::addColumn<int>("microVectorFactor");
+    QTest::addColumn<QVector<double>>("power");
+
+    QTest::newRow("LineX") << QVector<QVector2D> {
+        QVector2D{0.0, 0.0},
+        QVector2D{0.15, 0.0},
+        QVector2D{0.0, 0.0},
+        QVector2D{-0.15, 0.0},
+        QVector2D{0.0, 0.0}
+    } << 10 << QVector<double> {
+        0.1,
+        0.3,
+        0.1,
+        0.1,
+        0.1
+    };
+    QTest::newRow("LineY") << QVector<QVector2D> {
+        QVector2D{0.0, 0.0},
+        QVector2D{0.0, 0.15},
+        QVector2D{0.0, 0.0},
+        QVector2D{0.0, -0.15},
+        QVector2D{0.0, 0.0}
+    } << 5 << QVector<double> {
+        0.5,
+        0.3,
+        0.4,
+        0.5,
+        0.5
+    };
+}
+
+void SimulationStreamTest::testCreateWobbleVelocities()
+{
+    QFETCH(QVector<QVector2D>, position);
+    QFETCH(int, microVectorFactor);
+    QFETCH(QVector<double>, power);
+
+    Figure wobble;
+    wobble.microVectorFactor = microVectorFactor;
+    RTC6::wobbleFigure::command::Order newWobblePoint;
+    for (int i = 0; i < position.size(); i++)
+    {
+        const auto &point = position.at(i);
+        newWobblePoint.endPosition = std::make_pair(point.x(), point.y());
+        newWobblePoint.power = power.at(i);
+        wobble.figure.push_back(newWobblePoint);
+    }
+
+    const auto &wobbleParts = SimulationStream::createWobbleVelocities(wobble);
+    QCOMPARE(wobbleParts.size(), (wobble.figure.size() - 1) * wobble.microVectorFactor);
+
+    auto startPoint = position.front();
+    int counter = 0;
+    int deltaCompareValue = wobble.microVectorFactor;
+    int compareValue = deltaCompareValue;
+    auto startPower = power.front();
+
+    for (const auto& wobblePart : wobbleParts)
+    {
+        if (counter == compareValue)
+        {
+            QCOMPARE(startPoint, position.at(counter / deltaCompareValue));
+            compareValue += deltaCompareValue;
+            QCOMPARE(testFunction::limitPowerPrecisionToSixDigits(startPower), power.at(counter / deltaCompareValue));
+        }
+        startPoint += wobblePart.toVector2D();
+        startPower += wobblePart.z();
+        counter++;
+    }
+
+    wobble.figure.resize(1);
+    QVERIFY(SimulationStream::createWobbleVelocities(wobble).empty());
+}
+
+void SimulationStreamTest::testAngleRadFromXAxis_data()
+{
+    QTest::addColumn<QVector2D>("point1");
+    QTest::addColumn<QVector2D>("point2");
+    QTest::addColumn<double>("angle");
+
+    QTest::newRow("0°") << QVector2D{1.0, 1.0} << QVector2D{2.0, 1.0} << 0.0;
+    QTest::newRow("45°") << QVector2D{1.0, 1.0} << QVector2D{2.0, 2.0} << 0.79;
+    QTest::newRow("90°") << QVector2D{0.0, 0.0} << QVector2D{0.0, 2.0} << 1.57;
+    QTest::newRow("135°") << QVector2D{-1.0, 1.0} << QVector2D{-2.0, 2.0} << 2.36;
+    QTest::newRow("180°") << QVector2D{1.0, 0.0} << QVector2D{-2.0, 0.0} << 3.14;
+    QTest::newRow("225°") << QVector2D{-1.0, -1.0} << QVector2D{-2.0, -2.0} << 3.93;
+    QTest::newRow("270°") << QVector2D{-1.0, -1.0} << QVector2D{-1.0, -2.0} << 4.71;
+    QTest::newRow("315°") << QVector2D{1.0, -1.0} << QVector2D{2.0, -2.0} << 5.5;
+    QTest::newRow("360°") << QVector2D{1.0, -1.0} << QVector2D{2.0, -1.0} << 0.0;
+}
+
+void SimulationStreamTest::testAngleRadFromXAxis()
+{
+    QFETCH(QVector2D, point1);
+    QFETCH(QVector2D, point2);
+
+    const auto& vector = point2 - point1;
+    QTEST(testFunction::limitPrecisionToTwoDigits(SimulationStream::angleRadFromXAxis(vector)), "angle");
+}
+
+void SimulationStreamTest::testRotateVectorRad_data()
+{
+    QTest::addColumn<QVector2D>("vector");
+    QTest::addColumn<double>("angle");
+    QTest::addColumn<QVector2D>("rotatedVector");
+
+    QTest::newRow("0°") << QVector2D{1.0, 1.0} << 0.0 << QVector2D{1.0, 1.0};
+    QTest::newRow("45°") << QVector2D{1.0, 1.0} << 0.79 << QVector2D{-0.006508, 1.414199};
+    QTest::newRow("90°") << QVector2D{1.0, 1.0} << 1.57 << QVector2D{-0.999203, 1.000796};
+    QTest::newRow("135°") << QVector2D{1.0, 1.0} << 2.36 << QVector2D{-1.414203, -0.005382};
+    QTest::newRow("180°") << QVector2D{1.0, 1.0} << 3.14 << QVector2D{-1.001591, -0.998406};
+    QTest::newRow("225°") << QVector2D{1.0, 1.0} << 3.93 << QVector2D{0.004256, -1.414207};
+    QTest::newRow("270°") << QVector2D{1.0, 1.0} << 4.71 << QVector2D{0.997608, -1.002386};
+    QTest::newRow("315°") << QVector2D{1.0, 1.0} << 5.5 << QVector2D{1.41421, 0.003129};
+    QTest::newRow("360°") << QVector2D{1.0, 1.0} << 6.28 << QVector2D{1.00318, 0.99681};
+}
+
+void SimulationStreamTest::testRotateVectorRad()
+{
+    QFETCH(QVector2D, vector);
+    QFETCH(double, angle);
+
+    auto manipulatedVector = SimulationStream::rotateVectorRad(vector, angle);
+    QFETCH(QVector2D, rotatedVector);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(manipulatedVector.x()), testFunction::limitPrecisionToSixDigits(rotatedVector.x()));
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(manipulatedVector.y()), testFunction::limitPrecisionToSixDigits(rotatedVector.y()));
+}
+
+void SimulationStreamTest::testFocusSpeed()
+{
+    QVector2D movement{-0.02, 0.05};
+
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(SimulationStatistics::focusSpeed(movement)), 5385.16);
+}
+
+void SimulationStreamTest::testStatistics()
+{
+    SimulationStatistics statistics;
+    QCOMPARE(statistics.stepCount(), std::size_t(0));
+    QCOMPARE(statistics.minFocusSpeed(), 0.0);
+    QCOMPARE(statistics.maxFocusSpeed(), 0.0);
+    QCOMPARE(statistics.averageFocusSpeed(), 0.0);
+    QCOMPARE(statistics.minPower(), 0.0);
+    QCOMPARE(statistics.maxPower(), 0.0);
+    QCOMPARE(statistics.pathLength(), 0.0);
+
+    statistics.add(QVector2D{0.003f, 0.004f}, 0.5);
+    statistics.add(QVector2D{0.0f, -0.001f}, 0.25);
+    statistics.add(QVector2D{-0.003f, 0.0f}, 0.75);
+
+    QCOMPARE(statistics.stepCount(), std::size_t(3));
+    QCOMPARE(qRound(statistics.minFocusSpeed()), 100);
+    QCOMPARE(qRound(statistics.maxFocusSpeed()), 500);
+    QCOMPARE(qRound(statistics.averageFocusSpeed()), 300);
+    QCOMPARE(statistics.minPower(), 0.25);
+    QCOMPARE(statistics.maxPower(), 0.75);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(statistics.pathLength()), 0.009);
+}
+
+void SimulationStreamTest::testStream()
+{
+    // 1 mm with 100 mm/s are 1000 steps, a period of the wobble figure 4 * 25 steps
+    const auto seam = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{1.0, 0.0}}, 100.0);
+    const auto wobble = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.0, 0.1}, QVector2D{0.0, 0.0}, QVector2D{0.0, -0.1}, QVector2D{0.0, 0.0}}, 25);
+
+    SimulationStream stream{seam, wobble, 1.0};
+    QCOMPARE(stream.stepCount(), std::size_t(1000));
+    QCOMPARE(stream.step(), std::size_t(0));
+    QVERIFY(!stream.atEnd());
+    QCOMPARE(stream.current().endPosition.first, 0.0);
+    QCOMPARE(stream.current().endPosition.second, 0.0);
+    QCOMPARE(stream.current().power, 0.5);
+
+    SimulationStatistics statistics;
+    double maxY = 0.0;
+    while (!stream.atEnd())
+    {
+        const auto before = stream.current().endPosition;
+        const auto movement = stream.next();
+        QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.first - before.first), testFunction::limitPrecisionToSixDigits(movement.x()));
+        QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.second - before.second), testFunction::limitPrecisionToSixDigits(movement.y()));
+        statistics.add(movement, stream.current().power);
+        maxY = std::max(maxY, stream.current().endPosition.second);
+
+        if (stream.step() == 25)
+        {
+            QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.first), 0.025);
+            QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.second), 0.1);
+        }
+    }
+
+    QCOMPARE(stream.step(), std::size_t(1000));
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.first), 1.0);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(stream.current().endPosition.second), 0.0);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(maxY), 0.1);
+
+    // 0.001 mm along the seam and 0.004 mm across in each step
+    QCOMPARE(statistics.stepCount(), std::size_t(1000));
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(statistics.minFocusSpeed()), 412.31);
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(statistics.maxFocusSpeed()), 412.31);
+}
+
+void SimulationStreamTest::testDecimateStraightLine()
+{
+    PolylineDecimator decimator{100};
+    for (int i = 0; i <= 10000; i++)
+    {
+        decimator.add(testFunction::point(i * 0.001, i * 0.0005));
+    }
+
+    const auto points = decimator.takePoints();
+    QCOMPARE(points.size(), std::size_t(2));
+    QCOMPARE(points.front().endPosition.first, 0.0);
+    QCOMPARE(points.front().endPosition.second, 0.0);
+    QCOMPARE(points.back().endPosition.first, 10.0);
+    QCOMPARE(points.back().endPosition.second, 5.0);
+}
+
+void SimulationStreamTest::testDecimateKeepsCorners()
+{
+    PolylineDecimator decimator{100};
+    const std::vector<std::pair<double, double>> corners{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}, {0.0, 0.0}};
+    decimator.add(testFunction::point(0.0, 0.0));
+    for (std::size_t i = 1; i < corners.size(); i++)
+    {
+        const auto& start = corners.at(i - 1);
+        const auto& end = corners.at(i);
+        for (int j = 1; j <= 100; j++)
+        {
+            decimator.add(testFunction::point(start.first + (end.first - start.first) * j / 100.0, start.second + (end.second - start.second) * j / 100.0));
+        }
+    }
+
+    const auto points = decimator.takePoints();
+    QCOMPARE(points.size(), corners.size());
+    for (std::size_t i = 0; i < corners.size(); i++)
+    {
+        QCOMPARE(testFunction::limitPrecisionToSixDigits(points.at(i).endPosition.first), corners.at(i).first);
+        QCOMPARE(testFunction::limitPrecisionToSixDigits(points.at(i).endPosition.second), corners.at(i).second);
+    }
+
+    // back and forth on a line, the turning points are kept
+    PolylineDecimator zigZag{100};
+    for (int i = 0; i <= 400; i++)
+    {
+        const auto inPeriod = i % 200;
+        zigZag.add(testFunction::point((inPeriod <= 100 ? inPeriod : 200 - inPeriod) * 0.01, 0.0));
+    }
+    QCOMPARE(zigZag.takePoints().size(), std::size_t(5));
+}
+
+void SimulationStreamTest::testDecimateMaxPointCount()
+{
+    // circles along a line, every point of the input is a vertex
+    const std::size_t maxPointCount = 500;
+    PolylineDecimator decimator{maxPointCount};
+    std::vector<std::pair<double, double>> input;
+    for (int i = 0; i <= 200000; i++)
+    {
+        const auto angle = i * 2.0 * M_PI / 100.0;
+        input.emplace_back(i * 0.0001 + std::cos(angle), std::sin(angle));
+        decimator.add(testFunction::point(input.back().first, input.back().second));
+    }
+
+    const auto tolerance = decimator.tolerance();
+    QVERIFY(tolerance > 0.001);
+    const auto points = decimator.takePoints();
+    QVERIFY(points.size() <= maxPointCount);
+    QVERIFY(points.size() > 2);
+    QCOMPARE(points.front().endPosition.first, input.front().first);
+    QCOMPARE(points.front().endPosition.second, input.front().second);
+    QCOMPARE(points.back().endPosition.first, input.back().first);
+    QCOMPARE(points.back().endPosition.second, input.back().second);
+
+    // every input point is near to the reduced polyline, each reduction adds at most the tolerance
+    std::size_t segment = 1;
+    for (const auto& inputPoint : input)
+    {
+        auto distance = testFunction::distanceToSegment(inputPoint, points.at(segment - 1).endPosition, points.at(segment).endPosition);
+        while (distance > 2.0 * tolerance && segment + 1 < points.size())
+        {
+            segment++;
+            distance = testFunction::distanceToSegment(inputPoint, points.at(segment - 1).endPosition, points.at(segment).endPosition);
+        }
+        QVERIFY(distance <= 2.0 * tolerance);
+    }
+}
+
+void SimulationStreamTest::testSimulateWholeFigure()
+{
+    // 100 mm with 10 mm/s are 1 million steps
+    const auto seam = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{50.0, 0.0}, QVector2D{50.0, 50.0}}, 10.0);
+    const auto wobble = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.0, 0.5}, QVector2D{0.0, 0.0}, QVector2D{0.0, -0.5}, QVector2D{0.0, 0.0}}, 250);
+
+    SimulationSettings settings;
+    settings.maxPointCount = 1000;
+    const auto result = simulate(seam, wobble, 1.0, settings, std::make_shared<std::atomic<bool>>(false));
+
+    QCOMPARE(result.statistics.stepCount(), std::size_t(1000000));
+    QVERIFY(result.figure.size() <= settings.maxPointCount);
+    QVERIFY(result.figure.size() > 2);
+    QCOMPARE(result.figure.front().endPosition.first, 0.0);
+    QCOMPARE(result.figure.front().endPosition.second, 0.0);
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(result.figure.back().endPosition.first), 50.0);
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(result.figure.back().endPosition.second), 50.0);
+    // 0.0001 mm along the seam and 0.002 mm across in each step
+    QCOMPARE(testFunction::limitPrecisionToTwoDigits(result.statistics.averageFocusSpeed()), 200.25);
+    QCOMPARE(qRound(result.statistics.pathLength()), 2002);
+}
+
+void SimulationStreamTest::testSimulateLoopCount()
+{
+    const auto seam = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{1.0, 0.0}}, 100.0);
+    const auto wobble = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.0, 0.1}, QVector2D{0.0, 0.0}, QVector2D{0.0, -0.1}, QVector2D{0.0, 0.0}}, 25);
+
+    SimulationSettings settings;
+    settings.tenMicroSecondsFactor = 3;
+    settings.loopCountInPoints = 10;
+    const auto result = simulate(seam, wobble, 1.0, settings, nullptr);
+
+    // the steps 0, 3, 6, 9 and the first one after the requested steps
+    QCOMPARE(result.figure.size(), std::size_t(5));
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(result.figure.at(1).endPosition.first), 0.003);
+    QCOMPARE(testFunction::limitPrecisionToSixDigits(result.figure.at(4).endPosition.first), 0.012);
+    // the statistics contain the whole seam
+    QCOMPARE(result.statistics.stepCount(), std::size_t(1000));
+
+    settings.maxPointCount = 3;
+    QCOMPARE(simulate(seam, wobble, 1.0, settings, nullptr).figure.size(), std::size_t(3));
+}
+
+void SimulationStreamTest::testSimulateCanceled()
+{
+    const auto seam = testFunction::getSeamFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{1.0, 0.0}}, 100.0);
+    const auto wobble = testFunction::getWobbleFigureFromVectors({QVector2D{0.0, 0.0}, QVector2D{0.0, 0.1}, QVector2D{0.0, 0.0}}, 25);
+
+    const auto result = simulate(seam, wobble, 1.0, {}, std::make_shared<std::atomic<bool>>(true));
+    QVERIFY(result.figure.empty());
+    QCOMPARE(result.statistics.stepCount(), std::size_t(0));
+
+    QVERIFY(simulate(seam, {}, 1.0, {}, nullptr).figure.empty());
+    QVERIFY(simulate({}, wobble, 1.0, {}, nullptr).figure.empty());
+}
+
+QTEST_GUILESS_MAIN(SimulationStreamTest)
+#include "simulationStreamTest.moc"
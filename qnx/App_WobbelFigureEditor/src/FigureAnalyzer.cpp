@@ -244,18 +244,6 @@ bool FigureAnalyzer::getInformationFromSimulationController()
     m_wobbleFigurePointSize = m_simulationController->wobbleFigurePointSize();
     m_microVectorFactor = m_simulationController->microVectorFactor();
     m_wobbleFigurePointCount = m_simulationController->wobbleFigurePointCount();
-    if (m_simulationController->loopCount() != 0)
-    {
-        std::vector<RTC6::seamFigure::command::Order> copySimulatedFigure = simulatedFigure;
-        simulatedFigure.clear();
-        for (int i = 0; i < static_cast<int>(m_simulationController->pointCountSimulationFigure() * m_simulationController->tenMicroSecondsFactor()); i++)
-        {
-            if (i % m_simulationController->tenMicroSecondsFactor() == 0)
-            {
-                simulatedFigure.push_back(copySimulatedFigure.at(i));
-            }
-        }
-    }
 
     if (simulatedFigure.empty() || m_wobbleFigurePointSize == 0)
     {
@@ -415,18 +403,15 @@ void FigureAnalyzer::updateFocusSpeed()
         return;
     }
 
-    const auto &focusSpeed = m_simulationController->simulationFocusSpeed();
-    if (focusSpeed.empty())
+    const auto &statistics = m_simulationController->simulationStatistics();
+    if (statistics.stepCount() == 0)
     {
         return;
     }
 
-    auto minMax = std::minmax_element(focusSpeed.begin(), focusSpeed.end());
-    auto average = std::accumulate(focusSpeed.begin(), focusSpeed.end(), 0.0) / focusSpeed.size();
-
-    m_minFocusSpeed = *minMax.first;
-    m_maxFocusSpeed = *minMax.second;
-    m_averageFocusSpeed = average;
+    m_minFocusSpeed = statistics.minFocusSpeed();
+    m_maxFocusSpeed = statistics.maxFocusSpeed();
+    m_averageFocusSpeed = statistics.averageFocusSpeed();
 
     emit focusSpeedChanged();
 }
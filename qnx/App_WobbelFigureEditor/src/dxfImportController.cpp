@@ -623,8 +623,7 @@ void DxfImportController::renderSegments()
 
                 m_paths = nsDxfReader::RouteOptimized(m_paths);
 
-                for (int i = 0; nsDxfReader::ImproveOrderLocally(m_paths) && i < 10; ++i)
-                    ;
+                nsDxfReader::ImproveRoute(m_paths, nsDxfReader::ScannerTiming{}, std::chrono::milliseconds(500));
             }
 
             { // apply segment configuration to imported paths
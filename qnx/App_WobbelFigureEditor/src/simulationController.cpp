@@ -2,6 +2,7 @@
 
 #include <QVector2D>
 #include <QVector3D>
+#include <QtConcurrentRun>
 
 #include "FileModel.h"
 #include "laserPointController.h"
@@ -9,12 +10,9 @@
 #include "figureEditorSettings.h"
 
 #include "editorDataTypes.h"
-#include "velocityLimits.h"
 
 using precitec::scanmaster::components::wobbleFigureEditor::FigureEditorSettings;
 
-using precitec::scanmaster::components::wobbleFigureEditor::velocityLimits::VelocityLimits;
-
 namespace precitec
 {
 namespace scanmaster
@@ -30,6 +28,7 @@ SimulationController::SimulationController(QObject* parent)
     connect(this, &SimulationController::simulationModeChanged, this, &SimulationController::clear);
     connect(this, &SimulationController::figureForSimulationChanged, this, &SimulationController::startSimulationFigure);
     connect(this, &SimulationController::tenMicroSecondsFactorChanged, this, &SimulationController::startSimulationFigure);
+    connect(this, &SimulationController::loopCountChanged, this, &SimulationController::startSimulationFigure);
     connect(FigureEditorSettings::instance(), &FigureEditorSettings::scannerSpeedChanged, this, &SimulationController::startSimulationFigure);
     connect(this, &SimulationController::simulationFigureCalculated, this, &SimulationController::checkSimulatedFigureReady);
     connect(this, &SimulationController::loopCountChanged, this, &SimulationController::checkSimulatedFigureReady);
@@ -38,7 +37,11 @@ SimulationController::SimulationController(QObject* parent)
     connect(this, &SimulationController::loopCountChanged, this, &SimulationController::pointCountSimulationFigureChanged);
 }
 
-SimulationController::~SimulationController() = default;
+SimulationController::~SimulationController()
+{
+    cancelSimulation();
+    m_simulation.waitForFinished();
+}
 
 void SimulationController::setFileModel(precitec::scantracker::components::wobbleFigureEditor::FileModel* model)
 {
@@ -164,12 +167,15 @@ void SimulationController::showSimulatedFigure()
         return;
     }
 
-    m_laserPointController->drawSimulatedFigure(m_simulatedSeamFigure, m_visualizationInformation);
+    // the simulated figure only contains the points to draw
+    const auto loopCountInPoints = m_loopCount == LoopCount::WholeFigure || m_simulatedSeamFigure.figure.empty() ? 0u : static_cast<unsigned int>(m_simulatedSeamFigure.figure.size() - 1);
+    m_laserPointController->drawSimulatedFigure(m_simulatedSeamFigure, std::make_pair(loopCountInPoints, 1));
     m_laserPointController->setPointsAreModifiable(false);
 }
 
 void SimulationController::clear()
 {
+    cancelSimulation();
     clearSimulationFigure();
     m_wobbleFigure = {};
     m_seamFigure = {};
@@ -195,44 +201,51 @@ bool SimulationController::checkOneFigureMissing()
 
 void SimulationController::calculateSimulationFigure()
 {
+    cancelSimulation();
     clearSimulationFigure();
-    m_focusSpeed.clear();
+    m_simulationStatistics = {};
 
     if (m_seamFigure.figure.empty() || m_wobbleFigure.figure.empty())
     {
         return;
     }
 
-    const auto& startPoint = m_seamFigure.figure.at(0).endPosition;
-    const auto& seamVelocities = createSeamVelocities();
-    const auto& wobbleVelocities = createWobbleVelocities();
-
-    m_simulatedSeamFigure.figure.reserve(seamVelocities.size());
-    RTC6::seamFigure::command::Order order;
-    order.endPosition = std::make_pair(startPoint.first, startPoint.second);
-    order.power = m_wobbleFigure.figure.front().power;
-    m_simulatedSeamFigure.figure.push_back(order);
+    SimulationSettings settings;
+    settings.tenMicroSecondsFactor = m_tenMicroSecondsFactor;
+    settings.loopCountInPoints = calculateVisualizationInformation().first;
+    // the whole figure has to stay below the limit to be drawn
+    settings.maxPointCount = m_loopCount == LoopCount::WholeFigure ? m_pointCountVisualizationLimit - 1 : m_pointCountVisualizationLimit;
+
+    m_simulationCanceled = std::make_shared<std::atomic<bool>>(false);
+    auto watcher = m_pendingWatcher = new QFutureWatcher<SimulationResult>(this);
+    connect(watcher, &QFutureWatcher<SimulationResult>::finished, this,
+            [watcher, this]
+            {
+                watcher->deleteLater();
+
+                // Discard results of a simulation which was canceled or restarted with other figures or settings.
+                if (watcher != m_pendingWatcher)
+                {
+                    return;
+                }
+                m_pendingWatcher = nullptr;
+
+                auto result = watcher->result();
+                m_simulatedSeamFigure.figure = std::move(result.figure);
+                m_simulationStatistics = result.statistics;
+                emit simulationFigureCalculated();
+            });
+    m_simulation = QtConcurrent::run(simulate, m_seamFigure, m_wobbleFigure, firstValidSpeed(), settings, m_simulationCanceled);
+    watcher->setFuture(m_simulation);
+}
 
-    for (std::size_t i = 0; i < seamVelocities.size(); i++)
+void SimulationController::cancelSimulation()
+{
+    if (m_simulationCanceled)
     {
-        auto seamPart = seamVelocities.at(i);
-        auto wobblePart = wobbleVelocities.at(i % wobbleVelocities.size());
-
-        auto seamAngle = angleRadFromXAxis(seamPart);
-        auto wobblePartRotated = rotateVectorRad(wobblePart.toVector2D(), seamAngle);
-
-        auto superImposedPart = seamPart + wobblePartRotated;
-
-        order.endPosition = std::make_pair(
-            m_simulatedSeamFigure.figure.back().endPosition.first + superImposedPart.x(),
-            m_simulatedSeamFigure.figure.back().endPosition.second + superImposedPart.y());
-        order.power += wobblePart.z();
-        m_simulatedSeamFigure.figure.push_back(order);
-
-        m_focusSpeed.push_back(calculateFocusSpeed(superImposedPart));
+        m_simulationCanceled->store(true);
     }
-
-    emit simulationFigureCalculated();
+    m_pendingWatcher = nullptr;
 }
 
 void SimulationController::clearSimulationFigure()
@@ -248,71 +261,6 @@ double SimulationController::firstValidSpeed()
     return FigureEditorSettings::instance()->scannerSpeed();
 }
 
-std::vector<QVector2D> SimulationController::createSeamVelocities()
-{
-    std::vector<QVector2D> seamVelocities;
-    seamVelocities.reserve(m_seamFigure.figure.size() * 500000);
-
-    auto lastValidSpeed = 1.0;
-    if (qFuzzyCompare(m_seamFigure.figure.at(0).velocity, static_cast<double>(VelocityLimits::Default)))
-    {
-        lastValidSpeed = firstValidSpeed();
-    }
-
-    for (std::size_t i = 1; i < m_seamFigure.figure.size(); i++)
-    {
-        const auto& lastPoint = m_seamFigure.figure.at(i - 1);
-        const auto& currentPoint = m_seamFigure.figure.at(i);
-        const auto& lastToCurrentPoint = QVector2D(currentPoint.endPosition.first - lastPoint.endPosition.first, currentPoint.endPosition.second - lastPoint.endPosition.second);
-        const auto& lengthLastToCurrent = lastToCurrentPoint.length();
-        auto partSpeed = 0.0;
-        if (qFuzzyCompare(lastPoint.velocity, static_cast<double>(VelocityLimits::Default)))
-        {
-            partSpeed = lastValidSpeed;
-        }
-        else
-        {
-            partSpeed = lastPoint.velocity;
-        }
-
-        const auto& timeForSeamPart = lengthLastToCurrent / partSpeed;
-        const auto& pointCount10us = qRound(timeForSeamPart / m_secondsIn10us);
-        for (int i = 0; i < pointCount10us; i++)
-        {
-            seamVelocities.emplace_back(lastToCurrentPoint / pointCount10us);
-        }
-    }
-
-    return seamVelocities;
-}
-
-std::vector<QVector3D> SimulationController::createWobbleVelocities()
-{
-    std::vector<QVector3D> wobbleVelocities;
-    wobbleVelocities.reserve((m_wobbleFigure.figure.size() - 1) * m_wobbleFigure.microVectorFactor);
-
-    for (std::size_t i = 1; i < m_wobbleFigure.figure.size(); i++)
-    {
-        const auto& lastPoint = m_wobbleFigure.figure.at(i - 1);
-        const auto& currentPoint = m_wobbleFigure.figure.at(i);
-        const auto& lastToCurrentPoint = QVector2D(currentPoint.endPosition.first - lastPoint.endPosition.first, currentPoint.endPosition.second - lastPoint.endPosition.second);
-        const auto& microVectorFactor = static_cast<unsigned int>(m_wobbleFigure.microVectorFactor);
-        auto relativePower = (currentPoint.power - lastPoint.power) / microVectorFactor;
-
-        if (i == m_wobbleFigure.figure.size() - 1)
-        {
-            relativePower = 0.0;
-        }
-
-        for (std::size_t j = 0; j < microVectorFactor; j++)
-        {
-            wobbleVelocities.emplace_back(lastToCurrentPoint.x() / microVectorFactor, lastToCurrentPoint.y() / microVectorFactor, relativePower);
-        }
-    }
-
-    return wobbleVelocities;
-}
-
 std::pair<unsigned int, int> SimulationController::calculateVisualizationInformation()
 {
     if (m_loopCount != 0)
@@ -324,7 +272,7 @@ std::pair<unsigned int, int> SimulationController::calculateVisualizationInforma
 
 bool SimulationController::checkTooManyPoints()
 {
-    return m_simulatedSeamFigure.figure.size() / m_tenMicroSecondsFactor >= m_pointCountVisualizationLimit;
+    return m_simulatedSeamFigure.figure.size() >= m_pointCountVisualizationLimit;
 }
 
 void SimulationController::checkSimulatedFigureReady()
@@ -340,54 +288,6 @@ void SimulationController::checkSimulatedFigureReady()
     setReady(true);
 }
 
-double SimulationController::calculateFocusSpeed(const QVector2D& velocity)
-{
-    return velocity.length() / m_secondsIn10us;
-}
-
-double SimulationController::angleRadFromXAxis(const QVector2D& vector)
-{
-    if (qFuzzyIsNull(vector.x())) //90°/270° --> vector.x() == 0
-    {
-        if (vector.y() > 0.0)
-        {
-            return M_PI * 0.5;
-        }
-        else if (vector.y() < 0.0)
-        {
-            return 3 * M_PI * 0.5;
-        }
-        else
-        {
-            return 0.0;
-        }
-    }
-
-    auto angle = qAtan2(std::abs(vector.y()), std::abs(vector.x())); //Works for I quadrant of coordinate system (see complex numbers, especially angle of complex numbers)
-    if (vector.x() < 0.0 && vector.y() > 0.0)                        //II quadrant
-    {
-        return M_PI - angle;
-    }
-    else if (vector.x() < 0.0 && vector.y() < 0.0) //III quadrant
-    {
-        return M_PI + angle;
-    }
-    else if (vector.x() > 0.0 && vector.y() < 0.0) //IV quadrant
-    {
-        return (2 * M_PI) - angle;
-    }
-    else if (qFuzzyIsNull(angle) && vector.x() < 0.0)
-    {
-        return M_PI;
-    }
-    return angle;
-}
-
-QVector2D SimulationController::rotateVectorRad(const QVector2D& vector, double angleRad)
-{
-    return QVector2D(qCos(angleRad) * vector.x() - qSin(angleRad) * vector.y(), qSin(angleRad) * vector.x() + qCos(angleRad) * vector.y());
-}
-
 }
 }
 }
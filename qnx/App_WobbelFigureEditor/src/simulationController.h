@@ -1,10 +1,13 @@
 #pragma once
 
 #include <QObject>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QtMath>
 
 #include "fileType.h"
 #include "editorDataTypes.h"
+#include "simulationStream.h"
 
 class SimulationControllerTest;
 class FigureAnalyzerTest;
@@ -71,9 +74,9 @@ class SimulationController : public QObject
 
     /**
      * 10us factor
-     * This factor is used to be able to display even very large simulated figures. 10 us is the clock of the wobble figure.
-     * To achieve the highest resolution of the simulated figure the temporal basis of the simulation is the clock of the wobble figure.
-     * That is why the number of points can increase very quickly with a long seam. With this property a multiple of the 10us is specified.
+     * 10 us is the clock of the wobble figure and the temporal basis of the simulation. With this property a multiple of the 10us is specified,
+     * only every n-th step of the simulation is a point of the simulated figure. The whole figure is additionally decimated to at most
+     * maxPointCountForSimulation points, straight parts are reduced more than curved parts.
      **/
     Q_PROPERTY(int tenMicroSecondsFactor READ tenMicroSecondsFactor WRITE setTenMicroSecondsFactor NOTIFY tenMicroSecondsFactorChanged)
 
@@ -89,6 +92,7 @@ class SimulationController : public QObject
      * Number of points from the simulated figure which will be drawn
      * Gives the number of points from the simulated figure which will be drawn. If loop count is not equal to zero then
      * the number of points which are used to draw the periods of the wobble figure is set.
+     * The simulation is calculated in the background, the number changes when the calculation is finished.
      **/
     Q_PROPERTY(int pointCountSimulationFigure READ pointCountSimulationFigure NOTIFY pointCountSimulationFigureChanged)
 
@@ -145,7 +149,7 @@ public:
 
     int pointCountSimulationFigure() const
     {
-        return m_loopCount == LoopCount::WholeFigure ? m_simulatedSeamFigure.figure.size() / m_tenMicroSecondsFactor : qCeil(static_cast<double> (m_wobbleFigure.figure.size() * m_wobbleFigure.microVectorFactor * m_loopCount) / static_cast<double> (m_tenMicroSecondsFactor));
+        return m_loopCount == LoopCount::WholeFigure ? m_simulatedSeamFigure.figure.size() : qCeil(static_cast<double> (m_wobbleFigure.figure.size() * m_wobbleFigure.microVectorFactor * m_loopCount) / static_cast<double> (m_tenMicroSecondsFactor));
     }
 
     int maxPointCountForSimulation() const
@@ -169,9 +173,12 @@ public:
         return m_simulatedSeamFigure.figure;
     }
 
-    const std::vector<double>& simulationFocusSpeed() const
+    /**
+     * Statistics of all 10us steps of the simulated figure, not only of the drawn points.
+     **/
+    const SimulationStatistics& simulationStatistics() const
     {
-        return m_focusSpeed;
+        return m_simulationStatistics;
     }
 
     unsigned int microVectorFactor() const
@@ -201,16 +208,12 @@ private:
     void startSimulationFigure();
     bool checkOneFigureMissing();
     void calculateSimulationFigure();
+    void cancelSimulation();
     void clearSimulationFigure();
     double firstValidSpeed();
-    std::vector<QVector2D> createSeamVelocities();
-    std::vector<QVector3D> createWobbleVelocities();
     std::pair<unsigned int, int> calculateVisualizationInformation();
     bool checkTooManyPoints();
     void checkSimulatedFigureReady();
-    double calculateFocusSpeed(const QVector2D& velocity);
-    double angleRadFromXAxis(const QVector2D& vector);
-    QVector2D rotateVectorRad(const QVector2D& vector, double angleRad);
 
     precitec::scantracker::components::wobbleFigureEditor::FileModel* m_fileModel = nullptr;
     QMetaObject::Connection m_fileModelDestroyedConnection;
@@ -225,14 +228,17 @@ private:
 
     bool m_ready{false};
 
-    double m_secondsIn10us{0.00001};
     unsigned int m_pointCountVisualizationLimit{3000};
 
     RTC6::seamFigure::SeamFigure m_seamFigure;
     RTC6::wobbleFigure::Figure m_wobbleFigure;
     RTC6::seamFigure::SeamFigure m_simulatedSeamFigure;
 
-    std::vector<double> m_focusSpeed;
+    SimulationStatistics m_simulationStatistics;
+
+    QFutureWatcher<SimulationResult>* m_pendingWatcher = nullptr;
+    QFuture<SimulationResult> m_simulation;     ///< last started simulation, also after it was canceled
+    std::shared_ptr<std::atomic<bool>> m_simulationCanceled;
 
     friend SimulationControllerTest;
     friend FigureAnalyzerTest;
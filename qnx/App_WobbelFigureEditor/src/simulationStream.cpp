@@ -0,0 +1,387 @@
+#include "simulationStream.h"
+
+#include <QtMath>
+
+#include <cmath>
+
+#include "velocityLimits.h"
+
+using precitec::scanmaster::components::wobbleFigureEditor::velocityLimits::VelocityLimits;
+
+namespace precitec
+{
+namespace scanmaster
+{
+namespace components
+{
+namespace wobbleFigureEditor
+{
+
+namespace
+{
+const double secondsIn10us{0.00001};
+// steps between two checks whether the simulation is canceled
+const std::size_t cancelCheckInterval{65536};
+}
+
+void SimulationStatistics::add(const QVector2D& movement, double power)
+{
+    const auto speed = focusSpeed(movement);
+    m_stepCount++;
+    m_minFocusSpeed = std::min(m_minFocusSpeed, speed);
+    m_maxFocusSpeed = std::max(m_maxFocusSpeed, speed);
+    m_focusSpeedSum += speed;
+    m_minPower = std::min(m_minPower, power);
+    m_maxPower = std::max(m_maxPower, power);
+    m_pathLength += movement.length();
+}
+
+double SimulationStatistics::focusSpeed(const QVector2D& movement)
+{
+    return movement.length() / secondsIn10us;
+}
+
+SimulationStream::SimulationStream(const RTC6::seamFigure::SeamFigure& seam, const RTC6::wobbleFigure::Figure& wobble, double firstValidSpeed)
+    : m_seamParts(createSeamParts(seam, firstValidSpeed))
+    , m_wobbleVelocities(createWobbleVelocities(wobble))
+{
+    for (const auto& seamPart : m_seamParts)
+    {
+        m_stepCount += seamPart.stepCount;
+    }
+    if (!seam.figure.empty())
+    {
+        m_current.endPosition = seam.figure.front().endPosition;
+    }
+    if (!wobble.figure.empty())
+    {
+        m_current.power = wobble.figure.front().power;
+    }
+}
+
+QVector2D SimulationStream::next()
+{
+    const auto& seamPart = m_seamParts.at(m_seamPart);
+    const auto wobblePart = m_wobbleVelocities.empty() ? QVector3D{} : m_wobbleVelocities.at(m_step % m_wobbleVelocities.size());
+
+    const auto wobblePartRotated = QVector2D(seamPart.cosAngle * wobblePart.x() - seamPart.sinAngle * wobblePart.y(), seamPart.sinAngle * wobblePart.x() + seamPart.cosAngle * wobblePart.y());
+    const auto superImposedPart = seamPart.velocity + wobblePartRotated;
+
+    m_current.endPosition.first += superImposedPart.x();
+    m_current.endPosition.second += superImposedPart.y();
+    m_current.power += wobblePart.z();
+
+    m_step++;
+    m_stepInSeamPart++;
+    if (m_stepInSeamPart >= seamPart.stepCount)
+    {
+        m_seamPart++;
+        m_stepInSeamPart = 0;
+    }
+
+    return superImposedPart;
+}
+
+std::vector<SeamPart> SimulationStream::createSeamParts(const RTC6::seamFigure::SeamFigure& seam, double firstValidSpeed)
+{
+    std::vector<SeamPart> seamParts;
+    if (seam.figure.empty())
+    {
+        return seamParts;
+    }
+    seamParts.reserve(seam.figure.size() - 1);
+
+    auto lastValidSpeed = 1.0;
+    if (qFuzzyCompare(seam.figure.at(0).velocity, static_cast<double>(VelocityLimits::Default)))
+    {
+        lastValidSpeed = firstValidSpeed;
+    }
+
+    for (std::size_t i = 1; i < seam.figure.size(); i++)
+    {
+        const auto& lastPoint = seam.figure.at(i - 1);
+        const auto& currentPoint = seam.figure.at(i);
+        const auto& lastToCurrentPoint = QVector2D(currentPoint.endPosition.first - lastPoint.endPosition.first, currentPoint.endPosition.second - lastPoint.endPosition.second);
+        const auto& lengthLastToCurrent = lastToCurrentPoint.length();
+        auto partSpeed = 0.0;
+        if (qFuzzyCompare(lastPoint.velocity, static_cast<double>(VelocityLimits::Default)))
+        {
+            partSpeed = lastValidSpeed;
+        }
+        else
+        {
+            partSpeed = lastPoint.velocity;
+        }
+
+        const auto& timeForSeamPart = lengthLastToCurrent / partSpeed;
+        const auto& pointCount10us = qRound(timeForSeamPart / secondsIn10us);
+        if (pointCount10us <= 0)
+        {
+            continue;
+        }
+        const auto velocity = lastToCurrentPoint / pointCount10us;
+        const auto angle = angleRadFromXAxis(velocity);
+        seamParts.push_back({velocity, pointCount10us, qCos(angle), qSin(angle)});
+    }
+
+    return seamParts;
+}
+
+std::vector<QVector3D> SimulationStream::createWobbleVelocities(const RTC6::wobbleFigure::Figure& wobble)
+{
+    std::vector<QVector3D> wobbleVelocities;
+    if (wobble.figure.size() < 2)
+    {
+        return wobbleVelocities;
+    }
+    wobbleVelocities.reserve((wobble.figure.size() - 1) * wobble.microVectorFactor);
+
+    for (std::size_t i = 1; i < wobble.figure.size(); i++)
+    {
+        const auto& lastPoint = wobble.figure.at(i - 1);
+        const auto& currentPoint = wobble.figure.at(i);
+        const auto& lastToCurrentPoint = QVector2D(currentPoint.endPosition.first - lastPoint.endPosition.first, currentPoint.endPosition.second - lastPoint.endPosition.second);
+        const auto& microVectorFactor = static_cast<unsigned int>(wobble.microVectorFactor);
+        auto relativePower = (currentPoint.power - lastPoint.power) / microVectorFactor;
+
+        if (i == wobble.figure.size() - 1)
+        {
+            relativePower = 0.0;
+        }
+
+        for (std::size_t j = 0; j < microVectorFactor; j++)
+        {
+            wobbleVelocities.emplace_back(lastToCurrentPoint.x() / microVectorFactor, lastToCurrentPoint.y() / microVectorFactor, relativePower);
+        }
+    }
+
+    return wobbleVelocities;
+}
+
+double SimulationStream::angleRadFromXAxis(const QVector2D& vector)
+{
+    if (qFuzzyIsNull(vector.x())) //90°/270° --> vector.x() == 0
+    {
+        if (vector.y() > 0.0)
+        {
+            return M_PI * 0.5;
+        }
+        else if (vector.y() < 0.0)
+        {
+            return 3 * M_PI * 0.5;
+        }
+        else
+        {
+            return 0.0;
+        }
+    }
+
+    auto angle = qAtan2(std::abs(vector.y()), std::abs(vector.x())); //Works for I quadrant of coordinate system (see complex numbers, especially angle of complex numbers)
+    if (vector.x() < 0.0 && vector.y() > 0.0)                        //II quadrant
+    {
+        return M_PI - angle;
+    }
+    else if (vector.x() < 0.0 && vector.y() < 0.0) //III quadrant
+    {
+        return M_PI + angle;
+    }
+    else if (vector.x() > 0.0 && vector.y() < 0.0) //IV quadrant
+    {
+        return (2 * M_PI) - angle;
+    }
+    else if (qFuzzyIsNull(angle) && vector.x() < 0.0)
+    {
+        return M_PI;
+    }
+    return angle;
+}
+
+QVector2D SimulationStream::rotateVectorRad(const QVector2D& vector, double angleRad)
+{
+    return QVector2D(qCos(angleRad) * vector.x() - qSin(angleRad) * vector.y(), qSin(angleRad) * vector.x() + qCos(angleRad) * vector.y());
+}
+
+PolylineDecimator::PolylineDecimator(std::size_t maxPointCount, double tolerance)
+    // first point, last kept point and a new vertex have to fit, otherwise reducing can't succeed
+    : m_maxPointCount(std::max(maxPointCount, std::size_t{3}))
+    , m_tolerance(tolerance > 0.0 ? tolerance : 0.001)
+{
+}
+
+void PolylineDecimator::add(const RTC6::seamFigure::command::Order& point)
+{
+    addPoint(point);
+    if (m_points.size() > m_maxPointCount)
+    {
+        reduce();
+    }
+}
+
+std::vector<RTC6::seamFigure::command::Order> PolylineDecimator::takePoints()
+{
+    if (m_last)
+    {
+        m_points.push_back(m_last.value());
+        m_last.reset();
+    }
+    if (m_points.size() > m_maxPointCount)
+    {
+        reduce();
+    }
+    startSleeve();
+    return std::move(m_points);
+}
+
+void PolylineDecimator::addPoint(const RTC6::seamFigure::command::Order& point)
+{
+    if (m_points.empty())
+    {
+        m_points.push_back(point);
+        startSleeve();
+        return;
+    }
+    if (!addToSleeve(point))
+    {
+        // the first point after the start of a sleeve always fits, so there is a last point
+        m_points.push_back(m_last.value());
+        startSleeve();
+        addToSleeve(point);
+    }
+    m_last = point;
+}
+
+bool PolylineDecimator::addToSleeve(const RTC6::seamFigure::command::Order& point)
+{
+    const auto& anchor = m_points.back().endPosition;
+    const auto dx = point.endPosition.first - anchor.first;
+    const auto dy = point.endPosition.second - anchor.second;
+    const auto distance = std::hypot(dx, dy);
+
+    if (distance < m_maxDistance - m_tolerance)
+    {
+        // the polyline turns back
+        return false;
+    }
+    if (distance <= m_tolerance)
+    {
+        return true;
+    }
+
+    const auto angle = std::atan2(dy, dx);
+    const auto halfWidth = std::asin(m_tolerance / distance);
+    if (!m_hasDirection)
+    {
+        m_hasDirection = true;
+        m_direction = angle;
+        m_lowerAngle = -halfWidth;
+        m_upperAngle = halfWidth;
+        m_maxDistance = distance;
+        return true;
+    }
+
+    const auto relativeAngle = std::remainder(angle - m_direction, 2.0 * M_PI);
+    if (relativeAngle < m_lowerAngle || relativeAngle > m_upperAngle)
+    {
+        return false;
+    }
+    m_lowerAngle = std::max(m_lowerAngle, relativeAngle - halfWidth);
+    m_upperAngle = std::min(m_upperAngle, relativeAngle + halfWidth);
+    m_maxDistance = std::max(m_maxDistance, distance);
+    return true;
+}
+
+void PolylineDecimator::startSleeve()
+{
+    m_hasDirection = false;
+    m_direction = 0.0;
+    m_lowerAngle = 0.0;
+    m_upperAngle = 0.0;
+    m_maxDistance = 0.0;
+}
+
+void PolylineDecimator::reduce()
+{
+    auto pending = m_last;
+    while (m_points.size() > m_maxPointCount)
+    {
+        m_tolerance *= 2.0;
+        auto points = std::move(m_points);
+        m_points.clear();
+        m_last.reset();
+        for (const auto& point : points)
+        {
+            addPoint(point);
+        }
+        // the last kept point is the start of the current sleeve, so it is kept again
+        if (m_last)
+        {
+            m_points.push_back(m_last.value());
+            m_last.reset();
+            startSleeve();
+        }
+        if (pending)
+        {
+            addPoint(pending.value());
+            pending.reset();
+        }
+    }
+}
+
+SimulationResult simulate(const RTC6::seamFigure::SeamFigure& seam, const RTC6::wobbleFigure::Figure& wobble, double firstValidSpeed, const SimulationSettings& settings, std::shared_ptr<std::atomic<bool>> canceled)
+{
+    SimulationResult result;
+    if (seam.figure.empty() || wobble.figure.empty())
+    {
+        return result;
+    }
+
+    SimulationStream stream{seam, wobble, firstValidSpeed};
+    const auto tenMicroSecondsFactor = static_cast<std::size_t>(std::max(settings.tenMicroSecondsFactor, 1));
+    const auto wholeFigure = settings.loopCountInPoints == 0;
+    PolylineDecimator decimator{settings.maxPointCount};
+
+    auto addPoint = [&]
+    {
+        if (wholeFigure)
+        {
+            decimator.add(stream.current());
+        }
+        else if (result.figure.size() < settings.maxPointCount)
+        {
+            result.figure.push_back(stream.current());
+        }
+    };
+
+    addPoint();
+    while (!stream.atEnd())
+    {
+        if (canceled && stream.step() % cancelCheckInterval == 0 && canceled->load())
+        {
+            return {};
+        }
+        result.statistics.add(stream.next(), stream.current().power);
+
+        const auto step = stream.step();
+        // the periods of the wobble figure are shown up to the first point after the requested number of steps
+        if (step % tenMicroSecondsFactor == 0 && (wholeFigure || step < settings.loopCountInPoints + tenMicroSecondsFactor))
+        {
+            addPoint();
+        }
+    }
+
+    if (wholeFigure)
+    {
+        if (stream.stepCount() % tenMicroSecondsFactor != 0)
+        {
+            decimator.add(stream.current());
+        }
+        result.figure = decimator.takePoints();
+    }
+
+    return result;
+}
+
+}
+}
+}
+}
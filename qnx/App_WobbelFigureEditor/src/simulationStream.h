@@ -0,0 +1,221 @@
+#pragma once
+
+#include <QVector2D>
+#include <QVector3D>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <optional>
+
+#include "editorDataTypes.h"
+
+namespace precitec
+{
+namespace scanmaster
+{
+namespace components
+{
+namespace wobbleFigureEditor
+{
+
+/**
+ * Straight part of the seam between two seam points, passed in a number of 10us steps with a constant velocity.
+ * The wobble figure is rotated into the direction of the seam part.
+ **/
+struct SeamPart
+{
+    QVector2D velocity;
+    int stepCount;
+    double cosAngle;
+    double sinAngle;
+};
+
+/**
+ * Statistics of all 10us steps of a simulated figure.
+ * The values are accumulated step by step, so no step has to be stored.
+ **/
+class SimulationStatistics
+{
+public:
+    void add(const QVector2D& movement, double power);
+
+    std::size_t stepCount() const
+    {
+        return m_stepCount;
+    }
+
+    double minFocusSpeed() const
+    {
+        return m_stepCount == 0 ? 0.0 : m_minFocusSpeed;
+    }
+
+    double maxFocusSpeed() const
+    {
+        return m_stepCount == 0 ? 0.0 : m_maxFocusSpeed;
+    }
+
+    double averageFocusSpeed() const
+    {
+        return m_stepCount == 0 ? 0.0 : m_focusSpeedSum / m_stepCount;
+    }
+
+    double minPower() const
+    {
+        return m_stepCount == 0 ? 0.0 : m_minPower;
+    }
+
+    double maxPower() const
+    {
+        return m_stepCount == 0 ? 0.0 : m_maxPower;
+    }
+
+    /**
+     * Length of the simulated path in mm.
+     **/
+    double pathLength() const
+    {
+        return m_pathLength;
+    }
+
+    /**
+     * Speed of the laser focus in mm/s if it moves @p movement in 10us.
+     **/
+    static double focusSpeed(const QVector2D& movement);
+
+private:
+    std::size_t m_stepCount{0};
+    double m_minFocusSpeed{std::numeric_limits<double>::max()};
+    double m_maxFocusSpeed{std::numeric_limits<double>::lowest()};
+    double m_focusSpeedSum{0.0};
+    double m_minPower{std::numeric_limits<double>::max()};
+    double m_maxPower{std::numeric_limits<double>::lowest()};
+    double m_pathLength{0.0};
+};
+
+/**
+ * Superimposes a seam with a wobble figure in the 10us clock of the scanner.
+ * The steps are calculated on demand, only the current position is kept. The memory doesn't depend on the length of the seam.
+ **/
+class SimulationStream
+{
+public:
+    SimulationStream(const RTC6::seamFigure::SeamFigure& seam, const RTC6::wobbleFigure::Figure& wobble, double firstValidSpeed);
+
+    std::size_t stepCount() const
+    {
+        return m_stepCount;
+    }
+
+    std::size_t step() const
+    {
+        return m_step;
+    }
+
+    bool atEnd() const
+    {
+        return m_step >= m_stepCount;
+    }
+
+    /**
+     * Start point of the seam or the position and power after the last step.
+     **/
+    const RTC6::seamFigure::command::Order& current() const
+    {
+        return m_current;
+    }
+
+    /**
+     * Performs the next step and returns the movement of the laser focus in this step.
+     **/
+    QVector2D next();
+
+    static std::vector<SeamPart> createSeamParts(const RTC6::seamFigure::SeamFigure& seam, double firstValidSpeed);
+    static std::vector<QVector3D> createWobbleVelocities(const RTC6::wobbleFigure::Figure& wobble);
+    static double angleRadFromXAxis(const QVector2D& vector);
+    static QVector2D rotateVectorRad(const QVector2D& vector, double angleRad);
+
+private:
+    std::vector<SeamPart> m_seamParts;
+    std::vector<QVector3D> m_wobbleVelocities;
+    std::size_t m_stepCount{0};
+    std::size_t m_step{0};
+    std::size_t m_seamPart{0};
+    int m_stepInSeamPart{0};
+    RTC6::seamFigure::command::Order m_current{};
+};
+
+/**
+ * Reduces a polyline while its points are added.
+ * Points are dropped as long as the polyline from the last kept point stays within the tolerance (sleeve fitting),
+ * so straight parts shrink to their end points and curved parts keep more points.
+ * If more than the maximum number of points would be kept the tolerance is doubled and the kept points are reduced again,
+ * thus the memory is bounded independently of the number of added points.
+ **/
+class PolylineDecimator
+{
+public:
+    explicit PolylineDecimator(std::size_t maxPointCount, double tolerance = 0.001);
+
+    void add(const RTC6::seamFigure::command::Order& point);
+
+    /**
+     * Returns the kept points including the last added point.
+     **/
+    std::vector<RTC6::seamFigure::command::Order> takePoints();
+
+    double tolerance() const
+    {
+        return m_tolerance;
+    }
+
+private:
+    bool addToSleeve(const RTC6::seamFigure::command::Order& point);
+    void addPoint(const RTC6::seamFigure::command::Order& point);
+    void startSleeve();
+    void reduce();
+
+    std::size_t m_maxPointCount;
+    double m_tolerance;
+    std::vector<RTC6::seamFigure::command::Order> m_points;
+    std::optional<RTC6::seamFigure::command::Order> m_last;
+
+    bool m_hasDirection{false};
+    double m_direction{0.0};
+    double m_lowerAngle{0.0};
+    double m_upperAngle{0.0};
+    double m_maxDistance{0.0};
+};
+
+struct SimulationSettings
+{
+    /**
+     * Every n-th 10us step is a point of the simulated figure.
+     **/
+    int tenMicroSecondsFactor{1};
+    /**
+     * Number of 10us steps which are shown, 0 for the whole figure.
+     **/
+    unsigned int loopCountInPoints{0};
+    /**
+     * Maximum number of points of the simulated figure. The whole figure is decimated to this number of points.
+     **/
+    std::size_t maxPointCount{3000};
+};
+
+struct SimulationResult
+{
+    std::vector<RTC6::seamFigure::command::Order> figure;
+    SimulationStatistics statistics;
+};
+
+/**
+ * Simulates the seam superimposed with the wobble figure. The statistics contain all steps, the figure only the points for the display.
+ * Stops early if @p canceled is set.
+ **/
+SimulationResult simulate(const RTC6::seamFigure::SeamFigure& seam, const RTC6::wobbleFigure::Figure& wobble, double firstValidSpeed, const SimulationSettings& settings, std::shared_ptr<std::atomic<bool>> canceled);
+
+}
+}
+}
+}
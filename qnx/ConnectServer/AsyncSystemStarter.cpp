@@ -17,10 +17,14 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <poll.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <spawn.h>
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <numeric>
 
 #include <errno.h>
@@ -49,14 +53,11 @@ static std::string wmInstPath()
 }
  
  void AsyncSystemStarter::run(){
-	// try to start processes with an fd, blocks till notified
+	// try to start processes with an fd, blocks till all are notified
 	const auto processes = loadConfiguration();
 	const auto wmProcesses = std::count_if(processes.begin(), processes.end(), [] (const auto &process) { return process.weldMasterApplication; });
 	Poco::ThreadPool::defaultPool().addCapacity(wmProcesses);
-	for (const auto &process : processes)
-	{
-		startProcess(process);
-	}
+	startProcesses(processes);
 }
 
 /**
@@ -120,6 +121,24 @@ static std::string removeWhitespaces(const std::string &input)
 	return output;
 }
 
+/**
+ * Reads the start notification of @p processName from the pipe @p readFileDescriptor
+ * and closes the pipe.
+ */
+static void readStartNotification(int readFileDescriptor, const std::string &processName)
+{
+	char buffer = 0;
+	if (read(readFileDescriptor, &buffer, 1) == -1)
+	{
+		std::cout <<  "WaitForProcessStarted " << processName << " Failed reading from pipe: " << errno << std::endl;
+	}
+	close(readFileDescriptor);
+	if (buffer != '1')
+	{
+		std::cout << "WaitForProcessStarted " << processName << " Read unexpected value from pipe" << std::endl;
+	}
+}
+
 std::vector<AsyncSystemStarter::Process> AsyncSystemStarter::loadConfiguration()
 {
 	using namespace Poco::Util;
@@ -156,6 +175,16 @@ std::vector<AsyncSystemStarter::Process> AsyncSystemStarter::loadConfiguration()
             process.enabled = pConf->getBool(group + std::string(".Enabled"), true);
             process.autoRestart = pConf->getBool(group + std::string(".AutoRestart"), false);
             process.ldPreload = pConf->getString(group + std::string(".LD_PRELOAD"), {});
+            process.configGroup = group;
+            if (pConf->hasProperty(group + std::string(".DependsOn")))
+            {
+                process.dependsOn = split(removeWhitespaces(pConf->getString(group + std::string(".DependsOn"))));
+                process.dependsOn.erase(std::remove(process.dependsOn.begin(), process.dependsOn.end(), std::string()), process.dependsOn.end());
+            } else if (!processes.empty())
+            {
+                // without configured dependencies the processes are started one after another
+                process.dependsOn.push_back(processes.back().configGroup);
+            }
 			processes.push_back(process);
 		} catch (Poco::NotFoundException&) {
 			std::cout << "Not found for " << key << std::endl;
@@ -184,6 +213,212 @@ void AsyncSystemStarter::startProcess(const Process &process)
 	unlink(pipePath.c_str());
 }
 
+std::chrono::milliseconds AsyncSystemStarter::startProcesses(const std::vector<Process> &processes, int timeOut)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+    const auto elapsed = [startTime] { return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime); };
+
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1)
+    {
+        std::cout << "Creating epoll instance failed: " << errno << ", starting processes one after another" << std::endl;
+        for (const auto &process : processes)
+        {
+            startProcess(process);
+        }
+        std::cout << "System started after " << elapsed().count() << " ms" << std::endl;
+        return elapsed();
+    }
+
+    // indices of the processes each process depends on
+    std::vector<std::vector<std::size_t>> dependencies(processes.size());
+    for (std::size_t i = 0; i < processes.size(); i++)
+    {
+        for (const auto &group : processes.at(i).dependsOn)
+        {
+            const auto it = std::find_if(processes.begin(), processes.end(), [&group] (const auto &process) { return process.configGroup == group; });
+            if (it == processes.end())
+            {
+                std::cout << "Unknown dependency " << group << " of " << processes.at(i).configGroup << std::endl;
+                continue;
+            }
+            dependencies.at(i).push_back(std::distance(processes.begin(), it));
+        }
+    }
+
+    struct StartingProcess
+    {
+        std::size_t index;
+        int readFd;
+        pid_t batchPid;
+        std::string pipePath;
+        Clock::time_point deadline;
+    };
+    std::vector<StartingProcess> startingProcesses;
+    std::vector<bool> launched(processes.size(), false);
+    std::vector<bool> started(processes.size(), false);
+    std::vector<bool> ignoreDependencies(processes.size(), false);
+    std::size_t startedCount = 0;
+
+    auto setStarted = [&] (std::size_t index)
+    {
+        started.at(index) = true;
+        startedCount++;
+        if (processes.at(index).enabled)
+        {
+            std::cout << "Process " << processes.at(index).processName << " started after " << elapsed().count() << " ms" << std::endl;
+        }
+    };
+    auto finish = [&] (const StartingProcess &startingProcess, bool timedOut)
+    {
+        const auto &process = processes.at(startingProcess.index);
+        if (startingProcess.readFd != -1)
+        {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, startingProcess.readFd, nullptr);
+            if (timedOut)
+            {
+                std::cout << "WaitForProcessStarted " << process.processName << " timed out" << std::endl;
+                close(startingProcess.readFd);
+            } else
+            {
+                readStartNotification(startingProcess.readFd, process.processName);
+            }
+        }
+        if (startingProcess.batchPid > 0)
+        {
+            int status = 0;
+            waitpid(startingProcess.batchPid, &status, 0);
+        }
+        if (!startingProcess.pipePath.empty())
+        {
+            // unlink the named pipe, will be deleted once both sides closed it
+            unlink(startingProcess.pipePath.c_str());
+        }
+        setStarted(startingProcess.index);
+    };
+    auto launch = [&] (std::size_t index)
+    {
+        const auto &process = processes.at(index);
+        launched.at(index) = true;
+        if (!process.enabled)
+        {
+            setStarted(index);
+            return;
+        }
+        StartingProcess startingProcess{index, -1, -1, {}, Clock::time_point::max()};
+        if (process.batch)
+        {
+            startingProcess.readFd = startBatchAsync(process, startingProcess.batchPid);
+            if (startingProcess.readFd == -1)
+            {
+                startBatch(process);
+                setStarted(index);
+                return;
+            }
+        } else
+        {
+            startingProcess.pipePath = getenv("XDG_RUNTIME_DIR") + std::string("/wmpipes/") + getenv("WM_STATION_NAME") + std::string("/p") + process.processName;
+            startingProcess.readFd = createPipe(startingProcess.pipePath);
+            startWeldmasterProcess(process, startingProcess.readFd == -1 ? std::string() : startingProcess.pipePath);
+            // without pipe just wait some time for the process to be started, like waitForProcessStarted
+            startingProcess.deadline = Clock::now() + std::chrono::milliseconds{startingProcess.readFd == -1 ? 5000 : timeOut};
+        }
+        if (startingProcess.readFd != -1)
+        {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = startingProcess.readFd;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, startingProcess.readFd, &event) == -1)
+            {
+                std::cout << "Adding pipe of " << process.processName << " to epoll failed: " << errno << std::endl;
+                waitForProcessStarted(startingProcess.readFd, process.processName, process.batch ? std::numeric_limits<int>::max() : timeOut);
+                startingProcess.readFd = -1;
+                finish(startingProcess, false);
+                return;
+            }
+        }
+        startingProcesses.push_back(startingProcess);
+    };
+
+    while (startedCount < processes.size())
+    {
+        // a disabled process is started right away, thus its dependent processes can be launched in the same pass
+        bool launchedAny = true;
+        while (launchedAny)
+        {
+            launchedAny = false;
+            for (std::size_t i = 0; i < processes.size(); i++)
+            {
+                if (launched.at(i))
+                {
+                    continue;
+                }
+                const auto &processDependencies = dependencies.at(i);
+                if (ignoreDependencies.at(i) || std::all_of(processDependencies.begin(), processDependencies.end(), [&started] (std::size_t dependency) { return started.at(dependency); }))
+                {
+                    launch(i);
+                    launchedAny = true;
+                }
+            }
+        }
+        if (startedCount == processes.size())
+        {
+            break;
+        }
+        if (startingProcesses.empty())
+        {
+            // nothing to wait for, only processes with cyclic dependencies are left
+            const auto index = std::distance(launched.begin(), std::find(launched.begin(), launched.end(), false));
+            std::cout << "Cyclic dependency of " << processes.at(index).configGroup << ", starting it anyway" << std::endl;
+            ignoreDependencies.at(index) = true;
+            continue;
+        }
+
+        const auto deadline = std::min_element(startingProcesses.begin(), startingProcesses.end(),
+                                               [] (const auto &a, const auto &b) { return a.deadline < b.deadline; })->deadline;
+        int waitTime = -1;
+        if (deadline != Clock::time_point::max())
+        {
+            waitTime = std::max(std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count(), std::chrono::milliseconds::rep{0});
+        }
+        std::array<epoll_event, 16> events;
+        const int eventCount = epoll_wait(epollFd, events.data(), events.size(), waitTime);
+        if (eventCount == -1 && errno != EINTR)
+        {
+            std::cout << "Waiting for started processes failed: " << errno << std::endl;
+            for (const auto &startingProcess : startingProcesses)
+            {
+                finish(startingProcess, true);
+            }
+            startingProcesses.clear();
+            continue;
+        }
+        for (int i = 0; i < eventCount; i++)
+        {
+            const auto it = std::find_if(startingProcesses.begin(), startingProcesses.end(),
+                                         [&events, i] (const auto &startingProcess) { return startingProcess.readFd == events.at(i).data.fd; });
+            if (it != startingProcesses.end())
+            {
+                finish(*it, false);
+                startingProcesses.erase(it);
+            }
+        }
+        const auto now = Clock::now();
+        const auto expired = std::partition(startingProcesses.begin(), startingProcesses.end(), [now] (const auto &startingProcess) { return startingProcess.deadline > now; });
+        for (auto it = expired; it != startingProcesses.end(); ++it)
+        {
+            finish(*it, true);
+        }
+        startingProcesses.erase(expired, startingProcesses.end());
+    }
+    close(epollFd);
+
+    const auto systemStarted = elapsed();
+    std::cout << "System started after " << systemStarted.count() << " ms" << std::endl;
+    return systemStarted;
+}
+
 int AsyncSystemStarter::createPipe(const std::string &pipePath)
 {
 	if (mkfifo(pipePath.c_str(), S_IRUSR | S_IWUSR) == 0)
@@ -297,13 +532,22 @@ void AsyncSystemStarter::startWeldmasterProcess(const Process &process, const st
     }
 }
 
-void AsyncSystemStarter::startBatch(const Process &process)
+/**
+ * @returns the command line to run the batch @p process with "sh -c"
+ */
+template <typename Process>
+static std::string batchCommand(const Process &process)
 {
 	std::string s_path = process.weldMasterApplication ? wmInstPath() + std::string("/batch/") + process.processName : process.processName;
 	// for the system call all arguments need to be provided in one string
 	// so merge them back together
-	s_path = std::accumulate(process.arguments.begin(), process.arguments.end(), s_path,
+	return std::accumulate(process.arguments.begin(), process.arguments.end(), s_path,
 			[] (std::string a, std::string b) { return a + " " + b; });
+}
+
+void AsyncSystemStarter::startBatch(const Process &process)
+{
+	const std::string s_path = batchCommand(process);
     const auto pid = fork();
     if (pid == 0)
     {
@@ -321,6 +565,48 @@ void AsyncSystemStarter::startBatch(const Process &process)
     }
 }
 
+int AsyncSystemStarter::startBatchAsync(const Process &process, pid_t &pid)
+{
+    const std::string s_path = batchCommand(process);
+    int pipeFds[2];
+    // close on exec, the pipe must not be held open by the batch or processes started by it
+    if (pipe2(pipeFds, O_CLOEXEC) != 0)
+    {
+        std::cout << "Creating pipe failed for " << process.processName << std::endl;
+        return -1;
+    }
+    pid = fork();
+    if (pid == 0)
+    {
+        // intermediate child process, only async-signal-safe functions from here on
+        close(pipeFds[0]);
+        // unblock signals which got blocked by Poco::Util::ServerApplication
+        sigset_t signals;
+        sigfillset(&signals);
+        sigprocmask(SIG_UNBLOCK, &signals, nullptr);
+        const auto batchPid = fork();
+        if (batchPid == 0)
+        {
+            execl("/bin/sh", "sh", "-c", s_path.c_str(), (char *) 0);
+            _exit(127);
+        } else if (batchPid > 0)
+        {
+            int status = 0;
+            waitpid(batchPid, &status, 0);
+        }
+        const auto written = write(pipeFds[1], "1", 1);
+        _exit(written == 1 ? 0 : 1);
+    }
+    close(pipeFds[1]);
+    if (pid == -1)
+    {
+        std::cout << "Fork failed" << std::endl;
+        close(pipeFds[0]);
+        return -1;
+    }
+    return pipeFds[0];
+}
+
 void AsyncSystemStarter::waitForProcessStarted(int readFileDescriptor, std::string processName, int timeOut)
 {
 	if (readFileDescriptor == -1)
@@ -331,31 +617,23 @@ void AsyncSystemStarter::waitForProcessStarted(int readFileDescriptor, std::stri
 		Poco::Thread::sleep(5000);
 		return;
 	}
-	char buffer;
-	// max wait of timeout, if read failed, continue
-	const int runWaitTime = 10;
-	for (int i = 0; i < timeOut/runWaitTime; i++)
+	// max wait of timeout, the pipe gets readable once the process wrote into it or closed it again
+	// as long as the other side is not opened the pipe does not get readable
+	pollfd pollFd{readFileDescriptor, POLLIN, 0};
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{timeOut};
+	int ret = 0;
+	do
 	{
-		const auto ret = read(readFileDescriptor, &buffer, 1);
-		// ret == 0 -> other side not opened
-		// ret == -1 and EAGAIN -> would block without O_NONBLOCK
-		// ret == -1 and not EAGAIN -> other error during read
-		if (ret == 0 || (ret == -1 && errno == EAGAIN))
-		{
-			Poco::Thread::sleep(runWaitTime);
-			continue;
-		} else if (ret == -1)
-		{
-			std::cout <<  "WaitForProcessStarted " << processName << " Failed reading from pipe: " << errno << std::endl;
-			break;
-		}
-		break;
-	}
-	close(readFileDescriptor);
-	if (strncmp(&buffer, "1", 1) != 0)
+		const auto waitTime = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+		ret = poll(&pollFd, 1, std::max(waitTime, std::chrono::milliseconds::rep{0}));
+	} while (ret == -1 && errno == EINTR);
+	if (ret <= 0)
 	{
-		std::cout << "WaitForProcessStarted " << processName << " Read unexpected value from pipe" << std::endl;
+		std::cout << "WaitForProcessStarted " << processName << " timed out" << std::endl;
+		close(readFileDescriptor);
+		return;
 	}
+	readStartNotification(readFileDescriptor, processName);
 }
 
 static char *toCharArray(const std::string &string)
@@ -10,7 +10,9 @@
 
 #include "Poco/Runnable.h"
 #include <stdlib.h>
+#include <sys/types.h>
 
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -88,6 +90,15 @@ namespace Precitec {
                      * Path to give to LD_PRELOAD. LD_PRELOAD is set for weldMasterApplication if not empty.
                      **/
                     std::string ldPreload;
+                    /**
+                     * The name of the config group of this Process, used to reference it in @p dependsOn.
+                     **/
+                    std::string configGroup;
+                    /**
+                     * Config groups of the Processes which need to be started before this Process.
+                     * If not configured, this Process depends on the previous Process in the startup order.
+                     **/
+                    std::vector<std::string> dependsOn;
 				};
 
 				/**
@@ -100,6 +111,16 @@ namespace Precitec {
 				 */
 				void startProcess(const Process &process);
 
+				/**
+				 * Starts all @p processes, a Process is started as soon as all Processes it depends on are started.
+				 * Independent Processes are started concurrently, the start notifications are awaited with epoll.
+				 *
+				 * This blocks the thread till all Processes are started or ran into the @p timeOut.
+				 *
+				 * @returns the time till all Processes are started.
+				 */
+				std::chrono::milliseconds startProcesses(const std::vector<Process> &processes, int timeOut = 60000);
+
 				/**
 				 * Starts the @p process as a weldmaster process.
 				 * Passes @p pipePath as additional argument argument.
@@ -120,6 +141,16 @@ namespace Precitec {
 				 */
 				void startBatch(const Process &process);
 
+				/**
+				 * Starts the given @p process as a batch without waiting for it.
+				 * The batch is run by an intermediate child process, which writes into the returned pipe
+				 * once the batch finished and exits. The intermediate child process is returned in @p pid
+				 * and needs to be waited for.
+				 *
+				 * @returns a file descriptor to the read end of the pipe or @c -1 on error.
+				 */
+				int startBatchAsync(const Process &process, pid_t &pid);
+
 				/**
 				 * Waits for a Process to be started by reading the
 				 * @p readFileDescriptor.
@@ -12,9 +12,11 @@
 #include "Poco/DateTime.h"
 #include "Poco/File.h"
 #include "Poco/Path.h"
+#include "Poco/ThreadPool.h"
 #include "Poco/Util/PropertyFileConfiguration.h"
 
 #include <string.h>
+#include <fstream>
 #include <functional>
 
 #include <unistd.h>
@@ -45,6 +47,11 @@ CPPUNIT_TEST(testWaitTimeout);
 CPPUNIT_TEST(testCreateArguments);
 CPPUNIT_TEST(testCreateArgumentsNoPipe);
 CPPUNIT_TEST(testCreatePipe);
+CPPUNIT_TEST(testDependsOn);
+CPPUNIT_TEST(testStartIndependentProcesses);
+CPPUNIT_TEST(testStartDependentProcesses);
+CPPUNIT_TEST(testStartCyclicDependencies);
+CPPUNIT_TEST(testStartTimeout);
 CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -66,6 +73,11 @@ public:
     void testCreateArguments();
     void testCreateArgumentsNoPipe();
     void testCreatePipe();
+    void testDependsOn();
+    void testStartIndependentProcesses();
+    void testStartDependentProcesses();
+    void testStartCyclicDependencies();
+    void testStartTimeout();
 
 private:
     void testWaitNoFd_helper()
@@ -77,6 +89,12 @@ private:
         waitForProcessStarted(readFd, "test", 5000);
     }
     void createConfig(const std::string &argument);
+    /**
+     * Creates a dummy weldmaster process or batch which needs @p delay seconds to start.
+     * The dummy logs its start and when it is started into the startup log.
+     **/
+    Process createDummyProcess(const std::string &name, const std::string &delay, const std::vector<std::string> &dependsOn, bool batch = false);
+    std::vector<std::string> readStartupLog();
     Poco::Path configDirPath;
     int readFd;
 };
@@ -527,6 +545,168 @@ void AsyncSystemStarterTest::testCreatePipe()
     CPPUNIT_ASSERT_EQUAL(-1, fd);
 }
 
+void AsyncSystemStarterTest::testDependsOn()
+{
+    // this test verifies that the dependencies are read correctly, without configured dependencies a process depends on the previous one
+    Poco::AutoPtr<PropertyFileConfiguration> pConf{new PropertyFileConfiguration()};
+    pConf->setString(std::string("Startup.00"), std::string("Storage"));
+    pConf->setString(std::string("Startup.01"), std::string("Service"));
+    pConf->setString(std::string("Startup.02"), std::string("Analyzer"));
+    pConf->setString(std::string("Startup.03"), std::string("Gui"));
+    pConf->setString(std::string("Storage.Name"), std::string("App_Storage"));
+    pConf->setString(std::string("Service.Name"), std::string("App_Service"));
+    pConf->setString(std::string("Service.DependsOn"), std::string());
+    pConf->setString(std::string("Analyzer.Name"), std::string("App_Analyzer"));
+    pConf->setString(std::string("Analyzer.DependsOn"), std::string("Storage  Service"));
+    pConf->setString(std::string("Gui.Name"), std::string("App_Gui"));
+    pConf->setString(std::string("TerminalApplication.Path"), std::string("/usr/local/bin/sh"));
+
+    Path configFilePath = configDirPath;
+    configFilePath.setFileName("startup.config");
+    pConf->save(configFilePath.toString());
+
+    const auto result = loadConfiguration();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{4}, result.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Storage"), result.at(0).configGroup);
+    CPPUNIT_ASSERT(result.at(0).dependsOn.empty());
+    CPPUNIT_ASSERT_EQUAL(std::string("Service"), result.at(1).configGroup);
+    CPPUNIT_ASSERT(result.at(1).dependsOn.empty());
+    CPPUNIT_ASSERT_EQUAL(std::string("Analyzer"), result.at(2).configGroup);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, result.at(2).dependsOn.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Storage"), result.at(2).dependsOn.at(0));
+    CPPUNIT_ASSERT_EQUAL(std::string("Service"), result.at(2).dependsOn.at(1));
+    CPPUNIT_ASSERT_EQUAL(std::string("Gui"), result.at(3).configGroup);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, result.at(3).dependsOn.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Analyzer"), result.at(3).dependsOn.at(0));
+}
+
+void AsyncSystemStarterTest::testStartIndependentProcesses()
+{
+    // this test verifies that processes without dependencies are started concurrently
+    const std::vector<Process> processes{
+        createDummyProcess("Foo", "1", {}),
+        createDummyProcess("Bar", "1", {}),
+        createDummyProcess("Baz", "1", {}),
+        createDummyProcess("Batch", "1", {}, true)
+    };
+    const auto startupTime = startProcesses(processes, 10000);
+    Poco::ThreadPool::defaultPool().joinAll();
+
+    CPPUNIT_ASSERT(startupTime.count() >= 1000);
+    CPPUNIT_ASSERT(startupTime.count() < 3000);
+    const auto log = readStartupLog();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{8}, log.size());
+    CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t{4}, std::count_if(log.begin(), log.end(), [] (const auto &line) { return line.find(" ready") != std::string::npos; }));
+}
+
+void AsyncSystemStarterTest::testStartDependentProcesses()
+{
+    // this test verifies that a process is started once all its dependencies are started
+    const std::vector<Process> processes{
+        createDummyProcess("Analyzer", "0.1", {"Storage", "Setup"}),
+        createDummyProcess("Storage", "0.5", {"Setup"}),
+        createDummyProcess("Setup", "0.5", {}, true),
+        createDummyProcess("Service", "0.1", {"Unknown"})
+    };
+    const auto startupTime = startProcesses(processes, 10000);
+    Poco::ThreadPool::defaultPool().joinAll();
+
+    CPPUNIT_ASSERT(startupTime.count() >= 1100);
+    const auto log = readStartupLog();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{8}, log.size());
+    const auto position = [&log] (const std::string &line) { return std::distance(log.begin(), std::find(log.begin(), log.end(), line)); };
+    CPPUNIT_ASSERT(position("Setup ready") < position("Storage started"));
+    CPPUNIT_ASSERT(position("Storage ready") < position("Analyzer started"));
+    CPPUNIT_ASSERT(position("Analyzer ready") < std::ptrdiff_t(log.size()));
+    // the unknown dependency is ignored
+    CPPUNIT_ASSERT(position("Service started") < position("Setup ready"));
+}
+
+void AsyncSystemStarterTest::testStartCyclicDependencies()
+{
+    // this test verifies that processes with cyclic dependencies are started anyway
+    const std::vector<Process> processes{
+        createDummyProcess("Foo", "0.1", {"Bar"}),
+        createDummyProcess("Bar", "0.1", {"Foo"}),
+        createDummyProcess("Baz", "0.1", {"Bar"})
+    };
+    startProcesses(processes, 10000);
+    Poco::ThreadPool::defaultPool().joinAll();
+
+    const auto log = readStartupLog();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{6}, log.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Foo started"), log.front());
+    CPPUNIT_ASSERT_EQUAL(std::string("Baz ready"), log.back());
+}
+
+void AsyncSystemStarterTest::testStartTimeout()
+{
+    // this test verifies that a process which doesn't notify doesn't block the startup longer than the timeout
+    auto process = createDummyProcess("Foo", "2", {});
+    // the dummy doesn't notify
+    std::ofstream script{configDirPath.parent().toString() + "bin/Foo"};
+    script << "#!/bin/sh\nsleep 2\n";
+    script.close();
+    const std::vector<Process> processes{process, createDummyProcess("Bar", "0.1", {"Foo"})};
+
+    const auto startupTime = startProcesses(processes, 1000);
+    Poco::ThreadPool::defaultPool().joinAll();
+
+    CPPUNIT_ASSERT(startupTime.count() >= 1000);
+    CPPUNIT_ASSERT(startupTime.count() < 2000);
+    const auto log = readStartupLog();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, log.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Bar ready"), log.back());
+}
+
+AsyncSystemStarterTest::Process AsyncSystemStarterTest::createDummyProcess(const std::string &name, const std::string &delay, const std::vector<std::string> &dependsOn, bool batch)
+{
+    // WM_BASE_DIR is the parent of the config dir, the named pipes are created there as well
+    const Path baseDirPath = configDirPath.parent();
+    setenv("XDG_RUNTIME_DIR", baseDirPath.toString().c_str(), 1);
+    setenv("WM_STATION_NAME", "test", 1);
+    for (const auto &directory : {std::string("wmpipes/test/"), std::string("bin/"), std::string("batch/")})
+    {
+        File(baseDirPath.toString() + directory).createDirectories();
+    }
+
+    const std::string scriptPath = baseDirPath.toString() + (batch ? "batch/" : "bin/") + name;
+    std::ofstream script{scriptPath};
+    script << "#!/bin/sh\n";
+    script << "echo \"" << name << " started\" >> " << baseDirPath.toString() << "startup.log\n";
+    script << "sleep " << delay << "\n";
+    script << "echo \"" << name << " ready\" >> " << baseDirPath.toString() << "startup.log\n";
+    if (!batch)
+    {
+        // first argument is -pipePath
+        script << "printf 1 > \"$2\"\n";
+    }
+    script.close();
+    File(scriptPath).setExecutable(true);
+
+    Process process;
+    process.processName = name;
+    process.configGroup = name;
+    process.dependsOn = dependsOn;
+    process.batch = batch;
+    process.weldMasterApplication = true;
+    process.useTerminal = false;
+    process.enabled = true;
+    process.autoRestart = false;
+    return process;
+}
+
+std::vector<std::string> AsyncSystemStarterTest::readStartupLog()
+{
+    std::ifstream log{configDirPath.parent().toString() + "startup.log"};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(log, line);)
+    {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
 void AsyncSystemStarterTest::createConfig(const std::string &argument)
 {
     Poco::AutoPtr<PropertyFileConfiguration> pConf{new PropertyFileConfiguration()};
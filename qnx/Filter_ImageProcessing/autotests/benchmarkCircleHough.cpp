@@ -0,0 +1,103 @@
+#include <QTest>
+
+#include "../circleFitImpl.h"
+#include "houghTestImages.h"
+
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+using namespace precitec::filter;
+
+class BenchmarkCircleHough : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkCircleHough_data();
+    void benchmarkCircleHough();
+};
+
+namespace
+{
+
+/**
+* Binary edge image like the input of the circle hough filter: a ring of the given width (pore),
+* or a disc with a ring around it (spot weld), plus isolated noise pixels.
+*/
+BImage createImage(Size size, double radius, int edgeWidth, bool spotWeld, int numNoisePixels)
+{
+    BImage image;
+    image.resizeFill(size, 0);
+    const double centerX = size.width * 0.45;
+    const double centerY = size.height * 0.55;
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int x = 0; x < size.width; x++)
+        {
+            const double distance = std::hypot(x - centerX, y - centerY);
+            const bool onEdge = distance >= radius - edgeWidth * 0.5 && distance < radius + edgeWidth * 0.5;
+            const bool inNugget = spotWeld && distance < radius * 0.3;
+            if (onEdge || inNugget)
+            {
+                image[y][x] = 255;
+            }
+        }
+    }
+    HoughTestImage::addNoise(image, numNoisePixels);
+    return image;
+}
+
+}
+
+void BenchmarkCircleHough::benchmarkCircleHough_data()
+{
+    QTest::addColumn<double>("radius");
+    QTest::addColumn<double>("radiusStart");
+    QTest::addColumn<double>("radiusEnd");
+    QTest::addColumn<bool>("spotWeld");
+    QTest::addColumn<int>("numNoisePixels");
+
+    for (int numNoisePixels : {0, 400})
+    {
+        QTest::newRow(qPrintable(QStringLiteral("pore r 12, 5 - 25, noise %1").arg(numNoisePixels))) << 12.0 << 5.0 << 25.0 << false << numNoisePixels;
+        QTest::newRow(qPrintable(QStringLiteral("pore r 30, 20 - 40, noise %1").arg(numNoisePixels))) << 30.0 << 20.0 << 40.0 << false << numNoisePixels;
+        QTest::newRow(qPrintable(QStringLiteral("spot weld r 50, 40 - 60, noise %1").arg(numNoisePixels))) << 50.0 << 40.0 << 60.0 << true << numNoisePixels;
+        QTest::newRow(qPrintable(QStringLiteral("spot weld r 100, 80 - 120, noise %1").arg(numNoisePixels))) << 100.0 << 80.0 << 120.0 << true << numNoisePixels;
+    }
+}
+
+void BenchmarkCircleHough::benchmarkCircleHough()
+{
+    QFETCH(double, radius);
+    QFETCH(double, radiusStart);
+    QFETCH(double, radiusEnd);
+    QFETCH(bool, spotWeld);
+    QFETCH(int, numNoisePixels);
+
+    const auto image = createImage(Size{int(radius * 4), int(radius * 4)}, radius, 2, spotWeld, numNoisePixels);
+
+    CircleHoughParameters parameters;
+    parameters.m_oRadiusStart = radiusStart;
+    parameters.m_oRadiusEnd = radiusEnd;
+    parameters.m_oRadiusStep = 1.0;
+    parameters.m_oNumberMax = 1;
+    parameters.m_oCoarse = true;
+    parameters.m_oScoreType = CircleHoughParameters::ScoreType::Accumulator;
+    parameters.m_oConnectedArcToleranceDegrees = 1.0;
+
+    CircleHoughImpl circleHough;
+    std::vector<hough_circle_t> result;
+    QBENCHMARK
+    {
+        result = circleHough.DoCircleHough(image, 100, SearchType::OnlyCenterInsideROI, parameters);
+    }
+    // one candidate for each radius, the best one is the circle
+    QVERIFY(!result.empty());
+    const auto best = std::max_element(result.begin(), result.end(), [] (const hough_circle_t & a, const hough_circle_t & b)
+        {
+            return a.second < b.second;
+        });
+    // the radius step is increased for large radius ranges
+    QVERIFY(std::abs(best->first.m_radius - radius) <= 2.0);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkCircleHough)
+#include "benchmarkCircleHough.moc"
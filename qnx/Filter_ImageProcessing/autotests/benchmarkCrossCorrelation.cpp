@@ -0,0 +1,87 @@
+#include <QTest>
+
+#include "../crossCorrelationImpl.h"
+#include "../crossCorrelationFFT.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::image::DImage;
+using precitec::geo2d::Size;
+using namespace precitec::filter::crosscorrelation;
+
+class BenchmarkCrossCorrelation : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkCorrelation_data();
+    void benchmarkCorrelation();
+
+private:
+    BImage m_image;
+};
+
+void BenchmarkCrossCorrelation::initTestCase()
+{
+    std::mt19937 generator{42};
+    m_image.resize(Size{1024, 512});
+    for (int y = 0; y < m_image.height(); y++)
+    {
+        for (int x = 0; x < m_image.width(); x++)
+        {
+            m_image[y][x] = generator() % 256;
+        }
+    }
+}
+
+void BenchmarkCrossCorrelation::benchmarkCorrelation_data()
+{
+    QTest::addColumn<int>("templateSize");
+    QTest::addColumn<QString>("method");
+
+    // the crossover between spatial and frequency domain is at a template size of about 5 to 7
+    for (int templateSize : {3, 5, 7, 9, 15, 25, 41, 65})
+    {
+        for (const auto method : {QStringLiteral("spatial"), QStringLiteral("frequency"), QStringLiteral("automatic")})
+        {
+            QTest::newRow(qPrintable(QStringLiteral("%1x%1 %2").arg(templateSize).arg(method))) << templateSize << method;
+        }
+    }
+}
+
+void BenchmarkCrossCorrelation::benchmarkCorrelation()
+{
+    QFETCH(int, templateSize);
+    QFETCH(QString, method);
+
+    DImage kernel;
+    kernel.resizeFill(Size{templateSize, templateSize}, 1.0 / (templateSize * templateSize));
+    const DImage noKernel;
+
+    const auto cost = estimateCorrelationCost(m_image.size(), kernel.size(), false, true);
+    qInfo("estimated cost: spatial %.3g, frequency domain %.3g", cost.m_oSpatial, cost.m_oFrequencyDomain);
+
+    // the kernel spectrum is computed before the measurement, like for all but the first image of a series
+    FrequencyDomainCorrelation frequencyDomain;
+    DImage result;
+    frequencyDomain.calcCorrelation(m_image, kernel, noKernel, result);
+
+    const bool frequency = method == QStringLiteral("frequency")
+        || (method == QStringLiteral("automatic") && useFrequencyDomain(m_image.size(), kernel.size(), false, true));
+    QBENCHMARK
+    {
+        if (frequency)
+        {
+            frequencyDomain.calcCorrelation(m_image, kernel, noKernel, result);
+        }
+        else
+        {
+            calcConvolution(m_image, kernel, result);
+        }
+    }
+    QCOMPARE(result.size(), Size(m_image.width() - templateSize + 1, m_image.height() - templateSize + 1));
+}
+
+QTEST_GUILESS_MAIN(BenchmarkCrossCorrelation)
+#include "benchmarkCrossCorrelation.moc"
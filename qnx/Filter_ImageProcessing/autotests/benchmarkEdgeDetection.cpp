@@ -0,0 +1,126 @@
+#include <QTest>
+
+#include "../edgeDetectionImpl.h"
+#include "../convolution3X3.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+using namespace precitec::filter;
+
+class BenchmarkEdgeDetection : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkEdgeOperator_data();
+    void benchmarkEdgeOperator();
+    void benchmarkConvolution3X3_data();
+    void benchmarkConvolution3X3();
+};
+
+namespace
+{
+
+BImage createImage(Size size)
+{
+    std::mt19937 generator{11};
+    BImage image;
+    image.resize(size);
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int x = 0; x < size.width; x++)
+        {
+            image[y][x] = (x / 8 + y / 4 + generator() % 16) % 256;
+        }
+    }
+    return image;
+}
+
+}
+
+void BenchmarkEdgeDetection::benchmarkEdgeOperator_data()
+{
+    QTest::addColumn<int>("edgeOperator");
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    for (const auto size : {Size{400, 400}, Size{1024, 1024}})
+    {
+        for (int mode : {0, 1})
+        {
+            const auto suffix = QStringLiteral("%1x%2, mode %3").arg(size.width).arg(size.height).arg(mode);
+            QTest::newRow(qPrintable(QStringLiteral("sobel ") + suffix)) << int(eSobel) << mode << size.width << size.height;
+            QTest::newRow(qPrintable(QStringLiteral("kirsch ") + suffix)) << int(eKirsch) << mode << size.width << size.height;
+        }
+    }
+}
+
+void BenchmarkEdgeDetection::benchmarkEdgeOperator()
+{
+    QFETCH(int, edgeOperator);
+    QFETCH(int, mode);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    const Size size{width, height};
+
+    const auto image = createImage(size);
+    BImage imageOut;
+    imageOut.resize(size);
+    QBENCHMARK
+    {
+        if (edgeOperator == eSobel)
+        {
+            sobel(image, imageOut, mode);
+        }
+        else
+        {
+            kirsch(image, imageOut, mode);
+        }
+    }
+}
+
+void BenchmarkEdgeDetection::benchmarkConvolution3X3_data()
+{
+    QTest::addColumn<bool>("largeCoefficients");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    for (const auto size : {Size{400, 400}, Size{1024, 1024}})
+    {
+        const auto suffix = QStringLiteral("%1x%2").arg(size.width).arg(size.height);
+        QTest::newRow(qPrintable(QStringLiteral("laplace ") + suffix)) << false << size.width << size.height;
+        QTest::newRow(qPrintable(QStringLiteral("large coefficients ") + suffix)) << true << size.width << size.height;
+    }
+}
+
+void BenchmarkEdgeDetection::benchmarkConvolution3X3()
+{
+    QFETCH(bool, largeCoefficients);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    const Size size{width, height};
+
+    Convolution3X3::FilterCoeff coefficients;
+    coefficients.m_oCoeff1 = 0;
+    coefficients.m_oCoeff2 = -1;
+    coefficients.m_oCoeff3 = 0;
+    coefficients.m_oCoeff4 = -1;
+    coefficients.m_oCoeff5 = largeCoefficients ? 400 : 4;
+    coefficients.m_oCoeff6 = -1;
+    coefficients.m_oCoeff7 = 0;
+    coefficients.m_oCoeff8 = -1;
+    coefficients.m_oCoeff9 = 0;
+
+    const auto image = createImage(size);
+    BImage imageOut;
+    imageOut.resize(size);
+    QBENCHMARK
+    {
+        Convolution3X3::calcConvolution3X3(image, coefficients, imageOut);
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkEdgeDetection)
+#include "benchmarkEdgeDetection.moc"
@@ -0,0 +1,96 @@
+#include <QTest>
+
+#include "../houghVoting.h"
+#include "houghTestImages.h"
+
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+using precitec::filter::angle2index;
+using namespace precitec::filter::houghvoting;
+using namespace HoughTestImage;
+
+class BenchmarkLineHough : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkAllAngles_data();
+    void benchmarkAllAngles();
+    void benchmarkLineVoting_data();
+    void benchmarkLineVoting();
+};
+
+namespace
+{
+
+void addRows()
+{
+    QTest::addColumn<int>("minAngle");
+    QTest::addColumn<int>("maxAngle");
+    QTest::addColumn<int>("numNoisePixels");
+
+    // the roi of a seam, the default angle range of the filter and a search for lines in all directions
+    for (int numNoisePixels : {0, 2000})
+    {
+        QTest::newRow(qPrintable(QStringLiteral("-10 - 10, noise %1").arg(numNoisePixels))) << -10 << 10 << numNoisePixels;
+        QTest::newRow(qPrintable(QStringLiteral("-90 - 90, noise %1").arg(numNoisePixels))) << -90 << 90 << numNoisePixels;
+    }
+}
+
+BImage createImage(int numNoisePixels)
+{
+    return createSeam(Size{512, 512}, 200, 300, 3.0, numNoisePixels);
+}
+
+}
+
+void BenchmarkLineHough::benchmarkAllAngles_data()
+{
+    addRows();
+}
+
+void BenchmarkLineHough::benchmarkAllAngles()
+{
+    // the previous voting of the Hough filter: every pixel votes for all angles on the calling thread
+    QFETCH(int, minAngle);
+    QFETCH(int, maxAngle);
+    QFETCH(int, numNoisePixels);
+
+    const auto image = createImage(numNoisePixels);
+    const int angleMinInd = angle2index<g_oNumLineAngles>(minAngle * M_PI / 180.0);
+    const int angleMaxInd = angle2index<g_oNumLineAngles>(maxAngle * M_PI / 180.0);
+    std::vector<int> histogram;
+    QBENCHMARK
+    {
+        histogram.assign(lineHoughSize(image, angleMinInd, angleMaxInd), 0);
+        voteAllAngles(image, angleMinInd, angleMaxInd, histogram);
+    }
+    QVERIFY(*std::max_element(histogram.begin(), histogram.end()) >= image.height() / 2);
+}
+
+void BenchmarkLineHough::benchmarkLineVoting_data()
+{
+    addRows();
+}
+
+void BenchmarkLineHough::benchmarkLineVoting()
+{
+    QFETCH(int, minAngle);
+    QFETCH(int, maxAngle);
+    QFETCH(int, numNoisePixels);
+
+    const auto image = createImage(numNoisePixels);
+    const int angleMinInd = angle2index<g_oNumLineAngles>(minAngle * M_PI / 180.0);
+    const int angleMaxInd = angle2index<g_oNumLineAngles>(maxAngle * M_PI / 180.0);
+    LineVoting voting;
+    std::vector<int> histogram;
+    std::vector<unsigned int> touchedBlocks;
+    QBENCHMARK
+    {
+        histogram.assign(lineHoughSize(image, angleMinInd, angleMaxInd), 0);
+        voting.accumulate(image, angleMinInd, angleMaxInd, histogram, touchedBlocks);
+    }
+    QVERIFY(*std::max_element(histogram.begin(), histogram.end()) >= image.height() / 2);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkLineHough)
+#include "benchmarkLineHough.moc"
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../houghVoting.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+/**
+* Binary edge images like the input of the hough filters and the line hough space as it was filled before the orientation was used.
+* Shared by testHoughVoting and the hough benchmarks.
+*/
+namespace HoughTestImage
+{
+
+using precitec::image::BImage;
+using precitec::geo2d::Size;
+
+inline void addNoise(BImage & image, int numNoisePixels)
+{
+    std::mt19937 generator{7};
+    for (int i = 0; i < numNoisePixels; i++)
+    {
+        image[generator() % image.height()][generator() % image.width()] = 255;
+    }
+}
+
+/**
+* The two edges of a seam, 2 pixels wide, tilted by the given angle against the vertical.
+*/
+inline BImage createSeam(Size size, int leftEdge, int rightEdge, double tiltDegrees, int numNoisePixels)
+{
+    BImage image;
+    image.resizeFill(size, 0);
+    const double slope = std::tan(tiltDegrees * M_PI / 180.0);
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int edge : {leftEdge, rightEdge})
+        {
+            const int x = edge + std::round(slope * (y - size.height / 2));
+            if (x >= 0 && x + 1 < size.width)
+            {
+                image[y][x] = 255;
+                image[y][x + 1] = 255;
+            }
+        }
+    }
+    addNoise(image, numNoisePixels);
+    return image;
+}
+
+/**
+* Number of cells of the line hough space of the image, see Hough::calcHough.
+*/
+inline std::size_t lineHoughSize(const BImage & image, int angleMinInd, int angleMaxInd)
+{
+    const int halfHeight = precitec::filter::roundToT<int>(image.height() / 2.);
+    const int numRadii = std::ceil(std::sqrt(image.width() * image.width() + halfHeight * halfHeight));
+    return std::size_t(numRadii) * (angleMaxInd - angleMinInd + 1);
+}
+
+/**
+* The line hough space as it was filled before the orientation was used: every non-zero pixel votes for all angles.
+*/
+inline void voteAllAngles(const BImage & image, int angleMinInd, int angleMaxInd, std::vector<int> & histogram)
+{
+    const auto & lookup = precitec::filter::houghvoting::lineAngleLookup();
+    const int halfHeight = precitec::filter::roundToT<int>(image.height() / 2.);
+    const int histAngleSize = angleMaxInd - angleMinInd + 1;
+    for (int y = 0; y < image.height(); y++)
+    {
+        for (int x = 0; x < image.width(); x++)
+        {
+            if (image[y][x] == 0)
+            {
+                continue;
+            }
+            for (int angleInd = angleMinInd; angleInd < angleMaxInd; angleInd++)
+            {
+                const int radius = precitec::filter::roundToT<int>(std::abs(x * lookup.m_oCos[angleInd] + (y - halfHeight) * lookup.m_oSin[angleInd]));
+                histogram[radius * histAngleSize + angleInd - angleMinInd]++;
+            }
+        }
+    }
+}
+
+}
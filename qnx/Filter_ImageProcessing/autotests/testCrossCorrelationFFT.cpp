@@ -0,0 +1,216 @@
+#include <QTest>
+
+#include "../crossCorrelationImpl.h"
+#include "../crossCorrelationFFT.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::image::DImage;
+using precitec::geo2d::Size;
+using namespace precitec::filter::crosscorrelation;
+
+Q_DECLARE_METATYPE(precitec::geo2d::Size)
+
+class TestCrossCorrelationFFT : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCorrelation_data();
+    void testCorrelation();
+    void testKernelCache();
+    void testComputeResultImage();
+    void testCostModel();
+};
+
+namespace
+{
+
+BImage createImage(Size size, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    BImage image{size};
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int x = 0; x < size.width; x++)
+        {
+            image[y][x] = generator() % 256;
+        }
+    }
+    return image;
+}
+
+DImage createKernel(Size size, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+    DImage kernel{size};
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int x = 0; x < size.width; x++)
+        {
+            kernel[y][x] = distribution(generator);
+        }
+    }
+    return kernel;
+}
+
+double absoluteSum(const DImage& kernel)
+{
+    double sum = 0.0;
+    kernel.for_each([&sum] (double value) { sum += std::abs(value); });
+    return sum;
+}
+
+double maxDifference(const DImage& a, const DImage& b)
+{
+    double difference = 0.0;
+    for (int y = 0; y < a.height(); y++)
+    {
+        for (int x = 0; x < a.width(); x++)
+        {
+            difference = std::max(difference, std::abs(a[y][x] - b[y][x]));
+        }
+    }
+    return difference;
+}
+
+}
+
+void TestCrossCorrelationFFT::testCorrelation_data()
+{
+    QTest::addColumn<Size>("imageSize");
+    QTest::addColumn<Size>("kernelSize");
+    QTest::addColumn<bool>("separable");
+
+    QTest::newRow("1x1") << Size{64, 48} << Size{1, 1} << false;
+    QTest::newRow("5x7") << Size{131, 100} << Size{5, 7} << false;
+    QTest::newRow("25x25") << Size{400, 300} << Size{25, 25} << false;
+    QTest::newRow("kernel size of image") << Size{41, 37} << Size{41, 37} << false;
+    QTest::newRow("single column") << Size{41, 37} << Size{1, 37} << false;
+    QTest::newRow("separable 9x5") << Size{200, 150} << Size{9, 5} << true;
+}
+
+void TestCrossCorrelationFFT::testCorrelation()
+{
+    QFETCH(Size, imageSize);
+    QFETCH(Size, kernelSize);
+    QFETCH(bool, separable);
+
+    const auto image = createImage(imageSize, 1);
+    DImage kernel1;
+    DImage kernel2;
+    DImage expected;
+    double kernelAbsoluteSum = 0.0;
+    if (separable)
+    {
+        kernel1 = createKernel(Size{kernelSize.width, 1}, 2);
+        kernel2 = createKernel(Size{1, kernelSize.height}, 3);
+        DImage horizontal;
+        calcConvolution(image, kernel1, horizontal);
+        calcConvolution(horizontal, kernel2, expected);
+        kernelAbsoluteSum = absoluteSum(kernel1) * absoluteSum(kernel2);
+    }
+    else
+    {
+        kernel1 = createKernel(kernelSize, 2);
+        calcConvolution(image, kernel1, expected);
+        kernelAbsoluteSum = absoluteSum(kernel1);
+    }
+
+    FrequencyDomainCorrelation frequencyDomain;
+    DImage result;
+    frequencyDomain.calcCorrelation(image, kernel1, kernel2, result);
+    QCOMPARE(result.size(), expected.size());
+    QVERIFY(maxDifference(result, expected) <= 1e-12 * kernelAbsoluteSum * 255);
+}
+
+void TestCrossCorrelationFFT::testKernelCache()
+{
+    const auto image = createImage(Size{120, 80}, 4);
+    auto kernel = createKernel(Size{15, 11}, 5);
+
+    FrequencyDomainCorrelation frequencyDomain;
+    QVERIFY(!frequencyDomain.hasKernelSpectrum(kernel, DImage{}, image.size()));
+
+    DImage result;
+    frequencyDomain.calcCorrelation(image, kernel, DImage{}, result);
+    QVERIFY(frequencyDomain.hasKernelSpectrum(kernel, DImage{}, image.size()));
+    // the padded size of a slightly smaller image is the same
+    QVERIFY(frequencyDomain.hasKernelSpectrum(kernel, DImage{}, Size{119, 80}));
+    QVERIFY(!frequencyDomain.hasKernelSpectrum(kernel, DImage{}, Size{240, 80}));
+
+    // a changed kernel value requires a new spectrum
+    kernel[3][4] += 0.5;
+    QVERIFY(!frequencyDomain.hasKernelSpectrum(kernel, DImage{}, image.size()));
+    frequencyDomain.calcCorrelation(image, kernel, DImage{}, result);
+    QVERIFY(frequencyDomain.hasKernelSpectrum(kernel, DImage{}, image.size()));
+
+    DImage expected;
+    calcConvolution(image, kernel, expected);
+    QVERIFY(maxDifference(result, expected) <= 1e-12 * absoluteSum(kernel) * 255);
+
+    // a smaller image after a larger one, the padding must not contain the previous image
+    const auto smallImage = createImage(Size{60, 40}, 6);
+    frequencyDomain.calcCorrelation(smallImage, kernel, DImage{}, result);
+    calcConvolution(smallImage, kernel, expected);
+    QCOMPARE(result.size(), expected.size());
+    QVERIFY(maxDifference(result, expected) <= 1e-12 * absoluteSum(kernel) * 255);
+}
+
+void TestCrossCorrelationFFT::testComputeResultImage()
+{
+    // normalized cross correlation with a large template, computed in the frequency domain
+    const auto image = createImage(Size{320, 240}, 7);
+    DImage kernel;
+    kernel.resizeFill(Size{41, 41}, 1.0);
+    const double kernelRootSquaredSum = 41.0;
+    QVERIFY(useFrequencyDomain(image.size(), kernel.size(), false, false));
+
+    BImage output;
+    precitec::math::DescriptiveStats stats{0.0, 1.0, 5};
+    precitec::image::TLineImage<int> integralImage;
+    FrequencyDomainCorrelation frequencyDomain;
+    computeResultImage<byte, double, byte, true>(output, stats, image, kernel, DImage{}, kernel.size(), kernelRootSquaredSum,
+        false, false, 0, 255, integralImage, frequencyDomain);
+    QVERIFY(frequencyDomain.hasKernelSpectrum(kernel, DImage{}, image.size()));
+
+    DImage correlation;
+    calcConvolution(image, kernel, correlation);
+    QCOMPARE(output.size(), correlation.size());
+    for (int y = 0; y < output.height(); y++)
+    {
+        for (int x = 0; x < output.width(); x++)
+        {
+            double squareSum = 0.0;
+            for (int j = 0; j < 41; j++)
+            {
+                for (int i = 0; i < 41; i++)
+                {
+                    squareSum += double(image[y + j][x + i]) * image[y + j][x + i];
+                }
+            }
+            const double value = correlation[y][x] / (kernelRootSquaredSum * std::sqrt(squareSum));
+            const int expected = value < 1.0 ? int(255 * value) : 255;
+            // the rounding errors of the transform may change the result at a quantization step
+            QVERIFY(std::abs(int(output[y][x]) - expected) <= 1);
+        }
+    }
+}
+
+void TestCrossCorrelationFFT::testCostModel()
+{
+    QVERIFY(!useFrequencyDomain(Size{1024, 512}, Size{3, 3}, false, true));
+    QVERIFY(useFrequencyDomain(Size{1024, 512}, Size{25, 25}, false, false));
+    QVERIFY(!useFrequencyDomain(Size{1024, 512}, Size{9, 9}, true, true));
+    // the template does not fit into the image
+    QVERIFY(!useFrequencyDomain(Size{10, 10}, Size{25, 25}, false, false));
+
+    const auto uncached = estimateCorrelationCost(Size{1024, 512}, Size{15, 15}, false, false);
+    const auto cached = estimateCorrelationCost(Size{1024, 512}, Size{15, 15}, false, true);
+    QCOMPARE(cached.m_oSpatial, uncached.m_oSpatial);
+    QVERIFY(cached.m_oFrequencyDomain < uncached.m_oFrequencyDomain);
+}
+
+QTEST_GUILESS_MAIN(TestCrossCorrelationFFT)
+#include "testCrossCorrelationFFT.moc"
@@ -3,6 +3,9 @@
 #include "../edgeDetectionImpl.h"
 #include "image/image.h"
 
+#include <limits>
+#include <random>
+
 namespace precitec
 {
 namespace filter
@@ -15,8 +18,48 @@ private Q_SLOTS:
     void testRobertsBorder();
     void testKirschBorder();
     void testSobelBorder();
+    void testAgainstReference_data();
+    void testAgainstReference();
 };
 
+namespace
+{
+
+image::BImage createImage(int width, int height, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    image::BImage image;
+    image.resize(geo2d::Size(width, height));
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            // smooth gradient with some noise and a few saturated pixels
+            image[y][x] = generator() % 20 == 0 ? 255 : (x + 2 * y + generator() % 30) % 256;
+        }
+    }
+    return image;
+}
+
+// straightforward per pixel implementation of sobel (|Gx| + |Gy|) and kirsch (maximum of the four masks)
+int referenceGradient(const image::BImage &image, int x, int y, bool kirsch)
+{
+    auto p = [&image, x, y] (int dx, int dy) { return int(image[y + dy][x + dx]); };
+    if (!kirsch)
+    {
+        const int gx = std::abs(p(-1, -1) - p(1, -1) + 2 * p(-1, 0) - 2 * p(1, 0) + p(-1, 1) - p(1, 1));
+        const int gy = std::abs(p(-1, -1) + 2 * p(0, -1) + p(1, -1) - p(-1, 1) - 2 * p(0, 1) - p(1, 1));
+        return gx + gy;
+    }
+    const int g0 = std::abs(-p(-1, -1) + p(1, -1) - 2 * p(-1, 0) + 2 * p(1, 0) - p(-1, 1) + p(1, 1));
+    const int g1 = std::abs(-2 * p(-1, -1) - p(0, -1) - p(-1, 0) + p(1, 0) + p(0, 1) + 2 * p(1, 1));
+    const int g2 = std::abs(-p(-1, -1) - 2 * p(0, -1) - p(1, -1) + p(-1, 1) + 2 * p(0, 1) + p(1, 1));
+    const int g3 = std::abs(-p(0, -1) - 2 * p(1, -1) + p(-1, 0) - p(1, 0) + 2 * p(-1, 1) + p(0, 1));
+    return std::max(std::max(g0, g1), std::max(g2, g3));
+}
+
+}
+
 void TestEdgeDetection::testRobertsBorder()
 {
     const auto height = 1536u;
@@ -97,6 +140,71 @@ void TestEdgeDetection::testSobelBorder()
     }
 }
 
+void TestEdgeDetection::testAgainstReference_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<bool>("kirsch");
+    QTest::addColumn<int>("mode");
+
+    // the widths cover images without vectorized part, with and without remainder
+    for (int width : {3, 17, 18, 33, 100})
+    {
+        for (int mode : {0, 1})
+        {
+            QTest::newRow(qPrintable(QStringLiteral("sobel, width %1, mode %2").arg(width).arg(mode))) << width << 20 << false << mode;
+            QTest::newRow(qPrintable(QStringLiteral("kirsch, width %1, mode %2").arg(width).arg(mode))) << width << 20 << true << mode;
+        }
+    }
+}
+
+void TestEdgeDetection::testAgainstReference()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(bool, kirsch);
+    QFETCH(int, mode);
+
+    const auto image = createImage(width, height, width);
+    image::BImage imageOut;
+    imageOut.resizeFill(image.size(), 17);
+    if (kirsch)
+    {
+        filter::kirsch(image, imageOut, mode);
+    }
+    else
+    {
+        filter::sobel(image, imageOut, mode);
+    }
+
+    int min = std::numeric_limits<int>::max();
+    int max = std::numeric_limits<int>::min();
+    for (int y = 1; y < height - 1; y++)
+    {
+        for (int x = 1; x < width - 1; x++)
+        {
+            min = std::min(min, referenceGradient(image, x, y, kirsch));
+            max = std::max(max, referenceGradient(image, x, y, kirsch));
+        }
+    }
+    QVERIFY(max > min);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (y == 0 || y == height - 1 || x == 0 || x == width - 1)
+            {
+                QCOMPARE(int(imageOut[y][x]), 0);
+                continue;
+            }
+            const int gradient = referenceGradient(image, x, y, kirsch);
+            const int expected = mode > 0 ? byte((255.0 / (max - min)) * (gradient - min)) : std::min(gradient, 255);
+            QCOMPARE(int(imageOut[y][x]), expected);
+        }
+    }
+}
+
 } //namespace filter
 } //namespace precitec
 
@@ -0,0 +1,221 @@
+#include <QTest>
+
+#include "../hough.h"
+#include "houghTestImages.h"
+#include <fliplib/NullSourceFilter.h>
+#include <util/calibDataSingleton.h>
+#include "math/Calibration3DCoordsLoader.h"
+
+#include <fliplib/BaseFilter.h>
+#include <overlay/overlayCanvas.h>
+
+using precitec::geo2d::Size;
+
+class TestHough : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testCtor();
+    void testProceed_data();
+    void testProceed();
+};
+
+struct DummyInput
+{
+    fliplib::NullSourceFilter m_sourceFilter;
+    fliplib::SynchronePipe<precitec::interface::ImageFrame> m_pipeInImage;
+
+    precitec::interface::ImageFrame m_image;
+
+    DummyInput()
+    : m_pipeInImage{&m_sourceFilter, "ImageFrame"}
+    {
+    }
+
+    bool connectToFilter(fliplib::BaseFilter * pFilter)
+    {
+        int group = 0;
+        //connect  pipes
+        return pFilter->connectPipe(&m_pipeInImage, group);
+    }
+
+    void fillData(int imageNumber, const precitec::image::BImage &image)
+    {
+        precitec::interface::SmpTrafo oTrafo{new precitec::interface::LinearTrafo(precitec::geo2d::Point(0, 0))};
+        precitec::interface::ImageContext context{precitec::interface::ImageContext{}, oTrafo};
+        context.setImageNumber(imageNumber);
+        m_image = precitec::interface::ImageFrame{context, image, precitec::interface::ResultType::AnalysisOK};
+    }
+
+    void signal()
+    {
+        m_pipeInImage.signal(m_image);
+    }
+};
+
+class DummyFilter : public fliplib::BaseFilter
+{
+public:
+    DummyFilter() : fliplib::BaseFilter("dummy") {}
+    void proceed(const void *sender, fliplib::PipeEventArgs &e) override
+    {
+        Q_UNUSED(sender)
+        Q_UNUSED(e)
+        preSignalAction();
+        m_proceedCalled = true;
+    }
+    void proceedGroup(const void *sender, fliplib::PipeGroupEventArgs &e) override
+    {
+        Q_UNUSED(sender)
+        Q_UNUSED(e)
+        preSignalAction();
+        m_proceedCalled = true;
+    }
+    int getFilterType() const override
+    {
+        return BaseFilterInterface::SINK;
+    }
+
+    bool isProceedCalled() const
+    {
+        return m_proceedCalled;
+    }
+
+    void resetProceedCalled()
+    {
+        m_proceedCalled = false;
+    }
+
+private:
+    bool m_proceedCalled = false;
+};
+
+void TestHough::initTestCase()
+{
+    // the radius distances are given in mm, the default coax calibration has about 47 pixel per mm
+    precitec::math::Calibration3DCoords coords;
+    QVERIFY(precitec::math::loadCoaxModel(coords, precitec::math::CoaxCalibrationData{}, false));
+    precitec::math::CalibrationParamMap params;
+    auto &calibData = precitec::system::CalibDataSingleton::getCalibrationDataReference(precitec::math::SensorId::eSensorId0);
+    calibData.reload(coords, params);
+    QVERIFY(calibData.hasData());
+}
+
+void TestHough::testCtor()
+{
+    precitec::filter::Hough filter;
+    QCOMPARE(filter.name(), std::string("Hough"));
+    QVERIFY(filter.findPipe("PositionLeft") != nullptr);
+    QVERIFY(filter.findPipe("PositionRight") != nullptr);
+    QVERIFY(filter.findPipe("HoughPPCandidate") != nullptr);
+    QVERIFY(filter.findPipe("NotAValidPipe") == nullptr);
+
+    for (auto entry : std::vector<std::pair<std::string, int>>{{"MinAngle", -90}, {"MaxAngle", 90}, {"SearchStart", 0}})
+    {
+        QVERIFY(filter.getParameters().exists(entry.first));
+        QCOMPARE(filter.getParameters().findParameter(entry.first).getType(), fliplib::Parameter::TYPE_int);
+        QCOMPARE(filter.getParameters().findParameter(entry.first).getValue().convert<int>(), entry.second);
+    }
+}
+
+void TestHough::testProceed_data()
+{
+    QTest::addColumn<int>("minAngle");
+    QTest::addColumn<int>("maxAngle");
+    QTest::addColumn<double>("minLineLength");
+    QTest::addColumn<int>("searchStart");
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<int>("numNoisePixels");
+
+    // a min line length selects the maxima search over the cells with votes of houghvoting::LineVoting, 0 the search over the whole hough space
+    for (double minLineLength : {0.0, 50.0})
+    {
+        for (int searchStart : {0, 1})
+        {
+            for (int numNoisePixels : {0, 500})
+            {
+                const char *direction = searchStart == 0 ? "left" : "right";
+                QTest::addRow("vertical, length %.0f, %s, noise %d", minLineLength, direction, numNoisePixels) << -10 << 10 << minLineLength << searchStart << 0.0 << numNoisePixels;
+                QTest::addRow("tilted, length %.0f, %s, noise %d", minLineLength, direction, numNoisePixels) << -10 << 10 << minLineLength << searchStart << 3.0 << numNoisePixels;
+                QTest::addRow("all angles, length %.0f, %s, noise %d", minLineLength, direction, numNoisePixels) << -90 << 90 << minLineLength << searchStart << 3.0 << numNoisePixels;
+            }
+        }
+    }
+}
+
+void TestHough::testProceed()
+{
+    precitec::filter::Hough filter;
+
+    std::unique_ptr<precitec::image::OverlayCanvas> canvas{new precitec::image::OverlayCanvas};
+    filter.setCanvas(canvas.get());
+
+    DummyInput dummyInput;
+    QVERIFY(dummyInput.connectToFilter(&filter));
+
+    auto outPipeLeft = dynamic_cast<fliplib::SynchronePipe<precitec::interface::GeoDoublearray>*>(filter.findPipe("PositionLeft"));
+    QVERIFY(outPipeLeft);
+    auto outPipeRight = dynamic_cast<fliplib::SynchronePipe<precitec::interface::GeoDoublearray>*>(filter.findPipe("PositionRight"));
+    QVERIFY(outPipeRight);
+    auto outPipeCandidate = dynamic_cast<fliplib::SynchronePipe<precitec::interface::GeoHoughPPCandidatearray>*>(filter.findPipe("HoughPPCandidate"));
+    QVERIFY(outPipeCandidate);
+
+    DummyFilter dummyFilter;
+    QVERIFY(dummyFilter.connectPipe(outPipeLeft, 0));
+    QVERIFY(dummyFilter.connectPipe(outPipeRight, 0));
+    QVERIFY(dummyFilter.connectPipe(outPipeCandidate, 0));
+
+    QFETCH(int, minAngle);
+    QFETCH(int, maxAngle);
+    QFETCH(double, minLineLength);
+    QFETCH(int, searchStart);
+    filter.getParameters().update(std::string("MinAngle"), fliplib::Parameter::TYPE_int, minAngle);
+    filter.getParameters().update(std::string("MaxAngle"), fliplib::Parameter::TYPE_int, maxAngle);
+    filter.getParameters().update(std::string("MinLineLength"), fliplib::Parameter::TYPE_double, minLineLength);
+    filter.getParameters().update(std::string("MinRadiusDistance"), fliplib::Parameter::TYPE_double, 1.0);
+    filter.getParameters().update(std::string("MaxRadiusDistance"), fliplib::Parameter::TYPE_double, 10.0);
+    filter.getParameters().update(std::string("SearchStart"), fliplib::Parameter::TYPE_int, searchStart);
+    filter.setParameter();
+
+    // both edges are 2 pixels wide, the distance of 150 pixel has to be between the min and max radius distance
+    const int leftEdge = 100;
+    const int rightEdge = 250;
+    const Size size{400, 200};
+    const double pixelPerMM = precitec::system::CalibDataSingleton::getCalibrationCoords(precitec::math::SensorId::eSensorId0).factorHorizontal(10, size.width / 2, size.height / 2);
+    QVERIFY(1.0 * pixelPerMM < rightEdge - leftEdge - 2);
+    QVERIFY(10.0 * pixelPerMM > rightEdge - leftEdge + 2);
+
+    QFETCH(double, tilt);
+    QFETCH(int, numNoisePixels);
+    // two images, so that the accumulators of the voting are reused
+    for (int imageNumber = 0; imageNumber < 2; imageNumber++)
+    {
+        dummyInput.fillData(imageNumber, HoughTestImage::createSeam(size, leftEdge, rightEdge, tilt, numNoisePixels));
+        QCOMPARE(dummyFilter.isProceedCalled(), false);
+        dummyInput.signal();
+        QCOMPARE(dummyFilter.isProceedCalled(), true);
+        dummyFilter.resetProceedCalled();
+
+        const auto resultLeft = outPipeLeft->read(imageNumber);
+        const auto resultRight = outPipeRight->read(imageNumber);
+        const auto resultCandidate = outPipeCandidate->read(imageNumber);
+        QCOMPARE(resultLeft.ref().size(), 1ul);
+        QCOMPARE(resultRight.ref().size(), 1ul);
+        QCOMPARE(resultCandidate.ref().size(), 1ul);
+
+        // the positions are where the lines cross the middle row of the image
+        QCOMPARE(resultLeft.ref().getRank().front(), int(precitec::filter::eRankMax));
+        QCOMPARE(resultRight.ref().getRank().front(), int(precitec::filter::eRankMax));
+        QVERIFY2(std::abs(resultLeft.ref().getData().front() - leftEdge) <= 2, qPrintable(QString::number(resultLeft.ref().getData().front())));
+        QVERIFY2(std::abs(resultRight.ref().getData().front() - rightEdge) <= 2, qPrintable(QString::number(resultRight.ref().getData().front())));
+
+        const auto &candidate = resultCandidate.ref().getData().front();
+        QVERIFY(candidate.m_oTwoLinesFound);
+        QVERIFY(candidate.m_oNumberOfPixelOnLine1 >= 90.0);
+        QVERIFY(candidate.m_oNumberOfPixelOnLine2 >= 90.0);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestHough)
+#include "testHough.moc"
@@ -0,0 +1,391 @@
+#include <QTest>
+
+#include "../houghVoting.h"
+#include "../circleFitImpl.h"
+#include "houghTestImages.h"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using precitec::image::BImage;
+using precitec::geo2d::DPoint;
+using precitec::geo2d::Point;
+using precitec::geo2d::Size;
+using precitec::filter::CircleHoughImpl;
+using precitec::filter::CircleHoughParameters;
+using precitec::filter::SearchType;
+using precitec::filter::angle2index;
+using precitec::filter::hough_circle_t;
+using namespace precitec::filter::houghvoting;
+using namespace HoughTestImage;
+
+class TestHoughVoting : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEdgePointsOfCircle_data();
+    void testEdgePointsOfCircle();
+    void testEdgePointsWithoutOrientation();
+    void testVotingPartitions_data();
+    void testVotingPartitions();
+    void testVotingPartitionsConcurrently();
+    void testLineVotingMatchesAllAngles_data();
+    void testLineVotingMatchesAllAngles();
+    void testCircleVotingMatchesPointList_data();
+    void testCircleVotingMatchesPointList();
+};
+
+namespace
+{
+
+double angleDifference(double a, double b)
+{
+    // orientations are defined modulo pi
+    const double difference = std::abs(std::remainder(a - b, M_PI));
+    return difference * 180.0 / M_PI;
+}
+
+}
+
+void TestHoughVoting::testEdgePointsOfCircle_data()
+{
+    QTest::addColumn<double>("radius");
+    QTest::addColumn<int>("edgeWidth");
+
+    QTest::newRow("r 4") << 4.0 << 1;
+    QTest::newRow("r 10") << 10.0 << 1;
+    QTest::newRow("r 10, width 4") << 10.0 << 4;
+    QTest::newRow("r 37.5, width 2") << 37.5 << 2;
+}
+
+void TestHoughVoting::testEdgePointsOfCircle()
+{
+    QFETCH(double, radius);
+    QFETCH(int, edgeWidth);
+
+    const double center = 50.0;
+    BImage image;
+    image.resizeFill(Size{100, 100}, 0);
+    for (int y = 0; y < image.height(); y++)
+    {
+        for (int x = 0; x < image.width(); x++)
+        {
+            const double distance = std::hypot(x - center, y - center);
+            if (distance >= radius - 0.5 && distance < radius - 0.5 + edgeWidth)
+            {
+                image[y][x] = 200;
+            }
+        }
+    }
+
+    std::vector<EdgePoint> edgePoints;
+    findEdgePoints(image, 100, edgePoints);
+    QVERIFY(!edgePoints.empty());
+
+    for (const auto & point : edgePoints)
+    {
+        QCOMPARE(image[point.m_oY][point.m_oX], byte(200));
+        QVERIFY(point.m_oOriented);
+        QVERIFY(point.m_oNormal >= 0.0 && point.m_oNormal < M_PI);
+        const double radial = std::atan2(point.m_oY - center, point.m_oX - center);
+        QVERIFY(angleDifference(point.m_oNormal, radial) < g_oOrientationToleranceDegrees);
+    }
+}
+
+void TestHoughVoting::testEdgePointsWithoutOrientation()
+{
+    BImage image;
+    image.resizeFill(Size{40, 30}, 0);
+    // isolated point
+    image[5][5] = 255;
+    // filled area
+    for (int y = 15; y < 25; y++)
+    {
+        for (int x = 20; x < 30; x++)
+        {
+            image[y][x] = 255;
+        }
+    }
+
+    std::vector<EdgePoint> edgePoints;
+    findEdgePoints(image, 0, edgePoints);
+    QCOMPARE(edgePoints.size(), std::size_t(101));
+    QCOMPARE(edgePoints.front().m_oX, 5);
+    QCOMPARE(edgePoints.front().m_oY, 5);
+    QVERIFY(!edgePoints.front().m_oOriented);
+    // the inner part of the filled area has no orientation
+    for (const auto & point : edgePoints)
+    {
+        if (point.m_oX >= 23 && point.m_oX < 27 && point.m_oY >= 18 && point.m_oY < 22)
+        {
+            QVERIFY(!point.m_oOriented);
+        }
+    }
+}
+
+void TestHoughVoting::testVotingPartitions_data()
+{
+    QTest::addColumn<int>("numCells");
+    QTest::addColumn<int>("numItems");
+    QTest::addColumn<bool>("trackBlocks");
+
+    QTest::newRow("no items") << 1000 << 0 << true;
+    QTest::newRow("few votes") << 1000 << 10 << true;
+    QTest::newRow("partial last block") << 1000 << 100000 << true;
+    QTest::newRow("many votes") << 100000 << 200000 << true;
+    QTest::newRow("many votes, untracked") << 100000 << 200000 << false;
+}
+
+void TestHoughVoting::testVotingPartitions()
+{
+    QFETCH(int, numCells);
+    QFETCH(int, numItems);
+    QFETCH(bool, trackBlocks);
+
+    // every item votes for a few cells, clustered like the votes of a hough transform
+    std::mt19937 generator{3};
+    std::vector<unsigned int> items(numItems);
+    for (auto & item : items)
+    {
+        item = generator() % (numCells / 4);
+    }
+    const int votesPerItem = 3;
+    auto vote = [&items, numCells] (std::size_t index, VoteCounter & counter)
+    {
+        for (int i = 0; i < votesPerItem; i++)
+        {
+            counter((items[index] + i * numCells / 3) % numCells);
+        }
+    };
+
+    std::vector<int> expected(numCells, 0);
+    for (const auto item : items)
+    {
+        for (int i = 0; i < votesPerItem; i++)
+        {
+            expected[(item + i * numCells / 3) % numCells]++;
+        }
+    }
+
+    // the partitions are reused, the second call must not see votes of the first one
+    VotingPartitions partitions;
+    for (int run = 0; run < 2; run++)
+    {
+        std::vector<int> accumulator(numCells, 0);
+        std::vector<unsigned int> touchedBlocks;
+        // the number of votes is exaggerated to use all workers
+        partitions.accumulate(accumulator.data(), accumulator.size(), items.size(), std::size_t(votesPerItem) * numItems * 100,
+            trackBlocks ? &touchedBlocks : nullptr, vote);
+        QCOMPARE(accumulator, expected);
+
+        if (!trackBlocks)
+        {
+            continue;
+        }
+        QVERIFY(std::is_sorted(touchedBlocks.begin(), touchedBlocks.end()));
+        QVERIFY(std::adjacent_find(touchedBlocks.begin(), touchedBlocks.end()) == touchedBlocks.end());
+        for (int block = 0; block * int(g_oCellsPerBlock) < numCells; block++)
+        {
+            const auto first = expected.begin() + block * g_oCellsPerBlock;
+            const auto last = expected.begin() + std::min<int>((block + 1) * g_oCellsPerBlock, numCells);
+            const bool hasVotes = std::any_of(first, last, [] (int count) { return count > 0; });
+            QCOMPARE(std::binary_search(touchedBlocks.begin(), touchedBlocks.end(), block), hasVotes);
+        }
+    }
+}
+
+void TestHoughVoting::testVotingPartitionsConcurrently()
+{
+    // several filters share the worker pool, e.g. in the graphs of different sensors
+    const int numCells = 10000;
+    const int numItems = 100000;
+    std::vector<int> expected(numCells, 0);
+    for (int item = 0; item < numItems; item++)
+    {
+        expected[item % numCells]++;
+    }
+
+    const int numThreads = 4;
+    std::vector<std::vector<int>> accumulators(numThreads);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < numThreads; thread++)
+    {
+        threads.emplace_back([&accumulators, thread]
+            {
+                VotingPartitions partitions;
+                for (int run = 0; run < 20; run++)
+                {
+                    accumulators[thread].assign(numCells, 0);
+                    partitions.accumulate(accumulators[thread].data(), numCells, numItems, std::size_t(numItems) * 100, nullptr,
+                        [] (std::size_t index, VoteCounter & counter) { counter(index % numCells); });
+                }
+            });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto & accumulator : accumulators)
+    {
+        QCOMPARE(accumulator, expected);
+    }
+}
+
+void TestHoughVoting::testLineVotingMatchesAllAngles_data()
+{
+    QTest::addColumn<int>("minAngle");
+    QTest::addColumn<int>("maxAngle");
+    QTest::addColumn<int>("numNoisePixels");
+    QTest::addColumn<bool>("oriented");
+
+    // the narrow default range of the filter votes for all angles, the result is the same
+    QTest::newRow("-10 - 10") << -10 << 10 << 0 << false;
+    QTest::newRow("-10 - 10, noise") << -10 << 10 << 400 << false;
+    QTest::newRow("-90 - 90") << -90 << 90 << 0 << true;
+    QTest::newRow("-90 - 90, noise") << -90 << 90 << 400 << true;
+    QTest::newRow("-180 - 180, noise") << -180 << 180 << 400 << true;
+}
+
+void TestHoughVoting::testLineVotingMatchesAllAngles()
+{
+    QFETCH(int, minAngle);
+    QFETCH(int, maxAngle);
+    QFETCH(int, numNoisePixels);
+    QFETCH(bool, oriented);
+
+    // two edges of a seam, 5 degrees against the vertical, like the input of the line hough filter
+    const auto image = createSeam(Size{200, 200}, 60, 140, 5.0, numNoisePixels);
+
+    const int angleMinInd = angle2index<g_oNumLineAngles>(minAngle * M_PI / 180.0);
+    const int angleMaxInd = angle2index<g_oNumLineAngles>(maxAngle * M_PI / 180.0);
+    const std::size_t numCells = lineHoughSize(image, angleMinInd, angleMaxInd);
+    std::vector<int> expected(numCells, 0);
+    voteAllAngles(image, angleMinInd, angleMaxInd, expected);
+
+    LineVoting voting;
+    std::vector<unsigned int> touchedBlocks;
+    // the voting is reused, the second image must give the same result
+    for (int run = 0; run < 2; run++)
+    {
+        std::vector<int> histogram(numCells, 0);
+        QCOMPARE(voting.accumulate(image, angleMinInd, angleMaxInd, histogram, touchedBlocks), oriented);
+        if (!oriented)
+        {
+            QCOMPARE(histogram, expected);
+            continue;
+        }
+
+        // edge points only vote for some angles, so the histograms differ. But the peaks of the lines are the same:
+        // the two strongest cells keep at least 97% of their votes and are still the two strongest lines.
+        std::vector<std::size_t> peaks(numCells);
+        std::iota(peaks.begin(), peaks.end(), 0);
+        std::partial_sort(peaks.begin(), peaks.begin() + 2, peaks.end(), [&expected] (std::size_t a, std::size_t b) { return expected[a] > expected[b]; });
+        for (int peak = 0; peak < 2; peak++)
+        {
+            const auto cell = peaks[peak];
+            QVERIFY(histogram[cell] <= expected[cell]);
+            QVERIFY(histogram[cell] >= 0.97 * expected[cell]);
+        }
+        const int weakerPeak = std::min(histogram[peaks[0]], histogram[peaks[1]]);
+        const int numStronger = std::count_if(histogram.begin(), histogram.end(), [weakerPeak] (int count) { return count > weakerPeak; });
+        QVERIFY(numStronger <= 1);
+
+        // all cells with votes are in the touched blocks
+        for (std::size_t cell = 0; cell < numCells; cell++)
+        {
+            if (histogram[cell] > 0)
+            {
+                QVERIFY(std::binary_search(touchedBlocks.begin(), touchedBlocks.end(), cell / g_oCellsPerBlock));
+            }
+        }
+    }
+}
+
+void TestHoughVoting::testCircleVotingMatchesPointList_data()
+{
+    QTest::addColumn<double>("radius");
+    QTest::addColumn<double>("radiusStart");
+    QTest::addColumn<double>("radiusEnd");
+    QTest::addColumn<int>("numNoisePixels");
+
+    QTest::newRow("pore r 12") << 12.0 << 5.0 << 20.0 << 0;
+    QTest::newRow("pore r 12, noise") << 12.0 << 5.0 << 20.0 << 200;
+    QTest::newRow("spot weld r 50") << 50.0 << 40.0 << 59.0 << 0;
+    QTest::newRow("spot weld r 50, noise") << 50.0 << 40.0 << 59.0 << 400;
+}
+
+void TestHoughVoting::testCircleVotingMatchesPointList()
+{
+    QFETCH(double, radius);
+    QFETCH(double, radiusStart);
+    QFETCH(double, radiusEnd);
+    QFETCH(int, numNoisePixels);
+
+    // a ring with a width of 2 pixels
+    const double center = radius * 2.1;
+    BImage image;
+    image.resizeFill(Size{int(radius * 4), int(radius * 4)}, 0);
+    for (int y = 0; y < image.height(); y++)
+    {
+        for (int x = 0; x < image.width(); x++)
+        {
+            const double distance = std::hypot(x - center, y - center);
+            if (distance >= radius - 1.0 && distance < radius + 1.0)
+            {
+                image[y][x] = 255;
+            }
+        }
+    }
+    addNoise(image, numNoisePixels);
+
+    // a point list votes for the whole circle like all pixels did before the orientation was used
+    std::vector<DPoint> points;
+    for (int y = 0; y < image.height(); y++)
+    {
+        for (int x = 0; x < image.width(); x++)
+        {
+            if (image[y][x] > 100)
+            {
+                points.emplace_back(x, y);
+            }
+        }
+    }
+
+    // at most 20 radii keep the radius step at 1, the accumulator score compares the votes directly
+    CircleHoughParameters parameters;
+    parameters.m_oRadiusStart = radiusStart;
+    parameters.m_oRadiusEnd = radiusEnd;
+    parameters.m_oRadiusStep = 1.0;
+    parameters.m_oNumberMax = 1;
+    parameters.m_oCoarse = true;
+    parameters.m_oScoreType = CircleHoughParameters::ScoreType::Accumulator;
+    parameters.m_oConnectedArcToleranceDegrees = 1.0;
+
+    auto best = [] (const std::vector<hough_circle_t> & candidates)
+    {
+        return *std::max_element(candidates.begin(), candidates.end(), [] (const hough_circle_t & a, const hough_circle_t & b)
+            {
+                return a.second < b.second;
+            });
+    };
+    CircleHoughImpl oriented;
+    const auto result = oriented.DoCircleHough(image, 100, SearchType::OnlyCenterInsideROI, parameters);
+    // same candidate area for the centers as OnlyCenterInsideROI
+    CircleHoughImpl allAngles;
+    const auto expected = allAngles.DoCircleHough(points, Point{0, 0}, Point{image.width() - 1, image.height() - 1}, parameters);
+    QVERIFY(!result.empty());
+    QVERIFY(!expected.empty());
+
+    const auto resultCircle = best(result).first;
+    const auto expectedCircle = best(expected).first;
+    QCOMPARE(resultCircle.m_radius, expectedCircle.m_radius);
+    QVERIFY(std::abs(resultCircle.m_middleX - expectedCircle.m_middleX) <= 1.0);
+    QVERIFY(std::abs(resultCircle.m_middleY - expectedCircle.m_middleY) <= 1.0);
+    QVERIFY(std::abs(resultCircle.m_middleX - center) <= 1.0);
+    QVERIFY(std::abs(resultCircle.m_middleY - center) <= 1.0);
+}
+
+QTEST_GUILESS_MAIN(TestHoughVoting)
+#include "testHoughVoting.moc"
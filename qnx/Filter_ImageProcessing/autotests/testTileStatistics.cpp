@@ -0,0 +1,88 @@
+#include <QTest>
+
+#include "../tileStatistics.h"
+
+#include <filter/algoImage.h>
+#include <geo/rect.h>
+
+#include <random>
+
+using precitec::filter::TileStatistics;
+using precitec::image::BImage;
+using precitec::geo2d::Rect;
+using precitec::geo2d::Size;
+
+class TestTileStatistics : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testStatistics_data();
+    void testStatistics();
+    void testOverflow();
+};
+
+void TestTileStatistics::testStatistics_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("random") << 320 << 240 << 0;
+    QTest::newRow("saturated") << 200 << 100 << 1;
+    QTest::newRow("low contrast") << 97 << 53 << 2;
+    QTest::newRow("single row") << 64 << 1 << 0;
+    QTest::newRow("single column") << 1 << 64 << 0;
+}
+
+void TestTileStatistics::testStatistics()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, mode);
+
+    std::mt19937 generator{42};
+    BImage image{Size{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const auto random = generator();
+            image[y][x] = mode == 0 ? random % 256 : mode == 1 ? 255 : 100 + random % 5;
+        }
+    }
+
+    TileStatistics statistics;
+    statistics.init(image, TileStatistics::eMean | TileStatistics::eVariance | TileStatistics::eGradientX | TileStatistics::eGradientY);
+
+    for (int i = 0; i < 500; i++)
+    {
+        const int x = generator() % width;
+        const int y = generator() % height;
+        const int tileWidth = 1 + generator() % (width - x);
+        const int tileHeight = 1 + generator() % (height - y);
+        // the tile image as created by SurfaceCalculator::computeTiles
+        const BImage tile{image, Rect{x, y, tileWidth, tileHeight}, true};
+        QCOMPARE(tile.size(), Size(tileWidth, tileHeight));
+
+        // the values must be bit identical
+        QCOMPARE(statistics.mean(x, y, tileWidth, tileHeight), precitec::filter::calcMeanIntensity(tile));
+        QCOMPARE(statistics.variance(x, y, tileWidth, tileHeight), precitec::filter::calcVariance(tile));
+        QCOMPARE(statistics.gradientSumX(x, y, tileWidth, tileHeight), precitec::filter::calcGradientSumX(tile));
+        QCOMPARE(statistics.gradientSumY(x, y, tileWidth, tileHeight), precitec::filter::calcGradientSumY(tile));
+    }
+}
+
+void TestTileStatistics::testOverflow()
+{
+    // the sum of squares of a bright tile exceeds 32 bit, calcVariance computes modulo 2^32 as well
+    BImage image{Size{400, 300}};
+    image.fill(255);
+
+    TileStatistics statistics;
+    statistics.init(image, TileStatistics::eVariance);
+    const BImage tile{image, Rect{0, 0, 400, 300}, true};
+    QCOMPARE(statistics.variance(0, 0, 400, 300), precitec::filter::calcVariance(tile));
+}
+
+QTEST_GUILESS_MAIN(TestTileStatistics)
+#include "testTileStatistics.moc"
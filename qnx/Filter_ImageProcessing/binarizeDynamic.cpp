@@ -23,7 +23,7 @@ namespace filter
 {
 
 void binarizeImage(const geo2d::Doublearray& thresholdIn, const image::BImage& imageIn, const ComparisonType& comparisonType,
-                            const BinarizeType& binarizeType, image::BImage& rBinarizedImageOut)
+                            const BinarizeType& binarizeType, int windowSize, int blockSize, image::BImage& rBinarizedImageOut)
 {
     const image::Size2d& sizeImageIn (imageIn.size());
 
@@ -57,6 +57,9 @@ void binarizeImage(const geo2d::Doublearray& thresholdIn, const image::BImage& i
         case BinarizeType::eLocal: // local and dynamically
         calcBinarizeLocal(imageIn, comparisonType, distanceToMeanIntensity, rBinarizedImageOut);
         break;
+        case BinarizeType::eLocalIntegral: // local and dynamically, window mean from a summed area table
+        calcBinarizeLocalIntegral(imageIn, comparisonType, distanceToMeanIntensity, windowSize, blockSize, rBinarizedImageOut);
+        break;
         case BinarizeType::eStatic: // global and statically
         calcBinarizeStatic(imageIn, comparisonType, distanceToMeanIntensity, rBinarizedImageOut);
         break;
@@ -75,11 +78,15 @@ BinarizeDynamic::BinarizeDynamic() :
 	m_pPipeInThreshold          ( nullptr ),
 	m_oPipeOutImgFrame			( this, m_oPipeOut1Name ),
 	m_oComparisonType			( eLess ),
-	m_oBinarizeType				( BinarizeType::eGlobal )
+	m_oBinarizeType				( BinarizeType::eGlobal ),
+	m_oWindowSize				( 20 ),
+	m_oBlockSize				( 1 )
 {
 	// Defaultwerte der Parameter setzen
 	parameters_.add("ComparisonType",	fliplib::Parameter::TYPE_int,	static_cast<int>(m_oComparisonType));
 	parameters_.add("BinarizeType",		fliplib::Parameter::TYPE_int,	static_cast<int>(m_oBinarizeType));
+	parameters_.add("WindowSize",		fliplib::Parameter::TYPE_int,	m_oWindowSize);
+	parameters_.add("BlockSize",		fliplib::Parameter::TYPE_int,	m_oBlockSize);
 
     setInPipeConnectors({{Poco::UUID("218854a5-9536-46fe-88e8-95c3ba548398"), m_pPipeInImageFrame, "Image", 1, "image"},
     {Poco::UUID("3b93a294-2c6c-4b24-b4be-6bd85f1ac650"), m_pPipeInThreshold, "Threshold", 1, "threshold"}});
@@ -94,6 +101,8 @@ void BinarizeDynamic::setParameter()
 	TransformFilter::setParameter();
 	m_oComparisonType		= static_cast<ComparisonType>(parameters_.getParameter("ComparisonType").convert<int>());
 	m_oBinarizeType			= static_cast<BinarizeType>(parameters_.getParameter("BinarizeType").convert<int>());
+	m_oWindowSize			= parameters_.getParameter("WindowSize").convert<int>();
+	m_oBlockSize			= parameters_.getParameter("BlockSize").convert<int>();
 }
 
 
@@ -137,7 +146,7 @@ void BinarizeDynamic::proceedGroup(const void* sender, fliplib::PipeGroupEventAr
 
 	auto& rBinarizedImageOut = m_oBinImageOut[m_oCounter % g_oNbPar];
 
-    binarizeImage(rThresholdIn, rImageIn, m_oComparisonType, m_oBinarizeType, rBinarizedImageOut);
+    binarizeImage(rThresholdIn, rImageIn, m_oComparisonType, m_oBinarizeType, m_oWindowSize, m_oBlockSize, rBinarizedImageOut);
     const interface::ImageFrame oFrameOut(rFrameIn.context(), rBinarizedImageOut, rFrameIn.analysisResult());
     preSignalAction();
     m_oPipeOutImgFrame.signal(oFrameOut);
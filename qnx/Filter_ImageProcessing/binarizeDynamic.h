@@ -81,6 +81,8 @@ private:
 
 	ComparisonType 				m_oComparisonType;		///< parameter - comparison type
 	BinarizeType 				m_oBinarizeType;		///< parameter - binarize type
+	int							m_oWindowSize;			///< parameter - side length of the mean window of the local integral binarization
+	int							m_oBlockSize;			///< parameter - side length of the pixel blocks sharing a threshold in the local integral binarization
 
 	interface::SmpTrafo			m_oSpTrafo;				///< roi translation
     std::array<image::BImage, g_oNbParMax>	m_oBinImageOut;			///< binarized image
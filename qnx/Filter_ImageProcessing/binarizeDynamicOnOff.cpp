@@ -21,7 +21,7 @@ namespace filter
 {
 
 extern void binarizeImage(const geo2d::Doublearray& thresholdIn, const image::BImage& imageIn, const ComparisonType& comparisonType,
-                     const BinarizeType& binarizeType, image::BImage& rBinarizedImageOut);
+                     const BinarizeType& binarizeType, int windowSize, int blockSize, image::BImage& rBinarizedImageOut);
 
 BinarizeDynamicOnOff::BinarizeDynamicOnOff()
     : TransformFilter("BinarizeDynamicOnOff", Poco::UUID{"945258a7-8992-48c6-b637-b3b99e3825f7"})
@@ -88,7 +88,8 @@ void BinarizeDynamicOnOff::proceedGroup(const void* sender, fliplib::PipeGroupEv
     auto& rBinarizedImageOut = m_binarizedImageOut[m_oCounter % g_oNbPar];
     // Just pass the input iamge to output if threshold is zero.
     const geo2d::Doublearray& threshold = m_paramOnOff ? rThresholdIn : geo2d::Doublearray(1, 0);
-    binarizeImage(threshold, rImageIn, m_paramComparisonType, m_paramBinarizeType, rBinarizedImageOut);
+    // the integral local binarization uses the window of the local binarization, one threshold per pixel
+    binarizeImage(threshold, rImageIn, m_paramComparisonType, m_paramBinarizeType, 20, 1, rBinarizedImageOut);
     const interface::ImageFrame oFrameOut(rFrameIn.context(), rBinarizedImageOut, rFrameIn.analysisResult());
     preSignalAction();
     m_oPipeOutImgFrame.signal(oFrameOut);
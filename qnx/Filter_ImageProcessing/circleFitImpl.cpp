@@ -319,7 +319,7 @@ void CircleHoughImpl::AccumulationMatrix::update(double radius, geo2d::Point min
 #endif
 }
 
-bool CircleHoughImpl::DoSingleCircleHough(const image::BImage & p_rImageIn, double radius, byte threshold, SearchType searchOutsideROI, bool coarse)
+bool CircleHoughImpl::DoSingleCircleHough(const image::BImage & p_rImageIn, double radius, SearchType searchOutsideROI, bool coarse)
 {
     //there is an offset between the allowed candidate area and the image size depending on the search type
     geo2d::Point minAllowedCenterPosition{0,0};
@@ -356,40 +356,14 @@ bool CircleHoughImpl::DoSingleCircleHough(const image::BImage & p_rImageIn, doub
         return false;
     }
     // search on the whole roi (even in the most restrictive case, the whole roi may contain a valid circle point)
-    const int startX = 0;
-    const int endX = p_rImageIn.size().width;
-    const int startY = 0;
-    const int endY = p_rImageIn.size().height;
-
-    
+    // m_edgePoints contains all pixels above the threshold
     if (coarse)
     {
-        for(int y=startY; y<endY; y++)
-        {
-            auto p_curVal= p_rImageIn.rowBegin(y) + startX;
-            for (int x=startX; x<endX; x++, ++p_curVal )
-            {
-                if (*p_curVal > threshold)
-                {
-                    m_accumulationMatrix.increaseScore<true>(x,y);
-                }
-            }
-        }
+        m_accumulationMatrix.accumulate<true>(m_edgePoints);
     }
     else
     {
-
-        for(int y=startY; y<endY; y++)
-        {
-            auto p_curVal= p_rImageIn.rowBegin(y) + startX;
-            for (int x=startX; x<endX; x++, ++p_curVal )
-            {
-                if (*p_curVal > threshold)
-                {
-                    m_accumulationMatrix.increaseScore<false>(x,y);
-                }
-            }
-        }
+        m_accumulationMatrix.accumulate<false>(m_edgePoints);
     }
 
     return true;
@@ -426,6 +400,24 @@ bool CircleHoughImpl::DoSingleCircleHough(std::vector<geo2d::DPoint> p_rPointLis
 CircleHoughImpl::PositionInAccuMa CircleHoughImpl::AccumulationMatrix::extractMax() const
 {
     assert(_maxX*_maxY > 0);
+    if (m_touchedBlocksValid)
+    {
+        // all other cells are zero, same result as max_element: the first cell with the maximum value
+        const int size = _maxX*_maxY;
+        int index = 0;
+        int maxValue = 0;
+        for (auto block : m_touchedBlocks)
+        {
+            const int first = block * houghvoting::g_oCellsPerBlock;
+            const auto itMax = std::max_element(_pAccuMa + first, _pAccuMa + std::min<int>(first + houghvoting::g_oCellsPerBlock, size));
+            if (*itMax > maxValue || (*itMax == maxValue && maxValue > 0 && itMax - _pAccuMa < index))
+            {
+                maxValue = *itMax;
+                index = itMax - _pAccuMa;
+            }
+        }
+        return extractPosition(index);
+    }
 	// Max in Akkumulator-Matrix suchen
 	auto itMax = std::max_element(_pAccuMa, _pAccuMa + _maxX*_maxY);
     auto index = itMax - _pAccuMa;
@@ -610,9 +602,10 @@ std::vector<hough_circle_t> CircleHoughImpl::DoCircleHough(const precitec::image
 	oResult.reserve(numberMax * numCandidatesRadii);
 
     PointMatrix matrix(p_rImageIn, threshold);
+    houghvoting::findEdgePoints(p_rImageIn, threshold, m_edgePoints);
 	for (double curRadius = radiusEnd; curRadius >= radiusStart; curRadius -= radiusStep)
 	{
-		bool ok = DoSingleCircleHough( p_rImageIn, curRadius, threshold, searchOutsideROI, parameters.m_oCoarse);
+		bool ok = DoSingleCircleHough( p_rImageIn, curRadius, searchOutsideROI, parameters.m_oCoarse);
 		if (!ok)
 		{
 			continue;
@@ -921,14 +914,28 @@ void CircleHoughImpl::AccumulationMatrix::OffsetLookUpTable<NUMBER_OF_SAMPLES>::
             itYX->second = std::cos(angle_rad); //x
         }
         assert(itYX == oCircleLookupTable.end());
+        return oCircleLookupTable;
+    }();
+    static const std::array< std::pair< double, double >, NUMBER_OF_SAMPLES > sCircleLookupTableSortedByY = []()
+    {
+        auto oCircleLookupTable = sCircleLookupTable;
         std::sort(oCircleLookupTable.begin(),oCircleLookupTable.end()); //sorted by y, not by angle
         return oCircleLookupTable;
     }();
 
     m_radius = radius;
 
+    for (int i = 0; i < NUMBER_OF_SAMPLES; i++)
+    {
+        // same values as below, the accumulator cells of a sample do not depend on the order
+        m_dataByAngle[i] = {radius * sCircleLookupTable[i].first - m_accumulatorTrafoY - 0.5,
+                            radius * sCircleLookupTable[i].second - m_accumulatorTrafoX - 0.5
+                           };
+        m_dataByAngle[i + NUMBER_OF_SAMPLES] = m_dataByAngle[i];
+    }
+
     auto ityx = m_data.begin();
-    for (auto & rCircleyx : sCircleLookupTable)
+    for (auto & rCircleyx : sCircleLookupTableSortedByY)
     {
         *ityx = {radius * rCircleyx.first - m_accumulatorTrafoY - 0.5, // for the sign, check the usage in  DoSingleCircleHough
                  radius * rCircleyx.second - m_accumulatorTrafoX - 0.5
@@ -975,6 +982,77 @@ void CircleHoughImpl::AccumulationMatrix::increaseScore(double imageX, double im
     }
 }
 
+template<bool coarse>
+void CircleHoughImpl::AccumulationMatrix::accumulate(const std::vector<houghvoting::EdgePoint> & p_rEdgePoints)
+{
+    if (coarse)
+    {
+        accumulateSamples(m_accumulatorOffsetsLookUpTableCoarse, p_rEdgePoints);
+    }
+    else
+    {
+        accumulateSamples(m_accumulatorOffsetsLookUpTableFine, p_rEdgePoints);
+    }
+}
+
+template <int NUMBER_OF_SAMPLES>
+void CircleHoughImpl::AccumulationMatrix::accumulateSamples(const OffsetLookUpTable<NUMBER_OF_SAMPLES> & p_rTable, const std::vector<houghvoting::EdgePoint> & p_rEdgePoints)
+{
+    static_assert(NUMBER_OF_SAMPLES % 2 == 0, "the opposite sample must be in the table");
+    const double angleStep = 2 * M_PI / NUMBER_OF_SAMPLES;
+    // a sample reaches the cell of the center if its direction deviates by less than half a cell diagonal (seen from the edge point)
+    // from the direction of the center
+    const double tolerance = houghvoting::g_oOrientationToleranceDegrees * M_PI / 180.0 + 0.75 / p_rTable.getRadius();
+
+    // the center lies on the normal of the edge, on either side
+    std::size_t numVotes = 0;
+    m_sampleRanges.resize(p_rEdgePoints.size());
+    for (std::size_t i = 0; i < p_rEdgePoints.size(); i++)
+    {
+        const auto & rPoint = p_rEdgePoints[i];
+        auto & rRange = m_sampleRanges[i];
+        rRange = {0, NUMBER_OF_SAMPLES, 1};
+        if (rPoint.m_oOriented)
+        {
+            const int first = std::ceil((rPoint.m_oNormal - tolerance) / angleStep);
+            const int last = std::floor((rPoint.m_oNormal + tolerance) / angleStep);
+            if (2 * (last - first + 1) < NUMBER_OF_SAMPLES)
+            {
+                rRange = {(first + NUMBER_OF_SAMPLES) % NUMBER_OF_SAMPLES, last - first + 1, 2};
+            }
+        }
+        numVotes += rRange.count * rRange.numWindows;
+    }
+
+    const auto & rOffsets = p_rTable.getOffsetsByAngle();
+    m_votingPartitions.accumulate(_pAccuMa, _maxX * _maxY, p_rEdgePoints.size(), numVotes, &m_touchedBlocks,
+        [this, &p_rEdgePoints, &rOffsets] (std::size_t item, houghvoting::VoteCounter & rCounter)
+        {
+            const double imageX = p_rEdgePoints[item].m_oX;
+            const double imageY = p_rEdgePoints[item].m_oY;
+            const auto & rRange = m_sampleRanges[item];
+            for (int window = 0, first = rRange.first; window < rRange.numWindows; window++, first += NUMBER_OF_SAMPLES / 2)
+            {
+                for (auto itYX = rOffsets.begin() + first, itEnd = itYX + rRange.count; itYX != itEnd; ++itYX)
+                {
+                    // same cell as in increaseScore
+                    double x0 = imageX - itYX->second;
+                    if (x0 < 0.5 || x0 >= _maxX)
+                    {
+                        continue;
+                    }
+                    double y0 = imageY - itYX->first;
+                    if (y0 < 0.5 || y0 >= _maxY)
+                    {
+                        continue;
+                    }
+                    rCounter(static_cast<int>(x0) + static_cast<int>(y0)*_maxX);
+                }
+            }
+        });
+    m_touchedBlocksValid = true;
+}
+
 template<int NUMBER_OF_VERIFICATION_SAMPLES>
 CircleHoughImpl::VerificationLookUpTable<NUMBER_OF_VERIFICATION_SAMPLES>::VerificationLookUpTable()
 {
@@ -1025,6 +1103,19 @@ void CircleHoughImpl::AccumulationMatrix::resizeArray(geo2d::Size newSize)
         _oAccuMaSize = _maxX*_maxY;
         _pAccuMa = new int [_oAccuMaSize](); //value initialization
     }
+    else if (m_touchedBlocksValid)
+    {
+        //only the touched blocks of the last accumulation can be different from zero, the new size is not bigger than the old one
+        const int oldSize = _maxX*_maxY;
+        for (auto block : m_touchedBlocks)
+        {
+            const int first = block * houghvoting::g_oCellsPerBlock;
+            std::fill(_pAccuMa + first, _pAccuMa + std::min<int>(first + houghvoting::g_oCellsPerBlock, oldSize), 0);
+        }
+
+        _maxY = newSize.height;
+        _maxX = newSize.width;
+    }
     else
     {
         //accumulator matrix has already enough elements, update only the bounds
@@ -1035,6 +1126,8 @@ void CircleHoughImpl::AccumulationMatrix::resizeArray(geo2d::Size newSize)
         assert((int)_oAccuMaSize >= _maxX*_maxY);
         std::fill_n(_pAccuMa, _maxX*_maxY, 0); //Nullen der AccuMa muss immer vor SingleHough passieren -> Evtl. ueber Flag steuern
     }
+    m_touchedBlocks.clear();
+    m_touchedBlocksValid = false;
     assert(std::all_of(_pAccuMa, _pAccuMa+(_maxX*_maxY), [](int val) {
         return val == 0;
     }));
@@ -6,6 +6,7 @@
 #include "common/frame.h"				// ImageFrame
 #include "image/image.h"				///< BImage
 #include "circleFitDefinitions.h"
+#include "houghVoting.h"
 
 // std lib
 #include <string>
@@ -60,6 +61,13 @@ private:
         template<bool coarse>
         void increaseScore(double imageX, double imageY);
 
+        /**
+         * Accumulates the votes of all edge points. Points with an orientation vote only for the centers along their normal,
+         * the other points for the whole circle like increaseScore. The votes are counted on several threads.
+         */
+        template<bool coarse>
+        void accumulate(const std::vector<houghvoting::EdgePoint> & p_rEdgePoints);
+
         PositionInAccuMa extractMax() const;
         geo2d::DPoint extractMeanImagePosition(const PositionInAccuMa & startPosition) const;
 
@@ -76,6 +84,18 @@ private:
         int m_accumulatorTrafoY;
         unsigned int _oAccuMaSize;
 
+        std::vector<unsigned int> m_touchedBlocks; // blocks with votes of accumulate, allows to search the maximum and to reset only these cells
+        bool m_touchedBlocksValid = false; // false if the votes were counted with increaseScore
+        houghvoting::VotingPartitions m_votingPartitions;
+
+        struct SampleRange
+        {
+            int first;
+            int count;
+            int numWindows; // the window at first and the opposite one at first + NUMBER_OF_SAMPLES / 2
+        };
+        std::vector<SampleRange> m_sampleRanges;
+
         PositionInAccuMa extractPosition(unsigned int index) const;
         unsigned int fromImageCoordToAccumulatorIndex(int xImage, int yImage) const;
         void resizeArray(geo2d::Size newSize);
@@ -86,11 +106,16 @@ private:
             public:
                 void update(double radius, int offsetX, int offsetY);
                 const std::array< std::pair< double, double >, NUMBER_OF_SAMPLES > & getOffsets() const {return m_data;};
+                // same offsets ordered by angle and repeated once, so that any window of samples is contiguous
+                const std::array< std::pair< double, double >, 2 * NUMBER_OF_SAMPLES > & getOffsetsByAngle() const {return m_dataByAngle;};
                 double getRadius() const {return m_radius;}
             private:
                 std::array< std::pair< double, double >, NUMBER_OF_SAMPLES > m_data;
+                std::array< std::pair< double, double >, 2 * NUMBER_OF_SAMPLES > m_dataByAngle;
                 double m_radius;
         };
+        template <int NUMBER_OF_SAMPLES>
+        void accumulateSamples(const OffsetLookUpTable<NUMBER_OF_SAMPLES> & p_rTable, const std::vector<houghvoting::EdgePoint> & p_rEdgePoints);
         OffsetLookUpTable<NUMBER_OF_SAMPLES_COARSE> m_accumulatorOffsetsLookUpTableCoarse;
         OffsetLookUpTable<NUMBER_OF_SAMPLES_FINE> m_accumulatorOffsetsLookUpTableFine;
     };
@@ -124,13 +149,14 @@ private:
         double computeScore(const PointMatrix & p_rMatrix, geo2d::DPoint center, double tolerance_degrees);
     };
 
-	bool DoSingleCircleHough(const precitec::image::BImage & p_rImageIn, double radius,  byte threshold, SearchType searchOutsideROI, bool coarse);
+	bool DoSingleCircleHough(const precitec::image::BImage & p_rImageIn, double radius, SearchType searchOutsideROI, bool coarse);
 	bool DoSingleCircleHough(std::vector<geo2d::DPoint> p_rPointList, double radius, geo2d::Point minAllowedCenterPosition, geo2d::Point maxAllowedCenterPosition, bool coarse);
     void extractCandidates(std::vector<hough_circle_t> & p_rResult, const PointMatrix & p_rMatrix, int numberMax, double curRadius, CircleHoughParameters::ScoreType scoreType, double tolerance_degrees, bool coarse);
 
 	Circle _resultCircle;
     AccumulationMatrix m_accumulationMatrix;
     VerificationLookUpTable<720> m_verificationOffsetsLookUpTable;
+    std::vector<houghvoting::EdgePoint> m_edgePoints;
 
 
 };
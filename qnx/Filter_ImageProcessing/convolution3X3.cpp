@@ -7,6 +7,7 @@
  */
 
 #include "convolution3X3.h"
+#include "kernel3X3.h"
 
 #include <system/platform.h>					///< global and platform specific defines
 #include <system/tools.h>						///< poco bugcheck
@@ -134,33 +135,19 @@ Convolution3X3::calcConvolution3X3( // actual signal processing
 	BImage				&p_rImageOut
 )
 {
-	const int oImgWidth		= p_rImageIn.size().width;
-	const int oImgHeight	= p_rImageIn.size().height;
-
-	const int	C1(p_FilterCoeff.m_oCoeff1), C2(p_FilterCoeff.m_oCoeff2), C3(p_FilterCoeff.m_oCoeff3),
-				C4(p_FilterCoeff.m_oCoeff4), C5(p_FilterCoeff.m_oCoeff5), C6(p_FilterCoeff.m_oCoeff6),
-				C7(p_FilterCoeff.m_oCoeff7), C8(p_FilterCoeff.m_oCoeff8), C9(p_FilterCoeff.m_oCoeff9);
-				// just for shorter names
-
-	std::fill_n(p_rImageOut.upperLeft(), oImgWidth, 0); // fill boundary
-	for (int y = 1; y < oImgHeight - 1; ++y) { // exclude boundaries
-
-		const byte	*pLineInPre		= p_rImageIn[y-1];
-		const byte	*pLineInCur		= p_rImageIn[y];
-		const byte	*pLineInPost	= p_rImageIn[y+1];
-		byte		*pLineOut		= p_rImageOut[y];
-
-		pLineOut[0]	= 0; // fill boundary
-		for (int x = 1; x < oImgWidth - 1; ++x) { // exclude boundaries
-			const int	oRawValue	= std::abs(
-				C1 * pLineInPre	[x-1] + C2 * pLineInPre	[x] + C3 * pLineInPre  [x+1] +
-				C4 * pLineInCur	[x-1] + C5 * pLineInCur	[x] + C6 * pLineInCur  [x+1] +
-				C7 * pLineInPost[x-1] + C8 * pLineInPost[x] + C9 * pLineInPost [x+1]);
-			pLineOut[x] = static_cast<byte>( std::min(oRawValue, 255) );	// prevent clipping
-		} // for
-		pLineOut[oImgWidth - 1]	= 0; // fill boundary
-	} // for
-	std::fill_n(p_rImageOut.lowerLeft(), oImgWidth, 0); // fill boundary
+	const kernel3X3::Convolution oConvolution(std::array<int, 9>{{
+		p_FilterCoeff.m_oCoeff1, p_FilterCoeff.m_oCoeff2, p_FilterCoeff.m_oCoeff3,
+		p_FilterCoeff.m_oCoeff4, p_FilterCoeff.m_oCoeff5, p_FilterCoeff.m_oCoeff6,
+		p_FilterCoeff.m_oCoeff7, p_FilterCoeff.m_oCoeff8, p_FilterCoeff.m_oCoeff9}});
+
+	kernel3X3::ClipSink oSink(p_rImageOut);
+	if (oConvolution.fitsInt16()) {
+		kernel3X3::forEachInnerPixel<true>(p_rImageIn, oConvolution, oSink);
+	}
+	else {
+		kernel3X3::forEachInnerPixel<false>(p_rImageIn, oConvolution, oSink); // large coefficients need 32 bit sums
+	}
+	kernel3X3::clearBorder(p_rImageOut);
 } // calcConvolution3X3
 
 
@@ -637,7 +637,7 @@ namespace precitec {
                             m_oFillOutputBorder,
                             computeStats,
                             outputMin, outputMax,
-                            m_oIntegralImage);
+                            m_oIntegralImage, m_oFrequencyDomainCorrelation);
                 }
                 else
                 {
@@ -648,7 +648,7 @@ namespace precitec {
                             m_oFillOutputBorder,
                             computeStats,
                             outputMin, outputMax,
-                            m_oIntegralImage);
+                            m_oIntegralImage, m_oFrequencyDomainCorrelation);
 
                 }
             }
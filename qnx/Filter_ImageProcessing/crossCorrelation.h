@@ -17,6 +17,7 @@
 
 #include "sparseKernel.h"
 #include "common/frame.h"
+#include "crossCorrelationFFT.h"
 
 namespace precitec {
 	using namespace image;
@@ -91,6 +92,7 @@ namespace precitec {
 			DImage										    m_oKernel2;			///< normalized template (component 2), size 0 if kernel could not separated
 			BImage											m_oBKernel;			///< byte rescaled template (for out pipe and for comparing dimensions)
 			TLineImage<int>                          m_oIntegralImage; ///< used for normalization
+			crosscorrelation::FrequencyDomainCorrelation m_oFrequencyDomainCorrelation; ///< kernel spectrum for large kernels
 			double											m_oKernelRootSquaredSum; ///< cached sum of squares of template elements
 			std::vector<std::string>						m_oResultInfo;
 			double m_oRangeInputMinPerc;
@@ -234,7 +234,7 @@ namespace precitec {
                         m_oFillOutputBorder,
                         computeStats,
                         outputMin, outputMax,
-                        m_oIntegralImage);
+                        m_oIntegralImage, m_oFrequencyDomainCorrelation);
             }
             else
             {
@@ -245,7 +245,7 @@ namespace precitec {
                         m_oFillOutputBorder,
                         computeStats,
                         outputMin, outputMax,
-                        m_oIntegralImage);
+                        m_oIntegralImage, m_oFrequencyDomainCorrelation);
             }
 
             m_oResultInfo.clear();
@@ -16,6 +16,7 @@
 #include "fliplib/SynchronePipe.h"
 
 #include "common/frame.h"
+#include "crossCorrelationFFT.h"
 
 namespace precitec {
     using namespace image;
@@ -57,6 +58,7 @@ namespace precitec {
             DImage m_oKernel2;            ///< normalized template (component 2), size 0 if kernel could not separated
             geo2d::Size m_oKernelSize;            ///< byte rescaled template (for out pipe and for comparing dimensions)
             TLineImage<int>     m_oIntegralImage; ///< used for normalization
+            crosscorrelation::FrequencyDomainCorrelation m_oFrequencyDomainCorrelation; ///< kernel spectrum for large kernels
             double m_oKernelRootSquaredSum; ///< cached sum of squares of template elements
             std::vector<std::string> m_oResultInfo;
             double m_oRangeInputMinPerc;
@@ -0,0 +1,183 @@
+/***
+*    @file
+*    @copyright        Precitec Vision GmbH & Co. KG
+*    @brief            Cross correlation in the frequency domain and selection between spatial and frequency domain
+*/
+
+#include "crossCorrelationFFT.h"
+
+#include <cmath>
+
+namespace precitec
+{
+using namespace image;
+using namespace geo2d;
+namespace filter
+{
+namespace crosscorrelation
+{
+
+namespace
+{
+
+// Relative costs, measured with benchmarkCrossCorrelation: one transform of n elements costs about
+// s_dftCostFactor * n * log2(n) multiply-adds of the spatial correlation, copying the image into the padded
+// buffer, multiplying the spectra and copying the result about s_elementCost per element.
+const double s_dftCostFactor = 0.7;
+const double s_elementCost = 2.0;
+
+cv::Size dftSize(Size p_oImageSize)
+{
+    // no wrap around in the valid region, as the kernel never exceeds the image
+    return cv::Size(cv::getOptimalDFTSize(p_oImageSize.width), cv::getOptimalDFTSize(p_oImageSize.height));
+}
+
+}
+
+CorrelationCost estimateCorrelationCost(Size p_oImageSize, Size p_oKernelSize, bool p_oSeparable, bool p_oCachedKernelSpectrum)
+{
+    CorrelationCost oCost;
+    if (p_oImageSize.width < p_oKernelSize.width || p_oImageSize.height < p_oKernelSize.height || p_oKernelSize.area() <= 0)
+    {
+        return oCost;
+    }
+    const double oOutputWidth = p_oImageSize.width - p_oKernelSize.width + 1;
+    const double oOutputHeight = p_oImageSize.height - p_oKernelSize.height + 1;
+    if (p_oSeparable)
+    {
+        // horizontal component on all rows, vertical component on the intermediate result
+        oCost.m_oSpatial = oOutputWidth * p_oImageSize.height * p_oKernelSize.width + oOutputWidth * oOutputHeight * p_oKernelSize.height;
+    }
+    else
+    {
+        oCost.m_oSpatial = oOutputWidth * oOutputHeight * p_oKernelSize.area();
+    }
+
+    const auto oDftSize = dftSize(p_oImageSize);
+    const double oNumElements = double(oDftSize.width) * oDftSize.height;
+    const double oTransformCost = s_dftCostFactor * oNumElements * std::log2(oNumElements);
+    // forward transform of the image and inverse transform, plus the transform of the kernel if not cached
+    const int oNumTransforms = p_oCachedKernelSpectrum ? 2 : 3;
+    oCost.m_oFrequencyDomain = oNumTransforms * oTransformCost + s_elementCost * oNumElements;
+    return oCost;
+}
+
+bool useFrequencyDomain(Size p_oImageSize, Size p_oKernelSize, bool p_oSeparable, bool p_oCachedKernelSpectrum)
+{
+    const auto oCost = estimateCorrelationCost(p_oImageSize, p_oKernelSize, p_oSeparable, p_oCachedKernelSpectrum);
+    return oCost.m_oFrequencyDomain < oCost.m_oSpatial;
+}
+
+bool FrequencyDomainCorrelation::hasKernelSpectrum(const DImage & p_rKernel1, const DImage & p_rKernel2, Size p_oImageSize) const
+{
+    return !m_oKernelSpectrum.empty() && m_oDftSize == dftSize(p_oImageSize) && isCachedKernel(p_rKernel1, p_rKernel2);
+}
+
+bool FrequencyDomainCorrelation::isCachedKernel(const DImage & p_rKernel1, const DImage & p_rKernel2) const
+{
+    if (m_oKernelSize1 != p_rKernel1.size() || m_oKernelSize2 != (p_rKernel2.isValid() ? p_rKernel2.size() : Size(0, 0)))
+    {
+        return false;
+    }
+    auto itCached = m_oKernelValues.begin();
+    for (const DImage * pKernel : {&p_rKernel1, &p_rKernel2})
+    {
+        if (!pKernel->isValid())
+        {
+            continue;
+        }
+        for (int y = 0; y < pKernel->height(); ++y)
+        {
+            if (!std::equal(pKernel->rowBegin(y), pKernel->rowEnd(y), itCached))
+            {
+                return false;
+            }
+            itCached += pKernel->width();
+        }
+    }
+    return true;
+}
+
+void FrequencyDomainCorrelation::preparePaddedImage(Size p_oImageSize)
+{
+    const auto oDftSize = dftSize(p_oImageSize);
+    if (oDftSize != m_oDftSize)
+    {
+        m_oDftSize = oDftSize;
+        m_oKernelSpectrum.release();
+        m_oPaddedImage = cv::Mat::zeros(oDftSize, CV_64F);
+    }
+    else if (p_oImageSize != m_oImageSize)
+    {
+        // clear the remaining pixels of a larger last image
+        m_oPaddedImage.setTo(0);
+    }
+    m_oImageSize = p_oImageSize;
+}
+
+void FrequencyDomainCorrelation::updateKernelSpectrum(const DImage & p_rKernel1, const DImage & p_rKernel2)
+{
+    if (!m_oKernelSpectrum.empty() && isCachedKernel(p_rKernel1, p_rKernel2))
+    {
+        return;
+    }
+
+    m_oKernelSize1 = p_rKernel1.size();
+    m_oKernelSize2 = p_rKernel2.isValid() ? p_rKernel2.size() : Size(0, 0);
+    m_oKernelValues.clear();
+    for (const DImage * pKernel : {&p_rKernel1, &p_rKernel2})
+    {
+        if (pKernel->isValid())
+        {
+            for (int y = 0; y < pKernel->height(); ++y)
+            {
+                m_oKernelValues.insert(m_oKernelValues.end(), pKernel->rowBegin(y), pKernel->rowEnd(y));
+            }
+        }
+    }
+
+    cv::Mat oPaddedKernel = cv::Mat::zeros(m_oDftSize, CV_64F);
+    if (p_rKernel2.isValid())
+    {
+        // outer product of the horizontal and the vertical component
+        for (int y = 0; y < p_rKernel2.height(); ++y)
+        {
+            const double oVertical = p_rKernel2.getValue(0, y);
+            auto pKernelRow = oPaddedKernel.ptr<double>(y);
+            for (int x = 0; x < p_rKernel1.width(); ++x)
+            {
+                pKernelRow[x] = p_rKernel1.getValue(x, 0) * oVertical;
+            }
+        }
+    }
+    else
+    {
+        for (int y = 0; y < p_rKernel1.height(); ++y)
+        {
+            std::copy(p_rKernel1.rowBegin(y), p_rKernel1.rowEnd(y), oPaddedKernel.ptr<double>(y));
+        }
+    }
+    const int oKernelHeight = p_rKernel2.isValid() ? p_rKernel2.height() : p_rKernel1.height();
+    cv::dft(oPaddedKernel, m_oKernelSpectrum, 0, oKernelHeight);
+}
+
+void FrequencyDomainCorrelation::correlate(Size p_oImageSize, Size p_oKernelSize, DImage & p_rImageOut)
+{
+    const Size oSizeOut(p_oImageSize.width - p_oKernelSize.width + 1, p_oImageSize.height - p_oKernelSize.height + 1);
+    p_rImageOut.resize(oSizeOut);
+
+    // the product with the conjugated kernel spectrum corresponds to the correlation (not the convolution) with the kernel
+    cv::dft(m_oPaddedImage, m_oImageSpectrum, 0, p_oImageSize.height);
+    cv::mulSpectrums(m_oImageSpectrum, m_oKernelSpectrum, m_oImageSpectrum, 0, true);
+    cv::dft(m_oImageSpectrum, m_oResult, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT | cv::DFT_SCALE, oSizeOut.height);
+
+    for (int y = 0; y < oSizeOut.height; ++y)
+    {
+        const double * pResultRow = m_oResult.ptr<double>(y);
+        std::copy(pResultRow, pResultRow + oSizeOut.width, p_rImageOut.rowBegin(y));
+    }
+}
+
+} // namespace crosscorrelation
+} // namespace filter
+} // namespace precitec
@@ -0,0 +1,114 @@
+/***
+*    @file
+*    @copyright        Precitec Vision GmbH & Co. KG
+*    @brief            Cross correlation in the frequency domain and selection between spatial and frequency domain
+*/
+
+#ifndef CROSSCORRELATIONFFT_H_
+#define CROSSCORRELATIONFFT_H_
+
+#include "image/image.h"
+#include "geo/size.h"
+
+#include "opencv2/core.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace precitec
+{
+namespace filter
+{
+namespace crosscorrelation
+{
+
+/**
+* Estimated cost of the correlation of an image with a kernel, in multiply-add operations of the spatial implementation.
+*/
+struct CorrelationCost
+{
+    double m_oSpatial = 0.0;
+    double m_oFrequencyDomain = 0.0;
+};
+
+/**
+* Estimates the cost of calcConvolution and of FrequencyDomainCorrelation for the valid region of an image.
+*
+* @param p_oSeparable              the kernel is given as horizontal and vertical component
+* @param p_oCachedKernelSpectrum   the spectrum of the kernel is already available (unchanged kernel and image size)
+*/
+CorrelationCost estimateCorrelationCost(geo2d::Size p_oImageSize, geo2d::Size p_oKernelSize, bool p_oSeparable, bool p_oCachedKernelSpectrum);
+
+/**
+* True if the correlation is expected to be faster in the frequency domain, see estimateCorrelationCost
+*/
+bool useFrequencyDomain(geo2d::Size p_oImageSize, geo2d::Size p_oKernelSize, bool p_oSeparable, bool p_oCachedKernelSpectrum);
+
+/**
+* Correlation of an image with a kernel via the discrete Fourier transform, computing the same valid region as calcConvolution.
+*
+* The spectrum of the kernel is kept and reused for the next images, as long as the kernel values and the image size
+* do not change. The buffers for the padded image and the spectra are reused as well.
+*
+* Tolerance: the result differs from calcConvolution by rounding errors of the transform only, which are below
+* 1e-12 * (sum of the absolute kernel values) * (maximum pixel value) for the image sizes in use.
+*/
+class FrequencyDomainCorrelation
+{
+public:
+    /**
+    * Computes the correlation of p_rImageIn with p_rKernel1 and saves the valid region to p_rImageOut.
+    * If p_rKernel2 is valid, p_rKernel1 is the horizontal (w x 1) and p_rKernel2 the vertical (1 x h) component of a separable kernel.
+    */
+    template <typename TPixelType>
+    void calcCorrelation(const image::TLineImage<TPixelType> & p_rImageIn,
+        const image::DImage & p_rKernel1, const image::DImage & p_rKernel2,
+        image::DImage & p_rImageOut);
+
+    /**
+    * True if the spectrum of the kernel is available for an image of the given size
+    */
+    bool hasKernelSpectrum(const image::DImage & p_rKernel1, const image::DImage & p_rKernel2, geo2d::Size p_oImageSize) const;
+
+private:
+    bool isCachedKernel(const image::DImage & p_rKernel1, const image::DImage & p_rKernel2) const;
+    void preparePaddedImage(geo2d::Size p_oImageSize);
+    void updateKernelSpectrum(const image::DImage & p_rKernel1, const image::DImage & p_rKernel2);
+    void correlate(geo2d::Size p_oImageSize, geo2d::Size p_oKernelSize, image::DImage & p_rImageOut);
+
+    std::vector<double> m_oKernelValues;        ///< kernel of the cached spectrum (both components of a separable kernel)
+    geo2d::Size m_oKernelSize1;
+    geo2d::Size m_oKernelSize2;
+    geo2d::Size m_oImageSize;                   ///< size of the last image in the padded buffer
+    cv::Size m_oDftSize;                        ///< padded size, the kernel spectrum is valid for this size
+    cv::Mat m_oKernelSpectrum;
+    cv::Mat m_oPaddedImage;
+    cv::Mat m_oImageSpectrum;
+    cv::Mat m_oResult;
+};
+
+template <typename TPixelType>
+void FrequencyDomainCorrelation::calcCorrelation(const image::TLineImage<TPixelType> & p_rImageIn,
+    const image::DImage & p_rKernel1, const image::DImage & p_rKernel2,
+    image::DImage & p_rImageOut)
+{
+    const geo2d::Size oKernelSize(p_rKernel1.width(), p_rKernel2.isValid() ? p_rKernel2.height() : p_rKernel1.height());
+    assert(oKernelSize.width <= p_rImageIn.width() && oKernelSize.height <= p_rImageIn.height());
+
+    preparePaddedImage(p_rImageIn.size());
+    updateKernelSpectrum(p_rKernel1, p_rKernel2);
+
+    // the padding outside of the image is zero since the allocation
+    for (int y = 0; y < p_rImageIn.height(); ++y)
+    {
+        std::copy(p_rImageIn.rowBegin(y), p_rImageIn.rowEnd(y), m_oPaddedImage.ptr<double>(y));
+    }
+    correlate(p_rImageIn.size(), oKernelSize, p_rImageOut);
+}
+
+} // namespace crosscorrelation
+} // namespace filter
+} // namespace precitec
+
+#endif /*CROSSCORRELATIONFFT_H_*/
@@ -15,6 +15,7 @@
 #include "math/descriptiveStats.h"
 #include <numeric> //accumulate
 #include "filter/algoImage.h"
+#include "crossCorrelationFFT.h"
 
 namespace precitec 
 {
@@ -231,7 +232,8 @@ namespace crosscorrelation
 			const bool p_oFillOutputBorder, 
 			bool computeStats,
 			TOutputPixelType p_outputMin, TOutputPixelType p_outputMax,
-            TLineImage<int> & rIntegralImage            
+            TLineImage<int> & rIntegralImage,
+            FrequencyDomainCorrelation & rFrequencyDomainCorrelation
         )
 		{
 			//input sanity check should be done before calling this function, these asserts are for debug only
@@ -275,7 +277,13 @@ namespace crosscorrelation
 
 			bool useSeparableKernel = p_oKernel2.isValid();
 	
-			if ( useSeparableKernel )
+			// large kernels are faster in the frequency domain, see estimateCorrelationCost
+			if ( useFrequencyDomain(rImage.size(), p_oKernelSize, useSeparableKernel,
+				rFrequencyDomainCorrelation.hasKernelSpectrum(p_oKernel1, p_oKernel2, rImage.size())) )
+			{
+				rFrequencyDomainCorrelation.calcCorrelation(rImage, p_oKernel1, p_oKernel2, oCrossCorrelationResult);
+			}
+			else if ( useSeparableKernel )
 			{
 				assert(p_oKernelSize.width == p_oKernel1.width() && p_oKernelSize.height == p_oKernel2.height());
 				DImage oCCorr1;
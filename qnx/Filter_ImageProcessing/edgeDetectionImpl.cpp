@@ -12,6 +12,7 @@
 #endif // #if defined __QNX__ || defined __linux__
 // local includes
 #include "edgeDetectionImpl.h"
+#include "kernel3X3.h"
 
 #include "image/image.h"				///< BImage
 
@@ -20,7 +21,11 @@
 #include <new>
 #include <cmath>
 // std lib includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace precitec {
 	using namespace image;
@@ -67,6 +72,8 @@ int roberts(const BImage& p_rSource, BImage& p_rDestin, int pMode)
 
 
 
+namespace {
+
 //Gx
 //1 0 -1
 //2 0 -2
@@ -77,111 +84,28 @@ int roberts(const BImage& p_rSource, BImage& p_rDestin, int pMode)
 // 0  0  0
 //-1 -2 -1
 
-/**
-* @brief					performs roberts edge detection with the filter masks above
-* @param p_rSource	        input image
-* @param p_rDestin		    result image
-* @param pMode              decides filtering of the detected edges
-*/
-int sobel(const BImage& p_rSource, BImage& p_rDestin,int pMode)
-{
-
-	//byte const *sLine;
-	//byte *dLine0, *dLine1, *dLine2;
-
-	int height = p_rSource.size().height;
-	int width  = p_rSource.size().width;
-	int *pIntImage = NULL;
-	int *pRemember = NULL;
-	int max = -10000;
-	int min = 10000;
-
-
-
-	if (pMode > 0)
-	{
-		pIntImage = new int[height*width];
-		pRemember = pIntImage;
+/// |Gx| + |Gy| of the sobel masks above, at most 2040
+struct SobelOperator {
+	int operator()(const kernel3X3::Neighborhood &n) const {
+		const int oRawValueX = std::abs(n.a - n.c + 2 * n.d - 2 * n.f + n.g - n.i);
+		const int oRawValueY = std::abs(n.a + 2 * n.b + n.c - n.g - 2 * n.h - n.i);
+		return oRawValueX + oRawValueY;
 	}
 
-	//  Irgendwas initialisieren ?
-	//	p_rDestin.fill(255);
-
-	// Zeilen durchlaufen
-	for (int y = 1; y < height - 1; y++)
-	{
-		//Zeilenzugriffe Destination
-		const byte	*pLineInPre = p_rSource[y - 1];
-		const byte	*pLineInCur = p_rSource[y];
-		const byte	*pLineInPost = p_rSource[y + 1];
-
-		byte		*pLineOut = p_rDestin[y];
-
-
-		pLineOut[0] = 0; // fill boundary
-
-		//Spalten durchlaufen
-		for (int x = 1; x < width - 1; x++)
-		{
-			// Faltung mit Gx
-			const int	oRawValueX = std::abs(
-				pLineInPre[x - 1] - pLineInPre[x + 1]
-				+ 2 * pLineInCur[x - 1] - 2 * pLineInCur[x + 1]
-				+ pLineInPost[x - 1] - pLineInPost[x + 1]);
-
-			// Faltung mit Gy
-			const int	oRawValueY = std::abs(
-				pLineInPre[x - 1] + 2 * pLineInPre[x] + pLineInPre[x + 1]
-				- pLineInPost[x - 1] - 2 * pLineInPost[x] - pLineInPost[x + 1]);
-
-			//int oRawValueG = static_cast<byte>(  sqrt(oRawValueX*oRawValueX + oRawValueY*oRawValueY));
-
-			int oRawValueG = (  std::abs(oRawValueX) + std::abs(oRawValueY) );
-
-			if (pMode > 0)
-			{
-				// min max zum Normieren:
-				if (oRawValueG > max)
-					max = oRawValueG;
-				if (oRawValueG < min)
-					min = oRawValueG;
-
-				//zwischenspeichern
-				*pIntImage++ = oRawValueG;
-
-
-			}
-			else
-				pLineOut[x] = static_cast<byte>(std::min(oRawValueG, 255));	// prevent clipping
-		} // for
-		pLineOut[width - 1] = 0; // fill boundary
-	} // for
-
-	//Normieren
-	if (pMode > 0)
-	{
-		pIntImage = pRemember;
-		double diff = static_cast<double>(max - min);
-		for (int y = 1; y < height - 1; y++)
-		{
-			byte	*pLineOut = p_rDestin[y];
-			for (int x = 1; x < width - 1; x++)
-			{
-				pLineOut[x] = static_cast<byte>((255.0 / diff) *  static_cast<double> (*pRemember++ - min));
-			}
-		}
+#if HAVE_SSE4
+	__m128i operator()(const kernel3X3::Neighborhood8 &n) const {
+		using kernel3X3::abs16;
+		// vertical and horizontal [1 2 1] smoothing of the differences
+		const __m128i oDiffLeftRight = _mm_sub_epi16(_mm_add_epi16(n.a, n.g), _mm_add_epi16(n.c, n.i));
+		const __m128i oDiffCenterRow = _mm_sub_epi16(n.d, n.f);
+		const __m128i oRawValueX = abs16(_mm_add_epi16(oDiffLeftRight, _mm_add_epi16(oDiffCenterRow, oDiffCenterRow)));
+		const __m128i oDiffTopBottom = _mm_sub_epi16(_mm_add_epi16(n.a, n.c), _mm_add_epi16(n.g, n.i));
+		const __m128i oDiffCenterColumn = _mm_sub_epi16(n.b, n.h);
+		const __m128i oRawValueY = abs16(_mm_add_epi16(oDiffTopBottom, _mm_add_epi16(oDiffCenterColumn, oDiffCenterColumn)));
+		return _mm_add_epi16(oRawValueX, oRawValueY);
 	}
-
-	std::memset(p_rDestin[0], 0, width);
-	std::memset(p_rDestin[height - 1], 0, width);
-
-	if (pMode >0)
-		delete[] pIntImage;
-
-	return(0);
-
-}//sobel
-
+#endif
+}; // SobelOperator
 
 
 //G0
@@ -203,138 +127,148 @@ int sobel(const BImage& p_rSource, BImage& p_rDestin,int pMode)
 //0  -1  -2
 //1   0  -1
 //2   1   0
-/**
-* @brief					performs kirsch edge detection with the filter masks above
-* @param p_rSource	        input image
-* @param p_rDestin		    result image
-* @param pMode              decides filtering of the detected edges
-*/
 
-int kirsch(const BImage& p_rSource, BImage& p_rDestin, int pMode)
-{
-
-	//byte const *sLine;
-	//byte *dLine0, *dLine1, *dLine2;
+/// Maximum of the absolute responses to the kirsch masks above, at most 1020
+struct KirschOperator {
+	int operator()(const kernel3X3::Neighborhood &n) const {
+		const int oRawValue0 = std::abs(-n.a + n.c - 2 * n.d + 2 * n.f - n.g + n.i);
+		const int oRawValue1 = std::abs(-2 * n.a - n.b - n.d + n.f + n.h + 2 * n.i);
+		const int oRawValue2 = std::abs(-n.a - 2 * n.b - n.c + n.g + 2 * n.h + n.i);
+		const int oRawValue3 = std::abs(-n.b - 2 * n.c + n.d - n.f + 2 * n.g + n.h);
+		return std::max(std::max(oRawValue0, oRawValue1), std::max(oRawValue2, oRawValue3));
+	}
 
-	int height = p_rSource.size().height;
-	int width = p_rSource.size().width;
-	int *pIntImage = NULL;
-	int *pRemember = NULL;
-	int max = -10000;
-	int min = 10000;
+#if HAVE_SSE4
+	__m128i operator()(const kernel3X3::Neighborhood8 &n) const {
+		using kernel3X3::abs16;
+		auto twice = [] (__m128i p_oValue) { return _mm_add_epi16(p_oValue, p_oValue); };
+		const __m128i oRawValue0 = abs16(_mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(n.c, n.i), twice(n.f)), _mm_add_epi16(_mm_add_epi16(n.a, n.g), twice(n.d))));
+		const __m128i oRawValue1 = abs16(_mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(n.f, n.h), twice(n.i)), _mm_add_epi16(_mm_add_epi16(n.b, n.d), twice(n.a))));
+		const __m128i oRawValue2 = abs16(_mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(n.g, n.i), twice(n.h)), _mm_add_epi16(_mm_add_epi16(n.a, n.c), twice(n.b))));
+		const __m128i oRawValue3 = abs16(_mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(n.d, n.h), twice(n.g)), _mm_add_epi16(_mm_add_epi16(n.b, n.f), twice(n.c))));
+		return _mm_max_epi16(_mm_max_epi16(oRawValue0, oRawValue1), _mm_max_epi16(oRawValue2, oRawValue3));
+	}
+#endif
+}; // KirschOperator
 
 
-	if (pMode > 0)
-	{
-		pIntImage = new int[height*width];
-		pRemember = pIntImage;
+/**
+* Keeps the raw gradients and their range for the normalization. The buffer is reused by the following images of the thread.
+*/
+class NormalizeSink {
+public:
+	explicit NormalizeSink(const BImage &p_rImage) : m_oWidth(p_rImage.width()) {
+		auto &rBuffer = buffer();
+		if (rBuffer.size() < std::size_t(p_rImage.width()) * p_rImage.height()) {
+			rBuffer.resize(std::size_t(p_rImage.width()) * p_rImage.height());
+		}
+		m_pGradients = rBuffer.data();
 	}
 
-	//  Irgendwas initialisieren ?
-	//	p_rDestin.fill(255);
+	void store(int x, int y, int p_oValue) {
+		m_pGradients[y * m_oWidth + x] = static_cast<std::int16_t>(p_oValue);
+		m_oMin = std::min(m_oMin, p_oValue);
+		m_oMax = std::max(m_oMax, p_oValue);
+	}
 
-	// Zeilen durchlaufen
-	for (int y = 1; y < height - 1; y++)
-	{
-		//Zeilenzugriffe Destination
-		const byte	*pLineInPre = p_rSource[y - 1];
-		const byte	*pLineInCur = p_rSource[y];
-		const byte	*pLineInPost = p_rSource[y + 1];
+#if HAVE_SSE4
+	void store(int x, int y, __m128i p_oLow, __m128i p_oHigh) {
+		__m128i *pGradients = reinterpret_cast<__m128i*>(m_pGradients + y * m_oWidth + x);
+		_mm_storeu_si128(pGradients, p_oLow);
+		_mm_storeu_si128(pGradients + 1, p_oHigh);
+		m_oMin16 = _mm_min_epi16(m_oMin16, _mm_min_epi16(p_oLow, p_oHigh));
+		m_oMax16 = _mm_max_epi16(m_oMax16, _mm_max_epi16(p_oLow, p_oHigh));
+	}
+#endif
+
+	/**
+	* Maps the gradients of the inner pixels linearly from [min, max] to [0, 255], with the same rounding as the former per pixel computation.
+	* An image without any gradient variation stays zero.
+	*/
+	void normalize(BImage &p_rImageOut) {
+#if HAVE_SSE4
+		std::int16_t oLanes[8];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(oLanes), m_oMin16);
+		m_oMin = std::min<int>(m_oMin, *std::min_element(oLanes, oLanes + 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(oLanes), m_oMax16);
+		m_oMax = std::max<int>(m_oMax, *std::max_element(oLanes, oLanes + 8));
+#endif
+		if (m_oMax < m_oMin) {
+			return; // no inner pixels
+		}
+		const double diff = static_cast<double>(m_oMax - m_oMin);
+		std::array<byte, 2048> oLookUp;
+		for (int i = 0; i <= m_oMax - m_oMin; i++) {
+			oLookUp[i] = diff > 0 ? static_cast<byte>((255.0 / diff) * static_cast<double>(i)) : 0;
+		}
+		for (int y = 1; y < p_rImageOut.height() - 1; y++) {
+			const std::int16_t *pGradients = m_pGradients + y * m_oWidth;
+			byte *pLineOut = p_rImageOut[y];
+			for (int x = 1; x < m_oWidth - 1; x++) {
+				pLineOut[x] = oLookUp[pGradients[x] - m_oMin];
+			}
+		}
+	}
 
-		byte		*pLineOut = p_rDestin[y];
+private:
+	static std::vector<std::int16_t> &buffer() {
+		static thread_local std::vector<std::int16_t> s_oBuffer;
+		return s_oBuffer;
+	}
 
+	const int m_oWidth;
+	std::int16_t *m_pGradients;
+	int m_oMin = std::numeric_limits<int>::max();
+	int m_oMax = std::numeric_limits<int>::min();
+#if HAVE_SSE4
+	__m128i m_oMin16 = _mm_set1_epi16(std::numeric_limits<std::int16_t>::max());
+	__m128i m_oMax16 = _mm_set1_epi16(std::numeric_limits<std::int16_t>::min());
+#endif
+}; // NormalizeSink
+
+/// Applies the operator to all inner pixels, normalized (pMode > 0) or clipped to 255, and clears the border
+template <typename TOperator>
+void edgeImage(const BImage &p_rSource, BImage &p_rDestin, int pMode) {
+	if (pMode > 0) {
+		NormalizeSink oSink(p_rSource);
+		kernel3X3::forEachInnerPixel<true>(p_rSource, TOperator(), oSink);
+		oSink.normalize(p_rDestin);
+	}
+	else {
+		kernel3X3::ClipSink oSink(p_rDestin);
+		kernel3X3::forEachInnerPixel<true>(p_rSource, TOperator(), oSink);
+	}
+	kernel3X3::clearBorder(p_rDestin);
+}
 
-		pLineOut[0] = 0; // fill boundary
+} // namespace
 
-		//Spalten durchlaufen
-		for (int x = 1; x < width - 1; x++)
-		{
 
-			// Faltung mit G0
-			//-1 0 1
-			//-2 0 2
-			//-1 0 1
-			const int	oRawValue0 = std::abs(
-				-1 * pLineInPre[x - 1]  + pLineInPre[x + 1]      +
-				-2 * pLineInCur[x - 1]  +  2 * pLineInCur[x + 1] +
-				-1 * pLineInPost[x - 1] + pLineInPost[x + 1]
-				);
-
-			// Faltung mit G1
-			//-2  -1  0
-			//-1   0  1
-			// 0   1  2
-			const int	oRawValue1 = std::abs(
-				-2 * pLineInPre[x - 1] - pLineInPre[x]     +
-				-1 * pLineInCur[x - 1] + pLineInCur[x + 1] +
-				pLineInPost[x] + 2 * pLineInPost[x + 1]
-				);
-
-			//Faltung mit G2
-			//-1  -2  -1
-			// 0   0   0
-			// 1   2   1
-			const int	oRawValue2 = std::abs(
-				-1 * pLineInPre[x - 1] - 2 * pLineInPre[x]  -pLineInPre[x + 1] +
-				pLineInPost[x - 1] + 2 * pLineInPost[x] + pLineInPost[x + 1]
-			);
-
-			//Faltung mit G3
-			//0  -1  -2
-			//1   0  -1
-			//2   1   0
-			const int	oRawValue3 = std::abs(
-				-1 * pLineInPre[x]  - 2 * pLineInPre[x + 1] +
-				pLineInCur[x - 1] - pLineInCur[x + 1] +
-				2* pLineInPost[x - 1] + pLineInPost[x]
-				);
-
-			//max der 4 Werte
-			int oRawValueG = (std::max(oRawValue0, oRawValue1));
-			oRawValueG     = (std::max(oRawValueG, oRawValue2));
-			oRawValueG     = (std::max(oRawValueG, oRawValue3));
-
-
-			if (pMode > 0)
-			{
-				// min max zum Normieren:
-				if (oRawValueG > max)
-					max = oRawValueG;
-				if (oRawValueG < min)
-					min = oRawValueG;
-
-				//zwischenspeichern
-				*pIntImage++ = oRawValueG;
+/**
+* @brief					performs sobel edge detection, |Gx| + |Gy| of the sobel masks
+* @param p_rSource	        input image
+* @param p_rDestin		    result image
+* @param pMode              decides filtering of the detected edges
+*/
+int sobel(const BImage& p_rSource, BImage& p_rDestin,int pMode)
+{
+	edgeImage<SobelOperator>(p_rSource, p_rDestin, pMode);
+	return(0);
 
+}//sobel
 
-			}
-			else
-				pLineOut[x] = static_cast<byte>(std::min(oRawValueG, 255));	// prevent clipping
-		} // for
-		pLineOut[width - 1] = 0; // fill boundary
-	} // for
-
-	//Normieren
-	if (pMode > 0)
-	{
-		pIntImage = pRemember;
-		double diff = static_cast<double>(max - min);
-		for (int y = 1; y < height - 1; y++)
-		{
-			byte	*pLineOut = p_rDestin[y];
-			for (int x = 1; x < width - 1; x++)
-			{
-				pLineOut[x] = static_cast<byte>((255.0 / diff) *  static_cast<double> (*pRemember++ - min));
-			}
-		}
-	}
 
-	std::memset(p_rDestin[0], 0, width);
-	std::memset(p_rDestin[height - 1], 0, width);
 
-	if (pMode >0)
-		delete[] pIntImage;
+/**
+* @brief					performs kirsch edge detection, maximum response of the four kirsch masks
+* @param p_rSource	        input image
+* @param p_rDestin		    result image
+* @param pMode              decides filtering of the detected edges
+*/
 
+int kirsch(const BImage& p_rSource, BImage& p_rDestin, int pMode)
+{
+	edgeImage<KirschOperator>(p_rSource, p_rDestin, pMode);
 	return(0);
 
 }//kirsch
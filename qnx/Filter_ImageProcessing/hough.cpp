@@ -9,6 +9,7 @@
 #define _USE_MATH_DEFINES						/// pi constant
 #include "hough.h"
 #include "lookup.h"								/// Provides lookup table for trigonometric sin and cos functions.
+#include "houghVoting.h"						/// edge orientation, parallel voting
 
 #include "system/platform.h"					/// global and platform specific defines
 #include "system/tools.h"						/// poco bugcheck
@@ -34,8 +35,8 @@ const std::string Hough::m_oPipeOut2Name = std::string("PositionRight");
 const std::string Hough::m_oPipeOutCandidateName = std::string("HoughPPCandidate");
 
 
-const static std::size_t		LU_SIZE				= 360;					///< lookup table size. value experimentally found - tradeoff between high computation time and low quantization error
-const static Lookup<LU_SIZE>	g_oLookup			= Lookup<LU_SIZE>();	///< lookup table for sin and cos
+const static std::size_t		LU_SIZE				= houghvoting::g_oNumLineAngles;		///< lookup table size. value experimentally found - tradeoff between high computation time and low quantization error
+const static Lookup<LU_SIZE>	&g_oLookup			= houghvoting::lineAngleLookup();	///< lookup table for sin and cos, shared with the voting
 const static double				g_oMIN_ANGLE_RAD	= - M_PI;				///< define from cmath
 const static double				g_oMAX_ANGLE_RAD	= + M_PI;				///< define from cmath
 
@@ -227,32 +228,13 @@ Hough::calcHough(const BImage&	p_rImageIn, HoughPPCandidate & houghCandiate)
 	poco_assert_dbg(oAngleMinInd		<= static_cast<int>( LU_SIZE ));
 	poco_assert_dbg(oAngleMaxInd		<= static_cast<int>( LU_SIZE ));
 
-	m_oHistogram.assign( oHistRadiusSize, std::vector<int>(oHistAngleSize, 0) ); // reset.
+	m_oHistogram.assign( oHistRadiusSize * oHistAngleSize, 0 ); // reset. row major, radius x phi
 
 	houghCandiate.m_oTwoLinesFound = false;
 
-	// fill hough histogram
-
-	for (int oY = 0; oY < oImgHeight; ++oY) {
-		const byte	*pLineInCur		= p_rImageIn[oY]; // transform hough space y index
-		for (int oX = 0; oX < oImgWidth; ++oX) {
-			if (pLineInCur[oX] == 0){ // accumulate over all non-zero positions
-				continue;
-			} // if
-
-			for (int oAngleInd = oAngleMinInd; oAngleInd < oAngleMaxInd; ++oAngleInd) { // all angles of our hough space
-				const int	oYOff	= oY - oHalfImgHeight; // the origin of our hough space lies at (0, oHalfImgHeight)
-				const int	oRadius = roundToT<int>( std::abs(
-					oX		* g_oLookup.m_oCos[oAngleInd] +
-					oYOff	* g_oLookup.m_oSin[oAngleInd] ) );
-				const int	oAngleHist	= oAngleInd - oAngleMinInd; // map angle lookup index to histogram index
-				poco_assert_dbg(oAngleHist >= 0);
-				poco_assert_dbg(oAngleHist < oHistAngleSize);
-				poco_assert_dbg(oRadius < oHistRadiusSize);
-				++ m_oHistogram[oRadius][oAngleHist];
-			} // for
-		} // for
-	} // for
+	// fill hough histogram, see houghvoting::LineVoting. The touched blocks of the histogram are only tracked together with
+	// the orientation, otherwise most of the histogram has votes anyway.
+	const bool		oUseOrientation	= m_oLineVoting.accumulate(p_rImageIn, oAngleMinInd, oAngleMaxInd, m_oHistogram, m_oTouchedBlocks);
 
 	// find maximum in hough space
 
@@ -260,67 +242,73 @@ Hough::calcHough(const BImage&	p_rImageIn, HoughPPCandidate & houghCandiate)
 	auto oHoughMax	= std::make_tuple(0, 0, 0);
 	auto oPrevVal	= 0;
 	auto oIsNewMax	= false;
-	int oRadInd		= 0;
 	int oRank		= 255;
 
 	// convert length limit from % in Pixel
 	m_oMinLineLengthPix = int(m_oMinLineLength/100 * oImgHeight);
 
-	if (m_oSearchStart == eRight)		// from right
-	{
-		for (oRadInd = oHistRadiusSize-1; oRadInd >= 0; --oRadInd) {
-			for (int oPhiInd = 0; oPhiInd < oHistAngleSize; ++oPhiInd) {
-				const auto oCurrVal = m_oHistogram[oRadInd][oPhiInd];
+	auto oFindMaxima = [&](int oRadInd, int oPhiInd) {
+		const auto oCurrVal = m_oHistogram[oRadInd * oHistAngleSize + oPhiInd];
 
-				if (oCurrVal < (int)m_oMinLineLengthPix ) { // ignore short lines
-					continue;
-				} // if
+		if (oCurrVal < (int)m_oMinLineLengthPix ) { // ignore short lines
+			return;
+		} // if
 
-				// save maxima if is new maximum and next value smaller (falling curve)
+		// save maxima if is new maximum and next value smaller (falling curve)
 
-				if (oIsNewMax && oCurrVal < oPrevVal) {
-					m_oMaxima.push_back(oHoughMax);
-					oIsNewMax = false;
-					oHoughMax = std::make_tuple(0, 0, 0);
-				} // if
+		if (oIsNewMax && oCurrVal < oPrevVal) {
+			m_oMaxima.push_back(oHoughMax);
+			oIsNewMax = false;
+			oHoughMax = std::make_tuple(0, 0, 0);
+		} // if
 
-				// new maximum if curr val bigger than old max and bigger than prev value (rising curve)
+		// new maximum if curr val bigger than old max and bigger than prev value (rising curve)
 
-				if (oCurrVal > std::get<eMax>(oHoughMax) && oCurrVal > oPrevVal) {
-					oHoughMax = std::make_tuple(oCurrVal, oRadInd, oPhiInd + oAngleMinInd); // add min angle offset to phi
-					oIsNewMax = true;
-				} // if
+		if (oCurrVal > std::get<eMax>(oHoughMax) && oCurrVal > oPrevVal) {
+			oHoughMax = std::make_tuple(oCurrVal, oRadInd, oPhiInd + oAngleMinInd); // add min angle offset to phi
+			oIsNewMax = true;
+		} // if
+
+		oPrevVal = oCurrVal;
+	};
 
-				oPrevVal = oCurrVal;
+	if (oUseOrientation && m_oMinLineLengthPix > 0) {
+		// Ignored cells do not change the search state, so it is sufficient to visit the cells above the limit, in the same order.
+		// They are all in the touched blocks, which are in ascending order.
+		m_oCandidateCells.clear();
+		for (const auto oBlock : m_oTouchedBlocks) {
+			const int oFirst	= oBlock * houghvoting::g_oCellsPerBlock;
+			const int oLast		= std::min<int>(oFirst + houghvoting::g_oCellsPerBlock, m_oHistogram.size());
+			for (int oIndex = oFirst; oIndex < oLast; ++oIndex) {
+				if (m_oHistogram[oIndex] >= (int)m_oMinLineLengthPix) {
+					m_oCandidateCells.push_back(oIndex);
+				} // if
+			} // for
+		} // for
+		if (m_oSearchStart == eRight) { // from right: descending radius, ascending phi
+			std::sort(std::begin(m_oCandidateCells), std::end(m_oCandidateCells), [oHistAngleSize](int p_oFirst, int p_oSecond) {
+				const int oFirstRad		= p_oFirst / oHistAngleSize;
+				const int oSecondRad	= p_oSecond / oHistAngleSize;
+				return oFirstRad > oSecondRad || (oFirstRad == oSecondRad && p_oFirst < p_oSecond);
+			});
+		} // if
+		for (const auto oIndex : m_oCandidateCells) {
+			oFindMaxima(oIndex / oHistAngleSize, oIndex % oHistAngleSize);
+		} // for
+	}
+	else if (m_oSearchStart == eRight)		// from right
+	{
+		for (int oRadInd = oHistRadiusSize-1; oRadInd >= 0; --oRadInd) {
+			for (int oPhiInd = 0; oPhiInd < oHistAngleSize; ++oPhiInd) {
+				oFindMaxima(oRadInd, oPhiInd);
 			} // for
 		} // for
 	}
 	else // from left
 	{
-		for (oRadInd = 0; oRadInd < oHistRadiusSize; ++oRadInd) {
+		for (int oRadInd = 0; oRadInd < oHistRadiusSize; ++oRadInd) {
 			for (int oPhiInd = 0; oPhiInd < oHistAngleSize; ++oPhiInd) {
-				const auto oCurrVal = m_oHistogram[oRadInd][oPhiInd];
-
-				if (oCurrVal < (int)m_oMinLineLengthPix ) { // ignore short lines
-					continue;
-				} // if
-
-				// save maxima if is new maximum and next value smaller (falling curve)
-
-				if (oIsNewMax && oCurrVal < oPrevVal) {
-					m_oMaxima.push_back(oHoughMax);
-					oIsNewMax = false;
-					oHoughMax = std::make_tuple(0, 0, 0);
-				} // if
-
-				// new maximum if curr val bigger than old max and bigger than prev value (rising curve)
-
-				if (oCurrVal > std::get<eMax>(oHoughMax) && oCurrVal > oPrevVal) {
-					oHoughMax = std::make_tuple(oCurrVal, oRadInd, oPhiInd + oAngleMinInd); // add min angle offset to phi
-					oIsNewMax = true;
-				} // if
-
-				oPrevVal = oCurrVal;
+				oFindMaxima(oRadInd, oPhiInd);
 			} // for
 		} // for
 	}
@@ -507,7 +495,7 @@ Hough::calcHough(const BImage&	p_rImageIn, HoughPPCandidate & houghCandiate)
 			byte		*pLine		= m_oHoughImage[oRad];
 			for (int oPhi = 0; oPhi < oHistAngleSize; ++oPhi) {
 				// treat hough space as image. phi hist and img x sizes are equal
-				pLine[oPhi] = static_cast<byte>( double(m_oHistogram[oRad][oPhi]) / oMax * 255 ); // map to 8 bit
+				pLine[oPhi] = static_cast<byte>( double(m_oHistogram[oRad * oHistAngleSize + oPhi]) / oMax * 255 ); // map to 8 bit
 			} // for
 		} // for
 	} // if
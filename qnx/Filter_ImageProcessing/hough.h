@@ -17,6 +17,7 @@
 #include "fliplib/SynchronePipe.h"		///< in- / output
 #include "filter/parameterEnums.h"
 #include "geo/houghPPCandidate.h"
+#include "houghVoting.h"
 
 #include "common/frame.h"				///< ImageFrame
 #include "geo/geo.h"					///< GeoPointarray
@@ -48,7 +49,6 @@ private:
 
 	typedef fliplib::SynchronePipe<interface::ImageFrame>			image_pipe_t;
 	typedef fliplib::SynchronePipe< interface::GeoDoublearray >		scalar_pipe_t;
-	typedef std::vector<std::vector<int>>							vector_int_2d_t;
 	typedef std::tuple<int, int, int>								triple_int_t;
 	typedef std::vector<triple_int_t>								vector_triple_int_t;
 
@@ -107,7 +107,10 @@ private:
 	interface::SmpTrafo					m_oSpTrafo;				/// roi translation	
 	geo2d::Size							m_oImageSize;			///< image size	
 	vector_triple_int_t					m_oMaxima;				/// hough space maxima
-	vector_int_2d_t						m_oHistogram;			/// hough space accumulator. x, y -> phi, radius
+	std::vector<int>					m_oHistogram;			/// hough space accumulator. x, y -> phi, radius, row major
+	std::vector<unsigned int>			m_oTouchedBlocks;		/// blocks of the accumulator with votes
+	std::vector<int>					m_oCandidateCells;		/// accumulator cells above the min line length
+	houghvoting::LineVoting				m_oLineVoting;			/// parallel voting of the edge pixels into m_oHistogram
 	image::BImage						m_oHoughImage;
 
 	double                              m_oMaxima0_LineFkt_b;   /// Line function factor b of Maxima0
@@ -0,0 +1,282 @@
+/***
+*    @file
+*    @copyright        Precitec Vision GmbH & Co. KG
+*    @brief            Helpers of the hough filters: edge orientation and parallel accumulation of the votes
+*/
+
+#include "houghVoting.h"
+
+#include <cmath>
+#include <utility>
+
+namespace precitec
+{
+using namespace image;
+namespace filter
+{
+namespace houghvoting
+{
+
+namespace
+{
+
+const int s_neighborhoodRadius = 3;
+// minimal (l1 - l2) / (l1 + l2) of the eigenvalues of the second moments, 0 for isotropic and 1 for collinear points
+const double s_minCoherence = 0.5;
+const int s_minNeighbors = 3;
+
+// below about 0.2 ms of work per worker, handing the work over and merging the partition costs more than it saves
+const std::size_t s_minVotesPerWorker = 1 << 17;
+const std::size_t s_maxWorkers = 4;
+
+}
+
+void findEdgePoints(const BImage & p_rImage, byte p_oThreshold, std::vector<EdgePoint> & p_rEdgePoints)
+{
+    p_rEdgePoints.clear();
+    const int oWidth = p_rImage.width();
+    const int oHeight = p_rImage.height();
+    for (int y = 0; y < oHeight; ++y)
+    {
+        const byte * pRow = p_rImage[y];
+        for (int x = 0; x < oWidth; ++x)
+        {
+            if (pRow[x] <= p_oThreshold)
+            {
+                continue;
+            }
+
+            // moments of the set pixels in the neighborhood, relative to the current pixel
+            int oCount = 0;
+            int oSumX = 0;
+            int oSumY = 0;
+            int oSumXX = 0;
+            int oSumXY = 0;
+            int oSumYY = 0;
+            const int oFirstX = std::max(x - s_neighborhoodRadius, 0) - x;
+            const int oLastX = std::min(x + s_neighborhoodRadius, oWidth - 1) - x;
+            for (int dy = std::max(y - s_neighborhoodRadius, 0) - y, oLastY = std::min(y + s_neighborhoodRadius, oHeight - 1) - y; dy <= oLastY; ++dy)
+            {
+                const byte * pNeighborRow = p_rImage[y + dy] + x;
+                for (int dx = oFirstX; dx <= oLastX; ++dx)
+                {
+                    if (pNeighborRow[dx] > p_oThreshold)
+                    {
+                        ++oCount;
+                        oSumX += dx;
+                        oSumY += dy;
+                        oSumXX += dx * dx;
+                        oSumXY += dx * dy;
+                        oSumYY += dy * dy;
+                    }
+                }
+            }
+
+            EdgePoint oPoint{x, y, 0.0, false};
+            if (oCount >= s_minNeighbors)
+            {
+                const double oMeanX = double(oSumX) / oCount;
+                const double oMeanY = double(oSumY) / oCount;
+                const double oVarX = double(oSumXX) / oCount - oMeanX * oMeanX;
+                const double oVarY = double(oSumYY) / oCount - oMeanY * oMeanY;
+                const double oCovXY = double(oSumXY) / oCount - oMeanX * oMeanY;
+                const double oAnisotropy = std::sqrt((oVarX - oVarY) * (oVarX - oVarY) + 4 * oCovXY * oCovXY);
+                if (oAnisotropy >= s_minCoherence * (oVarX + oVarY))
+                {
+                    // the main axis is the tangent of the edge, the normal is perpendicular
+                    const double oTangent = 0.5 * std::atan2(2 * oCovXY, oVarX - oVarY);
+                    oPoint.m_oNormal = oTangent < M_PI_2 ? oTangent + M_PI_2 : oTangent - M_PI_2;
+                    if (oPoint.m_oNormal >= M_PI)
+                    {
+                        oPoint.m_oNormal = 0.0;
+                    }
+                    oPoint.m_oOriented = true;
+                }
+            }
+            p_rEdgePoints.push_back(oPoint);
+        }
+    }
+}
+
+WorkerPool & WorkerPool::instance()
+{
+    static WorkerPool s_instance;
+    return s_instance;
+}
+
+WorkerPool::WorkerPool()
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_oStop = true;
+    }
+    m_oJobQueued.notify_all();
+    for (auto & rThread : m_oThreads)
+    {
+        rThread.join();
+    }
+}
+
+void WorkerPool::run(std::size_t p_oNumTasks, const std::function<void(std::size_t)> & p_rTask)
+{
+    if (p_oNumTasks == 0)
+    {
+        return;
+    }
+    Batch oBatch{&p_rTask, p_oNumTasks - 1};
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        // the workers are only started once, numWorkers limits the tasks to the number of cores
+        while (m_oThreads.size() < std::min(p_oNumTasks, s_maxWorkers) - 1)
+        {
+            m_oThreads.emplace_back(&WorkerPool::work, this);
+        }
+        for (std::size_t oTask = 1; oTask < p_oNumTasks; ++oTask)
+        {
+            m_oJobs.push_back(Job{&oBatch, oTask});
+        }
+    }
+    m_oJobQueued.notify_all();
+
+    p_rTask(0);
+
+    // take back the tasks no worker has started yet
+    std::vector<std::size_t> oOwnTasks;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        const auto itOwn = std::stable_partition(m_oJobs.begin(), m_oJobs.end(), [&oBatch] (const Job & p_rJob) { return p_rJob.m_pBatch != &oBatch; });
+        for (auto itJob = itOwn; itJob != m_oJobs.end(); ++itJob)
+        {
+            oOwnTasks.push_back(itJob->m_oTask);
+        }
+        m_oJobs.erase(itOwn, m_oJobs.end());
+        oBatch.m_oNumQueued -= oOwnTasks.size();
+    }
+    for (const auto oTask : oOwnTasks)
+    {
+        p_rTask(oTask);
+    }
+
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    m_oJobFinished.wait(oLock, [&oBatch] { return oBatch.m_oNumQueued == 0; });
+}
+
+void WorkerPool::work()
+{
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    while (true)
+    {
+        m_oJobQueued.wait(oLock, [this] { return m_oStop || !m_oJobs.empty(); });
+        if (m_oStop)
+        {
+            return;
+        }
+        const Job oJob = m_oJobs.front();
+        m_oJobs.pop_front();
+        oLock.unlock();
+        (*oJob.m_pBatch->m_pTask)(oJob.m_oTask);
+        oLock.lock();
+        if (--oJob.m_pBatch->m_oNumQueued == 0)
+        {
+            m_oJobFinished.notify_all();
+        }
+    }
+}
+
+std::size_t VotingPartitions::numWorkers(std::size_t p_oNumVotes)
+{
+    static const std::size_t s_numCores = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::max<std::size_t>(std::min({s_maxWorkers, s_numCores, p_oNumVotes / s_minVotesPerWorker}), 1);
+}
+
+const Lookup<g_oNumLineAngles> & lineAngleLookup()
+{
+    static const Lookup<g_oNumLineAngles> s_lookup;
+    return s_lookup;
+}
+
+bool LineVoting::accumulate(const BImage & p_rImage, int p_oAngleMinInd, int p_oAngleMaxInd, std::vector<int> & p_rHistogram,
+    std::vector<unsigned int> & p_rTouchedBlocks)
+{
+    const auto & rLookup = lineAngleLookup();
+    const int oImgWidth = p_rImage.width();
+    const int oImgHeight = p_rImage.height();
+    const int oHalfImgHeight = roundToT<int>(oImgHeight / 2.);
+    const int oHistAngleSize = p_oAngleMaxInd - p_oAngleMinInd + 1;
+
+    const double oIndexPerRad = g_oNumLineAngles / (2 * M_PI);
+    const double oToleranceInd = g_oOrientationToleranceDegrees * M_PI / 180. * oIndexPerRad;
+    const int oNumAnglesOriented = std::min(2 * int(oToleranceInd) + 1, p_oAngleMaxInd - p_oAngleMinInd);
+    const bool oUseOrientation = 2 * oNumAnglesOriented < p_oAngleMaxInd - p_oAngleMinInd;
+
+    const auto oVote = [&] (int p_oX, int p_oY, int p_oAngleIndStart, int p_oAngleIndEnd, VoteCounter & p_rCounter)
+    {
+        const int oYOff = p_oY - oHalfImgHeight; // the origin of the hough space lies at (0, oHalfImgHeight)
+        for (int oAngleInd = p_oAngleIndStart; oAngleInd < p_oAngleIndEnd; ++oAngleInd)
+        {
+            const int oRadius = roundToT<int>(std::abs(p_oX * rLookup.m_oCos[oAngleInd] + oYOff * rLookup.m_oSin[oAngleInd]));
+            p_rCounter(oRadius * oHistAngleSize + oAngleInd - p_oAngleMinInd);
+        }
+    };
+
+    if (!oUseOrientation)
+    {
+        // the workers share the rows, every non-zero position votes for all angles
+        // the number of votes only decides the number of workers, every 8th row is sufficient for the estimate
+        std::size_t oNumVotes = 0;
+        for (int oY = 0; oY < oImgHeight; oY += 8)
+        {
+            const byte * pRow = p_rImage[oY];
+            oNumVotes += std::count_if(pRow, pRow + oImgWidth, [] (byte p_oValue) { return p_oValue != 0; });
+        }
+        oNumVotes *= 8 * (p_oAngleMaxInd - p_oAngleMinInd);
+
+        m_oVotingPartitions.accumulate(p_rHistogram.data(), p_rHistogram.size(), oImgHeight, oNumVotes, nullptr,
+            [&] (std::size_t p_oY, VoteCounter & p_rCounter)
+            {
+                const byte * pRow = p_rImage[p_oY];
+                for (int oX = 0; oX < oImgWidth; ++oX)
+                {
+                    if (pRow[oX] != 0)
+                    {
+                        oVote(oX, p_oY, p_oAngleMinInd, p_oAngleMaxInd, p_rCounter);
+                    }
+                }
+            });
+        return false;
+    }
+
+    findEdgePoints(p_rImage, 0, m_oEdgePoints);
+    std::size_t oNumVotes = 0;
+    for (const auto & rPoint : m_oEdgePoints)
+    {
+        oNumVotes += rPoint.m_oOriented ? oNumAnglesOriented : p_oAngleMaxInd - p_oAngleMinInd;
+    }
+
+    m_oVotingPartitions.accumulate(p_rHistogram.data(), p_rHistogram.size(), m_oEdgePoints.size(), oNumVotes, &p_rTouchedBlocks,
+        [&] (std::size_t p_oIndex, VoteCounter & p_rCounter)
+        {
+            const auto & rPoint = m_oEdgePoints[p_oIndex];
+            if (!rPoint.m_oOriented)
+            {
+                oVote(rPoint.m_oX, rPoint.m_oY, p_oAngleMinInd, p_oAngleMaxInd, p_rCounter);
+                return;
+            }
+            // the normal is in [0, PI), the angles of the hough space are in [-PI; PI]
+            for (int oTurn = -2; oTurn <= 1; ++oTurn)
+            {
+                const double oCenterInd = (rPoint.m_oNormal + oTurn * M_PI) * oIndexPerRad + g_oNumLineAngles / 2;
+                oVote(rPoint.m_oX, rPoint.m_oY, std::max(p_oAngleMinInd, int(std::ceil(oCenterInd - oToleranceInd))),
+                    std::min(p_oAngleMaxInd, int(std::floor(oCenterInd + oToleranceInd)) + 1), p_rCounter);
+            }
+        });
+    return true;
+}
+
+} // namespace houghvoting
+} // namespace filter
+} // namespace precitec
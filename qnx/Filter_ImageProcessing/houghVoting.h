@@ -0,0 +1,308 @@
+/***
+*    @file
+*    @copyright        Precitec Vision GmbH & Co. KG
+*    @brief            Helpers of the hough filters: edge orientation and parallel accumulation of the votes
+*/
+
+#ifndef HOUGHVOTING_H_
+#define HOUGHVOTING_H_
+
+#include "image/image.h"
+#include "system/types.h"
+#include "lookup.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace precitec
+{
+namespace filter
+{
+namespace houghvoting
+{
+
+/**
+* Maximal deviation [deg] between the estimated orientation of an edge point and the orientation of the circle or line through it.
+* The estimate of findEdgePoints deviates by less than 13 degree on clean digital circles with a radius of 4 pixel and more
+* and an edge width up to 4 pixel. Noise pixels next to the edge add to the deviation: with 2% noise pixels, the peaks of
+* lines keep at least 97% of their votes.
+*/
+const double g_oOrientationToleranceDegrees = 25.0;
+
+/**
+* Pixel above the threshold with the orientation of the edge through it
+*/
+struct EdgePoint
+{
+    int m_oX;
+    int m_oY;
+    double m_oNormal;       ///< angle of the edge normal [rad] in [0, pi), only valid if m_oOriented
+    bool m_oOriented;       ///< false if the neighborhood does not define an edge (isolated points, filled areas, crossings)
+};
+
+/**
+* Collects all pixels above the threshold. The orientation of the edge is the main axis of the set pixels in the 7x7 neighborhood,
+* it is only used if the second moments of the neighborhood are sufficiently anisotropic.
+*/
+void findEdgePoints(const image::BImage & p_rImage, byte p_oThreshold, std::vector<EdgePoint> & p_rEdgePoints);
+
+/**
+* The touched parts of an accumulator are tracked in blocks of consecutive cells. Every vote sets the flag of its block,
+* the flags are small enough to stay in the cache. An unconditional store is cheaper than checking the flag first.
+*/
+const unsigned int g_oCellsPerBlock = 64;
+
+/**
+* Counts the votes into one accumulator and flags the blocks of the counted cells, if there are flags.
+*/
+class VoteCounter
+{
+public:
+    VoteCounter(int * p_pCells, byte * p_pBlockFlags)
+        : m_pCells(p_pCells)
+        , m_pBlockFlags(p_pBlockFlags)
+    {
+    }
+
+    void operator()(unsigned int p_oIndex)
+    {
+        ++m_pCells[p_oIndex];
+        if (m_pBlockFlags != nullptr)
+        {
+            m_pBlockFlags[p_oIndex / g_oCellsPerBlock] = 1;
+        }
+    }
+
+private:
+    int * m_pCells;
+    byte * m_pBlockFlags;
+};
+
+/**
+* Threads shared by all hough filters of the process. They are started with the first parallel accumulation and wait for work
+* between the images, so an image does not pay for starting threads. Several filters may use the pool at the same time.
+*/
+class WorkerPool
+{
+public:
+    static WorkerPool & instance();
+
+    /**
+    * Calls p_rTask(i) for all i in [0, p_oNumTasks) and returns when all calls are done. Task 0 runs on the calling thread,
+    * the others are queued for the workers. Queued tasks which no worker has started when the calling thread is done with
+    * task 0 are run by the calling thread, so a busy pool does not take longer than running all tasks on the calling thread.
+    */
+    void run(std::size_t p_oNumTasks, const std::function<void(std::size_t)> & p_rTask);
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool & operator=(const WorkerPool &) = delete;
+
+    void work();
+
+    struct Batch
+    {
+        const std::function<void(std::size_t)> * m_pTask;
+        std::size_t m_oNumQueued;       ///< tasks queued and not finished yet
+    };
+    struct Job
+    {
+        Batch * m_pBatch;
+        std::size_t m_oTask;
+    };
+
+    std::mutex m_oMutex;
+    std::condition_variable m_oJobQueued;
+    std::condition_variable m_oJobFinished;
+    std::deque<Job> m_oJobs;
+    std::vector<std::thread> m_oThreads;
+    bool m_oStop = false;
+};
+
+/**
+* Accumulates votes on several threads. Each worker counts its share of the items into a private accumulator (partition),
+* at the end the partitions are added to the result. If the touched blocks are tracked, only these are merged, so the cost
+* does not depend on the accumulator size. The partitions are kept zeroed for the next call.
+*
+* The cells of block b are [b * g_oCellsPerBlock, (b + 1) * g_oCellsPerBlock), all cells outside of the touched blocks stay zero.
+*/
+class VotingPartitions
+{
+public:
+    /**
+    * Calls p_oVote(item, counter) for all items in [0, p_oNumItems) and adds the votes to p_pAccumulator.
+    *
+    * @param p_pAccumulator     accumulator with p_oNumCells cells, all zero
+    * @param p_oNumVotes        expected total number of votes, decides the number of workers
+    * @param p_pTouchedBlocks   receives the indices of all blocks with at least one vote in ascending order, nullptr if not needed.
+    *                           Tracking the blocks costs about a fifth of the voting time.
+    */
+    template <typename TVote>
+    void accumulate(int * p_pAccumulator, std::size_t p_oNumCells, std::size_t p_oNumItems, std::size_t p_oNumVotes,
+        std::vector<unsigned int> * p_pTouchedBlocks, TVote p_oVote);
+
+    /// Number of workers used for the given number of votes
+    static std::size_t numWorkers(std::size_t p_oNumVotes);
+
+private:
+    struct Partition
+    {
+        std::vector<int> m_oCells;
+        std::vector<byte> m_oBlockFlags;
+    };
+    std::vector<byte> m_oBlockFlags;            ///< flags of the result
+    std::vector<Partition> m_oPartitions;       ///< one for each additional worker
+};
+
+template <typename TVote>
+void VotingPartitions::accumulate(int * p_pAccumulator, std::size_t p_oNumCells, std::size_t p_oNumItems, std::size_t p_oNumVotes,
+    std::vector<unsigned int> * p_pTouchedBlocks, TVote p_oVote)
+{
+    const bool oTrackBlocks = p_pTouchedBlocks != nullptr;
+    const std::size_t oNumBlocks = (p_oNumCells + g_oCellsPerBlock - 1) / g_oCellsPerBlock;
+    if (m_oBlockFlags.size() < oNumBlocks)
+    {
+        m_oBlockFlags.resize(oNumBlocks, 0);
+    }
+    const std::size_t oNumWorkers = std::min(numWorkers(p_oNumVotes), std::max<std::size_t>(p_oNumItems, 1));
+
+    auto oCountVotes = [&p_oVote, p_oNumItems, oNumWorkers] (std::size_t p_oWorker, VoteCounter & p_rCounter)
+    {
+        const std::size_t oEnd = p_oNumItems * (p_oWorker + 1) / oNumWorkers;
+        for (std::size_t oItem = p_oNumItems * p_oWorker / oNumWorkers; oItem < oEnd; ++oItem)
+        {
+            p_oVote(oItem, p_rCounter);
+        }
+    };
+
+    // the calling thread counts the first share directly into the result
+    if (m_oPartitions.size() < oNumWorkers - 1)
+    {
+        m_oPartitions.resize(oNumWorkers - 1);
+    }
+    for (std::size_t oWorker = 1; oWorker < oNumWorkers; ++oWorker)
+    {
+        auto & rPartition = m_oPartitions[oWorker - 1];
+        if (rPartition.m_oCells.size() < p_oNumCells)
+        {
+            rPartition.m_oCells.resize(p_oNumCells, 0);
+            rPartition.m_oBlockFlags.resize(oNumBlocks, 0);
+        }
+    }
+    auto oCountShare = [this, &oCountVotes, p_pAccumulator, oTrackBlocks] (std::size_t p_oWorker)
+    {
+        if (p_oWorker == 0)
+        {
+            VoteCounter oCounter(p_pAccumulator, oTrackBlocks ? m_oBlockFlags.data() : nullptr);
+            oCountVotes(0, oCounter);
+            return;
+        }
+        auto & rPartition = m_oPartitions[p_oWorker - 1];
+        VoteCounter oCounter(rPartition.m_oCells.data(), oTrackBlocks ? rPartition.m_oBlockFlags.data() : nullptr);
+        oCountVotes(p_oWorker, oCounter);
+    };
+    if (oNumWorkers == 1)
+    {
+        oCountShare(0);
+    }
+    else
+    {
+        WorkerPool::instance().run(oNumWorkers, oCountShare);
+    }
+
+    for (std::size_t oWorker = 1; oWorker < oNumWorkers; ++oWorker)
+    {
+        auto & rPartition = m_oPartitions[oWorker - 1];
+        if (!oTrackBlocks)
+        {
+            for (std::size_t i = 0; i < p_oNumCells; ++i)
+            {
+                p_pAccumulator[i] += rPartition.m_oCells[i];
+            }
+            std::fill_n(rPartition.m_oCells.begin(), p_oNumCells, 0);
+            continue;
+        }
+        for (std::size_t oBlock = 0; oBlock < oNumBlocks; ++oBlock)
+        {
+            if (rPartition.m_oBlockFlags[oBlock] == 0)
+            {
+                continue;
+            }
+            m_oBlockFlags[oBlock] = 1;
+            int * pCells = rPartition.m_oCells.data() + oBlock * g_oCellsPerBlock;
+            int * pResult = p_pAccumulator + oBlock * g_oCellsPerBlock;
+            const std::size_t oNumCellsInBlock = std::min<std::size_t>(g_oCellsPerBlock, p_oNumCells - oBlock * g_oCellsPerBlock);
+            for (std::size_t i = 0; i < oNumCellsInBlock; ++i)
+            {
+                pResult[i] += pCells[i];
+                pCells[i] = 0;
+            }
+            rPartition.m_oBlockFlags[oBlock] = 0;
+        }
+    }
+
+    if (!oTrackBlocks)
+    {
+        return;
+    }
+    p_pTouchedBlocks->clear();
+    for (std::size_t oBlock = 0; oBlock < oNumBlocks; ++oBlock)
+    {
+        if (m_oBlockFlags[oBlock] != 0)
+        {
+            p_pTouchedBlocks->push_back(oBlock);
+            m_oBlockFlags[oBlock] = 0;
+        }
+    }
+}
+
+/**
+* Number of angle steps in [-pi, pi) of the line hough space.
+*/
+const std::size_t g_oNumLineAngles = 360;
+
+/**
+* Lookup table of the angles of the line hough space.
+*/
+const Lookup<g_oNumLineAngles> & lineAngleLookup();
+
+/**
+* Votes of the line hough filter. A line is given by the angle of its normal and its distance to (0, image height / 2), the angle
+* is an index of lineAngleLookup. The histogram is row major, distance x angle, with p_oAngleMaxInd - p_oAngleMinInd + 1 angles
+* in every row.
+*/
+class LineVoting
+{
+public:
+    /**
+    * Adds the votes of all non-zero pixels for the angles [p_oAngleMinInd, p_oAngleMaxInd) to p_rHistogram, which is zero and
+    * has a row for every distance up to the image diagonal.
+    *
+    * Pixels on an edge vote only for the angles close to the normal of the edge, which include the angle of any line through them.
+    * Pixels without orientation (isolated points, filled areas) vote for all angles. The orientation is only estimated if it saves
+    * a significant part of the votes, for a narrow angle range all pixels vote for all angles.
+    *
+    * @param p_rTouchedBlocks   receives the blocks of the histogram with votes, only if the orientation is used
+    * @return                   whether the orientation was used
+    */
+    bool accumulate(const image::BImage & p_rImage, int p_oAngleMinInd, int p_oAngleMaxInd, std::vector<int> & p_rHistogram,
+        std::vector<unsigned int> & p_rTouchedBlocks);
+
+private:
+    std::vector<EdgePoint> m_oEdgePoints;           ///< non-zero pixels of the image
+    VotingPartitions m_oVotingPartitions;           ///< accumulators of the worker threads
+};
+
+} // namespace houghvoting
+} // namespace filter
+} // namespace precitec
+
+#endif /*HOUGHVOTING_H_*/
@@ -0,0 +1,232 @@
+/***
+*    @file
+*    @copyright        Precitec Vision GmbH & Co. KG
+*    @brief            Row loop of the 3x3 filters (convolution, sobel, kirsch), vectorized with 16 bit lanes
+*/
+
+#ifndef KERNEL3X3_H_
+#define KERNEL3X3_H_
+
+#include <config-weldmaster.h>
+#include "image/image.h"
+#include "system/types.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#if HAVE_SSE4
+#include <immintrin.h>
+#endif
+
+namespace precitec
+{
+namespace filter
+{
+namespace kernel3X3
+{
+
+/**
+* 3x3 neighborhood of a pixel, the names follow the coefficients of the mask:
+*   a b c
+*   d e f
+*   g h i
+*/
+struct Neighborhood
+{
+    int a, b, c, d, e, f, g, h, i;
+};
+
+inline Neighborhood neighborhood(const byte * p_pPre, const byte * p_pCur, const byte * p_pPost, int x)
+{
+    return Neighborhood{p_pPre[x - 1], p_pPre[x], p_pPre[x + 1], p_pCur[x - 1], p_pCur[x], p_pCur[x + 1], p_pPost[x - 1], p_pPost[x], p_pPost[x + 1]};
+}
+
+#if HAVE_SSE4
+
+/// Neighborhoods of 8 consecutive pixels in 16 bit lanes
+struct Neighborhood8
+{
+    __m128i a, b, c, d, e, f, g, h, i;
+};
+
+/// Loads the neighborhoods of the pixels [x, x + 16), reads the columns [x - 1, x + 17)
+inline void neighborhood16(const byte * p_pPre, const byte * p_pCur, const byte * p_pPost, int x, Neighborhood8 & p_rLow, Neighborhood8 & p_rHigh)
+{
+    const __m128i oZero = _mm_setzero_si128();
+    auto oLoad = [oZero, x] (const byte * p_pLine, int p_oOffset, __m128i & p_rLow, __m128i & p_rHigh)
+    {
+        const __m128i oValue = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pLine + x + p_oOffset));
+        p_rLow = _mm_unpacklo_epi8(oValue, oZero);
+        p_rHigh = _mm_unpackhi_epi8(oValue, oZero);
+    };
+    oLoad(p_pPre, -1, p_rLow.a, p_rHigh.a);
+    oLoad(p_pPre, 0, p_rLow.b, p_rHigh.b);
+    oLoad(p_pPre, 1, p_rLow.c, p_rHigh.c);
+    oLoad(p_pCur, -1, p_rLow.d, p_rHigh.d);
+    oLoad(p_pCur, 0, p_rLow.e, p_rHigh.e);
+    oLoad(p_pCur, 1, p_rLow.f, p_rHigh.f);
+    oLoad(p_pPost, -1, p_rLow.g, p_rHigh.g);
+    oLoad(p_pPost, 0, p_rLow.h, p_rHigh.h);
+    oLoad(p_pPost, 1, p_rLow.i, p_rHigh.i);
+}
+
+/// Absolute value of signed 16 bit lanes, SSE2 has no abs instruction
+inline __m128i abs16(__m128i p_oValue)
+{
+    return _mm_max_epi16(p_oValue, _mm_sub_epi16(_mm_setzero_si128(), p_oValue));
+}
+
+#endif
+
+/**
+* Calls p_rOperator for all pixels except the one pixel border and passes the results to p_rSink.
+*
+* The operator computes the filter response from a Neighborhood (int operator()(const Neighborhood &)) and, if p_oSimd is set,
+* from a Neighborhood8 (__m128i operator()(const Neighborhood8 &)). Both must give the same result, the 16 bit results must not overflow.
+* The sink receives single results with store(x, y, int) and 16 results with store(x, y, __m128i low, __m128i high).
+* The border is not touched.
+*/
+template <bool p_oSimd, typename TOperator, typename TSink>
+void forEachInnerPixel(const image::BImage & p_rImageIn, const TOperator & p_rOperator, TSink & p_rSink)
+{
+    const int oWidth = p_rImageIn.width();
+    const int oHeight = p_rImageIn.height();
+    for (int y = 1; y < oHeight - 1; ++y)
+    {
+        const byte * pLineInPre = p_rImageIn[y - 1];
+        const byte * pLineInCur = p_rImageIn[y];
+        const byte * pLineInPost = p_rImageIn[y + 1];
+        int x = 1;
+#if HAVE_SSE4
+        if constexpr (p_oSimd)
+        {
+            for (; x + 16 < oWidth; x += 16)
+            {
+                Neighborhood8 oLow, oHigh;
+                neighborhood16(pLineInPre, pLineInCur, pLineInPost, x, oLow, oHigh);
+                p_rSink.store(x, y, p_rOperator(oLow), p_rOperator(oHigh));
+            }
+        }
+#endif
+        for (; x < oWidth - 1; ++x)
+        {
+            p_rSink.store(x, y, p_rOperator(neighborhood(pLineInPre, pLineInCur, pLineInPost, x)));
+        }
+    }
+}
+
+/**
+* Writes the non negative results, clipped to 255, to the output image.
+*/
+class ClipSink
+{
+public:
+    explicit ClipSink(image::BImage & p_rImageOut)
+        : m_rImageOut(p_rImageOut)
+    {
+    }
+
+    void store(int x, int y, int p_oValue)
+    {
+        m_rImageOut[y][x] = static_cast<byte>(std::min(p_oValue, 255));
+    }
+
+#if HAVE_SSE4
+    void store(int x, int y, __m128i p_oLow, __m128i p_oHigh)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(m_rImageOut[y] + x), _mm_packus_epi16(p_oLow, p_oHigh));
+    }
+#endif
+
+private:
+    image::BImage & m_rImageOut;
+};
+
+/// Sets the one pixel border of the image to zero
+inline void clearBorder(image::BImage & p_rImage)
+{
+    const int oWidth = p_rImage.width();
+    const int oHeight = p_rImage.height();
+    if (oWidth <= 0 || oHeight <= 0)
+    {
+        return;
+    }
+    std::fill_n(p_rImage[0], oWidth, 0);
+    for (int y = 1; y < oHeight - 1; ++y)
+    {
+        p_rImage[y][0] = 0;
+        p_rImage[y][oWidth - 1] = 0;
+    }
+    std::fill_n(p_rImage[oHeight - 1], oWidth, 0);
+}
+
+/**
+* Absolute value of the convolution with a general 3x3 mask. The coefficients are in row major order.
+*/
+class Convolution
+{
+public:
+    explicit Convolution(const std::array<int, 9> & p_rCoefficients)
+        : m_oCoefficients(p_rCoefficients)
+    {
+#if HAVE_SSE4
+        for (std::size_t k = 0; k < m_oCoefficients.size(); ++k)
+        {
+            m_oCoefficients16[k] = _mm_set1_epi16(static_cast<short>(m_oCoefficients[k]));
+        }
+#endif
+    }
+
+    /// The 16 bit lanes wrap around, the result is exact if the largest possible sum (sum of the absolute coefficients times 255) fits into them
+    bool fitsInt16() const
+    {
+        int oSum = 0;
+        for (const auto oCoefficient : m_oCoefficients)
+        {
+            if (std::abs(oCoefficient) > 128)
+            {
+                return false;
+            }
+            oSum += std::abs(oCoefficient);
+        }
+        return oSum * 255 <= 32767;
+    }
+
+    int operator()(const Neighborhood & n) const
+    {
+        const auto & C = m_oCoefficients;
+        return std::abs(
+            C[0] * n.a + C[1] * n.b + C[2] * n.c +
+            C[3] * n.d + C[4] * n.e + C[5] * n.f +
+            C[6] * n.g + C[7] * n.h + C[8] * n.i);
+    }
+
+#if HAVE_SSE4
+    __m128i operator()(const Neighborhood8 & n) const
+    {
+        const auto & C = m_oCoefficients16;
+        __m128i oSum = _mm_mullo_epi16(C[0], n.a);
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[1], n.b));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[2], n.c));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[3], n.d));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[4], n.e));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[5], n.f));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[6], n.g));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[7], n.h));
+        oSum = _mm_add_epi16(oSum, _mm_mullo_epi16(C[8], n.i));
+        return abs16(oSum);
+    }
+#endif
+
+private:
+    std::array<int, 9> m_oCoefficients;
+#if HAVE_SSE4
+    __m128i m_oCoefficients16[9];
+#endif
+};
+
+} // namespace kernel3X3
+} // namespace filter
+} // namespace precitec
+
+#endif /*KERNEL3X3_H_*/
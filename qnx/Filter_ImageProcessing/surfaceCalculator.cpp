@@ -15,6 +15,7 @@
 #include "image/image.h"
 #include "module/moduleLogger.h"
 #include "filter/algoImage.h"
+#include "tileStatistics.h"
 #include "filter/algoStl.h"
 #include "system/typeTraits.h"
 #include <fliplib/TypeToDataTypeImpl.h>
@@ -148,6 +149,27 @@ bool SurfaceCalculator::subscribe(BasePipe& p_rPipe, int p_oGroup)
         return oTileImgIn;
     };
 
+    // mean, variance and gradients of all tiles from summed area tables, computed in one pass over the image
+    int oFeatures = 0;
+    if ( rSurfaceInfo.usesMean || rSurfaceInfo.usesRelBrightness )
+    {
+        oFeatures |= TileStatistics::eMean;
+    }
+    if ( rSurfaceInfo.usesVariation )
+    {
+        oFeatures |= TileStatistics::eVariance;
+    }
+    if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceX )
+    {
+        oFeatures |= TileStatistics::eGradientX;
+    }
+    if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceY )
+    {
+        oFeatures |= TileStatistics::eGradientY;
+    }
+    TileStatistics oTileStatistics;
+    oTileStatistics.init(rImageIn, oFeatures);
+
     double meanValueSum = 0.0;
 
     if ( rSurfaceInfo.usesMean || rSurfaceInfo.usesRelBrightness )
@@ -158,9 +180,7 @@ bool SurfaceCalculator::subscribe(BasePipe& p_rPipe, int p_oGroup)
             {
                 SingleTile tile = tileContainer.getSingleTile(i, j);
 
-                const BImage oTileImgIn = fGetTileImage(tile);
-
-                double meanValue = calcMeanIntensity(oTileImgIn);
+                double meanValue = oTileStatistics.mean(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
                 meanValueSum += meanValue;
 
                 tile.m_MeanValue = meanValue;
@@ -187,13 +207,13 @@ bool SurfaceCalculator::subscribe(BasePipe& p_rPipe, int p_oGroup)
                 tile.m_isRelIntensityValid = true;
             }
 
-            // jetzt alle anderen
+            // jetzt alle anderen, die nicht aus den Summentabellen folgen
 
             const BImage oTileImgIn = fGetTileImage(tile);
 
             if ( rSurfaceInfo.usesVariation )
             {
-                double variation = calcVariance(oTileImgIn);
+                double variation = oTileStatistics.variance(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_Variation = variation;
                 tile.m_isVariationValid = true;
@@ -209,7 +229,7 @@ bool SurfaceCalculator::subscribe(BasePipe& p_rPipe, int p_oGroup)
 
             if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceX )
             {
-                double surfaceX = calcGradientSumX(oTileImgIn);
+                double surfaceX = oTileStatistics.gradientSumX(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_SurfaceX = surfaceX;
                 tile.m_isSurfaceXValid = rSurfaceInfo.usesSurfaceX;
@@ -217,7 +237,7 @@ bool SurfaceCalculator::subscribe(BasePipe& p_rPipe, int p_oGroup)
 
             if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceY )
             {
-                double surfaceY = calcGradientSumY(oTileImgIn);
+                double surfaceY = oTileStatistics.gradientSumY(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_SurfaceY = surfaceY;
                 tile.m_isSurfaceYValid = rSurfaceInfo.usesSurfaceY;
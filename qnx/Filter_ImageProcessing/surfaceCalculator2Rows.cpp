@@ -15,6 +15,7 @@
 #include "image/image.h"
 #include "module/moduleLogger.h"
 #include "filter/algoImage.h"
+#include "tileStatistics.h"
 #include "filter/algoStl.h"
 #include "system/typeTraits.h"
 #include <fliplib/TypeToDataTypeImpl.h>
@@ -183,6 +184,27 @@ void SurfaceCalculator2Rows::computeTiles ( const SurfaceInfo   & rSurfaceInfo,
         return oTileImgIn;
     };
 
+    // mean, variance and gradients of all tiles from summed area tables, computed in one pass over the image
+    int oFeatures = 0;
+    if ( rSurfaceInfo.usesMean || rSurfaceInfo.usesRelBrightness )
+    {
+        oFeatures |= TileStatistics::eMean;
+    }
+    if ( rSurfaceInfo.usesVariation )
+    {
+        oFeatures |= TileStatistics::eVariance;
+    }
+    if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceX )
+    {
+        oFeatures |= TileStatistics::eGradientX;
+    }
+    if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceY )
+    {
+        oFeatures |= TileStatistics::eGradientY;
+    }
+    TileStatistics oTileStatistics;
+    oTileStatistics.init(rImageIn, oFeatures);
+
     auto meanValueSum = 0.0;
 
     if ( rSurfaceInfo.usesMean || rSurfaceInfo.usesRelBrightness )
@@ -193,9 +215,7 @@ void SurfaceCalculator2Rows::computeTiles ( const SurfaceInfo   & rSurfaceInfo,
             {
                 SingleTile tile = tileContainer.getSingleTile(i, j);
 
-                const BImage oTileImgIn = fGetTileImage(tile);
-
-                const auto meanValue = calcMeanIntensity(oTileImgIn);
+                const auto meanValue = oTileStatistics.mean(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
                 meanValueSum += meanValue;
 
                 tile.m_MeanValue = meanValue;
@@ -226,13 +246,13 @@ void SurfaceCalculator2Rows::computeTiles ( const SurfaceInfo   & rSurfaceInfo,
                 tile.m_isRelIntensityValid = true;
             }
 
-            // Now all the other calculations
+            // Now all the other calculations, which do not follow from the summed area tables
 
             const BImage oTileImgIn = fGetTileImage(tile);
 
             if ( rSurfaceInfo.usesVariation )
             {
-                const auto variation = calcVariance(oTileImgIn);
+                const auto variation = oTileStatistics.variance(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_Variation = variation;
                 tile.m_isVariationValid = true;
@@ -248,7 +268,7 @@ void SurfaceCalculator2Rows::computeTiles ( const SurfaceInfo   & rSurfaceInfo,
 
             if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceX )
             {
-                const auto surfaceX = calcGradientSumX(oTileImgIn);
+                const auto surfaceX = oTileStatistics.gradientSumX(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_SurfaceX = surfaceX;
                 tile.m_isSurfaceXValid = rSurfaceInfo.usesSurfaceX;
@@ -256,7 +276,7 @@ void SurfaceCalculator2Rows::computeTiles ( const SurfaceInfo   & rSurfaceInfo,
 
             if ( rSurfaceInfo.usesSurface || rSurfaceInfo.usesSurfaceY )
             {
-                const auto surfaceY = calcGradientSumY(oTileImgIn);
+                const auto surfaceY = oTileStatistics.gradientSumY(tile.m_startX, tile.m_startY, tile.m_width, tile.m_height);
 
                 tile.m_SurfaceY = surfaceY;
                 tile.m_isSurfaceYValid = rSurfaceInfo.usesSurfaceY;
@@ -645,13 +645,43 @@ uint64_t normL2Squared(uint8_t *src, size_t height, size_t width,
 
 void crossCorrelation(const uint8_t *src, size_t srcHeight, size_t srcWidth,
     ptrdiff_t srcStride, const uint8_t *tmpl, size_t tmplHeight,
-    size_t tmplWidth, ptrdiff_t tmplStride, uint64_t *dst, ptrdiff_t dstStride)
+    size_t tmplWidth, ptrdiff_t tmplStride, uint64_t *dst, ptrdiff_t dstStride,
+    crosscorrelation::FrequencyDomainCorrelation &frequencyDomainCorrelation)
 {
     assert(srcHeight > tmplHeight);
     assert(srcWidth > tmplWidth);
     size_t dstHeight = srcHeight - tmplHeight + 1;
     size_t dstWidth = srcWidth - tmplWidth + 1;
 
+    const geo2d::Size srcSize(srcWidth, srcHeight);
+    const geo2d::Size tmplSize(tmplWidth, tmplHeight);
+    image::DImage kernel(tmplSize);
+    for (size_t u = 0; u < tmplHeight; ++u)
+    {
+        std::copy(tmpl + u * tmplStride, tmpl + u * tmplStride + tmplWidth, kernel.rowBegin(u));
+    }
+    if (crosscorrelation::useFrequencyDomain(srcSize, tmplSize, false, frequencyDomainCorrelation.hasKernelSpectrum(kernel, image::DImage{}, srcSize)))
+    {
+        image::BImage image(srcSize);
+        for (size_t r = 0; r < srcHeight; ++r)
+        {
+            std::copy(src + r * srcStride, src + r * srcStride + srcWidth, image.rowBegin(r));
+        }
+
+        image::DImage corr;
+        frequencyDomainCorrelation.calcCorrelation(image, kernel, image::DImage{}, corr);
+        // the rounding errors of the transform are far below 0.5, rounding gives the exact integer result
+        for (size_t r = 0; r < dstHeight; ++r, dst += dstStride)
+        {
+            const double *corrRow = corr.rowBegin(r);
+            for (size_t c = 0; c < dstWidth; ++c)
+            {
+                dst[c] = std::llround(corrRow[c]);
+            }
+        }
+        return;
+    }
+
     for (size_t r = 0; r < dstHeight; ++r, src += srcStride, dst += dstStride)
     {
         for (size_t c = 0; c < dstWidth; ++c)
@@ -6,6 +6,7 @@
 #include "common/frame.h"
 
 #include "shapeMatchingImpl.h"
+#include "crossCorrelationFFT.h"
 
 #include <vector>
 
@@ -65,9 +66,15 @@ void rotateImage(uint8_t *src, uint8_t *dst, size_t height,
 uint64_t normL2Squared(uint8_t *src, size_t height, size_t width,
     ptrdiff_t srcStride);
 
+/*
+Correlation of src with tmpl in the valid region. Large templates are correlated in the
+frequency domain with frequencyDomainCorrelation, which keeps the spectrum of the template
+as long as the template and the image size do not change. Keep it as a member of the caller.
+*/
 void crossCorrelation(const uint8_t *src, size_t srcHeight, size_t srcWidth,
     ptrdiff_t srcStride, const uint8_t *tmpl, size_t tmplHeight,
-    size_t tmplWidth, ptrdiff_t tmplStride, uint64_t *dst, ptrdiff_t dstStride);
+    size_t tmplWidth, ptrdiff_t tmplStride, uint64_t *dst, ptrdiff_t dstStride,
+    crosscorrelation::FrequencyDomainCorrelation &frequencyDomainCorrelation);
 
 /*
 Given a rectangle that has been rotated by 'angle' (in
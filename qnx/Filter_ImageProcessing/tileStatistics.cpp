@@ -0,0 +1,164 @@
+/**
+* 	@file
+* 	@copyright	Precitec Vision GmbH & Co. KG
+* 	@brief		Statistics of image tiles from summed area tables, shared by the SurfaceCalculator filters.
+*/
+
+#include "tileStatistics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace precitec {
+	using namespace image;
+namespace filter {
+
+namespace
+{
+
+/// Adds the row values to the sums of the previous table row, p_pTableRow points to column 0 of table row y + 1
+inline void accumulateRow(const std::uint32_t *p_pValues, int p_oWidth, std::uint32_t *p_pTableRow, int p_oStride)
+{
+	const std::uint32_t *pPreviousRow = p_pTableRow - p_oStride;
+	std::uint32_t oRowSum = 0;
+	for (int x = 0; x < p_oWidth; ++x) {
+		oRowSum += p_pValues[x];
+		p_pTableRow[x + 1] = pPreviousRow[x + 1] + oRowSum;
+	}
+}
+
+} // namespace
+
+
+
+void TileStatistics::init(const BImage &p_rImage, int p_oFeatures)
+{
+	const int oWidth = p_rImage.isValid() ? p_rImage.width() : 0;
+	const int oHeight = p_rImage.isValid() ? p_rImage.height() : 0;
+	m_oStride = oWidth + 1;
+
+	const std::size_t oTableSize = std::size_t(m_oStride) * (oHeight + 1);
+	auto fPrepareTable = [&] (std::vector<std::uint32_t> &rTable, bool p_oRequested)
+	{
+		if (!p_oRequested) {
+			rTable.clear();
+			return;
+		}
+		// only the first row and column need to be zero, the other entries are written below
+		rTable.resize(oTableSize);
+		std::fill(rTable.begin(), rTable.begin() + m_oStride, 0);
+		for (int y = 1; y <= oHeight; ++y) {
+			rTable[y * m_oStride] = 0;
+		}
+	};
+	// the variance uses the sum as well
+	fPrepareTable(m_oSum, p_oFeatures & (eMean | eVariance));
+	fPrepareTable(m_oSumSquare, p_oFeatures & eVariance);
+	fPrepareTable(m_oGradientX, p_oFeatures & eGradientX);
+	fPrepareTable(m_oGradientY, p_oFeatures & eGradientY);
+
+	// values of one image row, computed in separate loops which the compiler vectorizes
+	std::vector<std::uint32_t> oValues(oWidth);
+	for (int y = 0; y < oHeight; ++y) {
+		const byte *pLine = p_rImage[y];
+		const std::size_t oTableRow = std::size_t(y + 1) * m_oStride;
+
+		if (!m_oSum.empty()) {
+			for (int x = 0; x < oWidth; ++x) {
+				oValues[x] = pLine[x];
+			}
+			accumulateRow(oValues.data(), oWidth, &m_oSum[oTableRow], m_oStride);
+		}
+		if (!m_oSumSquare.empty()) {
+			for (int x = 0; x < oWidth; ++x) {
+				oValues[x] = pLine[x] * pLine[x];
+			}
+			accumulateRow(oValues.data(), oWidth, &m_oSumSquare[oTableRow], m_oStride);
+		}
+		if (!m_oGradientX.empty() && oWidth > 0) {
+			for (int x = 0; x < oWidth - 1; ++x) {
+				oValues[x] = std::abs(pLine[x] - pLine[x + 1]);
+			}
+			oValues[oWidth - 1] = 0;
+			accumulateRow(oValues.data(), oWidth, &m_oGradientX[oTableRow], m_oStride);
+		}
+		if (!m_oGradientY.empty()) {
+			if (y + 1 < oHeight) {
+				const byte *pNextLine = p_rImage[y + 1];
+				for (int x = 0; x < oWidth; ++x) {
+					oValues[x] = std::abs(pLine[x] - pNextLine[x]);
+				}
+			}
+			else {
+				std::fill(oValues.begin(), oValues.end(), 0);
+			}
+			accumulateRow(oValues.data(), oWidth, &m_oGradientY[oTableRow], m_oStride);
+		}
+	}
+} // init
+
+
+
+std::uint32_t TileStatistics::sum(const std::vector<std::uint32_t> &p_rTable, int p_oX, int p_oY, int p_oWidth, int p_oHeight) const
+{
+	assert(!p_rTable.empty());
+	assert(p_oX >= 0 && p_oY >= 0 && p_oX + p_oWidth < m_oStride && std::size_t(p_oY + p_oHeight) * m_oStride < p_rTable.size());
+	const std::size_t oTop = std::size_t(p_oY) * m_oStride;
+	const std::size_t oBottom = std::size_t(p_oY + p_oHeight) * m_oStride;
+	// unsigned overflow in the table cancels out in the difference
+	return p_rTable[oBottom + p_oX + p_oWidth] - p_rTable[oBottom + p_oX] - p_rTable[oTop + p_oX + p_oWidth] + p_rTable[oTop + p_oX];
+}
+
+
+
+double TileStatistics::mean(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const
+{
+	const int oNbPixels = p_oWidth * p_oHeight;
+	if (oNbPixels <= 0) {
+		return 0;
+	}
+	return double(sum(m_oSum, p_oX, p_oY, p_oWidth, p_oHeight)) / oNbPixels;
+}
+
+
+
+double TileStatistics::variance(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const
+{
+	const unsigned int oArea = p_oWidth * p_oHeight;
+	if (p_oWidth <= 0 || p_oHeight <= 0 || oArea - 1 == 0) {
+		return 0;
+	}
+	const unsigned int oSum = sum(m_oSum, p_oX, p_oY, p_oWidth, p_oHeight);
+	const unsigned int oSumSquare = sum(m_oSumSquare, p_oX, p_oY, p_oWidth, p_oHeight);
+	const unsigned int oMean = oSum / oArea;
+	const unsigned int oVariance = (oSumSquare - oMean * oSum) / (oArea - 1);
+	return oVariance;
+}
+
+
+
+double TileStatistics::gradientSumX(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const
+{
+	const int oArea = p_oHeight * (p_oWidth - 1);
+	if (p_oWidth <= 0 || p_oHeight <= 0 || oArea == 0) {
+		return 0;
+	}
+	const int oSumX = sum(m_oGradientX, p_oX, p_oY, p_oWidth - 1, p_oHeight);
+	return double(oSumX) / oArea;
+}
+
+
+
+double TileStatistics::gradientSumY(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const
+{
+	const int oArea = (p_oHeight - 1) * p_oWidth;
+	if (p_oWidth <= 0 || p_oHeight <= 0 || oArea == 0) {
+		return 0;
+	}
+	const int oSumY = sum(m_oGradientY, p_oX, p_oY, p_oWidth, p_oHeight - 1);
+	return double(oSumY) / oArea;
+}
+
+} // namespace filter
+} // namespace precitec
@@ -0,0 +1,68 @@
+/**
+* 	@file
+* 	@copyright	Precitec Vision GmbH & Co. KG
+* 	@brief		Statistics of image tiles from summed area tables, shared by the SurfaceCalculator filters.
+*/
+
+#ifndef TILESTATISTICS_H_
+#define TILESTATISTICS_H_
+
+#include "image/image.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace precitec {
+namespace filter {
+
+/**
+* Summed area tables of the pixel values, the squared pixel values and the absolute differences of
+* horizontally and vertically neighbouring pixels. All tables are computed in a single pass over the image,
+* afterwards the statistics of any tile are available in constant time.
+*
+* The results are identical to calcMeanIntensity, calcVariance, calcGradientSumX and calcGradientSumY
+* applied to the tile image: the tables hold 32 bit unsigned sums, the difference of four entries yields the
+* exact tile sum modulo 2^32, which is the unsigned int arithmetic of the original functions.
+*/
+class TileStatistics
+{
+public:
+	enum Feature
+	{
+		eMean		= 1 << 0,
+		eVariance	= 1 << 1,
+		eGradientX	= 1 << 2,
+		eGradientY	= 1 << 3
+	};
+
+	/**
+	* Computes the tables of the requested features (combination of Feature values).
+	*/
+	void init(const image::BImage &p_rImage, int p_oFeatures);
+
+	// The tile [x, x + width) x [y, y + height) must be inside the image.
+
+	/// same as calcMeanIntensity of the tile image
+	double mean(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const;
+	/// same as calcVariance of the tile image
+	double variance(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const;
+	/// same as calcGradientSumX of the tile image
+	double gradientSumX(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const;
+	/// same as calcGradientSumY of the tile image
+	double gradientSumY(int p_oX, int p_oY, int p_oWidth, int p_oHeight) const;
+
+private:
+	/// Sum of the table entries in [x, x + width) x [y, y + height)
+	std::uint32_t sum(const std::vector<std::uint32_t> &p_rTable, int p_oX, int p_oY, int p_oWidth, int p_oHeight) const;
+
+	int m_oStride = 0;								///< width of the tables, image width + 1
+	std::vector<std::uint32_t> m_oSum;
+	std::vector<std::uint32_t> m_oSumSquare;
+	std::vector<std::uint32_t> m_oGradientX;		///< |p(x, y) - p(x + 1, y)|, zero in the last column
+	std::vector<std::uint32_t> m_oGradientY;		///< |p(x, y) - p(x, y + 1)|, zero in the last row
+};
+
+} // namespace filter
+} // namespace precitec
+
+#endif /*TILESTATISTICS_H_*/
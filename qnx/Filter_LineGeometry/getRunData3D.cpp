@@ -155,6 +155,19 @@ bool GetRunData3D::get3DValues(const geo2d::VecDoublearray &p_rLine, const Vec3D
 	m_oLength = std::abs(oTo[0] - oFrom[0]);
 	m_oHeight = 0.0; double oZHeight = 0.0; m_oSurface = 0.0; int oIdx = -1;
 
+	// convert all points of the run with one call to the calibration
+	m_oRunPoints.clear();
+	for (int i=0; i < oLenScreen; ++i)
+	{
+		const int oYValInt = static_cast<int>(p_oStart[0] + i);
+		if (oRank[oYValInt] > eRankMin)
+		{
+			m_oRunPoints.emplace_back(oYValInt, static_cast<int>(oData[oYValInt]));
+		}
+	}
+	const std::vector<Vec3D> oRun3D = m_pCoordTransformer->imageCoordsTo3D(m_oRunPoints);
+	auto itRun3D = oRun3D.begin();
+
 	// traverse seam to find highest point
 	for (int i=0; i < oLenScreen; ++i)
 	{
@@ -165,7 +178,7 @@ bool GetRunData3D::get3DValues(const geo2d::VecDoublearray &p_rLine, const Vec3D
 			oYValScreen = oSlopeScreen*i + p_oStart[1];             // get screen y...
 			m_oYcoords[i].set(oYVal, oYValScreen);                 // and x coordinate for segment connecting start and endpoint of bead/gap
 
-			oCoord3D = m_pCoordTransformer->imageCoordTo3D(oYValInt, static_cast<int>(oData[oYValInt]));
+			oCoord3D = *itRun3D++;
 			oProj3D = oCoord3D.projOntoSegment(oSegment3D, false);
 			double oDist2 = oCoord3D.dist2(oProj3D);                // square of 3D distance from coord to its projection onto the segment joining start end end of seam
 			oZHeight = sqrt(oDist2);
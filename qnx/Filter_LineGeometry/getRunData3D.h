@@ -116,6 +116,7 @@ protected:
 	// for painting
 	int m_oYLeft, m_oYRight;        // for start and end of seam run
 	std::vector<Vec2DHomogeneous> m_oYcoords;     // the line segment between start and end of run
+	std::vector<geo2d::Point> m_oRunPoints;       // image points of the run, converted to 3D at once
 
 private:
 	bool m_oPaint;
@@ -66,7 +66,7 @@ void LineMovingAverage::setParameter()
 
 	poco_assert_dbg(m_oLowPassType >= FilterAlgorithmType::eTypeMin && m_oLowPassType <= FilterAlgorithmType::eTypeMax);	// Parameter assertion. Should be pre-checked by UI / MMI / GUI.
 	poco_assert_dbg(m_oFilterLength > 0);	// Parameter assertion. Should be pre-checked by UI / MMI / GUI.
-        assert(m_oValuesInWindow.size() == m_oFilterLength);
+        assert(m_oValuesInWindow.windowSize() == m_oFilterLength);
 
     //for performance reasons the actual algorithm used is passed as parameter in LineMovingAverage::proceed
 	switch (m_oLowPassType) {
@@ -86,7 +86,7 @@ private:
 	bool										m_oPassThroughBadRank;		///< if bad ranked values are always passed through and not eliminated
 
 	std::unique_ptr<MovingWindow<double>>		m_oUpLowPass;				///< boxcar filter
-	std::vector<double> m_oValuesInWindow;
+	SlidingMedian<double>						m_oValuesInWindow;			///< window of the median filter
 
 }; // LineMovingAverage
 
@@ -0,0 +1,73 @@
+#include <QTest>
+
+#include "../parallelMaximumKernel.h"
+
+#include <random>
+
+using precitec::image::BImage;
+
+class BenchmarkParallelMaximum : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkColumnMaximum_data();
+    void benchmarkColumnMaximum();
+};
+
+void BenchmarkParallelMaximum::benchmarkColumnMaximum_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("resX");
+    QTest::addColumn<bool>("scalar");
+
+    for (const auto& size : {std::make_pair(1024, 1024), std::make_pair(1280, 256)})
+    {
+        for (int resX : {1, 2, 4, 10})
+        {
+            for (bool scalar : {true, false})
+            {
+                const auto name = QStringLiteral("%1x%2 resX %3 %4").arg(size.first).arg(size.second).arg(resX).arg(scalar ? QStringLiteral("scalar") : QStringLiteral("simd"));
+                QTest::newRow(qPrintable(name)) << size.first << size.second << resX << scalar;
+            }
+        }
+    }
+}
+
+void BenchmarkParallelMaximum::benchmarkColumnMaximum()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, resX);
+    QFETCH(bool, scalar);
+
+    // noise with a laser line of 3 pixels
+    std::mt19937 generator{42};
+    BImage image{precitec::geo2d::Size{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            image[y][x] = generator() % 200;
+        }
+    }
+    for (int x = 0; x < width; x++)
+    {
+        const int y = height / 2 + (x / 16) % 20;
+        image[y][x] = 240;
+        image[y + 1][x] = 255;
+        image[y + 2][x] = 240;
+    }
+
+    std::vector<double> position(width, 0.0);
+    std::vector<int> rank(width, 0);
+    const auto function = scalar ? &precitec::filter::columnMaximumScalar : &precitec::filter::columnMaximum;
+    QBENCHMARK
+    {
+        function(image, 0, width, resX, 0, height, 1, 20, 230, position.data(), rank.data());
+    }
+    QCOMPARE(position[0], height / 2.0 + 1.0);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkParallelMaximum)
+#include "benchmarkParallelMaximum.moc"
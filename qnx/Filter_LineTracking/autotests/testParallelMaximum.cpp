@@ -0,0 +1,174 @@
+#include <QTest>
+
+#include "../parallelMaximum.h"
+#include "../parallelMaximumXT.h"
+#include "../parallelMaximumOriented.h"
+#include "../parallelMaximumKernel.h"
+
+#include <random>
+
+using precitec::image::BImage;
+using precitec::geo2d::Doublearray;
+using precitec::geo2d::VecDoublearray;
+
+class TestParallelMaximum : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testParMax_data();
+    void testParMax();
+    void testOrientedRoi();
+};
+
+namespace
+{
+
+/**
+ * Image with random background and a laser line of 3 pixels, the values depend on mode:
+ * 0 random, 1 few distinct values (many equal maxima), 2 saturated
+ **/
+BImage createImage(int width, int height, int mode, unsigned int seed)
+{
+    std::mt19937 generator{seed};
+    BImage image{precitec::geo2d::Size{width, height}};
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const auto random = generator();
+            image[y][x] = mode == 0 ? random % 256 : mode == 1 ? random % 4 * 80 : 200 + random % 3;
+        }
+    }
+    for (int x = 0; x < width; x++)
+    {
+        const int y = (x * 7 / 5) % height;
+        for (int i = 0; i < 3 && y + i < height; i++)
+        {
+            image[y + i][x] = 255;
+        }
+    }
+    return image;
+}
+
+/**
+ * Column by column search as done by ParallelMaximum before the row by row implementation
+ **/
+void referenceParMax(const BImage& image, int resX, int resY, unsigned int threshold, unsigned int maxLineWidth, Doublearray& line)
+{
+    for (int x = 0; x < image.width(); x += resX)
+    {
+        byte maxFirst = 0;
+        int indexFirst = 0;
+        int indexLast = 0;
+        for (int y = 0; y < image.height(); y += resY)
+        {
+            const byte value = image[y][x];
+            if (value > maxFirst)
+            {
+                maxFirst = value;
+                indexFirst = y;
+                indexLast = y;
+            }
+            else if (value == maxFirst && std::abs(indexFirst - y) <= int(maxLineWidth))
+            {
+                indexLast = y;
+            }
+        }
+        line.getData()[x] = maxFirst > threshold ? (indexFirst + indexLast) / 2.0 : 0.0;
+        line.getRank()[x] = maxFirst > threshold ? precitec::filter::eRankMax : precitec::filter::eRankMin;
+    }
+}
+
+VecDoublearray createLine(int width)
+{
+    // entries which are not sampled keep their value
+    VecDoublearray line(1);
+    line.front().assign(width, -1.0, 42);
+    return line;
+}
+
+}
+
+void TestParallelMaximum::testParMax_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("resX");
+    QTest::addColumn<int>("resY");
+    QTest::addColumn<unsigned int>("threshold");
+    QTest::addColumn<unsigned int>("maxLineWidth");
+
+    QTest::newRow("1024x1024") << 1024 << 1024 << 0 << 1 << 1 << 230u << 20u;
+    QTest::newRow("1280x256 resX 10") << 1280 << 256 << 0 << 10 << 1 << 230u << 20u;
+    QTest::newRow("equal maxima") << 640 << 300 << 1 << 1 << 1 << 200u << 5u;
+    QTest::newRow("equal maxima resX 3 resY 2") << 640 << 300 << 1 << 3 << 2 << 200u << 5u;
+    QTest::newRow("saturated") << 517 << 123 << 2 << 1 << 1 << 100u << 20u;
+    QTest::newRow("saturated width 0") << 517 << 123 << 2 << 2 << 1 << 100u << 0u;
+    QTest::newRow("saturated large width") << 517 << 123 << 2 << 1 << 3 << 100u << 0xFFFFFFF0u;
+    QTest::newRow("below threshold") << 300 << 100 << 2 << 1 << 1 << 255u << 20u;
+    QTest::newRow("narrow") << 15 << 40 << 0 << 1 << 1 << 230u << 20u;
+    QTest::newRow("resX 7") << 1000 << 64 << 1 << 7 << 1 << 200u << 10u;
+}
+
+void TestParallelMaximum::testParMax()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, mode);
+    QFETCH(int, resX);
+    QFETCH(int, resY);
+    QFETCH(unsigned int, threshold);
+    QFETCH(unsigned int, maxLineWidth);
+
+    const auto image = createImage(width, height, mode, width * height);
+    auto expected = createLine(width);
+    referenceParMax(image, resX, resY, threshold, maxLineWidth, expected.front());
+
+    auto line = createLine(width);
+    precitec::filter::ParallelMaximum::parMax(image, resX, resY, threshold, maxLineWidth, line);
+    QCOMPARE(line.front().getData(), expected.front().getData());
+    QCOMPARE(line.front().getRank(), expected.front().getRank());
+
+    line = createLine(width);
+    precitec::filter::ParallelMaximumXT::parMax(image, resX, resY, threshold, maxLineWidth, line);
+    QCOMPARE(line.front().getData(), expected.front().getData());
+    QCOMPARE(line.front().getRank(), expected.front().getRank());
+
+    line = createLine(width);
+    precitec::filter::ParallelMaximumOriented::parMax(image, resX, resY, threshold, maxLineWidth, true, line,
+        precitec::geo2d::Point{0, 0}, precitec::geo2d::Size{width, height});
+    QCOMPARE(line.front().getData(), expected.front().getData());
+    QCOMPARE(line.front().getRank(), expected.front().getRank());
+
+    line = createLine(width);
+    precitec::filter::columnMaximumScalar(image, 0, width, resX, 0, height, resY, maxLineWidth, threshold,
+        line.front().getData().data(), line.front().getRank().data());
+    QCOMPARE(line.front().getData(), expected.front().getData());
+    QCOMPARE(line.front().getRank(), expected.front().getRank());
+}
+
+void TestParallelMaximum::testOrientedRoi()
+{
+    // fine tracking searches in patches, the result is written at the absolute column
+    const auto image = createImage(400, 200, 1, 17);
+    for (int offsetX : {0, 3, 37})
+    {
+        for (int offsetY : {0, 11})
+        {
+            const precitec::geo2d::Size size{400 - offsetX - 5, 200 - offsetY - 7};
+
+            auto line = createLine(400);
+            precitec::filter::ParallelMaximumOriented::parMax(image, 2, 1, 200, 5, true, line, precitec::geo2d::Point{offsetX, offsetY}, size);
+
+            auto expected = createLine(400);
+            precitec::filter::columnMaximumScalar(image, offsetX, offsetX + size.width, 2, offsetY, offsetY + size.height, 1, 5, 200,
+                expected.front().getData().data(), expected.front().getRank().data());
+            QCOMPARE(line.front().getData(), expected.front().getData());
+            QCOMPARE(line.front().getRank(), expected.front().getRank());
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestParallelMaximum)
+#include "testParallelMaximum.moc"
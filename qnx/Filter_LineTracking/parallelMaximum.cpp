@@ -7,6 +7,7 @@
 
 
 #include "parallelMaximum.h"
+#include "parallelMaximumKernel.h"
 
 #include <system/platform.h>			///< global and platform specific defines
 #include <system/tools.h>				///< debug assert integrity assumptions
@@ -185,44 +186,10 @@ void ParallelMaximum::parMax(
 	auto &rLaserVectorOut = p_rLineOut.front().getData();
 	auto &rRankVectorOut = p_rLineOut.front().getRank();
 
-	for (int x = 0; x < oImgWidth; x += p_oResX) {
-		byte oMaxFirst = std::numeric_limits<byte>::min();
-		int oIndexFirst	= 0;
-		int oIndexLast	= 0;
-		for (int y = 0; y < oImgHeight; y += p_oResY) {
-			const byte* pLine = p_rImageIn[y]; // get line pointer
-			// std::cout << (int)pLine[x*p_oResX] << ' ';
-			if (pLine[x] > oMaxFirst) {
-				oMaxFirst	= pLine[x];
-				oIndexFirst	= y;
-				oIndexLast	= y;
-			}
-			// second maximum found if value remains equal first maximum
-			else if( pLine[x] == oMaxFirst ) {
-				// Falls dieser Pixel ausserdem in der nachbarschaft liegt
-				if (std::abs(oIndexFirst - y) <= (int)(p_oMaxLineWidth))
-				{
-					oIndexLast = y;
-				}
-			} // if
-		} // for
-		//std::cout << std::endl;
-		if (oMaxFirst > p_oThreshold) {
-			rLaserVectorOut[x + p_oOffset] = (static_cast<double>(oIndexFirst + oIndexLast) / (2.0) );
-			rRankVectorOut[x + p_oOffset] = eRankMax; // value set - full rank
-		}
-		else {
-			// Diese Methode wird im Zusammenhang des FineTrackings aufgerufen. In diesem Zusammenhang
-			// liegen bereits Daten im rLaserVector vor - d.h. der initiale Zustand ist gerade nicht der,
-			// dass der Rank schlecht ist. Wenn wir jetzt nichts gefunden haben, dann muss jetzt
-			// der Rank auf schlecht gesetzt werden, um sicherzustellen, dass das korrekt abgebildet ist.
-			//
-			// Im Zusammenhang eines Bugs hatten wir es tatsaechlich beobachtet, dass Daten vorhanden
-			// waren, die einen guten Rank hatten - aber tatsaechlich waren diese Daten falsch.
-			rLaserVectorOut[x + p_oOffset] = 0;
-			rRankVectorOut[x + p_oOffset] = eRankMin;
-		}
-	} // for
+	// Bei einem Fehlschlag wird der Rank explizit auf eRankMin gesetzt, da im Zusammenhang des FineTrackings
+	// bereits Daten mit gutem Rank im rLaserVector vorliegen koennen.
+	columnMaximum(p_rImageIn, 0, oImgWidth, p_oResX, 0, oImgHeight, p_oResY, p_oMaxLineWidth, p_oThreshold,
+		rLaserVectorOut.data() + p_oOffset, rRankVectorOut.data() + p_oOffset);
 } // parMax
 
 
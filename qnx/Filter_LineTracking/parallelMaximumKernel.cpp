@@ -0,0 +1,272 @@
+/*!
+ *  @copyright		Precitec Vision GmbH & Co. KG
+ *  @file
+ *  @brief			Maximum search shared by the ParallelMaximum filters.
+ */
+
+#include "parallelMaximumKernel.h"
+
+#include <config-weldmaster.h>
+#include "filter/parameterEnums.h"		///< eRankMax
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#if HAVE_SSE4
+#include <immintrin.h>
+#endif
+
+namespace precitec {
+namespace filter {
+
+namespace
+{
+
+/// Row indices are held in 16 bit lanes by the SIMD implementation
+const int s_maxSimdRow = std::numeric_limits<std::int16_t>::max();
+/// Up to this step all columns are processed, for larger steps the sampled columns are copied into a buffer first
+const int s_maxContiguousResX = 4;
+
+void setResult(byte p_oMax, int p_oIndexFirst, int p_oIndexLast, std::uint32_t p_oThreshold, double &p_rPosition, int &p_rRank)
+{
+	if (p_oMax > p_oThreshold) {
+		p_rPosition = static_cast<double>(p_oIndexFirst + p_oIndexLast) / 2.0;
+		p_rRank = eRankMax;
+	}
+	else {
+		p_rPosition = 0;
+		p_rRank = eRankMin;
+	}
+}
+
+#if HAVE_SSE4
+
+/// Running maximum, first and last row of the maximum for each column of the processed range
+struct ColumnState
+{
+	explicit ColumnState(int p_oWidth) : m_oMax(p_oWidth, 0), m_oIndexFirst(p_oWidth, 0), m_oIndexLast(p_oWidth, 0) {}
+	std::vector<byte> m_oMax;
+	std::vector<std::int16_t> m_oIndexFirst;
+	std::vector<std::int16_t> m_oIndexLast;
+};
+
+inline __m128i blend(__m128i p_oMask, __m128i p_oA, __m128i p_oB)
+{
+	return _mm_or_si128(_mm_and_si128(p_oMask, p_oA), _mm_andnot_si128(p_oMask, p_oB));
+}
+
+/// Updates first and last row of 8 columns, p_oGreater and p_oEqual are 16 bit masks
+inline void updateIndex(std::int16_t *p_pFirst, std::int16_t *p_pLast, __m128i p_oGreater, __m128i p_oEqual, __m128i p_oY, __m128i p_oMaxLineWidth)
+{
+	const __m128i oFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pFirst));
+	const __m128i oLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pLast));
+	const __m128i oTooFar = _mm_cmpgt_epi16(_mm_sub_epi16(p_oY, oFirst), p_oMaxLineWidth);
+	const __m128i oUpdateLast = _mm_or_si128(p_oGreater, _mm_andnot_si128(oTooFar, p_oEqual));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p_pFirst), blend(p_oGreater, p_oY, oFirst));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p_pLast), blend(oUpdateLast, p_oY, oLast));
+}
+
+/// Adds row p_pLine to the columns [p_oX, p_oX + 16) of the state
+inline void addRow16(const byte *p_pLine, ColumnState &p_rState, int p_oX, __m128i p_oY, __m128i p_oMaxLineWidth)
+{
+	const __m128i oValue = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_pLine + p_oX));
+	const __m128i oMax = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_rState.m_oMax.data() + p_oX));
+	const __m128i oNewMax = _mm_max_epu8(oValue, oMax);
+	const __m128i oGreater = _mm_xor_si128(_mm_cmpeq_epi8(oNewMax, oMax), _mm_set1_epi8(-1));
+	const __m128i oEqual = _mm_cmpeq_epi8(oValue, oMax);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p_rState.m_oMax.data() + p_oX), oNewMax);
+
+	updateIndex(p_rState.m_oIndexFirst.data() + p_oX, p_rState.m_oIndexLast.data() + p_oX,
+		_mm_unpacklo_epi8(oGreater, oGreater), _mm_unpacklo_epi8(oEqual, oEqual), p_oY, p_oMaxLineWidth);
+	updateIndex(p_rState.m_oIndexFirst.data() + p_oX + 8, p_rState.m_oIndexLast.data() + p_oX + 8,
+		_mm_unpackhi_epi8(oGreater, oGreater), _mm_unpackhi_epi8(oEqual, oEqual), p_oY, p_oMaxLineWidth);
+}
+
+/// Provides the pixels of a row for the state columns, column i of the state is image column xStart + i * step
+class RowReader
+{
+public:
+	RowReader(const image::BImage &p_rImage, int p_oXStart, int p_oStep, int p_oWidth)
+		: m_rImage(p_rImage), m_oXStart(p_oXStart), m_oStep(p_oStep), m_oBuffer(p_oStep > 1 ? p_oWidth : 0)
+	{
+	}
+	const byte *operator()(int y)
+	{
+		const byte *pLine = m_rImage[y] + m_oXStart;
+		if (m_oStep == 1) {
+			return pLine;
+		}
+		byte *pBuffer = m_oBuffer.data();
+		const int oWidth = static_cast<int>(m_oBuffer.size());
+		for (int i = 0; i < oWidth; ++i) {
+			pBuffer[i] = pLine[i * m_oStep];
+		}
+		return pBuffer;
+	}
+private:
+	const image::BImage &m_rImage;
+	const int m_oXStart;
+	const int m_oStep;
+	std::vector<byte> m_oBuffer;
+};
+
+/// Processes the columns [0, p_oNumBlocks * 16) of the state, 16 columns at once
+void addRowsSse(RowReader &p_rRow, ColumnState &p_rState, int p_oNumBlocks,
+	int p_oYStart, int p_oYEnd, int p_oResY, int p_oMaxLineWidth)
+{
+	const __m128i oMaxLineWidth = _mm_set1_epi16(p_oMaxLineWidth);
+	for (int y = p_oYStart; y < p_oYEnd; y += p_oResY) {
+		const byte *pLine = p_rRow(y);
+		const __m128i oY = _mm_set1_epi16(y);
+		for (int oBlock = 0; oBlock < p_oNumBlocks; ++oBlock) {
+			addRow16(pLine, p_rState, oBlock * 16, oY, oMaxLineWidth);
+		}
+	}
+}
+
+#if defined(__GNUC__)
+#define PARALLELMAXIMUM_AVX2 1
+
+__attribute__((target("avx2")))
+inline __m256i blend256(__m256i p_oMask, __m256i p_oA, __m256i p_oB)
+{
+	return _mm256_blendv_epi8(p_oB, p_oA, p_oMask);
+}
+
+__attribute__((target("avx2")))
+inline void updateIndex256(std::int16_t *p_pFirst, std::int16_t *p_pLast, __m256i p_oGreater, __m256i p_oEqual, __m256i p_oY, __m256i p_oMaxLineWidth)
+{
+	const __m256i oFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_pFirst));
+	const __m256i oLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_pLast));
+	const __m256i oTooFar = _mm256_cmpgt_epi16(_mm256_sub_epi16(p_oY, oFirst), p_oMaxLineWidth);
+	const __m256i oUpdateLast = _mm256_or_si256(p_oGreater, _mm256_andnot_si256(oTooFar, p_oEqual));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(p_pFirst), blend256(p_oGreater, p_oY, oFirst));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(p_pLast), blend256(oUpdateLast, p_oY, oLast));
+}
+
+/// Processes the columns [0, p_oNumBlocks * 32) of the state, 32 columns at once
+__attribute__((target("avx2")))
+void addRowsAvx2(RowReader &p_rRow, ColumnState &p_rState, int p_oNumBlocks,
+	int p_oYStart, int p_oYEnd, int p_oResY, int p_oMaxLineWidth)
+{
+	const __m256i oMaxLineWidth = _mm256_set1_epi16(p_oMaxLineWidth);
+	const __m256i oAllSet = _mm256_set1_epi8(-1);
+	for (int y = p_oYStart; y < p_oYEnd; y += p_oResY) {
+		const byte *pLine = p_rRow(y);
+		const __m256i oY = _mm256_set1_epi16(y);
+		for (int oBlock = 0; oBlock < p_oNumBlocks; ++oBlock) {
+			const int x = oBlock * 32;
+			// the 64 bit quarters are reordered to 0, 2, 1, 3, so that unpacking within the 128 bit lanes
+			// yields the columns 0-15 (lo) and 16-31 (hi) in order
+			const __m256i oValue = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLine + x)), 0xD8);
+			const __m256i oMax = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_rState.m_oMax.data() + x)), 0xD8);
+			const __m256i oNewMax = _mm256_max_epu8(oValue, oMax);
+			const __m256i oGreater = _mm256_xor_si256(_mm256_cmpeq_epi8(oNewMax, oMax), oAllSet);
+			const __m256i oEqual = _mm256_cmpeq_epi8(oValue, oMax);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(p_rState.m_oMax.data() + x), _mm256_permute4x64_epi64(oNewMax, 0xD8));
+
+			updateIndex256(p_rState.m_oIndexFirst.data() + x, p_rState.m_oIndexLast.data() + x,
+				_mm256_unpacklo_epi8(oGreater, oGreater), _mm256_unpacklo_epi8(oEqual, oEqual), oY, oMaxLineWidth);
+			updateIndex256(p_rState.m_oIndexFirst.data() + x + 16, p_rState.m_oIndexLast.data() + x + 16,
+				_mm256_unpackhi_epi8(oGreater, oGreater), _mm256_unpackhi_epi8(oEqual, oEqual), oY, oMaxLineWidth);
+		}
+	}
+}
+
+bool hasAvx2()
+{
+	static const bool s_oHasAvx2 = __builtin_cpu_supports("avx2");
+	return s_oHasAvx2;
+}
+#endif // __GNUC__
+
+#endif // HAVE_SSE4
+
+} // namespace
+
+
+
+void columnMaximumScalar(const image::BImage &p_rImage,
+	int p_oXStart, int p_oXEnd, int p_oResX,
+	int p_oYStart, int p_oYEnd, int p_oResY,
+	std::uint32_t p_oMaxLineWidth, std::uint32_t p_oThreshold,
+	double *p_pPosition, int *p_pRank)
+{
+	for (int x = p_oXStart; x < p_oXEnd; x += p_oResX) {
+		byte oMaxFirst = std::numeric_limits<byte>::min();
+		int oIndexFirst	= 0;
+		int oIndexLast	= 0;
+		for (int y = p_oYStart; y < p_oYEnd; y += p_oResY) {
+			const byte* pLine = p_rImage[y]; // get line pointer
+			if (pLine[x] > oMaxFirst) {
+				oMaxFirst	= pLine[x];
+				oIndexFirst	= y;
+				oIndexLast	= y;
+			}
+			// second maximum found if value remains equal first maximum
+			else if( pLine[x] == oMaxFirst ) {
+				// Falls dieser Pixel ausserdem in der nachbarschaft liegt
+				if (std::abs(oIndexFirst - y) <= (int)(p_oMaxLineWidth))
+				{
+					oIndexLast = y;
+				}
+			} // if
+		} // for
+		setResult(oMaxFirst, oIndexFirst, oIndexLast, p_oThreshold, p_pPosition[x], p_pRank[x]);
+	} // for
+}
+
+
+
+void columnMaximum(const image::BImage &p_rImage,
+	int p_oXStart, int p_oXEnd, int p_oResX,
+	int p_oYStart, int p_oYEnd, int p_oResY,
+	std::uint32_t p_oMaxLineWidth, std::uint32_t p_oThreshold,
+	double *p_pPosition, int *p_pRank)
+{
+	int oXScalar = p_oXStart;
+#if HAVE_SSE4
+	if (p_oResX > 0 && p_oYEnd <= s_maxSimdRow) {
+		// a negative line width (cast from large values) never extends the run, like a width of 0
+		const int oMaxLineWidth = std::min(std::max(static_cast<int>(p_oMaxLineWidth), 0), s_maxSimdRow);
+		int oBlockWidth = 16;
+#if PARALLELMAXIMUM_AVX2
+		if (hasAvx2()) {
+			oBlockWidth = 32;
+		}
+#endif
+		// small steps: all columns are processed and the sampled ones picked afterwards,
+		// large steps: the sampled columns of each row are gathered, which avoids the strided column by column access
+		const int oStep = p_oResX <= s_maxContiguousResX ? 1 : p_oResX;
+		const int oNumColumns = (p_oXEnd - p_oXStart + oStep - 1) / oStep;
+		const int oNumBlocks = oNumColumns / oBlockWidth;
+		if (oNumBlocks > 0) {
+			const int oWidth = oNumBlocks * oBlockWidth;
+			ColumnState oState(oWidth);
+			RowReader oRow(p_rImage, p_oXStart, oStep, oWidth);
+#if PARALLELMAXIMUM_AVX2
+			if (oBlockWidth == 32) {
+				addRowsAvx2(oRow, oState, oNumBlocks, p_oYStart, p_oYEnd, p_oResY, oMaxLineWidth);
+			}
+			else
+#endif
+			{
+				addRowsSse(oRow, oState, oNumBlocks, p_oYStart, p_oYEnd, p_oResY, oMaxLineWidth);
+			}
+
+			for (int i = 0; i < oWidth; i += p_oResX / oStep) {
+				const int x = p_oXStart + i * oStep;
+				setResult(oState.m_oMax[i], oState.m_oIndexFirst[i], oState.m_oIndexLast[i], p_oThreshold, p_pPosition[x], p_pRank[x]);
+			}
+			// the remaining columns are searched one by one, starting with the next sampled column
+			const int oProcessed = oWidth * oStep;
+			oXScalar = p_oXStart + (oProcessed + p_oResX - 1) / p_oResX * p_oResX;
+		}
+	}
+#endif
+	columnMaximumScalar(p_rImage, oXScalar, p_oXEnd, p_oResX, p_oYStart, p_oYEnd, p_oResY, p_oMaxLineWidth, p_oThreshold, p_pPosition, p_pRank);
+}
+
+} // namespace filter
+} // namespace precitec
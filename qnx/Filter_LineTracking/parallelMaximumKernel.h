@@ -0,0 +1,47 @@
+/*!
+ *  @copyright		Precitec Vision GmbH & Co. KG
+ *  @file
+ *  @brief			Maximum search shared by the ParallelMaximum filters.
+ */
+
+#ifndef PARALLELMAXIMUMKERNEL_H_
+#define PARALLELMAXIMUMKERNEL_H_
+
+#include <cstdint>						///< uint32
+
+#include "image/image.h"				///< BImage
+
+namespace precitec {
+namespace filter {
+
+/**
+ * Searches the brightest run in the columns xStart, xStart + resX, ... < xEnd of the image,
+ * considering the rows yStart, yStart + resY, ... < yEnd.
+ *
+ * For each column the first row with the maximum gray value and the last row with the same
+ * value, at most maxLineWidth below the first one, are determined. If the maximum is above
+ * threshold, position[x] is set to the mean of both rows and rank[x] to eRankMax, otherwise
+ * position[x] is set to 0 and rank[x] to eRankMin. Other entries are not changed.
+ *
+ * The image is processed row by row, up to 32 columns at once with SIMD instructions if the
+ * CPU supports them. The result is identical to the column by column search.
+ */
+void columnMaximum(const image::BImage &p_rImage,
+	int p_oXStart, int p_oXEnd, int p_oResX,
+	int p_oYStart, int p_oYEnd, int p_oResY,
+	std::uint32_t p_oMaxLineWidth, std::uint32_t p_oThreshold,
+	double *p_pPosition, int *p_pRank);
+
+/**
+ * Column by column search with the same result as columnMaximum, without SIMD.
+ */
+void columnMaximumScalar(const image::BImage &p_rImage,
+	int p_oXStart, int p_oXEnd, int p_oResX,
+	int p_oYStart, int p_oYEnd, int p_oResY,
+	std::uint32_t p_oMaxLineWidth, std::uint32_t p_oThreshold,
+	double *p_pPosition, int *p_pRank);
+
+} // namespace filter
+} // namespace precitec
+
+#endif /*PARALLELMAXIMUMKERNEL_H_*/
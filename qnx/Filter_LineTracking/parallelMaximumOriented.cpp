@@ -6,6 +6,7 @@
  */
 
 #include "parallelMaximumOriented.h"
+#include "parallelMaximumKernel.h"
 
 #include <system/platform.h>			///< global and platform specific defines
 #include <system/tools.h>				///< debug assert integrity assumptions
@@ -378,23 +379,15 @@ void ParallelMaximumOriented::parMax(
     assert(!p_oMainDirectionHorizontal || int(rLaserVectorOut.size()) == p_rImageIn.width());
     assert(p_oMainDirectionHorizontal || int(rLaserVectorOut.size()) == p_rImageIn.height());
 
-    MaximumInSearchLine oSearchLine{static_cast<int>(p_oMaxLineWidth), p_oThreshold};
-
     if ( p_oMainDirectionHorizontal )
     {
-        for ( int x = p_oOffset.x; x < oXMax; x += p_oResX )
-        {
-            oSearchLine.resetSearchLine();
-            for ( int y = p_oOffset.y; y < oYMax; y += p_oResY )
-            {
-                const byte* pLine = p_rImageIn[y]; // get line pointer
-                oSearchLine.addPointOfSearchLine(pLine[x], y);
-            }
-            std::tie(rLaserVectorOut[x], rRankVectorOut[x]) = oSearchLine.processSearchLine();
-        }
+        // the search lines are columns, they are processed row by row
+        columnMaximum(p_rImageIn, p_oOffset.x, oXMax, p_oResX, p_oOffset.y, oYMax, p_oResY, p_oMaxLineWidth, p_oThreshold,
+            rLaserVectorOut.data(), rRankVectorOut.data());
     }
     else
     {
+        MaximumInSearchLine oSearchLine{static_cast<int>(p_oMaxLineWidth), p_oThreshold};
         for ( int y = p_oOffset.y; y < oYMax; y += p_oResY )
         {
             oSearchLine.resetSearchLine();
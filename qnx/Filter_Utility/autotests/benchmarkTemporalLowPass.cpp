@@ -0,0 +1,123 @@
+#include <QTest>
+
+#include "../slidingLowPass.h"
+#include "filter/algoArray.h"
+
+#include <random>
+
+using precitec::filter::FilterAlgorithmType;
+using precitec::filter::LowPass;
+using precitec::filter::SlidingLowPass;
+
+Q_DECLARE_METATYPE(precitec::filter::FilterAlgorithmType)
+
+class BenchmarkTemporalLowPass : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkLowPass_data();
+    void benchmarkLowPass();
+    void benchmarkSlidingLowPass_data();
+    void benchmarkSlidingLowPass();
+
+private:
+    std::vector<std::tuple<double, int>> m_values;
+};
+
+namespace
+{
+
+std::function<std::tuple<double, int>(const precitec::geo2d::TArray<double>&)> algorithm(FilterAlgorithmType type)
+{
+    switch (type)
+    {
+    case FilterAlgorithmType::eMean:
+        return &precitec::filter::calcMean<double>;
+    case FilterAlgorithmType::eMedian:
+        return &precitec::filter::calcMedian1d<double>;
+    case FilterAlgorithmType::eMinLowPass:
+        return &precitec::filter::calcDataMinimum<double>;
+    default:
+        return &precitec::filter::calcDataMaximum<double>;
+    }
+}
+
+void addRows()
+{
+    QTest::addColumn<FilterAlgorithmType>("type");
+    QTest::addColumn<unsigned int>("filterLength");
+
+    const std::vector<std::pair<FilterAlgorithmType, const char*>> types{
+        {FilterAlgorithmType::eMean, "mean"},
+        {FilterAlgorithmType::eMedian, "median"},
+        {FilterAlgorithmType::eMinLowPass, "minimum"},
+        {FilterAlgorithmType::eMaxLowPass, "maximum"}};
+    for (const auto& type : types)
+    {
+        for (unsigned int filterLength : {3u, 30u, 300u, 3000u})
+        {
+            QTest::addRow("%s_%u", type.second, filterLength) << type.first << filterLength;
+        }
+    }
+}
+
+}
+
+void BenchmarkTemporalLowPass::initTestCase()
+{
+    // seam positions with noise
+    std::mt19937 generator{5};
+    std::normal_distribution<double> noise{0.0, 0.1};
+    for (int i = 0; i < 10000; i++)
+    {
+        m_values.emplace_back(std::sin(i * 0.01) + noise(generator), precitec::filter::eRankMax);
+    }
+}
+
+void BenchmarkTemporalLowPass::benchmarkLowPass_data()
+{
+    addRows();
+}
+
+void BenchmarkTemporalLowPass::benchmarkLowPass()
+{
+    QFETCH(FilterAlgorithmType, type);
+    QFETCH(unsigned int, filterLength);
+
+    LowPass<double> lowPass(filterLength, algorithm(type), true);
+    double sum = 0.0;
+    QBENCHMARK
+    {
+        for (const auto& value : m_values)
+        {
+            sum += std::get<0>(lowPass.process(value));
+        }
+    }
+    QVERIFY(std::isfinite(sum));
+}
+
+void BenchmarkTemporalLowPass::benchmarkSlidingLowPass_data()
+{
+    addRows();
+}
+
+void BenchmarkTemporalLowPass::benchmarkSlidingLowPass()
+{
+    QFETCH(FilterAlgorithmType, type);
+    QFETCH(unsigned int, filterLength);
+
+    SlidingLowPass<double> slidingLowPass(type, filterLength, true);
+    double sum = 0.0;
+    QBENCHMARK
+    {
+        for (const auto& value : m_values)
+        {
+            sum += std::get<0>(slidingLowPass.process(value));
+        }
+    }
+    QVERIFY(std::isfinite(sum));
+}
+
+QTEST_GUILESS_MAIN(BenchmarkTemporalLowPass)
+#include "benchmarkTemporalLowPass.moc"
@@ -0,0 +1,160 @@
+#include <QTest>
+
+#include "../slidingLowPass.h"
+#include "filter/algoArray.h"
+
+#include <deque>
+#include <limits>
+#include <random>
+
+using precitec::filter::FilterAlgorithmType;
+using precitec::filter::LowPass;
+using precitec::filter::SlidingLowPass;
+
+Q_DECLARE_METATYPE(precitec::filter::FilterAlgorithmType)
+
+class TestSlidingLowPass : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSameAsLowPass_data();
+    void testSameAsLowPass();
+    void testMeanTolerance_data();
+    void testMeanTolerance();
+};
+
+void TestSlidingLowPass::testSameAsLowPass_data()
+{
+    QTest::addColumn<FilterAlgorithmType>("type");
+    QTest::addColumn<unsigned int>("filterLength");
+    QTest::addColumn<bool>("passThroughBadRank");
+
+    const std::vector<std::pair<FilterAlgorithmType, const char*>> types{
+        {FilterAlgorithmType::eMean, "mean"},
+        {FilterAlgorithmType::eMedian, "median"},
+        {FilterAlgorithmType::eMinLowPass, "minimum"},
+        {FilterAlgorithmType::eMaxLowPass, "maximum"}};
+    for (const auto& type : types)
+    {
+        for (unsigned int filterLength : {1u, 2u, 3u, 7u, 16u, 17u, 50u})
+        {
+            for (bool passThroughBadRank : {false, true})
+            {
+                QTest::addRow("%s_%u_%s", type.second, filterLength, passThroughBadRank ? "passThrough" : "noPassThrough")
+                    << type.first << filterLength << passThroughBadRank;
+            }
+        }
+    }
+}
+
+void TestSlidingLowPass::testSameAsLowPass()
+{
+    QFETCH(FilterAlgorithmType, type);
+    QFETCH(unsigned int, filterLength);
+    QFETCH(bool, passThroughBadRank);
+
+    std::function<std::tuple<double, int>(const precitec::geo2d::TArray<double>&)> algorithm;
+    switch (type)
+    {
+    case FilterAlgorithmType::eMean:
+        algorithm = &precitec::filter::calcMean<double>;
+        break;
+    case FilterAlgorithmType::eMedian:
+        algorithm = &precitec::filter::calcMedian1d<double>;
+        break;
+    case FilterAlgorithmType::eMinLowPass:
+        algorithm = &precitec::filter::calcDataMinimum<double>;
+        break;
+    default:
+        algorithm = &precitec::filter::calcDataMaximum<double>;
+        break;
+    }
+    LowPass<double> lowPass(filterLength, algorithm, passThroughBadRank);
+    SlidingLowPass<double> slidingLowPass(type, filterLength, passThroughBadRank);
+
+    // few distinct values, so that the extrema are often not unique and their rank depends on the position in the ring buffer
+    std::mt19937 generator{17};
+    for (int i = 0; i < 2000; i++)
+    {
+        if (i % 301 == 300)
+        {
+            // seam start
+            lowPass.resetBuffer();
+            slidingLowPass.resetBuffer();
+        }
+        const double value = static_cast<int>(generator() % 8) * 0.5;
+        const int rank = generator() % 4 == 0 ? precitec::filter::eRankMin : 1 + generator() % 255;
+
+        const auto expected = lowPass.process(std::make_tuple(value, rank));
+        const auto result = slidingLowPass.process(std::make_tuple(value, rank));
+        // the values are exact in double, the running sum of the mean doesn't round
+        QCOMPARE(std::get<0>(result), std::get<0>(expected));
+        QCOMPARE(std::get<1>(result), std::get<1>(expected));
+    }
+}
+
+void TestSlidingLowPass::testMeanTolerance_data()
+{
+    QTest::addColumn<unsigned int>("filterLength");
+    QTest::addColumn<bool>("passThroughBadRank");
+    QTest::addColumn<double>("offset");
+    QTest::addColumn<double>("spike");
+
+    for (unsigned int filterLength : {2u, 3u, 7u, 16u, 50u, 1000u})
+    {
+        for (bool passThroughBadRank : {false, true})
+        {
+            const char* passThrough = passThroughBadRank ? "passThrough" : "noPassThrough";
+            QTest::addRow("tenths_%u_%s", filterLength, passThrough) << filterLength << passThroughBadRank << 0.0 << 0.0;
+            QTest::addRow("offset_%u_%s", filterLength, passThrough) << filterLength << passThroughBadRank << 1e6 << 0.0;
+            QTest::addRow("spikes_%u_%s", filterLength, passThrough) << filterLength << passThroughBadRank << 0.0 << 1e8;
+        }
+    }
+}
+
+void TestSlidingLowPass::testMeanTolerance()
+{
+    QFETCH(unsigned int, filterLength);
+    QFETCH(bool, passThroughBadRank);
+    QFETCH(double, offset);
+    QFETCH(double, spike);
+
+    LowPass<double> lowPass(filterLength, &precitec::filter::calcMean<double>, passThroughBadRank);
+    SlidingLowPass<double> slidingLowPass(FilterAlgorithmType::eMean, filterLength, passThroughBadRank);
+
+    // values which are not representable in double, so that the running sum rounds differently than calcMean
+    std::mt19937 generator{23};
+    std::normal_distribution<double> noise{0.0, 1.0};
+    std::deque<double> lastAbsValues;
+    for (int i = 0; i < 5000; i++)
+    {
+        if (i % 1501 == 1500)
+        {
+            lowPass.resetBuffer();
+            slidingLowPass.resetBuffer();
+            lastAbsValues.clear();
+        }
+        double value = offset + 0.1 * (i % 10) + 0.01 * noise(generator);
+        if (spike != 0.0 && i % 97 == 0)
+        {
+            value += spike * noise(generator);
+        }
+        const int rank = generator() % 4 == 0 ? precitec::filter::eRankMin : 1 + generator() % 255;
+
+        lastAbsValues.push_back(std::abs(value));
+        if (lastAbsValues.size() > 2 * filterLength)
+        {
+            lastAbsValues.pop_front();
+        }
+        const double tolerance = 4.0 * filterLength * std::numeric_limits<double>::epsilon() * *std::max_element(lastAbsValues.begin(), lastAbsValues.end());
+
+        const auto expected = lowPass.process(std::make_tuple(value, rank));
+        const auto result = slidingLowPass.process(std::make_tuple(value, rank));
+        QVERIFY2(std::abs(std::get<0>(result) - std::get<0>(expected)) <= tolerance,
+            qPrintable(QStringLiteral("value %1: %2 instead of %3").arg(i).arg(std::get<0>(result), 0, 'g', 17).arg(std::get<0>(expected), 0, 'g', 17)));
+        QCOMPARE(std::get<1>(result), std::get<1>(expected));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSlidingLowPass)
+#include "testSlidingLowPass.moc"
@@ -26,6 +26,14 @@ namespace precitec
 namespace filter
 {
 
+namespace
+{
+
+// maximum deviation of the interpolated pixel to world conversion in mm, far below the size of a pixel
+const double PIXEL_TO_WORLD_TOLERANCE = 1e-4;
+
+}
+
 ContourCoordinateTransform::ContourCoordinateTransform()
     : TransformFilter("ContourCoordinateTransform", Poco::UUID(FILTER_ID))
     , m_contourIn(nullptr)
@@ -132,42 +140,50 @@ void ContourCoordinateTransform::proceedGroup(const void* sender, fliplib::PipeG
         wmLog(eInfo, "ay: %f, by: %f, cy: %f, dy: %f, ey: %f, fy: %f", k[6], k[7], k[8], k[9], k[10], k[11]);
     }
 
-    if (m_conversionMode == Mode::PixelToWorld)
+    // all points of all contours are converted in one batch
+    std::vector<std::pair<double, double>> pointsIn;
+    for (const auto &contour : m_contourOutArray.ref())
     {
-        for (auto &contour : m_contourOutArray.ref())
+        for (const auto &point : contour.getData())
         {
-            int i = 1;
-            for (auto &point : contour.getData())
+            if (m_conversionMode == Mode::PixelToWorld)
             {
-                const auto pointPixel = point;
-                const auto pointWorld = pixelToWorld(pointPixel.x - tcp.x, pointPixel.y - tcp.y, k);
-                point = {pointWorld.first + sx, pointWorld.second + sy};
-
-                if (m_oVerbosity > eLow)
-                {
-                    wmLog(eInfo, "[%d](%f px, %f px) --> (%f mm, %f mm)", i, pointPixel.x, pointPixel.y, point.x, point.y);
-                }
-                ++i;
+                pointsIn.emplace_back(point.x - tcp.x, point.y - tcp.y);
+            }
+            else
+            {
+                pointsIn.emplace_back(point.x - sx, point.y - sy);
             }
         }
     }
-    else
+
+    const auto pointsOut = m_conversionMode == Mode::PixelToWorld ? pixelToWorld(pointsIn, k, PIXEL_TO_WORLD_TOLERANCE) : worldToPixel(pointsIn, k);
+
+    std::size_t index = 0;
+    for (auto &contour : m_contourOutArray.ref())
     {
-        for (auto &contour : m_contourOutArray.ref())
+        int i = 1;
+        for (auto &point : contour.getData())
         {
-            int i = 1;
-            for (auto &point : contour.getData())
+            const auto pointIn = point;
+            const auto &pointOut = pointsOut[index++];
+            if (m_conversionMode == Mode::PixelToWorld)
             {
-                const auto pointWorld = point;
-                const auto pointPixel = worldToPixel(pointWorld.x - sx, pointWorld.y -sy, k);
-                point = {pointPixel.first + tcp.x, pointPixel.second + tcp.y};
-
+                point = {pointOut.first + sx, pointOut.second + sy};
+                if (m_oVerbosity > eLow)
+                {
+                    wmLog(eInfo, "[%d](%f px, %f px) --> (%f mm, %f mm)", i, pointIn.x, pointIn.y, point.x, point.y);
+                }
+            }
+            else
+            {
+                point = {pointOut.first + tcp.x, pointOut.second + tcp.y};
                 if (m_oVerbosity > eLow)
                 {
-                    wmLog(eInfo, "[%d](%f mm, %f mm) --> (%f px, %f px)", i, pointWorld.x, pointWorld.y, point.x, point.y);
+                    wmLog(eInfo, "[%d](%f mm, %f mm) --> (%f px, %f px)", i, pointIn.x, pointIn.y, point.x, point.y);
                 }
-                ++i;
             }
+            ++i;
         }
     }
 
@@ -7,6 +7,8 @@
 #include "overlay/overlayPrimitive.h"
 #include "util/calibDataSingleton.h"
 
+#include <memory>
+
 namespace precitec
 {
 namespace filter
@@ -197,6 +199,9 @@ namespace filter
                 return {math::LineEquation(), geo2d::DPoint(0, 0)};
             }
 
+            //sample the line pixel by pixel, along x and along y
+            std::vector<int> oSampleX;
+            std::vector<int> oSampleY;
             double n = std::abs(rSensorPointB[0] - rSensorPointA[0]);
             for ( int i = 0; i < n; ++i )
             {
@@ -206,20 +211,10 @@ namespace filter
                 {
                     continue;
                 }
-                float x,y;
-                bool valid = rCalibCoords.convertScreenToLaserPlane(x, y, xSensor, std::round(ySensor), m_oTypeOfLaserLine);
-                if ( valid )
-                {
-    #ifndef NDEBUG
-                    oSensorCoordinateX.push_back(std::round(xSensor));
-                    oSensorCoordinateY.push_back(std::round(ySensor));
-    #endif
-                    oX.push_back(x);
-                    oY.push_back(y);
-                }
+                oSampleX.push_back(static_cast<int>(xSensor));
+                oSampleY.push_back(static_cast<int>(std::round(ySensor)));
             }
 
-
             n = std::abs(rSensorPointB[1] - rSensorPointA[1]);
             for ( int i = 0; i < n; ++i )
             {
@@ -229,16 +224,29 @@ namespace filter
                 {
                     continue;
                 }
-                float x, y;
-                bool valid = rCalibCoords.convertScreenToLaserPlane(x, y, std::round(xSensor), ySensor, m_oTypeOfLaserLine);
-                if ( valid )
+                oSampleX.push_back(static_cast<int>(std::round(xSensor)));
+                oSampleY.push_back(static_cast<int>(ySensor));
+            }
+
+            //convert all samples with one call to the calibration
+            const std::size_t oNumSamples = oSampleX.size();
+            std::vector<float> oLaserPlaneX(oNumSamples);
+            std::vector<float> oLaserPlaneY(oNumSamples);
+            std::unique_ptr<bool[]> oValid(new bool[oNumSamples]);
+            const std::size_t oNumValid = rCalibCoords.convertScreenToLaserPlane(oLaserPlaneX.data(), oLaserPlaneY.data(), oValid.get(),
+                oSampleX.data(), oSampleY.data(), oNumSamples, m_oTypeOfLaserLine);
+            oX.reserve(oNumValid);
+            oY.reserve(oNumValid);
+            for ( std::size_t i = 0; i < oNumSamples; ++i )
+            {
+                if ( oValid[i] )
                 {
     #ifndef NDEBUG
-                    oSensorCoordinateX.push_back(std::round(xSensor));
-                    oSensorCoordinateY.push_back(std::round(ySensor));
+                    oSensorCoordinateX.push_back(oSampleX[i]);
+                    oSensorCoordinateY.push_back(oSampleY[i]);
     #endif
-                    oX.push_back(x);
-                    oY.push_back(y);
+                    oX.push_back(oLaserPlaneX[i]);
+                    oY.push_back(oLaserPlaneY[i]);
                 }
             }
         } //end Scheimpflug
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "filter/movingWindow.h"
+#include "filter/parameterEnums.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace precitec
+{
+namespace filter
+{
+
+/**
+ * @brief Temporal low pass over the last values with constant cost per value.
+ * @details Streaming counterpart of LowPass with calcMean, calcMedian1d, calcDataMinimum and calcDataMaximum.
+ * Instead of evaluating the whole ring buffer for every value, the window is updated incrementally: the mean with running sums,
+ * the median with a SlidingMedian and the extrema with monotonic queues.
+ * Median, minimum, maximum and all ranks are the same as in LowPass. The mean only equals calcMean if the sums are exact, e.g. for integral values.
+ * Otherwise the running sum rounds differently: it is recomputed once per window length, so the mean differs from calcMean
+ * by at most about filter length * epsilon * the largest absolute value of the last two windows.
+ * Bad ranked values are not part of the window, unless they are passed through: then they count with eRankMax like in LowPass.
+ */
+template <typename T>
+class SlidingLowPass
+{
+public:
+    /**
+     * @param p_oType Filter algorithm, mean, median, minimum or maximum
+     * @param p_oSize Filter length, must be greater than zero
+     * @param p_oPassThroughBadRank If bad ranked values are part of the window
+     */
+    SlidingLowPass(FilterAlgorithmType p_oType, unsigned int p_oSize, bool p_oPassThroughBadRank = false)
+        : m_oType(p_oType)
+        , m_oSize(p_oSize)
+        , m_oPassThroughBadRank(p_oPassThroughBadRank)
+        , m_oValues(p_oSize)
+        , m_oRanks(p_oSize, eRankMin)
+    {
+        poco_assert_dbg(m_oSize != 0);
+        poco_assert_dbg(m_oType == FilterAlgorithmType::eMean || m_oType == FilterAlgorithmType::eMedian
+            || m_oType == FilterAlgorithmType::eMinLowPass || m_oType == FilterAlgorithmType::eMaxLowPass);
+        if (m_oType == FilterAlgorithmType::eMedian)
+        {
+            m_oMedian.resize(m_oSize);
+        }
+    }
+
+    /**
+     * @brief Adds a value to the window and returns the filtered value of the window.
+     */
+    std::tuple<T, int> process(std::tuple<T, int> p_oNewValue)
+    {
+        if (m_oSize == 1)
+        {
+            return p_oNewValue; // degenerated filter, like LowPass
+        }
+        const unsigned int oSlot = m_oSequence % m_oSize;
+        erase(oSlot);
+
+        int oRank = std::get<eRank>(p_oNewValue);
+        if (m_oPassThroughBadRank && oRank == eRankMin)
+        {
+            oRank = eRankMax;
+        }
+        m_oValues[oSlot] = std::get<eData>(p_oNewValue);
+        m_oRanks[oSlot] = oRank;
+        insert(oSlot);
+
+        const auto oResult = result();
+        ++m_oSequence;
+        return oResult;
+    }
+
+    /**
+     * @brief Removes all values. The position in the ring buffer is kept, like in LowPass.
+     */
+    void resetBuffer()
+    {
+        std::fill(m_oValues.begin(), m_oValues.end(), T());
+        std::fill(m_oRanks.begin(), m_oRanks.end(), eRankMin);
+        m_oNumValues = 0;
+        m_oRankSum = 0;
+        m_oSum = T();
+        m_oMedian.clear();
+        m_oExtremumQueue.clear();
+    }
+
+private:
+    bool isMinimum() const
+    {
+        return m_oType == FilterAlgorithmType::eMinLowPass;
+    }
+
+    // true if the first value replaces the second one as extremum
+    bool isBetter(const T& p_rFirst, const T& p_rSecond) const
+    {
+        return isMinimum() ? p_rFirst < p_rSecond : p_rSecond < p_rFirst;
+    }
+
+    void erase(unsigned int p_oSlot)
+    {
+        if (m_oRanks[p_oSlot] == eRankMin)
+        {
+            return;
+        }
+        --m_oNumValues;
+        m_oRankSum -= m_oRanks[p_oSlot];
+        switch (m_oType)
+        {
+        case FilterAlgorithmType::eMean:
+            m_oSum = m_oSum - m_oValues[p_oSlot];
+            break;
+        case FilterAlgorithmType::eMedian:
+            m_oMedian.erase(p_oSlot);
+            break;
+        default:
+            // only the oldest value in the queue can leave the window
+            if (!m_oExtremumQueue.empty() && m_oExtremumQueue.front() + m_oSize == m_oSequence)
+            {
+                m_oExtremumQueue.pop_front();
+            }
+            break;
+        }
+    }
+
+    void insert(unsigned int p_oSlot)
+    {
+        if (m_oRanks[p_oSlot] != eRankMin)
+        {
+            ++m_oNumValues;
+            m_oRankSum += m_oRanks[p_oSlot];
+            switch (m_oType)
+            {
+            case FilterAlgorithmType::eMean:
+                m_oSum = m_oSum + m_oValues[p_oSlot];
+                break;
+            case FilterAlgorithmType::eMedian:
+                m_oMedian.insert(p_oSlot, m_oValues[p_oSlot]);
+                break;
+            default:
+                // values which can't become the extremum anymore are dropped, equal values are kept for the rank
+                while (!m_oExtremumQueue.empty() && isBetter(m_oValues[p_oSlot], value(m_oExtremumQueue.back())))
+                {
+                    m_oExtremumQueue.pop_back();
+                }
+                m_oExtremumQueue.push_back(m_oSequence);
+                break;
+            }
+        }
+        if (m_oType == FilterAlgorithmType::eMean && p_oSlot == m_oSize - 1)
+        {
+            // same summation order as calcMean
+            m_oSum = T();
+            for (unsigned int oSlot = 0; oSlot < m_oSize; ++oSlot)
+            {
+                if (m_oRanks[oSlot] != eRankMin)
+                {
+                    m_oSum = m_oSum + m_oValues[oSlot];
+                }
+            }
+        }
+    }
+
+    const T& value(std::uint64_t p_oSequence) const
+    {
+        return m_oValues[p_oSequence % m_oSize];
+    }
+
+    std::tuple<T, int> result() const
+    {
+        switch (m_oType)
+        {
+        case FilterAlgorithmType::eMean:
+            if (m_oNumValues == 0)
+            {
+                return std::make_tuple(T(), int(eRankMin));
+            }
+            return std::make_tuple(m_oSum / m_oNumValues, m_oRankSum / m_oNumValues);
+        case FilterAlgorithmType::eMedian:
+            if (m_oNumValues == 0)
+            {
+                return std::make_tuple(T(), int(eRankMin));
+            }
+            return std::make_tuple(m_oMedian.median(), m_oRankSum / m_oNumValues);
+        default:
+            return extremum();
+        }
+    }
+
+    // calcValueExtremum returns the rank of the first extremum in the ring buffer, not the oldest one
+    std::tuple<T, int> extremum() const
+    {
+        if (m_oExtremumQueue.empty())
+        {
+            return std::make_tuple(isMinimum() ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest(), int(eRankMin));
+        }
+        const T& rExtremum = value(m_oExtremumQueue.front());
+        auto oFirst = m_oExtremumQueue.begin();
+        if (m_oExtremumQueue.size() > 1 && !isBetter(rExtremum, value(m_oExtremumQueue[1])))
+        {
+            // the queue starts with equal values in temporal order. The ring buffer started over at the last multiple of the size,
+            // values from there on are in front of the older ones.
+            const auto oEqualEnd = std::partition_point(m_oExtremumQueue.begin(), m_oExtremumQueue.end(),
+                [this, &rExtremum] (std::uint64_t p_oSequence) { return !isBetter(rExtremum, value(p_oSequence)); });
+            const std::uint64_t oRingStart = m_oSequence - m_oSequence % m_oSize;
+            const auto oAfterRingStart = std::lower_bound(m_oExtremumQueue.begin(), oEqualEnd, oRingStart);
+            if (oAfterRingStart != oEqualEnd)
+            {
+                oFirst = oAfterRingStart;
+            }
+        }
+        return std::make_tuple(rExtremum, m_oRanks[*oFirst % m_oSize]);
+    }
+
+    const FilterAlgorithmType m_oType;
+    const unsigned int m_oSize;
+    const bool m_oPassThroughBadRank;
+
+    std::uint64_t m_oSequence = 0;          ///< number of processed values, the slot in the ring buffer is sequence % size
+    std::vector<T> m_oValues;               ///< ring buffer of the values
+    std::vector<int> m_oRanks;              ///< ring buffer of the ranks, values with eRankMin are not in the window
+    int m_oNumValues = 0;                   ///< number of values in the window
+    int m_oRankSum = 0;                     ///< sum of the ranks in the window
+    T m_oSum = T();                         ///< sum of the values in the window, mean only
+    SlidingMedian<T> m_oMedian;             ///< values in the window, median only
+    std::deque<std::uint64_t> m_oExtremumQueue; ///< sequences of the extremum candidates, the best one first, minimum and maximum only
+};
+
+}
+}
@@ -5,6 +5,7 @@
 #include "geo/geo.h"
 #include "geo/array.h"
 #include "filter/algoArray.h"
+#include "slidingLowPass.h"
 
 #include <optional>
 
@@ -21,7 +22,7 @@ public:
     {
         for (int slot = 0; slot < slotCount; slot++)
         {
-            m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcMean<double>, m_oPassThroughBadRank));
+            m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMean, m_oFilterLenght, m_oPassThroughBadRank));
         }
         clear();
     }
@@ -66,25 +67,25 @@ public:
                 case FilterAlgorithmType::eMean:
                 {
                     // make boxcar filter with mean as actual filter function.
-                    m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcMean<double>, m_oPassThroughBadRank));
+                    m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMean, m_oFilterLenght, m_oPassThroughBadRank));
                 }
                 break;
                 case FilterAlgorithmType::eMedian:
                 {
                     // make boxcar filter with median as actual filter function
-                    m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcMedian1d<double>, m_oPassThroughBadRank));
+                    m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMedian, m_oFilterLenght, m_oPassThroughBadRank));
                 }
                 break;
                 case FilterAlgorithmType::eMinLowPass:
                 {
                     // make boxcar filter with minimum as actual filter function
-                    m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcDataMinimum<double>, m_oPassThroughBadRank));
+                    m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMinLowPass, m_oFilterLenght, m_oPassThroughBadRank));
                 }
                 break;
                 case FilterAlgorithmType::eMaxLowPass:
                 {
                     // make boxcar filter with maximum as actual filter function
-                    m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcDataMaximum<double>, m_oPassThroughBadRank));
+                    m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMaxLowPass, m_oFilterLenght, m_oPassThroughBadRank));
                 }
                 break;
                 default:
@@ -94,7 +95,7 @@ public:
                     wmLog(eError, oMsg.str().c_str());
 
                     // make boxcar filter with mean as actual filter function
-                    m_oUpLowPass[slot].reset(new LowPass<double>(m_oFilterLenght, &calcMean<double>));
+                    m_oUpLowPass[slot].reset(new SlidingLowPass<double>(FilterAlgorithmType::eMean, m_oFilterLenght));
                 }
                 break;
                 }
@@ -185,7 +186,7 @@ public:
 
     } // temporalLowPass
 private:
-    typedef std::unique_ptr<LowPass<double>> upLowPass_t;
+    typedef std::unique_ptr<SlidingLowPass<double>> upLowPass_t;
 
     FilterAlgorithmType m_oLowPassType = FilterAlgorithmType::eMean; ///< type of low pass algorithm
     unsigned int m_oFilterLenght = 3u;                               ///< filter length
@@ -0,0 +1,334 @@
+/*!
+ *  \n Copyright:	Precitec Vision GmbH & Co. KG
+ *  \n Project:		WM Filtertest
+ *  \file			benchmark.cpp
+ *  \brief			Graph throughput benchmark: runs graphs at several pipeline depths and gates against a baseline
+ */
+
+#include "benchmark.h"
+#include "graphManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <fliplib/BaseFilter.h>
+#include "analyzer/graphVisitors.h"
+#include "system/tools.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace precitec {
+namespace filter {
+namespace benchmark {
+
+namespace
+{
+
+/**
+ * Enables or disables the recording of every processing time of all filters.
+ **/
+class RecordProcessingTimesVisitor : public fliplib::AbstractFilterVisitor
+{
+public:
+    explicit RecordProcessingTimesVisitor(bool enable)
+        : m_enable(enable)
+    {
+    }
+
+    void control(fliplib::FilterControlInterface &filter) override
+    {
+        auto &baseFilter = static_cast<fliplib::BaseFilter&>(filter);
+        baseFilter.alwaysEnableTiming(m_enable);
+        baseFilter.recordProcessingTimes(m_enable);
+    }
+
+private:
+    const bool m_enable;
+};
+
+/**
+ * Collects the recorded processing times of all filters, skipping the warm up images.
+ **/
+class CollectProcessingTimesVisitor : public fliplib::AbstractFilterVisitor
+{
+public:
+    explicit CollectProcessingTimesVisitor(std::size_t warmUpImages)
+        : m_warmUpImages(warmUpImages)
+    {
+    }
+
+    void control(fliplib::FilterControlInterface &filter) override
+    {
+        const auto &baseFilter = static_cast<fliplib::BaseFilter&>(filter);
+        const auto &timings = baseFilter.recordedProcessingTimes();
+        if (timings.size() <= m_warmUpImages)
+        {
+            return;
+        }
+        m_statistics[baseFilter.name() + " " + baseFilter.id().toString()] = TimingStatistics::compute({timings.begin() + m_warmUpImages, timings.end()});
+    }
+
+    const std::map<std::string, TimingStatistics> &statistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    const std::size_t m_warmUpImages;
+    std::map<std::string, TimingStatistics> m_statistics;
+};
+
+double toMicroSeconds(std::chrono::nanoseconds time)
+{
+    return std::chrono::duration<double, std::micro>(time).count();
+}
+
+QJsonObject toJson(const TimingStatistics &statistics)
+{
+    return QJsonObject{
+        {QStringLiteral("count"), double(statistics.count)},
+        {QStringLiteral("mean_us"), statistics.mean},
+        {QStringLiteral("p50_us"), statistics.p50},
+        {QStringLiteral("p90_us"), statistics.p90},
+        {QStringLiteral("p99_us"), statistics.p99},
+        {QStringLiteral("max_us"), statistics.max}
+    };
+}
+
+TimingStatistics statisticsFromJson(const QJsonObject &object)
+{
+    TimingStatistics statistics;
+    statistics.count = object.value(QStringLiteral("count")).toDouble();
+    statistics.mean = object.value(QStringLiteral("mean_us")).toDouble();
+    statistics.p50 = object.value(QStringLiteral("p50_us")).toDouble();
+    statistics.p90 = object.value(QStringLiteral("p90_us")).toDouble();
+    statistics.p99 = object.value(QStringLiteral("p99_us")).toDouble();
+    statistics.max = object.value(QStringLiteral("max_us")).toDouble();
+    return statistics;
+}
+
+bool exceeds(double value, double baseline, double tolerance)
+{
+    return value > baseline * (1.0 + tolerance);
+}
+
+std::string formatChange(double value, double baseline)
+{
+    std::ostringstream stream;
+    stream.precision(1);
+    stream << std::fixed << baseline << " -> " << value << " (" << std::showpos << (value / baseline - 1.0) * 100.0 << " %)";
+    return stream.str();
+}
+
+}
+
+TimingStatistics TimingStatistics::compute(std::vector<std::chrono::nanoseconds> timings)
+{
+    TimingStatistics statistics;
+    if (timings.empty())
+    {
+        return statistics;
+    }
+    std::sort(timings.begin(), timings.end());
+
+    const auto percentile = [&timings] (double p)
+    {
+        const auto rank = std::size_t(std::ceil(p * timings.size()));
+        return toMicroSeconds(timings[std::min(timings.size(), std::max<std::size_t>(rank, 1)) - 1]);
+    };
+
+    std::chrono::nanoseconds sum{0};
+    for (const auto &timing : timings)
+    {
+        sum += timing;
+    }
+    statistics.count = timings.size();
+    statistics.mean = toMicroSeconds(sum) / timings.size();
+    statistics.p50 = percentile(0.5);
+    statistics.p90 = percentile(0.9);
+    statistics.p99 = percentile(0.99);
+    statistics.max = toMicroSeconds(timings.back());
+    return statistics;
+}
+
+std::vector<GraphResult> run(const BenchmarkParameters &parameters)
+{
+    std::vector<GraphResult> results;
+    for (const auto &graph : parameters.graphs)
+    {
+        for (const auto pipelineDepth : parameters.pipelineDepths)
+        {
+            std::cout << "Benchmark: " << graph << " with pipeline depth " << pipelineDepth << std::endl;
+            try
+            {
+                GraphManager graphManager(graph, parameters.imagePath, 67000, 335,
+                                          { {interface::Sensor::eScannerXPosition, 1000},
+                                            {interface::Sensor::eScannerYPosition, 2000}},
+                                          false);
+                graphManager.redirectLogMessages(true);
+                if (parameters.imagePath.empty())
+                {
+                    graphManager.generateSyntheticImages(parameters.numImages == 0 ? 100 : parameters.numImages);
+                }
+                if (parameters.numImages > 0)
+                {
+                    graphManager.setNumImages(parameters.numImages + parameters.warmUpImages);
+                }
+                graphManager.setPipelineDepth(pipelineDepth);
+                graphManager.setWarmUpImages(parameters.warmUpImages);
+                graphManager.setParameter();
+
+                RecordProcessingTimesVisitor enableRecording{true};
+                graphManager.apply(enableRecording);
+
+                graphManager.fire();
+
+                const auto &frameTimings = graphManager.frameTimings();
+                if (frameTimings.size() <= parameters.warmUpImages)
+                {
+                    std::cout << "Benchmark: " << graph << " processed only " << frameTimings.size() << " images, skipped." << std::endl;
+                    continue;
+                }
+
+                GraphResult result;
+                result.graph = QFileInfo(QString::fromStdString(graph)).fileName().toStdString();
+                result.pipelineDepth = g_oNbPar;
+                result.numImages = frameTimings.size() - parameters.warmUpImages;
+                result.frame = TimingStatistics::compute({frameTimings.begin() + parameters.warmUpImages, frameTimings.end()});
+                // the total processing time starts after the warm up images
+                result.framesPerSecond = result.numImages / std::chrono::duration<double>(graphManager.totalProcessingTime()).count();
+
+                CollectProcessingTimesVisitor collect{parameters.warmUpImages};
+                graphManager.apply(collect);
+                result.filters = collect.statistics();
+
+                RecordProcessingTimesVisitor disableRecording{false};
+                graphManager.apply(disableRecording);
+
+                std::cout << "Benchmark: " << result.graph << " depth " << result.pipelineDepth << ": " << result.framesPerSecond << " fps, median "
+                          << result.frame.p50 << " us, p99 " << result.frame.p99 << " us" << std::endl;
+                results.push_back(std::move(result));
+            }
+            catch (...)
+            {
+                system::logExcpetion(__FUNCTION__, std::current_exception());
+                std::cout << "Benchmark: " << graph << " failed, skipped." << std::endl;
+            }
+        }
+    }
+    g_oNbPar = 1;
+    return results;
+}
+
+bool writeJson(const std::vector<GraphResult> &results, const std::string &fileName)
+{
+    QJsonArray graphs;
+    for (const auto &result : results)
+    {
+        QJsonObject filters;
+        for (const auto &filter : result.filters)
+        {
+            filters.insert(QString::fromStdString(filter.first), toJson(filter.second));
+        }
+        graphs.append(QJsonObject{
+            {QStringLiteral("graph"), QString::fromStdString(result.graph)},
+            {QStringLiteral("pipelineDepth"), double(result.pipelineDepth)},
+            {QStringLiteral("images"), double(result.numImages)},
+            {QStringLiteral("framesPerSecond"), result.framesPerSecond},
+            {QStringLiteral("frame"), toJson(result.frame)},
+            {QStringLiteral("filters"), filters}
+        });
+    }
+
+    QFile file{QString::fromStdString(fileName)};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        std::cout << "Benchmark: cannot write " << fileName << std::endl;
+        return false;
+    }
+    file.write(QJsonDocument{QJsonObject{{QStringLiteral("graphs"), graphs}}}.toJson());
+    return true;
+}
+
+std::vector<GraphResult> readJson(const std::string &fileName)
+{
+    std::vector<GraphResult> results;
+    QFile file{QString::fromStdString(fileName)};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        std::cout << "Benchmark: cannot read " << fileName << std::endl;
+        return results;
+    }
+    const auto document = QJsonDocument::fromJson(file.readAll());
+    const auto graphs = document.object().value(QStringLiteral("graphs")).toArray();
+    for (const auto &value : graphs)
+    {
+        const auto object = value.toObject();
+        GraphResult result;
+        result.graph = object.value(QStringLiteral("graph")).toString().toStdString();
+        result.pipelineDepth = object.value(QStringLiteral("pipelineDepth")).toInt(1);
+        result.numImages = object.value(QStringLiteral("images")).toInt();
+        result.framesPerSecond = object.value(QStringLiteral("framesPerSecond")).toDouble();
+        result.frame = statisticsFromJson(object.value(QStringLiteral("frame")).toObject());
+        const auto filters = object.value(QStringLiteral("filters")).toObject();
+        for (auto it = filters.begin(); it != filters.end(); ++it)
+        {
+            result.filters.emplace(it.key().toStdString(), statisticsFromJson(it.value().toObject()));
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+std::vector<std::string> compare(const std::vector<GraphResult> &results, const std::vector<GraphResult> &baseline, double tolerance)
+{
+    static const double s_minComparableTime = 20.0; // [us]
+
+    std::vector<std::string> regressions;
+    for (const auto &result : results)
+    {
+        auto reference = std::find_if(baseline.begin(), baseline.end(),
+            [&result] (const GraphResult &candidate)
+            {
+                return candidate.graph == result.graph && candidate.pipelineDepth == result.pipelineDepth;
+            });
+        if (reference == baseline.end())
+        {
+            std::cout << "Benchmark: no baseline for " << result.graph << " depth " << result.pipelineDepth << std::endl;
+            continue;
+        }
+        const auto prefix = result.graph + " depth " + std::to_string(result.pipelineDepth);
+
+        if (exceeds(reference->framesPerSecond, result.framesPerSecond, tolerance))
+        {
+            regressions.push_back(prefix + ": frames per second " + formatChange(result.framesPerSecond, reference->framesPerSecond));
+        }
+        if (exceeds(result.frame.p50, reference->frame.p50, tolerance))
+        {
+            regressions.push_back(prefix + ": median frame time [us] " + formatChange(result.frame.p50, reference->frame.p50));
+        }
+        for (const auto &filter : result.filters)
+        {
+            auto referenceFilter = reference->filters.find(filter.first);
+            if (referenceFilter == reference->filters.end() || referenceFilter->second.p50 < s_minComparableTime)
+            {
+                continue;
+            }
+            if (exceeds(filter.second.p50, referenceFilter->second.p50, tolerance))
+            {
+                regressions.push_back(prefix + ": median time [us] of " + filter.first + " " + formatChange(filter.second.p50, referenceFilter->second.p50));
+            }
+        }
+    }
+    return regressions;
+}
+
+}
+}
+}
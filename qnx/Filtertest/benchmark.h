@@ -0,0 +1,90 @@
+/*!
+ *  \n Copyright:	Precitec Vision GmbH & Co. KG
+ *  \n Project:		WM Filtertest
+ *  \file			benchmark.h
+ *  \brief			Graph throughput benchmark: runs graphs at several pipeline depths and gates against a baseline
+ */
+#ifndef FILTERTEST_BENCHMARK_H_
+#define FILTERTEST_BENCHMARK_H_
+
+// stl includes
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace precitec {
+namespace filter {
+namespace benchmark {
+
+/**
+ * Percentiles of a set of timings, all values in micro seconds.
+ **/
+struct TimingStatistics
+{
+    std::size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    /**
+     * Computes the statistics of @p timings. Percentiles use the nearest rank method.
+     **/
+    static TimingStatistics compute(std::vector<std::chrono::nanoseconds> timings);
+};
+
+/**
+ * Result of one graph processed at one pipeline depth.
+ **/
+struct GraphResult
+{
+    std::string graph;                                  ///< file name of the graph, used as key for the baseline
+    std::size_t pipelineDepth = 1;
+    std::size_t numImages = 0;
+    double framesPerSecond = 0.0;
+    TimingStatistics frame;                             ///< processing time per image of the complete graph
+    std::map<std::string, TimingStatistics> filters;    ///< key: filter name and instance id
+};
+
+struct BenchmarkParameters
+{
+    std::vector<std::string> graphs;
+    std::string imagePath;                              ///< empty: synthetic images are used
+    std::vector<std::size_t> pipelineDepths{1};
+    std::size_t numImages = 0;                          ///< 0: number of images in imagePath, or 100 synthetic images
+    std::size_t warmUpImages = 10;
+};
+
+/**
+ * Runs every graph at every pipeline depth without canvas and with log output suppressed.
+ * Graphs which fail to load or process are reported on std::cout and skipped.
+ **/
+std::vector<GraphResult> run(const BenchmarkParameters &parameters);
+
+/**
+ * Writes @p results as json to @p fileName.
+ **/
+bool writeJson(const std::vector<GraphResult> &results, const std::string &fileName);
+
+/**
+ * Reads results written by writeJson. Returns an empty list if the file cannot be parsed.
+ **/
+std::vector<GraphResult> readJson(const std::string &fileName);
+
+/**
+ * Compares @p results with @p baseline. A result regresses if the throughput decreased or the median frame time
+ * or the median time of a filter increased by more than @p tolerance (relative, e.g. 0.1 for 10 %).
+ * Filters with a baseline median below 20 us are not gated, as their timings are dominated by noise.
+ * Results without a matching baseline entry (same graph and pipeline depth) are not gated.
+ *
+ * @returns a description of every regression, empty if none.
+ **/
+std::vector<std::string> compare(const std::vector<GraphResult> &results, const std::vector<GraphResult> &baseline, double tolerance);
+
+}
+}
+}
+
+#endif /* FILTERTEST_BENCHMARK_H_ */
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <sstream>
+#include <vector>
 #include "Poco/Environment.h"
 
 struct FilterTestParameters
@@ -28,11 +30,17 @@ struct FilterTestParameters
     int mNumberOfImages = 0;
     bool mArmAtSequenceRepetition = false;
     bool m_pauseAfterEachImage{false};
+    std::vector<std::string> mGraphs; // all graphs given on the command line, used by the benchmark
+    std::string mBenchmarkOutput = "";
+    std::string mBenchmarkBaseline = "";
+    double mBenchmarkTolerance = 0.1;
+    std::vector<std::size_t> mPipelineDepths{1};
     
     void printUsage()
     {
         std::cout << "  command-line usage:" << std::endl;
         std::cout << "  filtertest [options] <xml-file>" << std::endl;
+        std::cout << "  filtertest --benchmark <json output> [options] <xml-file or directory> [<xml-file or directory> ...]" << std::endl;
         std::cout << "  xml_file can also be specified by the FILTERTEST_GRAPH env variable" << std::endl;
         std::cout << "    options:" << std::endl;
         std::cout << "    -i <image path> (default: $FILTERTEST_BMPPATH )" << std::endl;
@@ -46,6 +54,10 @@ struct FilterTestParameters
         std::cout << "    --numImages <min number of images to play>" << std::endl;
         std::cout << "    -a arm at sequence repetition (sequence repeats if  numImages > images in folder)" << std::endl;
         std::cout << "    -b pause after each image, press space to continue" << std::endl;
+        std::cout << "    --benchmark <json output> run all graphs without canvas and write timing percentiles (default: synthetic images if no image path)" << std::endl;
+        std::cout << "    --pipelineDepths <comma separated list of pipeline depths for the benchmark> (default: 1)" << std::endl;
+        std::cout << "    --baseline <json file of a previous benchmark, fails on regressions>" << std::endl;
+        std::cout << "    --tolerance <allowed regression against the baseline in percent> (default: 10)" << std::endl;
 
     }
     
@@ -252,6 +264,81 @@ struct FilterTestParameters
                         iCount++;
                         break;
                     }
+                    if (strcmp(argv[iCount], "--benchmark") == 0)
+                    {
+                        if (iCount + 1 < argc)
+                        {
+                            mBenchmarkOutput = argv[iCount+1];
+                            mHasCanvas = false;
+                            std::cout << "Benchmark output " << mBenchmarkOutput << std::endl;
+                        }
+                        else
+                        {
+                            std::cout << "Please specify a filename for the benchmark output!" << std::endl;
+                            valid = false;
+                        }
+                        iCount++;
+                        break;
+                    }
+                    if (strcmp(argv[iCount], "--baseline") == 0)
+                    {
+                        if (iCount + 1 < argc)
+                        {
+                            mBenchmarkBaseline = argv[iCount+1];
+                            std::cout << "Benchmark baseline " << mBenchmarkBaseline << std::endl;
+                        }
+                        else
+                        {
+                            std::cout << "Please specify a filename for the benchmark baseline!" << std::endl;
+                            valid = false;
+                        }
+                        iCount++;
+                        break;
+                    }
+                    if (strcmp(argv[iCount], "--tolerance") == 0)
+                    {
+                        if (iCount + 1 < argc)
+                        {
+                            mBenchmarkTolerance = std::atof(argv[iCount+1]) / 100.0;
+                            std::cout << "Benchmark tolerance " << mBenchmarkTolerance * 100.0 << " %" << std::endl;
+                        }
+                        else
+                        {
+                            std::cout << "Please specify a tolerance in percent!" << std::endl;
+                            valid = false;
+                        }
+                        iCount++;
+                        break;
+                    }
+                    if (strcmp(argv[iCount], "--pipelineDepths") == 0)
+                    {
+                        if (iCount + 1 < argc)
+                        {
+                            mPipelineDepths.clear();
+                            std::istringstream oDepths(argv[iCount+1]);
+                            std::string oDepth;
+                            while (std::getline(oDepths, oDepth, ','))
+                            {
+                                const int oValue = std::atoi(oDepth.c_str());
+                                if (oValue > 0)
+                                {
+                                    mPipelineDepths.push_back(oValue);
+                                }
+                            }
+                            if (mPipelineDepths.empty())
+                            {
+                                std::cout << "Please specify at least one pipeline depth!" << std::endl;
+                                valid = false;
+                            }
+                        }
+                        else
+                        {
+                            std::cout << "Please specify a list of pipeline depths!" << std::endl;
+                            valid = false;
+                        }
+                        iCount++;
+                        break;
+                    }
                 } // end switch
                 // default: omitted
             } 
@@ -259,6 +346,7 @@ struct FilterTestParameters
             {
 
                 mXML_Filename = argv[iCount];
+                mGraphs.push_back(mXML_Filename);
             }
 
             iCount++;
@@ -382,6 +382,8 @@ void GraphManager::fire()
 	// get time before the actual processing starts.
 	system::Timer oTimerFrame       ("Timer total");
 	oTimerFrame.start();
+    m_frameTimings.clear();
+    ElapsedTimer oTotalTimer;
 
 	// run the filter graph for every image
     unsigned int  numImagesToPlay = m_forceNumImages ? m_numImages : oNbImagesInFolder;
@@ -405,6 +407,12 @@ void GraphManager::fire()
         auto seamStart_us = oTimerFrame.us();
         while(imageCounterInSeam < numImagesCurrentSeam)
         {
+            if (m_warmUpImages > 0 && imageCounterTotal == m_warmUpImages)
+            {
+                // the warm up images are finished in completion order before the measured images start
+                joinAllWorkers();
+                oTotalTimer.restart();
+            }
             checkImageLoading(imageCounterTotal);
 
             const auto	oIdxData        =   imageCounterTotal % oNbImagesInFolder;
@@ -415,10 +423,19 @@ void GraphManager::fire()
                 pair.second.context().setImageNumber(imageCounterInSeam);
             }
             
-            oSignalAdapter.setSamples(m_oSampleFrames[oIdxData]);
-            oSignalAdapter.setImage(m_oVectorBmpData[oIdxData]);
-            oSignalAdapter.setImageNumber(imageCounterInSeam);
-            oSignalAdapter.run();
+            if (g_oNbPar == 1)
+            {
+                oSignalAdapter.setSamples(m_oSampleFrames[oIdxData]);
+                oSignalAdapter.setImage(m_oVectorBmpData[oIdxData]);
+                oSignalAdapter.setImageNumber(imageCounterInSeam);
+                ElapsedTimer oImageTimer;
+                oSignalAdapter.run();
+                m_frameTimings.push_back(oImageTimer.elapsed());
+            }
+            else
+            {
+                startWorker(imageCounterTotal % g_oNbPar, oIdxData, imageCounterInSeam);
+            }
 
             drawFrame(imageCounterTotal);
             
@@ -435,6 +452,7 @@ void GraphManager::fire()
         if (!lastSeam)
         { 
             assert(m_armAtSequenceRepetition);
+            joinAllWorkers();
             //Note: the timer is not stopped, the final average time per frame will be higher than the seam time per frame
             oTimerFrame.elapsed();
             auto seamEnd_us = oTimerFrame.us();
@@ -456,14 +474,12 @@ void GraphManager::fire()
 
     // for async notify test - wait for last image finished
     std::cout << "\n\tGraphManager::fire: Joining threads...\n";
-    for (std::size_t oIdx = imageCounterTotal - g_oNbPar; oIdx < imageCounterTotal; ++oIdx)
+    for (std::size_t oIdx = imageCounterTotal - std::min<std::size_t>(g_oNbPar, imageCounterTotal); oIdx < imageCounterTotal; ++oIdx)
     {
-        if (m_oWorkers[oIdx % g_oNbPar].isRunning())
-        {
-            m_oWorkers[oIdx % g_oNbPar].join();
-        }
+        joinWorker(oIdx % g_oNbPar);
         std::cout << "\tGraphManager::fire: Joined thread " << oIdx % g_oNbPar << " (img " << oIdx << ")." << std::endl;
     }
+    m_totalProcessingTime = oTotalTimer.elapsed();
 
 	// measure runtime and output stats.
 
@@ -652,6 +668,77 @@ void GraphManager::drawFrame(int p_oI)
 } // drawFrame
 
 
+void GraphManager::startWorker(std::size_t p_oIdxWorker, std::size_t p_oIdxData, int p_oImageNumber)
+{
+    joinWorker(p_oIdxWorker);
+
+    auto &rWorker = m_oSignalAdapters[p_oIdxWorker];
+    rWorker.m_signalAdapter = SignalAdapter{ p_oIdxWorker, nullptr, &m_oPipeImageFrame, m_oPipesSampleFrame[p_oIdxWorker].get(), m_pspGraph.get() };
+    rWorker.m_signalAdapter.setSamples(m_oSampleFrames[p_oIdxData]);
+    rWorker.m_signalAdapter.setImage(m_oVectorBmpData[p_oIdxData]);
+    rWorker.m_signalAdapter.setImageNumber(p_oImageNumber);
+    rWorker.m_pending = true;
+
+    m_oWorkers[p_oIdxWorker].start(rWorker);
+} // startWorker
+
+
+void GraphManager::joinWorker(std::size_t p_oIdxWorker)
+{
+    auto &rWorker = m_oSignalAdapters[p_oIdxWorker];
+    if (!rWorker.m_pending)
+    {
+        return;
+    }
+    m_oWorkers[p_oIdxWorker].join();
+    rWorker.m_pending = false;
+    m_frameTimings.push_back(rWorker.m_elapsed);
+} // joinWorker
+
+
+void GraphManager::joinAllWorkers()
+{
+    for (std::size_t oIdx = 0; oIdx < g_oNbParMax; ++oIdx)
+    {
+        joinWorker(oIdx);
+    }
+} // joinAllWorkers
+
+
+void GraphManager::setPipelineDepth(std::size_t depth)
+{
+    g_oNbPar = std::max<std::size_t>(1, std::min(depth, g_oNbParMax));
+    for (std::size_t oIdx = 0; oIdx < g_oNbPar; ++oIdx)
+    {
+        if (!m_oPipesSampleFrame[oIdx])
+        {
+            m_oPipesSampleFrame[oIdx].reset(new SampleFramePipe{ &m_oNullSourceFilter, SensorFilterInterface::SENSOR_SAMPLE_FRAME_PIPE });
+        }
+    }
+    std::cout << "GraphManager::setPipelineDepth: " << g_oNbPar << std::endl;
+} // setPipelineDepth
+
+
+void GraphManager::generateSyntheticImages(std::size_t numImages)
+{
+    if (!m_oBmpPath.empty())
+    {
+        return;
+    }
+    m_oVectorBmpData.clear();
+    m_oSampleFrames.resize(numImages, m_oSampleFrames.empty() ? std::map<int, SampleFrame>{} : m_oSampleFrames.front());
+    for (std::size_t oIdx = 0; oIdx < numImages; ++oIdx)
+    {
+        ImageContext oImageContext;
+        oImageContext.setImageNumber(oIdx);
+        oImageContext.HW_ROI_x0 = m_oHWROI.x;
+        oImageContext.HW_ROI_y0 = m_oHWROI.y;
+        m_oVectorBmpData.emplace_back(oImageContext, genModuloPattern(m_oImgSize, 2 + oIdx % 254));
+    }
+    m_oNbImagesLoaded.store(numImages);
+} // generateSyntheticImages
+
+
 void GraphManager::writeResultsToFolder(std::string folder) 
 {
     m_oResultHandler.setResultFolder(folder);
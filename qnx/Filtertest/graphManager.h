@@ -15,6 +15,7 @@
 #include <array>
 #include <set>
 #include <memory>
+#include <chrono>
 // Poco includes
 #include <Poco/File.h>
 #include <Poco/Thread.h>
@@ -30,6 +31,7 @@
 #include "common/frame.h"
 #include "filter/productData.h"
 #include "overlay/overlayCanvas.h"
+#include "system/timer.h"
 // local includes
 #if defined __QNX__
 	#include "QnxCanvas.h"
@@ -49,7 +51,6 @@ public:
     typedef fliplib::SynchronePipe< interface::ImageFrame >  ImageFramePipe;
     typedef fliplib::SynchronePipe< interface::SampleFrame > SampleFramePipe;
     typedef Poco::RunnableAdapter<GraphManager>				 thread_adapter_t;
-    typedef std::array<analyzer::SignalAdapter, g_oNbParMax> signal_adapters_t;
 
  	GraphManager( const std::string p_oFilename, const std::string p_oBmpPath, 
                   int inspectionVelocity_um_s, int triggerDelta_um,
@@ -68,13 +69,66 @@ public:
     {
         m_pauseAfterEachImage = pause;
     }
+    /**
+     * Sets the number of images processed concurrently (g_oNbPar), limited to [1, g_oNbParMax].
+     * With a depth greater than 1 each image is processed in its own worker thread, like in the analyzer.
+     **/
+    void setPipelineDepth(std::size_t depth);
+    /**
+     * Replaces the default (black) images used without image path by @p numImages modulo pattern images.
+     * Has no effect if images were loaded from an image path.
+     **/
+    void generateSyntheticImages(std::size_t numImages);
+
+    /**
+     * @returns the processing time of every image of the last fire, in completion order.
+     **/
+    const std::vector<std::chrono::nanoseconds> &frameTimings() const
+    {
+        return m_frameTimings;
+    }
+    /**
+     * The first @p warmUpImages of fire are processed before the wall clock time of totalProcessingTime starts.
+     **/
+    void setWarmUpImages(std::size_t warmUpImages)
+    {
+        m_warmUpImages = warmUpImages;
+    }
+    /**
+     * @returns the wall clock time of the last fire, from the first image after the warm up images until the last image was processed.
+     **/
+    std::chrono::nanoseconds totalProcessingTime() const
+    {
+        return m_totalProcessingTime;
+    }
 
 	void fire();
 private:
-    
+    /**
+     * Processes a SignalAdapter in a worker thread and measures the time until the graph finished the image.
+     **/
+    class TimedSignalAdapter : public Poco::Runnable
+    {
+    public:
+        void run() override
+        {
+            m_timer.restart();
+            m_signalAdapter.run();
+            m_elapsed = m_timer.elapsed();
+        }
+
+        analyzer::SignalAdapter m_signalAdapter;
+        system::ElapsedTimer m_timer;
+        std::chrono::nanoseconds m_elapsed{0};
+        bool m_pending = false;
+    };
+
 	void loadImages();
     void checkImageLoading(int p_oI);
     void drawFrame(int p_oI);
+    void startWorker(std::size_t p_oIdxWorker, std::size_t p_oIdxData, int p_oImageNumber);
+    void joinWorker(std::size_t p_oIdxWorker);
+    void joinAllWorkers();
 
 	const std::string										m_oXML_Filename;
 	const std::string										m_oBmpPath;
@@ -98,7 +152,8 @@ private:
 	thread_adapter_t										m_oRunloadImages;	        ///< Thread adapter that executes the loadImages() method
 	Poco::Thread											m_oWorkerImgLoad;
     std::array<Poco::Thread, g_oNbParMax>					m_oWorkers;					// worker threads, number of used ones depends on user parameter
-	signal_adapters_t                                       m_oSignalAdapters;           ///< signal adpaters for using worker threads with a data pipe and an image
+	std::array<TimedSignalAdapter, g_oNbParMax>             m_oSignalAdapters;           ///< signal adpaters for using worker threads with a data pipe and an image
+    std::array<std::unique_ptr<SampleFramePipe>, g_oNbParMax> m_oPipesSampleFrame;       ///< one sample pipe per worker, the sample pipe gets rewired during processing
     mutable Poco::Semaphore									m_oImagesLoadedSema;        ///< semaphore to signal that all images have been loaded
     std::atomic<std::size_t>                                m_oNbImagesLoaded;			// atomic buggy under gcc 4.61 - doesnt matter here
     std::map<interface::Sensor,int> m_oDefaultSamples;
@@ -108,6 +163,9 @@ private:
     bool m_armAtSequenceRepetition = false;
     int m_numImages;
     bool m_pauseAfterEachImage{false};
+    std::vector<std::chrono::nanoseconds> m_frameTimings;
+    std::chrono::nanoseconds m_totalProcessingTime{0};
+    std::size_t m_warmUpImages = 0;
 
 
 };
@@ -12,17 +12,21 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <set>
+#include <algorithm>
 
 // Poco includes
 #include <Poco/Path.h>
 #include <Poco/File.h>
 #include <Poco/Exception.h>
 #include <Poco/Environment.h>
+#include <Poco/Glob.h>
 // fliplib includes
 #include <fliplib/Exception.h>
 #include <fliplib/FilterLibrary.h>
 // local includes
 #include "graphManager.h"
+#include "benchmark.h"
 
 #include "filtertestParameters.h"
 #include "calibrationUtilities.h"
@@ -118,6 +122,47 @@ int main(int argc, char * argv[])
         }
 	}//end test checkerboard
 
+    if (!parameters.mBenchmarkOutput.empty())
+    {
+        namespace benchmark = precitec::filter::benchmark;
+        benchmark::BenchmarkParameters benchmarkParameters;
+        for (const auto &graph : parameters.mGraphs)
+        {
+            if (Poco::File(graph).exists() && Poco::File(graph).isDirectory())
+            {
+                std::set<std::string> graphsInDirectory;
+                Poco::Glob::glob(Poco::Path(graph, "*.xml").makeFile(), graphsInDirectory);
+                benchmarkParameters.graphs.insert(benchmarkParameters.graphs.end(), graphsInDirectory.begin(), graphsInDirectory.end());
+            }
+            else
+            {
+                benchmarkParameters.graphs.push_back(graph);
+            }
+        }
+        benchmarkParameters.imagePath = parameters.mBmpPath;
+        benchmarkParameters.pipelineDepths = parameters.mPipelineDepths;
+        benchmarkParameters.numImages = std::max(parameters.mNumberOfImages, 0);
+
+        const auto results = benchmark::run(benchmarkParameters);
+        if (results.empty() || !benchmark::writeJson(results, parameters.mBenchmarkOutput))
+        {
+            return EXIT_FAILURE;
+        }
+        if (!parameters.mBenchmarkBaseline.empty())
+        {
+            const auto regressions = benchmark::compare(results, benchmark::readJson(parameters.mBenchmarkBaseline), parameters.mBenchmarkTolerance);
+            for (const auto &regression : regressions)
+            {
+                std::cout << "REGRESSION: " << regression << std::endl;
+            }
+            if (!regressions.empty())
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
     if (parameters.mXML_Filename.empty())
     {
         return EXIT_FAILURE;
@@ -0,0 +1,197 @@
+#include <QTest>
+
+#include "overlay/overlayCanvas.h"
+#include "overlay/overlayPrimitive.h"
+#include "message/messageBuffer.h"
+#include "message/serializer.h"
+
+using namespace precitec::image;
+using precitec::geo2d::Point;
+using precitec::geo2d::Rect;
+using precitec::system::message::MessageBuffer;
+using precitec::system::message::Serializable;
+using precitec::system::message::StaticMessageBuffer;
+
+class BenchmarkOverlayCommandBuffer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkPaintShapes();
+    void benchmarkPaintCommands();
+    void benchmarkSerializeShapes();
+    void benchmarkSerializeCommands();
+    void benchmarkWriteShapes();
+    void benchmarkWriteCommands();
+
+private:
+    std::vector<int> m_laserLine;
+};
+
+namespace
+{
+
+// a typical frame of a seam tracking graph: the laser line of a 1024 pixel wide image,
+// the found seam points with crosses and lines and some result texts
+const int IMAGE_WIDTH = 1024;
+const int POINT_COUNT = 200;
+const int LINE_COUNT = 50;
+const int TEXT_COUNT = 20;
+const std::size_t PRIMITIVE_COUNT = 1 + 2 * POINT_COUNT + LINE_COUNT + TEXT_COUNT;
+
+/**
+ * The layer as it was before the command buffer: every primitive is a heap allocated polymorphic shape.
+ **/
+class ShapeLayer : public Serializable
+{
+public:
+    template <typename T, typename... Args>
+    void add(Args&&... args)
+    {
+        m_shapes.emplace_back(std::make_shared<T>(std::forward<Args>(args)...));
+    }
+
+    void serialize(MessageBuffer &buffer) const override
+    {
+        marshal(buffer, m_shapes, m_shapes.size());
+    }
+
+    void deserialize(MessageBuffer const &buffer) override
+    {
+        deMarshal(buffer, m_shapes, 0);
+    }
+
+    void write(OverlayCanvas &canvas, int zOrder) const
+    {
+        for (const auto &shape : m_shapes)
+        {
+            shape->writeShape(canvas, zOrder);
+        }
+    }
+
+    void clear()
+    {
+        m_shapes.clear();
+    }
+
+    std::size_t size() const
+    {
+        return m_shapes.size();
+    }
+
+private:
+    ShapeList m_shapes;
+};
+
+/**
+ * Paints the frame, either into the command buffer of an OverlayLayer or into a ShapeLayer.
+ **/
+template <typename Layer>
+void paint(Layer &layer, const std::vector<int> &laserLine)
+{
+    layer.template add<OverlayPointList>(Point{0, 0}, laserLine, Color::Green(), true);
+    for (int i = 0; i < POINT_COUNT; i++)
+    {
+        layer.template add<OverlayPoint>(Point{i * 5, laserLine[i * 5]}, Color::Red());
+        layer.template add<OverlayCross>(Point{i * 5, laserLine[i * 5]}, 3, Color::Blue());
+    }
+    for (int i = 0; i < LINE_COUNT; i++)
+    {
+        layer.template add<OverlayLine>(i * 20, 0, i * 20, 1023, Color::Yellow());
+    }
+    for (int i = 0; i < TEXT_COUNT; i++)
+    {
+        layer.template add<OverlayText>("result " + std::to_string(i), Font{14}, Rect{10, i * 20, 200, 20}, Color::Orange());
+    }
+}
+
+}
+
+void BenchmarkOverlayCommandBuffer::initTestCase()
+{
+    m_laserLine.reserve(IMAGE_WIDTH);
+    for (int x = 0; x < IMAGE_WIDTH; x++)
+    {
+        m_laserLine.push_back(500 + (x % 64) - 32);
+    }
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkPaintShapes()
+{
+    ShapeLayer layer;
+    QBENCHMARK
+    {
+        layer.clear();
+        paint(layer, m_laserLine);
+    }
+    QCOMPARE(layer.size(), PRIMITIVE_COUNT);
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkPaintCommands()
+{
+    // the canvas is cleared and painted again for every image, the command buffer keeps its capacity
+    OverlayCanvas canvas;
+    QBENCHMARK
+    {
+        canvas.clearShapes();
+        paint(canvas.getLayerLine(), m_laserLine);
+    }
+    QCOMPARE(canvas.getLayerLine().commands().size(), PRIMITIVE_COUNT);
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkSerializeShapes()
+{
+    ShapeLayer layer;
+    paint(layer, m_laserLine);
+    StaticMessageBuffer buffer(1024 * 1024);
+    ShapeLayer received;
+    QBENCHMARK
+    {
+        buffer.rewind();
+        layer.serialize(buffer);
+        buffer.rewind();
+        received.clear();
+        received.deserialize(buffer);
+    }
+    QCOMPARE(received.size(), PRIMITIVE_COUNT);
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkSerializeCommands()
+{
+    OverlayLayer layer;
+    paint(layer, m_laserLine);
+    StaticMessageBuffer buffer(1024 * 1024);
+    OverlayLayer received;
+    QBENCHMARK
+    {
+        buffer.rewind();
+        layer.serialize(buffer);
+        buffer.rewind();
+        received.deserialize(buffer);
+    }
+    QCOMPARE(received.commands().size(), PRIMITIVE_COUNT);
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkWriteShapes()
+{
+    ShapeLayer layer;
+    paint(layer, m_laserLine);
+    OverlayCanvas canvas;
+    QBENCHMARK
+    {
+        layer.write(canvas, eLayerLine);
+    }
+}
+
+void BenchmarkOverlayCommandBuffer::benchmarkWriteCommands()
+{
+    OverlayCanvas canvas;
+    paint(canvas.getLayerLine(), m_laserLine);
+    QBENCHMARK
+    {
+        canvas.write();
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkOverlayCommandBuffer)
+#include "benchmarkOverlayCommandBuffer.moc"
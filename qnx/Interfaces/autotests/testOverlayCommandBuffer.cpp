@@ -0,0 +1,233 @@
+#include "../../Mod_Grabber/autotests/testHelper.h"
+
+#include "overlay/overlayCanvas.h"
+#include "overlay/overlayPrimitive.h"
+#include "message/messageBuffer.h"
+
+#include <algorithm>
+#include <sstream>
+
+using precitec::image::Color;
+using precitec::image::Font;
+using precitec::image::OverlayCanvas;
+using precitec::image::OverlayCommandBuffer;
+using precitec::image::OverlayLayer;
+using precitec::image::OverlayShape;
+using precitec::image::OverlayText;
+using precitec::geo2d::Point;
+using precitec::geo2d::Rect;
+using precitec::system::message::StaticMessageBuffer;
+
+namespace
+{
+
+/**
+ * Canvas which records every write call as text.
+ **/
+class RecordingCanvas : public OverlayCanvas
+{
+public:
+    void writePixel(int layer, int x, int y, const Color &c) override
+    {
+        record() << "pixel " << layer << " " << x << " " << y << " " << c.toARGB();
+    }
+    void writeLine(int layer, int x0, int y0, int x1, int y1, const Color &c) override
+    {
+        record() << "line " << layer << " " << x0 << " " << y0 << " " << x1 << " " << y1 << " " << c.toARGB();
+    }
+    void writeCircle(int layer, int x, int y, int r, const Color &c) override
+    {
+        record() << "circle " << layer << " " << x << " " << y << " " << r << " " << c.toARGB();
+    }
+    void writeText(int layer, const std::string &text, const Font &font, const Rect &bounds, const Color &c, int index) override
+    {
+        record() << "text " << layer << " " << text << " " << font.name << " " << font.size << " " << font.bold << " " << font.italic << " "
+                 << bounds.x().start() << " " << bounds.x().end() << " " << bounds.y().start() << " " << bounds.y().end() << " " << c.toARGB() << " " << index;
+    }
+    void writeRect(int layer, const Rect &rectangle, const Color &c) override
+    {
+        record() << "rect " << layer << " " << rectangle.x().start() << " " << rectangle.x().end() << " " << rectangle.y().start() << " " << rectangle.y().end() << " " << c.toARGB();
+    }
+    void writeInfoBox(int layer, precitec::image::ContentType contentType, int id, const std::vector<OverlayText> &lines, const Rect &boundingBox) override
+    {
+        record() << "infobox " << layer << " " << contentType << " " << id << " " << lines.size();
+    }
+    void writePixelList(int layer, const Point &position, const std::vector<int> &y, const Color &c) override
+    {
+        writeList("pixellist ", layer, position, y, c);
+    }
+    void writeConnectedPixelList(int layer, const Point &position, const std::vector<int> &y, const Color &c) override
+    {
+        writeList("connectedpixellist ", layer, position, y, c);
+    }
+
+    const std::vector<std::string> &calls() const
+    {
+        return m_calls;
+    }
+
+private:
+    struct Recorder
+    {
+        ~Recorder()
+        {
+            calls.push_back(stream.str());
+        }
+        template <typename T>
+        Recorder &operator<<(const T &value)
+        {
+            stream << value;
+            return *this;
+        }
+        std::vector<std::string> &calls;
+        std::ostringstream stream;
+    };
+
+    Recorder record()
+    {
+        return Recorder{m_calls, {}};
+    }
+
+    void writeList(const char *name, int layer, const Point &position, const std::vector<int> &y, const Color &c)
+    {
+        auto recorder = record();
+        recorder << name << layer << " " << position.x << " " << position.y << " " << c.toARGB();
+        for (auto value : y)
+        {
+            recorder << " " << value;
+        }
+    }
+
+    std::vector<std::string> m_calls;
+};
+
+/**
+ * Paints one of each primitive, either via the command buffer or as polymorphic shapes.
+ **/
+void paint(OverlayLayer &layer)
+{
+    using namespace precitec::image;
+    layer.add<OverlayPoint>(Point{1, 2}, Color::Red());
+    layer.add<OverlayLine>(3, 4, 5, 6, Color::Green());
+    layer.add<OverlayCross>(Point{7, 8}, 3, Color::Blue());
+    layer.add<OverlayRectangle>(Rect{9, 10, 11, 12}, Color::Yellow());
+    layer.add<OverlayInfoBox>(eSurface, 42, std::vector<OverlayText>{OverlayText{"info", Font{}, Rect{0, 0, 10, 10}, Color::Black()}}, Rect{1, 1, 5, 5});
+    layer.add<OverlayText>("text", Font{12, true, false, "Courier"}, Rect{13, 14, 100, 20}, Color::Orange(), 3);
+    layer.add<OverlayText>("text", Font{14}, Point{20, 30}, Color::Cyan());
+    layer.add<OverlayCircle>(15, 16, 17, Color::Magenta());
+    layer.add<OverlayPointList>(Point{18, 19}, std::vector<int>{1, 2, 3}, Color::White(), true);
+    layer.add<OverlayPointList>(Point{20, 21}, std::vector<double>{4.4, 5.6}, Color::White());
+    layer.add(new OverlayPoint(22, 23, Color::Red()));
+    layer.add(std::make_shared<OverlayLine>(24, 25, 26, 27, Color::Black()));
+}
+
+std::vector<std::shared_ptr<OverlayShape>> legacyShapes()
+{
+    using namespace precitec::image;
+    return {
+        std::make_shared<OverlayPoint>(Point{1, 2}, Color::Red()),
+        std::make_shared<OverlayLine>(3, 4, 5, 6, Color::Green()),
+        std::make_shared<OverlayCross>(Point{7, 8}, 3, Color::Blue()),
+        std::make_shared<OverlayRectangle>(Rect{9, 10, 11, 12}, Color::Yellow()),
+        std::make_shared<OverlayInfoBox>(eSurface, 42, std::vector<OverlayText>{OverlayText{"info", Font{}, Rect{0, 0, 10, 10}, Color::Black()}}, Rect{1, 1, 5, 5}),
+        std::make_shared<OverlayText>("text", Font{12, true, false, "Courier"}, Rect{13, 14, 100, 20}, Color::Orange(), 3),
+        std::make_shared<OverlayText>("text", Font{14}, Point{20, 30}, Color::Cyan()),
+        std::make_shared<OverlayCircle>(15, 16, 17, Color::Magenta()),
+        std::make_shared<OverlayPointList>(Point{18, 19}, std::vector<int>{1, 2, 3}, Color::White(), true),
+        std::make_shared<OverlayPointList>(Point{20, 21}, std::vector<double>{4.4, 5.6}, Color::White()),
+        std::make_shared<OverlayPoint>(22, 23, Color::Red()),
+        std::make_shared<OverlayLine>(24, 25, 26, 27, Color::Black())
+    };
+}
+
+}
+
+class TestOverlayCommandBuffer : public CppUnit::TestFixture
+{
+CPPUNIT_TEST_SUITE(TestOverlayCommandBuffer);
+CPPUNIT_TEST(testStorage);
+CPPUNIT_TEST(testWriteMatchesShapes);
+CPPUNIT_TEST(testSerialization);
+CPPUNIT_TEST(testClear);
+CPPUNIT_TEST_SUITE_END();
+public:
+    void testStorage();
+    void testWriteMatchesShapes();
+    void testSerialization();
+    void testClear();
+};
+
+void TestOverlayCommandBuffer::testStorage()
+{
+    OverlayCanvas canvas;
+    auto &layer = canvas.getLayerLine();
+    CPPUNIT_ASSERT_EQUAL(false, layer.hasShapes());
+    paint(layer);
+    CPPUNIT_ASSERT_EQUAL(true, layer.hasShapes());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(12), layer.commands().size());
+    // only the info box and the shape added as shared pointer need a heap allocated shape
+    const auto &commands = layer.commands().commands();
+    CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t(2), std::count_if(commands.begin(), commands.end(), [] (const auto &command) { return command.type == OverlayCommandBuffer::eShape; }));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), layer.info().size());
+}
+
+void TestOverlayCommandBuffer::testWriteMatchesShapes()
+{
+    RecordingCanvas canvas;
+    paint(canvas.getLayer(3));
+    canvas.write();
+
+    RecordingCanvas expected;
+    for (const auto &shape : legacyShapes())
+    {
+        shape->writeShape(expected, 3);
+    }
+    CPPUNIT_ASSERT_EQUAL(expected.calls().size(), canvas.calls().size());
+    for (std::size_t i = 0; i < expected.calls().size(); i++)
+    {
+        CPPUNIT_ASSERT_EQUAL(expected.calls()[i], canvas.calls()[i]);
+    }
+}
+
+void TestOverlayCommandBuffer::testSerialization()
+{
+    OverlayCanvas canvas{640, 480};
+    paint(canvas.getLayerLine());
+    paint(canvas.getLayerText());
+
+    StaticMessageBuffer buffer(1024 * 1024);
+    canvas.serialize(buffer);
+    buffer.rewind();
+
+    RecordingCanvas received;
+    received.deserialize(buffer);
+    received.write();
+
+    RecordingCanvas expected;
+    paint(expected.getLayerLine());
+    paint(expected.getLayerText());
+    expected.write();
+
+    CPPUNIT_ASSERT_EQUAL(expected.calls().size(), received.calls().size());
+    for (std::size_t i = 0; i < expected.calls().size(); i++)
+    {
+        CPPUNIT_ASSERT_EQUAL(expected.calls()[i], received.calls()[i]);
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), received.getLayerLine().info().size());
+}
+
+void TestOverlayCommandBuffer::testClear()
+{
+    OverlayCanvas canvas;
+    paint(canvas.getLayerLine());
+    canvas.clearShapes();
+    CPPUNIT_ASSERT_EQUAL(false, canvas.getLayerLine().hasShapes());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), canvas.getLayerLine().info().size());
+
+    RecordingCanvas recording;
+    recording.swap(canvas);
+    recording.write();
+    CPPUNIT_ASSERT(recording.calls().empty());
+}
+
+TEST_MAIN(TestOverlayCommandBuffer)
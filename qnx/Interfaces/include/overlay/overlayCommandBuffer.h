@@ -0,0 +1,185 @@
+/**
+ * 	@file
+ * 	@copyright	Precitec Vision GmbH & Co. KG
+ * 	@date		2026
+ *	@brief		Flat, append-only storage of the simple overlay primitives of a layer.
+ */
+
+#ifndef OVERLAYCOMMANDBUFFER_H_20261019_INCLUDED
+#define OVERLAYCOMMANDBUFFER_H_20261019_INCLUDED
+
+#include "InterfacesManifest.h"
+
+#include "message/serializer.h"
+#include "overlay/color.h"
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace precitec {
+namespace image {
+
+	class OverlayCanvas;
+	class OverlayPoint;
+	class OverlayLine;
+	class OverlayCross;
+	class OverlayRectangle;
+	class OverlayText;
+	class OverlayCircle;
+	class OverlayPointList;
+
+	/**
+	 * One entry of the OverlayCommandBuffer. Trivially copyable, so that the command list can be serialized with one copy.
+	 * The meaning of the coordinates depends on the type:
+	 * @li ePoint: x, y
+	 * @li eLine: x0, y0, x1, y1
+	 * @li eCross, eCircle: x, y, r
+	 * @li eRectangle: x start, x end, y start, y end
+	 * @li eText: bounds as eRectangle, payload: text string index, font name string index, font size, text index
+	 * @li ePointList: x, y of the position, payload: the y values
+	 * @li eShape: payloadOffset is the index of a polymorphic OverlayShape stored in the layer
+	 **/
+	struct OverlayCommand
+	{
+		std::uint8_t	type;
+		std::uint8_t	flags;
+		std::uint16_t	reserved;
+		Color			color;
+		std::int32_t	coordinates[4];
+		std::uint32_t	payloadOffset;
+		std::uint32_t	payloadSize;
+	};
+
+	/**
+	 * Append-only buffer of overlay commands with an int payload arena and an interned string table.
+	 *
+	 * Replaces one heap allocated OverlayShape per primitive for the primitives filters paint most often.
+	 * Once the buffer grew to the size needed per image, clear() keeps the capacity and adding commands
+	 * does not allocate any more.
+	 **/
+	class INTERFACES_API OverlayCommandBuffer : public system::message::Serializable
+	{
+	public:
+		enum Type : std::uint8_t { ePoint, eLine, eCross, eRectangle, eText, eCircle, ePointList, eShape };
+		enum Flags : std::uint8_t { eConnected = 1, eBold = 2, eItalic = 4 };
+
+		/**
+		 * Whether primitives of type @p T are stored as command, all other shapes are kept as OverlayShape.
+		 **/
+		template <typename T>
+		static constexpr bool isCommand()
+		{
+			return std::is_same<T, OverlayPoint>::value || std::is_same<T, OverlayLine>::value || std::is_same<T, OverlayCross>::value
+				|| std::is_same<T, OverlayRectangle>::value || std::is_same<T, OverlayText>::value || std::is_same<T, OverlayCircle>::value
+				|| std::is_same<T, OverlayPointList>::value;
+		}
+
+		void append(const OverlayPoint &point);
+		void append(const OverlayLine &line);
+		void append(const OverlayCross &cross);
+		void append(const OverlayRectangle &rectangle);
+		void append(const OverlayText &text);
+		void append(const OverlayCircle &circle);
+		void append(const OverlayPointList &pointList);
+		/**
+		 * Appends a reference to the polymorphic shape at @p index in the layer's shape list to keep the paint order.
+		 **/
+		void appendShape(std::size_t index);
+
+		/**
+		 * Invokes the matching OverlayCanvas::write method for every command, @p writeShape for eShape commands.
+		 **/
+		template <typename ShapeWriter>
+		void write(OverlayCanvas &canvas, int zOrder, ShapeWriter writeShape) const;
+
+		/**
+		 * Invokes the matching OverlayCanvas::draw method for every command, @p drawShape for eShape commands.
+		 **/
+		template <typename ShapeDrawer>
+		void draw(OverlayCanvas &canvas, ShapeDrawer drawShape) const;
+
+		void clear();
+
+		bool empty() const
+		{
+			return m_commands.empty();
+		}
+
+		std::size_t size() const
+		{
+			return m_commands.size();
+		}
+
+		const std::vector<OverlayCommand> &commands() const
+		{
+			return m_commands;
+		}
+
+		const std::string &string(std::uint32_t index) const
+		{
+			return m_strings[index];
+		}
+
+		const int *payload(const OverlayCommand &command) const
+		{
+			return m_payload.data() + command.payloadOffset;
+		}
+
+		void serialize(system::message::MessageBuffer &buffer) const override;
+		void deserialize(system::message::MessageBuffer const &buffer) override;
+
+	private:
+		OverlayCommand &add(Type type, const Color &color);
+		std::uint32_t intern(const std::string &value);
+		void writeCommand(OverlayCanvas &canvas, int zOrder, const OverlayCommand &command, std::vector<int> &pointList) const;
+		void drawCommand(OverlayCanvas &canvas, const OverlayCommand &command, std::vector<int> &pointList) const;
+
+		std::vector<OverlayCommand> m_commands;
+		std::vector<int> m_payload;
+		std::vector<std::string> m_strings;
+		std::unordered_map<std::string, std::uint32_t> m_stringIndex;
+	};
+
+	template <typename ShapeWriter>
+	void OverlayCommandBuffer::write(OverlayCanvas &canvas, int zOrder, ShapeWriter writeShape) const
+	{
+		// one buffer for the y values of all point lists, the canvas api takes a vector
+		std::vector<int> pointList;
+		for (const auto &command : m_commands)
+		{
+			if (command.type == eShape)
+			{
+				writeShape(command.payloadOffset);
+			}
+			else
+			{
+				writeCommand(canvas, zOrder, command, pointList);
+			}
+		}
+	}
+
+	template <typename ShapeDrawer>
+	void OverlayCommandBuffer::draw(OverlayCanvas &canvas, ShapeDrawer drawShape) const
+	{
+		// reused for the y values of all point lists as in write
+		std::vector<int> pointList;
+		for (const auto &command : m_commands)
+		{
+			if (command.type == eShape)
+			{
+				drawShape(command.payloadOffset);
+			}
+			else
+			{
+				drawCommand(canvas, command, pointList);
+			}
+		}
+	}
+
+} // namespace image
+} // namespace precitec
+
+#endif /*OVERLAYCOMMANDBUFFER_H_20261019_INCLUDED*/
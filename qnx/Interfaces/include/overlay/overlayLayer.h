@@ -13,7 +13,9 @@
 
 #include "message/serializer.h"
 #include "overlay/overlayShape.h"
+#include "overlay/overlayCommandBuffer.h"
 
+#include <memory>
 #include <vector>
 
 namespace precitec {
@@ -30,7 +32,15 @@ namespace image {
         template <typename T>
         void add(T* shape)
         {
-            add(SpOverlayShape(shape));
+            if constexpr (OverlayCommandBuffer::isCommand<T>())
+            {
+                std::unique_ptr<T> owner{shape};
+                m_commands.append(*owner);
+            }
+            else
+            {
+                add(SpOverlayShape(shape));
+            }
         }
         /**
          * Overload which adds with zero temporary copies if the overlay needs to be constructed as a new object.
@@ -44,13 +54,24 @@ namespace image {
          * @code
          * layer.add<OverlayPoint>(Point(1, 2), Color::Red());
          * @endcode
+         *
+         * The simple primitives (see OverlayCommandBuffer::isCommand) are not allocated at all, but
+         * appended to the layer's command buffer.
          **/
         template <typename T, typename... Args>
         void add(Args&&... args)
         {
-            // arguments are forwarded to make_shared so that the shared pointer does not
-            // need to be copied in. By using emplace_back also the insert into the vector is without copy
-            shapes_.emplace_back(std::make_shared<T>(std::forward<Args>(args)...));
+            if constexpr (OverlayCommandBuffer::isCommand<T>())
+            {
+                m_commands.append(T(std::forward<Args>(args)...));
+            }
+            else
+            {
+                // arguments are forwarded to make_shared so that the shared pointer does not
+                // need to be copied in. By using emplace_back also the insert into the vector is without copy
+                m_commands.appendShape(shapes_.size());
+                shapes_.emplace_back(std::make_shared<T>(std::forward<Args>(args)...));
+            }
         }
 
 		void serialize ( system::message::MessageBuffer &buffer ) const;
@@ -63,6 +84,14 @@ namespace image {
 
         ShapeList info() const;
 
+        /**
+         * @returns the command buffer holding all primitives of this layer in paint order.
+         **/
+        const OverlayCommandBuffer &commands() const
+        {
+            return m_commands;
+        }
+
 	private:
 		friend class OverlayCanvas;
 
@@ -73,7 +102,8 @@ namespace image {
 		void clearShapeList();
 
 	protected:
-		ShapeList shapes_;
+		ShapeList shapes_;				///< shapes which are not stored as command, referenced by eShape commands
+		OverlayCommandBuffer m_commands;
 	};
 
 	typedef std::vector<OverlayLayer> LayerList;
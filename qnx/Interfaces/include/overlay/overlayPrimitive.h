@@ -33,6 +33,7 @@ namespace image
 	// Zeichnet einen Punkt
 	class INTERFACES_API OverlayPoint : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 	public:
 		OverlayPoint(system::message::MessageBuffer const&buffer);
 		OverlayPoint(geo2d::Point p, Color const& c);
@@ -60,6 +61,7 @@ namespace image
 	 */
 	class INTERFACES_API OverlayLine : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 	public:
 		OverlayLine(system::message::MessageBuffer const&buffer);
 		OverlayLine(geo2d::Point from, geo2d::Point to, Color const& c);
@@ -91,6 +93,7 @@ namespace image
 	 */
 	class INTERFACES_API OverlayCross : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 		enum { CROSS_SIZE = 10 };
 
 	public:
@@ -123,6 +126,7 @@ namespace image
 	 **/
 	class INTERFACES_API OverlayRectangle : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 
 	public:
 		OverlayRectangle(system::message::MessageBuffer const&buffer);
@@ -151,6 +155,7 @@ namespace image
 	// Text auf Canvas
 	class INTERFACES_API OverlayText : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 
 	public:
 		OverlayText();
@@ -182,6 +187,7 @@ namespace image
 	 */
 	class INTERFACES_API OverlayCircle: public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 
 	public:
 		OverlayCircle(system::message::MessageBuffer const&buffer);
@@ -287,6 +293,7 @@ private:
 // Displays a list of points
 class INTERFACES_API OverlayPointList : public OverlayShape
 	{
+		friend class OverlayCommandBuffer;
 	public:
 		OverlayPointList(system::message::MessageBuffer const&buffer);
         OverlayPointList(geo2d::Point p_oPosition, const std::vector<int>  p_vec_y, Color const& c, bool connected=false); //laser line+ linear trafo
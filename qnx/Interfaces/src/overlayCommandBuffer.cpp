@@ -0,0 +1,266 @@
+/**
+ * 	@file
+ * 	@copyright	Precitec Vision GmbH & Co. KG
+ * 	@date		2026
+ *	@brief		Flat, append-only storage of the simple overlay primitives of a layer.
+ */
+
+#include "overlay/overlayCommandBuffer.h"
+#include "overlay/overlayPrimitive.h"
+
+#include "message/messageBuffer.h"
+
+namespace precitec {
+namespace image {
+
+namespace
+{
+
+geo2d::Rect toRect(const OverlayCommand &command)
+{
+	return geo2d::Rect{geo2d::Range{command.coordinates[0], command.coordinates[1]}, geo2d::Range{command.coordinates[2], command.coordinates[3]}};
+}
+
+}
+
+OverlayCommand &OverlayCommandBuffer::add(Type type, const Color &color)
+{
+	m_commands.emplace_back();
+	auto &command = m_commands.back();
+	command.type = type;
+	command.flags = 0;
+	command.reserved = 0;
+	command.color = color;
+	command.coordinates[0] = 0;
+	command.coordinates[1] = 0;
+	command.coordinates[2] = 0;
+	command.coordinates[3] = 0;
+	command.payloadOffset = 0;
+	command.payloadSize = 0;
+	return command;
+}
+
+std::uint32_t OverlayCommandBuffer::intern(const std::string &value)
+{
+	auto it = m_stringIndex.find(value);
+	if (it != m_stringIndex.end())
+	{
+		return it->second;
+	}
+	const std::uint32_t index = m_strings.size();
+	m_strings.push_back(value);
+	m_stringIndex.emplace(value, index);
+	return index;
+}
+
+void OverlayCommandBuffer::append(const OverlayPoint &point)
+{
+	auto &command = add(ePoint, point.color_);
+	command.coordinates[0] = point.p_.x;
+	command.coordinates[1] = point.p_.y;
+}
+
+void OverlayCommandBuffer::append(const OverlayLine &line)
+{
+	auto &command = add(eLine, line.color_);
+	command.coordinates[0] = line.p0_.x;
+	command.coordinates[1] = line.p0_.y;
+	command.coordinates[2] = line.p1_.x;
+	command.coordinates[3] = line.p1_.y;
+}
+
+void OverlayCommandBuffer::append(const OverlayCross &cross)
+{
+	auto &command = add(eCross, cross.color_);
+	command.coordinates[0] = cross.p_.x;
+	command.coordinates[1] = cross.p_.y;
+	command.coordinates[2] = cross.r_;
+}
+
+void OverlayCommandBuffer::append(const OverlayRectangle &rectangle)
+{
+	auto &command = add(eRectangle, rectangle.color_);
+	command.coordinates[0] = rectangle.rectangle_.x().start();
+	command.coordinates[1] = rectangle.rectangle_.x().end();
+	command.coordinates[2] = rectangle.rectangle_.y().start();
+	command.coordinates[3] = rectangle.rectangle_.y().end();
+}
+
+void OverlayCommandBuffer::append(const OverlayText &text)
+{
+	const auto textIndex = intern(text.text_);
+	const auto fontIndex = intern(text.font_.name);
+
+	auto &command = add(eText, text.color_);
+	command.flags = (text.font_.bold ? eBold : 0) | (text.font_.italic ? eItalic : 0);
+	command.coordinates[0] = text.bounds_.x().start();
+	command.coordinates[1] = text.bounds_.x().end();
+	command.coordinates[2] = text.bounds_.y().start();
+	command.coordinates[3] = text.bounds_.y().end();
+	command.payloadOffset = m_payload.size();
+	command.payloadSize = 4;
+	m_payload.push_back(textIndex);
+	m_payload.push_back(fontIndex);
+	m_payload.push_back(text.font_.size);
+	m_payload.push_back(text.index_);
+}
+
+void OverlayCommandBuffer::append(const OverlayCircle &circle)
+{
+	auto &command = add(eCircle, circle.color_);
+	command.coordinates[0] = circle.p_.x;
+	command.coordinates[1] = circle.p_.y;
+	command.coordinates[2] = circle.r_;
+}
+
+void OverlayCommandBuffer::append(const OverlayPointList &pointList)
+{
+	auto &command = add(ePointList, pointList.color_);
+	command.flags = pointList.connected_ ? eConnected : 0;
+	command.coordinates[0] = pointList.m_oPosition.x;
+	command.coordinates[1] = pointList.m_oPosition.y;
+	command.payloadOffset = m_payload.size();
+	command.payloadSize = pointList.m_yList.size();
+	m_payload.insert(m_payload.end(), pointList.m_yList.begin(), pointList.m_yList.end());
+}
+
+void OverlayCommandBuffer::appendShape(std::size_t index)
+{
+	auto &command = add(eShape, Color{});
+	command.payloadOffset = index;
+}
+
+void OverlayCommandBuffer::writeCommand(OverlayCanvas &canvas, int zOrder, const OverlayCommand &command, std::vector<int> &pointList) const
+{
+	const auto *c = command.coordinates;
+	switch (command.type)
+	{
+	case ePoint:
+		canvas.writePixel(zOrder, c[0], c[1], command.color);
+		break;
+	case eLine:
+		canvas.writeLine(zOrder, c[0], c[1], c[2], c[3], command.color);
+		break;
+	case eCross:
+		canvas.writeLine(zOrder, c[0] - c[2], c[1], c[0] + c[2], c[1], command.color);
+		canvas.writeLine(zOrder, c[0], c[1] - c[2], c[0], c[1] + c[2], command.color);
+		break;
+	case eRectangle:
+		canvas.writeRect(zOrder, toRect(command), command.color);
+		break;
+	case eText:
+	{
+		const int *text = payload(command);
+		const Font font{text[2], (command.flags & eBold) != 0, (command.flags & eItalic) != 0, m_strings[text[1]]};
+		canvas.writeText(zOrder, m_strings[text[0]], font, toRect(command), command.color, text[3]);
+		break;
+	}
+	case eCircle:
+		canvas.writeCircle(zOrder, c[0], c[1], c[2], command.color);
+		break;
+	case ePointList:
+	{
+		const int *y = payload(command);
+		pointList.assign(y, y + command.payloadSize);
+		if (command.flags & eConnected)
+		{
+			canvas.writeConnectedPixelList(zOrder, geo2d::Point{c[0], c[1]}, pointList, command.color);
+		}
+		else
+		{
+			canvas.writePixelList(zOrder, geo2d::Point{c[0], c[1]}, pointList, command.color);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void OverlayCommandBuffer::drawCommand(OverlayCanvas &canvas, const OverlayCommand &command, std::vector<int> &pointList) const
+{
+	const auto *c = command.coordinates;
+	switch (command.type)
+	{
+	case ePoint:
+		canvas.drawPixel(c[0], c[1], command.color);
+		break;
+	case eLine:
+		canvas.drawLine(c[0], c[1], c[2], c[3], command.color);
+		break;
+	case eCross:
+		canvas.drawLine(c[0] - c[2], c[1], c[0] + c[2], c[1], command.color);
+		canvas.drawLine(c[0], c[1] - c[2], c[0], c[1] + c[2], command.color);
+		break;
+	case eRectangle:
+		canvas.drawRect(toRect(command), command.color);
+		break;
+	case eText:
+	{
+		const int *text = payload(command);
+		const Font font{text[2], (command.flags & eBold) != 0, (command.flags & eItalic) != 0, m_strings[text[1]]};
+		canvas.drawText(m_strings[text[0]], font, toRect(command), command.color);
+		break;
+	}
+	case eCircle:
+		canvas.drawCircle(c[0], c[1], c[2], command.color);
+		break;
+	case ePointList:
+	{
+		const int *y = payload(command);
+		pointList.assign(y, y + command.payloadSize);
+		if (command.flags & eConnected)
+		{
+			canvas.drawConnectedPixelList(geo2d::Point{c[0], c[1]}, pointList, command.color);
+		}
+		else
+		{
+			canvas.drawPixelList(geo2d::Point{c[0], c[1]}, pointList, command.color);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void OverlayCommandBuffer::clear()
+{
+	m_commands.clear();
+	m_payload.clear();
+	m_strings.clear();
+	m_stringIndex.clear();
+}
+
+void OverlayCommandBuffer::serialize(system::message::MessageBuffer &buffer) const
+{
+	marshal(buffer, m_commands);
+	marshal(buffer, m_payload);
+	marshal(buffer, m_strings.size());
+	for (const auto &value : m_strings)
+	{
+		marshal(buffer, value);
+	}
+}
+
+void OverlayCommandBuffer::deserialize(system::message::MessageBuffer const &buffer)
+{
+	clear();
+	deMarshal(buffer, m_commands);
+	deMarshal(buffer, m_payload);
+	std::size_t numStrings = 0;
+	deMarshal(buffer, numStrings);
+	m_strings.resize(numStrings);
+	for (auto &value : m_strings)
+	{
+		deMarshal(buffer, value);
+	}
+	// rebuild the index, so that text can still be appended to a received layer
+	for (std::uint32_t i = 0; i < m_strings.size(); i++)
+	{
+		m_stringIndex.emplace(m_strings[i], i);
+	}
+}
+
+} // namespace image
+} // namespace precitec
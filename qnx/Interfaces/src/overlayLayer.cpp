@@ -15,32 +15,37 @@
 namespace precitec {
 namespace image {
 
-void OverlayLayer::add(SpOverlayShape shape) { shapes_.push_back( shape ); }
+void OverlayLayer::add(SpOverlayShape shape)
+{
+    m_commands.appendShape(shapes_.size());
+    shapes_.push_back( shape );
+}
 
 void OverlayLayer::serialize ( system::message::MessageBuffer &buffer ) const
 {
+    marshal(buffer, m_commands);
     marshal(buffer, shapes_, shapes_.size());
 }
 
 void OverlayLayer::deserialize( system::message::MessageBuffer const&buffer )
 {
+    deMarshal(buffer, m_commands);
     deMarshal(buffer, shapes_, 0);
 }
 
 void OverlayLayer::draw(OverlayCanvas& canvas)
 {
-    for(ShapeList::iterator it= shapes_.begin();it!=shapes_.end();++it)
-        (*it)->drawShape(canvas);
+    m_commands.draw(canvas, [this, &canvas] (std::size_t index) { shapes_[index]->drawShape(canvas); });
 }
 
 void OverlayLayer::write(OverlayCanvas& canvas, int zOrder)
 {
-    for (ShapeList::iterator it = shapes_.begin(); it != shapes_.end(); ++it)
-        (*it)->writeShape(canvas, zOrder);
+    m_commands.write(canvas, zOrder, [this, &canvas, zOrder] (std::size_t index) { shapes_[index]->writeShape(canvas, zOrder); });
 }
 
 void OverlayLayer::clearShapeList() {
     shapes_.clear();
+    m_commands.clear();
 }
 
 ShapeList OverlayLayer::info() const
@@ -57,7 +62,7 @@ ShapeList OverlayLayer::info() const
 
 bool OverlayLayer::hasShapes() const
 {
-    return !shapes_.empty();
+    return !m_commands.empty();
 }
 
 } // namespace image
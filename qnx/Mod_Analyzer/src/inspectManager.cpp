@@ -1209,6 +1209,12 @@ bool InspectManager::reloadCalibData(int p_oSensorID, math::Calibration3DCoords
         return false;
     }
 
+    if (p_o3DCoords.coordinatesMissing())
+    {
+        wmLog(eWarning, "3DCoords for sensor %d could not be read, calibration not reloaded\n", p_oSensorID);
+        return false;
+    }
+
     bool ok = rCalibData.reload(p_o3DCoords, p_oCalibrationParameters);
 
     std::ostringstream oMsg;
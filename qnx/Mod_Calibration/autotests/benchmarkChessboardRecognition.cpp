@@ -0,0 +1,67 @@
+#include <QTest>
+
+#include "../include/calibration/chessboardRecognition.h"
+#include "syntheticChessboard.h"
+#include <common/bitmap.h>
+
+using precitec::calibration_algorithm::ChessboardRecognitionAlgorithm;
+using precitec::image::BImage;
+using precitec::image::Size2d;
+
+class BenchmarkChessboardRecognition : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkSyntheticChessboard_data();
+    void benchmarkSyntheticChessboard();
+    void benchmarkReferenceChessboard();
+};
+
+void BenchmarkChessboardRecognition::benchmarkSyntheticChessboard_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("threshold");
+
+    QTest::newRow("640x480, automatic threshold") << 640 << 480 << -1;
+    QTest::newRow("1280x1024, automatic threshold") << 1280 << 1024 << -1;
+    QTest::newRow("1280x1024, threshold 120") << 1280 << 1024 << 120;
+}
+
+void BenchmarkChessboardRecognition::benchmarkSyntheticChessboard()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, threshold);
+
+    const auto image = SyntheticChessboard::create(Size2d{width, height});
+
+    QBENCHMARK
+    {
+        ChessboardRecognitionAlgorithm recognition(image, threshold);
+        QVERIFY(!recognition.getRecognizedCorners().empty());
+    }
+}
+
+void BenchmarkChessboardRecognition::benchmarkReferenceChessboard()
+{
+    const std::string filename = QFINDTESTDATA("/opt/wm_inst/data/scanfieldimage/second_test/20200213_152030/row_0_col_0.bmp").toStdString();
+    if (filename.empty())
+    {
+        QSKIP("System does not have test data");
+    }
+    fileio::Bitmap bitmap(filename);
+    QVERIFY(bitmap.validSize());
+    BImage chessboard{Size2d{bitmap.width(), bitmap.height()}};
+    std::vector<unsigned char> additionalData;
+    QVERIFY(bitmap.load(chessboard.begin(), additionalData));
+
+    QBENCHMARK
+    {
+        ChessboardRecognitionAlgorithm recognition(chessboard, -1);
+        QVERIFY(recognition.isValid());
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkChessboardRecognition)
+#include "benchmarkChessboardRecognition.moc"
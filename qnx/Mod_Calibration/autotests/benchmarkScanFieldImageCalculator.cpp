@@ -0,0 +1,88 @@
+#include <QTest>
+
+#include "../include/calibration/ScanFieldImageCalculator.h"
+#include "util/ScanFieldImageParameters.h"
+#include "common/bitmap.h"
+
+#include <random>
+#include <sys/resource.h>
+
+using precitec::image::BImage;
+using precitec::image::Size2d;
+using precitec::calibration::ScanMasterCalibrationData;
+using precitec::calibration::ScanFieldImageCalculator;
+using precitec::calibration::ScanFieldImageParameters;
+
+class BenchmarkScanFieldImageCalculator : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkSyntheticCaptures_data();
+    void benchmarkSyntheticCaptures();
+};
+
+void BenchmarkScanFieldImageCalculator::benchmarkSyntheticCaptures_data()
+{
+    QTest::addColumn<int>("numRows");
+    QTest::addColumn<int>("numColumns");
+    QTest::addColumn<double>("delta");
+
+    // captures of 1024 x 1024 pixel, 27 pixel per mm
+    QTest::newRow("5 x 5, delta 20") << 5 << 5 << 20.0;
+    QTest::newRow("11 x 11, delta 10") << 11 << 11 << 10.0;
+    QTest::newRow("21 x 21, delta 5") << 21 << 21 << 5.0;
+}
+
+void BenchmarkScanFieldImageCalculator::benchmarkSyntheticCaptures()
+{
+    QFETCH(int, numRows);
+    QFETCH(int, numColumns);
+    QFETCH(double, delta);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const Size2d imageSize{1024, 1024};
+    const double xMax = (numColumns - 1) * delta / 2;
+    const double yMax = (numRows - 1) * delta / 2;
+    const auto parameters = ScanFieldImageParameters::computeParameters(ScanMasterCalibrationData{-27.0, 27.0, 0.0},
+        imageSize.width, imageSize.height, -xMax, xMax, -yMax, yMax);
+
+    std::mt19937 generator{3};
+    BImage image{imageSize};
+    std::vector<ScanFieldImageCalculator::ImageFile> imageFiles;
+    for (int row = 0; row < numRows; row++)
+    {
+        for (int column = 0; column < numColumns; column++)
+        {
+            for (auto & pixel : image)
+            {
+                pixel = generator() % 256;
+            }
+            const std::string filename = dir.path().toStdString() + "/row_" + std::to_string(row) + "_col_" + std::to_string(column) + ".bmp";
+            fileio::Bitmap bitmap(filename, image.width(), image.height(), false);
+            QVERIFY(bitmap.isValid() && bitmap.save(image.data()));
+            imageFiles.push_back({filename, -xMax + column * delta, -yMax + row * delta});
+        }
+    }
+
+    std::size_t accumulatorBytes = 0;
+    QBENCHMARK
+    {
+        ScanFieldImageCalculator calculator(parameters);
+        QCOMPARE(calculator.pasteImageFiles(imageFiles), imageFiles.size());
+        accumulatorBytes = calculator.accumulatorBytes();
+        const auto scanFieldImage = std::get<0>(calculator.computeAndWriteScanFieldImage(""));
+        QCOMPARE(scanFieldImage.size(), parameters.m_scanfieldimageSize);
+    }
+
+    // the full field buffers of the initial implementation needed 8 byte per pixel
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    qInfo("%zu images, scan field %d x %d, accumulator %zu MB (full field %zu MB), peak resident memory %ld MB",
+        imageFiles.size(), parameters.m_scanfieldimageSize.width, parameters.m_scanfieldimageSize.height,
+        accumulatorBytes >> 20, (std::size_t(8) * parameters.m_scanfieldimageSize.area()) >> 20, usage.ru_maxrss >> 10);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkScanFieldImageCalculator)
+#include "benchmarkScanFieldImageCalculator.moc"
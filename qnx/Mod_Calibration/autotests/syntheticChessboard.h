@@ -0,0 +1,33 @@
+#pragma once
+
+#include <image/image.h>
+
+#include <random>
+
+/**
+* Chessboard images for the recognition test and benchmark: squares of 54 pixels like the reference images, with noise.
+*/
+namespace SyntheticChessboard
+{
+
+const int squareSize = 54;
+// the first inner corner is at (squareSize - offsetX, squareSize - offsetY)
+const int offsetX = 20;
+const int offsetY = 30;
+
+inline precitec::image::BImage create(precitec::image::Size2d size)
+{
+    std::mt19937 generator{1};
+    precitec::image::BImage image{size};
+    for (int y = 0; y < size.height; y++)
+    {
+        for (int x = 0; x < size.width; x++)
+        {
+            const bool white = ((x + offsetX) / squareSize + (y + offsetY) / squareSize) % 2 == 1;
+            image[y][x] = (white ? 200 : 40) + int(generator() % 21) - 10;
+        }
+    }
+    return image;
+}
+
+}
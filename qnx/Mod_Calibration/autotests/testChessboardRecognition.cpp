@@ -1,8 +1,11 @@
 #include <QTest>
 
 #include "../include/calibration/chessboardRecognition.h"
+#include "syntheticChessboard.h"
 #include <common/bitmap.h>
 
+#include <thread>
+
 class TestChessboardRecognition: public QObject
 {    
     Q_OBJECT
@@ -10,9 +13,10 @@ private Q_SLOTS:
     void testCtor();
     void testChessboard_data();
     void testChessboard();
+    void testSyntheticChessboard();
+    void testConcurrentRecognitions();
 };
 
-
 void TestChessboardRecognition::testCtor()
 {
     precitec::calibration_algorithm::ChessboardRecognitionAlgorithm testRecognition( precitec::image::BImage{}, -1);
@@ -67,5 +71,56 @@ void TestChessboardRecognition::testChessboard()
     QCOMPARE(std::floor(rCornerGrid.factor_real_to_pix()) , 54.0);
 }
 
+void TestChessboardRecognition::testSyntheticChessboard()
+{
+    using precitec::calibration_algorithm::ChessboardRecognitionAlgorithm;
+    using namespace SyntheticChessboard;
+
+    const auto image = create({640, 480});
+
+    ChessboardRecognitionAlgorithm automaticThreshold(image, -1);
+    const auto & corners = automaticThreshold.getRecognizedCorners();
+    // 11 x 9 inner corners
+    QVERIFY(corners.size() >= 90);
+    for (const auto & corner : corners)
+    {
+        QVERIFY(std::abs(std::remainder(corner.x + offsetX, squareSize)) <= 3.0);
+        QVERIFY(std::abs(std::remainder(corner.y + offsetY, squareSize)) <= 3.0);
+    }
+
+    QVERIFY(automaticThreshold.isValid());
+    // the candidates are evaluated concurrently, the selected one must give the same result as on its own
+    ChessboardRecognitionAlgorithm providedThreshold(image, automaticThreshold.getThreshold());
+    QVERIFY(providedThreshold.isValid());
+    QVERIFY(providedThreshold.getRecognizedCorners() == corners);
+}
+
+void TestChessboardRecognition::testConcurrentRecognitions()
+{
+    using precitec::calibration_algorithm::ChessboardRecognitionAlgorithm;
+
+    // the recognitions share the threads of the pool, a recognition without free threads runs its tasks on its own
+    const auto image = SyntheticChessboard::create({640, 480});
+    ChessboardRecognitionAlgorithm reference(image, -1);
+    QVERIFY(reference.isValid());
+
+    std::array<bool, 2> sameResult{false, false};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < sameResult.size(); i++)
+    {
+        threads.emplace_back([&image, &reference, &sameResult, i] ()
+            {
+                ChessboardRecognitionAlgorithm recognition(image, -1);
+                sameResult[i] = recognition.isValid() && recognition.getRecognizedCorners() == reference.getRecognizedCorners();
+            });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    QVERIFY(sameResult[0]);
+    QVERIFY(sameResult[1]);
+}
+
 QTEST_MAIN(TestChessboardRecognition)
 #include "testChessboardRecognition.moc"
@@ -9,6 +9,8 @@
 #include <Poco/Util/XMLConfiguration.h>
 #include <mathCommon.h>
 
+#include <random>
+
 typedef std::vector<std::tuple<std::string,double,double>>  TImageWithScannerPositionList;
 Q_DECLARE_METATYPE(TImageWithScannerPositionList)
 
@@ -52,6 +54,9 @@ private Q_SLOTS:
     void testMakeConfiguration();
     void testGetKeyValue();
     void testLoadConfiguration();
+    void testTiledAccumulation_data();
+    void testTiledAccumulation();
+    void testPasteImageFiles();
 };
 
 using precitec::image::BImage;
@@ -463,5 +468,118 @@ void TestScanFieldImageCalculator::testLoadConfiguration()
 
 
 
+void TestScanFieldImageCalculator::testTiledAccumulation_data()
+{
+    QTest::addColumn<int>("fieldWidth");
+    QTest::addColumn<int>("fieldHeight");
+    QTest::addColumn<int>("imageSize");
+    QTest::addColumn<int>("numImages");
+    QTest::addColumn<int>("spread");
+    
+    QTest::addRow("tile borders") << 300 << 290 << 70 << 40 << 221;
+    QTest::addRow("single image") << 127 << 255 << 127 << 1 << 0;
+    // more than 257 images per tile, the 16 bit sums are widened
+    QTest::addRow("overlap 400") << 200 << 200 << 40 << 400 << 100;
+    // more than 65535 images per pixel, the 16 bit counters are widened
+    QTest::addRow("overlap 70000") << 20 << 20 << 4 << 70000 << 4;
+}
+
+void TestScanFieldImageCalculator::testTiledAccumulation()
+{
+    QFETCH(int, fieldWidth);
+    QFETCH(int, fieldHeight);
+    QFETCH(int, imageSize);
+    QFETCH(int, numImages);
+    QFETCH(int, spread);
+    
+    ScanFieldImageParameters oParameters;
+    oParameters.m_scanfieldimageSize = {fieldWidth, fieldHeight};
+    ScanFieldImageCalculator oScanFieldImageCalculator(oParameters);
+    QCOMPARE(oScanFieldImageCalculator.accumulatorBytes(), std::size_t(0));
+    
+    // reference: average of the full field sums like the initial implementation
+    std::vector<unsigned int> oCount(fieldWidth * fieldHeight, 0);
+    std::vector<int> oSum(fieldWidth * fieldHeight, 0);
+    
+    std::mt19937 oGenerator{5};
+    BImage oImage{precitec::image::Size2d{imageSize, imageSize}};
+    for (int i = 0; i < numImages; i++)
+    {
+        for (auto & rPixel : oImage)
+        {
+            // saturated images check the overflow of the sums
+            rPixel = numImages > 1000 ? 255 : oGenerator() % 256;
+        }
+        const int x = spread > 0 ? oGenerator() % spread : 0;
+        const int y = spread > 0 ? oGenerator() % spread : 0;
+        QVERIFY(oScanFieldImageCalculator.pasteImage(oImage, x, y));
+        for (int row = 0; row < imageSize; row++)
+        {
+            for (int column = 0; column < imageSize; column++)
+            {
+                oCount[(y + row) * fieldWidth + x + column]++;
+                oSum[(y + row) * fieldWidth + x + column] += oImage[row][column];
+            }
+        }
+    }
+    QVERIFY(!oScanFieldImageCalculator.pasteImage(oImage, fieldWidth - imageSize + 1, 0));
+    QVERIFY(!oScanFieldImageCalculator.pasteImage(oImage, 0, -1));
+    
+    auto oFinalScanFieldImage = std::get<0>(oScanFieldImageCalculator.computeAndWriteScanFieldImage(""));
+    QCOMPARE(oFinalScanFieldImage.size(), oParameters.m_scanfieldimageSize);
+    for (int y = 0; y < fieldHeight; y++)
+    {
+        for (int x = 0; x < fieldWidth; x++)
+        {
+            const auto oIndex = y * fieldWidth + x;
+            const byte oExpected = oCount[oIndex] > 1 ? std::round(oSum[oIndex] / double(oCount[oIndex])) : oSum[oIndex];
+            QCOMPARE(oFinalScanFieldImage[y][x], oExpected);
+        }
+    }
+    // only the tiles touched by an image are allocated
+    QVERIFY(oScanFieldImageCalculator.accumulatorBytes() > 0);
+    QVERIFY(oScanFieldImageCalculator.accumulatorBytes() <= std::size_t(8) * 128 * 128 * ((fieldWidth + 127) / 128) * ((fieldHeight + 127) / 128));
+}
+
+void TestScanFieldImageCalculator::testPasteImageFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    
+    ScanMasterCalibrationData oScanMasterCalibrationData {-27.0, 27.0, 0.0};
+    const auto oParameters = ScanFieldImageParameters::computeParameters(oScanMasterCalibrationData, 200, 150, -20.0, 20.0, -20.0, 20.0);
+    ScanFieldImageCalculator oSequentialCalculator(oParameters);
+    ScanFieldImageCalculator oParallelCalculator(oParameters);
+    
+    std::mt19937 oGenerator{7};
+    std::vector<ScanFieldImageCalculator::ImageFile> oImageFiles;
+    for (double y = -20.0; y <= 20.0; y += 5.0)
+    {
+        for (double x = -20.0; x <= 20.0; x += 5.0)
+        {
+            BImage oImage{precitec::image::Size2d{200, 150}};
+            for (auto & rPixel : oImage)
+            {
+                rPixel = oGenerator() % 256;
+            }
+            const std::string oFilename = QDir{dir.path()}.absolutePath().toStdString() + "/row_" + std::to_string(oImageFiles.size()) + ".bmp";
+            fileio::Bitmap oBitmap(oFilename, oImage.width(), oImage.height(), false);
+            QVERIFY(oBitmap.isValid() && oBitmap.save(oImage.data()));
+            oImageFiles.push_back({oFilename, x, y});
+            
+            auto oPositionInScanfieldImage = oParameters.getTopLeftCornerInScanFieldImageBeforeMirroring(oImage.size(), x, y);
+            QVERIFY(oSequentialCalculator.pasteImage(oImage, oPositionInScanfieldImage.x, oPositionInScanfieldImage.y));
+        }
+    }
+    // a missing image is skipped
+    oImageFiles.push_back({QDir{dir.path()}.absolutePath().toStdString() + "/missing.bmp", 0.0, 0.0});
+    
+    QCOMPARE(oParallelCalculator.pasteImageFiles(oImageFiles), oImageFiles.size() - 1);
+    const auto oParallelImage = std::get<0>(oParallelCalculator.computeAndWriteScanFieldImage(""));
+    const auto oSequentialImage = std::get<0>(oSequentialCalculator.computeAndWriteScanFieldImage(""));
+    QCOMPARE(oParallelImage.size(), oSequentialImage.size());
+    QVERIFY(std::equal(oParallelImage.begin(), oParallelImage.end(), oSequentialImage.begin()));
+}
+
 QTEST_GUILESS_MAIN(TestScanFieldImageCalculator)
 #include "testScanFieldImageCalculator.moc"
@@ -5,6 +5,12 @@
 #include "module/moduleLogger.h"
 #include "util/ScanFieldImageParameters.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <variant>
+
 
 namespace precitec{
 namespace calibration{    
@@ -14,17 +20,55 @@ class ScanFieldImageCalculator
 {
     public:
         
+        /// captured sub-image on disk and the scanner position where it was acquired
+        struct ImageFile
+        {
+            std::string m_filename;
+            double m_xScanner_mm;
+            double m_yScanner_mm;
+        };
+
         ScanFieldImageCalculator (ScanFieldImageParameters p_parameters);
         
         std::tuple<image::BImage,std::string, std::string> computeAndWriteScanFieldImage(const std::string outputFilename) const;
         
+        //thread safe, images can be pasted concurrently
         bool pasteImage(const precitec::image::BImage & rImage, int xTopLeft_pix, int yTopLeft_pix);
+        //loads and pastes the bitmaps in parallel, returns the number of pasted images
+        std::size_t pasteImageFiles(const std::vector<ImageFile> & rImageFiles);
         const ScanFieldImageParameters & getParameters() const;
+        //memory allocated for the sums and counters of the pasted pixels
+        std::size_t accumulatorBytes() const;
         
     private:
         
-        std::vector<unsigned int> m_Mask;
-        std::vector<int> m_Sum;
+        //sum and counter of the pixels of a tile, both can't overflow until s_maxImages images have been pasted on the tile
+        template <typename TCount, typename TSum>
+        struct Accumulator
+        {
+            static constexpr unsigned int s_maxImages = std::min<unsigned int>(std::numeric_limits<TCount>::max(), std::numeric_limits<TSum>::max() / 255);
+            std::vector<TCount> m_count;
+            std::vector<TSum> m_sum;
+        };
+        //the accumulator is widened when the overlap requires it: 16 bit sums up to 257 images, 16 bit counters up to 65535 images
+        typedef std::variant<Accumulator<std::uint16_t, std::uint16_t>, Accumulator<std::uint16_t, std::uint32_t>, Accumulator<std::uint32_t, std::uint32_t>> TileAccumulator;
+
+        struct Tile
+        {
+            std::mutex m_mutex;
+            unsigned int m_numImages = 0; //upper bound of the counter of each pixel, the accumulator is allocated by the first image
+            TileAccumulator m_accumulator;
+        };
+
+        static constexpr int s_tileSize = 128;
+        //the images are loaded while the system is running, don't occupy all cores
+        static constexpr std::size_t s_maxWorkers = 4;
+
+        static void reserveImage(Tile & rTile);
+
+        int m_numTileColumns;
+        int m_numTileRows;
+        std::vector<Tile> m_tiles;
         ScanFieldImageParameters m_parameters;
 };
 
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <image/image.h>
+#include <algorithm>
 #include <numeric>
 #include <array>
 
@@ -210,8 +211,39 @@ struct FilteringAlgorithms
      *
      */
     
+    /// Non zero entry of a filter kernel at the offset (m_x, m_y) from the upper left corner of the kernel window
+    struct Tap
+    {
+        int m_x;
+        int m_y;
+        double m_value;
+    };
+
+    /**
+     * Non zero entries of the filter in the order in which they are applied to every pixel, i.e. row by row through the transposed kernel.
+     * Skipping the zero entries does not change any sum, adding a zero product is exact.
+     */
+    static std::vector<Tap> nonZeroTaps(const array2D &p_rFilter)
+    {
+        std::vector<Tap> oTaps;
+        auto itFilter = p_rFilter.transposedBegin();
+        for (int y = 0; y < p_rFilter.size(); ++y)
+        {
+            for (int x = 0; x < p_rFilter.size(); ++x, ++itFilter)
+            {
+                if (*itFilter != 0.0)
+                {
+                    oTaps.push_back({x, y, *itFilter});
+                }
+            }
+        }
+        return oTaps;
+    }
+
     // for an 11x11 kernel, the filtersizes are 5, 5
     // Convolute image with filter
+    // The sums of a row are accumulated tap by tap over all pixels of the row, a contiguous loop which the compiler vectorizes.
+    // Every pixel still adds the products in the same order, so the result does not depend on the vectorization.
     template <class CallbackOnLine>
     static precitec::image::BImage convolution(const precitec::image::BImage &p_rSource, const array2D &p_rFilter, CallbackOnLine p_callbackOnLine)
     {
@@ -222,35 +254,35 @@ struct FilteringAlgorithms
         
         precitec::image::BImage oRetImg(p_rSource.size());
         
-        double oNorm = p_rFilter.getNorm(); 
-        if ( std::abs(oNorm) < 0.00001 ) oNorm = 1;
         const int oKernelSize = p_rFilter.kernelSize();
-    
+        const auto oTaps = nonZeroTaps(p_rFilter);
+        const int oNumColumns = std::max(p_rSource.width() - 2 * oKernelSize, 0);
+        std::vector<double> oSums(oNumColumns);
+
         for (int y=oKernelSize, end_y =  p_rSource.height()-oKernelSize; y < end_y; ++y)
         {
-            unsigned char * oLine = oRetImg.rowBegin(y);
-            for (int x=oKernelSize, end_x =  p_rSource.width()-oKernelSize; x < end_x; ++x)
+            std::fill(oSums.begin(), oSums.end(), 0.0);
+            double * pSums = oSums.data();
+            for (const auto & rTap : oTaps)
             {
-                
-                auto itFilter = p_rFilter.transposedBegin();
-
-                double oVal = 0;
-
-                auto fMultiplyFilter = [&itFilter, & oVal] (const byte & pixelSource)
+                const byte * pSource = p_rSource.rowBegin(y - oKernelSize + rTap.m_y) + rTap.m_x;
+                const double oValue = rTap.m_value;
+                for (int i = 0; i < oNumColumns; ++i)
                 {
-                    oVal += (double(pixelSource) * (*itFilter)) ;
-                    itFilter ++;
-                };
-
-                p_rSource.for_each(fMultiplyFilter, x- oKernelSize, y - oKernelSize, 2*oKernelSize + 1, 2*oKernelSize + 1); 
+                    pSums[i] += double(pSource[i]) * oValue;
+                }
+            }
 
-                
+            unsigned char * oLine = oRetImg.rowBegin(y) + oKernelSize;
+            for (int i = 0; i < oNumColumns; ++i)
+            {
+                const double oVal = pSums[i];
                 if (oVal <= 0)
                 {
-                    oLine[x] = 0;
+                    oLine[i] = 0;
                 } else
                 {
-                    oLine[x] = (oVal < 255 ? oVal : 255);
+                    oLine[i] = (oVal < 255 ? oVal : 255);
                 }
             }
             p_callbackOnLine (y);
@@ -264,6 +296,8 @@ struct FilteringAlgorithms
         return convolution(p_rSource, p_rFilter, [](int){});
     }
 
+    // Binary morphology: a pixel is set if the weighted sum of its neighborhood exceeds (mask size - 1) * 255.
+    // Accumulated tap by tap over the row like the convolution.
     template <class CallbackOnLine>
     static precitec::image::BImage morphBW(const precitec::image::BImage &p_rSource, const array2D &p_rFilter, CallbackOnLine p_callbackOnLine)
     {
@@ -275,36 +309,31 @@ struct FilteringAlgorithms
         
         BImage oRetImg(p_rSource.size());
 
-        double oNorm = p_rFilter.getNorm(); 
-        if ( std::abs(oNorm) < 0.00001 ) oNorm = 1;
         const int oKernelSize = p_rFilter.kernelSize();
+        const auto oTaps = nonZeroTaps(p_rFilter);
+        const int oNumColumns = std::max(p_rSource.width() - 2 * oKernelSize, 0);
+        const double oLimit = (p_rFilter.size() - 1) * 255;
+        std::vector<int> oSums(oNumColumns);
 
         for (int y=oKernelSize, end_y =  p_rSource.height()-oKernelSize; y < end_y; ++y)
         {
-            unsigned char * oLine = oRetImg.rowBegin(y);
-            for (int x=oKernelSize, end_x =  p_rSource.width()-oKernelSize; x < end_x; ++x)
+            std::fill(oSums.begin(), oSums.end(), 0);
+            int * pSums = oSums.data();
+            for (const auto & rTap : oTaps)
             {
-                                        
-                int oVal = 0; 
-                oNorm = 1; 
-                
-                auto itFilter = p_rFilter.transposedBegin();
-
-                auto fMultiplyFilter = [&itFilter, & oVal] (const byte & pixelSource)
-                    {
-                        oVal += (int)  (pixelSource* (*itFilter) );
-                        itFilter ++;
-                    };
-                p_rSource.for_each(fMultiplyFilter, x - oKernelSize, y - oKernelSize, 2*oKernelSize+1, 2* oKernelSize+1); 
-                
-                if (oVal <= ( (p_rFilter.size()-oNorm)*255))
-                {
-                    oLine[x] = (unsigned char)0;
-                } else
+                const byte * pSource = p_rSource.rowBegin(y - oKernelSize + rTap.m_y) + rTap.m_x;
+                const double oValue = rTap.m_value;
+                for (int i = 0; i < oNumColumns; ++i)
                 {
-                    oLine[x] = (unsigned char)255;
+                    pSums[i] += (int) (pSource[i] * oValue);
                 }
             }
+
+            unsigned char * oLine = oRetImg.rowBegin(y) + oKernelSize;
+            for (int i = 0; i < oNumColumns; ++i)
+            {
+                oLine[i] = pSums[i] <= oLimit ? (unsigned char)0 : (unsigned char)255;
+            }
             p_callbackOnLine (y);
         }
         return oRetImg;
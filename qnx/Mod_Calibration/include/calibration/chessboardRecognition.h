@@ -4,8 +4,10 @@
  * To be included in weldmaster and wmcalibration 
  */
 
+#include <array>
 #include <numeric>
 #include <list>
+#include <vector>
 
 //TODO rename namespace
 #include "calibrationCornerGrid.h"
@@ -14,6 +16,11 @@
 #include <image/image.h>
 #include "chessboardFilteringAlgorithms.h"
 
+namespace Poco
+{
+class ThreadPool;
+}
+
 namespace precitec {
 namespace calibration_algorithm {
 
@@ -88,9 +95,35 @@ private:
     static precitec::image::BImage preprocessImage(const precitec::image::BImage & rImgSource);
     static precitec::image::BImage computeBinaryImage(const precitec::image::BImage & rImgSource , int oThreshold,
                                    PreviewType previewType = PreviewType::CompleteProcessing, image::BImage * p_previewImage = nullptr );
-    static std::vector<precitec::geo2d::DPoint> thresholdCornerPoints(const precitec::image::BImage & rBinarizedImage, byte oThreshold = 200,
+    static std::vector<precitec::geo2d::DPoint> thresholdCornerPoints(const precitec::image::BImage & rBinarizedImage,
+                                   FilteringAlgorithms::CornerDetectionType filterType, byte oThreshold = 200,
                                    PreviewType previewType = PreviewType::CompleteProcessing, image::BImage * p_previewImage = nullptr);
     static std::pair<bool, precitec::math::CalibrationCornerGrid> generateGridMap(const point_list_t & rRawCorners, const int p_oMinSquareSize,  geo2d::Size p_oValidArea);
+
+    /// Intermediate results of one threshold candidate
+    struct CandidateEvaluation
+    {
+        CandidateEvaluation(int threshold, geo2d::Size validArea);
+
+        int m_threshold;
+        image::BImage m_binarizedImage;
+        image::BImage m_previewImage;
+        int m_pixelSum = 0;
+        bool m_lowContrast = false;
+        std::array<std::vector<precitec::geo2d::DPoint>, 2> m_cornerPoints;     ///< points of the black to white and white to black corner filter
+        point_list_t m_recognizedCorners;
+        bool m_validGridMap = false;
+        precitec::math::CalibrationCornerGrid m_cornerGrid;
+    };
+
+    /// The recognition runs while the operator waits at the machine, but it must not occupy all cores of the running system
+    static constexpr std::size_t s_maxWorkers = 4;
+    static std::size_t numWorkers();
+    /// Threads which help the calling thread, started with the first recognition and kept for the next images
+    static Poco::ThreadPool & threadPool();
+    /// Calls task(i) for all i in [0, numTasks) on up to numWorkers threads, including the calling one
+    template <typename TTask>
+    static void parallelFor(std::size_t numTasks, std::size_t numWorkers, TTask task);
     
     int m_threshold;
     bool m_validGridMap;
@@ -1,23 +1,90 @@
 #include <calibration/ScanFieldImageCalculator.h>
 #include <common/bitmap.h>
+#include <config-weldmaster.h>
+#include <atomic>
 #include <filesystem>
+#include <thread>
+#if HAVE_SSE4
+#include <emmintrin.h>
+#endif
 
 using precitec::image::ImageFillMode;
 
 namespace precitec{
 namespace calibration{    
 
+namespace
+{
+
+//same as std::round(sum / double(count)) for count > 1, the pixel itself for count 1 and 0 for a pixel without image
+template <typename TCount, typename TSum>
+byte averagePixel(TCount count, TSum sum)
+{
+    return (2 * std::uint64_t(sum) + count) / std::max<std::uint64_t>(2 * std::uint64_t(count), 1);
+}
+
+template <typename TCount, typename TSum>
+void averageRow(const TCount * pCount, const TSum * pSum, byte * pOutput, int width)
+{
+    for (int x = 0; x < width; x++)
+    {
+        pOutput[x] = averagePixel(pCount[x], pSum[x]);
+    }
+}
+
+#if HAVE_SSE4
+//the 16 bit sums hold at most 257 images, numerator and denominator are exact in float and the quotient
+//is at least 1/514 away from the next integer, the truncated float division gives the same pixel as the integer division
+void averageRow(const std::uint16_t * pCount, const std::uint16_t * pSum, byte * pOutput, int width)
+{
+    const __m128i oZero = _mm_setzero_si128();
+    const __m128 oOne = _mm_set1_ps(1.0f);
+    auto fAverage = [oZero, oOne] (__m128i p_oCount, __m128i p_oSum)
+    {
+        const __m128i oNumerator = _mm_add_epi32(_mm_add_epi32(p_oSum, p_oSum), p_oCount);
+        const __m128 oDenominator = _mm_max_ps(_mm_cvtepi32_ps(_mm_add_epi32(p_oCount, p_oCount)), oOne);
+        return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(oNumerator), oDenominator));
+    };
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i oCount = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCount + x));
+        const __m128i oSum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSum + x));
+        const __m128i oLow = fAverage(_mm_unpacklo_epi16(oCount, oZero), _mm_unpacklo_epi16(oSum, oZero));
+        const __m128i oHigh = fAverage(_mm_unpackhi_epi16(oCount, oZero), _mm_unpackhi_epi16(oSum, oZero));
+        const __m128i oPixels = _mm_packs_epi32(oLow, oHigh);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pOutput + x), _mm_packus_epi16(oPixels, oPixels));
+    }
+    for (; x < width; x++)
+    {
+        pOutput[x] = averagePixel(pCount[x], pSum[x]);
+    }
+}
+#endif
+
+template <typename TWide, typename TNarrow>
+TWide widen(const TNarrow & rNarrow)
+{
+    TWide oWide;
+    oWide.m_count.assign(rNarrow.m_count.begin(), rNarrow.m_count.end());
+    oWide.m_sum.assign(rNarrow.m_sum.begin(), rNarrow.m_sum.end());
+    return oWide;
+}
+
+}
+
 
 ScanFieldImageCalculator::ScanFieldImageCalculator(ScanFieldImageParameters p_parameters)
-  : m_parameters(std::move(p_parameters))
+  : m_numTileColumns((p_parameters.m_scanfieldimageSize.width + s_tileSize - 1) / s_tileSize)
+  , m_numTileRows((p_parameters.m_scanfieldimageSize.height + s_tileSize - 1) / s_tileSize)
+  , m_tiles(std::size_t(m_numTileColumns) * m_numTileRows)
+  , m_parameters(std::move(p_parameters))
 {   
 #ifndef NDEBUG
     std::ostringstream oMsg;
     oMsg <<  "ScanFieldImageCalculator CTOR " << p_parameters << "\n";
     wmLog(eDebug,  oMsg.str());
 #endif
-    m_Mask.assign(m_parameters.m_scanfieldimageSize.area(),0);
-    m_Sum.assign(m_parameters.m_scanfieldimageSize.area(),0);
 }
 
 
@@ -30,25 +97,34 @@ std::tuple<image::BImage,std::string, std::string> ScanFieldImageCalculator::com
     std::string imageFilename = "";
     std::string configurationFilename = "";
     
-    auto itCount = m_Mask.cbegin();
-    auto fComputePixelValue = [&itCount] (const int & pixelSum)
+    assert(oOutput.isValid() && oOutput.isContiguos());
+    for (int tileRow = 0; tileRow < m_numTileRows; tileRow++)
     {
-        assert((*itCount) > 0 || pixelSum == 0);
-        byte pixel = pixelSum;
-        if ((*itCount)>1)
+        const int firstY = tileRow * s_tileSize;
+        const int lastY = std::min(firstY + s_tileSize, oOutput.height());
+        for (int tileColumn = 0; tileColumn < m_numTileColumns; tileColumn++)
         {
-            pixel = std::round(pixelSum/double(*itCount));
-            
-        }   
-        assert(pixel >= 0 && pixel <= 255);                                        
-        itCount++;
-        return pixel;
-    };
-    
-    assert(oOutput.isValid() && oOutput.isContiguos());
-    std::transform(m_Sum.cbegin(),m_Sum.cend(), oOutput.begin(), fComputePixelValue);
-    
-    assert(itCount == m_Mask.cend());
+            const int firstX = tileColumn * s_tileSize;
+            const int width = std::min(firstX + s_tileSize, oOutput.width()) - firstX;
+            const auto & rTile = m_tiles[tileRow * m_numTileColumns + tileColumn];
+            if (rTile.m_numImages == 0)
+            {
+                for (int y = firstY; y < lastY; y++)
+                {
+                    std::fill_n(oOutput.rowBegin(y) + firstX, width, 0);
+                }
+                continue;
+            }
+            std::visit([&] (const auto & rAccumulator)
+                {
+                    for (int y = firstY; y < lastY; y++)
+                    {
+                        const auto offset = (y - firstY) * s_tileSize;
+                        averageRow(rAccumulator.m_count.data() + offset, rAccumulator.m_sum.data() + offset, oOutput.rowBegin(y) + firstX, width);
+                    }
+                }, rTile.m_accumulator);
+        }
+    }
     
     switch(m_parameters.m_ScanMasterData.getImageFillMode())
     {
@@ -114,27 +190,136 @@ bool ScanFieldImageCalculator::pasteImage(const precitec::image::BImage & rImage
     {
         return false;
     }
+    if (rImage.width() <= 0 || rImage.height() <= 0)
+    {
+        return true;
+    }
     
-    
-    for (int sourceY = 0, lastSourceY = rImage.height(), destinationY = yTopLeft_pix; sourceY< lastSourceY; sourceY++, destinationY++)
+    const int xEnd = xTopLeft_pix + rImage.width();
+    const int yEnd = yTopLeft_pix + rImage.height();
+    for (int tileRow = yTopLeft_pix / s_tileSize; tileRow * s_tileSize < yEnd; tileRow++)
     {
-        auto * pPixel = rImage.rowBegin(sourceY);
-        auto * pRowEnd = rImage.rowEnd(sourceY);
-        
-        auto index = destinationY * m_parameters.m_scanfieldimageSize.width + xTopLeft_pix;
-        auto itMask = m_Mask.begin() + index;
-        auto itSum = m_Sum.begin() + index;
-        for (; pPixel != pRowEnd; ++pPixel, ++itMask, ++itSum)
+        const int tileY = tileRow * s_tileSize;
+        const int firstY = std::max(yTopLeft_pix, tileY);
+        const int lastY = std::min(yEnd, tileY + s_tileSize);
+        for (int tileColumn = xTopLeft_pix / s_tileSize; tileColumn * s_tileSize < xEnd; tileColumn++)
         {
-            (*itSum) += (*pPixel);
-            (*itMask)++;
+            const int tileX = tileColumn * s_tileSize;
+            const int firstX = std::max(xTopLeft_pix, tileX);
+            const int width = std::min(xEnd, tileX + s_tileSize) - firstX;
+            
+            auto & rTile = m_tiles[tileRow * m_numTileColumns + tileColumn];
+            std::lock_guard<std::mutex> lock{rTile.m_mutex};
+            reserveImage(rTile);
+            std::visit([&] (auto & rAccumulator)
+                {
+                    for (int y = firstY; y < lastY; y++)
+                    {
+                        const byte * pPixel = rImage.rowBegin(y - yTopLeft_pix) + (firstX - xTopLeft_pix);
+                        const auto offset = (y - tileY) * s_tileSize + (firstX - tileX);
+                        auto * pCount = rAccumulator.m_count.data() + offset;
+                        auto * pSum = rAccumulator.m_sum.data() + offset;
+                        for (int x = 0; x < width; x++)
+                        {
+                            pSum[x] += pPixel[x];
+                            pCount[x]++;
+                        }
+                    }
+                }, rTile.m_accumulator);
         }
-        
     }
     return true;
 }
+
+std::size_t ScanFieldImageCalculator::pasteImageFiles(const std::vector<ImageFile> & rImageFiles)
+{
+    //the sums don't depend on the order of the images, the workers decode and paste independently
+    std::vector<char> oPasted(rImageFiles.size(), false);
+    std::atomic<std::size_t> oNextImage{0};
+    auto oWork = [this, &rImageFiles, &oPasted, &oNextImage] ()
+    {
+        precitec::image::BImage oImage;
+        for (std::size_t i = oNextImage++; i < rImageFiles.size(); i = oNextImage++)
+        {
+            const auto & rImageFile = rImageFiles[i];
+            fileio::Bitmap oBitmap(rImageFile.m_filename);
+            if (!oBitmap.validSize())
+            {
+                continue;
+            }
+            oImage.resize({oBitmap.width(), oBitmap.height()});
+            if (!oBitmap.load(oImage.begin()))
+            {
+                continue;
+            }
+            auto oPositionInScanfieldImage = m_parameters.getTopLeftCornerInScanFieldImageBeforeMirroring(oImage.size(), rImageFile.m_xScanner_mm, rImageFile.m_yScanner_mm);
+            oPasted[i] = pasteImage(oImage, oPositionInScanfieldImage.x, oPositionInScanfieldImage.y);
+        }
+    };
+    
+    static const std::size_t s_numCores = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::thread> oThreads;
+    for (std::size_t i = 1; i < std::min({s_numCores, s_maxWorkers, rImageFiles.size()}); i++)
+    {
+        oThreads.emplace_back(oWork);
+    }
+    oWork();
+    for (auto & rThread : oThreads)
+    {
+        rThread.join();
+    }
     
+    std::size_t oNumPasted = 0;
+    for (std::size_t i = 0; i < rImageFiles.size(); i++)
+    {
+        if (oPasted[i])
+        {
+            oNumPasted++;
+        }
+        else
+        {
+            wmLog(eInfo, "Error pasting image %s \n", rImageFiles[i].m_filename.c_str());
+        }
+    }
+    return oNumPasted;
+}
+
+void ScanFieldImageCalculator::reserveImage(Tile & rTile)
+{
+    typedef std::variant_alternative_t<0, TileAccumulator> NarrowAccumulator;
+    typedef std::variant_alternative_t<1, TileAccumulator> WideSumAccumulator;
+    typedef std::variant_alternative_t<2, TileAccumulator> WideAccumulator;
+    
+    if (rTile.m_numImages == 0)
+    {
+        auto & rAccumulator = rTile.m_accumulator.emplace<NarrowAccumulator>();
+        rAccumulator.m_count.assign(s_tileSize * s_tileSize, 0);
+        rAccumulator.m_sum.assign(s_tileSize * s_tileSize, 0);
+    }
+    else if (rTile.m_numImages == NarrowAccumulator::s_maxImages)
+    {
+        rTile.m_accumulator = widen<WideSumAccumulator>(std::get<NarrowAccumulator>(rTile.m_accumulator));
+    }
+    else if (rTile.m_numImages == WideSumAccumulator::s_maxImages)
+    {
+        rTile.m_accumulator = widen<WideAccumulator>(std::get<WideSumAccumulator>(rTile.m_accumulator));
+    }
+    assert(rTile.m_numImages < WideAccumulator::s_maxImages);
+    rTile.m_numImages++;
+}
 
+std::size_t ScanFieldImageCalculator::accumulatorBytes() const
+{
+    std::size_t oBytes = 0;
+    for (const auto & rTile : m_tiles)
+    {
+        std::visit([&oBytes] (const auto & rAccumulator)
+            {
+                oBytes += rAccumulator.m_count.capacity() * sizeof(rAccumulator.m_count[0]) + rAccumulator.m_sum.capacity() * sizeof(rAccumulator.m_sum[0]);
+            }, rTile.m_accumulator);
+    }
+    return oBytes;
+}
 
 const ScanFieldImageParameters& ScanFieldImageCalculator::getParameters() const 
 {
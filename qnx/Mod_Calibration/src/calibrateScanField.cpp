@@ -1225,18 +1225,21 @@ bool CalibrateScanField::calibrateCameraTarget() const
 
         //display artificial grid
         const int gridLineCount = std::min(50.0, std::abs(oImage.width() / distortionCoefficient[0] / (subGridLength_mm / 2) * 1.2));
-        std::vector<std::pair<double, double>> displayGrid;
-        displayGrid.resize(gridLineCount * gridLineCount);
+        std::vector<std::pair<double, double>> gridWorld;
+        gridWorld.reserve(gridLineCount * gridLineCount);
         for (int j = 0; j < gridLineCount; ++j)
         {
             for (int i = 0; i < gridLineCount; ++i)
             {
-                const double u = (i - (gridLineCount / 2)) * subGridLength_mm / 2;
-                const double v = (j - (gridLineCount / 2)) * subGridLength_mm / 2;
-                const auto point = worldToPixel(u, v, distortionCoefficient);
-                displayGrid[j * gridLineCount + i] = {point.first + gridCenter.first, point.second + gridCenter.second};
+                gridWorld.emplace_back((i - (gridLineCount / 2)) * subGridLength_mm / 2, (j - (gridLineCount / 2)) * subGridLength_mm / 2);
             }
         }
+        auto displayGrid = worldToPixel(gridWorld, distortionCoefficient);
+        for (auto& point : displayGrid)
+        {
+            point.first += gridCenter.first;
+            point.second += gridCenter.second;
+        }
         for (int j = 0; j < gridLineCount; ++j)
         {
             for (int i = 1; i < gridLineCount; ++i)
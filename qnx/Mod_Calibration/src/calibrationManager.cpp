@@ -7,6 +7,7 @@
  */
 
 
+#include <chrono>
 #include <sstream>
 #include "Poco/File.h"
 
@@ -1452,15 +1453,32 @@ void CalibrationManager::sendCalibDataChangedSignal(int p_oSensorID, bool p_oIni
     if (p_oInit)
     {
         wmLog(eInfo, "sendCalibDataChangedSignal with init true, preparing call to set3DCoords\n");
-        auto r3DCoords = rCalibData.getCalibrationCoords();
+        // not a copy, the generation of the arrays identifies the published version at the next call
+        auto & r3DCoords = rCalibData.getCalibrationCoordsReference();
         
         assert(r3DCoords.getSensorSize().area() > 0 && "Calling set3DCoords on invalid data ");
-     
+
+        // the coordinate arrays are passed in shared memory, unchanged arrays are not written again
+        const auto oStart = std::chrono::steady_clock::now();
+        if (!r3DCoords.publishSharedMemory(p_oSensorID))
+        {
+            wmLog(eWarning, "Could not publish 3DCoords in shared memory, sending them in the message\n");
+        }
         bool set3DCoords_response = m_rCalibDataMsgProxy.set3DCoords( p_oSensorID, r3DCoords, rCalibData.getParameters());
+        if (!set3DCoords_response && r3DCoords.getSharedMemoryHandle().isValid())
+        {
+            // the analyzer rejects coordinates it could not read from shared memory
+            wmLog(eWarning, "Analyzer could not read 3DCoords from shared memory, sending them in the message\n");
+            r3DCoords.resetSharedMemoryHandle();
+            set3DCoords_response = m_rCalibDataMsgProxy.set3DCoords( p_oSensorID, r3DCoords, rCalibData.getParameters());
+        }
         if (!set3DCoords_response)
         {
             wmLog(eWarning, "Error sending 3DCoords to Analyzer \n");
         }
+        // set3DCoords returns after the analyzer has reloaded the calibration
+        wmLog(eDebug, "3DCoords version %u available in analyzer after %d ms\n", r3DCoords.getSharedMemoryHandle().version,
+            int(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - oStart).count()));
         
         if (rCalibData.hasCameraCorrectionGrid())
         {
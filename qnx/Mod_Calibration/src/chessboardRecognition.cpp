@@ -1,5 +1,13 @@
 #include "calibration/chessboardRecognition.h"
+#include "Poco/Exception.h"
+#include "Poco/Runnable.h"
+#include "Poco/ThreadPool.h"
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace precitec
 {
@@ -47,33 +55,158 @@ ChessboardRecognitionAlgorithm::ChessboardRecognitionAlgorithm(const precitec::i
         int minExpectedIntensitySum = (1 -tolerance) * expectedIntensitySum;
         int maxExpectedIntensitySum = (1 + tolerance) * expectedIntensitySum;
 
+    // The candidates are evaluated in waves, each corner filter of a candidate is a task of its own. The results of a wave
+    // are inspected in the order of the candidates, like a sequential evaluation, so the first valid candidate is selected.
+    // The first wave contains the most likely candidate, later waves are only computed if it fails.
+    const std::size_t oNumWorkers = numWorkers();
+    const std::size_t oWaveSize = std::max<std::size_t>(oNumWorkers / 2, 1);
+    const std::array<FilteringAlgorithms::CornerDetectionType, 2> oFilterTypes{FilteringAlgorithms::CornerDetectionType::eBlackToWhite,
+                                                                                 FilteringAlgorithms::CornerDetectionType::eWhiteToBlack};
 
-    for (auto & thresholdCandidate : m_thresholdCandidates)
+    for (std::size_t oWaveStart = 0; oWaveStart < m_thresholdCandidates.size(); oWaveStart += oWaveSize)
     {
-        wmLog(eInfo, "Using threshold %d \n", thresholdCandidate);
-        auto oBinarizedImage = computeBinaryImage(preProcessedImage, thresholdCandidate, previewType, &m_previewImage);
-        if (!useProvidedThreshold)
+        std::vector<CandidateEvaluation> oWave;
+        for (std::size_t i = oWaveStart; i < std::min(oWaveStart + oWaveSize, m_thresholdCandidates.size()); i++)
         {
-            int pixelSum = 0;
-            oBinarizedImage.for_each([&pixelSum](byte pixelValue) { pixelSum += pixelValue;}, border, border, oInnerSize.width, oInnerSize.height);
-            if (pixelSum < minExpectedIntensitySum || pixelSum > maxExpectedIntensitySum)
+            oWave.emplace_back(m_thresholdCandidates[i], rImgSource.size());
+        }
+
+        parallelFor(oWave.size(), oNumWorkers, [&] (std::size_t i)
+            {
+                auto & rCandidate = oWave[i];
+                rCandidate.m_binarizedImage = computeBinaryImage(preProcessedImage, rCandidate.m_threshold, previewType, &rCandidate.m_previewImage);
+                if (!useProvidedThreshold)
+                {
+                    rCandidate.m_pixelSum = 0;
+                    rCandidate.m_binarizedImage.for_each([&rCandidate](byte pixelValue) { rCandidate.m_pixelSum += pixelValue;}, border, border, oInnerSize.width, oInnerSize.height);
+                    rCandidate.m_lowContrast = rCandidate.m_pixelSum < minExpectedIntensitySum || rCandidate.m_pixelSum > maxExpectedIntensitySum;
+                }
+            });
+
+        parallelFor(oWave.size() * oFilterTypes.size(), oNumWorkers, [&] (std::size_t i)
+            {
+                auto & rCandidate = oWave[i / oFilterTypes.size()];
+                if (!rCandidate.m_lowContrast)
+                {
+                    rCandidate.m_cornerPoints[i % oFilterTypes.size()] = thresholdCornerPoints(rCandidate.m_binarizedImage, oFilterTypes[i % oFilterTypes.size()], 200);
+                }
+            });
+
+        // a candidate after a valid one is never inspected
+        std::atomic<std::size_t> oFirstValid{oWave.size()};
+        parallelFor(oWave.size(), oNumWorkers, [&] (std::size_t i)
             {
-                wmLog(eDebug, "Binarized image has low contrast (%f), skip to next candidate  \n", double(pixelSum) /double(125.0*oInnerSize.area()));
+                auto & rCandidate = oWave[i];
+                if (rCandidate.m_lowContrast || i > oFirstValid)
+                {
+                    return;
+                }
+                auto oThresholdedPoints = std::move(rCandidate.m_cornerPoints[0]);
+                oThresholdedPoints.insert(oThresholdedPoints.end(), rCandidate.m_cornerPoints[1].begin(), rCandidate.m_cornerPoints[1].end());
+                ClusterCenters oClusters(oThresholdedPoints);
+                rCandidate.m_recognizedCorners = oClusters.getRawCorners();
+                std::tie(rCandidate.m_validGridMap, rCandidate.m_cornerGrid) = generateGridMap(rCandidate.m_recognizedCorners, oClusters.m_oMinSquareSize, rImgSource.size());
+                if (rCandidate.m_validGridMap)
+                {
+                    std::size_t oPrevious = oFirstValid;
+                    while (i < oPrevious && !oFirstValid.compare_exchange_weak(oPrevious, i))
+                    {
+                    }
+                }
+            });
+
+        for (auto & rCandidate : oWave)
+        {
+            wmLog(eInfo, "Using threshold %d \n", rCandidate.m_threshold);
+            if (rCandidate.m_previewImage.isValid())
+            {
+                m_previewImage = rCandidate.m_previewImage;
+            }
+            if (rCandidate.m_lowContrast)
+            {
+                wmLog(eDebug, "Binarized image has low contrast (%f), skip to next candidate  \n", double(rCandidate.m_pixelSum) /double(125.0*oInnerSize.area()));
                 continue;
             }
+
+            m_oRecognizedCorners = std::move(rCandidate.m_recognizedCorners);
+            m_validGridMap = rCandidate.m_validGridMap;
+            m_oCornerGrid = std::move(rCandidate.m_cornerGrid);
+            if (m_validGridMap)
+            {
+                m_threshold = rCandidate.m_threshold;
+                return;
+            }
         }
+    }
+}
+
+ChessboardRecognitionAlgorithm::CandidateEvaluation::CandidateEvaluation(int threshold, geo2d::Size validArea)
+    : m_threshold(threshold)
+    , m_cornerGrid(validArea)
+{
+}
+
+std::size_t ChessboardRecognitionAlgorithm::numWorkers()
+{
+    static const std::size_t s_numCores = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::min(s_numCores, s_maxWorkers);
+}
 
-        auto oThresholdedPoints = thresholdCornerPoints(oBinarizedImage, 200);
-        ClusterCenters oClusters(oThresholdedPoints);
-        m_oRecognizedCorners = oClusters.getRawCorners();
+Poco::ThreadPool & ChessboardRecognitionAlgorithm::threadPool()
+{
+    static Poco::ThreadPool s_threadPool(s_maxWorkers - 1, s_maxWorkers - 1);
+    return s_threadPool;
+}
+
+template <typename TTask>
+void ChessboardRecognitionAlgorithm::parallelFor(std::size_t numTasks, std::size_t numWorkers, TTask task)
+{
+    std::atomic<std::size_t> oNextTask{0};
+    auto oWork = [&oNextTask, numTasks, &task] ()
+    {
+        for (std::size_t i = oNextTask++; i < numTasks; i = oNextTask++)
+        {
+            task(i);
+        }
+    };
 
-        std::tie( m_validGridMap, m_oCornerGrid) = generateGridMap(m_oRecognizedCorners, oClusters.m_oMinSquareSize, rImgSource.size() );
-        if (m_validGridMap)
+    // the helpers take tasks until none is left, the calling thread waits until they are done
+    struct Helper : public Poco::Runnable
+    {
+        void run() override
         {
-            m_threshold = thresholdCandidate;
+            m_work();
+        }
+        std::function<void()> m_work;
+    };
+    std::mutex oMutex;
+    std::condition_variable oHelperDone;
+    std::size_t oNumRunningHelpers = 0;
+    Helper oHelper;
+    oHelper.m_work = [&] ()
+    {
+        oWork();
+        std::lock_guard<std::mutex> lock{oMutex};
+        oNumRunningHelpers--;
+        oHelperDone.notify_one();
+    };
+    for (std::size_t i = 1; i < std::min(numWorkers, numTasks); i++)
+    {
+        std::lock_guard<std::mutex> lock{oMutex};
+        try
+        {
+            threadPool().start(oHelper);
+            oNumRunningHelpers++;
+        }
+        catch (const Poco::NoThreadAvailableException &)
+        {
+            // another recognition uses the threads, the calling thread does the remaining tasks
             break;
         }
     }
+    oWork();
+    std::unique_lock<std::mutex> lock{oMutex};
+    oHelperDone.wait(lock, [&oNumRunningHelpers] { return oNumRunningHelpers == 0; });
 }
 
 precitec::image::Size2d ChessboardRecognitionAlgorithm::validImageSizeAfterFiltering(const precitec::image::Size2d & rImageSize, int border)
@@ -157,7 +290,8 @@ precitec::image::BImage ChessboardRecognitionAlgorithm::computeBinaryImage(const
     return oTempImage;
 }
 
-std::vector<precitec::geo2d::DPoint> ChessboardRecognitionAlgorithm::thresholdCornerPoints(const precitec::image::BImage & rBinarizedImage, byte oThreshold,
+std::vector<precitec::geo2d::DPoint> ChessboardRecognitionAlgorithm::thresholdCornerPoints(const precitec::image::BImage & rBinarizedImage,
+                                FilteringAlgorithms::CornerDetectionType filterType, byte oThreshold,
                                 PreviewType previewType, image::BImage * p_previewImage)
 {
     using precitec::image::BImage;
@@ -169,73 +303,52 @@ std::vector<precitec::geo2d::DPoint> ChessboardRecognitionAlgorithm::thresholdCo
 
     FilteringAlgorithms oImageFilterImplementation;
 
-    for (auto filterType : { FilteringAlgorithms::CornerDetectionType::eBlackToWhite ,
-                            FilteringAlgorithms::CornerDetectionType::eWhiteToBlack  })
-    {
-        bool returnForPreview = false;
+    bool returnForPreview = false;
 
-        switch (filterType)
-        {
-            case (FilteringAlgorithms::CornerDetectionType::eBlackToWhite):
-                returnForPreview =  (previewType == PreviewType::AfterCornerDetectionB2W);
-                break;
-            case (FilteringAlgorithms::CornerDetectionType::eWhiteToBlack):
-                returnForPreview =  (previewType == PreviewType::AfterCornerDetectionW2B);
-                break;
-        }
+    switch (filterType)
+    {
+        case (FilteringAlgorithms::CornerDetectionType::eBlackToWhite):
+            returnForPreview =  (previewType == PreviewType::AfterCornerDetectionB2W);
+            break;
+        case (FilteringAlgorithms::CornerDetectionType::eWhiteToBlack):
+            returnForPreview =  (previewType == PreviewType::AfterCornerDetectionW2B);
+            break;
+    }
 
-        BImage oFilteredImage = oImageFilterImplementation.convolution(rBinarizedImage, oImageFilterImplementation.detectionMask(filterType));
-        if (!oFilteredImage.isValid())
-        {
-            return {};
-        }
+    BImage oFilteredImage = oImageFilterImplementation.convolution(rBinarizedImage, oImageFilterImplementation.detectionMask(filterType));
+    if (!oFilteredImage.isValid())
+    {
+        return {};
+    }
 
-        if (returnForPreview)
+    if (returnForPreview)
+    {
+        if (p_previewImage)
         {
-            if (p_previewImage)
-            {
-                *p_previewImage = oFilteredImage;
-            }
-            return {};
+            *p_previewImage = oFilteredImage;
         }
+        return {};
+    }
 
 
-        //threshold and extract  corner coordinates
+    //threshold and extract  corner coordinates
 
-        auto oValMax = 0;
+    int border = oImageFilterImplementation.detectionMask(FilteringAlgorithms::eWhiteToBlack).size();
+    assert(border == FilteringAlgorithms::m_oDetectionMaskSize);
 
-        int border = oImageFilterImplementation.detectionMask(FilteringAlgorithms::eWhiteToBlack).size();
-        assert(border == FilteringAlgorithms::m_oDetectionMaskSize);
+    for (int y= border, yMax = oFilteredImage.height() - border ; y < yMax ; ++y)
+    {
+        int x0 = border;
+        auto * pLine = oFilteredImage.rowBegin(y) + x0;
 
-        for (int y= border, yMax = oFilteredImage.height() - border ; y < yMax ; ++y)
+        for (int x=x0, xMax = oFilteredImage.width() - border; x < xMax; ++x, pLine++)
         {
-            int x0 = border;
-            auto * pLine = oFilteredImage.rowBegin(y) + x0;
-
-            for (int x=x0, xMax = oFilteredImage.width() - border; x < xMax; ++x, pLine++)
+            if ( *pLine >= oThreshold  )
             {
-                auto & rVal = *pLine;
-                if ( rVal >= oThreshold  )
-                {
-                    oThresholdedPoints.push_back({double(x), double(y)});
-                }
-                if ( rVal > oValMax )
-                {
-                    oValMax = rVal;
-                }
-
+                oThresholdedPoints.push_back({double(x), double(y)});
             }
-
-
         }
-
-        if ( oThreshold > oValMax*0.9 )
-        {
-            //wmLog( LogType::eDebug, "Corner extraction: filtered image doesn't have enough contrast \n");
-        }
-
-    //std::cout << "After filtering " << curOperation << ": " << oThresholdedPoints.size() << " candidate points found" << std::endl;
-    }//for B2W, W2B
+    }
 
     return oThresholdedPoints;
 }
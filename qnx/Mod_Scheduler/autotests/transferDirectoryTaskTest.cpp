@@ -1,9 +1,18 @@
 #include <QTest>
 #include <QObject>
+#include <QTemporaryDir>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 #include "Scheduler/taskFactory.h"
 #include "Scheduler/transferDirectoryTask.h"
+#include "../src/SchedulerHelper/fileUpload.h"
+
+namespace fs = std::filesystem;
 
+using precitec::scheduler::FileUpload;
 using precitec::scheduler::TaskFactory;
 using precitec::scheduler::TransferDirectoryTask;
 using precitec::scheduler::TransferDirectoryTaskFactory;
@@ -15,8 +24,59 @@ private Q_SLOTS:
     void testCtor();
     void testJsonTransferDirectoryTaskFactory();
     void testCheckSettings();
+    void testUploadDirectory_data();
+    void testUploadDirectory();
+    void testResumeUploadDirectory();
+
+private:
+    void createProductInstance(const fs::path& directory);
+    void initUpload(FileUpload& upload, const QTemporaryDir& source, const QTemporaryDir& target);
+    std::vector<fs::path> m_smallFiles;
+    std::vector<fs::path> m_largeFiles;
 };
 
+namespace
+{
+
+std::string fileContent(const fs::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+}
+
+void TransferDirectoryTaskTest::createProductInstance(const fs::path& directory)
+{
+    // many small result files and a few videos
+    m_smallFiles.clear();
+    m_largeFiles.clear();
+    for (int seam = 0; seam < 20; seam++)
+    {
+        const auto seamDirectory = directory / "Instance" / ("seam_" + std::to_string(seam));
+        fs::create_directories(seamDirectory);
+        for (int result = 0; result < 25; result++)
+        {
+            m_smallFiles.push_back(fs::path{"seam_" + std::to_string(seam)} / ("result_" + std::to_string(result) + ".json"));
+            std::ofstream{seamDirectory / m_smallFiles.back().filename()} << std::string(500 + seam * 25 + result, 'a' + result);
+        }
+    }
+    for (int video = 0; video < 4; video++)
+    {
+        m_largeFiles.push_back(fs::path{"video_" + std::to_string(video) + ".bin"});
+        std::ofstream{directory / "Instance" / m_largeFiles.back()} << std::string(1024 * 1024, 'v' + video);
+    }
+}
+
+void TransferDirectoryTaskTest::initUpload(FileUpload& upload, const QTemporaryDir& source, const QTemporaryDir& target)
+{
+    upload.setProtocol(FileUpload::Protocol::File);
+    upload.SetSourceDirectory(source.path().toStdString());
+    upload.SetDirectoryToSend("Instance");
+    upload.SetTargetDirectory(target.path().toStdString() + "/");
+    upload.SetTargetDirectoryName("Instance");
+}
+
 void TransferDirectoryTaskTest::testCtor()
 {
     TransferDirectoryTaskTest task;
@@ -49,6 +109,106 @@ void TransferDirectoryTaskTest::testCheckSettings()
     QVERIFY(dynamic_cast<precitec::scheduler::TransferDirectoryTask *>(task.get())->checkSettings());
 }
 
+void TransferDirectoryTaskTest::testUploadDirectory_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("bundleFilesSmallerThan");
+
+    QTest::newRow("1 connection") << 1 << 0;
+    QTest::newRow("4 connections") << 4 << 0;
+    QTest::newRow("4 connections, bundled") << 4 << 4096;
+}
+
+void TransferDirectoryTaskTest::testUploadDirectory()
+{
+    QFETCH(int, connections);
+    QFETCH(int, bundleFilesSmallerThan);
+
+    QTemporaryDir source;
+    QTemporaryDir target;
+    QVERIFY(source.isValid());
+    QVERIFY(target.isValid());
+    createProductInstance(source.path().toStdString());
+
+    FileUpload upload;
+    initUpload(upload, source, target);
+    upload.setMaxConnections(connections);
+    upload.setBundleFilesSmallerThan(bundleFilesSmallerThan);
+    upload.UploadDirectory();
+
+    QCOMPARE(upload.GetNumberOfTransmittedFiles(), uint32_t(m_smallFiles.size() + m_largeFiles.size()));
+    QCOMPARE(upload.GetNumberOfSkippedFiles(), uint32_t(0));
+    QVERIFY(!fs::exists(fs::path{source.path().toStdString()} / ".Instance.transfer"));
+
+    const fs::path sourceDirectory = source.path().toStdString() + "/Instance";
+    const fs::path targetDirectory = target.path().toStdString() + "/Instance";
+    for (const auto& file : m_largeFiles)
+    {
+        QVERIFY(fileContent(targetDirectory / file) == fileContent(sourceDirectory / file));
+    }
+    if (bundleFilesSmallerThan == 0)
+    {
+        for (const auto& file : m_smallFiles)
+        {
+            QVERIFY(fileContent(targetDirectory / file) == fileContent(sourceDirectory / file));
+        }
+    }
+    else
+    {
+        // the small files are packed into one archive, the archive contains each file with its header
+        QVERIFY(!fs::exists(targetDirectory / m_smallFiles.front()));
+        const auto archive = fileContent(targetDirectory / "bundle_0.tar");
+        QVERIFY(!fs::exists(targetDirectory / "bundle_1.tar"));
+        for (const auto& file : m_smallFiles)
+        {
+            const auto position = archive.find(file.string());
+            QVERIFY(position != std::string::npos);
+            QCOMPARE(archive.substr(position + 512, fs::file_size(sourceDirectory / file)), fileContent(sourceDirectory / file));
+        }
+        QVERIFY(upload.GetTotalTransmittedBytes() > 4 * 1024 * 1024 + m_smallFiles.size() * 512);
+    }
+
+    QTest::setBenchmarkResult(upload.GetThroughputBytesPerSecond(), QTest::BytesPerSecond);
+}
+
+void TransferDirectoryTaskTest::testResumeUploadDirectory()
+{
+    QTemporaryDir source;
+    QTemporaryDir target;
+    QVERIFY(source.isValid());
+    QVERIFY(target.isValid());
+    createProductInstance(source.path().toStdString());
+
+    // a directory in the way of one file interrupts the transfer
+    const fs::path targetDirectory = target.path().toStdString() + "/Instance";
+    fs::create_directories(targetDirectory / m_largeFiles.front() / "blocked");
+
+    FileUpload upload;
+    initUpload(upload, source, target);
+    upload.UploadDirectory();
+
+    const auto fileCount = m_smallFiles.size() + m_largeFiles.size();
+    QCOMPARE(upload.GetNumberOfTransmittedFiles(), uint32_t(fileCount - 1));
+    QVERIFY(fs::exists(fs::path{source.path().toStdString()} / ".Instance.transfer"));
+
+    // files which are already transferred are not sent again
+    fs::remove_all(targetDirectory / m_largeFiles.front());
+    fs::remove(targetDirectory / m_largeFiles.back());
+    upload.UploadDirectory();
+
+    QCOMPARE(upload.GetNumberOfTransmittedFiles(), uint32_t(1));
+    QCOMPARE(upload.GetNumberOfSkippedFiles(), uint32_t(fileCount - 1));
+    QCOMPARE(upload.GetTotalTransmittedBytes(), uint64_t(1024 * 1024));
+    QVERIFY(fs::exists(targetDirectory / m_largeFiles.front()));
+    QVERIFY(!fs::exists(targetDirectory / m_largeFiles.back()));
+    QVERIFY(!fs::exists(fs::path{source.path().toStdString()} / ".Instance.transfer"));
+
+    // a completed transfer starts from scratch
+    upload.UploadDirectory();
+    QCOMPARE(upload.GetNumberOfTransmittedFiles(), uint32_t(fileCount));
+    QVERIFY(fs::exists(targetDirectory / m_largeFiles.back()));
+}
+
 QTEST_GUILESS_MAIN(TransferDirectoryTaskTest)
 #include "transferDirectoryTaskTest.moc"
 
@@ -33,6 +33,12 @@ int main(int argc, char* argv[])
         oLoggerText << "TransferDirectory: NumberOfTransmittedFiles: " << m_oFileUpload.GetNumberOfTransmittedFiles() << std::endl;
         precitec::pipeLogger::SendLoggerMessage(oWritePipeFd, precitec::eInfo, oLoggerText.str().c_str());
     }
+    if (m_oFileUpload.GetNumberOfSkippedFiles() > 0)
+    {
+        std::stringstream oLoggerText{};
+        oLoggerText << "TransferDirectory: Resumed, skipped files:   " << m_oFileUpload.GetNumberOfSkippedFiles() << std::endl;
+        precitec::pipeLogger::SendLoggerMessage(oWritePipeFd, precitec::eInfo, oLoggerText.str().c_str());
+    }
     {
         std::stringstream oLoggerText{};
         oLoggerText << "TransferDirectory: TotalTransmittedBytes:    " << m_oFileUpload.GetTotalTransmittedBytes() << std::endl;
@@ -43,6 +49,11 @@ int main(int argc, char* argv[])
         oLoggerText << "TransferDirectory: DurationOfTransmissionMS: " << m_oFileUpload.GetDurationOfTransmissionMS() << std::endl;
         precitec::pipeLogger::SendLoggerMessage(oWritePipeFd, precitec::eInfo, oLoggerText.str().c_str());
     }
+    {
+        std::stringstream oLoggerText{};
+        oLoggerText << "TransferDirectory: ThroughputKBytesPerSec:   " << m_oFileUpload.GetThroughputBytesPerSecond() / 1024 << std::endl;
+        precitec::pipeLogger::SendLoggerMessage(oWritePipeFd, precitec::eInfo, oLoggerText.str().c_str());
+    }
     precitec::pipeLogger::SendLoggerMessage(oWritePipeFd, precitec::eDebug, "End of TransferDirectory\n");
 
     close(oWritePipeFd); // close the write fd
@@ -21,9 +21,13 @@ static const std::string s_protocol{"--protocol="};
 static const std::string s_protocolSftp{"sftp"};
 static const std::string s_protocolHttp{"http"};
 static const std::string s_protocolHttps{"https"};
+static const std::string s_protocolFile{"file"};
 static const std::string s_httpMethodArg{"--httpMethod="};
 static const std::string s_httpPost{"POST"};
 static const std::string s_httpPut{"PUT"};
+static const std::string s_connectionsArg{"--connections="};
+static const std::string s_bundleArg{"--bundleBelow="};
+static const std::string s_manifestArg{"--manifest="};
 
 void parseCommandLine(int argc, char* argv[], FileUpload& fileUpload)
 {
@@ -96,6 +100,10 @@ void parseCommandLine(int argc, char* argv[], FileUpload& fileUpload)
             {
                 fileUpload.setProtocol(FileUpload::Protocol::Https);
             }
+            else if (protocol == s_protocolFile)
+            {
+                fileUpload.setProtocol(FileUpload::Protocol::File);
+            }
         }
         else if (arg.rfind(s_httpMethodArg, 0) ==0)
         {
@@ -109,6 +117,30 @@ void parseCommandLine(int argc, char* argv[], FileUpload& fileUpload)
                 fileUpload.setHttpMethod(FileUpload::HttpMethod::Put);
             }
         }
+        else if (arg.rfind(s_connectionsArg, 0) == 0)
+        {
+            try
+            {
+                fileUpload.setMaxConnections(std::stoul(arg.substr(s_connectionsArg.length())));
+            }
+            catch (...)
+            {
+            }
+        }
+        else if (arg.rfind(s_bundleArg, 0) == 0)
+        {
+            try
+            {
+                fileUpload.setBundleFilesSmallerThan(std::stoull(arg.substr(s_bundleArg.length())));
+            }
+            catch (...)
+            {
+            }
+        }
+        else if (arg.rfind(s_manifestArg, 0) == 0)
+        {
+            fileUpload.setManifestFile(arg.substr(s_manifestArg.length()));
+        }
     }
 }
 
@@ -11,7 +11,14 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <pwd.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <numeric>
+#include <set>
+#include <sstream>
 
 #include "pipeLogger.h"
 #include "fileUpload.h"
@@ -26,6 +33,216 @@ namespace fs = std::filesystem;
 
 const int MAX_LOGGER_MESSAGE_LENGTH = 150;
 
+/**
+ * Maximum size of an archive with small files, see FileUpload::setBundleFilesSmallerThan.
+ **/
+const std::uintmax_t MAX_BUNDLE_SIZE = 64 * 1024 * 1024;
+
+const std::size_t TAR_BLOCK_SIZE = 512;
+
+/**
+ * A file or an archive of small files which is uploaded by UploadDirectory.
+ **/
+struct FileUpload::Upload
+{
+    fs::path localPath;
+    std::string url;
+    std::uintmax_t size{0};
+    std::size_t fileCount{1};
+    // files which are packed into the archive at localPath right before the upload, with their names in the archive
+    std::vector<std::pair<fs::path, std::string>> bundleMembers;
+    // recorded in the manifest as soon as the upload succeeded
+    std::vector<std::string> manifestEntries;
+};
+
+/**
+ * Uploaded files of a directory transfer, see FileUpload::setManifestFile.
+ * The first line is the destination of the transfer, a manifest of another destination is discarded.
+ * Every finished upload is appended and flushed immediately, so the manifest survives an interrupted transfer.
+ **/
+class FileUpload::Manifest
+{
+public:
+    Manifest(const fs::path& path, const std::string& destination)
+        : m_path(path)
+    {
+        if (std::ifstream in{m_path}; in)
+        {
+            std::string line;
+            if (std::getline(in, line) && line == destination)
+            {
+                while (std::getline(in, line))
+                {
+                    if (!line.empty())
+                    {
+                        m_entries.insert(line);
+                    }
+                }
+            }
+        }
+
+        m_file.open(m_path, std::ios::trunc);
+        m_file << destination << '\n';
+        for (const auto& entry : m_entries)
+        {
+            m_file << entry << '\n';
+        }
+        m_file.flush();
+    }
+
+    bool isOpen() const
+    {
+        return m_file.is_open();
+    }
+
+    bool contains(const std::string& entry) const
+    {
+        return m_entries.find(entry) != m_entries.end();
+    }
+
+    std::size_t count(char type) const
+    {
+        return std::count_if(m_entries.begin(), m_entries.end(), [type] (const auto& entry) { return entry.front() == type; });
+    }
+
+    void add(const std::vector<std::string>& entries)
+    {
+        for (const auto& entry : entries)
+        {
+            m_entries.insert(entry);
+            m_file << entry << '\n';
+        }
+        m_file.flush();
+    }
+
+    void remove()
+    {
+        m_file.close();
+        std::error_code oErrorCode;
+        fs::remove(m_path, oErrorCode);
+    }
+
+private:
+    fs::path m_path;
+    std::set<std::string> m_entries;
+    std::ofstream m_file;
+};
+
+namespace
+{
+
+/**
+ * Header block of the ustar format (POSIX.1-1988).
+ **/
+struct TarHeader
+{
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char padding[12];
+};
+static_assert(sizeof(TarHeader) == TAR_BLOCK_SIZE);
+
+/**
+ * Stores @p name in the name field or splits it at a '/' into the prefix and the name field. Returns false if the name is too long.
+ **/
+bool setTarName(TarHeader& header, const std::string& name)
+{
+    if (name.size() <= sizeof(header.name))
+    {
+        std::copy(name.begin(), name.end(), header.name);
+        return true;
+    }
+    for (auto pos = name.find('/'); pos != std::string::npos && pos <= sizeof(header.prefix); pos = name.find('/', pos + 1))
+    {
+        if (name.size() - pos - 1 <= sizeof(header.name))
+        {
+            std::copy(name.begin(), name.begin() + pos, header.prefix);
+            std::copy(name.begin() + pos + 1, name.end(), header.name);
+            return true;
+        }
+    }
+    return false;
+}
+
+void setTarNumber(char* field, std::size_t fieldSize, unsigned long long value)
+{
+    // octal with leading zeros, terminated by NUL
+    std::string number(fieldSize - 1, '0');
+    for (auto it = number.rbegin(); it != number.rend() && value != 0; ++it, value /= 8)
+    {
+        *it = '0' + value % 8;
+    }
+    std::copy(number.begin(), number.end(), field);
+    field[fieldSize - 1] = '\0';
+}
+
+std::uintmax_t tarSize(std::uintmax_t fileSize)
+{
+    return TAR_BLOCK_SIZE + (fileSize + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+}
+
+/**
+ * Writes an uncompressed tar archive with the files. Each file is stored with the given name.
+ **/
+bool writeTarArchive(const fs::path& archive, const std::vector<std::pair<fs::path, std::string>>& files)
+{
+    std::ofstream out{archive, std::ios::binary | std::ios::trunc};
+    std::vector<char> content;
+    for (const auto& [path, name] : files)
+    {
+        std::ifstream in{path, std::ios::binary};
+        struct stat status;
+        if (!in || stat(path.c_str(), &status) != 0)
+        {
+            return false;
+        }
+        content.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+
+        TarHeader header{};
+        if (!setTarName(header, name))
+        {
+            return false;
+        }
+        setTarNumber(header.mode, sizeof(header.mode), 0644);
+        setTarNumber(header.uid, sizeof(header.uid), 0);
+        setTarNumber(header.gid, sizeof(header.gid), 0);
+        setTarNumber(header.size, sizeof(header.size), content.size());
+        setTarNumber(header.mtime, sizeof(header.mtime), status.st_mtime);
+        header.typeflag = '0';
+        std::copy_n("ustar", sizeof(header.magic), header.magic);
+        std::copy_n("00", sizeof(header.version), header.version);
+
+        // the checksum is calculated with spaces in the checksum field
+        std::fill(std::begin(header.checksum), std::end(header.checksum), ' ');
+        const auto bytes = reinterpret_cast<const unsigned char*>(&header);
+        setTarNumber(header.checksum, sizeof(header.checksum) - 1, std::accumulate(bytes, bytes + sizeof(header), 0u));
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(content.data(), content.size());
+        out.write(std::string(tarSize(content.size()) - TAR_BLOCK_SIZE - content.size(), '\0').data(), tarSize(content.size()) - TAR_BLOCK_SIZE - content.size());
+    }
+    // end of archive
+    out.write(std::string(2 * TAR_BLOCK_SIZE, '\0').data(), 2 * TAR_BLOCK_SIZE);
+    out.close();
+    return !out.fail();
+}
+
+}
+
 FileUpload::FileUpload(void):
     m_oNumberOfTransmittedFiles(0),
     m_oTotalTransmittedBytes(0),
@@ -75,6 +292,7 @@ void FileUpload::UploadFile(void)
             {
                 std::cerr << "[" << oDestination << "]" << std::endl;
             }
+            createLocalTargetDirectory(oDestination);
             curl_easy_setopt(m_pCurlHandle, CURLOPT_URL, oDestination.c_str());
 
             FILE* pFileHandle = fopen(m_oFileToSend.c_str(), "rb");
@@ -125,80 +343,16 @@ void FileUpload::UploadDirectory(void)
             {
                 std::cerr << m_oDirectoryToSend << std::endl;
             }
-            std::error_code oErrorCode;
-            fs::path start{m_oDirectoryToSend};
-            fs::recursive_directory_iterator verzeichnisIt{start}, ende;
-            while (verzeichnisIt != ende)
+            Manifest manifest{manifestPath(), buildUrl(TransferMode::Directory)};
+            if (!manifest.isOpen())
             {
-                if (!fs::is_directory(verzeichnisIt->path()))
-                {
-                    if (m_oDebugFileIsOn)
-                    {
-                        std::cerr << std::endl;
-                        std::cerr << verzeichnisIt->path().string() << std::endl;
-                    }
-
-                    std::uintmax_t oSize = fs::file_size(verzeichnisIt->path(), oErrorCode);
-                    if (oSize == static_cast<std::uintmax_t>(-1))
-                    {
-                        std::cerr << "error in stat " << verzeichnisIt->path() << ": " << errno << "," << strerror(errno) << std::endl;
-                        char oLogMsg[200];
-                        sprintf(oLogMsg, "Directory transfer to a remote system has failed (%s)\n", "001");
-                        precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eError, oLogMsg);
-                        sprintf(oLogMsg, "error in stat %s: %d,%s\n", m_oFileToSend.c_str(), errno, strerror(errno));
-                        precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eDebug, oLogMsg);
-                        return;
-                    }
-                    unsigned long oFileSize = (unsigned long)oSize;
-                    if (m_oDebugFileIsOn)
-                    {
-                        std::cerr << "Local oFileSize: " << oFileSize << " bytes" << std::endl;
-                    }
-                    curl_easy_setopt(m_pCurlHandle, CURLOPT_INFILESIZE_LARGE, (curl_off_t)oFileSize);
-
-                    // the path is shortened by the first level
-                    int oLoop{1};
-                    std::stringstream oNewPath{};
-                    auto it = verzeichnisIt->path().begin();
-                    while(it != verzeichnisIt->path().end())
-                    {
-                        if (oLoop > 1)
-                        {
-                            oNewPath << "/" << it->string();
-                        }
-                        ++it;
-                        ++oLoop;
-                    }
-                    const auto oDestination{buildUrl(TransferMode::Directory)  + oNewPath.str()};
-                    if (m_oDebugFileIsOn)
-                    {
-                        std::cerr << "[" << oDestination << "]" << std::endl;
-                    }
-                    curl_easy_setopt(m_pCurlHandle, CURLOPT_URL, oDestination.c_str());
-
-                    FILE* pFileHandle = fopen(verzeichnisIt->path().string().c_str(), "rb");
-                    curl_easy_setopt(m_pCurlHandle, CURLOPT_READDATA, pFileHandle); // now specify which file to upload
-
-                    initHttpMime(verzeichnisIt->path().string());
+                std::cerr << "cannot write manifest " << manifestPath() << ", an interrupted transfer cannot be resumed" << std::endl;
+            }
 
-                    CURLcode res = curl_easy_perform(m_pCurlHandle); // Now run off and do what you have been told
-                    if(res != CURLE_OK) // Check for errors
-                    {
-                        std::cerr << "error in curl_easy_perform: " << static_cast<int>(res) << "," << curl_easy_strerror(res) << std::endl;
-                        char oLogMsg[200];
-                        sprintf(oLogMsg, "Directory transfer to a remote system has failed (%s)\n", "002");
-                        precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eError, oLogMsg);
-                        sprintf(oLogMsg, "error in curl_easy_perform: %d,%s\n", res, curl_easy_strerror(res));
-                        precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eDebug, oLogMsg);
-                    }
-                    else
-                    {
-                        m_oNumberOfTransmittedFiles++;
-                        m_oTotalTransmittedBytes += oFileSize;
-                    }
-                    fclose(pFileHandle);
-                }
-                ++verzeichnisIt;
+            std::vector<Upload> uploads;
+            if (collectUploads(manifest, uploads) && transferConcurrently(uploads, manifest))
+            {
+                manifest.remove();
             }
         }
         catch(fs::filesystem_error const& oFilesystemException)
@@ -215,6 +369,272 @@ void FileUpload::UploadDirectory(void)
     PostTransfer();
 }
 
+bool FileUpload::collectUploads(Manifest& manifest, std::vector<Upload>& uploads)
+{
+    // sorted, so that the same small files are bundled again when an interrupted transfer is resumed
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it{fs::path{m_oDirectoryToSend}}, end; it != end; ++it)
+    {
+        if (!fs::is_directory(it->path()))
+        {
+            files.push_back(it->path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    const auto oDestination{buildUrl(TransferMode::Directory)};
+    std::vector<Upload> smallFiles;
+    for (const auto& file : files)
+    {
+        struct stat status;
+        if (stat(file.c_str(), &status) != 0)
+        {
+            logDirectoryTransferError("001", "error in stat " + file.string() + ": " + std::to_string(errno) + "," + strerror(errno));
+            return false;
+        }
+
+        // the path is shortened by the first level
+        std::string oNewPath;
+        for (auto it = std::next(file.begin()); it != file.end(); ++it)
+        {
+            oNewPath += "/" + it->string();
+        }
+
+        std::ostringstream entry;
+        entry << "F " << status.st_size << " " << status.st_mtim.tv_sec << "." << std::setfill('0') << std::setw(9) << status.st_mtim.tv_nsec << " " << file.string();
+        if (manifest.contains(entry.str()))
+        {
+            m_numberOfSkippedFiles++;
+            continue;
+        }
+
+        Upload upload;
+        upload.localPath = file;
+        upload.url = oDestination + oNewPath;
+        upload.size = status.st_size;
+        upload.manifestEntries.push_back(entry.str());
+
+        TarHeader header{};
+        if (upload.size < m_bundleFilesSmallerThan && setTarName(header, oNewPath.substr(1)))
+        {
+            smallFiles.push_back(std::move(upload));
+        }
+        else
+        {
+            uploads.push_back(std::move(upload));
+        }
+    }
+
+    // bundles of a resumed transfer get new names, the bundles of the interrupted transfer are complete
+    auto bundleIndex = manifest.count('B');
+    for (auto it = smallFiles.begin(); it != smallFiles.end(); bundleIndex++)
+    {
+        const auto name = "bundle_" + std::to_string(bundleIndex) + ".tar";
+        Upload bundle;
+        bundle.localPath = fs::temp_directory_path() / ("TransferDirectory_" + std::to_string(getpid()) + "_" + name);
+        bundle.url = oDestination + "/" + name;
+        bundle.size = 2 * TAR_BLOCK_SIZE;
+        bundle.fileCount = 0;
+        for (; it != smallFiles.end() && (bundle.fileCount == 0 || bundle.size + tarSize(it->size) <= MAX_BUNDLE_SIZE); ++it)
+        {
+            bundle.size += tarSize(it->size);
+            bundle.fileCount++;
+            bundle.bundleMembers.emplace_back(it->localPath, it->url.substr(oDestination.size() + 1));
+            bundle.manifestEntries.push_back(it->manifestEntries.front());
+        }
+        bundle.manifestEntries.push_back("B " + name);
+        uploads.push_back(std::move(bundle));
+    }
+
+    // large uploads first, so that the connections finish at about the same time
+    std::stable_sort(uploads.begin(), uploads.end(), [] (const auto& a, const auto& b) { return a.size > b.size; });
+    return true;
+}
+
+bool FileUpload::transferConcurrently(std::vector<Upload>& uploads, Manifest& manifest)
+{
+    struct Connection
+    {
+        CURL* handle{nullptr};
+        Upload* upload{nullptr};
+        FILE* file{nullptr};
+        curl_mime* mime{nullptr};
+    };
+
+    CURLM* multiHandle = curl_multi_init();
+    if (!multiHandle)
+    {
+        logDirectoryTransferError("005", "error in curl_multi_init");
+        return false;
+    }
+    curl_multi_setopt(multiHandle, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(m_maxConnections));
+    curl_multi_setopt(multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(m_maxConnections));
+
+    // the handle of PreTransfer and copies of it with the same options, each handle keeps its connection open for the next upload
+    std::vector<Connection> connections(std::min(m_maxConnections, uploads.size()));
+    for (std::size_t i = 0; i < connections.size(); i++)
+    {
+        connections[i].handle = i == 0 ? m_pCurlHandle : curl_easy_duphandle(m_pCurlHandle);
+        if (!connections[i].handle)
+        {
+            connections.resize(i);
+            break;
+        }
+        curl_easy_setopt(connections[i].handle, CURLOPT_PRIVATE, &connections[i]);
+    }
+
+    bool success = true;
+    auto next = uploads.begin();
+    auto startNextUpload = [&] (Connection& connection)
+    {
+        for (; next != uploads.end(); ++next)
+        {
+            Upload& upload = *next;
+            if (!upload.bundleMembers.empty())
+            {
+                std::error_code oErrorCode;
+                if (!writeTarArchive(upload.localPath, upload.bundleMembers))
+                {
+                    logDirectoryTransferError("004", "cannot create " + upload.localPath.string());
+                    fs::remove(upload.localPath, oErrorCode);
+                    success = false;
+                    continue;
+                }
+                upload.size = fs::file_size(upload.localPath, oErrorCode);
+            }
+
+            connection.file = fopen(upload.localPath.c_str(), "rb");
+            if (!connection.file)
+            {
+                logDirectoryTransferError("004", "cannot open " + upload.localPath.string() + ": " + std::to_string(errno) + "," + strerror(errno));
+                success = false;
+                continue;
+            }
+            if (m_oDebugFileIsOn)
+            {
+                std::cerr << std::endl;
+                std::cerr << upload.localPath.string() << std::endl;
+                std::cerr << "Local oFileSize: " << upload.size << " bytes" << std::endl;
+                std::cerr << "[" << upload.url << "]" << std::endl;
+            }
+            createLocalTargetDirectory(upload.url);
+
+            curl_easy_setopt(connection.handle, CURLOPT_URL, upload.url.c_str());
+            curl_easy_setopt(connection.handle, CURLOPT_INFILESIZE_LARGE, (curl_off_t)upload.size);
+            curl_easy_setopt(connection.handle, CURLOPT_READDATA, connection.file); // now specify which file to upload
+            connection.mime = createHttpMime(connection.handle, upload.localPath.string(), m_oTargetFileName);
+            if (connection.mime)
+            {
+                curl_easy_setopt(connection.handle, CURLOPT_MIMEPOST, connection.mime);
+            }
+            connection.upload = &upload;
+            ++next;
+
+            curl_multi_add_handle(multiHandle, connection.handle);
+            return true;
+        }
+        return false;
+    };
+    auto finishUpload = [&] (Connection& connection, CURLcode res)
+    {
+        curl_multi_remove_handle(multiHandle, connection.handle);
+        fclose(connection.file);
+        connection.file = nullptr;
+        if (connection.mime)
+        {
+            curl_easy_setopt(connection.handle, CURLOPT_MIMEPOST, nullptr);
+            curl_mime_free(connection.mime);
+            connection.mime = nullptr;
+        }
+
+        Upload& upload = *connection.upload;
+        connection.upload = nullptr;
+        if (!upload.bundleMembers.empty())
+        {
+            std::error_code oErrorCode;
+            fs::remove(upload.localPath, oErrorCode);
+        }
+
+        if (res != CURLE_OK) // Check for errors
+        {
+            logDirectoryTransferError("002", "error in curl transfer of " + upload.localPath.string() + ": " + std::to_string(res) + "," + curl_easy_strerror(res));
+            success = false;
+            return;
+        }
+        m_oNumberOfTransmittedFiles += upload.fileCount;
+        m_oTotalTransmittedBytes += upload.size;
+        manifest.add(upload.manifestEntries);
+    };
+
+    std::size_t activeConnections = 0;
+    for (auto& connection : connections)
+    {
+        if (startNextUpload(connection))
+        {
+            activeConnections++;
+        }
+    }
+
+    while (activeConnections > 0)
+    {
+        int running = 0;
+        CURLMcode multiResult = curl_multi_perform(multiHandle, &running);
+        if (multiResult == CURLM_OK && running > 0)
+        {
+#if CURL_AT_LEAST_VERSION(7, 66, 0)
+            multiResult = curl_multi_poll(multiHandle, nullptr, 0, 1000, nullptr);
+#else
+            // curl_multi_wait returns immediately if no file descriptor is to be waited for, e.g. while resolving a host name
+            int numberOfFds = 0;
+            multiResult = curl_multi_wait(multiHandle, nullptr, 0, 1000, &numberOfFds);
+            if (multiResult == CURLM_OK && numberOfFds == 0)
+            {
+                usleep(10 * 1000);
+            }
+#endif
+        }
+        if (multiResult != CURLM_OK)
+        {
+            logDirectoryTransferError("005", std::string{"error in curl_multi_perform: "} + curl_multi_strerror(multiResult));
+            success = false;
+            break;
+        }
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multiHandle, &queued))
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+            Connection* connection = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &connection);
+            finishUpload(*connection, message->data.result);
+            activeConnections--;
+
+            if (startNextUpload(*connection))
+            {
+                activeConnections++;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < connections.size(); i++)
+    {
+        if (connections[i].upload)
+        {
+            finishUpload(connections[i], CURLE_ABORTED_BY_CALLBACK);
+        }
+        if (i != 0)
+        {
+            curl_easy_cleanup(connections[i].handle);
+        }
+    }
+    curl_multi_cleanup(multiHandle);
+
+    return success && next == uploads.end();
+}
+
 std::string FileUpload::buildUrl(TransferMode mode) const
 {
     std::stringstream oDestination{};
@@ -229,15 +649,21 @@ std::string FileUpload::buildUrl(TransferMode mode) const
     case Protocol::Https:
         oDestination << "https://";
         break;
+    case Protocol::File:
+        oDestination << "file://";
+        break;
     }
-    if (!m_oRemoteUserName.empty())
-    {
-        oDestination << m_oRemoteUserName << "@";
-    }
-    oDestination << "sftp.nonamedummy.com";
-    if (m_port)
+    if (m_protocol != Protocol::File)
     {
-        oDestination << ":" << std::to_string(m_port.value());
+        if (!m_oRemoteUserName.empty())
+        {
+            oDestination << m_oRemoteUserName << "@";
+        }
+        oDestination << "sftp.nonamedummy.com";
+        if (m_port)
+        {
+            oDestination << ":" << std::to_string(m_port.value());
+        }
     }
 
     if (m_oTargetDirectory.rfind("/", 0) == std::string::npos)
@@ -259,26 +685,90 @@ std::string FileUpload::buildUrl(TransferMode mode) const
 
 void FileUpload::initHttpMime(const std::string& fileToSend)
 {
-    if ((m_protocol == Protocol::Http || m_protocol == Protocol::Https) && m_httpMethod == HttpMethod::Post)
+    if (auto mime = createHttpMime(m_pCurlHandle, fileToSend, m_oTargetFileName))
     {
         if (m_mime)
         {
             curl_mime_free(m_mime);
-            m_mime = nullptr;
         }
-        m_mime = curl_mime_init(m_pCurlHandle);
+        m_mime = mime;
 
-        auto field = curl_mime_addpart(m_mime);
+        curl_easy_setopt(m_pCurlHandle, CURLOPT_MIMEPOST, m_mime);
+    }
+}
+
+curl_mime* FileUpload::createHttpMime(CURL* handle, const std::string& fileToSend, const std::string& fileName) const
+{
+    if ((m_protocol == Protocol::Http || m_protocol == Protocol::Https) && m_httpMethod == HttpMethod::Post)
+    {
+        auto mime = curl_mime_init(handle);
+
+        auto field = curl_mime_addpart(mime);
         // TODO: this might need to be adjusted based on what the server expects
         curl_mime_name(field, "fileupload");
         curl_mime_filedata(field, fileToSend.c_str());
-        if (!m_oTargetFileName.empty())
+        if (!fileName.empty())
         {
-            curl_mime_filename(field, m_oTargetFileName.c_str());
+            curl_mime_filename(field, fileName.c_str());
         }
+        return mime;
+    }
+    return nullptr;
+}
 
-        curl_easy_setopt(m_pCurlHandle, CURLOPT_MIMEPOST, m_mime);
+void FileUpload::createLocalTargetDirectory(const std::string& url) const
+{
+    // curl does not create missing directories of file urls
+    static const std::string s_fileScheme{"file://"};
+    if (m_protocol == Protocol::File && url.rfind(s_fileScheme, 0) == 0)
+    {
+        std::error_code oErrorCode;
+        fs::create_directories(fs::path{url.substr(s_fileScheme.length())}.parent_path(), oErrorCode);
+    }
+}
+
+fs::path FileUpload::manifestPath() const
+{
+    if (!m_manifestFile.empty())
+    {
+        return m_manifestFile;
+    }
+    // relative to the source directory, which is the current path during the transfer
+    fs::path directory{m_oDirectoryToSend};
+    if (!directory.has_filename())
+    {
+        directory = directory.parent_path();
+    }
+    const char* baseDir = getenv("WM_BASE_DIR");
+    if (!baseDir)
+    {
+        return directory.parent_path() / ("." + directory.filename().string() + ".transfer");
+    }
+
+    // the source directory might be read only, so the manifests are kept in the state directory of the scheduler,
+    // named by the absolute path of the directory to send (FNV-1a, stable across runs)
+    const std::string absolutePath = fs::absolute(directory).lexically_normal().string();
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : absolutePath)
+    {
+        hash = (hash ^ c) * 1099511628211ull;
     }
+    std::ostringstream fileName;
+    fileName << directory.filename().string() << "-" << std::hex << std::setw(16) << std::setfill('0') << hash << ".transfer";
+
+    const fs::path stateDirectory = fs::path{baseDir} / "data" / "scheduler";
+    std::error_code oErrorCode;
+    fs::create_directories(stateDirectory, oErrorCode);
+    return stateDirectory / fileName.str();
+}
+
+void FileUpload::logDirectoryTransferError(const char* code, const std::string& debugMessage) const
+{
+    std::cerr << debugMessage << std::endl;
+    char oLogMsg[200];
+    sprintf(oLogMsg, "Directory transfer to a remote system has failed (%s)\n", code);
+    precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eError, oLogMsg);
+    precitec::pipeLogger::SendLoggerMessage(m_oWritePipeFd, eDebug, (debugMessage + "\n").c_str());
 }
 
 void FileUpload::PreTransfer(void)
@@ -337,6 +827,7 @@ void FileUpload::PreTransfer(void)
 
         m_oNumberOfTransmittedFiles = 0;
         m_oTotalTransmittedBytes = 0;
+        m_numberOfSkippedFiles = 0;
 
         m_oCurlVersion.assign(curl_version());
         if (m_oDebugFileIsOn)
@@ -361,16 +852,19 @@ void FileUpload::PreTransfer(void)
             curl_easy_setopt(m_pCurlHandle, CURLOPT_VERBOSE, 0L);
         }
 
-        std::string oHostName{};
-        oHostName.assign("sftp.nonamedummy.com:");
-        if (m_port)
+        if (m_protocol != Protocol::File)
         {
-            oHostName.append(std::to_string(m_port.value()));
-            oHostName.append(":");
+            std::string oHostName{};
+            oHostName.assign("sftp.nonamedummy.com:");
+            if (m_port)
+            {
+                oHostName.append(std::to_string(m_port.value()));
+                oHostName.append(":");
+            }
+            oHostName.append(m_oIPAddress);
+            m_pHostList = curl_slist_append(nullptr, oHostName.c_str());
+            curl_easy_setopt(m_pCurlHandle, CURLOPT_RESOLVE, m_pHostList);
         }
-        oHostName.append(m_oIPAddress);
-        m_pHostList = curl_slist_append(nullptr, oHostName.c_str());
-        curl_easy_setopt(m_pCurlHandle, CURLOPT_RESOLVE, m_pHostList);
 
         curl_easy_setopt(m_pCurlHandle, CURLOPT_READFUNCTION, readCallbackFunction); // we want to use our own read function
 
@@ -413,6 +907,10 @@ void FileUpload::PreTransfer(void)
             curl_easy_setopt(m_pCurlHandle, CURLOPT_SSL_VERIFYHOST, 0);
             setupHttpMethod();
         }
+        else if (m_protocol == Protocol::File)
+        {
+            curl_easy_setopt(m_pCurlHandle, CURLOPT_UPLOAD, 1L); // enable uploading
+        }
 
         try
         {
@@ -439,7 +937,9 @@ void FileUpload::PostTransfer(void)
     if (m_pCurlHandle)
     {
         curl_slist_free_all(m_pHostList);
+        m_pHostList = nullptr;
         curl_easy_cleanup(m_pCurlHandle);
+        m_pCurlHandle = nullptr;
     }
 
     try
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <vector>
 
 #include <curl/curl.h>
 #include <optional>
@@ -37,6 +39,8 @@ public:
     uint32_t GetNumberOfTransmittedFiles(void) {return m_oNumberOfTransmittedFiles;}
     uint64_t GetTotalTransmittedBytes(void) {return m_oTotalTransmittedBytes;}
     uint64_t GetDurationOfTransmissionMS(void) {return m_oDurationOfTransmissionMS;}
+    uint32_t GetNumberOfSkippedFiles(void) {return m_numberOfSkippedFiles;}
+    double GetThroughputBytesPerSecond(void) {return m_oDurationOfTransmissionMS == 0 ? 0.0 : m_oTotalTransmittedBytes * 1000.0 / m_oDurationOfTransmissionMS;}
 
     void SetIPAddress(const std::string& p_oIPAddress) {m_oIPAddress.assign(p_oIPAddress);}
     std::string& GetIPAddress(void) {return m_oIPAddress;}
@@ -72,7 +76,8 @@ public:
     {
         Sftp,
         Http,
-        Https
+        Https,
+        File
     };
     void setProtocol(Protocol protocol)
     {
@@ -89,7 +94,39 @@ public:
         m_httpMethod = method;
     }
 
+    /**
+     * Maximum number of files which are uploaded concurrently by UploadDirectory, each over its own connection.
+     * The connections are reused for the following files.
+     **/
+    void setMaxConnections(std::size_t maxConnections)
+    {
+        m_maxConnections = std::max<std::size_t>(maxConnections, 1);
+    }
+
+    /**
+     * Files of UploadDirectory which are smaller than @p size bytes are packed into tar archives (bundle_<n>.tar in the target directory)
+     * instead of being uploaded one by one. 0 disables the bundling.
+     **/
+    void setBundleFilesSmallerThan(std::uintmax_t size)
+    {
+        m_bundleFilesSmallerThan = size;
+    }
+
+    /**
+     * File in which UploadDirectory records the uploaded files. If the transfer is interrupted, the next UploadDirectory of the same directory
+     * to the same destination skips the recorded files. The file is removed when all files are uploaded.
+     * By default the manifest is kept in $WM_BASE_DIR/data/scheduler/ and named after the directory to send and a hash of its absolute path.
+     * Without WM_BASE_DIR it is a hidden file next to the directory to send, which then has to be writable.
+     **/
+    void setManifestFile(const std::string& manifestFile)
+    {
+        m_manifestFile = manifestFile;
+    }
+
 private:
+    struct Upload;
+    class Manifest;
+
     void PreTransfer(void);
     void PostTransfer(void);
 
@@ -100,6 +137,12 @@ private:
     };
     std::string buildUrl(TransferMode mode) const;
     void initHttpMime(const std::string& fileToSend);
+    curl_mime* createHttpMime(CURL* handle, const std::string& fileToSend, const std::string& fileName) const;
+    void createLocalTargetDirectory(const std::string& url) const;
+    fs::path manifestPath() const;
+    bool collectUploads(Manifest& manifest, std::vector<Upload>& uploads);
+    bool transferConcurrently(std::vector<Upload>& uploads, Manifest& manifest);
+    void logDirectoryTransferError(const char* code, const std::string& debugMessage) const;
 
     static size_t readCallbackFunction(char* ptr, size_t size, size_t nmemb, void* stream);
     static int sshCallbackFunction(CURL* easy, const struct curl_khkey* knownkey, const struct curl_khkey* foundkey, enum curl_khmatch khmatch, void* clientp);
@@ -116,6 +159,7 @@ private:
     uint32_t m_oNumberOfTransmittedFiles{};
     uint64_t m_oTotalTransmittedBytes{};
     uint64_t m_oDurationOfTransmissionMS{};
+    uint32_t m_numberOfSkippedFiles{};
 
     std::string m_oIPAddress{"128.0.0.1"};
     std::string m_oRemoteUserName{};
@@ -139,6 +183,10 @@ private:
 
     Protocol m_protocol{Protocol::Sftp};
     HttpMethod m_httpMethod{HttpMethod::Post};
+
+    std::size_t m_maxConnections{4};
+    std::uintmax_t m_bundleFilesSmallerThan{0};
+    std::string m_manifestFile{};
 };
 
 } // namespace scheduler
@@ -41,6 +41,16 @@ std::vector<std::string> TransferDirectoryTaskProcess::processArguments(const in
         processArguments.emplace_back(std::string{"--httpMethod="} + it->second);
     }
 
+    if (auto it = info().find("MaxConnections"); it != info().end())
+    {
+        processArguments.emplace_back(std::string{"--connections="} + it->second);
+    }
+
+    if (auto it = info().find("BundleFilesSmallerThan"); it != info().end())
+    {
+        processArguments.emplace_back(std::string{"--bundleBelow="} + it->second);
+    }
+
     // following argument is optional
     if (info().find("DebugOptionStatus") != info().end())
     {
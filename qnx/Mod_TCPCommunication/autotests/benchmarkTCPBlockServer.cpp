@@ -0,0 +1,198 @@
+#include <QTest>
+
+#include "TCPCommunication/TCPBlockServer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using precitec::tcpcommunication::TCPBlockServer;
+
+class BenchmarkTCPBlockServer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkLatency();
+    void benchmarkThroughput_data();
+    void benchmarkThroughput();
+
+private:
+    std::unique_ptr<TCPBlockServer> m_server;
+    std::thread m_thread;
+};
+
+namespace
+{
+
+// cross section block of the trailing sensor, acknowledged with 8 bytes
+const int16_t BLOCK_SIZE = 1388;
+const std::size_t ACKN_SIZE = 8;
+
+std::vector<char> crossSectionBlock()
+{
+    std::vector<char> ret(BLOCK_SIZE, 1);
+    const int16_t header[4] = {150, 0x100, BLOCK_SIZE, 0};
+    std::memcpy(ret.data(), header, sizeof(header));
+    return ret;
+}
+
+int connectTo(uint16_t port)
+{
+    int desc = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(desc, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+    {
+        close(desc);
+        return -1;
+    }
+    int noDelay = 1;
+    setsockopt(desc, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return desc;
+}
+
+bool sendAll(int desc, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const ssize_t sent = send(desc, data, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool receiveAll(int desc, char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const ssize_t bytes = recv(desc, data, size, 0);
+        if (bytes <= 0)
+        {
+            return false;
+        }
+        data += bytes;
+        size -= bytes;
+    }
+    return true;
+}
+
+// sends the blocks while the acknowledges are received, like a sensor which does not wait for each acknowledge
+bool streamBlocks(int desc, int blockCount)
+{
+    const auto block = crossSectionBlock();
+    bool ok = true;
+    std::thread sender{[&]
+        {
+            for (int i = 0; i < blockCount && ok; i++)
+            {
+                ok = sendAll(desc, block.data(), block.size());
+            }
+        }};
+    std::vector<char> ackn(ACKN_SIZE * blockCount);
+    const bool received = receiveAll(desc, ackn.data(), ackn.size());
+    sender.join();
+    return ok && received;
+}
+
+}
+
+void BenchmarkTCPBlockServer::initTestCase()
+{
+    m_server = std::make_unique<TCPBlockServer>("(Benchmark)",
+        [] (int, char* data, std::vector<char>& reply)
+        {
+            reply.insert(reply.end(), data, data + ACKN_SIZE);
+        });
+    QVERIFY(m_server->listen(0));
+    m_thread = std::thread{[this] { m_server->run(); }};
+}
+
+void BenchmarkTCPBlockServer::cleanupTestCase()
+{
+    m_server->stop();
+    m_thread.join();
+    m_server.reset();
+}
+
+void BenchmarkTCPBlockServer::benchmarkLatency()
+{
+    // round trip of one block and its acknowledge
+    const int client = connectTo(m_server->port());
+    QVERIFY(client != -1);
+    const auto block = crossSectionBlock();
+    char ackn[ACKN_SIZE];
+    bool ok = true;
+    QBENCHMARK
+    {
+        ok = ok && sendAll(client, block.data(), block.size()) && receiveAll(client, ackn, sizeof(ackn));
+    }
+    close(client);
+    QVERIFY(ok);
+}
+
+void BenchmarkTCPBlockServer::benchmarkThroughput_data()
+{
+    QTest::addColumn<int>("clientCount");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("4") << 4;
+    QTest::newRow("16") << 16;
+}
+
+void BenchmarkTCPBlockServer::benchmarkThroughput()
+{
+    QFETCH(int, clientCount);
+    const int blockCount = 10000;
+
+    std::vector<int> clients;
+    for (int i = 0; i < clientCount; i++)
+    {
+        clients.push_back(connectTo(m_server->port()));
+        QVERIFY(clients.back() != -1);
+    }
+
+    std::vector<char> results(clientCount, 0);
+    int iterations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    QBENCHMARK
+    {
+        iterations++;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < clientCount; i++)
+        {
+            threads.emplace_back([&, i] { results[i] = streamBlocks(clients[i], blockCount); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        QVERIFY(results[i]);
+        close(clients[i]);
+    }
+    const double blocks = double(iterations) * clientCount * blockCount;
+    qInfo("%.0f blocks/s, %.1f MB/s", blocks / duration.count(), blocks * BLOCK_SIZE / duration.count() / 1e6);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkTCPBlockServer)
+#include "benchmarkTCPBlockServer.moc"
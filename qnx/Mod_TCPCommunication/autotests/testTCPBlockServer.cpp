@@ -0,0 +1,320 @@
+#include <QTest>
+
+#include "TCPCommunication/TCPBlockServer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using precitec::tcpcommunication::TCPBlockServer;
+
+class TestTCPBlockServer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSegmentation_data();
+    void testSegmentation();
+    void testConcurrentClients();
+    void testInvalidLength();
+};
+
+namespace
+{
+
+// header with type, version, length and reserve followed by a pattern depending on the type
+std::vector<char> block(int16_t type, int16_t length)
+{
+    std::vector<char> ret(length);
+    const int16_t header[4] = {type, 0x100, length, 0};
+    std::memcpy(ret.data(), header, sizeof(header));
+    for (int i = sizeof(header); i < length; i++)
+    {
+        ret[i] = char(type + i);
+    }
+    return ret;
+}
+
+int16_t blockType(const char* data)
+{
+    int16_t type;
+    std::memcpy(&type, data, sizeof(type));
+    return type;
+}
+
+int connectTo(uint16_t port)
+{
+    int desc = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(desc, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+    {
+        close(desc);
+        return -1;
+    }
+    int noDelay = 1;
+    setsockopt(desc, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return desc;
+}
+
+bool sendAll(int desc, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const ssize_t sent = send(desc, data, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// returns the number of received bytes, less than size if the connection was closed
+std::size_t receiveAll(int desc, char* data, std::size_t size)
+{
+    std::size_t received = 0;
+    while (received < size)
+    {
+        const ssize_t bytes = recv(desc, data + received, size - received, 0);
+        if (bytes <= 0)
+        {
+            break;
+        }
+        received += bytes;
+    }
+    return received;
+}
+
+/**
+ * Runs a TCPBlockServer on a free port which answers each block with its header.
+ **/
+class EchoServer
+{
+public:
+    EchoServer()
+        : m_server("(Test)",
+                   [this] (int client, char* data, std::vector<char>& reply)
+                   {
+                       int16_t length;
+                       std::memcpy(&length, data + 4, sizeof(length));
+                       std::lock_guard<std::mutex> lock{m_mutex};
+                       m_blocks.emplace_back(client, std::vector<char>(data, data + length));
+                       if (std::size_t(length) < TCPBlockServer::MIN_BLOCK_BUFFER_SIZE)
+                       {
+                           m_trailingZeros = m_trailingZeros && std::all_of(data + length, data + TCPBlockServer::MIN_BLOCK_BUFFER_SIZE, [] (char c) { return c == 0; });
+                       }
+                       reply.insert(reply.end(), data, data + 8);
+                   },
+                   [this] (int)
+                   {
+                       std::lock_guard<std::mutex> lock{m_mutex};
+                       m_disconnects++;
+                   })
+    {
+        m_listening = m_server.listen(0);
+        if (m_listening)
+        {
+            m_thread = std::thread{[this] { m_server.run(); }};
+        }
+    }
+
+    ~EchoServer()
+    {
+        m_server.stop();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    bool listening() const { return m_listening; }
+    uint16_t port() const { return m_server.port(); }
+
+    std::vector<std::pair<int, std::vector<char>>> blocks()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_blocks;
+    }
+
+    int disconnects()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_disconnects;
+    }
+
+    bool trailingZeros()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_trailingZeros;
+    }
+
+    // the disconnect is handled asynchronously by the event loop
+    bool waitForDisconnects(int count)
+    {
+        for (int i = 0; i < 500 && disconnects() < count; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return disconnects() == count;
+    }
+
+private:
+    TCPBlockServer m_server;
+    bool m_listening = false;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::vector<std::pair<int, std::vector<char>>> m_blocks;
+    int m_disconnects = 0;
+    bool m_trailingZeros = true;
+};
+
+}
+
+void TestTCPBlockServer::testSegmentation_data()
+{
+    QTest::addColumn<int>("segmentSize");
+
+    // byte by byte, within a header, across block boundaries and all blocks at once
+    QTest::newRow("1") << 1;
+    QTest::newRow("5") << 5;
+    QTest::newRow("700") << 700;
+    QTest::newRow("all") << 100000;
+}
+
+void TestTCPBlockServer::testSegmentation()
+{
+    QFETCH(int, segmentSize);
+
+    EchoServer server;
+    QVERIFY(server.listening());
+    QVERIFY(server.port() != 0);
+
+    // cross section block, a seam data block, a block with header only and a block larger than the former fixed buffer
+    const std::vector<std::vector<char>> blocks{block(150, 1388), block(111, 100), block(112, 8), block(113, 3000)};
+    std::vector<char> stream;
+    for (const auto& b : blocks)
+    {
+        stream.insert(stream.end(), b.begin(), b.end());
+    }
+
+    const int client = connectTo(server.port());
+    QVERIFY(client != -1);
+    for (std::size_t offset = 0; offset < stream.size(); offset += segmentSize)
+    {
+        QVERIFY(sendAll(client, stream.data() + offset, std::min<std::size_t>(segmentSize, stream.size() - offset)));
+    }
+
+    std::vector<char> replies(blocks.size() * 8);
+    QCOMPARE(receiveAll(client, replies.data(), replies.size()), replies.size());
+    close(client);
+    QVERIFY(server.waitForDisconnects(1));
+
+    const auto received = server.blocks();
+    QCOMPARE(received.size(), blocks.size());
+    for (std::size_t i = 0; i < blocks.size(); i++)
+    {
+        QVERIFY(received[i].second == blocks[i]);
+        QVERIFY(std::equal(replies.begin() + i * 8, replies.begin() + (i + 1) * 8, blocks[i].begin()));
+    }
+    QVERIFY(server.trailingZeros());
+}
+
+void TestTCPBlockServer::testConcurrentClients()
+{
+    EchoServer server;
+    QVERIFY(server.listening());
+
+    const int clientCount = 8;
+    const int blockCount = 50;
+    std::vector<int> clients;
+    for (int i = 0; i < clientCount; i++)
+    {
+        clients.push_back(connectTo(server.port()));
+        QVERIFY(clients.back() != -1);
+    }
+
+    // the clients send alternately, each block split into two segments
+    for (int n = 0; n < blockCount; n++)
+    {
+        for (int i = 0; i < clientCount; i++)
+        {
+            const auto b = block(int16_t(i), 1388);
+            QVERIFY(sendAll(clients[i], b.data(), 500));
+        }
+        for (int i = 0; i < clientCount; i++)
+        {
+            const auto b = block(int16_t(i), 1388);
+            QVERIFY(sendAll(clients[i], b.data() + 500, b.size() - 500));
+        }
+    }
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        std::vector<char> replies(blockCount * 8);
+        QCOMPARE(receiveAll(clients[i], replies.data(), replies.size()), replies.size());
+        for (int n = 0; n < blockCount; n++)
+        {
+            QCOMPARE(blockType(replies.data() + n * 8), int16_t(i));
+        }
+        close(clients[i]);
+    }
+    QVERIFY(server.waitForDisconnects(clientCount));
+
+    // each connection delivered its own blocks
+    const auto received = server.blocks();
+    QCOMPARE(received.size(), std::size_t(clientCount * blockCount));
+    std::map<int, int16_t> typeOfConnection;
+    for (const auto& b : received)
+    {
+        QVERIFY(b.second == block(blockType(b.second.data()), 1388));
+        auto it = typeOfConnection.emplace(b.first, blockType(b.second.data())).first;
+        QCOMPARE(it->second, blockType(b.second.data()));
+    }
+    QCOMPARE(typeOfConnection.size(), std::size_t(clientCount));
+}
+
+void TestTCPBlockServer::testInvalidLength()
+{
+    EchoServer server;
+    QVERIFY(server.listening());
+
+    const int client = connectTo(server.port());
+    QVERIFY(client != -1);
+
+    // a valid block followed by a length shorter than the header
+    auto stream = block(150, 16);
+    const int16_t invalid[4] = {150, 0x100, 4, 0};
+    stream.insert(stream.end(), (const char*)invalid, (const char*)invalid + sizeof(invalid));
+    QVERIFY(sendAll(client, stream.data(), stream.size()));
+
+    // the server closes the connection after the acknowledge of the valid block
+    char replies[16];
+    QCOMPARE(receiveAll(client, replies, sizeof(replies)), std::size_t(8));
+    close(client);
+    QVERIFY(server.waitForDisconnects(1));
+    QCOMPARE(server.blocks().size(), std::size_t(1));
+
+    // other clients are still served
+    const int otherClient = connectTo(server.port());
+    QVERIFY(otherClient != -1);
+    const auto b = block(151, 20);
+    QVERIFY(sendAll(otherClient, b.data(), b.size()));
+    QCOMPARE(receiveAll(otherClient, replies, 8), std::size_t(8));
+    QCOMPARE(blockType(replies), int16_t(151));
+    close(otherClient);
+}
+
+QTEST_GUILESS_MAIN(TestTCPBlockServer)
+#include "testTCPBlockServer.moc"
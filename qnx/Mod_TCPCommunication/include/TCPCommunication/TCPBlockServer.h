@@ -0,0 +1,106 @@
+/**
+ *  @file
+ *  @copyright  Precitec Vision GmbH & Co. KG
+ *  @brief      Event loop of a TCP/IP server which receives data blocks from several clients
+ */
+
+#pragma once
+
+///////////////////////////////////////////////////////////
+//
+///////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////
+//
+///////////////////////////////////////////////////////////
+
+namespace precitec
+{
+
+namespace tcpcommunication
+{
+
+/**
+ * Server for the data blocks of the SOUVIS6000 protocol.
+ * A data block starts with a header of four int16 values: block type, block version, length of the whole block in bytes and a reserve.
+ *
+ * All clients are served by one epoll event loop with non-blocking sockets. The received bytes are collected per client
+ * until the block is complete according to its length field. Thus a block may be split into several segments and
+ * a segment may contain several blocks.
+ **/
+class TCPBlockServer
+{
+
+public:
+    /**
+     * Called in the event loop for each complete block. The bytes following the block up to MIN_BLOCK_BUFFER_SIZE are 0.
+     * Bytes appended to @p p_rReply are sent to the client.
+     **/
+    typedef std::function<void(int p_oClient, char* p_pBlock, std::vector<char>& p_rReply)> BlockCallback;
+    typedef std::function<void(int p_oClient)> DisconnectCallback;
+
+    static const std::size_t MIN_BLOCK_BUFFER_SIZE = 1500;
+
+    /**
+     * @p p_rLogTag is appended to the log messages, e.g. "(Server)".
+     **/
+    TCPBlockServer(const std::string& p_rLogTag, BlockCallback p_oBlockCallback, DisconnectCallback p_oDisconnectCallback = {});
+    TCPBlockServer(const TCPBlockServer&) = delete;
+    TCPBlockServer& operator=(const TCPBlockServer&) = delete;
+    virtual ~TCPBlockServer(void);
+
+    /**
+     * Binds to @p p_oPort on all interfaces, 0 for any free port. Errors are fatal.
+     **/
+    bool listen(uint16_t p_oPort);
+    uint16_t port(void) const { return m_oPort; }
+
+    /**
+     * Serves the clients until stop is called.
+     **/
+    void run(void);
+
+    /**
+     * Terminates run, may be called from any thread.
+     **/
+    void stop(void);
+
+private:
+    struct Client
+    {
+        std::vector<char> m_oReceived;
+        std::vector<char> m_oToSend;
+        bool m_oWaitingForSend{false};
+    };
+
+    void acceptClients(void);
+    void receive(int p_oClient);
+    bool processBlocks(int p_oClient, Client& p_rClient);
+    void send(int p_oClient, Client& p_rClient);
+    void closeClient(int p_oClient);
+
+    std::string m_oLogTag;
+    BlockCallback m_oBlockCallback;
+    DisconnectCallback m_oDisconnectCallback;
+
+    int m_oListenDesc;
+    int m_oEpollDesc;
+    int m_oStopEventDesc;
+    uint16_t m_oPort;
+    std::atomic<bool> m_oStopped;
+
+    std::map<int, Client> m_oClients;
+    std::vector<char> m_oBlock;
+};
+
+} // namespace tcpcommunication
+
+} // namespace precitec
+
@@ -15,11 +15,13 @@
 #include <stdint.h>
 #include <atomic>
 #include <functional>
+#include <vector>
 
 #include "event/inspectionOut.h"
 #include "event/S6K_InfoFromProcesses.proxy.h"
 
 #include "TCPCommunication/TCPDefinesSRING.h"
+#include "TCPCommunication/TCPBlockServer.h"
 
 ///////////////////////////////////////////////////////////
 //
@@ -93,6 +95,8 @@ private:
 
     void StartTCPServerCrossSectionThread(void);
 
+    void receiveBlock(char *recvBuffer, std::vector<char>& p_rReply);
+
     /****************************************************************************/
 
     void unpackCrossSectionData(char *recvBuffer);
@@ -109,6 +113,9 @@ private:
 
     bool m_oSOUVIS6000_TCPIP_Communication_On;
 
+    TCPBlockServer m_oBlockServer;
+    int32_t m_oBlocksReceived;
+
     /****************************************************************************/
 
     uint32_t m_oProductNo;
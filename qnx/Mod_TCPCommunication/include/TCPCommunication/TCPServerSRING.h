@@ -16,10 +16,13 @@
 #include <stdint.h>
 #include <atomic>
 #include <functional>
+#include <map>
+#include <vector>
 
 #include "common/systemConfiguration.h"
 
 #include "TCPCommunication/TCPDefinesSRING.h"
+#include "TCPCommunication/TCPBlockServer.h"
 
 ///////////////////////////////////////////////////////////
 //
@@ -97,6 +100,9 @@ public:
 private:
     void StartTCPServerThread(void);
 
+    void receiveBlock(int p_oClient, char *recvBuffer, std::vector<char>& p_rReply);
+    void clientDisconnected(int p_oClient);
+
     interface::SOUVIS6000MachineType getSOUVIS6000MachineType(void) { return m_oSOUVIS6000_Machine_Type; }
 
     /****************************************************************************/
@@ -124,6 +130,10 @@ private:
     interface::SOUVIS6000MachineType m_oSOUVIS6000_Machine_Type;
     bool m_oSOUVIS6000_TCPIP_Communication_On;
 
+    TCPBlockServer m_oBlockServer;
+    int32_t m_oBlocksReceived;
+    std::map<int, int16_t> m_oClientsWithNewSeamData; ///< clients and their last block type, the seam data is inserted when the client disconnects
+
     /****************************************************************************/
 
     std::atomic<uint32_t> m_oProductNo;
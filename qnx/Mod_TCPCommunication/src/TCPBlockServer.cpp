@@ -0,0 +1,330 @@
+/**
+ *  @file
+ *  @copyright  Precitec Vision GmbH & Co. KG
+ *  @brief      Event loop of a TCP/IP server which receives data blocks from several clients
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "module/moduleLogger.h"
+
+#include "TCPCommunication/TCPBlockServer.h"
+
+namespace precitec
+{
+
+namespace tcpcommunication
+{
+
+// type, version, length, reserve
+static const int16_t BLOCK_HEADER_SIZE = 8;
+static const int MAX_EPOLL_EVENTS = 16;
+
+const std::size_t TCPBlockServer::MIN_BLOCK_BUFFER_SIZE;
+
+///////////////////////////////////////////////////////////
+// Constructor
+///////////////////////////////////////////////////////////
+
+TCPBlockServer::TCPBlockServer(const std::string& p_rLogTag, BlockCallback p_oBlockCallback, DisconnectCallback p_oDisconnectCallback):
+        m_oLogTag(p_rLogTag),
+        m_oBlockCallback(std::move(p_oBlockCallback)),
+        m_oDisconnectCallback(std::move(p_oDisconnectCallback)),
+        m_oListenDesc(-1),
+        m_oEpollDesc(epoll_create1(EPOLL_CLOEXEC)),
+        m_oStopEventDesc(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+        m_oPort(0),
+        m_oStopped(false)
+{
+    struct epoll_event oEvent{};
+    oEvent.events = EPOLLIN;
+    oEvent.data.fd = m_oStopEventDesc;
+    epoll_ctl(m_oEpollDesc, EPOLL_CTL_ADD, m_oStopEventDesc, &oEvent);
+}
+
+///////////////////////////////////////////////////////////
+// Destructor
+///////////////////////////////////////////////////////////
+
+TCPBlockServer::~TCPBlockServer(void)
+{
+    for (const auto& oClient : m_oClients)
+    {
+        close(oClient.first);
+    }
+    if (m_oListenDesc != -1)
+    {
+        close(m_oListenDesc);
+    }
+    close(m_oStopEventDesc);
+    close(m_oEpollDesc);
+}
+
+bool TCPBlockServer::listen(uint16_t p_oPort)
+{
+    // create socket
+    m_oListenDesc = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_oListenDesc == -1)
+    {
+        wmLog(eDebug, "TCPBlockServer%s: Error while creating socket: %s\n", m_oLogTag.c_str(), strerror(errno));
+        wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", (m_oLogTag + "(201)").c_str());
+        return false;
+    }
+    int oReuseAddress = 1;
+    setsockopt(m_oListenDesc, SOL_SOCKET, SO_REUSEADDR, &oReuseAddress, sizeof(oReuseAddress));
+
+    // bind socket
+    struct sockaddr_in serverAddr;
+    memset((char *)&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    serverAddr.sin_port = htons(p_oPort);
+
+    if (bind(m_oListenDesc, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) == -1)
+    {
+        wmLog(eDebug, "TCPBlockServer%s: Error while binding socket: %s\n", m_oLogTag.c_str(), strerror(errno));
+        wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", (m_oLogTag + "(202)").c_str());
+        return false;
+    }
+
+    // start listening
+    if (::listen(m_oListenDesc, 5) == -1)
+    {
+        wmLog(eDebug, "TCPBlockServer%s: Error while start listening: %s\n", m_oLogTag.c_str(), strerror(errno));
+        wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", (m_oLogTag + "(203)").c_str());
+        return false;
+    }
+
+    socklen_t addrLen = sizeof(serverAddr);
+    getsockname(m_oListenDesc, (struct sockaddr *)&serverAddr, &addrLen);
+    m_oPort = ntohs(serverAddr.sin_port);
+
+    struct epoll_event oEvent{};
+    oEvent.events = EPOLLIN;
+    oEvent.data.fd = m_oListenDesc;
+    epoll_ctl(m_oEpollDesc, EPOLL_CTL_ADD, m_oListenDesc, &oEvent);
+    return true;
+}
+
+void TCPBlockServer::run(void)
+{
+    struct epoll_event oEvents[MAX_EPOLL_EVENTS];
+
+    while (!m_oStopped)
+    {
+        int oEventCount = epoll_wait(m_oEpollDesc, oEvents, MAX_EPOLL_EVENTS, -1);
+        if (oEventCount == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            wmLog(eDebug, "TCPBlockServer%s: Error while waiting for events: %s\n", m_oLogTag.c_str(), strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < oEventCount && !m_oStopped; i++)
+        {
+            const int oDesc = oEvents[i].data.fd;
+            if (oDesc == m_oStopEventDesc)
+            {
+                continue;
+            }
+            if (oDesc == m_oListenDesc)
+            {
+                acceptClients();
+                continue;
+            }
+
+            // the client may have been closed by an earlier event
+            if (oEvents[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+            {
+                receive(oDesc);
+            }
+            if (oEvents[i].events & EPOLLOUT)
+            {
+                if (auto it = m_oClients.find(oDesc); it != m_oClients.end())
+                {
+                    send(oDesc, it->second);
+                }
+            }
+        }
+    }
+}
+
+void TCPBlockServer::stop(void)
+{
+    m_oStopped = true;
+    uint64_t oValue = 1;
+    if (write(m_oStopEventDesc, &oValue, sizeof(oValue)) == -1)
+    {
+        wmLog(eDebug, "TCPBlockServer%s: Error while stopping: %s\n", m_oLogTag.c_str(), strerror(errno));
+    }
+}
+
+void TCPBlockServer::acceptClients(void)
+{
+    while (true)
+    {
+        struct sockaddr_in clientAddr;
+        socklen_t addrLen = sizeof(clientAddr);
+        int oClient = accept4(m_oListenDesc, (struct sockaddr *)&clientAddr, &addrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (oClient == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED)
+            {
+                return;
+            }
+            wmLog(eDebug, "TCPBlockServer%s: Error while accepting connection: %s\n", m_oLogTag.c_str(), strerror(errno));
+            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", (m_oLogTag + "(204)").c_str());
+            return;
+        }
+
+        // the acknowledge is sent immediately
+        int oNoDelay = 1;
+        setsockopt(oClient, IPPROTO_TCP, TCP_NODELAY, &oNoDelay, sizeof(oNoDelay));
+
+        struct epoll_event oEvent{};
+        oEvent.events = EPOLLIN;
+        oEvent.data.fd = oClient;
+        epoll_ctl(m_oEpollDesc, EPOLL_CTL_ADD, oClient, &oEvent);
+        m_oClients[oClient];
+
+        wmLogTr(eInfo, "QnxMsg.VI.TCPCommStarted", "TCP/IP Connection started %s\n", m_oLogTag.c_str());
+    }
+}
+
+void TCPBlockServer::receive(int p_oClient)
+{
+    auto it = m_oClients.find(p_oClient);
+    if (it == m_oClients.end())
+    {
+        return;
+    }
+    Client& rClient = it->second;
+
+    char recvBuffer[4096];
+    while (true)
+    {
+        ssize_t recvBytes = recv(p_oClient, recvBuffer, sizeof(recvBuffer), 0);
+        if (recvBytes > 0)
+        {
+            rClient.m_oReceived.insert(rClient.m_oReceived.end(), recvBuffer, recvBuffer + recvBytes);
+            continue;
+        }
+        if (recvBytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (recvBytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        // connection closed by the client or error, blocks which are already complete are still processed
+        processBlocks(p_oClient, rClient);
+        send(p_oClient, rClient);
+        if (m_oClients.count(p_oClient) != 0)
+        {
+            closeClient(p_oClient);
+        }
+        return;
+    }
+
+    // the acknowledges of the valid blocks are sent before the connection is closed
+    const bool oValid = processBlocks(p_oClient, rClient);
+    send(p_oClient, rClient);
+    if (!oValid && m_oClients.count(p_oClient) != 0)
+    {
+        closeClient(p_oClient);
+    }
+}
+
+bool TCPBlockServer::processBlocks(int p_oClient, Client& p_rClient)
+{
+    std::size_t oOffset = 0;
+    while (p_rClient.m_oReceived.size() - oOffset >= static_cast<std::size_t>(BLOCK_HEADER_SIZE))
+    {
+        int16_t oLength;
+        memcpy(&oLength, &p_rClient.m_oReceived[oOffset + 4], sizeof(oLength));
+        if (oLength < BLOCK_HEADER_SIZE)
+        {
+            wmLog(eWarning, "TCPBlockServer%s: invalid block length %d, connection is closed\n", m_oLogTag.c_str(), oLength);
+            return false;
+        }
+        if (p_rClient.m_oReceived.size() - oOffset < static_cast<std::size_t>(oLength))
+        {
+            break;
+        }
+
+        m_oBlock.assign(p_rClient.m_oReceived.begin() + oOffset, p_rClient.m_oReceived.begin() + oOffset + oLength);
+        if (m_oBlock.size() < MIN_BLOCK_BUFFER_SIZE)
+        {
+            m_oBlock.resize(MIN_BLOCK_BUFFER_SIZE, 0);
+        }
+        m_oBlockCallback(p_oClient, m_oBlock.data(), p_rClient.m_oToSend);
+        oOffset += oLength;
+    }
+    p_rClient.m_oReceived.erase(p_rClient.m_oReceived.begin(), p_rClient.m_oReceived.begin() + oOffset);
+    return true;
+}
+
+void TCPBlockServer::send(int p_oClient, Client& p_rClient)
+{
+    std::size_t oSent = 0;
+    while (oSent < p_rClient.m_oToSend.size())
+    {
+        ssize_t sentBytes = ::send(p_oClient, p_rClient.m_oToSend.data() + oSent, p_rClient.m_oToSend.size() - oSent, MSG_NOSIGNAL);
+        if (sentBytes >= 0)
+        {
+            oSent += sentBytes;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            closeClient(p_oClient);
+            return;
+        }
+    }
+    p_rClient.m_oToSend.erase(p_rClient.m_oToSend.begin(), p_rClient.m_oToSend.begin() + oSent);
+
+    // wait until the socket is writable again if the send buffer is full
+    const bool oWaitForSend = !p_rClient.m_oToSend.empty();
+    if (oWaitForSend != p_rClient.m_oWaitingForSend)
+    {
+        struct epoll_event oEvent{};
+        oEvent.events = oWaitForSend ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        oEvent.data.fd = p_oClient;
+        epoll_ctl(m_oEpollDesc, EPOLL_CTL_MOD, p_oClient, &oEvent);
+        p_rClient.m_oWaitingForSend = oWaitForSend;
+    }
+}
+
+void TCPBlockServer::closeClient(int p_oClient)
+{
+    epoll_ctl(m_oEpollDesc, EPOLL_CTL_DEL, p_oClient, nullptr);
+    close(p_oClient);
+    m_oClients.erase(p_oClient);
+
+    wmLogTr(eInfo, "QnxMsg.VI.TCPCommEnded", "TCP/IP Connection ended %s\n", m_oLogTag.c_str());
+
+    if (m_oDisconnectCallback)
+    {
+        m_oDisconnectCallback(p_oClient);
+    }
+}
+
+} // namespace tcpcommunication
+
+} // namespace precitec
+
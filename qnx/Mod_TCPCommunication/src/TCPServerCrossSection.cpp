@@ -40,6 +40,9 @@ void* TCPServerCrossSectionThread(void *p_pArg);
 TCPServerCrossSection::TCPServerCrossSection(TS6K_InfoFromProcesses<EventProxy>& p_rS6K_InfoFromProcessesProxy):
         m_rS6K_InfoFromProcessesProxy(p_rS6K_InfoFromProcessesProxy),
         m_oTCPServerCrossSectionThread_ID(0),
+        m_oBlockServer("(ServerCrossSection)",
+                       [this] (int, char *recvBuffer, std::vector<char>& p_rReply) { receiveBlock(recvBuffer, p_rReply); }),
+        m_oBlocksReceived(0),
         m_oProductNo(0),
         m_oBatchID(0),
         m_oSeamNo(0),
@@ -64,7 +67,8 @@ TCPServerCrossSection::~TCPServerCrossSection(void)
 {
     if (m_oTCPServerCrossSectionThread_ID != 0)
     {
-        if (pthread_cancel(m_oTCPServerCrossSectionThread_ID) != 0)
+        m_oBlockServer.stop();
+        if (pthread_join(m_oTCPServerCrossSectionThread_ID, nullptr) != 0)
         {
             wmLog(eDebug, "TCPServerCrossSection: was not able to abort thread: %s\n", strerror(errno));
             wmFatal(eBusSystem, "QnxMsg.VI.InitTCPCommFault", "Problem while initializing TCP/IP communication %s\n", "(ServerCrossSection)(201)");
@@ -99,117 +103,51 @@ void TCPServerCrossSection::StartTCPServerCrossSectionThread(void)
 
 int TCPServerCrossSection::run(void)
 {
-    int sockDesc = 0;
-    int actSockDesc;
-    struct sockaddr_in serverAddr;
-    struct sockaddr_in clientAddr;
-    socklen_t addrLen;
-    bool connectOk;
-    char sendBuffer[1500];
-    char recvBuffer[1500];
-    int recvBytes;
-    int32_t blockReceived = 0;
-    int lengthToSend;
-
-    int16_t *type;
-    int16_t *version;
-    int16_t *length;
+    if (!isSOUVIS6000_TCPIP_Communication_On())
+    {
+        return 0;
+    }
 
-    /*************************************************************************/
+    /****** main loop ********************************************************/
 
-    if (isSOUVIS6000_TCPIP_Communication_On())
+    if (m_oBlockServer.listen(CROSS_SECTION_TRAILING_SERVER_PORT))
     {
-        // create socket
-        sockDesc = socket(AF_INET, SOCK_STREAM, 0);
-        if (sockDesc == -1)
-        {
-            wmLog(eDebug, "TCPServerCrossSection: Error while creating socket: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(ServerCrossSection)(201)");
-        }
-
-        // bind socket
-        memset((char *)&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(CROSS_SECTION_TRAILING_SERVER_PORT);
+        m_oBlockServer.run();
+    }
+    return 0;
+}
 
-        if (bind(sockDesc, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) == -1)
-        {
-            wmLog(eDebug, "TCPServerCrossSection: Error while binding socket: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(ServerCrossSection)(202)");
-        }
+/***************************************************************************/
+/* receiveBlock                                                            */
+/***************************************************************************/
 
-        // start listening
-        if (listen(sockDesc, 5) == -1)
-        {
-            wmLog(eDebug, "TCPServerCrossSection: Error while start listening: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(ServerCrossSection)(203)");
-        }
-    }
+void TCPServerCrossSection::receiveBlock(char *recvBuffer, std::vector<char>& p_rReply)
+{
+    char sendBuffer[1500];
+    int lengthToSend;
 
-    /****** main loop ********************************************************/
+    m_oBlocksReceived++;
+    int16_t *type = (int16_t *) &recvBuffer[0];
+    int16_t *version = (int16_t *) &recvBuffer[2];
+    int16_t *length = (int16_t *) &recvBuffer[4];
 
-    while (true)
-    {
-        if (isSOUVIS6000_TCPIP_Communication_On())
-        {
-            addrLen = sizeof(clientAddr);
-            actSockDesc = accept(sockDesc, (struct sockaddr *)&clientAddr, &addrLen);
-            if (actSockDesc == -1)
-            {
-                wmLog(eDebug, "TCPServerCrossSection: Error while accepting connection: %s\n", strerror(errno));
-                wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(ServerCrossSection)(204)");
-            }
-            wmLogTr(eInfo, "QnxMsg.VI.TCPCommStarted", "TCP/IP Connection started %s\n", "(ServerCrossSection)");
-            connectOk = true;
-
-            while (connectOk)
-            {
-                recvBytes = recv(actSockDesc, recvBuffer, sizeof(recvBuffer), 0);
-                if ((recvBytes == 0)||(recvBytes == -1))
-                {
-                    wmLogTr(eInfo, "QnxMsg.VI.TCPCommEnded", "TCP/IP Connection ended %s\n", "(ServerCrossSection)");
-                    connectOk = false;
-                }
-                else
-                {
-                    blockReceived++;
-                    type = (int16_t *) &recvBuffer[0];
-                    version = (int16_t *) &recvBuffer[2];
-                    length = (int16_t *) &recvBuffer[4];
-
-                    char oVersionStrg[21];
-                    sprintf(oVersionStrg, "%X", (int16_t)*version);
-                    wmLog(eDebug,"TCPServerCrossSection: blockType = %d , blockVersion = %s , blockLength = %d\n", (int16_t)*type, oVersionStrg, (int16_t)*length);
-
-                    switch(*type)
-                    {
-                        case DBLOCK_CROSS_SECTION_TYPE:
-                            unpackCrossSectionData(recvBuffer);
-                            break;
-                        default:
-                            wmLogTr(eWarning, "QnxMsg.VI.TCPUnknownBlock", "unknown blocktype via TCP/IP received: %d\n", *type);
-                            break;
-                    }
-
-                    // Acknowledge senden
-                    packAcknBlock(sendBuffer, &lengthToSend, DBLOCK_ACKN_OK, *type, blockReceived);
-                    send(actSockDesc, sendBuffer, lengthToSend, 0);
-                }
-            }
-            close (actSockDesc);
-        }
-        else
-        {
-            usleep(1000*1000);
-        }
-    }          /* end while !quit */
+    char oVersionStrg[21];
+    sprintf(oVersionStrg, "%X", (int16_t)*version);
+    wmLog(eDebug,"TCPServerCrossSection: blockType = %d , blockVersion = %s , blockLength = %d\n", (int16_t)*type, oVersionStrg, (int16_t)*length);
 
-    if (isSOUVIS6000_TCPIP_Communication_On())
+    switch(*type)
     {
-        close (sockDesc);
+        case DBLOCK_CROSS_SECTION_TYPE:
+            unpackCrossSectionData(recvBuffer);
+            break;
+        default:
+            wmLogTr(eWarning, "QnxMsg.VI.TCPUnknownBlock", "unknown blocktype via TCP/IP received: %d\n", *type);
+            break;
     }
-    return 0;
+
+    // Acknowledge senden
+    packAcknBlock(sendBuffer, &lengthToSend, DBLOCK_ACKN_OK, *type, m_oBlocksReceived);
+    p_rReply.insert(p_rReply.end(), sendBuffer, sendBuffer + lengthToSend);
 }
 
 /***************************************************************************/
@@ -44,6 +44,10 @@ TCPServerSRING::TCPServerSRING(void):
         m_oTCPServerThread_ID(0),
         m_oIsSOUVIS6000_Application(false),
         m_oSOUVIS6000_TCPIP_Communication_On(true),
+        m_oBlockServer("(Server)",
+                       [this] (int p_oClient, char *recvBuffer, std::vector<char>& p_rReply) { receiveBlock(p_oClient, recvBuffer, p_rReply); },
+                       [this] (int p_oClient) { clientDisconnected(p_oClient); }),
+        m_oBlocksReceived(0),
         m_oProductNo(0),
         m_oMaxSouvisSpeed(300), // [100mm/min] -> here: 30000 mm/min -> 30 m/min
         m_oSouvisPresent(true),
@@ -71,7 +75,8 @@ TCPServerSRING::~TCPServerSRING(void)
 {
     if (m_oTCPServerThread_ID != 0)
     {
-        if (pthread_cancel(m_oTCPServerThread_ID) != 0)
+        m_oBlockServer.stop();
+        if (pthread_join(m_oTCPServerThread_ID, nullptr) != 0)
         {
             wmLog(eDebug, "TCPServerSRING: was not able to abort thread: %s\n", strerror(errno));
             wmFatal(eBusSystem, "QnxMsg.VI.InitTCPCommFault", "Problem while initializing TCP/IP communication %s\n", "(201)");
@@ -134,180 +139,125 @@ void TCPServerSRING::StartTCPServerThread(void)
 
 int TCPServerSRING::run(void)
 {
-    int sockDesc = 0;
-    int actSockDesc;
-    struct sockaddr_in serverAddr;
-    struct sockaddr_in clientAddr;
-    socklen_t addrLen;
-    bool connectOk;
-    bool newSeamDataReceived;
-    char sendBuffer[1500];
-    char recvBuffer[1500];
-    int recvBytes;
-    int32_t blockReceived = 0;
-    int lengthToSend;
+    if (!m_oSOUVIS6000_TCPIP_Communication_On)
+    {
+        return 0;
+    }
 
-    int16_t *type;
-    int16_t *version;
-    int16_t *length;
+    uint16_t oPort;
+    if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PreInspection", false) == true)
+    {
+        oPort = SOURING_S6K_SERVER_PORT_S1;
+    }
+    else if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PostInspection_Top", false) == true)
+    {
+        oPort = SOURING_S6K_SERVER_PORT_S2U;
+    }
+    else if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PostInspection_Bottom", false) == true)
+    {
+        oPort = SOURING_S6K_SERVER_PORT_S2L;
+    }
+    else
+    {
+        wmLogTr(eError, "QnxMsg.VI.TCPCommNoSubsys", "No subsystem of SOUVIS6000 system is configured !\n");
+        oPort = SOURING_S6K_SERVER_PORT_S1;
+    }
 
-    /*************************************************************************/
+    /****** main loop ********************************************************/
 
-    if (m_oSOUVIS6000_TCPIP_Communication_On)
+    if (m_oBlockServer.listen(oPort))
     {
-        // create socket
-        sockDesc = socket(AF_INET, SOCK_STREAM, 0);
-        if (sockDesc == -1)
-        {
-            wmLog(eDebug, "TCPServerSRING: Error while creating socket: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(201)");
-        }
+        m_oBlockServer.run();
+    }
+    return 0;
+}
 
-        // bind socket
-        memset((char *)&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
+/***************************************************************************/
+/* receiveBlock                                                            */
+/***************************************************************************/
 
-        if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PreInspection", false) == true)
-        {
-            serverAddr.sin_port = htons(SOURING_S6K_SERVER_PORT_S1);
-        }
-        else if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PostInspection_Top", false) == true)
-        {
-            serverAddr.sin_port = htons(SOURING_S6K_SERVER_PORT_S2U);
-        }
-        else if (SystemConfiguration::instance().getBool("SOUVIS6000_Is_PostInspection_Bottom", false) == true)
-        {
-            serverAddr.sin_port = htons(SOURING_S6K_SERVER_PORT_S2L);
-        }
-        else
-        {
-            wmLogTr(eError, "QnxMsg.VI.TCPCommNoSubsys", "No subsystem of SOUVIS6000 system is configured !\n");
-            serverAddr.sin_port = htons(SOURING_S6K_SERVER_PORT_S1);
-        }
+void TCPServerSRING::receiveBlock(int p_oClient, char *recvBuffer, std::vector<char>& p_rReply)
+{
+    char sendBuffer[1500];
+    int lengthToSend;
 
-        if (bind(sockDesc, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) == -1)
-        {
-            wmLog(eDebug, "TCPServerSRING: Error while binding socket: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(202)");
-        }
+    m_oBlocksReceived++;
+    int16_t *type = (int16_t *) &recvBuffer[0];
+    int16_t *version = (int16_t *) &recvBuffer[2];
+    int16_t *length = (int16_t *) &recvBuffer[4];
 
-        // start listening
-        if (listen(sockDesc, 5) == -1)
-        {
-            wmLog(eDebug, "TCPServerSRING: Error while start listening: %s\n", strerror(errno));
-            wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(203)");
-        }
-    }
+    char oVersionStrg[21];
+    sprintf(oVersionStrg, "%X", (int16_t)*version);
+    wmLog(eDebug,"TCPServerSRING: blockType = %d , blockVersion = %s , blockLength = %d\n", (int16_t)*type, oVersionStrg, (int16_t)*length);
 
-    /****** main loop ********************************************************/
-
-    while (true)
+    switch(*type)
     {
-        if (m_oSOUVIS6000_TCPIP_Communication_On)
-        {
-            addrLen = sizeof(clientAddr);
-            actSockDesc = accept(sockDesc, (struct sockaddr *)&clientAddr, &addrLen);
-            if (actSockDesc == -1)
+        case DBLOCK_SRING_GLOBDATA_TYPE:
+            unpackGlobData(recvBuffer);
+            if (m_pTCPCallbackFunction_1)
             {
-                wmLog(eDebug, "TCPServerSRING: Error while accepting connection: %s\n", strerror(errno));
-                wmFatal(eBusSystem, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(204)");
+                m_pTCPCallbackFunction_1(*type);
             }
-            wmLogTr(eInfo, "QnxMsg.VI.TCPCommStarted", "TCP/IP Connection started %s\n", "(Server)");
-            connectOk = true;
-            newSeamDataReceived = false;
-
-            while (connectOk)
-            {
-                recvBytes = recv(actSockDesc, recvBuffer, sizeof(recvBuffer), 0);
-                if ((recvBytes == 0)||(recvBytes == -1))
-                {
-                    wmLogTr(eInfo, "QnxMsg.VI.TCPCommEnded", "TCP/IP Connection ended %s\n", "(Server)");
-                    connectOk = false;
-                    if (newSeamDataReceived)
-                    {
-                        if (m_pTCPCallbackFunction_2)
-                        {
-                            m_pTCPCallbackFunction_2(*type);
-                        }
-
-                        // insert new seamData in product file
-                        wmLog(eDebug, "TCPServerSRING: m_oProductNo: %d\n", m_oProductNo.load());
-                        InsertDataInProductFile();
-
-                        newSeamDataReceived = false;
-                    }
-                }
-                else
-                {
-                    blockReceived++;
-                    type = (int16_t *) &recvBuffer[0];
-                    version = (int16_t *) &recvBuffer[2];
-                    length = (int16_t *) &recvBuffer[4];
+            break;
+        case DBLOCK_SRING_SEAMDATA_1_TYPE:
+        case DBLOCK_SRING_SEAMDATA_2_TYPE:
+        case DBLOCK_SRING_SEAMDATA_3_TYPE:
+        case DBLOCK_SRING_SEAMDATA_4_TYPE:
+        case DBLOCK_SRING_SEAMDATA_5_TYPE:
+        case DBLOCK_SRING_SEAMDATA_6_TYPE:
+        case DBLOCK_SRING_SEAMDATA_7_TYPE:
+        case DBLOCK_SRING_SEAMDATA_8_TYPE:
+        case DBLOCK_SRING_SEAMDATA_9_TYPE:
+        case DBLOCK_SRING_SEAMDATA_10_TYPE:
+        case DBLOCK_SRING_SEAMDATA_11_TYPE:
+        case DBLOCK_SRING_SEAMDATA_12_TYPE:
+        case DBLOCK_SRING_SEAMDATA_13_TYPE:
+        case DBLOCK_SRING_SEAMDATA_14_TYPE:
+        case DBLOCK_SRING_SEAMDATA_15_TYPE:
+        case DBLOCK_SRING_SEAMDATA_16_TYPE:
+        case DBLOCK_SRING_SEAMDATA_17_TYPE:
+        case DBLOCK_SRING_SEAMDATA_18_TYPE:
+        case DBLOCK_SRING_SEAMDATA_19_TYPE:
+        case DBLOCK_SRING_SEAMDATA_20_TYPE:
+        case DBLOCK_SRING_SEAMDATA_21_TYPE:
+        case DBLOCK_SRING_SEAMDATA_22_TYPE:
+        case DBLOCK_SRING_SEAMDATA_23_TYPE:
+        case DBLOCK_SRING_SEAMDATA_24_TYPE:
+            unpackSeamData(recvBuffer, (*type - DBLOCK_SRING_SEAMDATA_1_TYPE));
+            m_oClientsWithNewSeamData[p_oClient] = *type;
+            break;
+        default:
+            wmLogTr(eWarning, "QnxMsg.VI.TCPUnknownBlock", "unknown blocktype via TCP/IP received: %d\n", *type);
+            break;
+    }
 
-                    char oVersionStrg[21];
-                    sprintf(oVersionStrg, "%X", (int16_t)*version);
-                    wmLog(eDebug,"TCPServerSRING: blockType = %d , blockVersion = %s , blockLength = %d\n", (int16_t)*type, oVersionStrg, (int16_t)*length);
+    // Acknowledge senden
+    packAcknBlock(sendBuffer, &lengthToSend, DBLOCK_ACKN_OK, *type, m_oBlocksReceived);
+    p_rReply.insert(p_rReply.end(), sendBuffer, sendBuffer + lengthToSend);
+}
 
-                    switch(*type)
-                    {
-                        case DBLOCK_SRING_GLOBDATA_TYPE:
-                            unpackGlobData(recvBuffer);
-                            if (m_pTCPCallbackFunction_1)
-                            {
-                                m_pTCPCallbackFunction_1(*type);
-                            }
-                            break;
-                        case DBLOCK_SRING_SEAMDATA_1_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_2_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_3_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_4_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_5_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_6_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_7_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_8_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_9_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_10_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_11_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_12_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_13_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_14_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_15_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_16_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_17_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_18_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_19_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_20_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_21_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_22_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_23_TYPE:
-                        case DBLOCK_SRING_SEAMDATA_24_TYPE:
-                            unpackSeamData(recvBuffer, (*type - DBLOCK_SRING_SEAMDATA_1_TYPE));
-                            newSeamDataReceived = true;
-                            break;
-                        default:
-                            wmLogTr(eWarning, "QnxMsg.VI.TCPUnknownBlock", "unknown blocktype via TCP/IP received: %d\n", *type);
-                            break;
-                    }
+/***************************************************************************/
+/* clientDisconnected                                                      */
+/***************************************************************************/
 
-                    // Acknowledge senden
-                    packAcknBlock(sendBuffer, &lengthToSend, DBLOCK_ACKN_OK, *type, blockReceived);
-                    send(actSockDesc, sendBuffer, lengthToSend, 0);
-                }
-            }
-            close (actSockDesc);
-        }
-        else
-        {
-            usleep(1000*1000);
-        }
-    }          /* end while !quit */
+void TCPServerSRING::clientDisconnected(int p_oClient)
+{
+    auto it = m_oClientsWithNewSeamData.find(p_oClient);
+    if (it == m_oClientsWithNewSeamData.end())
+    {
+        return;
+    }
+    const int16_t oLastBlockType = it->second;
+    m_oClientsWithNewSeamData.erase(it);
 
-    if (m_oSOUVIS6000_TCPIP_Communication_On)
+    if (m_pTCPCallbackFunction_2)
     {
-        close (sockDesc);
+        m_pTCPCallbackFunction_2(oLastBlockType);
     }
-    return 0;
+
+    // insert new seamData in product file
+    wmLog(eDebug, "TCPServerSRING: m_oProductNo: %d\n", m_oProductNo.load());
+    InsertDataInProductFile();
 }
 
 int TCPServerSRING::TestDataInsert(void)
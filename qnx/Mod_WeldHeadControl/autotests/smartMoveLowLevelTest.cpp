@@ -0,0 +1,450 @@
+#include <QTest>
+#include <QTemporaryFile>
+
+#include "../include/viWeldHead/Scanlab/smartMoveLowLevel.h"
+#include "common/systemConfiguration.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using precitec::hardware::SmartMoveLowLevel;
+using precitec::hardware::SmartMoveReplyParser;
+using precitec::interface::SystemConfiguration;
+
+namespace
+{
+
+/**
+ * Minimal SmartMove server: every line is answered after a latency with the echo of the line
+ * followed by the prompt. The answers are queued, so the client can send ahead of the replies.
+ * An upload with "U 101" is answered with the result "0".
+ **/
+class MockSmartMoveServer
+{
+public:
+    MockSmartMoveServer(std::chrono::microseconds latency = std::chrono::microseconds{0})
+        : m_latency(latency)
+    {
+        m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int enable = 1;
+        setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(m_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        getsockname(m_listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+        m_port = ntohs(address.sin_port);
+        listen(m_listenSocket, 1);
+        m_thread = std::thread{&MockSmartMoveServer::run, this};
+    }
+
+    ~MockSmartMoveServer()
+    {
+        m_stop = true;
+        m_thread.join();
+        close(m_listenSocket);
+    }
+
+    uint16_t port() const
+    {
+        return m_port;
+    }
+
+    // the first line of the reply to @p command
+    void setAnswer(const std::string& command, const std::string& answer)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_answers[command] = answer;
+    }
+
+    // @p command is not answered at all
+    void setSilent(const std::string& command)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_silent.insert(command);
+    }
+
+    // the reply to @p command and all following replies are delayed by @p delay
+    void setDelay(const std::string& command, std::chrono::microseconds delay)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_delays[command] = delay;
+    }
+
+    std::vector<std::string> receivedCommands() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_received;
+    }
+
+    std::size_t maxOutstandingReplies() const
+    {
+        return m_maxOutstanding;
+    }
+
+    std::vector<uint8_t> uploadedData() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_uploadedData;
+    }
+
+private:
+    void run()
+    {
+        int client = -1;
+        std::string input;
+        std::size_t uploadSize = 0;
+        bool upload = false;
+        while (!m_stop)
+        {
+            pollfd pollDescriptor{client == -1 ? m_listenSocket : client, POLLIN, 0};
+            int waitTime = 5;
+            if (!m_replies.empty())
+            {
+                const auto due = std::chrono::duration_cast<std::chrono::milliseconds>(m_replies.front().first - std::chrono::steady_clock::now());
+                waitTime = std::max(0, std::min(waitTime, int(due.count())));
+            }
+            if (poll(&pollDescriptor, 1, waitTime) > 0)
+            {
+                if (client == -1)
+                {
+                    client = accept(m_listenSocket, nullptr, nullptr);
+                    int noDelay = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                    continue;
+                }
+                char buffer[4096];
+                const auto bytesRead = recv(client, buffer, sizeof(buffer), 0);
+                if (bytesRead <= 0)
+                {
+                    close(client);
+                    client = -1;
+                    input.clear();
+                    continue;
+                }
+                input.append(buffer, bytesRead);
+            }
+            while (true)
+            {
+                if (upload)
+                {
+                    // header 0x42, 1, size with 4 bytes, crc with 2 bytes
+                    if (uploadSize == 0 && input.size() >= 8)
+                    {
+                        uploadSize = (uint8_t(input[2]) << 24) | (uint8_t(input[3]) << 16) | (uint8_t(input[4]) << 8) | uint8_t(input[5]);
+                    }
+                    if (uploadSize == 0 || input.size() < 8 + uploadSize)
+                    {
+                        break;
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock{m_mutex};
+                        m_uploadedData.assign(input.begin() + 8, input.begin() + 8 + uploadSize);
+                    }
+                    input.erase(0, 8 + uploadSize);
+                    upload = false;
+                    queueReply("U 101\r\n0\r\n>");
+                    continue;
+                }
+                const auto end = input.find("\r\n");
+                if (end == std::string::npos)
+                {
+                    break;
+                }
+                const auto command = input.substr(0, end);
+                input.erase(0, end + 2);
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_received.push_back(command);
+                if (command == "U 101")
+                {
+                    upload = true;
+                    uploadSize = 0;
+                    continue;
+                }
+                if (m_silent.count(command))
+                {
+                    continue;
+                }
+                const auto answer = m_answers.find(command);
+                const auto delay = m_delays.find(command);
+                queueReply((answer == m_answers.end() ? command : answer->second) + "\r\n>", delay == m_delays.end() ? std::chrono::microseconds{0} : delay->second);
+            }
+            m_maxOutstanding = std::max(m_maxOutstanding.load(), m_replies.size());
+            while (client != -1 && !m_replies.empty() && m_replies.front().first <= std::chrono::steady_clock::now())
+            {
+                send(client, m_replies.front().second.data(), m_replies.front().second.size(), MSG_NOSIGNAL);
+                m_replies.pop_front();
+            }
+        }
+        if (client != -1)
+        {
+            close(client);
+        }
+    }
+
+    void queueReply(const std::string& reply, std::chrono::microseconds delay = std::chrono::microseconds{0})
+    {
+        // the latency is the round trip time, the replies keep the order of the commands
+        auto due = std::chrono::steady_clock::now() + m_latency + delay;
+        if (!m_replies.empty())
+        {
+            due = std::max(due, m_replies.back().first);
+        }
+        m_replies.emplace_back(due, reply);
+    }
+
+    const std::chrono::microseconds m_latency;
+    int m_listenSocket = -1;
+    uint16_t m_port = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::string> m_answers;
+    std::set<std::string> m_silent;
+    std::map<std::string, std::chrono::microseconds> m_delays;
+    std::vector<std::string> m_received;
+
+    std::deque<std::pair<std::chrono::steady_clock::time_point, std::string>> m_replies;
+    std::atomic<std::size_t> m_maxOutstanding{0};
+    std::vector<uint8_t> m_uploadedData;
+};
+
+std::vector<std::string> alignmentCommands(int count)
+{
+    std::vector<std::string> commands;
+    for (int i = 0; i < count; i++)
+    {
+        commands.push_back("S AL_X " + std::to_string(i));
+    }
+    return commands;
+}
+
+}
+
+class SmartMoveLowLevelTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testReplyParser();
+    void testReplyParserOverflow();
+    void testSendCommands();
+    void testSendCommandsRejected();
+    void testExchangeCommands();
+    void testNoReply();
+    void testLateReply();
+    void testPipeliningRate();
+    void testTransmitFileBTX();
+};
+
+void SmartMoveLowLevelTest::initTestCase()
+{
+    SystemConfiguration::instance().set(SystemConfiguration::StringKey::Scanner2DController_IP_Address, std::string{"127.0.0.1"});
+}
+
+void SmartMoveLowLevelTest::testReplyParser()
+{
+    SmartMoveReplyParser parser;
+    QVERIFY(!parser.takeReply());
+
+    parser.append("S AL_X 1\r", 9);
+    QVERIFY(!parser.takeReply());
+    parser.append("\n>S AL_Y", 8);
+    QCOMPARE(parser.takeReply().value(), std::string{"S AL_X 1\r\n"});
+    QVERIFY(!parser.takeReply());
+    parser.append(" 2\r\n>G SYS_TS\r\n>", 16);
+    QCOMPARE(parser.takeReply().value(), std::string{"S AL_Y 2\r\n"});
+    QCOMPARE(parser.takeReply().value(), std::string{"G SYS_TS\r\n"});
+    QVERIFY(!parser.takeReply());
+    QVERIFY(!parser.overflow());
+
+    parser.append("rest", 4);
+    parser.clear();
+    parser.append(">", 1);
+    QCOMPARE(parser.takeReply().value(), std::string{});
+}
+
+void SmartMoveLowLevelTest::testReplyParserOverflow()
+{
+    SmartMoveReplyParser parser;
+    const std::string data(2000, 'a');
+    parser.append(data.data(), data.size());
+    QVERIFY(!parser.takeReply());
+    QVERIFY(parser.overflow());
+}
+
+void SmartMoveLowLevelTest::testSendCommands()
+{
+    MockSmartMoveServer server;
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+    QVERIFY(lowLevel.isTCPConnectionOpen());
+
+    const auto commands = alignmentCommands(40);
+    const auto acknowledged = lowLevel.sendCommands(commands);
+    QCOMPARE(acknowledged, std::vector<bool>(40, true));
+
+    // the two synchronization lines of the connect are followed by the commands in order
+    auto received = server.receivedCommands();
+    QCOMPARE(received.size(), 42u);
+    QCOMPARE(received.front(), std::string{});
+    received.erase(received.begin(), received.begin() + 2);
+    QCOMPARE(received, commands);
+    QVERIFY(server.maxOutstandingReplies() <= lowLevel.maxOutstandingCommands());
+
+    // empty commands are not sent
+    const auto withEmpty = lowLevel.sendCommands({"S AL_X 1", "", "S AL_Y 2"});
+    QCOMPARE(withEmpty, (std::vector<bool>{true, false, true}));
+    QCOMPARE(server.receivedCommands().size(), 44u);
+
+    lowLevel.closeTcpConnection();
+    QVERIFY(!lowLevel.isTCPConnectionOpen());
+}
+
+void SmartMoveLowLevelTest::testSendCommandsRejected()
+{
+    MockSmartMoveServer server;
+    server.setAnswer("S AL_X 99999999", "?Parameter");
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    const auto acknowledged = lowLevel.sendCommands({"S SYS_OP_MODE 2", "S AL_X 99999999", "S AL_Y 0"});
+    QCOMPARE(acknowledged, (std::vector<bool>{true, false, true}));
+}
+
+void SmartMoveLowLevelTest::testExchangeCommands()
+{
+    MockSmartMoveServer server;
+    server.setAnswer("G INT_SC_READY", "1");
+    server.setAnswer("G INT_PRINT_READY", "0");
+    server.setAnswer("G SYS_TS", "0.00001");
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    const auto replies = lowLevel.exchangeCommands({"G INT_SC_READY", "G INT_PRINT_READY", "G SYS_TS"}, 100'000);
+    QCOMPARE(replies.size(), 3u);
+    QCOMPARE(replies.at(0).value(), std::string{"1"});
+    QCOMPARE(replies.at(1).value(), std::string{"0"});
+    QCOMPARE(replies.at(2).value(), std::string{"0.00001"});
+
+    QVERIFY(lowLevel.scannerReady());
+    QVERIFY(!lowLevel.printReady());
+    QCOMPARE(lowLevel.sendGetSysTs("G SYS_TS").value(), 0.00001);
+}
+
+void SmartMoveLowLevelTest::testNoReply()
+{
+    MockSmartMoveServer server;
+    server.setSilent("G HP_VECCNT");
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    const auto replies = lowLevel.exchangeCommands({"G RSI_USTAT", "G HP_VECCNT"}, 100'000);
+    QCOMPARE(replies.size(), 2u);
+    QCOMPARE(replies.at(0).value(), std::string{"G RSI_USTAT"});
+    QVERIFY(!replies.at(1));
+
+    // the connection is still usable after the timeout
+    QCOMPARE(lowLevel.sendCommands({"S AL_X 1"}), std::vector<bool>{true});
+}
+
+void SmartMoveLowLevelTest::testLateReply()
+{
+    MockSmartMoveServer server;
+    server.setAnswer("G INT_SC_READY", "1");
+    server.setDelay("G HP_VECCNT", std::chrono::microseconds{250'000});
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    // the replies to the second and third command arrive after the timeout
+    const auto replies = lowLevel.exchangeCommands({"G RSI_USTAT", "G HP_VECCNT", "G SYS_TS"}, 100'000);
+    QCOMPARE(replies.size(), 3u);
+    QCOMPARE(replies.at(0).value(), std::string{"G RSI_USTAT"});
+    QVERIFY(!replies.at(1));
+    QVERIFY(!replies.at(2));
+
+    // the late replies are not taken as replies to the next commands
+    QCOMPARE(lowLevel.sendCommands({"S AL_X 1", "S AL_Y 2"}), (std::vector<bool>{true, true}));
+    QVERIFY(lowLevel.scannerReady());
+    const auto nextReplies = lowLevel.exchangeCommands({"G RSI_USTAT"}, 100'000);
+    QCOMPARE(nextReplies.at(0).value(), std::string{"G RSI_USTAT"});
+}
+
+void SmartMoveLowLevelTest::testPipeliningRate()
+{
+    MockSmartMoveServer server{std::chrono::microseconds{2000}};
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    const auto commands = alignmentCommands(50);
+    std::vector<bool> acknowledged;
+    const auto measure = [&] (std::size_t maxOutstandingCommands)
+    {
+        lowLevel.setMaxOutstandingCommands(maxOutstandingCommands);
+        const auto start = std::chrono::steady_clock::now();
+        acknowledged = lowLevel.sendCommands(commands);
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return commands.size() / duration;
+    };
+
+    const auto sequentialRate = measure(1);
+    QCOMPARE(acknowledged, std::vector<bool>(commands.size(), true));
+    const auto pipelinedRate = measure(16);
+    QCOMPARE(acknowledged, std::vector<bool>(commands.size(), true));
+    qDebug() << "commands per second, sequential:" << sequentialRate << "pipelined:" << pipelinedRate;
+    QVERIFY(pipelinedRate > 2 * sequentialRate);
+
+    lowLevel.setMaxOutstandingCommands(0);
+    QCOMPARE(lowLevel.maxOutstandingCommands(), 1u);
+}
+
+void SmartMoveLowLevelTest::testTransmitFileBTX()
+{
+    MockSmartMoveServer server;
+    SmartMoveLowLevel lowLevel;
+    lowLevel.setServerPort(server.port());
+    QCOMPARE(lowLevel.openTcpConnection(), 0);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QByteArray content;
+    for (int i = 0; i < 10000; i++)
+    {
+        content.append(char(i * 7));
+    }
+    file.write(content);
+    file.flush();
+
+    const auto fileDescriptor = lowLevel.openFile(file.fileName().toStdString());
+    QVERIFY(fileDescriptor >= 0);
+    std::string answer;
+    QCOMPARE(lowLevel.transmitMarkingFileBTX(fileDescriptor, answer), 0);
+    lowLevel.closeFile(fileDescriptor);
+
+    QCOMPARE(answer, std::string{"0"});
+    QCOMPARE(server.uploadedData(), std::vector<uint8_t>(content.begin(), content.end()));
+}
+
+QTEST_GUILESS_MAIN(SmartMoveLowLevelTest)
+#include "smartMoveLowLevelTest.moc"
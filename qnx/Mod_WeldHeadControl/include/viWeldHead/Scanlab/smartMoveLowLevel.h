@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <optional>
+#include <vector>
 #include "common/definesSmartMove.h"
 
 namespace precitec
@@ -54,6 +56,32 @@ typedef struct
 }
 XmodemParameter;
 
+/**
+ * Splits the data received from the SmartMove into replies.
+ * Each reply is terminated by the prompt '>', data can be appended in arbitrary chunks.
+ **/
+class SmartMoveReplyParser
+{
+public:
+    void append(const char* data, std::size_t size);
+
+    /**
+     * @returns the next complete reply without the prompt, if one was received.
+     **/
+    std::optional<std::string> takeReply();
+
+    /**
+     * @returns whether the data received so far doesn't contain a prompt, although it exceeds the maximum reply length.
+     **/
+    bool overflow() const;
+
+    void clear();
+
+private:
+    std::string m_buffer;
+    std::size_t m_searchStart{0};
+};
+
 class SmartMoveLowLevel
 {
 
@@ -130,12 +158,66 @@ public:
 
     bool sendCommand(const std::string& command, const std::string& errorLogMessage);
 
+    /**
+     * Sends all @p commands without waiting for the reply of the previous command.
+     * At most maxOutstandingCommands commands are sent ahead of the replies, the replies are matched to
+     * the commands in order. @p timeout in microseconds applies to each reply.
+     *
+     * @returns the first line of the reply to each command, an empty optional if no reply arrived in time.
+     **/
+    std::vector<std::optional<std::string>> exchangeCommands(const std::vector<std::string>& commands, int timeout);
+
+    /**
+     * Sends all @p commands pipelined, see exchangeCommands.
+     *
+     * @returns for each command whether it was acknowledged by its echo.
+     **/
+    std::vector<bool> sendCommands(const std::vector<std::string>& commands);
+
+    /**
+     * Number of commands which are sent ahead of the replies, 1 disables pipelining.
+     **/
+    void setMaxOutstandingCommands(std::size_t maxOutstandingCommands)
+    {
+        m_maxOutstandingCommands = std::max(maxOutstandingCommands, std::size_t{1});
+    }
+
+    std::size_t maxOutstandingCommands() const
+    {
+        return m_maxOutstandingCommands;
+    }
+
+    /**
+     * Port of the SmartMove server, defaults to the port of the marking engine.
+     **/
+    void setServerPort(uint16_t port)
+    {
+        m_scanner2DControllerServerPort = port;
+    }
+
 private:
     int convertAnswerToNumber(const std::string& answer, const std::string& errorLogMessage);
 
     int readMEParameter(const std::string& command, std::string& answer, int timeout);
     int setMEParameter(const std::string& command, std::string& answer, int timeout);
-    int readToPrompt(char* answer, size_t maxlen, size_t *nread, int timeout);
+    /**
+     * Sends the @p commands pipelined and stores the first line of each reply in @p replies.
+     *
+     * @returns 0 on success, -1 if sending failed and -2 if a reply is missing.
+     **/
+    int exchange(const std::vector<std::string>& commands, std::vector<std::optional<std::string>>& replies, int timeout);
+    /**
+     * Waits up to @p timeout microseconds for the next reply.
+     **/
+    std::optional<std::string> readReply(int timeout);
+    bool receive(int timeout);
+    bool sendAll(const void* data, std::size_t size);
+    /**
+     * Reads and drops the replies to the commands which were still in flight when a reply timed out,
+     * thus later replies are matched to the right commands.
+     **/
+    void discardLateReplies();
+    void flushInput();
 
     int transmitFileXModem(const std::string& command, int fileDescriptor, std::string& answer);
     int transmitFileBTX(const std::string& command, int fileDescriptor, std::string& answer);
@@ -152,9 +234,12 @@ private:
 
     std::string m_scanner2DControllerIpAddress{"192.168.170.105"};
     uint32_t m_scanner2DControllerIpAddressNetwork{0x69AAA8C0};
-    const uint16_t m_scanner2DControllerServerPort{10001};
+    uint16_t m_scanner2DControllerServerPort{10001};
 
     int m_sockDesc{-1};
+    SmartMoveReplyParser m_replyParser;
+    std::size_t m_maxOutstandingCommands{16};
+    std::size_t m_unansweredCommands{0};
     XmodemStatus m_xmodemStatus{XMODEM_STATUS_NOINIT};
     int m_xmodemPacketBuf[XMODEM_BUFSIZE_EXTENDED]{};
     int m_xmodemPacketNo{};
@@ -235,11 +235,13 @@ void SmartMoveControl::startJob(JobRepeats repeatMode)
         return;
     }
 
-    if (!static_cast<bool>(m_networkInterface.sendSystemOperationMode(globalCommands.front())))
+    // both commands are sent without waiting for the first reply
+    const auto acknowledged = m_networkInterface.sendCommands(globalCommands);
+    if (!acknowledged.front())
     {
         wmLog(eError, "Start job failed, switching to Marking System operation failed!\n");
     }
-    if (!static_cast<bool>(m_networkInterface.processJob(globalCommands.back())))
+    if (!acknowledged.back())
     {
         wmLog(eError, "Start job failed!\n");
     }
@@ -276,20 +278,21 @@ void SmartMoveControl::scannerDriveToPositionBits(std::pair<unsigned int, unsign
         return;
     }
 
-    //TODO Maybe use "Multi-Set" for faster sending --> Is implemented in smartMoveGlobalInterpreter but isn't used --> The check if sending the command is successful should behave as already.
-    if (!m_networkInterface.sendSystemOperationMode(globalCommands.front()))
+    // the commands are pipelined, each one is still checked by its own reply
+    const auto acknowledged = m_networkInterface.sendCommands(globalCommands);
+    if (!acknowledged.front())
     {
         wmLog(eError, "Send system operation mode failed\n");
     }
-    if (!m_networkInterface.sendInputMode(globalCommands.at(1)))
+    if (!acknowledged.at(1))
     {
         wmLog(eError, "Send input mode failed\n");
     }
-    if (!m_networkInterface.sendAlignX(globalCommands.at(2)))
+    if (!acknowledged.at(2))
     {
         wmLog(eError, "Send align X failed\n");
     }
-    if (!m_networkInterface.sendAlignY(globalCommands.back()))
+    if (!acknowledged.back())
     {
         wmLog(eError, "Send align Y failed\n");
     }
@@ -7,6 +7,7 @@
  */
 
 #include <unistd.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -32,6 +33,73 @@ const int ANSWER_BUFFER_LEN{1000};
 const int MCI_TIMEOUT_SYMBOL{100'000}; // 100ms
 const int MCI_TIMEOUT_SYMBOLLIST{2'000'000}; // 2s
 const int XMODEM_RXTIMEOUT{10'000'000}; // 10s
+const int MCI_TIMEOUT_SYNC{10'000}; // 10ms
+const int MCI_TIMEOUT_RESET{5'000'000}; // 5s
+const int MCI_TIMEOUT_LATE_REPLY{1'000'000}; // 1s
+
+namespace
+{
+
+std::string firstLine(const std::string& reply)
+{
+    return reply.substr(0, reply.find("\r\n"));
+}
+
+std::string secondLine(const std::string& reply)
+{
+    const auto first = reply.find("\r\n");
+    if (first == std::string::npos)
+    {
+        return {};
+    }
+    const auto start = first + strlen("\r\n");
+    return reply.substr(start, reply.find("\r\n", start) - start);
+}
+
+void logExchangeError(int returnValue, const char* sendErrorCode, const char* receiveErrorCode)
+{
+    if (returnValue == -1)
+    {
+        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", sendErrorCode);
+    }
+    else if (returnValue == -2)
+    {
+        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", receiveErrorCode);
+    }
+}
+
+}
+
+void SmartMoveReplyParser::append(const char* data, std::size_t size)
+{
+    m_buffer.append(data, size);
+}
+
+std::optional<std::string> SmartMoveReplyParser::takeReply()
+{
+    // only search the data appended since the last call
+    const auto prompt = m_buffer.find('>', m_searchStart);
+    if (prompt == std::string::npos)
+    {
+        m_searchStart = m_buffer.size();
+        return {};
+    }
+    auto reply = m_buffer.substr(0, prompt);
+    m_buffer.erase(0, prompt + 1);
+    m_searchStart = 0;
+    return reply;
+}
+
+bool SmartMoveReplyParser::overflow() const
+{
+    return m_searchStart >= ANSWER_BUFFER_LEN;
+}
+
+void SmartMoveReplyParser::clear()
+{
+    m_buffer.clear();
+    m_searchStart = 0;
+}
 
 SmartMoveLowLevel::SmartMoveLowLevel(void)
 {
@@ -99,40 +167,37 @@ int SmartMoveLowLevel::openTcpConnection(void)
         {
             wmLogTr(eWarning, "QnxMsg.VI.TCPCommNoConn", "connection to server not possible %s\n", "(001)");
             close (m_sockDesc);
-            sleep(2);
+            m_sockDesc = -1;
             return -1;
         }
         else if (errno == ETIMEDOUT)
         {
             wmLogTr(eWarning, "QnxMsg.VI.TCPCommNoConn", "connection to server not possible %s\n", "(002)");
             close (m_sockDesc);
+            m_sockDesc = -1;
             return -1;
         }
         else
         {
             wmLog(eDebug, "SmartMoveLowLevel: Error while connecting server: %s\n", strerror(errno));
             close (m_sockDesc);
+            m_sockDesc = -1;
             wmFatal(eExtEquipment, "QnxMsg.VI.InitTCPCommFault", "Problem while initializing TCP/IP communication %s\n", "(103)");
             return -1;
         }
     }
     wmLogTr(eInfo, "QnxMsg.VI.TCPCommStarted", "TCP/IP Connection started %s\n", "(MarkingEngine)");
 
-    /* flush input */
-    int loop{0};
-    char buffer[ANSWER_BUFFER_LEN + 1];
-    while (recv(m_sockDesc, buffer, ANSWER_BUFFER_LEN, 0) > 0)
+    flushInput();
+    m_unansweredCommands = 0;
+
+    /* send empty lines for syncronization, prompts which arrive later belong to data sent before the connect */
+    std::vector<std::optional<std::string>> replies;
+    logExchangeError(exchange({"", ""}, replies, MCI_TIMEOUT_SYMBOL), "(103)", "(104)");
+    while (readReply(MCI_TIMEOUT_SYNC))
     {
-        loop++;
     }
 
-    std::string answer{};
-    /* send an empty line for syncronization */
-    setMEParameter("", answer, MCI_TIMEOUT_SYMBOL);
-    usleep(10 * 1000);
-    setMEParameter("", answer, MCI_TIMEOUT_SYMBOL);
-    usleep(10 * 1000);
-
     return 0;
 }
 
@@ -140,6 +205,8 @@ void SmartMoveLowLevel::closeTcpConnection(void)
 {
     close(m_sockDesc);
     m_sockDesc = -1;
+    m_replyParser.clear();
+    m_unansweredCommands = 0;
 }
 
 TCPSendStatus SmartMoveLowLevel::processJob(const std::string& processJobCommand)
@@ -186,134 +253,219 @@ TCPSendStatus SmartMoveLowLevel::selectJob(const std::string& selectJobCommand)
 
 int SmartMoveLowLevel::readMEParameter(const std::string& command, std::string& answer, int timeout)
 {
-    char buffer[ANSWER_BUFFER_LEN + 1];
-    size_t bytesRead;
-
-    std::string sendCommand{command + "\r\n"};
-    if (send(m_sockDesc, sendCommand.c_str(), sendCommand.size(), 0) == -1)
+    std::vector<std::optional<std::string>> replies;
+    const auto returnValue = exchange({command}, replies, timeout);
+    logExchangeError(returnValue, "(101)", "(102)");
+    if (returnValue == 0)
     {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(101)");
-        return -1;
+        answer = replies.front().value();
     }
+    return returnValue;
+}
 
-    if (readToPrompt(buffer, ANSWER_BUFFER_LEN, &bytesRead, timeout) < 0)
+int SmartMoveLowLevel::setMEParameter(const std::string& command, std::string& answer, int timeout)
+{
+    std::vector<std::optional<std::string>> replies;
+    const auto returnValue = exchange({command}, replies, timeout);
+    logExchangeError(returnValue, "(103)", "(104)");
+    if (returnValue == 0)
     {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while receiving data\n");
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(102)");
-        return -2;
+        answer = replies.front().value();
     }
-    buffer[bytesRead] = '\0';
-    std::string inputString{buffer};
-    auto first = inputString.find("\r\n");
-    answer = inputString.substr(0, first);
-
-    return 0;
+    return returnValue;
 }
 
-int SmartMoveLowLevel::setMEParameter(const std::string& command, std::string& answer, int timeout)
+std::vector<std::optional<std::string>> SmartMoveLowLevel::exchangeCommands(const std::vector<std::string>& commands, int timeout)
 {
-    char buffer[ANSWER_BUFFER_LEN + 1];
-    size_t bytesRead;
+    std::vector<std::optional<std::string>> replies;
+    logExchangeError(exchange(commands, replies, timeout), "(121)", "(122)");
+    return replies;
+}
 
-    std::string sendCommand{command + "\r\n"};
-    if (send(m_sockDesc, sendCommand.c_str(), sendCommand.size(), 0) == -1)
+std::vector<bool> SmartMoveLowLevel::sendCommands(const std::vector<std::string>& commands)
+{
+    // an empty command is only a synchronization, don't send it
+    std::vector<std::string> nonEmptyCommands;
+    nonEmptyCommands.reserve(commands.size());
+    std::copy_if(commands.begin(), commands.end(), std::back_inserter(nonEmptyCommands), [] (const auto& command) { return !command.empty(); });
+    if (nonEmptyCommands.size() != commands.size())
     {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(103)");
-        return -1;
+        wmLog(eWarning, "Command is empty!\n");
     }
 
-    if (readToPrompt(buffer, ANSWER_BUFFER_LEN, &bytesRead, timeout) < 0)
+    const auto replies = exchangeCommands(nonEmptyCommands, MCI_TIMEOUT_SYMBOL);
+
+    std::vector<bool> acknowledged;
+    acknowledged.reserve(commands.size());
+    auto reply = replies.begin();
+    for (const auto& command : commands)
     {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while receiving data\n");
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(104)");
-        return -2;
+        if (command.empty())
+        {
+            acknowledged.push_back(false);
+            continue;
+        }
+        acknowledged.push_back(reply->has_value() && reply->value() == command);
+        ++reply;
     }
-    buffer[bytesRead] = '\0';
-    std::string inputString{buffer};
-    auto first = inputString.find("\r\n");
-    answer = inputString.substr(0, first);
+    return acknowledged;
+}
 
+int SmartMoveLowLevel::exchange(const std::vector<std::string>& commands, std::vector<std::optional<std::string>>& replies, int timeout)
+{
+    replies.assign(commands.size(), std::nullopt);
+    discardLateReplies();
+
+    std::size_t sent{0};
+    std::size_t received{0};
+    std::string sendBuffer{};
+    while (received < commands.size())
+    {
+        // fill the window of outstanding commands with one send
+        sendBuffer.clear();
+        for (; sent < commands.size() && sent - received < m_maxOutstandingCommands; sent++)
+        {
+            sendBuffer += commands[sent];
+            sendBuffer += "\r\n";
+        }
+        if (!sendBuffer.empty() && !sendAll(sendBuffer.data(), sendBuffer.size()))
+        {
+            wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
+            // like on a timeout the replies to the commands in flight are discarded before the next command is sent,
+            // if the failed send did not reach the controller, discardLateReplies gives up after its timeout
+            m_unansweredCommands = sent - received;
+            return -1;
+        }
+
+        const auto reply = readReply(timeout);
+        if (!reply)
+        {
+            wmLog(eDebug, "SmartMoveLowLevel: Error while receiving data\n");
+            // the replies to the commands in flight arrive later, they are discarded before the next command is sent
+            m_unansweredCommands = sent - received;
+            return -2;
+        }
+        replies[received++] = firstLine(reply.value());
+    }
     return 0;
 }
 
-int SmartMoveLowLevel::readToPrompt(char* answer, size_t maxlen, size_t *nread, int timeout)
+std::optional<std::string> SmartMoveLowLevel::readReply(int timeout)
 {
-    const auto startTime{std::chrono::steady_clock::now()};
-
-    *nread = 0;
-    char buffer[200];
-    ssize_t bytesRead;
+    const auto deadline{std::chrono::steady_clock::now() + std::chrono::microseconds{timeout}};
     while (true)
     {
-        bytesRead = recv(m_sockDesc, buffer, sizeof(buffer), 0);
-        if (bytesRead > 0)
+        if (auto reply = m_replyParser.takeReply())
         {
-            for (ssize_t i = 0; i < bytesRead; i++)
+            return reply;
+        }
+        if (m_replyParser.overflow())
+        {
+            return {};
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 || !receive(remaining.count()))
+        {
+            return {};
+        }
+    }
+}
+
+bool SmartMoveLowLevel::receive(int timeout)
+{
+    pollfd pollDescriptor{m_sockDesc, POLLIN, 0};
+    int returnValue;
+    do
+    {
+        returnValue = poll(&pollDescriptor, 1, (timeout + 999) / 1000);
+    } while (returnValue == -1 && errno == EINTR);
+    if (returnValue <= 0)
+    {
+        return false;
+    }
+
+    char buffer[ANSWER_BUFFER_LEN];
+    const auto bytesRead = recv(m_sockDesc, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (bytesRead == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+        return true;
+    }
+    if (bytesRead <= 0)
+    {
+        // error or connection closed by the server
+        return false;
+    }
+    m_replyParser.append(buffer, bytesRead);
+    return true;
+}
+
+bool SmartMoveLowLevel::sendAll(const void* data, std::size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        const auto bytesSent = send(m_sockDesc, bytes, size, MSG_NOSIGNAL);
+        if (bytesSent == -1)
+        {
+            if (errno == EINTR)
             {
-                if (buffer[i] == '>')
-                {
-                    return 0;
-                }
-                answer[(*nread)++] = buffer[i];
-                if (*nread >= maxlen)
-                {
-                    return -1;
-                }
+                continue;
             }
+            return false;
         }
-        const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
-        if (waited.count() > timeout)
+        bytes += bytesSent;
+        size -= bytesSent;
+    }
+    return true;
+}
+
+void SmartMoveLowLevel::discardLateReplies()
+{
+    while (m_unansweredCommands > 0)
+    {
+        if (!readReply(MCI_TIMEOUT_LATE_REPLY))
         {
-            return -1;
+            // the reply is lost, drop whatever was received so far
+            wmLog(eDebug, "SmartMoveLowLevel: %zu replies did not arrive\n", m_unansweredCommands);
+            m_unansweredCommands = 0;
+            flushInput();
+            return;
         }
-        usleep(2 * 1000);
+        m_unansweredCommands--;
     }
 }
 
-int SmartMoveLowLevel::askForVersion(void)
+void SmartMoveLowLevel::flushInput()
 {
-    std::string answer{};
+    m_replyParser.clear();
+    char buffer[ANSWER_BUFFER_LEN];
+    while (recv(m_sockDesc, buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+    {
+    }
+}
 
-    readMEParameter("G INFO_SERIAL", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_SERIAL: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_CONFIG", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_CONFIG: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_VERSION", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_VERSION: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_PLD_CONFIG", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_PLD_CONFIG: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_PLD_VERSION", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_PLD_VERSION: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_BOOT_CONFIG", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_BOOT_CONFIG: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G INFO_BOOT_VERSION", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G INFO_BOOT_VERSION: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G RSI_INFO", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G RSI_INFO: %s\n", answer.c_str());
-    usleep(10 * 1000);
+int SmartMoveLowLevel::askForVersion(void)
+{
+    const std::vector<std::string> commands{"G INFO_SERIAL", "G INFO_CONFIG", "G INFO_VERSION", "G INFO_PLD_CONFIG", "G INFO_PLD_VERSION", "G INFO_BOOT_CONFIG", "G INFO_BOOT_VERSION", "G RSI_INFO"};
+    std::vector<std::optional<std::string>> replies;
+    logExchangeError(exchange(commands, replies, MCI_TIMEOUT_SYMBOL), "(101)", "(102)");
+    for (std::size_t i = 0; i < commands.size(); i++)
+    {
+        wmLog(eDebug, "%s: %s\n", commands[i].c_str(), replies[i].value_or(std::string{}).c_str());
+    }
 
     return 1;
 }
 
 int SmartMoveLowLevel::askForDownloadInfo(void)
 {
-    std::string answer{};
-
-    readMEParameter("G RSI_USTAT", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G RSI_USTAT: %s\n", answer.c_str());
-    usleep(10 * 1000);
-    readMEParameter("G HP_VECCNT", answer, MCI_TIMEOUT_SYMBOL);
-    wmLog(eDebug, "G HP_VECCNT: %s\n", answer.c_str());
-    usleep(10 * 1000);
+    const std::vector<std::string> commands{"G RSI_USTAT", "G HP_VECCNT"};
+    std::vector<std::optional<std::string>> replies;
+    logExchangeError(exchange(commands, replies, MCI_TIMEOUT_SYMBOL), "(101)", "(102)");
+    for (std::size_t i = 0; i < commands.size(); i++)
+    {
+        wmLog(eDebug, "%s: %s\n", commands[i].c_str(), replies[i].value_or(std::string{}).c_str());
+    }
 
     return 1;
 }
@@ -338,47 +490,22 @@ int SmartMoveLowLevel::doSoftwareReset(void)
     wmLog(eDebug, "SmartMoveLowLevel::doSoftwareReset start\n");
 
     // send reset command
+    discardLateReplies();
     std::string downloadCommand{"R\r\n"};
-    if (send(m_sockDesc, downloadCommand.c_str(), downloadCommand.size(), 0) == -1)
+    if (!sendAll(downloadCommand.c_str(), downloadCommand.size()))
     {
         wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
         wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(105)");
         return -1;
     }
 
-    sleep(2);
-
-    // waiting for answer
-    int inputBuffer{};
-    int returnValue{};
-    std::string answerDownload{};
-    returnValue = recv(m_sockDesc, &inputBuffer, 1, 0);
-    if (returnValue == -1)
-    {
-        wmLog(eDebug, "SmartMoveLowLevel: after first receive error (%s)\n", strerror(errno));
-    }
-    else
+    // waiting for answer, the reset takes a while
+    const auto reply = readReply(MCI_TIMEOUT_RESET);
+    if (!reply)
     {
-        answerDownload.push_back(inputBuffer);
+        wmLog(eDebug, "SmartMoveLowLevel: no answer after reset\n");
     }
-    while (returnValue != -1)
-    {
-        returnValue = recv(m_sockDesc, &inputBuffer, 1, 0);
-        if (returnValue == -1)
-        {
-            wmLog(eDebug, "SmartMoveLowLevel: after next receive error  (%s)\n", strerror(errno));
-        }
-        else
-        {
-            answerDownload.push_back(inputBuffer);
-            if (static_cast<char>(inputBuffer & 0xFF) == '>')
-            {
-                break;
-            }
-        }
-    }
-    auto first = answerDownload.find("\r\n");
-    std::string answer = answerDownload.substr(0, first);
+    const auto answer = firstLine(reply.value_or(std::string{}));
     if (answer == std::string{"R"})
     {
         wmLog(eDebug, "SmartMoveLowLevel::doSoftwareReset successful\n");
@@ -626,9 +753,11 @@ int SmartMoveLowLevel::transmitFileXModem(const std::string& command, int fileDe
         return -1;
     }
 
-    // send download command
+    // send download command, the XModem protocol reads the socket directly
+    discardLateReplies();
+    m_replyParser.clear();
     std::string downloadCommand{command + "\r\n"};
-    if (send(m_sockDesc, downloadCommand.c_str(), downloadCommand.size(), 0) == -1)
+    if (!sendAll(downloadCommand.c_str(), downloadCommand.size()))
     {
         wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
         wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(107)");
@@ -649,20 +778,14 @@ int SmartMoveLowLevel::transmitFileXModem(const std::string& command, int fileDe
     // finish the upload
     xmodemWriteChar(nullptr) ;
 
-    char buffer[ANSWER_BUFFER_LEN + 1];
-    size_t bytesRead;
-    if (readToPrompt(buffer, ANSWER_BUFFER_LEN, &bytesRead, MCI_TIMEOUT_SYMBOL) < 0)
+    const auto reply = readReply(MCI_TIMEOUT_SYMBOL);
+    if (!reply)
     {
         wmLog(eDebug, "SmartMoveLowLevel: Error while receiving data\n");
         wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(108)");
         return -1;
     }
-    buffer[bytesRead] = '\0';
-    std::string answerDownload(buffer);
-    auto first = answerDownload.find("\r\n");
-    auto second = answerDownload.find("\r\n", (first + strlen("\r\n")));
-    auto length = second - (first + strlen("\r\n"));
-    answer = answerDownload.substr((first + strlen("\r\n")), length);
+    answer = secondLine(reply.value());
 
     wmLog(eDebug, "transmitFileXModem: end\n");
     return 0;
@@ -670,17 +793,14 @@ int SmartMoveLowLevel::transmitFileXModem(const std::string& command, int fileDe
 
 int SmartMoveLowLevel::xmodemOutBlock(int* data, int bytesToSend)
 {
-    int bytesSent{0};
-    while (bytesSent < bytesToSend)
+    // send the whole block at once instead of byte by byte
+    std::vector<uint8_t> block(bytesToSend);
+    std::transform(data, data + bytesToSend, block.begin(), [] (int value) { return static_cast<uint8_t>(value & 0xFF); });
+    if (!sendAll(block.data(), block.size()))
     {
-        int returnValue = send(m_sockDesc, data + bytesSent, 1, 0);
-        if (returnValue == -1)
-        {
-            wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-            wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(109)");
-            return -1;
-        }
-        bytesSent += returnValue;
+        wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
+        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(109)");
+        return -1;
     }
     return bytesToSend;
 }
@@ -690,11 +810,9 @@ int SmartMoveLowLevel::xmodemInpByte(int* inputByte, unsigned int timeout)
     const auto startTime{std::chrono::steady_clock::now()};
 
     unsigned char characterRead;
-    int loop{0};
     while (1)
     {
-        loop++;
-        if (recv(m_sockDesc, &characterRead, 1, 0) == 1)
+        if (recv(m_sockDesc, &characterRead, 1, MSG_DONTWAIT) == 1)
         {
             *inputByte = (int) characterRead;
             return 1;
@@ -704,7 +822,9 @@ int SmartMoveLowLevel::xmodemInpByte(int* inputByte, unsigned int timeout)
         {
             return 0;
         }
-        usleep(2 * 1000);
+        // wait till the next byte arrives or the timeout is over
+        pollfd pollDescriptor{m_sockDesc, POLLIN, 0};
+        poll(&pollDescriptor, 1, (timeout - waited.count() + 999) / 1000);
     }
 }
 
@@ -1000,21 +1120,13 @@ int SmartMoveLowLevel::transmitFileBTX(const std::string& command, int fileDescr
         return -1;
     }
 
-    // send download command
-    std::string downloadCommand{command + "\r\n"};
-    if (send(m_sockDesc, downloadCommand.c_str(), downloadCommand.size(), 0) == -1)
-    {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(118)");
-        return -1;
-    }
-
     // read file content
-    uint8_t fileChar{0x00};
+    uint8_t fileChunk[4096];
+    ssize_t bytesRead{0};
     std::vector<int> dataBlock{};
-    while (read(fileDescriptor, &fileChar, 1) == 1)
+    while ((bytesRead = read(fileDescriptor, fileChunk, sizeof(fileChunk))) > 0)
     {
-        dataBlock.push_back(static_cast<int>(fileChar));
+        dataBlock.insert(dataBlock.end(), fileChunk, fileChunk + bytesRead);
     }
     wmLog(eDebug, "transmitFileBTX: read %d characters\n", dataBlock.size());
 
@@ -1031,59 +1143,31 @@ int SmartMoveLowLevel::transmitFileBTX(const std::string& command, int fileDescr
     header[5] = dataBlock.size() & 0xFF;
     header[6] = (crcValue >> 8) & 0xFF;
     header[7] = crcValue & 0xFF;
-    if (send(m_sockDesc, header, sizeof(header), 0) == -1)
-    {
-        wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(119)");
-        return -1;
-    }
 
-    // copy data to sendBuffer and send sendBuffer
-    std::vector<uint8_t> sendBuffer{};
+    // download command, header and data are sent in one go
+    discardLateReplies();
+    const std::string downloadCommand{command + "\r\n"};
+    std::vector<uint8_t> sendBuffer{downloadCommand.begin(), downloadCommand.end()};
+    sendBuffer.reserve(sendBuffer.size() + sizeof(header) + dataBlock.size());
+    sendBuffer.insert(sendBuffer.end(), header, header + sizeof(header));
     for (const int& value : dataBlock)
     {
         sendBuffer.push_back(static_cast<uint8_t>(value & 0xFF));
     }
-    if (send(m_sockDesc, sendBuffer.data(), sendBuffer.size(), 0) == -1)
+    if (!sendAll(sendBuffer.data(), sendBuffer.size()))
     {
         wmLog(eDebug, "SmartMoveLowLevel: Error while sending data: %s\n", strerror(errno));
-        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(120)");
+        wmFatal(eExtEquipment, "QnxMsg.VI.TCPCommFault", "Problem while establishing TCP/IP communication %s\n", "(118)");
         return -1;
     }
 
     // waiting for answer and extract download result
-    int inputBuffer{};
-    int returnValue{};
-    std::string answerDownload{};
-    returnValue = recv(m_sockDesc, &inputBuffer, 1, 0);
-    if (returnValue == -1)
-    {
-        wmLog(eDebug, "transmitFileBTX: after first receive error (%s)\n", strerror(errno));
-    }
-    else
-    {
-        answerDownload.push_back(inputBuffer);
-    }
-    while (returnValue != -1)
+    const auto reply = readReply(XMODEM_RXTIMEOUT);
+    if (!reply)
     {
-        returnValue = recv(m_sockDesc, &inputBuffer, 1, 0);
-        if (returnValue == -1)
-        {
-            wmLog(eDebug, "transmitFileBTX: after next receive error  (%s)\n", strerror(errno));
-        }
-        else
-        {
-            answerDownload.push_back(inputBuffer);
-            if (static_cast<char>(inputBuffer & 0xFF) == '>')
-            {
-                break;
-            }
-        }
+        wmLog(eDebug, "transmitFileBTX: no answer received\n");
     }
-    auto first = answerDownload.find("\r\n");
-    auto second = answerDownload.find("\r\n", (first + strlen("\r\n")));
-    auto length = second - (first + strlen("\r\n"));
-    answer = answerDownload.substr((first + strlen("\r\n")), length);
+    answer = secondLine(reply.value_or(std::string{}));
 
     wmLog(eDebug, "transmitFileBTX: end\n");
     return 0;
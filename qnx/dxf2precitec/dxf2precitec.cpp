@@ -6,6 +6,7 @@
 #include <sstream>
 #include <optional>
 #include <list>
+#include <chrono>
 
 /*
 TODO:
@@ -39,6 +40,40 @@ double Overhead(std::vector<Path> const& paths)
 
 // ----------------------------------------------------------------------------
 
+/**
+Parses the value following the option at parg and advances parg to it. Prints an error and returns false if there is no
+non-negative value.
+*/
+bool ParseNonNegative(char const**& parg, double& value)
+{
+    std::string const option = *parg;
+    ++parg;
+    if (!*parg)
+    {
+        std::cerr << "invalid usage of " << option << ", expecting value afterwards" << std::endl;
+        return false;
+    }
+
+    std::istringstream s(*parg);
+    s.imbue(std::locale("C"));
+    s >> value;
+    if (!s)
+    {
+        std::cerr << "could not parse value for " << option << std::endl;
+        return false;
+    }
+
+    if (value < 0)
+    {
+        std::cerr << "value for " << option << " must not be negative" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
 // see https://en.cppreference.com/w/cpp/error/throw_with_nested
 void print_exception(const std::exception& e, int level = 0)
 {
@@ -97,6 +132,14 @@ jsonpath       Path to the .json precitec output file
 -optstart      Allow the optimizer to choose any vertex of a cyclic path as
                starting point. The starting position for circles and ellipses
                is always chosen by the optimizer.
+-jumpspeed v   Jump speed of the scanner used to estimate the cycle time that
+               is minimized by the optimizer. Unit: mm/s, default: 1000
+-markspeed v   Mark speed of the scanner. Unit: mm/s, default: 100
+-jumpdelay t   Delay after each jump of the scanner. Unit: us, default: 0
+-markdelay t   Delay after each marked path. Unit: us, default: 0
+-t budget      Time the optimizer may spend to improve the cycle time. The
+               best order found so far is used if the time is exceeded.
+               Unit: ms, default: 1000
 -unit name     Sets or overrides the physical unit of the imported geometry.
                By default the unit is taken from the DXF file and must be set.
                See -lu for supported units.
@@ -116,6 +159,8 @@ jsonpath       Path to the .json precitec output file
     std::optional<double> maxDist;
     bool optdir = false;
     bool optstart = false;
+    ScannerTiming timing;
+    double timeBudget = 1000;
 
     { // commandline parsing
         std::array<std::string*, 2> posArgs = {&dxfPath, &jsonPath};
@@ -253,6 +298,29 @@ jsonpath       Path to the .json precitec output file
                     continue;
                 }
 
+                if (arg == "-jumpspeed" || arg == "-markspeed" || arg == "-jumpdelay" || arg == "-markdelay" || arg == "-t")
+                {
+                    double value;
+                    if (!ParseNonNegative(parg, value))
+                        return -1;
+
+                    if (arg == "-jumpspeed" || arg == "-markspeed")
+                    {
+                        if (value == 0)
+                        {
+                            std::cerr << "value for " << arg << " must be positive" << std::endl;
+                            return -1;
+                        }
+                        (arg == "-jumpspeed" ? timing.jumpSpeed : timing.markSpeed) = value;
+                    }
+                    else if (arg == "-t")
+                        timeBudget = value;
+                    else
+                        (arg == "-jumpdelay" ? timing.jumpDelay : timing.markDelay) = value / 1000000;
+
+                    continue;
+                }
+
                 if (arg == "-svg")
                 {
                     ++parg;
@@ -367,6 +435,13 @@ jsonpath       Path to the .json precitec output file
             overhead = x;
         }
 
+        auto const budget = std::chrono::duration<double, std::milli>(timeBudget);
+        auto const route = ImproveRoute(paths, timing, std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget));
+        std::cout << "estimated cycle time: " << route.cycleTimeBefore << " s, optimized: " << route.cycleTimeAfter << " s";
+        if (route.timeBudgetExceeded)
+            std::cout << " (time budget exceeded)";
+        std::cout << std::endl;
+
         for (Path const& path : paths)
         {
             for (Point2 const& p : path.points)
@@ -0,0 +1,136 @@
+#include <QTest>
+
+#include "../dxfreader.h"
+
+#include <random>
+#include <sstream>
+
+using nsDxfReader::DxfData;
+using nsDxfReader::EstimateCycleTime;
+using nsDxfReader::ImproveOrderLocally;
+using nsDxfReader::ImproveRoute;
+using nsDxfReader::Path;
+using nsDxfReader::ScannerTiming;
+
+class BenchmarkRouteOptimization : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkImproveOrderLocally();
+    void benchmarkImproveRoute_data();
+    void benchmarkImproveRoute();
+
+private:
+    std::vector<Path> m_paths;
+    ScannerTiming m_timing;
+};
+
+namespace
+{
+
+class PathConfigProvider : public nsDxfReader::IPathConfigProvider
+{
+public:
+    double GetCircleStartAngle(size_t /*pathIdx*/, nsDxfReader::CircularDesc const& /*circleDesc*/) override { return 0; }
+    std::optional<double> GetMaxDist(size_t /*pathIdx*/) override { return {}; }
+    double GetMaxError(size_t /*pathIdx*/) override { return 0.05; }
+};
+
+// circles, closed rectangles and lines at random positions of a 500 mm x 500 mm field
+std::string syntheticDxf(int contourCount)
+{
+    std::mt19937 generator{11};
+    std::uniform_real_distribution<double> position{0.0, 500.0};
+    std::uniform_real_distribution<double> size{0.5, 3.0};
+
+    std::ostringstream dxf;
+    dxf.imbue(std::locale("C"));
+    dxf << "0\nSECTION\n2\nHEADER\n9\n$INSUNITS\n70\n4\n0\nENDSEC\n";
+    dxf << "0\nSECTION\n2\nENTITIES\n";
+    for (int i = 0; i < contourCount; i++)
+    {
+        double const x = position(generator);
+        double const y = position(generator);
+        double const s = size(generator);
+        switch (i % 3)
+        {
+        case 0:
+            dxf << "0\nCIRCLE\n10\n" << x << "\n20\n" << y << "\n40\n" << s << "\n";
+            break;
+        case 1:
+            dxf << "0\nLWPOLYLINE\n90\n4\n70\n1\n";
+            dxf << "10\n" << x << "\n20\n" << y << "\n";
+            dxf << "10\n" << x + s << "\n20\n" << y << "\n";
+            dxf << "10\n" << x + s << "\n20\n" << y + s * 0.5 << "\n";
+            dxf << "10\n" << x << "\n20\n" << y + s * 0.5 << "\n";
+            break;
+        default:
+            dxf << "0\nLINE\n10\n" << x << "\n20\n" << y << "\n11\n" << x + s << "\n21\n" << y - s << "\n";
+            break;
+        }
+    }
+    dxf << "0\nENDSEC\n0\nEOF\n";
+    return dxf.str();
+}
+
+}
+
+void BenchmarkRouteOptimization::initTestCase()
+{
+    std::istringstream dxf{syntheticDxf(10000)};
+    DxfData data{dxf};
+    PathConfigProvider cfg;
+    m_paths = data.CreatePaths(nsDxfReader::Unit::Millimeters, cfg, 10 * 1000 * 1000);
+    m_paths = nsDxfReader::JoinPaths(m_paths, 0.05);
+    m_paths = nsDxfReader::RouteOptimized(m_paths);
+    QVERIFY(m_paths.size() > 9000);
+
+    m_timing.jumpSpeed = 2000;
+    m_timing.markSpeed = 200;
+    m_timing.jumpDelay = 0.0003;
+    m_timing.markDelay = 0.0001;
+}
+
+void BenchmarkRouteOptimization::benchmarkImproveOrderLocally()
+{
+    std::vector<Path> paths;
+    QBENCHMARK
+    {
+        paths = m_paths;
+        for (int i = 0; ImproveOrderLocally(paths) && i < 10; ++i)
+            ;
+    }
+    qInfo("cycle time %f s -> %f s", EstimateCycleTime(m_paths, m_timing), EstimateCycleTime(paths, m_timing));
+}
+
+void BenchmarkRouteOptimization::benchmarkImproveRoute_data()
+{
+    QTest::addColumn<bool>("optimizeStart");
+
+    QTest::newRow("directed") << false;
+    QTest::newRow("optimizeStart") << true;
+}
+
+void BenchmarkRouteOptimization::benchmarkImproveRoute()
+{
+    QFETCH(bool, optimizeStart);
+
+    auto input = m_paths;
+    for (Path& path : input)
+        path.optimizeStart = optimizeStart || path.optimizeStart;
+
+    std::vector<Path> paths;
+    nsDxfReader::RouteImprovement result;
+    QBENCHMARK
+    {
+        paths = input;
+        result = ImproveRoute(paths, m_timing, std::chrono::seconds(10));
+    }
+    QVERIFY(!result.timeBudgetExceeded);
+    QVERIFY(result.cycleTimeAfter < result.cycleTimeBefore);
+    qInfo("cycle time %f s -> %f s with %zu moves", result.cycleTimeBefore, result.cycleTimeAfter, result.moves);
+}
+
+QTEST_GUILESS_MAIN(BenchmarkRouteOptimization)
+#include "benchmarkRouteOptimization.moc"
@@ -0,0 +1,168 @@
+#include <QTest>
+
+#include "../dxfreader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using nsDxfReader::EstimateCycleTime;
+using nsDxfReader::ImproveRoute;
+using nsDxfReader::Path;
+using nsDxfReader::Point2;
+using nsDxfReader::ScannerTiming;
+
+class TestRouteOptimization : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEstimateCycleTime();
+    void testImproveOrder_data();
+    void testImproveOrder();
+    void testJoinTouchingPaths();
+    void testTimeBudget();
+};
+
+namespace
+{
+
+Path line(Point2 start, Point2 end, bool optimizeStart)
+{
+    Path path;
+    path.points = {start, end};
+    path.optimizeStart = optimizeStart;
+    return path;
+}
+
+Path square(Point2 corner, double size)
+{
+    Path path;
+    path.points = {corner, Point2{corner.x + size, corner.y}, Point2{corner.x + size, corner.y + size}, Point2{corner.x, corner.y + size}};
+    path.cyclic = true;
+    return path;
+}
+
+// short lines and squares on a grid in random order
+std::vector<Path> shuffledGrid(bool optimizeStart)
+{
+    std::vector<Path> paths;
+    for (int x = 0; x < 20; x++)
+    {
+        for (int y = 0; y < 20; y++)
+        {
+            if ((x + y) % 3 == 0)
+                paths.push_back(square(Point2{x * 10.0, y * 10.0}, 2.0));
+            else
+                paths.push_back(line(Point2{x * 10.0, y * 10.0}, Point2{x * 10.0 + 3.0, y * 10.0 + 1.0}, optimizeStart));
+        }
+    }
+
+    std::mt19937 generator{3};
+    std::shuffle(paths.begin(), paths.end(), generator);
+    return paths;
+}
+
+std::vector<std::pair<double, double>> sortedEndpoints(std::vector<Path> const& paths)
+{
+    std::vector<std::pair<double, double>> ret;
+    for (Path const& path : paths)
+    {
+        auto const& a = path.StartPoint();
+        auto const& b = path.points.back();
+        ret.emplace_back(std::min(a.x, b.x) + std::min(a.y, b.y), std::max(a.x, b.x) + std::max(a.y, b.y));
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+}
+
+void TestRouteOptimization::testEstimateCycleTime()
+{
+    ScannerTiming timing;
+    timing.jumpSpeed = 1000;
+    timing.markSpeed = 100;
+    timing.jumpDelay = 0.001;
+    timing.markDelay = 0.0005;
+
+    QCOMPARE(EstimateCycleTime({}, timing), 0.0);
+
+    // 10 mm mark, 5 mm jump, 10 mm mark and 5 mm jump back to the start
+    std::vector<Path> paths{line(Point2{0, 0}, Point2{10, 0}, false), line(Point2{10, 5}, Point2{0, 5}, false)};
+    QCOMPARE(EstimateCycleTime(paths, timing), 2 * (0.1 + 0.0005) + 2 * (0.005 + 0.001));
+
+    // the square is closed, it ends at its start and no jump is needed to reach it
+    paths = {square(Point2{0, 0}, 2.0)};
+    QCOMPARE(EstimateCycleTime(paths, timing), 0.08 + 0.0005);
+}
+
+void TestRouteOptimization::testImproveOrder_data()
+{
+    QTest::addColumn<bool>("optimizeStart");
+
+    QTest::newRow("directed") << false;
+    QTest::newRow("optimizeStart") << true;
+}
+
+void TestRouteOptimization::testImproveOrder()
+{
+    QFETCH(bool, optimizeStart);
+
+    auto const input = shuffledGrid(optimizeStart);
+    auto paths = input;
+
+    ScannerTiming timing;
+    timing.jumpDelay = 0.0002;
+    auto const result = ImproveRoute(paths, timing, std::chrono::seconds(10));
+
+    QVERIFY(!result.timeBudgetExceeded);
+    QVERIFY(result.moves > 0);
+    QCOMPARE(result.cycleTimeBefore, EstimateCycleTime(input, timing));
+    QCOMPARE(result.cycleTimeAfter, EstimateCycleTime(paths, timing));
+    // a jump between neighbors takes less than 12 ms, in random order the jumps are about 100 mm long
+    QVERIFY(result.cycleTimeAfter < result.cycleTimeBefore * 0.5);
+
+    // all paths are visited once, directed paths keep their direction
+    QCOMPARE(paths.size(), input.size());
+    QCOMPARE(sortedEndpoints(paths), sortedEndpoints(input));
+    for (Path const& path : paths)
+    {
+        if (!path.cyclic && !optimizeStart)
+            QVERIFY(path.points.front().x < path.points.back().x);
+    }
+}
+
+void TestRouteOptimization::testJoinTouchingPaths()
+{
+    // a zig zag line split into pieces, the pieces touch each other but are in random order
+    std::vector<Path> paths;
+    for (int i = 0; i < 30; i++)
+        paths.push_back(line(Point2{i * 1.0, (i % 2) * 5.0}, Point2{(i + 1) * 1.0, ((i + 1) % 2) * 5.0}, true));
+
+    std::mt19937 generator{7};
+    std::shuffle(paths.begin(), paths.end(), generator);
+
+    ScannerTiming timing;
+    timing.jumpDelay = 0.01;
+    auto const result = ImproveRoute(paths, timing, std::chrono::seconds(10));
+
+    // only the jump from the end of the zig zag line back to its start is left
+    double const markTime = 30 * std::sqrt(26.0) / timing.markSpeed;
+    QCOMPARE(qRound(result.cycleTimeAfter * 1000000), qRound((markTime + timing.jumpDelay + 30.0 / timing.jumpSpeed) * 1000000));
+}
+
+void TestRouteOptimization::testTimeBudget()
+{
+    auto const input = shuffledGrid(true);
+    auto paths = input;
+
+    auto const result = ImproveRoute(paths, ScannerTiming{}, std::chrono::seconds(0));
+    QVERIFY(result.timeBudgetExceeded);
+    QCOMPARE(result.moves, size_t(0));
+    QCOMPARE(result.cycleTimeAfter, result.cycleTimeBefore);
+    QCOMPARE(sortedEndpoints(paths), sortedEndpoints(input));
+    QVERIFY(paths.front().points == input.front().points);
+}
+
+QTEST_GUILESS_MAIN(TestRouteOptimization)
+#include "testRouteOptimization.moc"
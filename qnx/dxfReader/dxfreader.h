@@ -2,6 +2,7 @@
 
 #include "linalg.h"
 #include <vector>
+#include <chrono>
 #include <set>
 #include <iosfwd>
 #include <exception>
@@ -143,4 +144,36 @@ std::vector<Path> RouteOptimized(std::vector<Path> const& paths);
 bool ImproveOrderLocally(std::vector<Path>& paths);
 std::vector<Path> ImproveStartPositions(std::vector<Path> const& paths);
 
+/**
+Describes how fast the scanner traces paths. Speeds in mm/s, delays in s.
+*/
+struct ScannerTiming
+{
+    double jumpSpeed = 1000;
+    double markSpeed = 100;
+    double jumpDelay = 0; ///< applied after each jump, paths that touch are traced without a jump
+    double markDelay = 0; ///< applied after each path
+};
+
+/**
+Estimates the time to trace the paths in the given order and to jump back to the start of the first path.
+*/
+double EstimateCycleTime(std::vector<Path> const& paths, ScannerTiming const& timing);
+
+struct RouteImprovement
+{
+    double cycleTimeBefore = 0; ///< see @ref EstimateCycleTime
+    double cycleTimeAfter = 0;
+    size_t moves = 0;             ///< number of applied improvements
+    bool timeBudgetExceeded = false;
+};
+
+/**
+Improves the order of the paths and the direction of paths with @ref Path::optimizeStart to reduce the estimated cycle time.
+
+Paths are moved next to their nearest neighbors (Or-opt) and parts of the route are reversed (2-opt) until no improvement
+is found or the time budget is exceeded. The start vertices of cyclic paths are not changed, see @ref ImproveStartPositions.
+*/
+RouteImprovement ImproveRoute(std::vector<Path>& paths, ScannerTiming const& timing, std::chrono::steady_clock::duration timeBudget, size_t neighborCount = 8);
+
 }
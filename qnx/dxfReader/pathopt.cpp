@@ -3,6 +3,8 @@
 #include "frnn.h"
 #include <algorithm>
 #include <array>
+#include <deque>
+#include <tuple>
 
 #ifndef NDEBUG
 #define _DEBUG
@@ -611,4 +613,438 @@ std::vector<Path> RouteOptimized(std::vector<Path> const& paths)
     return ret;
 }
 
+namespace
+{
+
+/**
+Time to jump from @p from to @p to, paths that touch are traced without a jump.
+*/
+double JumpTime(Point2 const& from, Point2 const& to, ScannerTiming const& timing)
+{
+    double const d = Distance(from, to);
+    return d > 0 ? timing.jumpDelay + d / timing.jumpSpeed : 0;
+}
+
+double MarkTime(Path const& path, ScannerTiming const& timing)
+{
+    double length = 0;
+    for (size_t i = 1; i < path.points.size(); ++i)
+        length += Distance(path.points[i - 1], path.points[i]);
+
+    if (path.cyclic && path.points.size() > 1)
+        length += Distance(path.points.back(), path.points.front());
+
+    return timing.markDelay + length / timing.markSpeed;
+}
+
+/**
+Local search on a cyclic route of paths.
+
+Only moves that connect a path with one of its nearest neighbors are evaluated, so one pass over the route is linear in the
+number of paths (apart from the cost to apply an improving move).
+*/
+class RouteOptimizer
+{
+    struct Node
+    {
+        size_t path;
+        bool reversed = false;
+    };
+
+    std::vector<Path> const& mPaths;
+    ScannerTiming const mTiming;
+    std::vector<Node> mRoute;
+    std::vector<size_t> mPos; ///< position in mRoute for each path
+    std::vector<std::vector<size_t>> mNeighbors;
+
+    // minimal gain of a move, avoids endless loops due to rounding
+    static constexpr double mMinGain = 1e-12;
+
+    size_t Succ(size_t pos) const { return pos + 1 < mRoute.size() ? pos + 1 : 0; }
+    size_t Pred(size_t pos) const { return pos ? pos - 1 : mRoute.size() - 1; }
+
+    // a cyclic path starts and ends at the same vertex, so it can be part of a reversed part of the route without changes
+    bool Reversible(Node const& node) const
+    {
+        Path const& path = mPaths[node.path];
+        return path.cyclic || path.optimizeStart;
+    }
+
+    static Node Flipped(Node node)
+    {
+        node.reversed = !node.reversed;
+        return node;
+    }
+
+    Point2 const& Start(Node const& node) const
+    {
+        Path const& path = mPaths[node.path];
+        return node.reversed && !path.cyclic ? path.points.back() : path.StartPoint();
+    }
+
+    Point2 const& End(Node const& node) const
+    {
+        Path const& path = mPaths[node.path];
+        return node.reversed && !path.cyclic ? path.points.front() : path.EndPoint();
+    }
+
+    double Jump(Node const& from, Node const& to) const
+    {
+        return JumpTime(End(from), Start(to), mTiming);
+    }
+
+    void UpdatePositions(size_t first, size_t last)
+    {
+        for (size_t i = first; i <= last; ++i)
+            mPos[mRoute[i].path] = i;
+    }
+
+    void ReverseRange(size_t first, size_t last)
+    {
+        std::reverse(mRoute.begin() + first, mRoute.begin() + last + 1);
+        for (size_t i = first; i <= last; ++i)
+            mRoute[i].reversed = !mRoute[i].reversed;
+        UpdatePositions(first, last);
+    }
+
+    bool AllReversible(size_t first, size_t last) const
+    {
+        for (size_t i = first; i <= last; ++i)
+        {
+            if (!Reversible(mRoute[i]))
+                return false;
+        }
+        return true;
+    }
+
+    void FindNeighbors(size_t neighborCount)
+    {
+        size_t const n = mPaths.size();
+        mNeighbors.resize(n);
+
+        Point2 min = mPaths.front().StartPoint();
+        Point2 max = min;
+        for (Path const& path : mPaths)
+        {
+            for (Point2 const* p : {&path.StartPoint(), &path.points.back()})
+            {
+                min.Minimize(*p);
+                max.Maximize(*p);
+            }
+        }
+
+        Vec2 const size = max - min;
+        double const extent = std::max(size.x, size.y);
+        if (!extent)
+            return; // all paths start and end at the same position, the order doesn't matter
+
+        // a cell of the grid holds about neighborCount endpoints if they are evenly distributed
+        double const area = std::max(size.x * size.y, extent * extent / n);
+        double range = std::sqrt(area * neighborCount / (2 * n));
+
+        // grids with increasing range for paths in sparse regions, built on demand
+        // NOTE: the coordinates are made positive as Frnn2D casts them to unsigned integers
+        std::deque<Frnn2D<double, size_t>> grids;
+        auto grid = [&](size_t level) -> Frnn2D<double, size_t> const&
+        {
+            while (grids.size() <= level)
+            {
+                auto& frnn = grids.emplace_back(range * std::pow(4., static_cast<double>(grids.size())));
+                for (size_t i = 0; i < n; ++i)
+                {
+                    for (Point2 const* p : {&mPaths[i].StartPoint(), &mPaths[i].points.back()})
+                        frnn.Insert(p->x - min.x, p->y - min.y, i);
+                }
+            }
+            return grids[level];
+        };
+
+        std::vector<std::pair<double, size_t>> candidates;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Path const& path = mPaths[i];
+            for (size_t level = 0;; ++level)
+            {
+                double const levelRange = range * std::pow(4., static_cast<double>(level));
+                candidates.clear();
+                for (Point2 const* p : {&path.StartPoint(), &path.points.back()})
+                {
+                    grid(level).QueryCandidates(p->x - min.x, p->y - min.y, [&](size_t cand)
+                                                {
+                        if (cand == i)
+                            return;
+
+                        Path const& other = mPaths[cand];
+                        double d = std::min(Distance(*p, other.StartPoint()), Distance(*p, other.points.back()));
+                        candidates.emplace_back(d, cand); });
+                }
+
+                std::sort(candidates.begin(), candidates.end());
+                // a path is listed once for each of its endpoints, only the nearest one is used
+                std::vector<size_t>& neighbors = mNeighbors[i];
+                neighbors.clear();
+                size_t inRange = 0;
+                for (auto const& [d, cand] : candidates)
+                {
+                    if (neighbors.size() == neighborCount)
+                        break;
+                    if (std::find(neighbors.begin(), neighbors.end(), cand) != neighbors.end())
+                        continue;
+                    neighbors.push_back(cand);
+                    if (d <= levelRange)
+                        ++inRange;
+                }
+
+                // only the candidates within the range are the nearest ones for sure
+                if (inRange == neighborCount || levelRange >= extent)
+                    break;
+            }
+        }
+    }
+
+    /**
+    Reverses the direction of a single path in place.
+    */
+    bool TryFlip(size_t i)
+    {
+        Node const& cur = mRoute[i];
+        Path const& path = mPaths[cur.path];
+        if (path.cyclic || !path.optimizeStart)
+            return false;
+
+        Node const& prev = mRoute[Pred(i)];
+        Node const& next = mRoute[Succ(i)];
+        double const gain = Jump(prev, cur) + Jump(cur, next) - Jump(prev, Flipped(cur)) - Jump(Flipped(cur), next);
+        if (gain <= mMinGain)
+            return false;
+
+        mRoute[i].reversed = !mRoute[i].reversed;
+        return true;
+    }
+
+    /**
+    Moves up to three successive paths starting at @p i next to a neighbor of its first or last path, optionally reversed.
+    */
+    bool TryOrOpt(size_t i)
+    {
+        size_t const n = mRoute.size();
+        for (size_t len = 1; len <= 3 && i + len <= n && len + 2 < n; ++len)
+        {
+            size_t const last = i + len - 1;
+            Node const first = mRoute[i];
+            Node const lastNode = mRoute[last];
+            Node const& prev = mRoute[Pred(i)];
+            Node const& next = mRoute[Succ(last)];
+
+            double const removeGain = Jump(prev, first) + Jump(lastNode, next) - Jump(prev, next);
+            if (removeGain <= mMinGain)
+                continue;
+
+            bool const reversible = AllReversible(i, last);
+
+            double bestGain = mMinGain;
+            std::optional<size_t> bestPos;
+            bool bestReversed = false;
+
+            auto tryInsertAfter = [&](size_t p)
+            {
+                if ((p >= i && p <= last) || p == Pred(i))
+                    return;
+
+                Node const& a = mRoute[p];
+                Node const& b = mRoute[Succ(p)];
+                double const base = removeGain + Jump(a, b);
+
+                double gain = base - Jump(a, first) - Jump(lastNode, b);
+                if (gain > bestGain)
+                {
+                    bestGain = gain;
+                    bestPos = p;
+                    bestReversed = false;
+                }
+
+                if (reversible)
+                {
+                    gain = base - Jump(a, Flipped(lastNode)) - Jump(Flipped(first), b);
+                    if (gain > bestGain)
+                    {
+                        bestGain = gain;
+                        bestPos = p;
+                        bestReversed = true;
+                    }
+                }
+            };
+
+            for (size_t end : {first.path, lastNode.path})
+            {
+                for (size_t neighbor : mNeighbors[end])
+                {
+                    size_t const p = mPos[neighbor];
+                    tryInsertAfter(p);
+                    tryInsertAfter(Pred(p));
+                }
+            }
+
+            if (!bestPos)
+                continue;
+
+            size_t const p = *bestPos;
+            size_t newFirst;
+            if (p > last)
+            {
+                std::rotate(mRoute.begin() + i, mRoute.begin() + last + 1, mRoute.begin() + p + 1);
+                UpdatePositions(i, p);
+                newFirst = p + 1 - len;
+            }
+            else
+            {
+                std::rotate(mRoute.begin() + p + 1, mRoute.begin() + i, mRoute.begin() + last + 1);
+                UpdatePositions(p + 1, last);
+                newFirst = p + 1;
+            }
+
+            if (bestReversed)
+                ReverseRange(newFirst, newFirst + len - 1);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+    Replaces the jumps after @p x and after @p y by reversing the route between them.
+    */
+    bool TryReverse(size_t x, size_t y)
+    {
+        if (x > y)
+            std::swap(x, y);
+        if (x == y || (x == 0 && y == mRoute.size() - 1))
+            return false;
+
+        Node const& a = mRoute[x];
+        Node const& b = mRoute[x + 1];
+        Node const& c = mRoute[y];
+        Node const& d = mRoute[Succ(y)];
+
+        double const gain = Jump(a, b) + Jump(c, d) - Jump(a, Flipped(c)) - Jump(Flipped(b), d);
+        if (gain <= mMinGain || !AllReversible(x + 1, y))
+            return false;
+
+        ReverseRange(x + 1, y);
+        return true;
+    }
+
+    /**
+    2-opt move which connects the path at @p i with one of its neighbors, either the end of the path with the end
+    of the neighbor or the start of the path with the start of the neighbor.
+    */
+    bool TryTwoOpt(size_t i)
+    {
+        for (size_t neighbor : mNeighbors[mRoute[i].path])
+        {
+            size_t const j = mPos[neighbor];
+            if (TryReverse(i, j) || TryReverse(Pred(i), Pred(j)))
+                return true;
+        }
+
+        return false;
+    }
+
+public:
+    RouteOptimizer(std::vector<Path> const& paths, ScannerTiming const& timing, size_t neighborCount)
+        : mPaths(paths)
+        , mTiming(timing)
+        , mRoute(paths.size())
+        , mPos(paths.size())
+    {
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            mRoute[i].path = i;
+            mPos[i] = i;
+        }
+
+        FindNeighbors(neighborCount);
+    }
+
+    /**
+    Applies improving moves until none is found or the deadline is reached.
+    Returns the number of applied moves and if the deadline was reached.
+    */
+    std::pair<size_t, bool> Optimize(std::chrono::steady_clock::time_point deadline)
+    {
+        size_t moves = 0;
+        for (bool improved = true; improved;)
+        {
+            improved = false;
+            for (size_t i = 0; i < mRoute.size(); ++i)
+            {
+                if (i % 64 == 0 && std::chrono::steady_clock::now() >= deadline)
+                    return {moves, true};
+
+                if (TryFlip(i) || TryOrOpt(i) || TryTwoOpt(i))
+                {
+                    improved = true;
+                    ++moves;
+                }
+            }
+        }
+
+        return {moves, false};
+    }
+
+    std::vector<Path> Result() const
+    {
+        std::vector<Path> ret;
+        ret.reserve(mRoute.size());
+        for (Node const& node : mRoute)
+        {
+            ret.push_back(mPaths[node.path]);
+            if (node.reversed && !ret.back().cyclic)
+                std::reverse(ret.back().points.begin(), ret.back().points.end());
+        }
+        return ret;
+    }
+};
+
+} // namespace
+
+double EstimateCycleTime(std::vector<Path> const& paths, ScannerTiming const& timing)
+{
+    if (paths.empty())
+        return 0;
+
+    double time = 0;
+    Path const* prev = &paths.back();
+    for (Path const& path : paths)
+    {
+        time += JumpTime(prev->EndPoint(), path.StartPoint(), timing) + MarkTime(path, timing);
+        prev = &path;
+    }
+
+    return time;
+}
+
+RouteImprovement ImproveRoute(std::vector<Path>& paths, ScannerTiming const& timing, std::chrono::steady_clock::duration timeBudget, size_t neighborCount)
+{
+    auto const deadline = std::chrono::steady_clock::now() + timeBudget;
+
+    RouteImprovement ret;
+    ret.cycleTimeBefore = EstimateCycleTime(paths, timing);
+    ret.cycleTimeAfter = ret.cycleTimeBefore;
+
+    if (paths.size() < 3 || !neighborCount)
+        return ret;
+
+    RouteOptimizer optimizer(paths, timing, neighborCount);
+    std::tie(ret.moves, ret.timeBudgetExceeded) = optimizer.Optimize(deadline);
+    if (!ret.moves)
+        return ret;
+
+    paths = optimizer.Result();
+    ret.cycleTimeAfter = EstimateCycleTime(paths, timing);
+
+    return ret;
+}
+
 } // nsDxfReader
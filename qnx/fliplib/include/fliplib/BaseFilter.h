@@ -10,6 +10,8 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <chrono>
 
 #include "Poco/Condition.h"
 #include "Poco/UUID.h"
@@ -427,6 +429,21 @@ namespace fliplib
          **/
         void logProcessingTime();
 
+        /**
+         * Enables recording of every single processing time, not only the min, max and mean.
+         * Used by the benchmark mode of filtertest to compute percentiles. Only effective if timing is enabled.
+         * Enabling clears the previously recorded processing times.
+         **/
+        void recordProcessingTimes(bool enable);
+
+        /**
+         * @returns the processing times recorded since recordProcessingTimes got enabled.
+         **/
+        const std::vector<std::chrono::nanoseconds> &recordedProcessingTimes() const
+        {
+            return m_recordedProcessingTimes;
+        }
+
         /**
          * Ensures that the Filter's image number is at least @p imageNumber.
          **/
@@ -509,6 +526,8 @@ namespace fliplib
         Poco::Condition m_synchronization;
         Poco::ThreadLocal<bool> m_preSignalActionCalled;
         bool m_oAlwaysEnableTiming; // log timing also when verbosity != max
+        bool m_recordProcessingTimes = false;
+        std::vector<std::chrono::nanoseconds> m_recordedProcessingTimes;
         int m_oGraphIndex; //(optional) unique index inside graph
         int m_skippedCounter;  //additional info for processing time
         int m_oProcessingIndex = -1; //(optional) unique index assigned according to the pipe notification
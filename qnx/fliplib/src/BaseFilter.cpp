@@ -593,6 +593,10 @@ inline void BaseFilter::logTiming()
     {
         m_maxProcessingTime = std::make_pair(m_oTimerCnt, elapsed);
     }
+    if (m_recordProcessingTimes)
+    {
+        m_recordedProcessingTimes.push_back(elapsed);
+    }
     ++m_oTimerCnt;
 } // logTiming
 
@@ -614,6 +618,16 @@ void BaseFilter::logPaintTime(const std::chrono::nanoseconds &elapsed)
     ++m_paintTimeCounter;
 }
 
+void BaseFilter::recordProcessingTimes(bool enable)
+{
+    m_recordProcessingTimes = enable;
+    m_recordedProcessingTimes.clear();
+    if (enable)
+    {
+        m_recordedProcessingTimes.reserve(4096);
+    }
+}
+
 void BaseFilter::logProcessingTime()
 {
     if (m_oVerbosity != eMax && !m_oAlwaysEnableTiming)